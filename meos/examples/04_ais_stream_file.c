@@ -35,10 +35,11 @@
  * ingest the newest observations.
  *
  * This program is similar to `04_ais_stream_db` but illustrates the use of
- * an output file. In this setting, the expandable data structures accumulate
- * the observations that have been received so far and append them to the file.
- * Depending on application requirements and the available memory, the
- * accumulated temporal values must be sent regularly to the file.
+ * an output file and of a stream of temporal sequences. The stream
+ * accumulates the observations that have been received so far for each ship
+ * and passes them to a function appending them to the file when they reach a
+ * given number of instants, when the memory of the stream exceeds its budget,
+ * or when there is a gap of more than one hour between two observations.
  *
  * The program can be build as follows
  * @code
@@ -51,8 +52,6 @@
 #include <string.h>
 #include <meos.h>
 #include <meos_geo.h>
-/* The expandable functions are in the internal MEOS API */
-#include <meos_internal.h>
 
 /* Number of instants to send in batch to the file */
 #define NUM_INSTS_BATCH 1000
@@ -62,8 +61,8 @@
 #define MAX_LEN_HEADER 1024
 /* Maximum length in characters of a point in the input data */
 #define MAX_LEN_POINT 64
-/* Maximum number of trips */
-#define MAX_NUM_TRIPS 5
+/* Memory budget of the stream in bytes */
+#define MAX_MEM_STREAM (1024 * 1024)
 
 typedef struct
 {
@@ -74,11 +73,23 @@ typedef struct
   double SOG;
 } AIS_record;
 
-typedef struct
+/* Number of writes to the output file */
+static int num_writes = 0;
+
+/* Function receiving the sequences released by the stream */
+static void
+write_trip(void *arg, int64 mmsi, const TSequence *seq)
 {
-  long int MMSI;   /* Identifier of the trip */
-  TSequence *trip; /* Array of latest observations of the trip, by MMSI */
-} trip_record;
+  FILE *file_out = (FILE *) arg;
+  char *temp_out = tspatial_out((const Temporal *) seq, 15);
+  fprintf(file_out, "%ld, %s\n", (long int) mmsi, temp_out);
+  /* Free memory */
+  free(temp_out);
+  num_writes++;
+  printf("*");
+  fflush(stdout);
+  return;
+}
 
 int
 main(int argc, char **argv)
@@ -87,14 +98,8 @@ main(int argc, char **argv)
   int num_records = 0;
   int num_nulls = 0;
   char text_buffer[MAX_LEN_HEADER];
-  /* Allocate space to build the trips */
-  trip_record trips[MAX_NUM_TRIPS] = {0};
-  /* Number of ships */
-  int num_ships = 0;
-  /* Number of writes */
-  int num_writes = 0;
-  /* Iterator variables */
-  int i, j;
+  /* Stream building the trips */
+  TSeqStream *stream = NULL;
   /* Exit value initialized to 1 (i.e., error) to quickly exit upon error */
   int exit_value = EXIT_FAILURE;
 
@@ -118,6 +123,14 @@ main(int argc, char **argv)
   /* Initialize MEOS */
   meos_initialize();
 
+  /* Create the stream, which splits the trips on gaps of more than one hour,
+   * and set its limits */
+  Interval *maxt = interval_in("1 hour", -1);
+  stream = tseqstream_make(LINEAR, 0.0, maxt, 0.0, &write_trip, file_out);
+  free(maxt);
+  tseqstream_set_limits(stream, NUM_INSTS_BATCH, NUM_INSTS_KEEP,
+    MAX_MEM_STREAM);
+
   /* You may substitute the full file path in the first argument of fopen */
   FILE *file_in = fopen("data/ais_instants.csv", "r");
   if (! file_in)
@@ -157,43 +170,6 @@ main(int argc, char **argv)
 
     num_records++;
 
-    /* Find the place to store the new instant */
-    j = -1;
-    for (i = 0; i < num_ships; i++)
-    {
-      if (trips[i].MMSI == rec.MMSI)
-      {
-        j = i;
-        break;
-      }
-    }
-    if (j < 0)
-    {
-      j = num_ships++;
-      if (j == MAX_NUM_TRIPS)
-      {
-        printf("The maximum number of ships in the input file is bigger than %d",
-          MAX_NUM_TRIPS);
-        fclose(file_in);
-        goto cleanup;
-      }
-      trips[j].MMSI = rec.MMSI;
-    }
-
-    /* Send to the output file the trip if reached the maximum number of instants */
-    if (trips[j].trip && trips[j].trip->count == NUM_INSTS_BATCH)
-    {
-      char *temp_out = tsequence_out(trips[j].trip, 15);
-      fprintf(file_out, "%ld, %s\n",trips[j].MMSI, temp_out);
-      /* Free memory */
-      free(temp_out);
-      num_writes++;
-      printf("*");
-      fflush(stdout);
-      /* Restart the sequence by only keeping the last instants */
-      tsequence_restart(trips[j].trip, NUM_INSTS_KEEP);
-    }
-
     /* Transform the string representing the timestamp into a timestamp value */
     rec.T = timestamp_in(text_buffer, -1);
 
@@ -206,14 +182,13 @@ main(int argc, char **argv)
     GSERIALIZED *gs = geogpoint_make2d(4326, rec.Longitude, rec.Latitude);
     TInstant *inst = tpointinst_make(gs, rec.T);
     free(gs);
-    if (! trips[j].trip)
-      trips[j].trip = tsequence_make_exp(&inst, 1, NUM_INSTS_BATCH, true,
-      true, LINEAR, false);
-    else
-      tsequence_append_tinstant(trips[j].trip, inst, 0.0, NULL, true);
+    tseqstream_append(stream, rec.MMSI, inst);
     free(inst);
   } while (! feof(file_in));
 
+  /* Send to the output file the remaining observations of the trips */
+  tseqstream_flush(stream);
+
   printf("\n%d records read\n%d incomplete records ignored\n"
     "%d writes to the output file\n", num_records, num_nulls, num_writes);
 
@@ -230,8 +205,7 @@ cleanup:
   fclose(file_out);
 
  /* Free memory */
-  for (i = 0; i < num_ships; i++)
-    free(trips[i].trip);
+  tseqstream_free(stream);
 
   /* Finalize MEOS */
   meos_finalize();
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Packed coordinate arrays of temporal point sequences.
+ */
+
+#ifndef __TPOINT_COORDS_H__
+#define __TPOINT_COORDS_H__
+
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include "temporal/temporal.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Number of instants read at a time by the kernels that scan the
+ * coordinates of a sequence with #tpointseq_coords_fill
+ */
+#define TPOINT_COORDS_CHUNK 256
+
+/**
+ * @brief Minimum number of instants of a sequence for which the length is
+ * computed with the kernels of tpoint_coords_simd.c
+ */
+#define TPOINT_COORDS_SIMD_MIN 32
+
+/**
+ * @brief Structure-of-arrays view of the instants of a temporal point
+ * sequence
+ * @details The timestamps and the coordinates are copied once into
+ * contiguous arrays that share a single SRID and flags header. The arrays
+ * are allocated in the same memory block as the structure, which is freed
+ * with a single call to @p pfree. The @p z array is @p NULL when the
+ * sequence has no Z dimension.
+ */
+typedef struct
+{
+  int count;              /**< Number of instants */
+  int32_t srid;           /**< SRID of the points */
+  int16 flags;            /**< Flags of the sequence */
+  TimestampTz *t;         /**< Timestamps */
+  double *x;              /**< X coordinates */
+  double *y;              /**< Y coordinates */
+  double *z;              /**< Z coordinates, @p NULL if there is no Z */
+} TPointCoords;
+
+/*****************************************************************************/
+
+extern TPointCoords *tpointseq_coords(const TSequence *seq);
+extern void tpointseq_coords_fill(const TSequence *seq, int from, int count,
+  TimestampTz *t, double *x, double *y, double *z);
+
+/* Segment kernels, tpoint_coords_simd.c */
+
+extern void (*tpoint_coords_seglength)(const double *x, const double *y,
+  const double *z, int count, double *result);
+extern void (*tpoint_coords_segdist2)(const double *x, const double *y,
+  const double *z, int count, const double *a, const double *b,
+  double *result);
+
+/*****************************************************************************/
+
+#endif /* __TPOINT_COORDS_H__ */
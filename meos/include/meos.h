@@ -39,6 +39,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 /* PostgreSQL */
 #if MEOS
 #include "postgres_int_defs.h"
@@ -369,7 +370,12 @@ extern RTree *rtree_create_tpcbox();
 #endif
 extern void rtree_free(RTree *rtree);
 extern void rtree_insert(RTree *rtree, void *box, int64 id);
+extern bool rtree_delete(RTree *rtree, const void *box, int64 id);
+extern bool rtree_update(RTree *rtree, const void *oldbox, void *newbox, int64 id);
+extern bool rtree_save(const RTree *rtree, const char *filename);
+extern RTree *rtree_open_mmap(const char *filename);
 extern void rtree_load(RTree *rtree, const void *boxes, const int64 *ids, int count);
+extern void rtree_load_parallel(RTree *rtree, const void *boxes, const int64 *ids, int count, int nthreads);
 extern void rtree_insert_temporal(RTree *rtree, const Temporal *temp, int64 id);
 extern void rtree_insert_temporal_split(RTree *rtree, const Temporal *temp, int64 id, int maxboxes);
 extern int rtree_search(const RTree *rtree, RTreeSearchOp op, const void *query, MeosArray *result);
@@ -385,6 +391,23 @@ typedef struct RTreeNNCursor RTreeNNCursor;
 extern RTreeNNCursor *rtree_nn_cursor_open(const RTree *rtree, const void *query);
 extern bool rtree_nn_cursor_next(RTreeNNCursor *cursor, int64 *id_out, double *dist_out);
 extern void rtree_nn_cursor_close(RTreeNNCursor *cursor);
+extern bool rtree_knn_batch(const RTree *rtree, const void *queries, int count, int k, int nthreads, int64 *ids, double *dists);
+
+/**
+ * Cursor over the pairs of the join of two in-memory Rtree indexes
+ */
+typedef struct RTreeJoinCursor RTreeJoinCursor;
+
+/**
+ * Function consuming a batch of pairs of a parallel join of two in-memory
+ * Rtree indexes, returning false to stop the join
+ */
+typedef bool (*rtree_join_fn)(void *arg, const int64 *pairs, int count);
+
+extern RTreeJoinCursor *rtree_join_cursor_open(const RTree *rtree1, const RTree *rtree2, RTreeSearchOp op);
+extern int rtree_join_cursor_next(RTreeJoinCursor *cursor, int maxpairs, MeosArray *result);
+extern void rtree_join_cursor_close(RTreeJoinCursor *cursor);
+extern int64 rtree_join_parallel(const RTree *rtree1, const RTree *rtree2, RTreeSearchOp op, int nthreads, int batchsize, rtree_join_fn fn, void *arg);
 
 /**
  * @brief Enumeration that defines the kind of an in-memory space-partitioning
@@ -414,6 +437,8 @@ extern SPTree *sptree_create_stbox(SPTreeKind kind);
 extern SPTree *sptree_create_tpcbox(SPTreeKind kind);
 #endif
 extern void sptree_free(SPTree *sptree);
+extern bool sptree_save(const SPTree *sptree, const char *filename);
+extern SPTree *sptree_open_mmap(const char *filename);
 extern void sptree_insert(SPTree *sptree, void *box, int64 id);
 extern void sptree_insert_temporal(SPTree *sptree, const Temporal *temp, int64 id);
 extern void sptree_insert_temporal_split(SPTree *sptree, const Temporal *temp, int64 id, int maxboxes);
@@ -429,6 +454,7 @@ typedef struct SPNNCursor SPNNCursor;
 extern SPNNCursor *sptree_nn_cursor_open(const SPTree *sptree, const void *query);
 extern bool sptree_nn_cursor_next(SPNNCursor *cursor, int64 *id_out, double *dist_out);
 extern void sptree_nn_cursor_close(SPNNCursor *cursor);
+extern bool sptree_knn_batch(const SPTree *sptree, const void *queries, int count, int k, int nthreads, int64 *ids, double *dists);
 
 /*****************************************************************************
  * Initialization of the MEOS library
@@ -450,6 +476,10 @@ typedef void  (*meos_free_fn)(void *ptr);
 
 extern void meos_initialize_allocator(meos_malloc_fn malloc_fn,
   meos_realloc_fn realloc_fn, meos_free_fn free_fn);
+extern void meos_arena_push(void);
+extern void meos_arena_pop(void);
+extern void *meos_arena_keep(const void *ptr);
+extern int meos_arena_depth(void);
 extern void meos_initialize_noexit_error_handler(void);
 extern void meos_initialize_timezone(const char *name);
 extern void meos_initialize_collation(void);
@@ -457,6 +487,7 @@ extern void meos_finalize_timezone(void);
 extern void meos_finalize_collation(void);
 extern void meos_finalize_projsrs(void);
 extern void meos_finalize_ways(void);
+extern void meos_finalize_arena(void);
 #if POINTCLOUD
 extern void meos_initialize_pointcloud(void);
 #endif
@@ -472,6 +503,10 @@ extern void meos_set_ways_csv(const char* path);
 extern void meos_initialize(void);
 extern void meos_finalize(void);
 
+extern int meos_initialize_threads(int nthreads);
+extern void meos_finalize_threads(void);
+extern int meos_get_threads(void);
+
 /*****************************************************************************
  * Version functions
  *****************************************************************************/
@@ -1315,14 +1350,22 @@ extern bool tbox_ne(const TBox *box1, const TBox *box2);
  * Input and output functions for temporal types
  *****************************************************************************/
 
+/* Function receiving the temporal values of the streaming MF-JSON reader,
+ * which takes ownership of the value and returns false to stop the reading */
+typedef bool (*mfjson_read_fn)(void *arg, Temporal *temp);
+
 extern Temporal *tbool_from_mfjson(const char *str);
 extern Temporal *tbool_in(const char *str);
 extern char *tbool_out(const Temporal *temp);
 extern char *temporal_as_hexwkb(const Temporal *temp, uint8_t variant, size_t *size_out);
 extern char *temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags, int precision, const char *srs);
+extern size_t temporal_as_mfjson_buffer(const Temporal *temp, bool with_bbox, int precision, const char *srs, char *buf, size_t size);
+extern bool temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision, const char *srs, FILE *file);
 extern uint8_t *temporal_as_wkb(const Temporal *temp, uint8_t variant, size_t *size_out);
 extern uint8_t wkb_variant_from_endian(const char *endian);
 extern Temporal *temporal_from_hexwkb(const char *hexwkb);
+extern int temporal_from_mfjson_buffer(const char *mfjson, size_t size, bool geodetic, mfjson_read_fn fn, void *arg);
+extern int temporal_from_mfjson_file(FILE *file, bool geodetic, mfjson_read_fn fn, void *arg);
 extern Temporal *temporal_from_wkb(const uint8_t *wkb, size_t size);
 extern Temporal *tfloat_from_mfjson(const char *str);
 extern Temporal *tfloat_in(const char *str);
@@ -1376,6 +1419,7 @@ extern TSequenceSet *ttextseqset_from_base_tstzspanset(const text *txt, const Sp
  *****************************************************************************/
 
 extern Temporal *tbool_to_tint(const Temporal *temp);
+extern bool temparr_to_tstzspan(Temporal **temparr, int count, Span *result);
 extern Span *temporal_to_tstzspan(const Temporal *temp);
 extern Temporal *tfloat_to_tint(const Temporal *temp);
 extern Temporal *tfloat_to_tbigint(const Temporal *temp);
@@ -1385,6 +1429,7 @@ extern Temporal *tbigint_to_tint(const Temporal *temp);
 extern Temporal *tbigint_to_tfloat(const Temporal *temp);
 extern Span *tnumber_to_span(const Temporal *temp);
 extern TBox *tnumber_to_tbox (const Temporal *temp);
+extern bool tnumberarr_to_tbox(Temporal **temparr, int count, TBox *result);
 
 /*****************************************************************************
  * Accessor functions for temporal types
@@ -1395,6 +1440,10 @@ extern bool tbool_start_value(const Temporal *temp);
 extern bool tbool_value_at_timestamptz(const Temporal *temp, TimestampTz t, bool strict, bool *value);
 extern bool tbool_value_n(const Temporal *temp, int n, bool *result);
 extern bool *tbool_values(const Temporal *temp, int *count);
+extern bool temparr_duration(Temporal **temparr, int count, bool boundspan, int64 *result);
+extern bool temparr_end_timestamptz(Temporal **temparr, int count, TimestampTz *result);
+extern bool temparr_num_instants(Temporal **temparr, int count, int *result);
+extern bool temparr_start_timestamptz(Temporal **temparr, int count, TimestampTz *result);
 extern Interval *temporal_duration(const Temporal *temp, bool boundspan);
 extern TInstant *temporal_end_instant(const Temporal *temp);
 extern TSequence *temporal_end_sequence(const Temporal *temp);
@@ -1431,6 +1480,8 @@ extern double tfloat_start_value(const Temporal *temp);
 extern bool tfloat_value_at_timestamptz(const Temporal *temp, TimestampTz t, bool strict, double *value);
 extern bool tfloat_value_n(const Temporal *temp, int n, double *result);
 extern double *tfloat_values(const Temporal *temp, int *count);
+extern bool tfloatarr_end_value(Temporal **temparr, int count, double *result);
+extern bool tfloatarr_start_value(Temporal **temparr, int count, double *result);
 extern int tint_end_value(const Temporal *temp);
 extern int64 tbigint_end_value(const Temporal *temp);
 extern int tint_max_value(const Temporal *temp);
@@ -1445,6 +1496,8 @@ extern bool tint_value_n(const Temporal *temp, int n, int *result);
 extern bool tbigint_value_n(const Temporal *temp, int64 n, int64 *result);
 extern int *tint_values(const Temporal *temp, int *count);
 extern int64 *tbigint_values(const Temporal *temp, int32 *count);
+extern bool tintarr_end_value(Temporal **temparr, int count, int *result);
+extern bool tintarr_start_value(Temporal **temparr, int count, int *result);
 extern double tnumber_avg_value(const Temporal *temp);
 extern double tnumber_integral(const Temporal *temp);
 extern double tnumber_twavg(const Temporal *temp);
@@ -1500,12 +1553,32 @@ extern Temporal *temporal_merge(const Temporal *temp1, const Temporal *temp2);
 extern Temporal *temporal_merge_array(Temporal **temparr, int count);
 extern Temporal *temporal_update(const Temporal *temp1, const Temporal *temp2, bool connect);
 
+/**
+ * Structure for the streaming construction of temporal sequences keyed by an
+ * identifier
+ */
+typedef struct TSeqStream TSeqStream;
+
+/**
+ * Function receiving the sequences released by a stream of temporal sequences
+ */
+typedef void (*tseqstream_fn)(void *arg, int64 key, const TSequence *seq);
+
+extern bool tseqstream_append(TSeqStream *stream, int64 key, const TInstant *inst);
+extern int tseqstream_flush(TSeqStream *stream);
+extern bool tseqstream_flush_key(TSeqStream *stream, int64 key);
+extern void tseqstream_free(TSeqStream *stream);
+extern TSeqStream *tseqstream_make(interpType interp, double maxdist, const Interval *maxt, double maxspeed, tseqstream_fn fn, void *arg);
+extern size_t tseqstream_mem_size(const TSeqStream *stream);
+extern bool tseqstream_set_limits(TSeqStream *stream, int maxinsts, int keepinsts, size_t maxbytes);
+
 /*****************************************************************************
  * Restriction functions for temporal types
  *****************************************************************************/
 
 extern Temporal *tbool_at_value(const Temporal *temp, bool b);
 extern Temporal *tbool_minus_value(const Temporal *temp, bool b);
+extern bool temparr_at_tstzspan(Temporal **temparr, int count, const Span *s, Temporal **result);
 extern Temporal *temporal_after_timestamptz(const Temporal *temp, TimestampTz t, bool strict);
 extern Temporal *temporal_at_max(const Temporal *temp);
 extern Temporal *temporal_at_min(const Temporal *temp);
@@ -1932,6 +2005,9 @@ extern SkipList *tbool_tand_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tbool_tand_combinefn(SkipList *state1, SkipList *state2);
 extern SkipList *tbool_tor_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tbool_tor_combinefn(SkipList *state1, SkipList *state2);
+extern SkipList *temporal_aggstate_read(const uint8_t *buf, size_t size);
+extern size_t temporal_aggstate_size(SkipList *state);
+extern void temporal_aggstate_write(const SkipList *state, uint8_t *buf);
 extern Span *temporal_extent_transfn(Span *s, const Temporal *temp);
 extern Temporal *temporal_tagg_finalfn(SkipList *state);
 extern SkipList *temporal_tcount_transfn(SkipList *state, const Temporal *temp);
@@ -1992,9 +2068,13 @@ extern Temporal *temporal_tsample(const Temporal *temp, const Interval *duration
 
 /* Similarity functions for temporal types */
 
+extern bool temparr_dyntimewarp_distance(const Temporal *temp, Temporal **temparr, int count, int window, double maxdist, double *result);
+extern bool temparr_frechet_distance(const Temporal *temp, Temporal **temparr, int count, int window, double maxdist, double *result);
 extern double temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2);
+extern double temporal_dyntimewarp_distance_bounded(const Temporal *temp1, const Temporal *temp2, int window, double maxdist);
 extern Match *temporal_dyntimewarp_path(const Temporal *temp1, const Temporal *temp2, int *count);
 extern double temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2);
+extern double temporal_frechet_distance_bounded(const Temporal *temp1, const Temporal *temp2, int window, double maxdist);
 extern Match *temporal_frechet_path(const Temporal *temp1, const Temporal *temp2, int *count);
 extern double temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2);
 extern double temporal_average_hausdorff_distance(const Temporal *temp1, const Temporal *temp2);
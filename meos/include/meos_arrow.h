@@ -0,0 +1,112 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Public MEOS API for the exchange of temporal values in the columnar
+ * layout of the Apache Arrow C Data Interface
+ *
+ * A batch of temporal values is exchanged as one Arrow column of type
+ * `list<struct<t: timestamp[us, UTC], ...>>`, with one list of instants per
+ * value. The fields following the timestamp are `x`, `y`, and optionally `z`
+ * of type `float64` for temporal points, and `v` for the other types, whose
+ * Arrow type is `bool`, `int32`, `int64`, `float64`, or `utf8`. The column
+ * can be passed without serialization to any Arrow implementation, such as
+ * DuckDB, Polars, or PyArrow, which can in turn write it into Parquet files.
+ */
+
+#ifndef __MEOS_ARROW_H__
+#define __MEOS_ARROW_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************
+ * Structures of the Arrow C Data Interface
+ * https://arrow.apache.org/docs/format/CDataInterface.html
+ * The definitions are part of the specification and are shared by all
+ * implementations through the ARROW_C_DATA_INTERFACE guard
+ *****************************************************************************/
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  /* Array type description */
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  /* Release callback */
+  void (*release)(struct ArrowSchema *);
+  /* Opaque producer-specific data */
+  void *private_data;
+};
+
+struct ArrowArray
+{
+  /* Array data description */
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  /* Release callback */
+  void (*release)(struct ArrowArray *);
+  /* Opaque producer-specific data */
+  void *private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+/*****************************************************************************
+ * Exchange of temporal values
+ *****************************************************************************/
+
+extern bool temparr_as_arrow(Temporal **temparr, int count, struct ArrowSchema *schema, struct ArrowArray *array);
+extern Temporal **temparr_from_arrow(const struct ArrowSchema *schema, const struct ArrowArray *array, int *count);
+
+/*****************************************************************************/
+
+#endif /* __MEOS_ARROW_H__ */
@@ -664,6 +664,7 @@ typedef struct
 extern MvtGeom tpoint_as_mvtgeom(const Temporal *temp, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom);
 extern bool tpoint_tfloat_to_geomeas(const Temporal *tpoint, const Temporal *measure, bool segmentize, GSERIALIZED **result);
 extern STBox *tspatial_to_stbox(const Temporal *temp);
+extern bool tspatialarr_to_stbox(Temporal **temparr, int count, STBox *result);
 
 /* Accessor functions */
 
@@ -687,6 +688,7 @@ extern Temporal *tpoint_get_y(const Temporal *temp);
 extern Temporal *tpoint_get_z(const Temporal *temp);
 extern bool tpoint_is_simple(const Temporal *temp);
 extern double tpoint_length(const Temporal *temp);
+extern bool tpointarr_length(Temporal **temparr, int count, double *result);
 extern Temporal *tpoint_speed(const Temporal *temp);
 extern GSERIALIZED *tpoint_trajectory(const Temporal *temp, bool unary_union);
 extern GSERIALIZED *tpoint_twcentroid(const Temporal *temp);
@@ -946,6 +948,22 @@ typedef struct
 extern SpaceSplit tgeo_space_split(const Temporal *temp, double xsize, double ysize, double zsize, const GSERIALIZED *sorigin, bool bitmatrix, bool border_inc);
 extern SpaceTimeSplit tgeo_space_time_split(const Temporal *temp, double xsize, double ysize, double zsize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, bool border_inc);
 
+/* Cumulative-length index of temporal point sequences */
+
+/**
+ * Structure keeping the length travelled at each instant of a temporal point
+ * sequence
+ */
+typedef struct TPointIndex TPointIndex;
+
+extern Temporal *tpointindex_at_length(const TPointIndex *idx, double from, double to);
+extern void tpointindex_free(TPointIndex *idx);
+extern double tpointindex_length(const TPointIndex *idx);
+extern bool tpointindex_length_at_timestamptz(const TPointIndex *idx, TimestampTz t, double *result);
+extern TPointIndex *tpointindex_make(const Temporal *temp);
+extern bool tpointindex_timestamptz_at_length(const TPointIndex *idx, double length, TimestampTz *result);
+extern GSERIALIZED *tpointindex_value_at_length(const TPointIndex *idx, double length);
+
 /* Clustering functions */
 
 extern int *geo_cluster_kmeans(const GSERIALIZED **geoms, uint32_t ngeoms, uint32_t k, int *count);
@@ -748,6 +748,18 @@ struct SkipList
   int (*comp_fn)(void *, void *); /**< Comparison function for the elements */
   void *(*merge_fn)(void *, void *); /**< Merge function for the elements */
   SkipListElem *elems; /**< Array of elements */
+  void *events;        /**< Sweep-line buffer of the temporal count, may be
+                            `NULL` */
+  int nevents;         /**< Number of events in the buffer */
+  int evcapacity;      /**< Maximum number of events in the buffer */
+  uint8 evsubtype;     /**< Subtype of the values counted in the buffer */
+  void ***runs;        /**< Sorted runs of values of the combined states,
+                            may be `NULL` */
+  int *runcounts;      /**< Number of values in each run */
+  int nruns;           /**< Number of runs */
+  int runcapacity;     /**< Maximum number of runs */
+  Datum (*runfunc)(Datum, Datum); /**< Function for merging the runs */
+  bool runcrossings;   /**< True if turning points are added in the runs */
 };
 
 /**
@@ -154,6 +154,7 @@ extern double nsegment_start_position(const Nsegment *ns);
 extern bool route_exists(int64 rid);
 extern const GSERIALIZED *route_geom(int64 rid);
 extern double route_length(int64 rid);
+extern bool routes_geom(const int64 *rids, int count, const GSERIALIZED **result);
 
 /* Transformation functions */
 
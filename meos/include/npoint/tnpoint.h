@@ -117,6 +117,10 @@ extern Datum datum_npoint_round(Datum npoint, Datum size);
 
 /* Input/output functions */
 
+/* Route functions */
+
+extern bool routes_fetch(const int64 *rids, int count);
+
 /* Conversion functions */
 
 extern TInstant *tnpointinst_tgeompointinst(const TInstant *inst);
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Parallel execution of independent tasks by MEOS worker threads
+ */
+
+#ifndef __MEOS_PARALLEL_H__
+#define __MEOS_PARALLEL_H__
+
+/* C */
+#include <stdbool.h>
+
+/*****************************************************************************/
+
+/* Minimum number of instants of the input of a MEOS function for splitting
+ * its loop between the threads of the pool */
+#define MEOS_PARALLEL_MIN_INSTANTS 4096
+/* Minimum number of tasks of a loop split between the threads of the pool */
+#define MEOS_PARALLEL_MIN_TASKS 8
+
+/**
+ * @brief Function executing the n-th task of a parallel loop
+ */
+typedef void (*meos_task_fn)(void *arg, int task);
+
+extern int meos_parallel_threads(int nthreads);
+extern void meos_parallel_for(int nthreads, int ntasks, meos_task_fn fn,
+  void *arg);
+extern int meos_parallel_pool_threads(int ninsts, int ntasks);
+
+/*****************************************************************************/
+
+#endif /* __MEOS_PARALLEL_H__ */
@@ -55,6 +55,7 @@ extern bool ensure_same_skiplist_subtype(SkipList *state, uint8 subtype);
 
 extern void skiplist_set_extra(SkipList *state, void *data, size_t size);
 extern void *skiplist_headval(SkipList *list);
+extern void skiplist_clear(SkipList *list);
 
 
 /*****************************************************************************/
@@ -67,6 +67,17 @@ extern void **temporal_skiplist_merge(void **spliced, int spliced_count,
 extern void temporal_skiplist_splice(SkipList *list, void **values, int count,
   datum_func2 func, bool crossings);
 
+/* Deferred merge of the states of parallel aggregations */
+
+extern Temporal **skiplist_temporal_values(SkipList *list);
+extern bool temporal_tagg_merge_runs(SkipList *state);
+
+/* Sweep-line temporal count */
+
+extern void temporal_tcount_flush(SkipList *state);
+extern SkipList *tcount_seqarr_events(SkipList *state, TSequence **sequences,
+  int count);
+
 /* Generic aggregation functions */
 
 extern TInstant **tinstant_tagg(TInstant **instants1, int count1,
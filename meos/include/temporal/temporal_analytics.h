@@ -63,6 +63,14 @@ extern double temporal_similarity(const Temporal *temp1, const Temporal *temp2,
 extern Match *temporal_similarity_path(const Temporal *temp1,
   const Temporal *temp2, int *count, SimFunc simfunc);
 
+/* Similarity distances by tiles, temporal_similarity.c */
+
+extern double tinstarr_similarity(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, SimFunc simfunc, double epsilon,
+  int window, double maxdist);
+extern double tinstarr_average_hausdorff(const TInstant **instants1,
+  int count1, const TInstant **instants2, int count2);
+
 /*****************************************************************************/
 
 #endif /* __TEMPORAL_ANALYTICS_H__ */
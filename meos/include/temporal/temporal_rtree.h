@@ -43,9 +43,14 @@
  * RTree
  *****************************************************************************/
 
+/* At most 64 so that the entries of a node fit the bits of a uint64 mask, and
+ * a multiple of 4 so that the kernels scanning a node never read past it */
 #define MAXITEMS 64
 #define MINITEMS_PERCENTAGE 10
 #define MINITEMS ((MAXITEMS) * (MINITEMS_PERCENTAGE) / 100 + 1)
+/* Largest number of axes of a bounding box type, i.e., X, Y, time, and Z of
+ * an STBox */
+#define RTREE_MAX_AXES 4
 
 /**
  * @brief Enumeration that defines the node types for an RTree.
@@ -69,7 +74,8 @@ typedef struct RTreeNode
     struct RTreeNode *nodes[MAXITEMS];
     int64 ids[MAXITEMS];
   };
-  /* The bounding boxes can be of type Span, TBox, or STBox */
+  /* The bounding boxes can be of type Span, TBox, or STBox, and they are
+   * followed by their axis bounds, see #RTREE_NODE_LOWER */
   char boxes[];
 } RTreeNode;
 
@@ -86,7 +92,11 @@ struct RTree
   size_t bboxsize;       /**< Size of the bouding box */
   MeosType bboxtype;     /**< Type of the bouding box */
   int dims;
+  int axes;              /**< Bit mask of the axes present in every box */
   RTreeNode *root;
+  const char *mapped;    /**< Start of the file of a tree opened by
+                              #rtree_open_mmap, or @p NULL */
+  size_t mapped_size;    /**< Size of the mapped file */
   double (*get_axis)(const void *, int, bool);
   void (*bbox_expand)(const void *, void *);
   bool (*bbox_contains)(const void *, const void *);
@@ -101,6 +111,107 @@ struct RTree
 #define RTREE_NODE_BBOX_N(node, n) ( (void *)( \
   ((char *) &((node)->boxes)) + (n) * (node)->bboxsize ) )
 
+/**
+ * @brief Return a pointer to the lower bounds of a node along an axis
+ * @details The bounding boxes of a node are followed by a structure-of-arrays
+ * copy of their axis bounds: for each axis, the `MAXITEMS` lower bounds and
+ * then the `MAXITEMS` upper bounds, as doubles. This lets the kernels of
+ * #rtree_bounds_cover and #rtree_bounds_within test a whole node along an axis
+ * with contiguous loads instead of one indirect call per box.
+ */
+#define RTREE_NODE_LOWER(node, axis) ( (double *) ( \
+  ((char *) &((node)->boxes)) + MAXITEMS * (node)->bboxsize ) + \
+  (2 * (axis)) * MAXITEMS )
+
+/**
+ * @brief Return a pointer to the upper bounds of a node along an axis
+ */
+#define RTREE_NODE_UPPER(node, axis) \
+  ( RTREE_NODE_LOWER((node), (axis)) + MAXITEMS )
+
+/**
+ * @brief Return the child of the n-th entry of an inner node
+ * @details The nodes of a tree opened by #rtree_open_mmap store in place of
+ * the child pointers the offsets of the children from the start of the file
+ */
+#define RTREE_NODE_CHILD(rtree, node, n) ( (rtree)->mapped ? \
+  (RTreeNode *) ((rtree)->mapped + (node)->ids[(n)]) : (node)->nodes[(n)] )
+
+/**
+ * @brief Return the bit mask with the bits of the first @p count entries of a
+ * node set
+ */
+#define RTREE_COUNT_MASK(count) ( ((count) >= 64) ? ~UINT64CONST(0) : \
+  (UINT64CONST(1) << (count)) - 1 )
+
+/*****************************************************************************/
+
+/* Node scan kernels, temporal_rtree_simd.c */
+
+extern uint64 (*rtree_bounds_cover)(const double *lower,
+  const double *upper, int count, double a, double b);
+extern uint64 (*rtree_bounds_within)(const double *lower,
+  const double *upper, int count, double a, double b);
+
+/* Snapshots of the RTree and SPTree indexes */
+
+/* Read back with the bytes in another order on another architecture */
+#define INDEX_FILE_BYTEORDER 0x01020304
+/* Alignment of the first node of a snapshot */
+#define INDEX_FILE_ALIGN 64
+
+extern const char *index_file_map(const char *filename, size_t *size);
+extern void index_file_unmap(const char *mapped, size_t size);
+
+/* Batched nearest-neighbour queries of the RTree and SPTree indexes */
+
+/* Number of consecutive queries of a batch answered by one task */
+#define INDEX_KNN_CHUNK 256
+
+/**
+ * @brief A neighbour found by a batched nearest-neighbour query
+ */
+typedef struct
+{
+  double dist;          /**< Distance from the query to the box */
+  int64 id;             /**< Id stored with the box */
+  const void *box;      /**< Box stored in the index */
+} IndexNeighbor;
+
+/**
+ * @brief The nearest neighbours of the query being answered by a task of a
+ * batched nearest-neighbour query, and those of the previous query, which
+ * seed the search of the next one
+ */
+typedef struct
+{
+  int k;                  /**< Number of neighbours per query */
+  int count;              /**< Number of neighbours found so far */
+  IndexNeighbor *heap;    /**< Max-heap by distance of the neighbours */
+  int nseeds;             /**< Number of neighbours of the previous query */
+  IndexNeighbor *seeds;   /**< Neighbours of the previous query */
+} IndexKNN;
+
+extern int *index_query_order(MeosType bboxtype, const void *queries,
+  size_t stride, int count);
+extern void index_knn_init(IndexKNN *knn, int k);
+extern void index_knn_free(IndexKNN *knn);
+extern void index_knn_restart(IndexKNN *knn);
+extern bool index_knn_seeded(const IndexKNN *knn, const void *box);
+extern void index_knn_offer(IndexKNN *knn, int64 id, double dist,
+  const void *box);
+extern void index_knn_emit(IndexKNN *knn, int64 *ids, double *dists);
+
+/**
+ * @brief Return true when an entry at distance @p dist cannot be among the
+ * nearest neighbours found so far
+ */
+static inline bool
+index_knn_prune(const IndexKNN *knn, double dist)
+{
+  return knn->count == knn->k && dist >= knn->heap[0].dist;
+}
+
 /*****************************************************************************/
 
 #endif /* __TEMPORAL_RTREE__ */
@@ -86,6 +86,9 @@ struct SPTree
                              matches. */
   SPTreeKind kind;      /**< Quad-tree or k-d tree */
   SPNode *root;         /**< Root node, or @p NULL when empty */
+  const char *mapped;   /**< Start of the file of a tree opened by
+                             #sptree_open_mmap, or @p NULL */
+  size_t mapped_size;   /**< Size of the mapped file */
   int (*box_dims)(const void *box);  /**< Dimensions of a box, or @p NULL when
                                           fixed at creation */
   void (*project)(const void *in, void *out);  /**< Project an incoming box
@@ -104,6 +107,16 @@ struct SPTree
   bool (*leaf_consistent)(const void *key, const void *query, RTreeSearchOp op);
 };
 
+/**
+ * @brief Return the offset of the children of a node of a tree opened by
+ * #sptree_open_mmap
+ * @details Such a node stores after its box the offsets of its @p nchild
+ * children from the start of the file, 0 for an empty child slot, in place of
+ * the pointer to the array of children
+ */
+#define SPNODE_MAPPED_CHILDREN(sptree) \
+  ( MAXALIGN(sizeof(SPNode) + (sptree)->boxsize) )
+
 /*****************************************************************************/
 
 #endif /* __TEMPORAL_SPTREE__ */
@@ -51,6 +51,8 @@ extern SkipList *temporal_wagg_transfn(SkipList *state, const Temporal *temp,
 extern SkipList *temporal_wagg_transform_transfn(SkipList *state,
   const Temporal *temp, const Interval *interval, datum_func2 func,
   TSequence ** (*transform)(const Temporal *, const Interval *, int *));
+extern SkipList *temporal_wcount_transfn(SkipList *state,
+  const Temporal *temp, const Interval *interval);
 
 /*****************************************************************************/
 
@@ -377,7 +377,8 @@ tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int32_t srid)
 Temporal *
 tpoint_tcentroid_finalfn(SkipList *state)
 {
-  if (state == NULL || state->length == 0)
+  if (state == NULL || ! temporal_tagg_merge_runs(state) ||
+      state->length == 0)
     return NULL;
 
   Temporal **values = (Temporal **) skiplist_values(state);
@@ -47,10 +47,12 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include <meos_internal_geo.h>
+#include "temporal/meos_parallel.h"
 #include "temporal/temporal.h"
 #include "temporal/temporal_tile.h"
 #include "geo/stbox.h"
 #include "geo/tgeo_spatialfuncs.h"
+#include "geo/tpoint_coords.h"
 
 /*****************************************************************************
  * Bit Matrix implementation based on
@@ -90,7 +92,7 @@ bitmatrix_get(const BitMatrix *bm, const int *coords)
 {
   int i, j;
   for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
+    assert(coords[i] < bm->count[i]);
   int pos = 0;
   for (i = 0; i < bm->ndims; i++)
   {
@@ -114,7 +116,7 @@ bitmatrix_set_cell(BitMatrix *bm, const int *coords, bool value)
 {
   int i, j, pos = 0;
   for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
+    assert(coords[i] < bm->count[i]);
   for (i = 0; i < bm->ndims - 1; i++)
   {
     int offset = coords[i];
@@ -1109,9 +1111,10 @@ tile_get_fpos(double dx, double dy, double dz, TimestampTz dt,
 }
 
 /**
- * @brief Get the coordinates of the tile corresponding the temporal point
- * instant
- * @param[in] inst Temporal point
+ * @brief Get the coordinates of the tile corresponding to a point and a
+ * timestamp
+ * @param[in] px,py,pz Coordinates of the point
+ * @param[in] pt Timestamp
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
@@ -1119,32 +1122,32 @@ tile_get_fpos(double dx, double dy, double dz, TimestampTz dt,
  * @param[out] fpos Fractional position inside the tile
  */
 static void
-tpointinst_get_coords_fpos(const TInstant *inst, bool hasz, bool hast,
-  const STboxGridState *state, int *coords, double *fpos)
+tpoint_get_coords_fpos(double px, double py, double pz, TimestampTz pt,
+  bool hasz, bool hast, const STboxGridState *state, int *coords,
+  double *fpos)
 {
-  /* Read the point and compute the minimum values of the tile */
-  POINT4D p;
-  datum_point4d(tinstant_value_p(inst), &p);
-  double x = float_get_bin(p.x, state->xsize, state->box.xmin);
-  double y = float_get_bin(p.y, state->ysize, state->box.ymin);
+  /* Compute the minimum values of the tile */
+  double x = float_get_bin(px, state->xsize, state->box.xmin);
+  double y = float_get_bin(py, state->ysize, state->box.ymin);
   double z = 0;
   TimestampTz t = 0;
   if (hasz)
-    z = float_get_bin(p.z, state->zsize, state->box.zmin);
+    z = float_get_bin(pz, state->zsize, state->box.zmin);
   if (hast)
-    t = timestamptz_bin_start(inst->t, state->tunits,
+    t = timestamptz_bin_start(pt, state->tunits,
       DatumGetTimestampTz(state->box.period.lower));
   /* Transform the minimum values of the tile into matrix coordinates */
   tile_get_coords(x, y, z, t, state, coords);
   /* Transform the values in a tile into relative positions in matrix cells */
   if (fpos) /* Some methods do not need this information */
-    tile_get_fpos(p.x - x, p.y - y, p.z - z, inst->t - t, state, fpos);
+    tile_get_fpos(px - x, py - y, pz - z, pt - t, state, fpos);
   return;
 }
 
 /**
  * @brief Set the bit corresponding to the tiles intersecting a temporal point
  * sequence
+ * @details The coordinates are read into packed arrays by chunks
  * @param[in] seq Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
@@ -1155,15 +1158,23 @@ static int
 tpointseq_disc_set_tiles(const TSequence *seq, bool hasz, bool hast,
   const STboxGridState *state, BitMatrix *bm)
 {
+  TimestampTz t[TPOINT_COORDS_CHUNK];
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK];
   /* Transform the point into tile coordinates */
   int coords[MAXDIMS], result = 0;
   memset(coords, 0, sizeof(coords));
-  for (int i = 0; i < seq->count; i++)
+  for (int from = 0; from < seq->count; from += TPOINT_COORDS_CHUNK)
   {
-    tpointinst_get_coords_fpos(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
-      coords, NULL);
-    bitmatrix_set_cell(bm, coords, true);
-    result++;
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, t, x, y, z);
+    for (int i = 0; i < count; i++)
+    {
+      tpoint_get_coords_fpos(x[i], y[i], z[i], t[i], hasz, hast, state,
+        coords, NULL);
+      bitmatrix_set_cell(bm, coords, true);
+      result++;
+    }
   }
   return result;
 }
@@ -1171,6 +1182,8 @@ tpointseq_disc_set_tiles(const TSequence *seq, bool hasz, bool hast,
 /**
  * @brief Set the bit corresponding to the tiles intersecting the temporal
  * point sequence
+ * @details The coordinates are read into packed arrays by chunks, the last
+ * instant of a chunk being the first instant of the next one
  * @param[in] seq Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
@@ -1184,20 +1197,29 @@ tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
   assert(seq); assert(state);
   assert(MEOS_FLAGS_GET_INTERP(seq->flags) != DISCRETE);
 
+  TimestampTz t[TPOINT_COORDS_CHUNK];
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK];
   int ndims = 2 + (hasz ? 1 : 0) + (hast ? 1 : 0);
   int coords1[MAXDIMS], coords2[MAXDIMS], result = 0;
   double fpos1[MAXDIMS], fpos2[MAXDIMS];
   memset(coords1, 0, sizeof(coords1));
   memset(coords2, 0, sizeof(coords2));
-  tpointinst_get_coords_fpos(TSEQUENCE_INST_N(seq, 0), hasz, hast, state,
-    coords1, fpos1);
-  for (int i = 1; i < seq->count; i++)
+  tpointseq_coords_fill(seq, 0, 1, t, x, y, z);
+  tpoint_get_coords_fpos(x[0], y[0], z[0], t[0], hasz, hast, state, coords1,
+    fpos1);
+  for (int from = 0; from < seq->count - 1; from += TPOINT_COORDS_CHUNK - 1)
   {
-    tpointinst_get_coords_fpos(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
-      coords2, fpos2);
-    result += fastvoxel_bm(coords1, fpos1, coords2, fpos2, ndims, bm);
-    memcpy(coords1, coords2, sizeof(coords1));
-    memcpy(fpos1, fpos2, sizeof(fpos1));
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, t, x, y, z);
+    for (int i = 1; i < count; i++)
+    {
+      tpoint_get_coords_fpos(x[i], y[i], z[i], t[i], hasz, hast, state,
+        coords2, fpos2);
+      result += fastvoxel_bm(coords1, fpos1, coords2, fpos2, ndims, bm);
+      memcpy(coords1, coords2, sizeof(coords1));
+      memcpy(fpos1, fpos2, sizeof(fpos1));
+    }
   }
   return result;
 }
@@ -1356,7 +1378,11 @@ tgeo_space_time_tile_init(const Temporal *temp, double xsize, double ysize,
     assert(tpoint_type(temp->temptype));
     /* Create the bit matrix and set the tiles traversed by the temporal point */
     int ndims = 2 + (hasz ? 1 : 0) + (duration ? 1 : 0);
-    state->bm = bitmatrix_make(state->max_coords, ndims);
+    /* The tile coordinates go from 0 to the maximum one included */
+    int count[MAXDIMS];
+    for (int i = 0; i < ndims; i++)
+      count[i] = state->max_coords[i] + 1;
+    state->bm = bitmatrix_make(count, ndims);
     *ntiles = tpoint_set_tiles(temp, state, state->bm);
   }
   else
@@ -1364,6 +1390,71 @@ tgeo_space_time_tile_init(const Temporal *temp, double xsize, double ysize,
   return state;
 }
 
+/**
+ * @brief Arguments of the tasks restricting a temporal geo to the tiles of a
+ * grid
+ */
+typedef struct
+{
+  const Temporal *temp;     /**< Temporal geo */
+  const STBox *boxes;       /**< Tiles */
+  Temporal **result;        /**< Restriction to each tile, may be `NULL` */
+} TgeoSplitTasks;
+
+/**
+ * @brief Restrict a temporal geo to the n-th tile of a grid
+ */
+static void
+tgeo_split_task(void *arg, int task)
+{
+  TgeoSplitTasks *tasks = (TgeoSplitTasks *) arg;
+  tasks->result[task] = tgeo_restrict_stbox(tasks->temp, &tasks->boxes[task],
+    BORDER_EXC, REST_AT);
+  return;
+}
+
+/**
+ * @brief Return the fragments of a temporal geo split according to a grid
+ * by the threads of the MEOS thread pool
+ * @details The tiles are enumerated first and the temporal geo is restricted
+ * to each of them in parallel, the fragments being kept in the order of the
+ * tiles as in #tgeo_space_time_split
+ */
+static int
+tgeo_space_time_split_parallel(STboxGridState *state, int ntiles,
+  int nthreads, bool hasduration, Temporal **result, GSERIALIZED **spaces,
+  TimestampTz *times)
+{
+  STBox *boxes = palloc(sizeof(STBox) * ntiles);
+  int nboxes = 0;
+  while (! state->done && nboxes < ntiles &&
+    stbox_tile_state_get(state, &boxes[nboxes]))
+  {
+    stbox_tile_state_next(state);
+    nboxes++;
+  }
+  TgeoSplitTasks tasks;
+  tasks.temp = state->temp;
+  tasks.boxes = boxes;
+  tasks.result = palloc(sizeof(Temporal *) * nboxes);
+  meos_parallel_for(nthreads, nboxes, &tgeo_split_task, &tasks);
+  bool hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
+  int count = 0;
+  for (int i = 0; i < nboxes; i++)
+  {
+    if (tasks.result[i] == NULL)
+      continue;
+    const STBox *box = &boxes[i];
+    spaces[count] = geopoint_make(box->xmin, box->ymin, box->zmin, hasz,
+      false, box->srid);
+    if (hasduration)
+      times[count] = DatumGetTimestampTz(box->period.lower);
+    result[count++] = tasks.result[i];
+  }
+  pfree(tasks.result); pfree(boxes);
+  return count;
+}
+
 /**
  * @ingroup meos_geo_tile
  * @brief Return the fragments a temporal geo split according to a space and
@@ -1413,6 +1504,17 @@ tgeo_space_time_split(const Temporal *temp, double xsize, double ysize,
   if (duration)
     times = palloc(sizeof(TimestampTz) * ntiles);
   Temporal **result = palloc(sizeof(Temporal *) * ntiles);
+  int nthreads = meos_parallel_pool_threads(temporal_num_instants(temp),
+    ntiles);
+  if (nthreads > 1)
+  {
+    int count = tgeo_space_time_split_parallel(state, ntiles, nthreads,
+      duration != NULL, result, spaces, times);
+    if (state->bm)
+      pfree(state->bm);
+    pfree(state);
+    return (SpaceTimeSplit) {result, spaces, times, count};
+  }
   bool hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
   int i = 0;
   /* We need to loop since atStbox may be NULL */
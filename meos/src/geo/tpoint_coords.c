@@ -0,0 +1,130 @@
+/***********************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Packed coordinate arrays of temporal point sequences
+ * @details The instants of a temporal point sequence are stored as an array
+ * of serialized points, each one with its own header. The kernels that only
+ * read the coordinates, such as the speed, the simplification, or the tiling
+ * of a sequence, copy the timestamps and the coordinates into contiguous
+ * arrays, either for the whole sequence with #tpointseq_coords or by chunks
+ * of #TPOINT_COORDS_CHUNK instants with #tpointseq_coords_fill, and then run
+ * over these arrays.
+ */
+
+#include "geo/tpoint_coords.h"
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* PostGIS */
+#include <liblwgeom.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+
+/*****************************************************************************/
+
+/**
+ * @brief Copy the timestamps and the coordinates of a range of instants of a
+ * temporal point sequence into the arrays given as arguments
+ * @param[in] seq Temporal point sequence
+ * @param[in] from Index of the first instant
+ * @param[in] count Number of instants
+ * @param[out] t Timestamps, may be @p NULL
+ * @param[out] x,y X and Y coordinates
+ * @param[out] z Z coordinates, may be @p NULL, set to 0 when the sequence has
+ * no Z dimension
+ */
+void
+tpointseq_coords_fill(const TSequence *seq, int from, int count,
+  TimestampTz *t, double *x, double *y, double *z)
+{
+  assert(seq); assert(tpoint_type(seq->temptype)); assert(x); assert(y);
+  assert(from >= 0 && count >= 0 && from + count <= seq->count);
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  for (int i = 0; i < count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, from + i);
+    Datum value = tinstant_value_p(inst);
+    if (t)
+      t[i] = inst->t;
+    if (hasz)
+    {
+      const POINT3DZ *p = DATUM_POINT3DZ_P(value);
+      x[i] = p->x; y[i] = p->y;
+      if (z)
+        z[i] = p->z;
+    }
+    else
+    {
+      const POINT2D *p = DATUM_POINT2D_P(value);
+      x[i] = p->x; y[i] = p->y;
+      if (z)
+        z[i] = 0.0;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return the packed coordinate arrays of a temporal point sequence
+ * @param[in] seq Temporal point sequence
+ * @note The result is allocated in a single memory block
+ */
+TPointCoords *
+tpointseq_coords(const TSequence *seq)
+{
+  assert(seq); assert(tpoint_type(seq->temptype));
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int count = seq->count;
+  /* The timestamps and the doubles have the same alignment */
+  size_t size = DOUBLE_PAD(sizeof(TPointCoords)) +
+    sizeof(TimestampTz) * count + sizeof(double) * count * (hasz ? 3 : 2);
+  TPointCoords *result = palloc(size);
+  char *ptr = (char *) result + DOUBLE_PAD(sizeof(TPointCoords));
+  result->count = count;
+  result->srid = tspatial_srid((Temporal *) seq);
+  result->flags = seq->flags;
+  result->t = (TimestampTz *) ptr;
+  ptr += sizeof(TimestampTz) * count;
+  result->x = (double *) ptr;
+  ptr += sizeof(double) * count;
+  result->y = (double *) ptr;
+  ptr += sizeof(double) * count;
+  result->z = hasz ? (double *) ptr : NULL;
+  tpointseq_coords_fill(seq, 0, count, result->t, result->x, result->y,
+    result->z);
+  return result;
+}
+
+/*****************************************************************************/
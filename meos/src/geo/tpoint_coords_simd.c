@@ -0,0 +1,655 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Kernels computing the segments of temporal point sequences from
+ * packed coordinate arrays
+ * @details The kernels in this file read the coordinates of consecutive
+ * instants from the packed arrays filled by #tpointseq_coords_fill and
+ * compute one value per segment or per point:
+ * - #tpoint_coords_seglength sets `result[i]` to the length of the segment
+ *   between the points `i` and `i + 1`, which is used for the length, the
+ *   cumulative length and the speed of temporal points
+ * - #tpoint_coords_segdist2 sets `result[i]` to the square of the distance
+ *   between the point `i` and a segment, which is used for finding the splits
+ *   of the Douglas-Peucker simplification
+ *
+ * The vector kernels perform the same operations in the same order as the
+ * scalar ones and the square root is correctly rounded, so that all versions
+ * return the same values. Each kernel comes in a scalar version, which is
+ * also used for the last points of an array, an SSE2 version for x86-64 and
+ * a Neon version for aarch64, and AVX2 and AVX-512 versions that are selected
+ * at the first call when the processor supports them, as done for the RTree
+ * kernels in temporal_rtree_simd.c.
+ */
+
+/* C */
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include "port/simd.h"
+/* MEOS */
+#include "geo/tpoint_coords.h"
+
+/* The AVX2 and AVX-512 kernels are compiled with a function target attribute
+ * and selected at run time, which requires GCC or Clang on x86 */
+#if defined(USE_SSE2) && defined(__GNUC__)
+  #define USE_AVX2_WITH_RUNTIME_CHECK
+  #define USE_AVX512_WITH_RUNTIME_CHECK
+  #include <immintrin.h>
+#endif
+
+/*****************************************************************************
+ * Scalar kernels
+ *****************************************************************************/
+
+/**
+ * @brief Set the lengths of the segments defined by consecutive points, one
+ * segment at a time
+ * @param[in] x,y,z Coordinates of the points, @p z is @p NULL for 2D points
+ * @param[in] count Number of points
+ * @param[out] result Array of `count - 1` lengths
+ */
+static void
+tpoint_seglength_scalar(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  for (int i = 1; i < count; i++)
+  {
+    double dx = x[i - 1] - x[i], dy = y[i - 1] - y[i];
+    if (z)
+    {
+      double dz = z[i - 1] - z[i];
+      result[i - 1] = sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    else
+      result[i - 1] = sqrt(dx * dx + dy * dy);
+  }
+  return;
+}
+
+/**
+ * @brief Set the squared distances between the points and a segment, one
+ * point at a time
+ * @details The closest point of the segment is computed as in the PostGIS
+ * functions @p lw_dist2d_pt_seg and @p lw_dist3d_pt_seg
+ * @param[in] x,y,z Coordinates of the points, @p z is @p NULL for 2D points
+ * @param[in] count Number of points
+ * @param[in] a,b Coordinates of the start and end points of the segment,
+ * @p b is @p NULL when the segment is reduced to the point @p a
+ * @param[out] result Array of @p count squared distances
+ */
+static void
+tpoint_segdist2_scalar(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  double abx = 0.0, aby = 0.0, abz = 0.0, len2 = 0.0;
+  if (b)
+  {
+    abx = b[0] - a[0]; aby = b[1] - a[1];
+    len2 = abx * abx + aby * aby;
+    if (z)
+    {
+      abz = b[2] - a[2];
+      len2 += abz * abz;
+    }
+  }
+  for (int i = 0; i < count; i++)
+  {
+    double cx = a[0], cy = a[1], cz = z ? a[2] : 0.0;
+    if (b)
+    {
+      double num = (x[i] - a[0]) * abx + (y[i] - a[1]) * aby;
+      if (z)
+        num += (z[i] - a[2]) * abz;
+      double r = num / len2;
+      if (r > 1)
+      {
+        cx = b[0]; cy = b[1]; cz = z ? b[2] : 0.0;
+      }
+      else if (! (r < 0))
+      {
+        cx = a[0] + r * abx; cy = a[1] + r * aby;
+        cz = z ? a[2] + r * abz : 0.0;
+      }
+    }
+    double dx = cx - x[i], dy = cy - y[i];
+    result[i] = dx * dx + dy * dy;
+    if (z)
+    {
+      double dz = cz - z[i];
+      result[i] += dz * dz;
+    }
+  }
+  return;
+}
+
+/*****************************************************************************
+ * Two-lane kernels
+ *****************************************************************************/
+
+#if defined(USE_SSE2)
+
+/**
+ * @brief Set the lengths of the segments defined by consecutive points, two
+ * segments at a time with SSE2
+ */
+static void
+tpoint_seglength_sse2(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  int i = 1;
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i - 1), _mm_loadu_pd(x + i));
+    __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i - 1), _mm_loadu_pd(y + i));
+    __m128d sum = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    if (z)
+    {
+      __m128d dz = _mm_sub_pd(_mm_loadu_pd(z + i - 1), _mm_loadu_pd(z + i));
+      sum = _mm_add_pd(sum, _mm_mul_pd(dz, dz));
+    }
+    _mm_storeu_pd(result + i - 1, _mm_sqrt_pd(sum));
+  }
+  if (i < count)
+    tpoint_seglength_scalar(x + i - 1, y + i - 1, z ? z + i - 1 : NULL,
+      count - i + 1, result + i - 1);
+  return;
+}
+
+/**
+ * @brief Return the values of @p a where @p mask is set and the values of
+ * @p b elsewhere
+ */
+static inline __m128d
+tpoint_select_sse2(__m128d mask, __m128d a, __m128d b)
+{
+  return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+/**
+ * @brief Set the squared distances between the points and a segment, two
+ * points at a time with SSE2
+ */
+static void
+tpoint_segdist2_sse2(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  __m128d ax = _mm_set1_pd(a[0]), ay = _mm_set1_pd(a[1]),
+    az = _mm_set1_pd(z ? a[2] : 0.0);
+  __m128d bx = ax, by = ay, bz = az, abx = ax, aby = ay, abz = az, len2 = ax;
+  if (b)
+  {
+    double sabx = b[0] - a[0], saby = b[1] - a[1], sabz = 0.0;
+    double slen2 = sabx * sabx + saby * saby;
+    if (z)
+    {
+      sabz = b[2] - a[2];
+      slen2 += sabz * sabz;
+    }
+    bx = _mm_set1_pd(b[0]); by = _mm_set1_pd(b[1]);
+    bz = _mm_set1_pd(z ? b[2] : 0.0);
+    abx = _mm_set1_pd(sabx); aby = _mm_set1_pd(saby);
+    abz = _mm_set1_pd(sabz); len2 = _mm_set1_pd(slen2);
+  }
+  __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+  int i = 0;
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128d px = _mm_loadu_pd(x + i), py = _mm_loadu_pd(y + i);
+    __m128d pz = z ? _mm_loadu_pd(z + i) : zero;
+    __m128d cx = ax, cy = ay, cz = az;
+    if (b)
+    {
+      __m128d num = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(px, ax), abx),
+        _mm_mul_pd(_mm_sub_pd(py, ay), aby));
+      if (z)
+        num = _mm_add_pd(num, _mm_mul_pd(_mm_sub_pd(pz, az), abz));
+      __m128d r = _mm_div_pd(num, len2);
+      __m128d lt = _mm_cmplt_pd(r, zero), gt = _mm_cmpgt_pd(r, one);
+      cx = tpoint_select_sse2(lt, ax, tpoint_select_sse2(gt, bx,
+        _mm_add_pd(ax, _mm_mul_pd(r, abx))));
+      cy = tpoint_select_sse2(lt, ay, tpoint_select_sse2(gt, by,
+        _mm_add_pd(ay, _mm_mul_pd(r, aby))));
+      if (z)
+        cz = tpoint_select_sse2(lt, az, tpoint_select_sse2(gt, bz,
+          _mm_add_pd(az, _mm_mul_pd(r, abz))));
+    }
+    __m128d dx = _mm_sub_pd(cx, px), dy = _mm_sub_pd(cy, py);
+    __m128d sum = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    if (z)
+    {
+      __m128d dz = _mm_sub_pd(cz, pz);
+      sum = _mm_add_pd(sum, _mm_mul_pd(dz, dz));
+    }
+    _mm_storeu_pd(result + i, sum);
+  }
+  if (i < count)
+    tpoint_segdist2_scalar(x + i, y + i, z ? z + i : NULL, count - i, a, b,
+      result + i);
+  return;
+}
+
+#elif defined(USE_NEON)
+
+/**
+ * @brief Set the lengths of the segments defined by consecutive points, two
+ * segments at a time with Neon
+ */
+static void
+tpoint_seglength_neon(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  int i = 1;
+  for (; i + 2 <= count; i += 2)
+  {
+    float64x2_t dx = vsubq_f64(vld1q_f64(x + i - 1), vld1q_f64(x + i));
+    float64x2_t dy = vsubq_f64(vld1q_f64(y + i - 1), vld1q_f64(y + i));
+    float64x2_t sum = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+    if (z)
+    {
+      float64x2_t dz = vsubq_f64(vld1q_f64(z + i - 1), vld1q_f64(z + i));
+      sum = vaddq_f64(sum, vmulq_f64(dz, dz));
+    }
+    vst1q_f64(result + i - 1, vsqrtq_f64(sum));
+  }
+  if (i < count)
+    tpoint_seglength_scalar(x + i - 1, y + i - 1, z ? z + i - 1 : NULL,
+      count - i + 1, result + i - 1);
+  return;
+}
+
+/**
+ * @brief Set the squared distances between the points and a segment, two
+ * points at a time with Neon
+ */
+static void
+tpoint_segdist2_neon(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  float64x2_t ax = vdupq_n_f64(a[0]), ay = vdupq_n_f64(a[1]),
+    az = vdupq_n_f64(z ? a[2] : 0.0);
+  float64x2_t bx = ax, by = ay, bz = az, abx = ax, aby = ay, abz = az,
+    len2 = ax;
+  if (b)
+  {
+    double sabx = b[0] - a[0], saby = b[1] - a[1], sabz = 0.0;
+    double slen2 = sabx * sabx + saby * saby;
+    if (z)
+    {
+      sabz = b[2] - a[2];
+      slen2 += sabz * sabz;
+    }
+    bx = vdupq_n_f64(b[0]); by = vdupq_n_f64(b[1]);
+    bz = vdupq_n_f64(z ? b[2] : 0.0);
+    abx = vdupq_n_f64(sabx); aby = vdupq_n_f64(saby);
+    abz = vdupq_n_f64(sabz); len2 = vdupq_n_f64(slen2);
+  }
+  float64x2_t zero = vdupq_n_f64(0.0), one = vdupq_n_f64(1.0);
+  int i = 0;
+  for (; i + 2 <= count; i += 2)
+  {
+    float64x2_t px = vld1q_f64(x + i), py = vld1q_f64(y + i);
+    float64x2_t pz = z ? vld1q_f64(z + i) : zero;
+    float64x2_t cx = ax, cy = ay, cz = az;
+    if (b)
+    {
+      float64x2_t num = vaddq_f64(vmulq_f64(vsubq_f64(px, ax), abx),
+        vmulq_f64(vsubq_f64(py, ay), aby));
+      if (z)
+        num = vaddq_f64(num, vmulq_f64(vsubq_f64(pz, az), abz));
+      float64x2_t r = vdivq_f64(num, len2);
+      uint64x2_t lt = vcltq_f64(r, zero), gt = vcgtq_f64(r, one);
+      cx = vbslq_f64(lt, ax, vbslq_f64(gt, bx,
+        vaddq_f64(ax, vmulq_f64(r, abx))));
+      cy = vbslq_f64(lt, ay, vbslq_f64(gt, by,
+        vaddq_f64(ay, vmulq_f64(r, aby))));
+      if (z)
+        cz = vbslq_f64(lt, az, vbslq_f64(gt, bz,
+          vaddq_f64(az, vmulq_f64(r, abz))));
+    }
+    float64x2_t dx = vsubq_f64(cx, px), dy = vsubq_f64(cy, py);
+    float64x2_t sum = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+    if (z)
+    {
+      float64x2_t dz = vsubq_f64(cz, pz);
+      sum = vaddq_f64(sum, vmulq_f64(dz, dz));
+    }
+    vst1q_f64(result + i, sum);
+  }
+  if (i < count)
+    tpoint_segdist2_scalar(x + i, y + i, z ? z + i : NULL, count - i, a, b,
+      result + i);
+  return;
+}
+
+#endif /* USE_SSE2 / USE_NEON */
+
+/*****************************************************************************
+ * AVX2 kernels
+ *****************************************************************************/
+
+#ifdef USE_AVX2_WITH_RUNTIME_CHECK
+
+/**
+ * @brief Set the lengths of the segments defined by consecutive points, four
+ * segments at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static void
+tpoint_seglength_avx2(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  int i = 1;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i - 1),
+      _mm256_loadu_pd(x + i));
+    __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i - 1),
+      _mm256_loadu_pd(y + i));
+    __m256d sum = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    if (z)
+    {
+      __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i - 1),
+        _mm256_loadu_pd(z + i));
+      sum = _mm256_add_pd(sum, _mm256_mul_pd(dz, dz));
+    }
+    _mm256_storeu_pd(result + i - 1, _mm256_sqrt_pd(sum));
+  }
+  if (i < count)
+    tpoint_seglength_scalar(x + i - 1, y + i - 1, z ? z + i - 1 : NULL,
+      count - i + 1, result + i - 1);
+  return;
+}
+
+/**
+ * @brief Set the squared distances between the points and a segment, four
+ * points at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static void
+tpoint_segdist2_avx2(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  __m256d ax = _mm256_set1_pd(a[0]), ay = _mm256_set1_pd(a[1]),
+    az = _mm256_set1_pd(z ? a[2] : 0.0);
+  __m256d bx = ax, by = ay, bz = az, abx = ax, aby = ay, abz = az, len2 = ax;
+  if (b)
+  {
+    double sabx = b[0] - a[0], saby = b[1] - a[1], sabz = 0.0;
+    double slen2 = sabx * sabx + saby * saby;
+    if (z)
+    {
+      sabz = b[2] - a[2];
+      slen2 += sabz * sabz;
+    }
+    bx = _mm256_set1_pd(b[0]); by = _mm256_set1_pd(b[1]);
+    bz = _mm256_set1_pd(z ? b[2] : 0.0);
+    abx = _mm256_set1_pd(sabx); aby = _mm256_set1_pd(saby);
+    abz = _mm256_set1_pd(sabz); len2 = _mm256_set1_pd(slen2);
+  }
+  __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256d px = _mm256_loadu_pd(x + i), py = _mm256_loadu_pd(y + i);
+    __m256d pz = z ? _mm256_loadu_pd(z + i) : zero;
+    __m256d cx = ax, cy = ay, cz = az;
+    if (b)
+    {
+      __m256d num = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(px, ax), abx),
+        _mm256_mul_pd(_mm256_sub_pd(py, ay), aby));
+      if (z)
+        num = _mm256_add_pd(num,
+          _mm256_mul_pd(_mm256_sub_pd(pz, az), abz));
+      __m256d r = _mm256_div_pd(num, len2);
+      __m256d lt = _mm256_cmp_pd(r, zero, _CMP_LT_OQ),
+        gt = _mm256_cmp_pd(r, one, _CMP_GT_OQ);
+      cx = _mm256_blendv_pd(_mm256_blendv_pd(
+        _mm256_add_pd(ax, _mm256_mul_pd(r, abx)), bx, gt), ax, lt);
+      cy = _mm256_blendv_pd(_mm256_blendv_pd(
+        _mm256_add_pd(ay, _mm256_mul_pd(r, aby)), by, gt), ay, lt);
+      if (z)
+        cz = _mm256_blendv_pd(_mm256_blendv_pd(
+          _mm256_add_pd(az, _mm256_mul_pd(r, abz)), bz, gt), az, lt);
+    }
+    __m256d dx = _mm256_sub_pd(cx, px), dy = _mm256_sub_pd(cy, py);
+    __m256d sum = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    if (z)
+    {
+      __m256d dz = _mm256_sub_pd(cz, pz);
+      sum = _mm256_add_pd(sum, _mm256_mul_pd(dz, dz));
+    }
+    _mm256_storeu_pd(result + i, sum);
+  }
+  if (i < count)
+    tpoint_segdist2_scalar(x + i, y + i, z ? z + i : NULL, count - i, a, b,
+      result + i);
+  return;
+}
+
+#endif /* USE_AVX2_WITH_RUNTIME_CHECK */
+
+/*****************************************************************************
+ * AVX-512 kernels
+ *
+ * The fused multiply-add instructions are part of AVX-512F. The arithmetic
+ * is written with the intrinsics taking an explicit rounding mode so that
+ * the compiler does not contract a product and a sum into a single rounding,
+ * which would change the results. The last points of an array are handled
+ * with masked loads and stores.
+ *****************************************************************************/
+
+#ifdef USE_AVX512_WITH_RUNTIME_CHECK
+
+#define AVX512_ROUND (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define AVX512_ADD(a, b) _mm512_add_round_pd((a), (b), AVX512_ROUND)
+#define AVX512_SUB(a, b) _mm512_sub_round_pd((a), (b), AVX512_ROUND)
+#define AVX512_MUL(a, b) _mm512_mul_round_pd((a), (b), AVX512_ROUND)
+
+/**
+ * @brief Return the mask of the lanes of a vector of eight values that hold
+ * one of the @p count values left
+ */
+#define AVX512_COUNT_MASK(count) \
+  ( (count) >= 8 ? (__mmask8) 0xFF : (__mmask8) ((1u << (count)) - 1) )
+
+/**
+ * @brief Set the lengths of the segments defined by consecutive points,
+ * eight segments at a time with AVX-512
+ */
+__attribute__((target("avx512f")))
+static void
+tpoint_seglength_avx512(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  for (int i = 1; i < count; i += 8)
+  {
+    __mmask8 k = AVX512_COUNT_MASK(count - i);
+    __m512d dx = AVX512_SUB(_mm512_maskz_loadu_pd(k, x + i - 1),
+      _mm512_maskz_loadu_pd(k, x + i));
+    __m512d dy = AVX512_SUB(_mm512_maskz_loadu_pd(k, y + i - 1),
+      _mm512_maskz_loadu_pd(k, y + i));
+    __m512d sum = AVX512_ADD(AVX512_MUL(dx, dx), AVX512_MUL(dy, dy));
+    if (z)
+    {
+      __m512d dz = AVX512_SUB(_mm512_maskz_loadu_pd(k, z + i - 1),
+        _mm512_maskz_loadu_pd(k, z + i));
+      sum = AVX512_ADD(sum, AVX512_MUL(dz, dz));
+    }
+    _mm512_mask_storeu_pd(result + i - 1, k,
+      _mm512_sqrt_round_pd(sum, AVX512_ROUND));
+  }
+  return;
+}
+
+/**
+ * @brief Set the squared distances between the points and a segment, eight
+ * points at a time with AVX-512
+ */
+__attribute__((target("avx512f")))
+static void
+tpoint_segdist2_avx512(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  __m512d ax = _mm512_set1_pd(a[0]), ay = _mm512_set1_pd(a[1]),
+    az = _mm512_set1_pd(z ? a[2] : 0.0);
+  __m512d bx = ax, by = ay, bz = az, abx = ax, aby = ay, abz = az, len2 = ax;
+  if (b)
+  {
+    bx = _mm512_set1_pd(b[0]); by = _mm512_set1_pd(b[1]);
+    bz = _mm512_set1_pd(z ? b[2] : 0.0);
+    abx = AVX512_SUB(bx, ax); aby = AVX512_SUB(by, ay);
+    len2 = AVX512_ADD(AVX512_MUL(abx, abx), AVX512_MUL(aby, aby));
+    if (z)
+    {
+      abz = AVX512_SUB(bz, az);
+      len2 = AVX512_ADD(len2, AVX512_MUL(abz, abz));
+    }
+  }
+  __m512d zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1.0);
+  for (int i = 0; i < count; i += 8)
+  {
+    __mmask8 k = AVX512_COUNT_MASK(count - i);
+    __m512d px = _mm512_maskz_loadu_pd(k, x + i),
+      py = _mm512_maskz_loadu_pd(k, y + i);
+    __m512d pz = z ? _mm512_maskz_loadu_pd(k, z + i) : zero;
+    __m512d cx = ax, cy = ay, cz = az;
+    if (b)
+    {
+      __m512d num = AVX512_ADD(AVX512_MUL(AVX512_SUB(px, ax), abx),
+        AVX512_MUL(AVX512_SUB(py, ay), aby));
+      if (z)
+        num = AVX512_ADD(num, AVX512_MUL(AVX512_SUB(pz, az), abz));
+      __m512d r = _mm512_div_round_pd(num, len2, AVX512_ROUND);
+      __mmask8 lt = _mm512_cmp_pd_mask(r, zero, _CMP_LT_OQ),
+        gt = _mm512_cmp_pd_mask(r, one, _CMP_GT_OQ);
+      cx = _mm512_mask_blend_pd(lt, _mm512_mask_blend_pd(gt,
+        AVX512_ADD(ax, AVX512_MUL(r, abx)), bx), ax);
+      cy = _mm512_mask_blend_pd(lt, _mm512_mask_blend_pd(gt,
+        AVX512_ADD(ay, AVX512_MUL(r, aby)), by), ay);
+      if (z)
+        cz = _mm512_mask_blend_pd(lt, _mm512_mask_blend_pd(gt,
+          AVX512_ADD(az, AVX512_MUL(r, abz)), bz), az);
+    }
+    __m512d dx = AVX512_SUB(cx, px), dy = AVX512_SUB(cy, py);
+    __m512d sum = AVX512_ADD(AVX512_MUL(dx, dx), AVX512_MUL(dy, dy));
+    if (z)
+    {
+      __m512d dz = AVX512_SUB(cz, pz);
+      sum = AVX512_ADD(sum, AVX512_MUL(dz, dz));
+    }
+    _mm512_mask_storeu_pd(result + i, k, sum);
+  }
+  return;
+}
+
+#endif /* USE_AVX512_WITH_RUNTIME_CHECK */
+
+/*****************************************************************************
+ * Run-time selection of the kernels
+ *****************************************************************************/
+
+static void tpoint_seglength_choose(const double *x, const double *y,
+  const double *z, int count, double *result);
+static void tpoint_segdist2_choose(const double *x, const double *y,
+  const double *z, int count, const double *a, const double *b,
+  double *result);
+
+/**
+ * @brief Kernel computing the lengths of the segments defined by consecutive
+ * points
+ */
+void (*tpoint_coords_seglength)(const double *x, const double *y,
+  const double *z, int count, double *result) = tpoint_seglength_choose;
+
+/**
+ * @brief Kernel computing the squared distances between points and a segment
+ */
+void (*tpoint_coords_segdist2)(const double *x, const double *y,
+  const double *z, int count, const double *a, const double *b,
+  double *result) = tpoint_segdist2_choose;
+
+/**
+ * @brief Set the kernels to the widest version the processor supports
+ * @note Several threads may run this at once; they all store the same
+ * function pointers
+ */
+static void
+tpoint_coords_choose_kernels(void)
+{
+#if defined(USE_AVX512_WITH_RUNTIME_CHECK)
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    tpoint_coords_seglength = tpoint_seglength_avx512;
+    tpoint_coords_segdist2 = tpoint_segdist2_avx512;
+    return;
+  }
+#endif
+#if defined(USE_AVX2_WITH_RUNTIME_CHECK)
+  if (__builtin_cpu_supports("avx2"))
+  {
+    tpoint_coords_seglength = tpoint_seglength_avx2;
+    tpoint_coords_segdist2 = tpoint_segdist2_avx2;
+    return;
+  }
+#endif
+#if defined(USE_SSE2)
+  tpoint_coords_seglength = tpoint_seglength_sse2;
+  tpoint_coords_segdist2 = tpoint_segdist2_sse2;
+#elif defined(USE_NEON)
+  tpoint_coords_seglength = tpoint_seglength_neon;
+  tpoint_coords_segdist2 = tpoint_segdist2_neon;
+#else
+  tpoint_coords_seglength = tpoint_seglength_scalar;
+  tpoint_coords_segdist2 = tpoint_segdist2_scalar;
+#endif
+  return;
+}
+
+static void
+tpoint_seglength_choose(const double *x, const double *y, const double *z,
+  int count, double *result)
+{
+  tpoint_coords_choose_kernels();
+  tpoint_coords_seglength(x, y, z, count, result);
+  return;
+}
+
+static void
+tpoint_segdist2_choose(const double *x, const double *y, const double *z,
+  int count, const double *a, const double *b, double *result)
+{
+  tpoint_coords_choose_kernels();
+  tpoint_coords_segdist2(x, y, z, count, a, b, result);
+  return;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,469 @@
+/***********************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Cumulative-length index of temporal point sequences
+ * @details The length traversed by a temporal point sequence, the position
+ * reached after travelling a given distance, or the restriction of a
+ * sequence to a range of travelled distances require a scan of all its
+ * segments. An index built once for a sequence keeps its timestamps and the
+ * length travelled at each of its instants in contiguous arrays, so that
+ * these queries are answered by a binary search over the arrays followed by
+ * an interpolation within a single segment.
+ *
+ * The index is an in-memory structure that refers to the sequence from
+ * which it is built. The serialized format of the sequences is unchanged.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <lwgeodetic.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_geo.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "temporal/temporal.h"
+#include "temporal/tsequence.h"
+#include "temporal/type_util.h"
+#include "geo/geo_funcs.h"
+#include "geo/tgeo_spatialfuncs.h"
+#include "geo/tpoint_coords.h"
+
+/**
+ * @brief Cumulative-length index of a temporal point sequence
+ * @details The arrays are allocated in the same memory block as the
+ * structure
+ */
+struct TPointIndex
+{
+  const TSequence *seq;   /**< Indexed sequence, which is not copied */
+  int count;              /**< Number of instants */
+  TimestampTz *t;         /**< Timestamps of the instants */
+  double *length;         /**< Length travelled at each instant */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Set the lengths travelled at the instants of a temporal geometry
+ * point sequence
+ * @details The coordinates are read by chunks of packed arrays and the
+ * lengths of the segments are computed with #tpoint_coords_seglength as in
+ * #tpoint_length
+ */
+static void
+tpointindex_set_length_geom(const TSequence *seq, double *length)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK], seglength[TPOINT_COORDS_CHUNK];
+  double total = 0.0;
+  length[0] = total;
+  for (int from = 0; from < seq->count - 1; from += TPOINT_COORDS_CHUNK - 1)
+  {
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, NULL, x, y, hasz ? z : NULL);
+    tpoint_coords_seglength(x, y, hasz ? z : NULL, count, seglength);
+    for (int i = 1; i < count; i++)
+    {
+      total += seglength[i - 1];
+      length[from + i] = total;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Set the lengths travelled at the instants of a temporal geography
+ * point sequence
+ * @details The length of each segment is computed on the spheroid of the
+ * SRID of the sequence as done by PostGIS for the length of a geography
+ */
+static void
+tpointindex_set_length_geog(const TSequence *seq, double *length)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  SPHEROID s;
+  spheroid_init_from_srid(tspatial_srid((Temporal *) seq), &s);
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK];
+  GEOGRAPHIC_POINT a, b;
+  double za = 0.0, total = 0.0;
+  for (int from = 0; from < seq->count; from += TPOINT_COORDS_CHUNK)
+  {
+    int n = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, n, NULL, x, y, hasz ? z : NULL);
+    for (int i = 0; i < n; i++)
+    {
+      geographic_point_init(x[i], y[i], &b);
+      if (from + i > 0)
+      {
+        double seglength = (s.a == s.b) ? s.radius * sphere_distance(&a, &b) :
+          spheroid_distance(&a, &b, &s);
+        if (hasz)
+          seglength = sqrt((z[i] - za) * (z[i] - za) + seglength * seglength);
+        total += seglength;
+      }
+      length[from + i] = total;
+      a = b;
+      if (hasz)
+        za = z[i];
+    }
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return the cumulative-length index of a temporal point sequence
+ * @details The index refers to the sequence, which must not be freed before
+ * the index
+ * @param[in] temp Temporal point sequence with linear interpolation
+ * @return On error return @p NULL
+ * @see #tpointindex_free()
+ */
+TPointIndex *
+tpointindex_make(const Temporal *temp)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_TPOINT(temp, NULL);
+  if (! ensure_temporal_isof_subtype(temp, TSEQUENCE) ||
+      ! ensure_linear_interp(temp->flags))
+    return NULL;
+
+  const TSequence *seq = (const TSequence *) temp;
+  int count = seq->count;
+  /* The timestamps and the doubles have the same alignment */
+  size_t size = DOUBLE_PAD(sizeof(TPointIndex)) +
+    (sizeof(TimestampTz) + sizeof(double)) * count;
+  TPointIndex *result = palloc(size);
+  char *ptr = (char *) result + DOUBLE_PAD(sizeof(TPointIndex));
+  result->seq = seq;
+  result->count = count;
+  result->t = (TimestampTz *) ptr;
+  result->length = (double *) (ptr + sizeof(TimestampTz) * count);
+  for (int i = 0; i < count; i++)
+    result->t[i] = TSEQUENCE_INST_N(seq, i)->t;
+  if (MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    tpointindex_set_length_geog(seq, result->length);
+  else
+    tpointindex_set_length_geom(seq, result->length);
+  return result;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Free a cumulative-length index
+ * @param[in] idx Index
+ */
+void
+tpointindex_free(TPointIndex *idx)
+{
+  if (idx)
+    pfree(idx);
+  return;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return the length traversed by the sequence of a cumulative-length
+ * index
+ * @param[in] idx Index
+ * @return On error return @p DBL_MAX
+ * @see #tpoint_length()
+ */
+double
+tpointindex_length(const TPointIndex *idx)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(idx, DBL_MAX);
+  return idx->length[idx->count - 1];
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return the index of the last instant whose timestamp is less than
+ * or equal to a timestamp, which is in the period of the sequence, without
+ * returning the last instant
+ */
+static int
+tpointindex_find_timestamptz(const TPointIndex *idx, TimestampTz t)
+{
+  int first = 0, last = idx->count - 2;
+  while (first < last)
+  {
+    int middle = first + (last - first + 1) / 2;
+    if (idx->t[middle] <= t)
+      first = middle;
+    else
+      last = middle - 1;
+  }
+  return first;
+}
+
+/**
+ * @brief Return the index of the first instant whose travelled length is
+ * greater than or equal to a length, which is at most the total length
+ */
+static int
+tpointindex_find_length(const TPointIndex *idx, double length)
+{
+  int first = 0, last = idx->count - 1;
+  while (first < last)
+  {
+    int middle = first + (last - first) / 2;
+    if (idx->length[middle] >= length)
+      last = middle;
+    else
+      first = middle + 1;
+  }
+  return first;
+}
+
+/**
+ * @brief Return the timestamp at a fraction of the segment starting at an
+ * instant
+ */
+static inline TimestampTz
+tpointindex_segment_timestamptz(const TPointIndex *idx, int i, double ratio)
+{
+  return idx->t[i] + (TimestampTz) llround((double) (idx->t[i + 1] -
+    idx->t[i]) * ratio);
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return in the last argument the length travelled by the sequence of
+ * a cumulative-length index at a timestamptz
+ * @details Within a segment the length is proportional to the time elapsed
+ * since its start. The bounds of the sequence are considered inclusive.
+ * @param[in] idx Index
+ * @param[in] t Timestamp
+ * @param[out] result Length
+ * @return Return false when the timestamp is out of the period of the
+ * sequence or on error
+ */
+bool
+tpointindex_length_at_timestamptz(const TPointIndex *idx, TimestampTz t,
+  double *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(idx, false); VALIDATE_NOT_NULL(result, false);
+
+  if (t < idx->t[0] || t > idx->t[idx->count - 1])
+    return false;
+  if (idx->count == 1)
+  {
+    *result = 0.0;
+    return true;
+  }
+  int i = tpointindex_find_timestamptz(idx, t);
+  double ratio = (double) (t - idx->t[i]) /
+    (double) (idx->t[i + 1] - idx->t[i]);
+  *result = idx->length[i] + (idx->length[i + 1] - idx->length[i]) * ratio;
+  return true;
+}
+
+/**
+ * @brief Return the segment and the fraction of it where the sequence of an
+ * index has travelled a length for the first time
+ * @return Return false if the length is negative or greater than the length
+ * of the sequence
+ */
+static bool
+tpointindex_locate_length(const TPointIndex *idx, double length, int *seg,
+  double *ratio)
+{
+  if (length < 0.0 || length > idx->length[idx->count - 1])
+    return false;
+  int i = tpointindex_find_length(idx, length);
+  if (i == 0)
+  {
+    *seg = 0;
+    *ratio = 0.0;
+  }
+  else
+  {
+    /* The segment has a positive length since the previous instant is below
+     * the length */
+    *seg = i - 1;
+    *ratio = (length - idx->length[i - 1]) /
+      (idx->length[i] - idx->length[i - 1]);
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return in the last argument the first timestamp at which the
+ * sequence of a cumulative-length index has travelled a length
+ * @param[in] idx Index
+ * @param[in] length Length
+ * @param[out] result Timestamp
+ * @return Return false when the length is negative or greater than the
+ * length of the sequence or on error
+ */
+bool
+tpointindex_timestamptz_at_length(const TPointIndex *idx, double length,
+  TimestampTz *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(idx, false); VALIDATE_NOT_NULL(result, false);
+
+  int seg;
+  double ratio;
+  if (! tpointindex_locate_length(idx, length, &seg, &ratio))
+    return false;
+  *result = (idx->count == 1) ? idx->t[0] :
+    tpointindex_segment_timestamptz(idx, seg, ratio);
+  return true;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return the position of the sequence of a cumulative-length index
+ * when it has travelled a length for the first time
+ * @details The position of a geometry point is interpolated along its
+ * segment from the length, and the one of a geography point is the value of
+ * the segment at the timestamp of the length
+ * @param[in] idx Index
+ * @param[in] length Length
+ * @return Return @p NULL when the length is negative or greater than the
+ * length of the sequence or on error
+ */
+GSERIALIZED *
+tpointindex_value_at_length(const TPointIndex *idx, double length)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(idx, NULL);
+
+  int seg;
+  double ratio;
+  if (! tpointindex_locate_length(idx, length, &seg, &ratio))
+    return NULL;
+  const TSequence *seq = idx->seq;
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, seg);
+  if (idx->count == 1 || ratio == 0.0)
+    return DatumGetGserializedP(datum_copy(tinstant_value_p(inst1),
+      temptype_basetype(seq->temptype)));
+  const TInstant *inst2 = TSEQUENCE_INST_N(seq, seg + 1);
+  if (MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    return DatumGetGserializedP(tsegment_value_at_timestamptz(
+      tinstant_value_p(inst1), tinstant_value_p(inst2), seq->temptype,
+      inst1->t, inst2->t, tpointindex_segment_timestamptz(idx, seg, ratio)));
+
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  double x1, y1, z1 = 0.0, x2, y2, z2 = 0.0;
+  if (hasz)
+  {
+    const POINT3DZ *p1 = DATUM_POINT3DZ_P(tinstant_value_p(inst1));
+    const POINT3DZ *p2 = DATUM_POINT3DZ_P(tinstant_value_p(inst2));
+    x1 = p1->x; y1 = p1->y; z1 = p1->z;
+    x2 = p2->x; y2 = p2->y; z2 = p2->z;
+  }
+  else
+  {
+    const POINT2D *p1 = DATUM_POINT2D_P(tinstant_value_p(inst1));
+    const POINT2D *p2 = DATUM_POINT2D_P(tinstant_value_p(inst2));
+    x1 = p1->x; y1 = p1->y;
+    x2 = p2->x; y2 = p2->y;
+  }
+  return geopoint_make(x1 + (x2 - x1) * ratio, y1 + (y2 - y1) * ratio,
+    z1 + (z2 - z1) * ratio, hasz, false, tspatial_srid((Temporal *) seq));
+}
+
+/**
+ * @ingroup meos_geo_restrict
+ * @brief Return the sequence of a cumulative-length index restricted to the
+ * period in which its travelled length is between two values
+ * @details The period starts when the sequence has travelled the first
+ * length and ends when it starts travelling beyond the second one, so that a
+ * stop at the second length is included
+ * @param[in] idx Index
+ * @param[in] from,to Lengths
+ * @return Return @p NULL when the sequence does not travel a length between
+ * the two values or on error
+ */
+Temporal *
+tpointindex_at_length(const TPointIndex *idx, double from, double to)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(idx, NULL);
+  if (! ensure_not_negative_datum(Float8GetDatum(from), T_FLOAT8))
+    return NULL;
+  if (from > to)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The first length must be less than or equal to the second one");
+    return NULL;
+  }
+
+  TimestampTz lower, upper;
+  if (! tpointindex_timestamptz_at_length(idx, from, &lower))
+    return NULL;
+  /* Last instant whose travelled length is at most the second length */
+  int last = idx->count - 1;
+  if (to < idx->length[last])
+  {
+    int i = tpointindex_find_length(idx, to);
+    if (idx->length[i] > to)
+    {
+      /* The segment ending at the instant crosses the second length */
+      double ratio = (to - idx->length[i - 1]) /
+        (idx->length[i] - idx->length[i - 1]);
+      upper = tpointindex_segment_timestamptz(idx, i - 1, ratio);
+    }
+    else
+    {
+      /* Include the instants that do not travel beyond the second length */
+      while (i < last && idx->length[i + 1] == to)
+        i++;
+      upper = idx->t[i];
+    }
+  }
+  else
+    upper = idx->t[last];
+
+  Span s;
+  span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper), true, true,
+    T_TIMESTAMPTZ, T_TSTZSPAN, &s);
+  return tsequence_restrict_tstzspan(idx->seq, &s, REST_AT);
+}
+
+/*****************************************************************************/
@@ -58,6 +58,7 @@
 #include "geo/tgeo.h"
 #include "geo/tgeo_distance.h"
 #include "geo/tgeo_spatialfuncs.h"
+#include "geo/tpoint_coords.h"
 #if CBUFFER
   #include "cbuffer/cbuffer.h"
 #endif
@@ -2119,6 +2120,32 @@ tpointseq_length_3d(const TSequence *seq)
   return result;
 }
 
+/**
+ * @brief Return the length traversed by a temporal geometry point sequence
+ * @details The coordinates are read by chunks of packed arrays and the
+ * lengths of the segments are computed with #tpoint_coords_seglength. The
+ * lengths are added in the same order as in #tpointseq_length_2d and
+ * #tpointseq_length_3d, which return the same result.
+ * @pre The temporal point has linear interpolation
+ */
+static double
+tpointseq_length_planar(const TSequence *seq)
+{
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK], length[TPOINT_COORDS_CHUNK];
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  double result = 0.0;
+  for (int from = 0; from < seq->count - 1; from += TPOINT_COORDS_CHUNK - 1)
+  {
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, NULL, x, y, hasz ? z : NULL);
+    tpoint_coords_seglength(x, y, hasz ? z : NULL, count, length);
+    for (int i = 0; i < count - 1; i++)
+      result += length[i];
+  }
+  return result;
+}
+
 /**
  * @ingroup meos_internal_geo_accessor
  * @brief Return the length traversed by a temporal point sequence
@@ -2135,6 +2162,8 @@ tpointseq_length(const TSequence *seq)
 
   if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
   {
+    if (seq->count >= TPOINT_COORDS_SIMD_MIN)
+      return tpointseq_length_planar(seq);
     return MEOS_FLAGS_GET_Z(seq->flags) ?
       tpointseq_length_3d(seq) : tpointseq_length_2d(seq);
   }
@@ -2189,6 +2218,92 @@ tpoint_length(const Temporal *temp)
     return tpointseqset_length((TSequenceSet *) temp);
 }
 
+/**
+ * @brief Set the lengths of the segments defined by consecutive points of
+ * packed coordinate arrays as computed by the PostGIS distance functions
+ * @details In 3D the lengths are computed with #tpoint_coords_seglength. In
+ * 2D the function @p distance2d_pt_pt uses @p hypot, whose result may differ
+ * in the last place from the one of the kernel, and which is thus called one
+ * segment at a time.
+ * @param[in] x,y,z Coordinates of the points, @p z is @p NULL for 2D points
+ * @param[in] count Number of points
+ * @param[out] result Array of `count - 1` lengths
+ */
+static void
+tpointcoords_seglength_dist(const double *x, const double *y,
+  const double *z, int count, double *result)
+{
+  if (z)
+  {
+    tpoint_coords_seglength(x, y, z, count, result);
+    return;
+  }
+  for (int i = 1; i < count; i++)
+    result[i - 1] = hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+  return;
+}
+
+/**
+ * @brief Return the speed of a temporal geometry point sequence
+ * @details The result is the same as the one of #tsequence_derivative but
+ * the coordinates and the timestamps are read into packed arrays by chunks,
+ * the last instant of a chunk being the first instant of the next one
+ * @pre The sequence has linear interpolation and is not geodetic
+ */
+static TSequence *
+tpointseq_speed_planar(const TSequence *seq)
+{
+  /* Instantaneous sequence */
+  if (seq->count == 1)
+    return NULL;
+
+  /* General case */
+  TimestampTz t[TPOINT_COORDS_CHUNK];
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK], length[TPOINT_COORDS_CHUNK];
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  double speed = 0.0; /* make compiler quiet */
+  int ninsts = 0;
+  for (int from = 0; from < seq->count - 1; from += TPOINT_COORDS_CHUNK - 1)
+  {
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, t, x, y, hasz ? z : NULL);
+    tpointcoords_seglength_dist(x, y, hasz ? z : NULL, count, length);
+    for (int i = 1; i < count; i++)
+    {
+      /* The length of a segment between equal points is 0 */
+      speed = length[i - 1] / ((double)(t[i] - t[i - 1]) / 1000000);
+      instants[ninsts++] = tinstant_make(Float8GetDatum(speed), T_TFLOAT,
+        t[i - 1]);
+    }
+  }
+  instants[ninsts++] = tinstant_make(Float8GetDatum(speed), T_TFLOAT,
+    seq->period.upper);
+  /* The resulting sequence has step interpolation */
+  return tsequence_make_free(instants, ninsts, seq->period.lower_inc,
+    seq->period.upper_inc, STEP, NORMALIZE);
+}
+
+/**
+ * @brief Return the speed of a temporal geometry point sequence set
+ * @pre The sequence set has linear interpolation and is not geodetic
+ */
+static TSequenceSet *
+tpointseqset_speed_planar(const TSequenceSet *ss)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  int nseqs = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    if (seq->count > 1)
+      sequences[nseqs++] = tpointseq_speed_planar(seq);
+  }
+  /* The resulting sequence set has step interpolation */
+  return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
 /**
  * @ingroup meos_geo_accessor
  * @brief Return the speed of a temporal point sequence (set)
@@ -2199,11 +2314,59 @@ tpoint_length(const Temporal *temp)
 Temporal *
 tpoint_speed(const Temporal *temp)
 {
+  /* Planar points are read from packed coordinate arrays, all other cases
+   * are handled by the generic derivative */
+  if (temp && tpoint_type(temp->temptype) &&
+      MEOS_FLAGS_LINEAR_INTERP(temp->flags) &&
+      ! MEOS_FLAGS_GET_GEODETIC(temp->flags))
+  {
+    if (temp->subtype == TSEQUENCE)
+      return (Temporal *) tpointseq_speed_planar((TSequence *) temp);
+    if (temp->subtype == TSEQUENCESET)
+      return (Temporal *) tpointseqset_speed_planar((TSequenceSet *) temp);
+  }
   return temporal_derivative(temp);
 }
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the cumulative length traversed by a temporal geometry point
+ * sequence
+ * @details The result is the same as the one of the general case but the
+ * coordinates are read by chunks of packed arrays
+ * @param[in] seq Temporal sequence
+ * @param[in] prevlength Previous length to be added to the current sequence
+ * @pre The sequence has linear interpolation, is not geodetic and has more
+ * than one instant
+ */
+static TSequence *
+tpointseq_cumulative_length_planar(const TSequence *seq, double prevlength)
+{
+  TimestampTz t[TPOINT_COORDS_CHUNK];
+  double x[TPOINT_COORDS_CHUNK], y[TPOINT_COORDS_CHUNK],
+    z[TPOINT_COORDS_CHUNK], seglength[TPOINT_COORDS_CHUNK];
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  double length = prevlength;
+  instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+    TSEQUENCE_INST_N(seq, 0)->t);
+  for (int from = 0; from < seq->count - 1; from += TPOINT_COORDS_CHUNK - 1)
+  {
+    int count = Min(TPOINT_COORDS_CHUNK, seq->count - from);
+    tpointseq_coords_fill(seq, from, count, t, x, y, hasz ? z : NULL);
+    tpointcoords_seglength_dist(x, y, hasz ? z : NULL, count, seglength);
+    for (int i = 1; i < count; i++)
+    {
+      length += seglength[i - 1];
+      instants[from + i] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+        t[i]);
+    }
+  }
+  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+    seq->period.upper_inc, LINEAR, NORMALIZE);
+}
+
 /**
  * @ingroup meos_internal_geo_accessor
  * @brief Return the cumulative length traversed by a temporal point sequence
@@ -2226,6 +2389,10 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
     return tinstant_to_tsequence_free(inst, LINEAR);
   }
 
+  /* Planar points are read from packed coordinate arrays */
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    return tpointseq_cumulative_length_planar(seq, prevlength);
+
   /* General case */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   datum_func2 func = pt_distance_fn(seq->flags);
@@ -596,15 +596,21 @@ Datum
     case T_GEOMETRY:
     case T_GEOGRAPHY:
     {
-      LWGEOM *geo = lwgeom_from_gserialized(DatumGetGserializedP(d));
+      /* The coordinates of the geometry reference those of the serialized
+       * value, which is copied to be able to transform them in place */
+      GSERIALIZED *gs = geo_copy(DatumGetGserializedP(d));
+      LWGEOM *geo = lwgeom_from_gserialized(gs);
       if (! lwgeom_transform(geo, (LWPROJ *) pj))
+      {
+        lwgeom_free(geo); pfree(gs);
         return PointerGetDatum(NULL);
+      }
       geo->srid = srid_to;
       /* Re-compute bbox if input had one (COMPUTE_BBOX TAINTING) */
       if (geo->bbox)
         lwgeom_refresh_bbox(geo);
       Datum result = PointerGetDatum(geo_serialize(geo));
-      lwgeom_free(geo);
+      lwgeom_free(geo); pfree(gs);
       return result;
     }
 #if CBUFFER
@@ -745,6 +751,51 @@ tspatialinst_transf_pj(const TInstant *inst, int32_t srid_to, const LWPROJ *pj)
   return tinstant_make_free(d, inst->temptype, inst->t);
 }
 
+/**
+ * @brief Return a temporal point sequence transformed to another SRID
+ * @details The coordinates of all the instants are transformed with a single
+ * call to PROJ instead of one call per instant
+ * @param[in] seq Temporal point sequence
+ * @param[in] srid_to SRID, may be @p SRID_UNKNOWN for pipeline
+ * transformations
+ * @param[in] pj Information about the transformation
+ */
+static TSequence *
+tpointseq_transf_pj(const TSequence *seq, int32_t srid_to, const LWPROJ *pj)
+{
+  assert(seq); assert(pj); assert(tpoint_type(seq->temptype));
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  size_t size = hasz ? sizeof(POINT3DZ) : sizeof(POINT2D);
+  /* Gather the coordinates of the points into a point array */
+  POINTARRAY *pa = ptarray_construct(hasz, false, seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const GSERIALIZED *gs = DatumGetGserializedP(tinstant_value_p(
+      TSEQUENCE_INST_N(seq, i)));
+    memcpy(getPoint_internal(pa, i), GS_POINT_PTR(gs), size);
+  }
+  /* Transform the coordinates, which calls proj_trans_generic once */
+  if (! ptarray_transform(pa, (LWPROJ *) pj))
+  {
+    ptarray_free(pa);
+    return NULL;
+  }
+  /* Scatter the transformed coordinates into copies of the instants */
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    GSERIALIZED *gs = geo_copy(DatumGetGserializedP(tinstant_value_p(inst)));
+    memcpy(GS_POINT_PTR(gs), getPoint_internal(pa, i), size);
+    gserialized_set_srid(gs, srid_to);
+    instants[i] = tinstant_make_free(PointerGetDatum(gs), inst->temptype,
+      inst->t);
+  }
+  ptarray_free(pa);
+  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
+    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+}
+
 /**
  * @brief Return a spatiotemporal type transformed to another SRID
  * @param[in] seq Spatiotemporal sequence
@@ -755,6 +806,8 @@ TSequence *
 tspatialseq_transf_pj(const TSequence *seq, int32_t srid_to, const LWPROJ *pj)
 {
   assert(seq); assert(pj); assert(tspatial_type(seq->temptype));
+  if (tpoint_type(seq->temptype))
+    return tpointseq_transf_pj(seq, srid_to, pj);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
   {
@@ -17,6 +17,11 @@
  * up transformations (see file file libpgcommon/lw_transform.c).
  * The functions in this file are derived from PostGIS functions by perforning
  * memory allocation with `malloc` instead of using PostreSQL contexts.
+ *
+ * In MEOS, the `spatial_ref_sys.csv` file is read once into a table indexed
+ * by SRID which is shared by all threads, while each thread keeps its own
+ * cache of transformations indexed by a hash table, since the PROJ objects
+ * belong to the PROJ context of the thread that created them.
  */
 
 #include "geo/meos_transform.h"
@@ -25,8 +30,12 @@
 #include <float.h>
 #include <string.h>
 #include <stdio.h>
+#if MEOS
+  #include <pthread.h>
+#endif /* MEOS */
 /* PostgreSQL */
 #include <postgres.h>
+#include <common/hashfn.h>
 #if ! MEOS
   #include <libpq/pqformat.h>
   #include <executor/spi.h>
@@ -57,16 +66,21 @@ typedef struct struct_PROJSRSCacheItem
 /* PROJ 4 lookup transaction cache methods */
 #define PROJ_CACHE_ITEMS 128
 
+/* Number of slots of the hash table of the PROJ cache, which is a power of
+ * two at least twice the number of entries */
+#define PROJ_CACHE_SLOTS 256
+
 /**
  * @brief The proj4 cache holds a fixed number of reprojection entries
- * @details In normal usage we don't expect it to have many entries, so we
- * always linearly scan the list.
+ * @details The entries are found from their pair of SRIDs with a hash table
+ * with open addressing giving their position in the array of entries.
  * @note The structure removes the context field from PostGIS PROJSRSCache
  */
 typedef struct struct_MEOSPROJSRSCache
 {
   PROJSRSCacheItem MEOSPROJSRSCache[PROJ_CACHE_ITEMS];
   uint32_t PROJSRSCacheCount;
+  int16 PROJSRSCacheSlots[PROJ_CACHE_SLOTS]; /* -1 for an empty slot */
 } MEOSPROJSRSCache;
 
 /**
@@ -95,13 +109,64 @@ typedef struct
  *****************************************************************************/
 
 #if MEOS
-/* Maximum length in characters of a header record in the input CSV file */
-#define MAX_LEN_HEADER 1024
-/* Maximum length in characters of a geometry in the input data */
+/* Maximum length in characters of a record in the input CSV file */
 #define MAX_LEN_SRS_RECORD 5120
 /* Location of the spatial_ref_sys.csv file */
 char *SPATIAL_REF_SYS_CSV = "/usr/local/share/spatial_ref_sys.csv";
 
+/**
+ * @brief Structure to represent a record of the spatial_ref_sys.csv file
+ */
+typedef struct
+{
+  int32_t srid;     /**< Authority identifier of the record */
+  char *authtext;   /**< auth_name:auth_srid */
+  char *srtext;
+  char *proj4text;
+} SpatialRefSysRecord;
+
+/**
+ * @brief The spatial_ref_sys table holds the records read from the
+ * spatial_ref_sys.csv file and a hash table with open addressing giving the
+ * position of a record from its SRID
+ */
+typedef struct
+{
+  SpatialRefSysRecord *records; /**< Records in the order of the file */
+  int count;                    /**< Number of records */
+  int *slots;                   /**< Positions of the records in the array,
+                                     -1 for an empty slot */
+  uint32 mask;                  /**< Number of slots minus one */
+} SpatialRefSysTable;
+
+/* Minimum number of slots of the hash table, which is a power of two at
+ * least twice the number of records */
+#define SRS_MIN_SLOTS 16
+
+/* Table of the current spatial_ref_sys.csv file, NULL until it is read */
+static SpatialRefSysTable *MEOS_SRS_TABLE = NULL;
+/* Protects the table of the current file */
+static pthread_mutex_t MEOS_SRS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Free the strings and the arrays of a spatial_ref_sys table
+ */
+static void
+srs_table_free(SpatialRefSysTable *table)
+{
+  for (int i = 0; i < table->count; i++)
+  {
+    pfree(table->records[i].authtext);
+    pfree(table->records[i].srtext);
+    pfree(table->records[i].proj4text);
+  }
+  pfree(table->records);
+  if (table->slots)
+    pfree(table->slots);
+  pfree(table);
+  return;
+}
+
 /**
  * @ingroup meos_setup
  * @brief Set the location of the SPATIAL_REF_SYS_CSV files
@@ -109,17 +174,19 @@ char *SPATIAL_REF_SYS_CSV = "/usr/local/share/spatial_ref_sys.csv";
 void
 meos_set_spatial_ref_sys_csv(const char* path)
 {
-  SPATIAL_REF_SYS_CSV = malloc(strlen(path) + 1);
-  strcpy(SPATIAL_REF_SYS_CSV, path);
+  char *csv = malloc(strlen(path) + 1);
+  strcpy(csv, path);
+  pthread_mutex_lock(&MEOS_SRS_LOCK);
+  SPATIAL_REF_SYS_CSV = csv;
+  /* The next lookup reads the new file */
+  if (MEOS_SRS_TABLE)
+  {
+    srs_table_free(MEOS_SRS_TABLE);
+    MEOS_SRS_TABLE = NULL;
+  }
+  pthread_mutex_unlock(&MEOS_SRS_LOCK);
+  return;
 }
-
-typedef struct
-{
-  char auth_name[256];
-  int32_t auth_srid;
-  char proj4text[2048];
-  char srtext[2048];
-} spatial_ref_sys_record;
 #endif /* MEOS */
 
 /*****************************************************************************
@@ -160,6 +227,7 @@ GetMEOSPROJSRSCache()
       return NULL;
     }
     cache->PROJSRSCacheCount = 0;
+    memset(cache->PROJSRSCacheSlots, -1, sizeof(cache->PROJSRSCacheSlots));
     MEOS_PROJ_CACHE = cache;
   }
   return cache;
@@ -180,8 +248,9 @@ meos_finalize_projsrs(void)
       if (cache->MEOSPROJSRSCache[i].projection)
         PROJSRSDestroyPJ(cache->MEOSPROJSRSCache[i].projection);
     }
+    pfree(cache);
+    MEOS_PROJ_CACHE = NULL;
   }
-  pfree(cache);
   return;
 }
 
@@ -189,6 +258,44 @@ meos_finalize_projsrs(void)
  * Per-cache management functions
  *****************************************************************************/
 
+/**
+ * @brief Return the slot of a pair of SRIDs in the hash table of the PROJ
+ * cache, which is either the slot of their entry or the empty slot where it
+ * would be added
+ */
+static uint32
+PROJCacheSlot(const MEOSPROJSRSCache *cache, int32_t srid_from,
+  int32_t srid_to)
+{
+  uint64 key = ((uint64) (uint32) srid_from << 32) | (uint32) srid_to;
+  uint32 slot = (uint32) murmurhash64(key) & (PROJ_CACHE_SLOTS - 1);
+  while (cache->PROJSRSCacheSlots[slot] >= 0)
+  {
+    const PROJSRSCacheItem *item =
+      &cache->MEOSPROJSRSCache[cache->PROJSRSCacheSlots[slot]];
+    if (item->srid_from == srid_from && item->srid_to == srid_to)
+      break;
+    slot = (slot + 1) & (PROJ_CACHE_SLOTS - 1);
+  }
+  return slot;
+}
+
+/**
+ * @brief Rebuild the hash table of the PROJ cache from its entries
+ */
+static void
+PROJCacheIndex(MEOSPROJSRSCache *cache)
+{
+  memset(cache->PROJSRSCacheSlots, -1, sizeof(cache->PROJSRSCacheSlots));
+  for (uint32_t i = 0; i < cache->PROJSRSCacheCount; i++)
+  {
+    uint32 slot = PROJCacheSlot(cache, cache->MEOSPROJSRSCache[i].srid_from,
+      cache->MEOSPROJSRSCache[i].srid_to);
+    cache->PROJSRSCacheSlots[slot] = (int16) i;
+  }
+  return;
+}
+
 /**
  * @brief Get a PROJ structure from the PROJ cache
  * @return On error return `NULL`
@@ -197,17 +304,12 @@ static LWPROJ *
 GetProjectionFromPROJCache(MEOSPROJSRSCache *cache, int32_t srid_from,
   int32_t srid_to)
 {
-  uint32_t i;
-  for (i = 0; i < cache->PROJSRSCacheCount; i++)
-  {
-    if (cache->MEOSPROJSRSCache[i].srid_from == srid_from &&
-        cache->MEOSPROJSRSCache[i].srid_to == srid_to)
-    {
-      cache->MEOSPROJSRSCache[i].hits++;
-      return cache->MEOSPROJSRSCache[i].projection;
-    }
-  }
-  return NULL;
+  int16 pos = cache->PROJSRSCacheSlots[PROJCacheSlot(cache, srid_from,
+    srid_to)];
+  if (pos < 0)
+    return NULL;
+  cache->MEOSPROJSRSCache[pos].hits++;
+  return cache->MEOSPROJSRSCache[pos].projection;
 }
 
 #if ! MEOS
@@ -234,63 +336,150 @@ SPI_pstrdup(const char *str)
  * @note The PostGIS function is copied here since it is declared as `static`
  */
 #if MEOS
-static PjStrs
-GetProjStringsSPI(int32_t srid)
+/**
+ * @brief Return the slot of an SRID in the hash table of a spatial_ref_sys
+ * table, which is either the slot of its record or the empty slot where it
+ * would be added
+ */
+static uint32
+srs_table_slot(const SpatialRefSysTable *table, int32_t srid)
 {
-  char header_buffer[MAX_LEN_HEADER];
-  char auth_name[256];
-  int32_t auth_srid;
-  char proj4text[2048];
-  char srtext[2048];
+  uint32 slot = murmurhash32((uint32) srid) & table->mask;
+  while (table->slots[slot] >= 0 &&
+      table->records[table->slots[slot]].srid != srid)
+    slot = (slot + 1) & table->mask;
+  return slot;
+}
 
-  PjStrs strs; // TODO palloc ?
-  memset(&strs, 0, sizeof(strs));
+/**
+ * @brief Build the hash table of a spatial_ref_sys table
+ * @note When several records of the file have the same SRID, the first one
+ * is kept, as when the file was scanned for each lookup
+ */
+static void
+srs_table_index(SpatialRefSysTable *table)
+{
+  uint32 nslots = SRS_MIN_SLOTS;
+  while (nslots < 2 * (uint32) table->count)
+    nslots <<= 1;
+  table->mask = nslots - 1;
+  table->slots = palloc(sizeof(int) * nslots);
+  memset(table->slots, -1, sizeof(int) * nslots);
+  for (int i = 0; i < table->count; i++)
+  {
+    uint32 slot = srs_table_slot(table, table->records[i].srid);
+    if (table->slots[slot] < 0)
+      table->slots[slot] = i;
+  }
+  return;
+}
 
+/**
+ * @brief Read the spatial_ref_sys.csv file into a new table
+ * @return On error return @p NULL
+ */
+static SpatialRefSysTable *
+srs_table_read(void)
+{
   /* Substitute the full file path in the first argument of fopen */
   FILE *file = fopen(SPATIAL_REF_SYS_CSV, "r");
   if (! file)
+    return NULL;
+
+  SpatialRefSysTable *table = palloc0(sizeof(SpatialRefSysTable));
+  int maxcount = 1024;
+  table->records = palloc(sizeof(SpatialRefSysRecord) * maxcount);
+  char *line = palloc(MAX_LEN_SRS_RECORD);
+  char auth_name[256];
+  int32_t auth_srid;
+  char *proj4text = palloc(2048);
+  char *srtext = palloc(2048);
+  bool header = true;
+  while (fgets(line, MAX_LEN_SRS_RECORD, file))
   {
-    printf("Cannot open the spatial_ref_sys.csv file (reading from %s)\n", SPATIAL_REF_SYS_CSV);
-    return strs;
+    /* Discard the rest of a line longer than the buffer */
+    bool partial = ! strchr(line, '\n') && ! feof(file);
+    while (partial)
+    {
+      int c = fgetc(file);
+      partial = (c != '\n' && c != EOF);
+    }
+    /* Discard the first line of the file with the headers */
+    if (header)
+    {
+      header = false;
+      continue;
+    }
+    /* Ignore the records with NULL values */
+    if (sscanf(line, "%255[^,^\n],%d,%2047[^,^\n],%2047[^\n]", auth_name,
+        &auth_srid, proj4text, srtext) != 4)
+      continue;
+    if (table->count == maxcount)
+    {
+      maxcount *= 2;
+      table->records = repalloc(table->records,
+        sizeof(SpatialRefSysRecord) * maxcount);
+    }
+    SpatialRefSysRecord *record = &table->records[table->count++];
+    char tmp[MAX_PROJ_LEN];
+    snprintf(tmp, MAX_PROJ_LEN, "%s:%d", auth_name, auth_srid);
+    record->srid = auth_srid;
+    record->authtext = pstrdup(tmp);
+    record->proj4text = pstrdup(proj4text);
+    record->srtext = pstrdup(srtext);
+  }
+  bool error = ferror(file);
+  fclose(file);
+  pfree(line); pfree(proj4text); pfree(srtext);
+  if (error)
+  {
+    srs_table_free(table);
+    return NULL;
   }
+  srs_table_index(table);
+  return table;
+}
 
-  /* Read and discard the first line of the file with the headers */
-  int nread = fscanf(file, "%1023s\n", header_buffer);
-  (void) nread;
+static PjStrs
+GetProjStringsSPI(int32_t srid)
+{
+  PjStrs strs;
+  memset(&strs, 0, sizeof(strs));
 
-  /* Continue reading the file */
+  /* Read the file when the SRID of one of its records is looked up for the
+   * first time */
+  pthread_mutex_lock(&MEOS_SRS_LOCK);
+  SpatialRefSysTable *table = MEOS_SRS_TABLE;
+  if (! table)
+    table = MEOS_SRS_TABLE = srs_table_read();
   bool found = false;
-  do
+  if (table)
   {
-    /* Read each line from the file */
-    int read = fscanf(file, "%255[^,^\n],%d,%2047[^,^\n],%2047[^\n]\n",
-      auth_name, &auth_srid, proj4text, srtext);
-
-    if (ferror(file))
+    int pos = table->slots[srs_table_slot(table, srid)];
+    if (pos >= 0)
     {
-      printf("Error reading the spatial_ref_sys.csv file");
-      return strs;
-    }
-
-    /* Ignore the records with NULL values */
-    if (read == 4 && auth_srid == srid)
-    {
-      char tmp[MAX_PROJ_LEN];
-      snprintf(tmp, MAX_PROJ_LEN, "%s:%d", auth_name, auth_srid);
-      strs.authtext = strdup(tmp);
-      strs.proj4text = strdup(proj4text);
-      strs.srtext = strdup(srtext);
+      /* Copy the strings since the table may be freed by another thread */
+      SpatialRefSysRecord *record = &table->records[pos];
+      strs.authtext = pstrdup(record->authtext);
+      strs.proj4text = pstrdup(record->proj4text);
+      strs.srtext = pstrdup(record->srtext);
       found = true;
-      break;
     }
-  } while (! feof(file));
+  }
+  pthread_mutex_unlock(&MEOS_SRS_LOCK);
 
+  if (! table)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot read the spatial_ref_sys.csv file (reading from %s)",
+      SPATIAL_REF_SYS_CSV);
+    return strs;
+  }
   if (! found)
   {
     meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
       "Cannot find SRID (%d) in spatial_ref_sys", srid);
   }
-  fclose(file);
   return strs;
 }
 #else
@@ -611,8 +800,10 @@ AddToMEOSPROJSRSCache(MEOSPROJSRSCache *PROJCache, int32_t srid_from,
   /* If the cache is already full then find the least used element and delete it */
   uint32_t cache_position = PROJCache->PROJSRSCacheCount;
   uint32_t hits = 1;
+  bool evicted = false;
   if (cache_position == PROJ_CACHE_ITEMS)
   {
+    evicted = true;
     cache_position = 0;
     hits = PROJCache->MEOSPROJSRSCache[0].hits;
     for (uint32_t i = 1; i < PROJ_CACHE_ITEMS; i++)
@@ -645,6 +836,14 @@ AddToMEOSPROJSRSCache(MEOSPROJSRSCache *PROJCache, int32_t srid_from,
   PROJCache->MEOSPROJSRSCache[cache_position].projection = projection;
   PROJCache->MEOSPROJSRSCache[cache_position].hits = hits;
 
+  /* The slot of an evicted entry cannot be emptied without breaking the
+   * probe sequences going through it, so the hash table is rebuilt */
+  if (evicted)
+    PROJCacheIndex(PROJCache);
+  else
+    PROJCache->PROJSRSCacheSlots[PROJCacheSlot(PROJCache, srid_from,
+      srid_to)] = (int16) cache_position;
+
   return projection;
 }
 
@@ -658,10 +857,15 @@ AddToMEOSPROJSRSCache(MEOSPROJSRSCache *PROJCache, int32_t srid_from,
 int
 lwproj_lookup(int32_t srid_from, int32_t srid_to, LWPROJ **pj)
 {
+  /* The cache outlives an arena scope open on the calling thread */
+  meos_arena_suspend();
   /* get or initialize the cache for this round */
   MEOSPROJSRSCache* proj_cache = GetMEOSPROJSRSCache();
   if (! proj_cache)
+  {
+    meos_arena_resume();
     return LW_FAILURE;
+  }
 
   /* Add the output SRID to the cache if it is not already there */
   *pj = GetProjectionFromPROJCache(proj_cache, srid_from, srid_to);
@@ -669,6 +873,7 @@ lwproj_lookup(int32_t srid_from, int32_t srid_to, LWPROJ **pj)
   {
     *pj = AddToMEOSPROJSRSCache(proj_cache, srid_from, srid_to);
   }
+  meos_arena_resume();
   return *pj != NULL;
 }
 #endif /* MEOS */
@@ -457,6 +457,22 @@ tnpointseqset_tgeompointseqset(const TSequenceSet *ss)
   return tsequenceset_make_free(sequences, ss->count, NORMALIZE_NO);
 }
 
+/**
+ * @brief Fetch at once the routes of a temporal network point, so that its
+ * instants do not access the ways table one at a time
+ */
+static bool
+tnpoint_fetch_routes(const Temporal *temp)
+{
+  Set *s = tnpoint_routes(temp);
+  int64 *rids = palloc(sizeof(int64) * s->count);
+  for (int i = 0; i < s->count; i++)
+    rids[i] = DatumGetInt64(SET_VAL_N(s, i));
+  bool result = routes_fetch(rids, s->count);
+  pfree(rids); pfree(s);
+  return result;
+}
+
 /**
  * @ingroup meos_npoint_conversion
  * @brief Convert a temporal network point into a temporal geometry point
@@ -468,6 +484,8 @@ tnpoint_to_tgeompoint(const Temporal *temp)
 {
   /* Ensure the validity of the arguments */
   VALIDATE_TNPOINT(temp, NULL);
+  if (temp->subtype != TINSTANT && ! tnpoint_fetch_routes(temp))
+    return NULL;
 
   assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
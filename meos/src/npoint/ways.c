@@ -30,6 +30,13 @@
 /**
  * @file
  * @brief Network-based static point and segment types
+ * @details The routes read from the ways table are kept in a cache of the
+ * backend, which is a hash table indexed by the route identifiers whose least
+ * recently used routes are evicted when it is full. The cache is reset by
+ * the invalidation callbacks of the relation cache and of the system cache
+ * when the ways table is altered, truncated, dropped, or replaced by another
+ * relation. As for the SRID of the table, the updates of its rows are not
+ * seen by a backend that has cached the routes before.
  */
 
 #include "npoint/tnpoint.h"
@@ -38,11 +45,21 @@
 #include <assert.h>
 #include <float.h>
 #include <limits.h>
+#include <stdlib.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <catalog/pg_namespace.h>
+#include <catalog/pg_type.h>
 #include <libpq/pqformat.h>
 #include <executor/spi.h>
+#include <lib/ilist.h>
+#include <utils/array.h>
+#include <utils/catcache.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
+#include <utils/lsyscache.h>
 #include <utils/memutils.h>
+#include <utils/syscache.h>
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
@@ -51,11 +68,315 @@
 #include "geo/postgis_funcs.h"
 #include "geo/tgeo_spatialfuncs.h"
 
-#define SQL_ROUTE_MAXLEN  64
-
 /* Global variable saving the SRID of the ways table */
 static int32_t SRID_WAYS = SRID_INVALID;
 
+/*****************************************************************************
+ * Route cache
+ *****************************************************************************/
+
+/* Maximum number of routes kept in the route cache of a backend */
+#define WAYS_CACHE_MAXROUTES 16384
+
+/* Query fetching the routes of an array of route identifiers */
+#define WAYS_ROUTES_QUERY "SELECT gid::bigint, length::float8, the_geom " \
+  "FROM public.ways WHERE gid = ANY($1)"
+
+/**
+ * @brief Structure to represent an entry of the route cache
+ */
+typedef struct
+{
+  int64 gid;              /**< Identifier of the route, key of the entry */
+  bool exists;            /**< True if the route is in the ways table */
+  bool length_null;       /**< True if the length of the route is null */
+  double length;          /**< Length of the route */
+  GSERIALIZED *the_geom;  /**< Geometry of the route, NULL if null */
+  dlist_node lru;         /**< Node in the list of the routes from the most
+                               to the least recently used */
+} WaysCacheEntry;
+
+/* Hash table of the route cache, NULL until a route is fetched */
+static HTAB *WAYS_CACHE = NULL;
+/* Memory context of the hash table and of the geometries of the routes */
+static MemoryContext WAYS_CACHE_CONTEXT = NULL;
+/* Routes of the cache from the most to the least recently used */
+static dlist_head WAYS_CACHE_LRU = DLIST_STATIC_INIT(WAYS_CACHE_LRU);
+/* Identifier of the ways table when the cache was created */
+static Oid WAYS_RELID = InvalidOid;
+/* Hash value of the name of the ways table in the system cache */
+static uint32 WAYS_RELNAME_HASH = 0;
+/* Plan of the query fetching the routes, kept for the backend */
+static SPIPlanPtr WAYS_PLAN = NULL;
+
+/**
+ * @brief Reset the route cache and the SRID of the ways table
+ */
+static void
+ways_cache_reset(void)
+{
+  if (WAYS_CACHE_CONTEXT)
+    MemoryContextReset(WAYS_CACHE_CONTEXT);
+  WAYS_CACHE = NULL;
+  dlist_init(&WAYS_CACHE_LRU);
+  WAYS_RELID = InvalidOid;
+  SRID_WAYS = SRID_INVALID;
+  return;
+}
+
+/**
+ * @brief Reset the route cache when the ways table is invalidated in the
+ * relation cache
+ */
+static void
+ways_relcache_callback(Datum arg UNUSED, Oid relid)
+{
+  if (relid == InvalidOid || relid == WAYS_RELID)
+    ways_cache_reset();
+  return;
+}
+
+/**
+ * @brief Reset the route cache when a relation named `public.ways` is
+ * created, renamed, or dropped
+ */
+static void
+ways_syscache_callback(Datum arg UNUSED, int cacheid UNUSED,
+  uint32 hashvalue)
+{
+  if (hashvalue == 0 || hashvalue == WAYS_RELNAME_HASH)
+    ways_cache_reset();
+  return;
+}
+
+/**
+ * @brief Return the route cache, creating it if it does not exist
+ */
+static HTAB *
+ways_cache_get(void)
+{
+  if (WAYS_CACHE)
+    return WAYS_CACHE;
+
+  if (! WAYS_CACHE_CONTEXT)
+  {
+    if (! CacheMemoryContext)
+      CreateCacheMemoryContext();
+    WAYS_CACHE_CONTEXT = AllocSetContextCreate(CacheMemoryContext,
+      "MobilityDB route cache", ALLOCSET_DEFAULT_SIZES);
+    WAYS_RELNAME_HASH = GetSysCacheHashValue2(RELNAMENSP,
+      CStringGetDatum("ways"), ObjectIdGetDatum(PG_PUBLIC_NAMESPACE));
+    CacheRegisterRelcacheCallback(ways_relcache_callback, (Datum) 0);
+    CacheRegisterSyscacheCallback(RELNAMENSP, ways_syscache_callback,
+      (Datum) 0);
+  }
+  /* The identifier is read before creating the hash table since reading it
+   * may process the pending invalidations */
+  Oid relid = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+
+  HASHCTL ctl;
+  memset(&ctl, 0, sizeof(ctl));
+  ctl.keysize = sizeof(int64);
+  ctl.entrysize = sizeof(WaysCacheEntry);
+  ctl.hcxt = WAYS_CACHE_CONTEXT;
+  WAYS_CACHE = hash_create("MobilityDB route cache", 1024, &ctl,
+    HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+  dlist_init(&WAYS_CACHE_LRU);
+  WAYS_RELID = relid;
+  return WAYS_CACHE;
+}
+
+/**
+ * @brief Return a route of the cache, if not found return `NULL`
+ */
+static WaysCacheEntry *
+ways_cache_lookup(int64 rid)
+{
+  if (! WAYS_CACHE)
+    return NULL;
+  WaysCacheEntry *entry = (WaysCacheEntry *) hash_search(WAYS_CACHE, &rid,
+    HASH_FIND, NULL);
+  if (entry)
+    dlist_move_head(&WAYS_CACHE_LRU, &entry->lru);
+  return entry;
+}
+
+/**
+ * @brief Add a route to the cache, evicting the least recently used route if
+ * the cache is full
+ * @note The geometry is copied into the memory context of the cache
+ */
+static void
+ways_cache_add(HTAB *cache, int64 rid, bool exists, bool length_null,
+  double length, const GSERIALIZED *gs)
+{
+  bool found;
+  WaysCacheEntry *entry = (WaysCacheEntry *) hash_search(cache, &rid,
+    HASH_FIND, NULL);
+  /* When the table has several rows for a route the first one is kept */
+  if (entry)
+    return;
+  if (hash_get_num_entries(cache) >= WAYS_CACHE_MAXROUTES)
+  {
+    WaysCacheEntry *last = dlist_tail_element(WaysCacheEntry, lru,
+      &WAYS_CACHE_LRU);
+    dlist_delete(&last->lru);
+    if (last->the_geom)
+      pfree(last->the_geom);
+    hash_search(cache, &last->gid, HASH_REMOVE, NULL);
+  }
+  entry = (WaysCacheEntry *) hash_search(cache, &rid, HASH_ENTER, &found);
+  entry->exists = exists;
+  entry->length_null = length_null;
+  entry->length = length;
+  entry->the_geom = NULL;
+  if (gs)
+  {
+    entry->the_geom = MemoryContextAlloc(WAYS_CACHE_CONTEXT, VARSIZE(gs));
+    memcpy(entry->the_geom, gs, VARSIZE(gs));
+  }
+  dlist_push_head(&WAYS_CACHE_LRU, &entry->lru);
+  return;
+}
+
+/**
+ * @brief Order two route identifiers, in the form @p qsort takes
+ */
+static int
+route_id_cmp(const void *a, const void *b)
+{
+  int64 l = *(const int64 *) a, r = *(const int64 *) b;
+  return (l < r) ? -1 : ((l > r) ? 1 : 0);
+}
+
+/**
+ * @brief Fetch from the ways table with a single query the routes of an
+ * array of route identifiers that are not in the route cache
+ * @details The routes that are not in the table are also added to the cache
+ * so that they are not fetched again
+ * @param[in] rids Route identifiers
+ * @param[in] count Number of route identifiers
+ */
+bool
+routes_fetch(const int64 *rids, int count)
+{
+  /* Collect the distinct identifiers that are not in the cache */
+  int64 *missing = palloc(sizeof(int64) * count);
+  int nmissing = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! WAYS_CACHE || ! hash_search(WAYS_CACHE, &rids[i], HASH_FIND, NULL))
+      missing[nmissing++] = rids[i];
+  }
+  if (nmissing == 0)
+  {
+    pfree(missing);
+    return true;
+  }
+  qsort(missing, nmissing, sizeof(int64), route_id_cmp);
+  int ndistinct = 1;
+  for (int i = 1; i < nmissing; i++)
+  {
+    if (missing[i] != missing[ndistinct - 1])
+      missing[ndistinct++] = missing[i];
+  }
+
+  Datum *values = palloc(sizeof(Datum) * ndistinct);
+  for (int i = 0; i < ndistinct; i++)
+    values[i] = Int64GetDatum(missing[i]);
+  ArrayType *array = construct_array(values, ndistinct, INT8OID,
+    sizeof(int64), FLOAT8PASSBYVAL, TYPALIGN_DOUBLE);
+  pfree(values);
+
+  SPI_connect();
+  if (! WAYS_PLAN)
+  {
+    Oid argtypes[1] = { INT8ARRAYOID };
+    SPIPlanPtr plan = SPI_prepare(WAYS_ROUTES_QUERY, 1, argtypes);
+    if (! plan)
+    {
+      SPI_finish();
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Cannot prepare the query fetching the routes of the ways table");
+      return false;
+    }
+    SPI_keepplan(plan);
+    WAYS_PLAN = plan;
+  }
+  Datum arg = PointerGetDatum(array);
+  int ret = SPI_execute_plan(WAYS_PLAN, &arg, NULL, true, 0);
+  uint64 proc = SPI_processed;
+
+  /* The values are detoasted before updating the cache since detoasting
+   * them may process the pending invalidations, which reset the cache */
+  int64 *gids = palloc(sizeof(int64) * Max(proc, 1));
+  double *lengths = palloc(sizeof(double) * Max(proc, 1));
+  bool *length_nulls = palloc(sizeof(bool) * Max(proc, 1));
+  GSERIALIZED **geoms = palloc(sizeof(GSERIALIZED *) * Max(proc, 1));
+  int nrows = 0;
+  if (ret > 0 && SPI_tuptable)
+  {
+    SPITupleTable *tuptable = SPI_tuptable;
+    for (uint64 i = 0; i < proc; i++)
+    {
+      bool isnull;
+      Datum gid = SPI_getbinval(tuptable->vals[i], tuptable->tupdesc, 1,
+        &isnull);
+      if (isnull)
+        continue;
+      gids[nrows] = DatumGetInt64(gid);
+      Datum length = SPI_getbinval(tuptable->vals[i], tuptable->tupdesc, 2,
+        &length_nulls[nrows]);
+      lengths[nrows] = length_nulls[nrows] ? 0.0 : DatumGetFloat8(length);
+      Datum line = SPI_getbinval(tuptable->vals[i], tuptable->tupdesc, 3,
+        &isnull);
+      geoms[nrows] = isnull ? NULL : (GSERIALIZED *) PG_DETOAST_DATUM(line);
+      nrows++;
+    }
+  }
+
+  /* The routes without row are found in the sorted identifiers rather than in
+   * the cache, since a batch larger than the cache evicts some of its own
+   * routes, which must not be cached as missing */
+  bool *hasrow = palloc0(sizeof(bool) * ndistinct);
+  for (int i = 0; i < nrows; i++)
+  {
+    int64 *pos = bsearch(&gids[i], missing, ndistinct, sizeof(int64),
+      route_id_cmp);
+    if (pos)
+      hasrow[pos - missing] = true;
+  }
+  HTAB *cache = ways_cache_get();
+  for (int i = 0; i < nrows; i++)
+    ways_cache_add(cache, gids[i], true, length_nulls[i], lengths[i],
+      geoms[i]);
+  for (int i = 0; i < ndistinct; i++)
+  {
+    if (! hasrow[i])
+      ways_cache_add(cache, missing[i], false, true, 0.0, NULL);
+  }
+  pfree(hasrow);
+  SPI_finish();
+  pfree(missing); pfree(array);
+  return true;
+}
+
+/**
+ * @brief Return a route of the cache, fetching it from the ways table if it
+ * is not in the cache
+ * @return On error return @p NULL
+ */
+static const WaysCacheEntry *
+route_lookup(int64 rid)
+{
+  WaysCacheEntry *entry = ways_cache_lookup(rid);
+  if (entry)
+    return entry;
+  if (! routes_fetch(&rid, 1))
+    return NULL;
+  return ways_cache_lookup(rid);
+}
+
 /*****************************************************************************
  * Route functions
  *****************************************************************************/
@@ -112,22 +433,8 @@ get_srid_ways()
 bool
 route_exists(int64 rid)
 {
-  char sql[SQL_ROUTE_MAXLEN];
-  snprintf(sql, sizeof(sql),
-    "SELECT true FROM public.ways WHERE gid = " INT64_FORMAT, rid);
-  bool isNull = true;
-  bool result = false;
-  SPI_connect();
-  int ret = SPI_execute(sql, true, 1);
-  uint64 proc = SPI_processed;
-  if (ret > 0 && proc > 0 && SPI_tuptable)
-  {
-    SPITupleTable *tuptable = SPI_tuptable;
-    result = DatumGetBool(SPI_getbinval(tuptable->vals[0],
-      tuptable->tupdesc, 1, &isNull));
-  }
-  SPI_finish();
-  return result;
+  const WaysCacheEntry *entry = route_lookup(rid);
+  return entry && entry->exists;
 }
 
 /**
@@ -140,29 +447,14 @@ route_exists(int64 rid)
 double
 route_length(int64 rid)
 {
-  char sql[SQL_ROUTE_MAXLEN];
-  snprintf(sql, sizeof(sql),
-    "SELECT length FROM public.ways WHERE gid = " INT64_FORMAT, rid);
-  bool isNull = true;
-  double result = 0.0;
-  SPI_connect();
-  int ret = SPI_execute(sql, true, 1);
-  uint64 proc = SPI_processed;
-  if (ret > 0 && proc > 0 && SPI_tuptable)
-  {
-    SPITupleTable *tuptable = SPI_tuptable;
-    result = DatumGetFloat8(SPI_getbinval(tuptable->vals[0],
-      tuptable->tupdesc, 1, &isNull));
-  }
-  SPI_finish();
-
-  if (isNull)
+  const WaysCacheEntry *entry = route_lookup(rid);
+  if (! entry || entry->length_null)
   {
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
       "Cannot get the length for route " INT64_FORMAT, rid);
     return DBL_MAX;
   }
-  return result;
+  return entry->length;
 }
 
 /**
@@ -171,38 +463,21 @@ route_length(int64 rid)
  * route identifier
  * @param[in] rid Route identifier
  * @return On error return @p NULL
+ * @note The geometry is copied from the route cache into the current memory
+ * context, so that it remains valid when the route is evicted from the cache
  */
 const GSERIALIZED *
 route_geom(int64 rid)
 {
-  char sql[SQL_ROUTE_MAXLEN];
-  snprintf(sql, sizeof(sql),
-    "SELECT the_geom FROM public.ways WHERE gid = " INT64_FORMAT, rid);
-  bool isNull = true;
-  GSERIALIZED *result = NULL;
-  SPI_connect();
-  int ret = SPI_execute(sql, true, 1);
-  uint64 proc = SPI_processed;
-  if (ret > 0 && proc > 0 && SPI_tuptable)
-  {
-    SPITupleTable *tuptable = SPI_tuptable;
-    Datum line = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1, &isNull);
-    if (! isNull)
-    {
-      /* Must allocate this in upper executor context to keep it alive after SPI_finish() */
-      GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(line);
-      result = (GSERIALIZED *) SPI_palloc(gs->size);
-      memcpy(result, gs, gs->size);
-    }
-  }
-  SPI_finish();
-
-  if (isNull)
+  const WaysCacheEntry *entry = route_lookup(rid);
+  if (! entry || ! entry->the_geom)
   {
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
       "Cannot get the geometry for route " INT64_FORMAT, rid);
     return NULL;
   }
+  GSERIALIZED *result = palloc(VARSIZE(entry->the_geom));
+  memcpy(result, entry->the_geom, VARSIZE(entry->the_geom));
   if (! ensure_not_empty(result))
   {
     pfree(result);
@@ -29,20 +29,34 @@
 
 /**
  * @file
- * @brief Implementation of a cache storing the route records read from a ways
- * CSV file
+ * @brief Implementation of a store keeping the routes read from a ways CSV
+ * file
+ * @details The ways CSV file is read once, when a route is looked up for the
+ * first time, into a store holding for each route its geometry, its length,
+ * and its bounding box, and a hash table indexed by the route identifiers.
+ * The store is shared read-only by all threads. Each thread holds a reference
+ * to the store it uses, which is released by #meos_finalize_ways, and the
+ * store is freed when its last reference is released. Setting the location
+ * of the file with #meos_set_ways_csv makes the next lookups read the new
+ * file. The geometries returned to a thread remain valid until the thread
+ * looks up a route of a new file or calls #meos_finalize_ways.
  */
 
 /* C */
 #include <assert.h>
 #include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <common/hashfn.h>
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
+#include <meos_internal_geo.h>
 #include "geo/tgeo_spatialfuncs.h"
 #include "npoint/tnpoint.h"
 
@@ -61,275 +75,293 @@
 char *WAYS_CSV = "/usr/local/share/ways1000.csv";
 
 /**
- * @ingroup meos_setup
- * @brief Set the location of the ways CSV file used to resolve npoint route
- * geometries
- * @param[in] path Full path to the ways CSV file
- */
-void
-meos_set_ways_csv(const char *path)
-{
-  WAYS_CSV = malloc(strlen(path) + 1);
-  strcpy(WAYS_CSV, path);
-}
-
-/**
- * @brief Structure to represent a record in the ways CSV file
+ * @brief Structure to represent a route of the ways store
  */
 typedef struct
 {
   int64 gid;              /**< Identifier of the route */
   GSERIALIZED *the_geom;  /**< Geometry of the route */
   double length;          /**< Length of the route */
-} ways_record;
+  STBox box;              /**< Bounding box of the route */
+} WaysRoute;
 
 /**
- * @brief Structure to represent an entry in the ways cache
+ * @brief The ways store holds the routes read from the ways CSV file and a
+ * hash table with open addressing giving the position of a route from its
+ * identifier
  */
-typedef struct struct_WaysCacheEntry
+typedef struct
 {
-  int64 gid;              /**< Identifier of the route */
-  GSERIALIZED *the_geom;  /**< Geometry of the route */
-  double length;          /**< Length of the route */
-  uint64_t hits;          /**< Number of hits of the route */
-} WaysCacheEntry;
-
-/* Number of items stored in the ways cache */
-#define WAYS_CACHE_SIZE 128
+  WaysRoute *routes;      /**< Routes in the order of the file */
+  int count;              /**< Number of routes */
+  int *slots;             /**< Positions of the routes in the array, -1 for
+                               an empty slot */
+  uint32 mask;            /**< Number of slots minus one */
+  int refcount;           /**< Number of threads using the store */
+} WaysStore;
+
+/* Minimum number of slots of the hash table, which is a power of two at
+ * least twice the number of routes */
+#define WAYS_MIN_SLOTS 16
+
+/* Store of the current ways CSV file, NULL until a route is looked up */
+static WaysStore *MEOS_WAYS_STORE = NULL;
+/* Protects the store of the current file and the reference counts */
+static pthread_mutex_t MEOS_WAYS_LOCK = PTHREAD_MUTEX_INITIALIZER;
+/* Store used by the calling thread, of which it holds a reference */
+static MEOS_TLS WaysStore *MEOS_WAYS = NULL;
 
 /**
- * @brief The ways cache holds a fixed number of ways records read from the
- * ways CSV file
- * @note In normal usage we do not expect it to have many entries, so we
- * linearly scan the list
+ * @ingroup meos_setup
+ * @brief Set the location of the ways CSV file used to resolve npoint route
+ * geometries
+ * @param[in] path Full path to the ways CSV file
  */
-typedef struct struct_WaysCache
+void
+meos_set_ways_csv(const char *path)
 {
-  WaysCacheEntry routes[WAYS_CACHE_SIZE];
-  uint32_t count;
-} WaysCache;
-
-/* Global variable to hold the ways cache */
-static MEOS_TLS WaysCache *MEOS_WAYS_CACHE = NULL;
+  char *csv = malloc(strlen(path) + 1);
+  strcpy(csv, path);
+  pthread_mutex_lock(&MEOS_WAYS_LOCK);
+  WAYS_CSV = csv;
+  /* The store of the previous file is freed by its last thread */
+  __atomic_store_n(&MEOS_WAYS_STORE, NULL, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&MEOS_WAYS_LOCK);
+  return;
+}
 
 /*****************************************************************************
- * Cache management functions
+ * Store management functions
  *****************************************************************************/
 
 /**
- * @brief Free all the malloc'ed geometries stored in the ways cache and free
- * the cache
+ * @brief Free the geometries and the arrays of a ways store
  */
 static void
-DestroyWaysCache(WaysCache *ways_cache)
+ways_store_free(WaysStore *store)
 {
-  if (ways_cache)
-  {
-    for (uint32_t i = 0; i < ways_cache->count; i++)
-    {
-      if (ways_cache->routes[i].the_geom)
-        pfree(ways_cache->routes[i].the_geom);
-    }
-  }
-  pfree(ways_cache);
+  for (int i = 0; i < store->count; i++)
+    pfree(store->routes[i].the_geom);
+  pfree(store->routes);
+  if (store->slots)
+    pfree(store->slots);
+  pfree(store);
   return;
 }
 
 /**
- * @brief Get the ways cache variable from the global variable if one exists.
- * If it doesn't exist, make a new blank one and return it.
-*/
-static WaysCache *
-GetWaysCache()
+ * @brief Return the slot of a route identifier in the hash table of a ways
+ * store, which is either the slot of the route or the empty slot where it
+ * would be added
+ */
+static uint32
+ways_store_slot(const WaysStore *store, int64 gid)
 {
-  WaysCache *ways_cache = MEOS_WAYS_CACHE;
-  if (! ways_cache)
-  {
-    /* Allocate memory */
-    ways_cache = palloc0(sizeof(WaysCache));
-    if (! ways_cache)
-    {
-      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
-        "Unable to allocate space for the ways cache");
-      return NULL;
-    }
-  }
-  MEOS_WAYS_CACHE = ways_cache;
-  return ways_cache;
+  uint32 slot = (uint32) murmurhash64((uint64) gid) & store->mask;
+  while (store->slots[slot] >= 0 &&
+      store->routes[store->slots[slot]].gid != gid)
+    slot = (slot + 1) & store->mask;
+  return slot;
 }
 
 /**
- * @ingroup meos_setup
- * @brief Destroy the ways cache
+ * @brief Build the hash table of a ways store
+ * @note When several records of the file have the same route identifier,
+ * the first one is kept, as when the file was scanned for each lookup
  */
-void
-meos_finalize_ways(void)
+static void
+ways_store_index(WaysStore *store)
 {
-  /* Idempotency: only destroy a live cache, and null the slot so a
-   * second finalize call does not double-free the cache and its
-   * stored geometries. */
-  if (! MEOS_WAYS_CACHE)
-    return;
-  DestroyWaysCache(MEOS_WAYS_CACHE);
-  MEOS_WAYS_CACHE = NULL;
+  uint32 nslots = WAYS_MIN_SLOTS;
+  while (nslots < 2 * (uint32) store->count)
+    nslots <<= 1;
+  store->mask = nslots - 1;
+  store->slots = palloc(sizeof(int) * nslots);
+  memset(store->slots, -1, sizeof(int) * nslots);
+  for (int i = 0; i < store->count; i++)
+  {
+    uint32 slot = ways_store_slot(store, store->routes[i].gid);
+    if (store->slots[slot] < 0)
+      store->slots[slot] = i;
+  }
+  return;
 }
 
 /**
- * @brief Get a route from the ways cache, if not found return `NULL`
+ * @brief Read the ways CSV file into a new store
+ * @return On error return @p NULL
  */
-static WaysCacheEntry *
-GetRouteFromWaysCache(WaysCache *ways_cache, int64 gid, bool any_gid)
+static WaysStore *
+ways_store_read(void)
 {
-  assert(ways_cache->count <= WAYS_CACHE_SIZE);
-  for (uint32_t i = 0; i < ways_cache->count; i++)
+  /* The full file path in the first argument is defined in a global variable*/
+  FILE *file = fopen(WAYS_CSV, "r");
+  if (! file)
   {
-    if (any_gid || ways_cache->routes[i].gid == gid)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Cannot open the ways CSV file (reading from %s); set its location with "
+      "meos_set_ways_csv()", WAYS_CSV);
+    return NULL;
+  }
+
+  WaysStore *store = palloc0(sizeof(WaysStore));
+  int maxcount = 1024;
+  store->routes = palloc(sizeof(WaysRoute) * maxcount);
+  char *line = palloc(MAX_LEN_GEOM + 32);
+  bool result = true;
+  /* Read the file line by line, so that a record without geometry does not
+   * make the next record be read as its geometry */
+  while (fgets(line, MAX_LEN_GEOM + 32, file))
+  {
+    /* Ignore the records with NULL values */
+    char *end;
+    long long gid = strtoll(line, &end, 10);
+    if (end == line || *end != ',')
+      continue;
+    char *geo_buffer = end + 1;
+    geo_buffer[strcspn(geo_buffer, " \t\r\n")] = '\0';
+    if (*geo_buffer == '\0')
+      continue;
+    /* Transform the geometry string into a geometry value */
+    GSERIALIZED *gs = geom_in(geo_buffer, -1);
+    if (! gs)
+    {
+      result = false;
+      break;
+    }
+    /* Ignore the records with empty geometries */
+    if (geo_is_empty(gs))
+    {
+      pfree(gs);
+      continue;
+    }
+    if (store->count == maxcount)
     {
-      ways_cache->routes[i].hits++;
-      return &ways_cache->routes[i];
+      maxcount *= 2;
+      store->routes = repalloc(store->routes, sizeof(WaysRoute) * maxcount);
     }
+    WaysRoute *route = &store->routes[store->count++];
+    route->gid = (int64) gid;
+    route->the_geom = gs;
+    route->length = geom_length(gs);
+    geo_set_stbox(gs, &route->box);
+  }
+  if (result && ferror(file))
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Error reading the ways CSV file");
+    result = false;
   }
-  return NULL;
+
+  /* Close the input file */
+  fclose(file);
+  pfree(line);
+  if (! result)
+  {
+    ways_store_free(store);
+    return NULL;
+  }
+  ways_store_index(store);
+  return store;
 }
 
 /**
- * @brief Remove from the ways cache the route in a given position 
+ * @brief Release the reference of the calling thread to its ways store,
+ * freeing the store if it was the last one
+ * @note Must be called with the lock held
  */
 static void
-DeleteRouteFromWaysCache(WaysCache *ways_cache, uint32_t position)
+ways_store_release(void)
 {
-  if (ways_cache->routes[position].the_geom)
-    pfree(ways_cache->routes[position].the_geom);
-  memset(&ways_cache->routes[position], 0, sizeof(WaysCacheEntry));
+  WaysStore *store = MEOS_WAYS;
+  MEOS_WAYS = NULL;
+  if (! store || --store->refcount > 0)
+    return;
+  if (store == MEOS_WAYS_STORE)
+    __atomic_store_n(&MEOS_WAYS_STORE, NULL, __ATOMIC_RELEASE);
+  ways_store_free(store);
   return;
 }
 
 /**
- * @brief Add a route to the ways cache
+ * @brief Return the store of the current ways CSV file, reading the file if
+ * no thread has read it yet
+ * @return On error return @p NULL
  */
-static WaysCacheEntry *
-AddRouteToWaysCache(WaysCache *ways_cache, ways_record *rec)
+static const WaysStore *
+ways_store(void)
 {
-  assert(ways_cache); assert(rec);
-
-  /* If the cache is full, find the least used element and delete it */
-  uint32_t cache_position = ways_cache->count;
-  uint32_t hits = 1;
-  if (cache_position == WAYS_CACHE_SIZE)
+  /* The store of the thread is used while the file has not changed */
+  WaysStore *store = MEOS_WAYS;
+  if (store && store == __atomic_load_n(&MEOS_WAYS_STORE, __ATOMIC_ACQUIRE))
+    return store;
+
+  /* The store outlives an arena scope open on the calling thread */
+  meos_arena_suspend();
+  pthread_mutex_lock(&MEOS_WAYS_LOCK);
+  ways_store_release();
+  store = MEOS_WAYS_STORE;
+  if (! store)
   {
-    cache_position = 0;
-    hits = ways_cache->routes[0].hits;
-    for (uint32_t i = 1; i < WAYS_CACHE_SIZE; i++)
+    /* The file is read without the lock, a store read concurrently by
+     * another thread is kept instead of this one */
+    pthread_mutex_unlock(&MEOS_WAYS_LOCK);
+    WaysStore *read = ways_store_read();
+    if (! read)
     {
-      if (ways_cache->routes[i].hits < hits)
-      {
-        cache_position = i;
-        hits = ways_cache->routes[i].hits;
-      }
+      meos_arena_resume();
+      return NULL;
+    }
+    pthread_mutex_lock(&MEOS_WAYS_LOCK);
+    store = MEOS_WAYS_STORE;
+    if (store)
+      ways_store_free(read);
+    else
+    {
+      store = read;
+      __atomic_store_n(&MEOS_WAYS_STORE, store, __ATOMIC_RELEASE);
     }
-    DeleteRouteFromWaysCache(ways_cache, cache_position);
-    /* To avoid the element we are introduced now being evicted next (as it
-     * would have 1 hit, being most likely the lower one) we reuse the hits
-     * from the evicted position and add some extra buffer */
-    hits += 5;
   }
-  else
-    ways_cache->count++;
-  assert(ways_cache->count <= WAYS_CACHE_SIZE);
-
-  /* Store everything in new cache entry */
-  assert(cache_position < WAYS_CACHE_SIZE);
-  ways_cache->routes[cache_position].gid = rec->gid;
-  ways_cache->routes[cache_position].the_geom = rec->the_geom;
-  ways_cache->routes[cache_position].length = rec->length;
-  ways_cache->routes[cache_position].hits = hits;
-
-  return &ways_cache->routes[cache_position];
+  store->refcount++;
+  MEOS_WAYS = store;
+  pthread_mutex_unlock(&MEOS_WAYS_LOCK);
+  meos_arena_resume();
+  return store;
 }
 
 /**
- * @brief Access the ways CSV file to get the geometry of a route and compute
- * its length 
- * @param[in] rid Route identifier
- * @param[out] rec Record to store on the cache
+ * @ingroup meos_setup
+ * @brief Release the ways store used by the calling thread
+ * @details The store is freed when no other thread uses it, and the
+ * geometries of the routes returned to the thread are no longer valid
  */
-static bool
-get_ways_record(int64 rid, ways_record *rec)
+void
+meos_finalize_ways(void)
 {
-  /* The full file path in the first argument is defined in a global variable*/
-  FILE *file = fopen(WAYS_CSV, "r");
-  if (! file)
-  {
-    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-      "Cannot open the ways CSV file (reading from %s); set its location with "
-      "meos_set_ways_csv()", WAYS_CSV);
-    return false;
-  }
-
-  bool result = false;
-  /* Continue reading the file */
-  do
-  {
-    char geo_buffer[MAX_LEN_GEOM];
-    long long gidbuf; /* MEOS: %ld mismatches int64 on LLP64 (Windows) */
-    int read = fscanf(file, "%lld,%100000s\n", &gidbuf, geo_buffer);
-    rec->gid = (int64) gidbuf; /* MEOS */
-    if (ferror(file))
-    {
-      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-        "Error reading the ways CSV file");
-      return false;
-    }
-
-    /* Ignore the records with NULL values or empty geometries */
-    if (read == 2 && rid == rec->gid)
-    {
-      /* Transform the geometry string into a geometry value */
-      rec->the_geom = geom_in(geo_buffer, -1);
-      if (! geo_is_empty(rec->the_geom))
-      {
-        if (rec->gid == rid)
-        {
-          rec->length = geom_length(rec->the_geom);
-          result = true;
-          break;
-        }
-      }
-      free(rec->the_geom);
-    }
-  } while (! feof(file));
-
-  /* Close the input file */
-  fclose(file);
-
-  return result;
+  /* Idempotency: only release a store held by the thread */
+  if (! MEOS_WAYS)
+    return;
+  pthread_mutex_lock(&MEOS_WAYS_LOCK);
+  ways_store_release();
+  pthread_mutex_unlock(&MEOS_WAYS_LOCK);
+  return;
 }
 
 /**
- * @brief Return true if a Ways entry was read from the ways cache,
- * return false otherwise
+ * @brief Return a route of the ways store, if not found return `NULL`
+ * @param[in] gid Route identifier
+ * @param[in] any_gid True when any route can be returned
  */
-static bool
-route_lookup(int64 gid, bool any_gid, ways_record *rec)
+static const WaysRoute *
+route_lookup(int64 gid, bool any_gid)
 {
-  /* Get or initialize the cache for this round */
-  WaysCache* ways_cache = GetWaysCache();
-  if (! ways_cache)
-    return true;
-
-  /* Add the route to the cache if it is not already there */
-  WaysCacheEntry *ways_entry = GetRouteFromWaysCache(ways_cache, gid, any_gid);
-  if (ways_entry == NULL)
-  {
-    if (! get_ways_record(gid, rec))
-      return false;
-    AddRouteToWaysCache(ways_cache, rec);
-    return true;
-  }
-  /* The route was found in the cache */
-  rec->gid = gid; rec->the_geom = ways_entry->the_geom;
-  rec->length = ways_entry->length;
-  return true;
+  const WaysStore *store = ways_store();
+  if (! store || store->count == 0)
+    return NULL;
+  if (any_gid)
+    return &store->routes[0];
+  int pos = store->slots[ways_store_slot(store, gid)];
+  return (pos < 0) ? NULL : &store->routes[pos];
 }
 
 /*****************************************************************************
@@ -338,32 +370,76 @@ route_lookup(int64 gid, bool any_gid, ways_record *rec)
 
 /**
  * @ingroup meos_npoint_base_route
- * @brief Return true if the ways cache contains a route with the route
+ * @brief Return true if the ways store contains a route with the route
  * identifier
  * @param[in] rid Route identifier
  */
 bool
 route_exists(int64 rid)
 {
-  ways_record rec;
-  if (route_lookup(rid, false, &rec) == LW_FAILURE)
-    return false;
-  return true;
+  return route_lookup(rid, false) != NULL;
 }
 
 /**
  * @ingroup meos_npoint_base_route
- * @brief Access the ways cache to get the geometry of a route identifier
+ * @brief Access the ways store to get the geometry of a route identifier
  * @param[in] rid Route identifier
  * @return On error return @p NULL
  */
 const GSERIALIZED *
 route_geom(int64 rid)
 {
-  ways_record rec;
-  if (route_lookup(rid, false, &rec) == LW_FAILURE)
-    return NULL;
-  return rec.the_geom;
+  const WaysRoute *route = route_lookup(rid, false);
+  return route ? route->the_geom : NULL;
+}
+
+/**
+ * @ingroup meos_npoint_base_route
+ * @brief Return in the last argument the geometries of an array of route
+ * identifiers, e.g., those of the instants of a temporal network point
+ * @param[in] rids Route identifiers
+ * @param[in] count Number of route identifiers
+ * @param[out] result Array of @p count geometries
+ * @return On error return false
+ */
+bool
+routes_geom(const int64 *rids, int count, const GSERIALIZED **result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(rids, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_positive(count))
+    return false;
+
+  const WaysStore *store = ways_store();
+  if (! store)
+    return false;
+  for (int i = 0; i < count; i++)
+  {
+    int pos = store->slots[ways_store_slot(store, rids[i])];
+    if (pos < 0)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "There is no route with gid value " INT64_FORMAT " in table ways",
+        rids[i]);
+      return false;
+    }
+    result[i] = store->routes[pos].the_geom;
+  }
+  return true;
+}
+
+/**
+ * @brief Ensure that the routes of an array of route identifiers can be
+ * looked up without reading the ways CSV file
+ * @details All routes are read into the ways store when the first one is
+ * looked up, so that ensuring that the store is loaded suffices
+ * @param[in] rids Route identifiers
+ * @param[in] count Number of route identifiers
+ */
+bool
+routes_fetch(const int64 *rids UNUSED, int count UNUSED)
+{
+  return ways_store() != NULL;
 }
 
 /**
@@ -376,19 +452,15 @@ route_geom(int64 rid)
 double
 route_length(int64 rid)
 {
-  ways_record rec;
-  if (route_lookup(rid, false, &rec) == LW_FAILURE)
-    return DBL_MAX;
-  return rec.length;
+  const WaysRoute *route = route_lookup(rid, false);
+  return route ? route->length : DBL_MAX;
 }
 
 int32_t
 get_srid_ways()
 {
-  ways_record rec;
-  if (route_lookup(0, true, &rec) == LW_FAILURE)
-    return SRID_INVALID;
-  return gserialized_get_srid(rec.the_geom);
+  const WaysRoute *route = route_lookup(0, true);
+  return route ? gserialized_get_srid(route->the_geom) : SRID_INVALID;
 }
 
 /*****************************************************************************
@@ -413,87 +485,49 @@ geompoint_to_npoint(const GSERIALIZED *gs)
   if (srid_ways == SRID_INVALID || ! ensure_same_srid(srid_geom, srid_ways))
     return NULL;
 
-  /* The full file path in the first argument is defined in a global variable*/
-  FILE *file = fopen(WAYS_CSV, "r");
-  if (! file)
-  {
-    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-      "Cannot open the ways CSV file (reading from %s); set its location with "
-      "meos_set_ways_csv()", WAYS_CSV);
+  const WaysStore *store = ways_store();
+  if (! store)
     return NULL;
-  }
 
-  /* Record holding one line of the file */
-  ways_record rec;
+  /* We need to reproduce the following SQL query for a given geometry geo
+   *   SELECT npoint(gid, ST_LineLocatePoint(the_geom, geo))
+   *   FROM public.ways WHERE ST_DWithin(the_geom, geo, MEOS_EPSILON)
+   *   ORDER BY ST_Distance(the_geom, geo) LIMIT 1;
+   */
+  const POINT2D *pt = GSERIALIZED_POINT2D_P(gs);
   /* Minimum distance */
   double min_dist = DBL_MAX;
-  /* Geometry with the shortest distance */
-  GSERIALIZED *the_geom = NULL;
-  /* Position in the geometry with the shortest distance */
+  /* Route with the shortest distance and position of the point in it */
+  int64 gid = 0;
   double pos = 0;
-  /* Read the file */
-  do
+  for (int i = 0; i < store->count; i++)
   {
-    /* We need to reproduce the following SQL query for a given geometry geo
-     *   SELECT npoint(gid, ST_LineLocatePoint(the_geom, geo))
-     *   FROM public.ways WHERE ST_DWithin(the_geom, geo, MEOS_EPSILON)
-     *   ORDER BY ST_Distance(the_geom, geo) LIMIT 1;
-     */
-    /* Buffer for reading the geometry string */
-    char geo_buffer[MAX_LEN_GEOM];
-    long long gidbuf; /* MEOS: %ld mismatches int64 on LLP64 (Windows) */
-    int read = fscanf(file, "%lld,%100000s\n", &gidbuf, geo_buffer);
-    rec.gid = (int64) gidbuf; /* MEOS */
-    if (ferror(file))
-    {
-      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-        "Error reading the ways CSV file");
-      return NULL;
-    }
-
-    /* Ignore the records with NULL values */
-    if (read == 2)
+    const WaysRoute *route = &store->routes[i];
+    /* Skip the routes whose bounding box is farther than the closest route,
+     * the distance to the box is reduced to be below the one to the route
+     * despite the rounding errors */
+    double dx = Max(Max(route->box.xmin - pt->x, pt->x - route->box.xmax), 0);
+    double dy = Max(Max(route->box.ymin - pt->y, pt->y - route->box.ymax), 0);
+    if (hypot(dx, dy) * (1.0 - 4 * DBL_EPSILON) > min_dist)
+      continue;
+    /* Continue if the point is not in the line */
+    double pos1 = line_locate_point(route->the_geom, gs);
+    if (pos1 < 0)
+      continue;
+    /* Compute minimal distance */
+    double dist = geom_distance2d(route->the_geom, gs);
+    if (dist < min_dist)
     {
-      /* Transform the geometry string into a geometry value */
-      rec.the_geom = geom_in(geo_buffer, -1);
-      /* Continue if the geometry is empty */
-      if (geo_is_empty(rec.the_geom))
-      {
-        free(rec.the_geom);
-        continue;
-      }
-      /* Continue if the point is not in the line */
-      pos = line_locate_point(rec.the_geom, gs);
-      if (pos < 0)
-      {
-        free(rec.the_geom);
-        continue;
-      }
-      /* Compute minimal distance */
-      double dist = geom_distance2d(rec.the_geom, gs);
-      if (dist < min_dist)
-      {
-        min_dist = dist;
-        /* Previous previous candidate to shortest distance */
-        if (the_geom)
-          free(the_geom);
-        the_geom = rec.the_geom;
-      }
-      else
-        free(rec.the_geom);
+      min_dist = dist;
+      gid = route->gid;
+      pos = pos1;
     }
-  } while (! feof(file));
-
-  /* Close the input file */
-  fclose(file);
+  }
 
   /* If the point was not found */
   if (min_dist == DBL_MAX)
     return NULL;
-
-  Npoint *result = npoint_make(rec.gid, pos);
-  free(the_geom);
-  return result;
+  return npoint_make(gid, pos);
 }
 
 /*****************************************************************************/
@@ -186,6 +186,7 @@
 #if JSON
   #include <meos_json.h>
 #endif
+#include "temporal/meos_parallel.h"
 #include "temporal/temporal_restrict.h"
 #include "temporal/tsequence.h"
 #include "temporal/tsequenceset.h"
@@ -723,8 +724,37 @@ tfunc_tsequence(const TSequence *seq, LiftedFunctionInfo *lfinfo)
     seq->period.upper_inc, interp, NORMALIZE);
 }
 
+/**
+ * @brief Arguments of the tasks applying a lifted function to the sequences
+ * of a temporal sequence set
+ */
+typedef struct
+{
+  const TSequenceSet *ss;           /**< Temporal value */
+  const LiftedFunctionInfo *lfinfo; /**< Information about the function */
+  TSequence **sequences;            /**< Result of each sequence */
+} TFuncSeqsetTasks;
+
+/**
+ * @brief Apply a lifted function to the n-th sequence of a temporal sequence
+ * set
+ * @note The information about the function is copied since the lifting may
+ * change it
+ */
+static void
+tfunc_tsequenceset_task(void *arg, int task)
+{
+  TFuncSeqsetTasks *tasks = (TFuncSeqsetTasks *) arg;
+  LiftedFunctionInfo lfinfo = *tasks->lfinfo;
+  tasks->sequences[task] = tfunc_tsequence(TSEQUENCESET_SEQ_N(tasks->ss,
+    task), &lfinfo);
+  return;
+}
+
 /**
  * @brief Apply a lifted function to a temporal sequence set
+ * @details The sequences are lifted by the threads of the MEOS thread pool
+ * when the sequence set is large enough
  * @param[in] ss Temporal value
  * @param[in] lfinfo Information about the lifted function
  */
@@ -737,8 +767,17 @@ tfunc_tsequenceset(const TSequenceSet *ss, LiftedFunctionInfo *lfinfo)
     return tfunc_null_tsequenceset(ss, lfinfo);
 #endif /* JSON */
   TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
-  for (int i = 0; i < ss->count; i++)
-    sequences[i] = tfunc_tsequence(TSEQUENCESET_SEQ_N(ss, i), lfinfo);
+  int nthreads = meos_parallel_pool_threads(ss->totalcount, ss->count);
+  if (nthreads > 1)
+  {
+    TFuncSeqsetTasks tasks = { ss, lfinfo, sequences };
+    meos_parallel_for(nthreads, ss->count, &tfunc_tsequenceset_task, &tasks);
+  }
+  else
+  {
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = tfunc_tsequence(TSEQUENCESET_SEQ_N(ss, i), lfinfo);
+  }
   return tsequenceset_make_free(sequences, ss->count, NORMALIZE);
 }
 
@@ -2061,8 +2100,54 @@ tfunc_tcontseq_tsequenceset(const TSequence *seq, const TSequenceSet *ss,
   return tfunc_tsequenceset_tcontseq(ss, seq, lfinfo);
 }
 
+/**
+ * @brief Arguments of the tasks applying a lifted function to the pairs of
+ * overlapping sequences of two temporal sequence sets
+ */
+typedef struct
+{
+  const TSequenceSet *ss1;          /**< First temporal value */
+  const TSequenceSet *ss2;          /**< Second temporal value */
+  const LiftedFunctionInfo *lfinfo; /**< Information about the function */
+  const int *pairs;                 /**< Sequence numbers of each pair */
+  TSequence ***sequences;           /**< Result sequences of each pair */
+  int *counts;                      /**< Number of result sequences of each
+                                         pair */
+} TFuncSeqsetPairTasks;
+
+/**
+ * @brief Apply a lifted function to the n-th pair of overlapping sequences of
+ * two temporal sequence sets
+ * @details The result sequences are kept in an array sized as in
+ * #tfunc_tcontseq_tcontseq
+ */
+static void
+tfunc_tsequenceset_pair_task(void *arg, int task)
+{
+  TFuncSeqsetPairTasks *tasks = (TFuncSeqsetPairTasks *) arg;
+  LiftedFunctionInfo lfinfo = *tasks->lfinfo;
+  const TSequence *seq1 = TSEQUENCESET_SEQ_N(tasks->ss1,
+    tasks->pairs[task * 2]);
+  const TSequence *seq2 = TSEQUENCESET_SEQ_N(tasks->ss2,
+    tasks->pairs[task * 2 + 1]);
+  int count;
+  if (lfinfo.discont)
+    count = (seq1->count + seq2->count) * 3;
+  else if (MEOS_FLAGS_LINEAR_INTERP(seq1->flags) ==
+      MEOS_FLAGS_LINEAR_INTERP(seq2->flags))
+    count = 1;
+  else
+    count = (seq1->count + seq2->count) * 2;
+  tasks->sequences[task] = palloc(sizeof(TSequence *) * count);
+  tasks->counts[task] = tfunc_tcontseq_tcontseq_dispatch(seq1, seq2, &lfinfo,
+    tasks->sequences[task]);
+  return;
+}
+
 /**
  * @brief Synchronize two temporal values and apply to them a lifted function
+ * @details The pairs of overlapping sequences are lifted by the threads of
+ * the MEOS thread pool when the sequence sets are large enough
  * @param[in] ss1,ss2 Temporal values
  * @param[in] lfinfo Information about the lifted function
  */
@@ -2071,6 +2156,12 @@ tfunc_tsequenceset_tsequenceset(const TSequenceSet *ss1,
   const TSequenceSet *ss2, LiftedFunctionInfo *lfinfo)
 {
   int count = ss1->totalcount + ss2->totalcount;
+  /* Sequence numbers of the pairs of sequences to synchronize, collected
+   * when the pairs are lifted by the threads of the pool */
+  int nthreads = meos_parallel_pool_threads(count, ss1->count + ss2->count);
+  int *pairs = (nthreads > 1) ?
+    palloc(sizeof(int) * 2 * (ss1->count + ss2->count)) : NULL;
+  int npairs = 0;
   if (lfinfo->discont)
     count *= 3;
   else
@@ -2085,8 +2176,14 @@ tfunc_tsequenceset_tsequenceset(const TSequenceSet *ss1,
   {
     const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss1, i);
     const TSequence *seq2 = TSEQUENCESET_SEQ_N(ss2, j);
-    nseqs += tfunc_tcontseq_tcontseq_dispatch(seq1, seq2, lfinfo,
-      &sequences[nseqs]);
+    if (pairs)
+    {
+      pairs[npairs * 2] = i;
+      pairs[npairs++ * 2 + 1] = j;
+    }
+    else
+      nseqs += tfunc_tcontseq_tcontseq_dispatch(seq1, seq2, lfinfo,
+        &sequences[nseqs]);
     int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(seq1->period.upper),
       DatumGetTimestampTz(seq2->period.upper));
     if (cmp == 0)
@@ -2105,6 +2202,28 @@ tfunc_tsequenceset_tsequenceset(const TSequenceSet *ss1,
     else
       j++;
   }
+  if (pairs)
+  {
+    /* Lift the pairs and concatenate their results in the order of the
+     * pairs, which is the one of the sequential loop above */
+    TFuncSeqsetPairTasks tasks;
+    tasks.ss1 = ss1;
+    tasks.ss2 = ss2;
+    tasks.lfinfo = lfinfo;
+    tasks.pairs = pairs;
+    tasks.sequences = palloc(sizeof(TSequence **) * npairs);
+    tasks.counts = palloc(sizeof(int) * npairs);
+    meos_parallel_for(nthreads, npairs, &tfunc_tsequenceset_pair_task,
+      &tasks);
+    for (int k = 0; k < npairs; k++)
+    {
+      memcpy(&sequences[nseqs], tasks.sequences[k],
+        sizeof(TSequence *) * tasks.counts[k]);
+      nseqs += tasks.counts[k];
+      pfree(tasks.sequences[k]);
+    }
+    pfree(tasks.sequences); pfree(tasks.counts); pfree(pairs);
+  }
   /* We need to normalize if the function has instantaneous discontinuities */
   return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
 }
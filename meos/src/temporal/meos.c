@@ -776,6 +776,8 @@ meos_finalize(void)
 #endif
   /* Finalize the PostgreSQL pseudo-random number generators */
   prng_finalize();
+  /* Release the arena */
+  meos_finalize_arena();
   return;
 }
 
@@ -0,0 +1,484 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Parallel execution of independent tasks by MEOS worker threads
+ * @details A parallel loop runs its tasks on the calling thread and on worker
+ * threads, each thread claiming the next task not yet claimed until none is
+ * left, so that a thread done with short tasks takes over those the others
+ * have not reached. The tasks of a loop must be independent, and a function
+ * using a loop obtains the same result whatever the number of threads, which
+ * only changes the time taken.
+ *
+ * The worker threads are those of the pool started by
+ * #meos_initialize_threads, which are created once and wait for the loops,
+ * each with its own MEOS thread-local state set up as for the thread that
+ * started the pool. Without a pool, a loop asked for several threads by an
+ * index function starts its worker threads for the duration of the loop, and
+ * the loops of the other MEOS functions run on the calling thread. A loop
+ * started from a task of another loop, or while the pool runs the loop of
+ * another thread, runs on the calling thread. In the MobilityDB extension,
+ * where a backend is single-threaded, the tasks run on the calling thread.
+ */
+
+/* C */
+#if MEOS
+  #include <pthread.h>
+  #include <stdint.h>
+  #include <string.h>
+  #include <unistd.h>
+#endif
+/* PostgreSQL */
+#include <postgres.h>
+#if MEOS
+  #include "pgtime.h"
+#endif
+/* MEOS */
+#include <meos.h>
+#if MEOS
+  #include <meos_error.h>
+#endif
+#include "temporal/meos_parallel.h"
+
+/* Maximum number of threads of a parallel loop */
+#define MEOS_MAX_THREADS 256
+
+/*****************************************************************************/
+
+/**
+ * @brief Return the number of threads used for a requested number of threads
+ * @details A single thread is used while the calling thread has an arena scope
+ * open, since the arena is per thread and the values allocated by the other
+ * threads would otherwise escape the scope
+ * @param[in] nthreads Requested number of threads, where a value less than 1
+ * requests one thread per online processor
+ */
+int
+meos_parallel_threads(int nthreads)
+{
+#if MEOS
+  if (meos_arena_depth() > 0)
+    return 1;
+  if (nthreads < 1)
+  {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = (ncpus < 1) ? 1 : (int) ncpus;
+  }
+  return (nthreads > MEOS_MAX_THREADS) ? MEOS_MAX_THREADS : nthreads;
+#else
+  (void) nthreads;
+  return 1;
+#endif /* MEOS */
+}
+
+#if MEOS
+/**
+ * @brief State of a parallel loop shared by its threads
+ */
+typedef struct
+{
+  meos_task_fn fn;          /**< Function executing a task */
+  void *arg;                /**< Argument of the function */
+  int ntasks;               /**< Number of tasks */
+  int next;                 /**< Next task to claim */
+  int error;                /**< First error number raised by a task */
+} MeosParallelLoop;
+
+/**
+ * @brief Pool of worker threads started by #meos_initialize_threads
+ */
+typedef struct
+{
+  pthread_mutex_t lock;     /**< Protects the fields below */
+  pthread_cond_t start;     /**< Signalled when a loop or the end is posted */
+  pthread_cond_t done;      /**< Signalled when the last worker of a loop is
+                                 done with it */
+  pthread_mutex_t busy;     /**< Held by the thread running a loop on the
+                                 pool */
+  pthread_t threads[MEOS_MAX_THREADS];  /**< Worker threads */
+  int nworkers;             /**< Number of worker threads */
+  MeosParallelLoop *loop;   /**< Loop posted to the workers */
+  int nwanted;              /**< Number of workers taking part in the loop */
+  int running;              /**< Number of workers still in the loop */
+  uint64 generation;        /**< Number of loops posted so far */
+  uint64 startgen;          /**< Number of loops posted when the workers
+                                 were started */
+  bool shutdown;            /**< True when the workers must exit */
+  char tzname[TZ_STRLEN_MAX + 1];  /**< Time zone of the posting thread */
+} MeosThreadPool;
+
+static MeosThreadPool MEOS_POOL = {
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .start = PTHREAD_COND_INITIALIZER,
+  .done = PTHREAD_COND_INITIALIZER,
+  .busy = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* Serializes the starting and the stopping of the pool */
+static pthread_mutex_t MEOS_POOL_SETUP = PTHREAD_MUTEX_INITIALIZER;
+
+/* True on a thread running the tasks of a loop */
+static MEOS_TLS bool MEOS_IN_LOOP = false;
+
+/* Time zone set on a worker thread of the pool */
+static MEOS_TLS char MEOS_WORKER_TZNAME[TZ_STRLEN_MAX + 1];
+
+/**
+ * @brief Copy the name of the time zone of the calling thread, the empty
+ * string standing for the default one
+ */
+static void
+meos_timezone_name(char *tzname)
+{
+  const char *name = session_timezone ?
+    pg_get_timezone_name(session_timezone) : NULL;
+  strncpy(tzname, name ? name : "", TZ_STRLEN_MAX);
+  tzname[TZ_STRLEN_MAX] = '\0';
+  return;
+}
+
+/**
+ * @brief Claim and execute the tasks of a parallel loop until none is left
+ * @details An error raised by a task, which sets the error number of the
+ * thread running it, is recorded in the loop so that the thread that started
+ * the loop reports it
+ */
+static void
+meos_parallel_run(MeosParallelLoop *loop)
+{
+  MEOS_IN_LOOP = true;
+  while (true)
+  {
+    int task = __atomic_fetch_add(&loop->next, 1, __ATOMIC_RELAXED);
+    if (task >= loop->ntasks)
+      break;
+    loop->fn(loop->arg, task);
+    int err = meos_errno_reset();
+    if (err)
+    {
+      int none = 0;
+      __atomic_compare_exchange_n(&loop->error, &none, err, false,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+  }
+  MEOS_IN_LOOP = false;
+  return;
+}
+
+/**
+ * @brief Execute the tasks of a parallel loop on a thread started for it
+ */
+static void *
+meos_parallel_worker(void *arg)
+{
+  meos_parallel_run((MeosParallelLoop *) arg);
+  return NULL;
+}
+
+/**
+ * @brief Set the MEOS thread-local state of a worker thread of the pool and
+ * run the loops posted to the pool until it is stopped
+ * @details The time zone of a worker follows the one of the thread posting
+ * each loop, while the allocator and the error handler are shared by all
+ * threads. The state is freed when the worker exits.
+ */
+static void *
+meos_pool_worker(void *arg)
+{
+  int index = (int) (intptr_t) arg;
+  uint64 seen;
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  strcpy(MEOS_WORKER_TZNAME, MEOS_POOL.tzname);
+  /* A loop may have been posted before the worker runs */
+  seen = MEOS_POOL.startgen;
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+  meos_initialize_timezone(MEOS_WORKER_TZNAME);
+  meos_initialize_collation();
+
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  while (true)
+  {
+    while (! MEOS_POOL.shutdown && MEOS_POOL.generation == seen)
+      pthread_cond_wait(&MEOS_POOL.start, &MEOS_POOL.lock);
+    if (MEOS_POOL.shutdown)
+      break;
+    seen = MEOS_POOL.generation;
+    if (index >= MEOS_POOL.nwanted)
+      continue;
+    MeosParallelLoop *loop = MEOS_POOL.loop;
+    bool newtz = (strcmp(MEOS_WORKER_TZNAME, MEOS_POOL.tzname) != 0);
+    if (newtz)
+      strcpy(MEOS_WORKER_TZNAME, MEOS_POOL.tzname);
+    pthread_mutex_unlock(&MEOS_POOL.lock);
+
+    if (newtz)
+      meos_initialize_timezone(MEOS_WORKER_TZNAME);
+    meos_parallel_run(loop);
+
+    pthread_mutex_lock(&MEOS_POOL.lock);
+    if (--MEOS_POOL.running == 0)
+      pthread_cond_signal(&MEOS_POOL.done);
+  }
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+  meos_finalize();
+  return NULL;
+}
+
+/**
+ * @brief Run a parallel loop on the workers of the pool and the calling
+ * thread
+ * @return False when the pool is not started or busy with the loop of another
+ * thread, in which case nothing has run
+ */
+static bool
+meos_pool_run(int nthreads, MeosParallelLoop *loop)
+{
+  if (pthread_mutex_trylock(&MEOS_POOL.busy) != 0)
+    return false;
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  if (MEOS_POOL.nworkers == 0)
+  {
+    pthread_mutex_unlock(&MEOS_POOL.lock);
+    pthread_mutex_unlock(&MEOS_POOL.busy);
+    return false;
+  }
+  MEOS_POOL.loop = loop;
+  MEOS_POOL.nwanted = Min(nthreads - 1, MEOS_POOL.nworkers);
+  MEOS_POOL.running = MEOS_POOL.nwanted;
+  meos_timezone_name(MEOS_POOL.tzname);
+  MEOS_POOL.generation++;
+  pthread_cond_broadcast(&MEOS_POOL.start);
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+
+  meos_parallel_run(loop);
+
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  while (MEOS_POOL.running > 0)
+    pthread_cond_wait(&MEOS_POOL.done, &MEOS_POOL.lock);
+  MEOS_POOL.loop = NULL;
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+  pthread_mutex_unlock(&MEOS_POOL.busy);
+  return true;
+}
+
+/**
+ * @brief Run a parallel loop on the calling thread and on threads started for
+ * the loop
+ */
+static void
+meos_transient_run(int nthreads, MeosParallelLoop *loop)
+{
+  pthread_t threads[MEOS_MAX_THREADS];
+  int nstarted = 0;
+  for (int i = 1; i < nthreads; i++)
+  {
+    /* A thread that cannot be started leaves its tasks to the others */
+    if (pthread_create(&threads[nstarted], NULL, meos_parallel_worker,
+        loop) == 0)
+      nstarted++;
+  }
+  meos_parallel_run(loop);
+  for (int i = 0; i < nstarted; i++)
+    pthread_join(threads[i], NULL);
+  return;
+}
+#endif /* MEOS */
+
+/**
+ * @brief Execute the tasks `0` to `ntasks - 1` of a parallel loop and return
+ * when all of them are done
+ * @details When the pool of #meos_initialize_threads is started the loop runs
+ * on it with at most as many threads as it has. An error raised by a task is
+ * reported on the calling thread once the loop is done.
+ * @param[in] nthreads Number of threads, see #meos_parallel_threads
+ * @param[in] ntasks Number of tasks
+ * @param[in] fn Function executing a task
+ * @param[in] arg Argument of the function
+ */
+void
+meos_parallel_for(int nthreads, int ntasks, meos_task_fn fn, void *arg)
+{
+  nthreads = meos_parallel_threads(nthreads);
+  if (nthreads > ntasks)
+    nthreads = ntasks;
+#if MEOS
+  if (MEOS_IN_LOOP)
+    nthreads = 1;
+#endif /* MEOS */
+  if (nthreads <= 1)
+  {
+    for (int i = 0; i < ntasks; i++)
+      fn(arg, i);
+    return;
+  }
+#if MEOS
+  MeosParallelLoop loop;
+  loop.fn = fn;
+  loop.arg = arg;
+  loop.ntasks = ntasks;
+  loop.next = 0;
+  loop.error = 0;
+  /* The error number of the calling thread is cleared while the loop runs so
+   * that an error of a task it runs is told from one raised before */
+  int saved = meos_errno_reset();
+  if (! meos_pool_run(nthreads, &loop))
+  {
+    bool started;
+    pthread_mutex_lock(&MEOS_POOL.lock);
+    started = (MEOS_POOL.nworkers > 0);
+    pthread_mutex_unlock(&MEOS_POOL.lock);
+    /* The pool is busy with the loop of another thread */
+    if (started)
+      meos_parallel_run(&loop);
+    else
+      meos_transient_run(nthreads, &loop);
+  }
+  if (loop.error)
+    meos_errno_set(loop.error);
+  else
+    meos_errno_restore(saved);
+#endif /* MEOS */
+  return;
+}
+
+/*****************************************************************************
+ * Thread pool
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_setup
+ * @brief Start the MEOS thread pool, which runs the parallel parts of the MEOS
+ * functions
+ * @details The pool has @p nthreads threads including the one calling a MEOS
+ * function, which takes part in the work, so that `nthreads - 1` worker
+ * threads are started. A worker thread sets its MEOS thread-local state as
+ * the calling thread has it, and takes the time zone of the thread calling
+ * each MEOS function it works for. Once the pool is started, the functions
+ * processing independent sequences, fragments or pairs in a loop, such as
+ * #temporal_merge_array, the lifted functions of sequence sets and
+ * #tgeo_space_time_split, split the loop between the threads when their
+ * input is large enough. A pool already started is stopped first. Without a
+ * pool these functions run on the calling thread.
+ * @param[in] nthreads Number of threads, a value less than 1 meaning as many
+ * as there are processors online
+ * @return Number of threads of the pool
+ */
+int
+meos_initialize_threads(int nthreads)
+{
+#if MEOS
+  nthreads = meos_parallel_threads(nthreads);
+  meos_finalize_threads();
+  pthread_mutex_lock(&MEOS_POOL_SETUP);
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  meos_timezone_name(MEOS_POOL.tzname);
+  MEOS_POOL.shutdown = false;
+  MEOS_POOL.startgen = MEOS_POOL.generation;
+  int nworkers = 0;
+  for (int i = 1; i < nthreads; i++)
+  {
+    /* A thread that cannot be started makes the pool smaller */
+    if (pthread_create(&MEOS_POOL.threads[nworkers], NULL, meos_pool_worker,
+        (void *) (intptr_t) nworkers) == 0)
+      nworkers++;
+  }
+  __atomic_store_n(&MEOS_POOL.nworkers, nworkers, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+  pthread_mutex_unlock(&MEOS_POOL_SETUP);
+  return nworkers + 1;
+#else
+  (void) nthreads;
+  return 1;
+#endif /* MEOS */
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Stop the MEOS thread pool, waiting for its worker threads to exit
+ * @details Must not be called while another thread runs a MEOS function.
+ * Nothing is done when the pool is not started.
+ */
+void
+meos_finalize_threads(void)
+{
+#if MEOS
+  pthread_mutex_lock(&MEOS_POOL_SETUP);
+  /* Wait for a loop running on the pool to end */
+  pthread_mutex_lock(&MEOS_POOL.busy);
+  pthread_mutex_lock(&MEOS_POOL.lock);
+  int nworkers = MEOS_POOL.nworkers;
+  __atomic_store_n(&MEOS_POOL.nworkers, 0, __ATOMIC_RELAXED);
+  MEOS_POOL.shutdown = true;
+  pthread_cond_broadcast(&MEOS_POOL.start);
+  pthread_mutex_unlock(&MEOS_POOL.lock);
+  for (int i = 0; i < nworkers; i++)
+    pthread_join(MEOS_POOL.threads[i], NULL);
+  pthread_mutex_unlock(&MEOS_POOL.busy);
+  pthread_mutex_unlock(&MEOS_POOL_SETUP);
+#endif /* MEOS */
+  return;
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Return the number of threads of the MEOS thread pool, 1 when it is
+ * not started
+ */
+int
+meos_get_threads(void)
+{
+#if MEOS
+  return __atomic_load_n(&MEOS_POOL.nworkers, __ATOMIC_RELAXED) + 1;
+#else
+  return 1;
+#endif /* MEOS */
+}
+
+/**
+ * @brief Return the number of threads of the pool between which a MEOS
+ * function splits a loop of @p ntasks tasks over an input of @p ninsts
+ * instants, 1 when the loop is too small to gain from it or when the calling
+ * thread has an arena scope open
+ */
+int
+meos_parallel_pool_threads(int ninsts, int ntasks)
+{
+#if MEOS
+  if (MEOS_IN_LOOP || meos_arena_depth() > 0 ||
+      ninsts < MEOS_PARALLEL_MIN_INSTANTS || ntasks < MEOS_PARALLEL_MIN_TASKS)
+    return 1;
+  return meos_get_threads();
+#else
+  (void) ninsts; (void) ntasks;
+  return 1;
+#endif /* MEOS */
+}
+
+/*****************************************************************************/
@@ -335,6 +335,15 @@ skiplist_free(SkipList *list)
     pfree(list->extra);
   if (list->freed)
     pfree(list->freed);
+  if (list->events)
+    pfree(list->events);
+  if (list->runs)
+  {
+    for (int i = 0; i < list->nruns; i++)
+      pfree_array(list->runs[i], list->runcounts[i]);
+    pfree(list->runs);
+    pfree(list->runcounts);
+  }
   if (list->elems)
   {
     /* Free the keys and values of the elements if they are not NULL */
@@ -355,6 +364,37 @@ skiplist_free(SkipList *list)
   return;
 }
 
+/**
+ * @brief Remove all the elements of the skiplist and free their keys and
+ * values
+ * @param[in,out] list Skiplist
+ */
+void
+skiplist_clear(SkipList *list)
+{
+  int cur = list->elems[0].next[0];
+  while (cur != list->tail && cur != -1)
+  {
+    SkipListElem *elem = &list->elems[cur];
+    if (elem->key)
+      pfree(elem->key);
+    if (elem->value)
+      pfree(elem->value);
+    cur = elem->next[0];
+  }
+  list->length = 0;
+  list->next = 2;
+  list->tail = 1;
+  list->freecount = 0;
+  SkipListElem *head = &list->elems[0];
+  SkipListElem *tail = &list->elems[1];
+  head->height = 0;
+  head->next[0] = 1;
+  tail->height = 0;
+  tail->next[0] = -1;
+  return;
+}
+
 /**
  * @brief Output the skiplist in graphviz dot format for visualisation and
  * debugging purposes
@@ -206,8 +206,15 @@ datum_sum_double4(Datum l, Datum r)
 bool
 ensure_same_skiplist_subtype(SkipList *state, uint8 subtype)
 {
-  Temporal *head = (Temporal *) skiplist_headval(state);
-  if (head->subtype != subtype)
+  /* The values of a temporal count may only be kept in the event buffer */
+  uint8 subtype1;
+  if (state->length > 0)
+    subtype1 = ((Temporal *) skiplist_headval(state))->subtype;
+  else if (state->nevents > 0)
+    subtype1 = state->evsubtype;
+  else
+    return true;
+  if (subtype1 != subtype)
   {
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
       "Cannot aggregate temporal values of different subtype");
@@ -398,6 +405,685 @@ temporal_skiplist_splice(SkipList *list, void **values, int count,
     SKIPLIST_TEMPORAL);
 }
 
+/*****************************************************************************
+ * Sweep-line temporal count
+ *
+ * Splicing every new value into the skiplist touches all the elements that
+ * overlap with it, which makes the temporal count quadratic on heavily
+ * overlapping inputs. Since the count is a sum of step functions with value
+ * 1, the transition functions only record the bounds of the values in an
+ * event buffer kept in the state, and the final function sorts the events
+ * once and computes the count with a single linear sweep.
+ *****************************************************************************/
+
+/* Initial number of events in the buffer */
+#define TCOUNT_EVENTS_INITIAL 1024
+/* Number of events above which the buffer is flushed into the skiplist */
+#define TCOUNT_EVENTS_MAX (1 << 24)
+
+/**
+ * @brief Kinds of events of the temporal count
+ */
+typedef enum
+{
+  TCOUNT_INST,       /**< Instant counted at its timestamp */
+  TCOUNT_START_INC,  /**< Inclusive lower bound of a span */
+  TCOUNT_START_EXC,  /**< Exclusive lower bound of a span */
+  TCOUNT_END_INC,    /**< Inclusive upper bound of a span */
+  TCOUNT_END_EXC,    /**< Exclusive upper bound of a span */
+} TCountEventKind;
+
+/**
+ * @brief Structure of an event of the temporal count
+ */
+typedef struct
+{
+  TimestampTz t;     /**< Timestamp of the event */
+  int8 kind;         /**< Kind of the event */
+} TCountEvent;
+
+/**
+ * @brief Comparator function for events of the temporal count
+ */
+static int
+tcount_event_cmp(const void *e1, const void *e2)
+{
+  TimestampTz t1 = ((const TCountEvent *) e1)->t;
+  TimestampTz t2 = ((const TCountEvent *) e2)->t;
+  return (t1 < t2) ? -1 : ((t1 > t2) ? 1 : 0);
+}
+
+/**
+ * @brief Ensure that the event buffer of a temporal count has room for
+ * additional events
+ * @param[in,out] state Skiplist containing the state
+ * @param[in] count Number of events to add
+ * @param[in] subtype Subtype of the values counted
+ */
+static bool
+tcount_events_reserve(SkipList *state, int count, uint8 subtype)
+{
+  if (! ensure_same_skiplist_subtype(state, subtype))
+    return false;
+  /* Bound the size of the buffer by aggregating its events in the skiplist */
+  if (state->nevents > 0 && state->nevents + count > TCOUNT_EVENTS_MAX)
+    temporal_tcount_flush(state);
+  state->evsubtype = subtype;
+  if (state->nevents + count <= state->evcapacity)
+    return true;
+
+  int capacity = Max(state->evcapacity, TCOUNT_EVENTS_INITIAL);
+  while (capacity < state->nevents + count)
+    capacity <<= 1;
+  if (! state->events)
+  {
+#if ! MEOS
+    MemoryContext ctx = set_aggregation_context(fetch_fcinfo());
+#endif /* ! MEOS */
+    state->events = palloc(sizeof(TCountEvent) * capacity);
+#if ! MEOS
+    unset_aggregation_context(ctx);
+#endif /* ! MEOS */
+  }
+  else
+    state->events = repalloc(state->events, sizeof(TCountEvent) * capacity);
+  state->evcapacity = capacity;
+  return true;
+}
+
+/**
+ * @brief Add an event to the buffer of a temporal count
+ * @note The buffer must have been reserved by #tcount_events_reserve
+ */
+static inline void
+tcount_event_add(SkipList *state, TimestampTz t, TCountEventKind kind)
+{
+  TCountEvent *event = &((TCountEvent *) state->events)[state->nevents++];
+  event->t = t;
+  event->kind = (int8) kind;
+  return;
+}
+
+/**
+ * @brief Add the events of a span to the buffer of a temporal count
+ * @note The buffer must have been reserved by #tcount_events_reserve
+ */
+static void
+tcount_span_add(SkipList *state, TimestampTz lower, TimestampTz upper,
+  bool lower_inc, bool upper_inc)
+{
+  if (lower == upper)
+    tcount_event_add(state, lower, TCOUNT_INST);
+  else
+  {
+    tcount_event_add(state, lower,
+      lower_inc ? TCOUNT_START_INC : TCOUNT_START_EXC);
+    tcount_event_add(state, upper,
+      upper_inc ? TCOUNT_END_INC : TCOUNT_END_EXC);
+  }
+  return;
+}
+
+/**
+ * @brief Return the temporal count of the instants in the event buffer
+ * @param[in] events Sorted array of events
+ * @param[in] count Number of events
+ */
+static TSequence *
+tcount_events_sweep_inst(const TCountEvent *events, int count)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  int ninsts = 0;
+  int i = 0;
+  while (i < count)
+  {
+    TimestampTz t = events[i].t;
+    int j = i + 1;
+    while (j < count && events[j].t == t)
+      j++;
+    instants[ninsts++] = tinstant_make(Int32GetDatum(j - i), T_TINT, t);
+    i = j;
+  }
+  return tsequence_make_free(instants, ninsts, true, true, DISCRETE,
+    NORMALIZE_NO);
+}
+
+/**
+ * @brief Return the temporal count of the spans in the event buffer
+ * @details At each distinct timestamp `t` of the events the count of the
+ * instant `t` and of the open span that follows `t` are derived from the
+ * count of the open span that precedes `t` and the bounds at `t`. A step
+ * sequence is extended as long as its value at `t` is the value after `t`,
+ * otherwise it is closed at `t` and a new one is started.
+ * @param[in] events Sorted array of events
+ * @param[in] count Number of events
+ */
+static TSequenceSet *
+tcount_events_sweep_seq(const TCountEvent *events, int count)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  int nseqs = 0, ninsts = 0;
+  bool open = false, lower_inc = false;
+  /* Count of the open span preceding the current timestamp */
+  int before = 0;
+  int i = 0;
+  while (i < count)
+  {
+    TimestampTz t = events[i].t;
+    int starts = 0, starts_inc = 0, ends = 0, ends_inc = 0, insts = 0;
+    for (; i < count && events[i].t == t; i++)
+    {
+      switch (events[i].kind)
+      {
+        case TCOUNT_INST:
+          insts++;
+          break;
+        case TCOUNT_START_INC:
+          starts_inc++;
+          /* fallthrough */
+        case TCOUNT_START_EXC:
+          starts++;
+          break;
+        case TCOUNT_END_INC:
+          ends_inc++;
+          /* fallthrough */
+        default: /* TCOUNT_END_EXC */
+          ends++;
+      }
+    }
+    /* Count at the timestamp and in the open span following it */
+    int at = before - ends + ends_inc + starts_inc + insts;
+    int after = before - ends + starts;
+    bool close = false, upper_inc = false;
+    if (open)
+    {
+      if (at == 0)
+      {
+        instants[ninsts++] = tinstant_make(Int32GetDatum(before), T_TINT, t);
+        close = true;
+      }
+      else if (at != before || after != at)
+      {
+        instants[ninsts++] = tinstant_make(Int32GetDatum(at), T_TINT, t);
+        close = (after != at);
+        upper_inc = true;
+      }
+    }
+    else if (at > 0)
+    {
+      instants[ninsts++] = tinstant_make(Int32GetDatum(at), T_TINT, t);
+      lower_inc = open = true;
+      close = (after != at);
+      upper_inc = true;
+    }
+    if (close)
+    {
+      sequences[nseqs++] = tsequence_make(instants, ninsts, lower_inc,
+        upper_inc, STEP, NORMALIZE_NO);
+      for (int k = 0; k < ninsts; k++)
+        pfree(instants[k]);
+      ninsts = 0;
+      open = false;
+    }
+    if (! open && after > 0)
+    {
+      instants[ninsts++] = tinstant_make(Int32GetDatum(after), T_TINT, t);
+      lower_inc = false;
+      open = true;
+    }
+    before = after;
+  }
+  assert(! open && before == 0);
+  pfree(instants);
+  return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
+/**
+ * @brief Return the temporal count of the events in the buffer of the state
+ * and empty the buffer
+ */
+static Temporal *
+tcount_events_sweep(SkipList *state)
+{
+  TCountEvent *events = (TCountEvent *) state->events;
+  qsort(events, (size_t) state->nevents, sizeof(TCountEvent),
+    &tcount_event_cmp);
+  Temporal *result = (state->evsubtype == TINSTANT) ?
+    (Temporal *) tcount_events_sweep_inst(events, state->nevents) :
+    (Temporal *) tcount_events_sweep_seq(events, state->nevents);
+  state->nevents = 0;
+  return result;
+}
+
+/**
+ * @brief Aggregate in the skiplist the events in the buffer of a temporal
+ * count
+ * @param[in,out] state Skiplist containing the state
+ * @note This function is called before the state is serialized or when the
+ * buffer is full
+ */
+void
+temporal_tcount_flush(SkipList *state)
+{
+  if (! state || state->nevents == 0)
+    return;
+  Temporal *temp = tcount_events_sweep(state);
+  if (temp->subtype == TSEQUENCE)
+  {
+    int count;
+    const TInstant **instants = tsequence_insts_p((TSequence *) temp, &count);
+    temporal_skiplist_splice(state, (void **) instants, count,
+      &datum_sum_int32, CROSSINGS_NO);
+    pfree(instants);
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequence **sequences =
+      tsequenceset_sequences_p((TSequenceSet *) temp);
+    temporal_skiplist_splice(state, (void **) sequences,
+      ((TSequenceSet *) temp)->count, &datum_sum_int32, CROSSINGS_NO);
+    pfree(sequences);
+  }
+  pfree(temp);
+  return;
+}
+
+/**
+ * @brief Add the events in the buffer of the second state to the buffer of
+ * the first one
+ */
+static bool
+tcount_events_append(SkipList *state1, const SkipList *state2)
+{
+  if (! tcount_events_reserve(state1, state2->nevents, state2->evsubtype))
+    return false;
+  memcpy((TCountEvent *) state1->events + state1->nevents, state2->events,
+    sizeof(TCountEvent) * state2->nevents);
+  state1->nevents += state2->nevents;
+  return true;
+}
+
+/**
+ * @brief Add the spans of an array of temporal sequences to the buffer of
+ * a temporal count
+ * @param[in,out] state Skiplist containing the state, may be `NULL`
+ * @param[in] sequences Array of sequences
+ * @param[in] count Number of elements in the array
+ */
+SkipList *
+tcount_seqarr_events(SkipList *state, TSequence **sequences, int count)
+{
+  if (! state)
+    state = temporal_skiplist_make();
+  if (! tcount_events_reserve(state, count * 2, TSEQUENCE))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    const Span *p = &sequences[i]->period;
+    tcount_span_add(state, DatumGetTimestampTz(p->lower),
+      DatumGetTimestampTz(p->upper), p->lower_inc, p->upper_inc);
+  }
+  return state;
+}
+
+/*****************************************************************************
+ * Deferred merge of the states of parallel aggregations
+ *
+ * Splicing the values of every combined state into the skiplist of the first
+ * one rewrites the whole list once per state when the states cover the same
+ * period, as those of the parallel workers do. The combine function keeps
+ * instead the values of each state as a sorted run and the final function
+ * merges the k runs in a balanced tree of pairwise merges, that is, in
+ * log2(k) linear passes.
+ *****************************************************************************/
+
+/**
+ * @brief Return a copy of the temporal values contained in the skiplist
+ */
+Temporal **
+skiplist_temporal_values(SkipList *list)
+{
+  Temporal **result = palloc(sizeof(Temporal *) * list->length);
+  int cur = list->elems[0].next[0];
+  int count = 0;
+  while (cur != list->tail)
+  {
+    result[count++] = temporal_copy(list->elems[cur].value);
+    cur = list->elems[cur].next[0];
+  }
+  return result;
+}
+
+/* Initial number of runs of a state */
+#define TAGG_RUNS_INITIAL 8
+
+/**
+ * @brief Add a sorted run of values to the state
+ * @param[in,out] state Skiplist containing the state
+ * @param[in] values Array of values, which are owned by the state afterwards
+ * @param[in] count Number of elements in the array
+ * @param[in] func Function used when merging the runs
+ * @param[in] crossings True if turning points are added in the segments
+ * @note The function must be called in the memory context of the aggregation
+ */
+static void
+tagg_run_add(SkipList *state, void **values, int count, datum_func2 func,
+  bool crossings)
+{
+  if (state->nruns == state->runcapacity)
+  {
+    int capacity = Max(state->runcapacity << 1, TAGG_RUNS_INITIAL);
+    if (! state->runs)
+    {
+      state->runs = palloc(sizeof(void **) * capacity);
+      state->runcounts = palloc(sizeof(int) * capacity);
+    }
+    else
+    {
+      state->runs = repalloc(state->runs, sizeof(void **) * capacity);
+      state->runcounts = repalloc(state->runcounts, sizeof(int) * capacity);
+    }
+    state->runcapacity = capacity;
+  }
+  state->runs[state->nruns] = values;
+  state->runcounts[state->nruns++] = count;
+  state->runfunc = func;
+  state->runcrossings = crossings;
+  return;
+}
+
+/**
+ * @brief Return the merge of two sorted runs of values
+ * @param[in] values1,values2 Arrays of values
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] func Function, may be NULL for the merge aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[out] newcount Number of elements in the output array
+ * @note The values in the output array are new and the input arrays are not
+ * modified
+ */
+static void **
+tagg_run_merge(void **values1, int count1, void **values2, int count2,
+  datum_func2 func, bool crossings, int *newcount)
+{
+  /* Temporal aggregation cannot mix instants and sequences */
+  Temporal *temp1 = (Temporal *) values1[0];
+  Temporal *temp2 = (Temporal *) values2[0];
+  if (temp1->subtype != temp2->subtype)
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Cannot aggregate temporal values of different subtype");
+    return NULL;
+  }
+  if (MEOS_FLAGS_LINEAR_INTERP(temp1->flags) !=
+      MEOS_FLAGS_LINEAR_INTERP(temp2->flags))
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Cannot aggregate temporal values of different interpolation");
+    return NULL;
+  }
+  if (temp1->subtype == TSEQUENCE)
+    return (void **) tsequence_tagg((TSequence **) values1, count1,
+      (TSequence **) values2, count2, func, crossings, newcount);
+
+  /* All the instants of the result are new */
+  void **tofree;
+  int nfree;
+  void **result = (void **) tinstant_tagg((TInstant **) values1, count1,
+    (TInstant **) values2, count2, func, newcount, &tofree, &nfree);
+  if (result)
+    pfree(tofree);
+  return result;
+}
+
+/**
+ * @brief Merge the runs of the combined states into the skiplist of the state
+ * @param[in,out] state Skiplist containing the state
+ * @return On error return false
+ */
+bool
+temporal_tagg_merge_runs(SkipList *state)
+{
+  if (! state || state->nruns == 0)
+    return true;
+
+  /* The values of the skiplist are one more run */
+  int k = 0;
+  void ***runs = palloc(sizeof(void **) * (state->nruns + 1));
+  int *counts = palloc(sizeof(int) * (state->nruns + 1));
+  if (state->length > 0)
+  {
+    runs[k] = (void **) skiplist_temporal_values(state);
+    counts[k++] = state->length;
+  }
+  for (int i = 0; i < state->nruns; i++)
+  {
+    runs[k] = state->runs[i];
+    counts[k++] = state->runcounts[i];
+  }
+  state->nruns = 0;
+
+  /* Merge the runs pairwise until only one remains */
+  bool result = true;
+  while (k > 1 && result)
+  {
+    int m = 0;
+    for (int i = 0; i < k; i += 2)
+    {
+      if (i == k - 1 || ! result)
+      {
+        runs[m] = runs[i];
+        counts[m++] = counts[i];
+        continue;
+      }
+      int count;
+      void **merged = tagg_run_merge(runs[i], counts[i], runs[i + 1],
+        counts[i + 1], state->runfunc, state->runcrossings, &count);
+      if (! merged)
+      {
+        /* Keep the runs to free them below */
+        result = false;
+        runs[m] = runs[i];
+        counts[m++] = counts[i];
+        runs[m] = runs[i + 1];
+        counts[m++] = counts[i + 1];
+        continue;
+      }
+      pfree_array(runs[i], counts[i]);
+      pfree_array(runs[i + 1], counts[i + 1]);
+      runs[m] = merged;
+      counts[m++] = count;
+    }
+    k = m;
+  }
+
+  /* Replace the values of the skiplist by the merged run */
+  if (result)
+  {
+    skiplist_clear(state);
+    temporal_skiplist_splice(state, runs[0], counts[0], NULL, false);
+  }
+  for (int i = 0; i < k; i++)
+    pfree_array(runs[i], counts[i]);
+  pfree(runs); pfree(counts);
+  return result;
+}
+
+/*****************************************************************************
+ * Compact binary format of the aggregate state
+ *
+ * The state is written as a header followed by the values of the skiplist
+ * in their own flat representation, each padded to a multiple of 8 bytes,
+ * the events of a temporal count, and the additional data. Since the values
+ * are sorted and disjoint, they are read back without any merge. The format
+ * is only meant to exchange states between processes of the same server, as
+ * the parallel workers of PostgreSQL.
+ *****************************************************************************/
+
+/**
+ * @brief Header of the binary format of the aggregate state
+ */
+typedef struct
+{
+  int32 length;      /**< Number of values of the skiplist */
+  int32 nevents;     /**< Number of events of a temporal count */
+  uint64 extrasize;  /**< Size of the additional data */
+  uint8 evsubtype;   /**< Subtype of the values counted */
+} TaggStateHeader;
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the size in bytes of the binary format of an aggregate state
+ * @param[in,out] state Skiplist containing the state
+ * @note The runs of the combined states are merged into the skiplist first
+ */
+size_t
+temporal_aggstate_size(SkipList *state)
+{
+  if (! temporal_tagg_merge_runs(state))
+    return 0;
+  size_t result = DOUBLE_PAD(sizeof(TaggStateHeader));
+  int cur = state->elems[0].next[0];
+  while (cur != state->tail)
+  {
+    result += DOUBLE_PAD(VARSIZE(state->elems[cur].value));
+    cur = state->elems[cur].next[0];
+  }
+  return result + sizeof(TCountEvent) * state->nevents + state->extrasize;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Write an aggregate state in binary format
+ * @param[in] state Skiplist containing the state
+ * @param[out] buf Buffer of the size given by #temporal_aggstate_size
+ */
+void
+temporal_aggstate_write(const SkipList *state, uint8_t *buf)
+{
+  assert(state->nruns == 0);
+  TaggStateHeader header;
+  memset(&header, 0, sizeof(TaggStateHeader));
+  header.length = state->length;
+  header.nevents = state->nevents;
+  header.extrasize = state->extrasize;
+  header.evsubtype = state->evsubtype;
+  size_t size = DOUBLE_PAD(sizeof(TaggStateHeader));
+  memset(buf, 0, size);
+  memcpy(buf, &header, sizeof(TaggStateHeader));
+  uint8_t *cur_buf = buf + size;
+  int cur = state->elems[0].next[0];
+  while (cur != state->tail)
+  {
+    const Temporal *temp = state->elems[cur].value;
+    size = VARSIZE(temp);
+    memcpy(cur_buf, temp, size);
+    /* Zero the padding so that equal states have equal bytes */
+    memset(cur_buf + size, 0, DOUBLE_PAD(size) - size);
+    cur_buf += DOUBLE_PAD(size);
+    cur = state->elems[cur].next[0];
+  }
+  if (state->nevents > 0)
+  {
+    size = sizeof(TCountEvent) * state->nevents;
+    memcpy(cur_buf, state->events, size);
+    cur_buf += size;
+  }
+  if (state->extrasize > 0)
+    memcpy(cur_buf, state->extra, state->extrasize);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return an aggregate state read from its binary format
+ * @param[in] buf Buffer written by #temporal_aggstate_write
+ * @param[in] size Size of the buffer
+ * @return On error return `NULL`
+ * @pre The buffer is aligned on a double since the temporal values it
+ * contains are read in place
+ */
+SkipList *
+temporal_aggstate_read(const uint8_t *buf, size_t size)
+{
+  TaggStateHeader header;
+  if (size < DOUBLE_PAD(sizeof(TaggStateHeader)))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid binary format of the aggregate state");
+    return NULL;
+  }
+  memcpy(&header, buf, sizeof(TaggStateHeader));
+  const uint8_t *cur_buf = buf + DOUBLE_PAD(sizeof(TaggStateHeader));
+  size_t remaining = size - DOUBLE_PAD(sizeof(TaggStateHeader));
+  /* Each value takes at least the size of its header in the buffer */
+  if (header.length < 0 || header.nevents < 0 ||
+      (size_t) header.length > remaining / sizeof(Temporal) ||
+      header.extrasize > remaining)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid binary format of the aggregate state");
+    return NULL;
+  }
+
+  /* Verify that the values fit in the buffer before reading them */
+  void **values = NULL;
+  if (header.length > 0)
+  {
+    values = palloc(sizeof(void *) * header.length);
+    for (int i = 0; i < header.length; i++)
+    {
+      uint32 varsize = 0;
+      if (remaining >= sizeof(Temporal))
+        varsize = VARSIZE(cur_buf);
+      if (remaining < sizeof(Temporal) || varsize < sizeof(Temporal) ||
+          DOUBLE_PAD(varsize) > remaining)
+      {
+        pfree(values);
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "Invalid binary format of the aggregate state");
+        return NULL;
+      }
+      values[i] = (void *) cur_buf;
+      cur_buf += DOUBLE_PAD(varsize);
+      remaining -= DOUBLE_PAD(varsize);
+    }
+  }
+  size_t evsize = sizeof(TCountEvent) * (size_t) header.nevents;
+  if (evsize + header.extrasize != remaining)
+  {
+    if (values)
+      pfree(values);
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid binary format of the aggregate state");
+    return NULL;
+  }
+
+  SkipList *result = temporal_skiplist_make();
+  if (header.length > 0)
+  {
+    /* The values are copied by the splice, which does not merge them since
+     * the skiplist is empty */
+    temporal_skiplist_splice(result, values, header.length, NULL, false);
+    pfree(values);
+  }
+  if (header.nevents > 0)
+  {
+    if (! tcount_events_reserve(result, header.nevents, header.evsubtype))
+    {
+      skiplist_free(result);
+      return NULL;
+    }
+    memcpy(result->events, cur_buf, evsize);
+    result->nevents = header.nevents;
+    cur_buf += evsize;
+  }
+  if (header.extrasize > 0)
+    skiplist_set_extra(result, (void *) cur_buf, header.extrasize);
+  return result;
+}
+
 /*****************************************************************************
  * Generic aggregation functions
  *****************************************************************************/
@@ -483,8 +1169,10 @@ tinstant_tagg(TInstant **instants1, int count1, TInstant **instants2,
       j++;
     }
   }
-  /* We finished to aggregate state1 */
-  assert (i == count1);
+  /* Copy the instants from state1 that are after the end of state2, which
+   * only happens when merging the runs of combined states */
+  while (i < count1)
+    result[count++] = tinstant_copy(instants1[i++]);
   /* Copy the instants from state2 that are after the end of state1 */
   while (j < count2)
   {
@@ -902,33 +1590,35 @@ temporal_tagg_combinefn(SkipList *state1, SkipList *state2, datum_func2 func,
   if (! state2)
     return state1;
 
-  if (state1->length == 0)
+  if (state1->length == 0 && state1->nevents == 0 && state1->nruns == 0)
     return state2;
-  if (state2->length == 0)
+  if (state2->length == 0 && state2->nevents == 0 && state2->nruns == 0)
     return state1;
 
-  int count2 = state2->length;
-  void **values2 = skiplist_values(state2);
-  temporal_skiplist_splice(state1, values2, count2, func, crossings);
-  pfree(values2);
-  return state1;
-}
-
-/**
- * @brief Return a copy of the temporal values contained in the skiplist
- */
-Temporal **
-skiplist_temporal_values(SkipList *list)
-{
-  Temporal **result = palloc(sizeof(Temporal *) * list->length);
-  int cur = list->elems[0].next[0];
-  int count = 0;
-  while (cur != list->tail)
+  /* The events of a temporal count are aggregated by the final function */
+  if (state2->nevents > 0 && ! tcount_events_append(state1, state2))
+    return NULL;
+  /* The values of the second state are kept as sorted runs that are merged
+   * all at once by the final function */
+#if ! MEOS
+  MemoryContext ctx = set_aggregation_context(fetch_fcinfo());
+#endif /* ! MEOS */
+  if (state2->length > 0)
   {
-    result[count++] = temporal_copy(list->elems[cur].value);
-    cur = list->elems[cur].next[0];
+    Temporal **values2 = skiplist_temporal_values(state2);
+    tagg_run_add(state1, (void **) values2, state2->length, func, crossings);
   }
-  return result;
+  for (int i = 0; i < state2->nruns; i++)
+  {
+    void **values2 = palloc(sizeof(void *) * state2->runcounts[i]);
+    for (int j = 0; j < state2->runcounts[i]; j++)
+      values2[j] = temporal_copy(state2->runs[i][j]);
+    tagg_run_add(state1, values2, state2->runcounts[i], func, crossings);
+  }
+#if ! MEOS
+  unset_aggregation_context(ctx);
+#endif /* ! MEOS */
+  return state1;
 }
 
 /**
@@ -940,7 +1630,20 @@ skiplist_temporal_values(SkipList *list)
 Temporal *
 temporal_tagg_finalfn(SkipList *state)
 {
-  if (! state || state->length == 0)
+  if (! state || ! temporal_tagg_merge_runs(state))
+    return NULL;
+  /* Sweep the events of a temporal count, which are usually the whole state */
+  if (state->nevents > 0)
+  {
+    if (state->length == 0)
+    {
+      Temporal *result = tcount_events_sweep(state);
+      skiplist_free(state);
+      return result;
+    }
+    temporal_tcount_flush(state);
+  }
+  if (state->length == 0)
     return NULL;
   /* A copy of the values is needed for switching from aggregate context,
    * for this reason the #skiplist_values cannot be used */
@@ -1075,78 +1778,6 @@ temporal_tagg_transform_transfn(SkipList *state, const Temporal *temp,
  * Temporal count
  *****************************************************************************/
 
-/**
- * @brief Transform a timestamp value into a temporal integer value for
- * performing temporal count aggregation
- */
-static TInstant **
-timestamp_transform_tcount(TimestampTz t)
-{
-  TInstant **result = palloc(sizeof(TInstant *));
-  result[0] = tinstant_make(Int32GetDatum(1), T_TINT, t);
-  return result;
-}
-
-/**
- * @brief Transform a timestamp set value into a temporal integer value for
- * performing temporal count aggregation
- */
-static TInstant **
-tstzset_transform_tcount(const Set *s)
-{
-  TInstant **result = palloc(sizeof(TInstant *) * s->count);
-  for (int i = 0; i < s->count; i++)
-  {
-    TimestampTz t = DatumGetTimestampTz(SET_VAL_N(s, i));
-    result[i] = tinstant_make(Int32GetDatum(1), T_TINT, t);
-  }
-  return result;
-}
-
-/**
- * @brief Transform a a timestamptz span into a temporal integer value for
- * performing temporal count aggregation
- */
-static TSequence *
-tstzspan_transform_tcount(const Span *s)
-{
-  Datum datum_one = Int32GetDatum(1);
-  TInstant *instants[2];
-  TimestampTz t = s->lower;
-  instants[0] = tinstant_make(datum_one, T_TINT, t);
-  TSequence *result;
-  if (s->lower == s->upper)
-  {
-    result = tsequence_make(instants, 1, s->lower_inc, s->upper_inc, STEP,
-      NORMALIZE_NO);
-  }
-  else
-  {
-    t = s->upper;
-    instants[1] = tinstant_make(datum_one, T_TINT, t);
-    result = tsequence_make(instants, 2, s->lower_inc, s->upper_inc, STEP,
-      NORMALIZE_NO);
-    pfree(instants[1]);
-  }
-  pfree(instants[0]);
-  return result;
-}
-
-/**
- * @brief Transform a timestamptz span set value into a temporal integer value
- * for performing temporal count aggregation
- */
-static TSequence **
-tstzspanset_transform_tcount(const SpanSet *ss)
-{
-  TSequence **result = palloc(sizeof(TSequence *) * ss->count);
-  for (int i = 0; i < ss->count; i++)
-    result[i] = tstzspan_transform_tcount(SPANSET_SP_N(ss, i));
-  return result;
-}
-
-/*****************************************************************************/
-
 /**
  * @brief Transform a temporal instant value into a temporal integer value for
  * performing temporal count aggregation
@@ -1267,17 +1898,11 @@ temporal_transform_tcount(const Temporal *temp, int *count)
 SkipList *
 timestamptz_tcount_transfn(SkipList *state, TimestampTz t)
 {
-  TInstant **instants = timestamp_transform_tcount(t);
   if (! state)
     state = temporal_skiplist_make();
-  else
-  {
-    if (! ensure_same_skiplist_subtype(state, TINSTANT))
-      return NULL;
-  }
-  temporal_skiplist_splice(state, (void **) instants, 1, &datum_sum_int32,
-    CROSSINGS_NO);
-  pfree_array((void **) instants, 1);
+  if (! tcount_events_reserve(state, 1, TINSTANT))
+    return NULL;
+  tcount_event_add(state, t, TCOUNT_INST);
   return state;
 }
 
@@ -1298,17 +1923,13 @@ tstzset_tcount_transfn(SkipList *state, const Set *s)
   if (! ensure_set_isof_type(s, T_TSTZSET))
     return NULL;
 
-  TInstant **instants = tstzset_transform_tcount(s);
   if (! state)
     state = temporal_skiplist_make();
-  else
-  {
-    if (! ensure_same_skiplist_subtype(state, TINSTANT))
-      return NULL;
-  }
-  temporal_skiplist_splice(state, (void **) instants, s->count, &datum_sum_int32,
-    CROSSINGS_NO);
-  pfree_array((void **) instants, s->count);
+  if (! tcount_events_reserve(state, s->count, TINSTANT))
+    return NULL;
+  for (int i = 0; i < s->count; i++)
+    tcount_event_add(state, DatumGetTimestampTz(SET_VAL_N(s, i)),
+      TCOUNT_INST);
   return state;
 }
 
@@ -1329,17 +1950,12 @@ tstzspan_tcount_transfn(SkipList *state, const Span *s)
   if (! ensure_span_isof_type(s, T_TSTZSPAN))
     return NULL;
 
-  TSequence *seq = tstzspan_transform_tcount(s);
   if (! state)
     state = temporal_skiplist_make();
-  else
-  {
-    if (! ensure_same_skiplist_subtype(state, TSEQUENCE))
-      return NULL;
-  }
-  temporal_skiplist_splice(state, (void **) &seq, 1, &datum_sum_int32,
-    CROSSINGS_NO);
-  pfree(seq);
+  if (! tcount_events_reserve(state, 2, TSEQUENCE))
+    return NULL;
+  tcount_span_add(state, DatumGetTimestampTz(s->lower),
+    DatumGetTimestampTz(s->upper), s->lower_inc, s->upper_inc);
   return state;
 }
 
@@ -1361,20 +1977,16 @@ tstzspanset_tcount_transfn(SkipList *state, const SpanSet *ss)
   if (! ensure_spanset_isof_type(ss, T_TSTZSPANSET))
     return NULL;
 
-  TSequence **sequences = tstzspanset_transform_tcount(ss);
   if (! state)
     state = temporal_skiplist_make();
-  else
-  {
-    if (! ensure_same_skiplist_subtype(state, TSEQUENCE))
-      return NULL;
-  }
+  if (! tcount_events_reserve(state, ss->count * 2, TSEQUENCE))
+    return NULL;
   for (int i = 0; i < ss->count; i++)
   {
-    temporal_skiplist_splice(state, (void **) &sequences[i], 1,
-      &datum_sum_int32, CROSSINGS_NO);
+    const Span *s = SPANSET_SP_N(ss, i);
+    tcount_span_add(state, DatumGetTimestampTz(s->lower),
+      DatumGetTimestampTz(s->upper), s->lower_inc, s->upper_inc);
   }
-  pfree_array((void **) sequences, ss->count);
   return state;
 }
 
@@ -1393,14 +2005,52 @@ temporal_tcount_transfn(SkipList *state, const Temporal *temp)
   /* Null temporal: return state */
   if (! temp)
     return state;
-  int count;
-  Temporal **temparr = temporal_transform_tcount(temp, &count);
   /* Null state: create a new state */
   if (! state)
     state = temporal_skiplist_make();
-  temporal_skiplist_splice(state, (void **) temparr, count, &datum_sum_int32,
-    false);
-  pfree_array((void **) temparr, count);
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+    {
+      if (! tcount_events_reserve(state, 1, TINSTANT))
+        return NULL;
+      tcount_event_add(state, ((TInstant *) temp)->t, TCOUNT_INST);
+      break;
+    }
+    case TSEQUENCE:
+    {
+      const TSequence *seq = (const TSequence *) temp;
+      if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+      {
+        if (! tcount_events_reserve(state, seq->count, TINSTANT))
+          return NULL;
+        for (int i = 0; i < seq->count; i++)
+          tcount_event_add(state, TSEQUENCE_INST_N(seq, i)->t, TCOUNT_INST);
+      }
+      else
+      {
+        if (! tcount_events_reserve(state, 2, TSEQUENCE))
+          return NULL;
+        tcount_span_add(state, DatumGetTimestampTz(seq->period.lower),
+          DatumGetTimestampTz(seq->period.upper), seq->period.lower_inc,
+          seq->period.upper_inc);
+      }
+      break;
+    }
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      if (! tcount_events_reserve(state, ss->count * 2, TSEQUENCE))
+        return NULL;
+      for (int i = 0; i < ss->count; i++)
+      {
+        const Span *p = &TSEQUENCESET_SEQ_N(ss, i)->period;
+        tcount_span_add(state, DatumGetTimestampTz(p->lower),
+          DatumGetTimestampTz(p->upper), p->lower_inc, p->upper_inc);
+      }
+    }
+  }
   return state;
 }
 
@@ -1475,7 +2125,7 @@ tsequence_tavg_finalfn(TSequence **sequences, int count)
 Temporal *
 tnumber_tavg_finalfn(SkipList *state)
 {
-  if (! state || state->length == 0)
+  if (! state || ! temporal_tagg_merge_runs(state) || state->length == 0)
     return NULL;
 
   Temporal **values = (Temporal **) skiplist_values(state);
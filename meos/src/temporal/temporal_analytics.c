@@ -44,6 +44,7 @@
 #include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/float.h>
 #include <utils/timestamp.h>
 /* PostGIS */
 #include <liblwgeom_internal.h>
@@ -60,6 +61,7 @@
 #include "temporal/tinyekf_meos.h"
 #include "geo/tgeo_distance.h"
 #include "geo/tgeo_spatialfuncs.h"
+#include "geo/tpoint_coords.h"
 #if CBUFFER
   #include <meos_cbuffer.h>
 #endif
@@ -1293,98 +1295,6 @@ tinstant_distance(const TInstant *inst1, const TInstant *inst2,
   }
 }
 
-/**
- * @brief Linear space computation of the similarity distance between two
- * temporal values
- * @param[in] instants1,instants2 Arrays of temporal instants
- * @param[in] count1,count2 Number of instants in the arrays
- * @param[in] simfunc Similarity function, i.e., Frechet or DTW
- * @param[out] dist Array keeping the distances
- * @note Only two rows of the full matrix are used
- */
-static double
-tinstarr_similarity1(double *dist, TInstant **instants1, int count1,
-  TInstant **instants2, int count2, SimFunc simfunc)
-{
-  datum_func2 func = pt_distance_fn(instants1[0]->flags);
-  for (int i = 0; i < count1; i++)
-  {
-    for (int j = 0; j < count2; j++)
-    {
-      const TInstant *inst1 = instants1[i];
-      const TInstant *inst2 = instants2[j];
-      double d = tinstant_distance(inst1, inst2, func);
-      if (i > 0 && j > 0)
-      {
-        if (simfunc == FRECHET)
-        {
-          dist[i%2 * count2 + j] = Max(d,
-            Min(dist[(i - 1)%2 * count2 + j - 1],
-              Min(dist[(i - 1)%2 * count2 + j], dist[i%2 * count2 + j - 1])));
-        }
-        else /* simfunc == DYNTIMEWARP */
-        {
-          dist[i%2 * count2 + j] = d +
-            Min(dist[(i - 1)%2 * count2 + j - 1],
-              Min(dist[(i - 1)%2 * count2 + j], dist[i%2 * count2 + j - 1]));
-        }
-      }
-      else if (i > 0 && j == 0)
-      {
-        if (simfunc == FRECHET)
-        {
-          dist[i%2 * count2] = Max(d, dist[(i - 1)%2 * count2]);
-        }
-        else /* simfunc == DYNTIMEWARP */
-        {
-          dist[i%2 * count2] = d + dist[(i - 1)%2 * count2];
-        }
-      }
-      else if (i == 0 && j > 0)
-      {
-        if (simfunc == FRECHET)
-        {
-          dist[j] = Max(d, dist[j - 1]);
-        }
-        else /* simfunc == DYNTIMEWARP */
-        {
-          dist[j] = d + dist[j - 1];
-        }
-      }
-      else /* i == 0 && j == 0 */
-      {
-        dist[0] = d;
-      }
-    }
-  }
-  return dist[(count1 - 1)%2 * count2 + count2 - 1];
-}
-
-/**
- * @brief Linear space computation of the similarity distance between two
- * temporal values
- * @param[in] instants1,instants2 Arrays of temporal instants
- * @param[in] count1,count2 Number of instants in the arrays
- * @param[in] simfunc Similarity function, i.e., Frechet or DTW
- * @note Only two rows of the full matrix are used
- */
-static double
-tinstarr_similarity(TInstant **instants1, int count1, TInstant **instants2,
-  int count2, SimFunc simfunc)
-{
-  /* Allocate memory for two rows of the distance matrix */
-  double *dist = palloc(sizeof(double) * 2 * count2);
-  /* Initialise it with -1.0 */
-  for (int i = 0; i < 2 * count2; i++)
-    *(dist + i) = -1.0;
-  /* Call the linear_space computation of the similarity distance */
-  double result = tinstarr_similarity1(dist, instants1, count1, instants2,
-    count2, simfunc);
-  /* Free memory */
-  pfree(dist);
-  return result;
-}
-
 /**
  * @brief Return the similarity distance between two temporal values
  * @param[in] temp1,temp2 Temporal values
@@ -1396,15 +1306,11 @@ temporal_similarity(const Temporal *temp1, const Temporal *temp2,
 {
   assert(temp1); assert(temp2);
   assert(temp1->temptype == temp2->temptype);
-  double result;
   int count1, count2;
   const TInstant **instants1 = temporal_insts_p(temp1, &count1);
   const TInstant **instants2 = temporal_insts_p(temp2, &count2);
-  result = count1 > count2 ?
-    tinstarr_similarity((TInstant **) instants1, count1,
-      (TInstant **) instants2, count2, simfunc) :
-    tinstarr_similarity((TInstant **) instants2, count2,
-      (TInstant **) instants1, count1, simfunc);
+  double result = tinstarr_similarity(instants1, count1, instants2, count2,
+    simfunc, 0.0, -1, get_float8_infinity());
   /* Free memory */
   pfree(instants1); pfree(instants2);
   return result;
@@ -2210,6 +2116,181 @@ tpointseq_findsplit(const TSequence *seq, int i1, int i2, bool syncdist,
   return;
 }
 
+/**
+ * @brief Find a split when simplifying the temporal point sequence using the
+ * Douglas-Peucker line simplification algorithm with the spatial only
+ * distance, computing the squared distances with #tpoint_coords_segdist2
+ * @details The squared distances only select the candidate instants, whose
+ * squared distance is within a few units in the last place of the maximum
+ * one. The distance of the candidates is then computed with #dist2d_pt_seg
+ * or #dist3d_pt_seg so that the split and the distance are those of
+ * #tpointcoords_findsplit.
+ * @param[in] coords Packed coordinates of the temporal sequence
+ * @param[in] i1,i2 Indexes of the reference instants
+ * @param[out] split Location of the split
+ * @param[out] dist Distance at the split
+ * @pre There is at least one instant between @p i1 and @p i2
+ */
+static void
+tpointcoords_findsplit_segdist(const TPointCoords *coords, int i1, int i2,
+  int *split, double *dist)
+{
+  const double *x = coords->x, *y = coords->y, *z = coords->z;
+  POINT3DZ p3a = { x[i1], y[i1], z ? z[i1] : 0.0 };
+  POINT3DZ p3b = { x[i2], y[i2], z ? z[i2] : 0.0 };
+  POINT2D p2a = { x[i1], y[i1] }, p2b = { x[i2], y[i2] };
+  double a[3] = { p3a.x, p3a.y, p3a.z }, b[3] = { p3b.x, p3b.y, p3b.z };
+  /* The segment is reduced to a point as in dist2d_pt_seg/dist3d_pt_seg */
+  bool point = z ?
+    (FP_EQUALS(a[0], b[0]) && FP_EQUALS(a[1], b[1]) &&
+      FP_EQUALS(a[2], b[2])) :
+    (a[0] == b[0] && a[1] == b[1]);
+  int count = i2 - i1 - 1;
+  double *dist2 = palloc(sizeof(double) * count);
+  tpoint_coords_segdist2(x + i1 + 1, y + i1 + 1, z ? z + i1 + 1 : NULL,
+    count, a, point ? NULL : b, dist2);
+
+  /* Bound of the squared distances of the candidates. Below the bound the
+   * distances are smaller than the maximum one whatever the rounding errors,
+   * unless the squares lost precision by being close to underflow. */
+  double max = dist2[0];
+  for (int i = 1; i < count; i++)
+  {
+    if (dist2[i] > max)
+      max = dist2[i];
+  }
+  double bound = (max < DBL_MIN / DBL_EPSILON) ? 0.0 :
+    max * (1.0 - 64 * DBL_EPSILON);
+
+  double d = -1;
+  *split = i1;
+  for (int i = 0; i < count; i++)
+  {
+    if (dist2[i] < bound)
+      continue;
+    int idx = i1 + 1 + i;
+    double d_tmp;
+    if (z)
+    {
+      POINT3DZ p3k = { x[idx], y[idx], z[idx] };
+      d_tmp = dist3d_pt_seg(&p3k, &p3a, &p3b);
+    }
+    else
+    {
+      POINT2D p2k = { x[idx], y[idx] };
+      d_tmp = dist2d_pt_seg(&p2k, &p2a, &p2b);
+    }
+    if (d_tmp > d)
+    {
+      /* record the maximum */
+      d = d_tmp;
+      *split = idx;
+    }
+  }
+  pfree(dist2);
+  *dist = d;
+  return;
+}
+
+/**
+ * @brief Find a split when simplifying the temporal point sequence using the
+ * Douglas-Peucker line simplification algorithm, reading the coordinates from
+ * packed arrays
+ * @details The result is the same as the one of #tpointseq_findsplit. In
+ * particular, the synchronized point is interpolated as in
+ * #pointsegm_interpolate for planar points.
+ * @param[in] coords Packed coordinates of the temporal sequence
+ * @param[in] i1,i2 Indexes of the reference instants
+ * @param[in] syncdist True when using the Synchronized Euclidean Distance
+ * @param[out] split Location of the split
+ * @param[out] dist Distance at the split
+ * @pre The points are planar when @p syncdist is true
+ */
+static void
+tpointcoords_findsplit(const TPointCoords *coords, int i1, int i2,
+  bool syncdist, int *split, double *dist)
+{
+  const double *x = coords->x, *y = coords->y, *z = coords->z;
+  double d = -1;
+  *split = i1;
+  *dist = -1;
+  if (i1 + 1 >= i2)
+    return;
+
+  /* The spatial only distances of many instants are computed at once */
+  if (! syncdist && i2 - i1 - 1 >= TPOINT_COORDS_SIMD_MIN)
+  {
+    tpointcoords_findsplit_segdist(coords, i1, i2, split, dist);
+    return;
+  }
+
+  /* Initialization of values wrt instants i1 and i2 */
+  TimestampTz lower = coords->t[i1], upper = coords->t[i2];
+  long double duration = (long double) (upper - lower);
+  POINT3DZ p3a = { x[i1], y[i1], z ? z[i1] : 0.0 };
+  POINT3DZ p3b = { x[i2], y[i2], z ? z[i2] : 0.0 };
+  POINT2D p2a = { x[i1], y[i1] }, p2b = { x[i2], y[i2] };
+
+  /* Loop for every instant between i1 and i2 */
+  for (int idx = i1 + 1; idx < i2; idx++)
+  {
+    double d_tmp;
+    long double ratio = 0.0;
+    if (syncdist)
+      ratio = (long double) (coords->t[idx] - lower) / duration;
+    if (z)
+    {
+      POINT3DZ p3k = { x[idx], y[idx], z[idx] };
+      if (syncdist)
+      {
+        POINT3DZ p3_sync;
+        p3_sync.x = p3a.x + (double) ((long double) (p3b.x - p3a.x) * ratio);
+        p3_sync.y = p3a.y + (double) ((long double) (p3b.y - p3a.y) * ratio);
+        p3_sync.z = p3a.z + (double) ((long double) (p3b.z - p3a.z) * ratio);
+        d_tmp = dist3d_pt_pt(&p3k, &p3_sync);
+      }
+      else
+        d_tmp = dist3d_pt_seg(&p3k, &p3a, &p3b);
+    }
+    else
+    {
+      POINT2D p2k = { x[idx], y[idx] };
+      if (syncdist)
+      {
+        POINT2D p2_sync;
+        p2_sync.x = p2a.x + (double) ((long double) (p2b.x - p2a.x) * ratio);
+        p2_sync.y = p2a.y + (double) ((long double) (p2b.y - p2a.y) * ratio);
+        d_tmp = dist2d_pt_pt(&p2k, &p2_sync);
+      }
+      else
+        d_tmp = dist2d_pt_seg(&p2k, &p2a, &p2b);
+    }
+    if (d_tmp > d)
+    {
+      /* record the maximum */
+      d = d_tmp;
+      *split = idx;
+    }
+  }
+  *dist = d;
+  return;
+}
+
+/**
+ * @brief Return the packed coordinates of a temporal point sequence used for
+ * finding the splits in the Douglas-Peucker line simplification algorithm,
+ * or @p NULL for temporal floats and for geodetic points when the
+ * Synchronized Euclidean Distance is used
+ */
+static TPointCoords *
+tsequence_simplify_coords(const TSequence *seq, bool syncdist)
+{
+  if (! tpoint_type(seq->temptype) ||
+      (syncdist && MEOS_FLAGS_GET_GEODETIC(seq->flags)))
+    return NULL;
+  return tpointseq_coords(seq);
+}
+
 /*****************************************************************************/
 
 /**
@@ -2233,6 +2314,8 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
            ninsts = 0;  /* Number of instants in the result */
   int split;            /* Index of the split */
   double d;             /* Distance */
+  /* The coordinates are read once since the splits are searched repeatedly */
+  TPointCoords *coords = tsequence_simplify_coords(seq, syncdist);
   for (int i = 0; i < seq->count; i++)
   {
     cur = TSEQUENCE_INST_N(seq, i);
@@ -2245,6 +2328,8 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
     /* For temporal floats only Synchronized Distance is used */
     if (seq->temptype == T_TFLOAT)
       tfloatseq_findsplit(seq, start, i, &split, &d);
+    else if (coords)
+      tpointcoords_findsplit(coords, start, i, syncdist, &split, &d);
     else /* tpoint_type(seq->temptype) */
       tpointseq_findsplit(seq, start, i, syncdist, &split, &d);
     bool dosplit = (d >= 0 && (d > dist || start + i + 1 < minpts));
@@ -2262,6 +2347,8 @@ tsequence_simplify_max_dist(const TSequence *seq, double dist, bool syncdist,
     (ninsts == 1) ? true : seq->period.lower_inc,
     (ninsts == 1) ? true : seq->period.upper_inc, LINEAR, NORMALIZE);
   pfree(instants);
+  if (coords)
+    pfree(coords);
   return result;
 }
 
@@ -2376,6 +2463,9 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     outlist = outlist_static;
   }
 
+  /* The coordinates are read once since the splits are searched repeatedly */
+  TPointCoords *coords = tsequence_simplify_coords(seq, syncdist);
+
   i1 = 0;
   stack[++sp] = seq->count - 1;
   /* Add first point to output list */
@@ -2385,6 +2475,8 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     /* For temporal floats only Synchronized Distance is used */
     if (seq->temptype == T_TFLOAT)
       tfloatseq_findsplit(seq, i1, stack[sp], &split, &d);
+    else if (coords)
+      tpointcoords_findsplit(coords, i1, stack[sp], syncdist, &split, &d);
     else /* tpoint_type(seq->temptype) */
       tpointseq_findsplit(seq, i1, stack[sp], syncdist, &split, &d);
     bool dosplit = (d >= 0 && (d > dist || outn + sp + 1 < minpts));
@@ -2408,6 +2500,8 @@ tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
     seq->period.upper_inc, LINEAR, NORMALIZE);
   pfree(instants);
 
+  if (coords)
+    pfree(coords);
   /* Free memory only if arrays are on the heap */
   if (stack != stack_static)
     pfree(stack);
@@ -2479,53 +2573,6 @@ temporal_simplify_dp(const Temporal *temp, double dist, bool syncdist)
  * Average Hausdorff distance
  *****************************************************************************/
 
-/**
- * @brief Return the average Hausdorff distance between two arrays of temporal
- * instants
- * @details The average Hausdorff distance averages, over both directions, the
- * mean distance from each instant of one array to its nearest instant in the
- * other array.
- * @param[in] instants1,instants2 Arrays of temporal instants
- * @param[in] count1,count2 Number of instants in the arrays
- */
-static double
-tinstarr_average_hausdorff_distance(const TInstant **instants1, int count1,
-  const TInstant **instants2, int count2)
-{
-  datum_func2 func = pt_distance_fn(instants1[0]->flags);
-  const TInstant *inst1, *inst2;
-  double sum1 = 0.0, sum2 = 0.0;
-  double cmin, d;
-  int i, j;
-  for (i = 0; i < count1; i++)
-  {
-    inst1 = instants1[i];
-    cmin = DBL_MAX;
-    for (j = 0; j < count2; j++)
-    {
-      inst2 = instants2[j];
-      d = tinstant_distance(inst1, inst2, func);
-      if (d < cmin)
-        cmin = d;
-    }
-    sum1 += cmin;
-  }
-  for (j = 0; j < count2; j++)
-  {
-    inst2 = instants2[j];
-    cmin = DBL_MAX;
-    for (i = 0; i < count1; i++)
-    {
-      inst1 = instants1[i];
-      d = tinstant_distance(inst1, inst2, func);
-      if (d < cmin)
-        cmin = d;
-    }
-    sum2 += cmin;
-  }
-  return 0.5 * ((sum1 / (double) count1) + (sum2 / (double) count2));
-}
-
 /**
  * @ingroup meos_temporal_analytics_similarity
  * @brief Return the average Hausdorff distance between two temporal values
@@ -2544,8 +2591,8 @@ temporal_average_hausdorff_distance(const Temporal *temp1,
   int count1, count2;
   const TInstant **instants1 = temporal_insts_p(temp1, &count1);
   const TInstant **instants2 = temporal_insts_p(temp2, &count2);
-  double result = tinstarr_average_hausdorff_distance(instants1, count1,
-    instants2, count2);
+  double result = tinstarr_average_hausdorff(instants1, count1, instants2,
+    count2);
   /* Free memory */
   pfree(instants1); pfree(instants2);
   return result;
@@ -2555,42 +2602,6 @@ temporal_average_hausdorff_distance(const Temporal *temp1,
  * Longest Common SubSequence (LCSS) distance
  *****************************************************************************/
 
-/**
- * @brief Return the Longest Common SubSequence (LCSS) distance between two
- * arrays of temporal instants
- * @details Two instants match when the distance between them is at most
- * @p epsilon. The result is the length of the longest common subsequence,
- * computed with a rolling two-row dynamic programming table.
- * @param[in] instants1,instants2 Arrays of temporal instants
- * @param[in] count1,count2 Number of instants in the arrays
- * @param[in] epsilon Maximum distance for two instants to match
- */
-static double
-tinstarr_lcss_distance(const TInstant **instants1, int count1,
-  const TInstant **instants2, int count2, double epsilon)
-{
-  datum_func2 func = pt_distance_fn(instants1[0]->flags);
-  int *prev = palloc0(sizeof(int) * (count2 + 1));
-  int *curr = palloc0(sizeof(int) * (count2 + 1));
-  for (int i = 1; i <= count1; i++)
-  {
-    for (int j = 1; j <= count2; j++)
-    {
-      double d = tinstant_distance(instants1[i - 1], instants2[j - 1], func);
-      if (d <= epsilon)
-        curr[j] = prev[j - 1] + 1;
-      else
-        curr[j] = Max(prev[j], curr[j - 1]);
-    }
-    int *tmp = prev;
-    prev = curr;
-    curr = tmp;
-  }
-  double result = prev[count2];
-  pfree(prev); pfree(curr);
-  return result;
-}
-
 /**
  * @ingroup meos_temporal_analytics_similarity
  * @brief Return the Longest Common SubSequence (LCSS) distance between two
@@ -2611,9 +2622,8 @@ temporal_lcss_distance(const Temporal *temp1, const Temporal *temp2,
   int count1, count2;
   const TInstant **instants1 = temporal_insts_p(temp1, &count1);
   const TInstant **instants2 = temporal_insts_p(temp2, &count2);
-  double result = count1 > count2 ?
-    tinstarr_lcss_distance(instants1, count1, instants2, count2, epsilon) :
-    tinstarr_lcss_distance(instants2, count2, instants1, count1, epsilon);
+  double result = tinstarr_similarity(instants1, count1, instants2, count2,
+    LCSS, epsilon, -1, get_float8_infinity());
   /* Free memory */
   pfree(instants1); pfree(instants2);
   return result;
@@ -0,0 +1,932 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Exchange of temporal values in the columnar layout of the Apache
+ * Arrow C Data Interface
+ * @details A batch of temporal instants or sequences is exported as one
+ * Arrow column of type `list<struct<t, ...>>` with one list of instants per
+ * value, as described in file meos_arrow.h. The column is made of one buffer
+ * of list offsets and one buffer per field of the instants, such as the
+ * timestamps and the x and y coordinates of temporal points, which are
+ * filled in a single pass over the instants. Since MEOS stores the instants
+ * of a sequence row by row and counts the timestamps from 2000-01-01 while
+ * Arrow counts them from 1970-01-01, the buffers cannot share the memory of
+ * the temporal values and are copied once, without serializing each value.
+ *
+ * The interpolation of the values, the temporal type, and the SRID of
+ * temporal points are kept in the metadata of the column under the keys
+ * `meos.interp`, `meos.type`, and `meos.srid`. A column produced by another
+ * implementation without these keys is read with linear interpolation for
+ * floats and points and step interpolation otherwise. The bounds of the
+ * sequences are not part of the layout, so only sequences with inclusive
+ * bounds are exported and the sequences are read with inclusive bounds.
+ */
+
+/* C */
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <varatt.h>
+#include <common/int.h>
+#include <utils/datetime.h>
+#include <utils/timestamp.h>
+#include <utils/varlena.h>
+/* PostGIS */
+#include <liblwgeom.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_arrow.h>
+#include <meos_geo.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "temporal/temporal.h"
+#include "temporal/tsequence.h"
+#include "temporal/type_util.h"
+#include "geo/geo_funcs.h"
+
+/* Offset between the epoch of MEOS timestamps, 2000-01-01, and the epoch of
+ * Arrow timestamps, 1970-01-01, in microseconds */
+#define ARROW_EPOCH_OFFSET \
+  ((int64) (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * USECS_PER_DAY)
+/* Maximum number of fields of an instant: t, x, y, and z */
+#define ARROW_MAX_FIELDS 4
+/* Maximum number of buffers of an array: validity, offsets, and data */
+#define ARROW_MAX_BUFFERS 3
+/* Maximum length of the values of the metadata read */
+#define ARROW_MAX_METADATA 64
+
+/**
+ * @brief Private data of an exported array, which owns its buffers and the
+ * structures of its children
+ */
+typedef struct
+{
+  const void *buffers[ARROW_MAX_BUFFERS];
+  struct ArrowArray *childptrs[ARROW_MAX_FIELDS];
+  struct ArrowArray children[ARROW_MAX_FIELDS];
+} ArrowArrayData;
+
+/**
+ * @brief Private data of an exported schema, which owns its metadata and the
+ * structures of its children
+ */
+typedef struct
+{
+  char *metadata;
+  struct ArrowSchema *childptrs[ARROW_MAX_FIELDS];
+  struct ArrowSchema children[ARROW_MAX_FIELDS];
+} ArrowSchemaData;
+
+/*****************************************************************************
+ * Structures of the Arrow C Data Interface
+ *****************************************************************************/
+
+/**
+ * @brief Release an exported array, its buffers, and its children
+ */
+static void
+arrow_array_release(struct ArrowArray *array)
+{
+  ArrowArrayData *data = array->private_data;
+  /* A child moved by the consumer has no release callback */
+  for (int i = 0; i < array->n_children; i++)
+  {
+    if (array->children[i]->release)
+      array->children[i]->release(array->children[i]);
+  }
+  for (int i = 0; i < array->n_buffers; i++)
+  {
+    if (data->buffers[i])
+      pfree((void *) data->buffers[i]);
+  }
+  pfree(data);
+  array->release = NULL;
+  return;
+}
+
+/**
+ * @brief Initialize an exported array without nulls
+ * @return Private data of the array, whose buffers are set by the caller
+ */
+static ArrowArrayData *
+arrow_array_init(struct ArrowArray *array, int64 length, int nbuffers,
+  int nchildren)
+{
+  assert(nbuffers <= ARROW_MAX_BUFFERS); assert(nchildren <= ARROW_MAX_FIELDS);
+  ArrowArrayData *data = palloc0(sizeof(ArrowArrayData));
+  for (int i = 0; i < nchildren; i++)
+    data->childptrs[i] = &data->children[i];
+  memset(array, 0, sizeof(struct ArrowArray));
+  array->length = length;
+  array->n_buffers = nbuffers;
+  array->n_children = nchildren;
+  array->buffers = data->buffers;
+  array->children = nchildren ? data->childptrs : NULL;
+  array->release = &arrow_array_release;
+  array->private_data = data;
+  return data;
+}
+
+/**
+ * @brief Initialize an exported array of fixed-size values without nulls
+ */
+static void
+arrow_array_values(struct ArrowArray *array, int64 length, void *values)
+{
+  ArrowArrayData *data = arrow_array_init(array, length, 2, 0);
+  data->buffers[1] = values;
+  return;
+}
+
+/**
+ * @brief Release an exported schema, its metadata, and its children
+ */
+static void
+arrow_schema_release(struct ArrowSchema *schema)
+{
+  ArrowSchemaData *data = schema->private_data;
+  for (int i = 0; i < schema->n_children; i++)
+  {
+    if (schema->children[i]->release)
+      schema->children[i]->release(schema->children[i]);
+  }
+  if (data->metadata)
+    pfree(data->metadata);
+  pfree(data);
+  schema->release = NULL;
+  return;
+}
+
+/**
+ * @brief Initialize an exported schema
+ * @return Private data of the schema
+ */
+static ArrowSchemaData *
+arrow_schema_init(struct ArrowSchema *schema, const char *format,
+  const char *name, int64 flags, int nchildren)
+{
+  assert(nchildren <= ARROW_MAX_FIELDS);
+  ArrowSchemaData *data = palloc0(sizeof(ArrowSchemaData));
+  for (int i = 0; i < nchildren; i++)
+    data->childptrs[i] = &data->children[i];
+  memset(schema, 0, sizeof(struct ArrowSchema));
+  schema->format = format;
+  schema->name = name;
+  schema->flags = flags;
+  schema->n_children = nchildren;
+  schema->children = nchildren ? data->childptrs : NULL;
+  schema->release = &arrow_schema_release;
+  schema->private_data = data;
+  return data;
+}
+
+/**
+ * @brief Return the metadata of a schema encoded as specified by the C Data
+ * Interface, that is, the number of pairs followed by the length and the
+ * bytes of each key and value, the lengths being native 32-bit integers
+ */
+static char *
+arrow_metadata_make(const char **keys, const char **values, int count)
+{
+  size_t size = sizeof(int32);
+  for (int i = 0; i < count; i++)
+    size += 2 * sizeof(int32) + strlen(keys[i]) + strlen(values[i]);
+  char *result = palloc(size);
+  char *ptr = result;
+  int32 n = count;
+  memcpy(ptr, &n, sizeof(int32));
+  ptr += sizeof(int32);
+  for (int i = 0; i < count; i++)
+  {
+    const char *strs[2] = { keys[i], values[i] };
+    for (int j = 0; j < 2; j++)
+    {
+      int32 len = (int32) strlen(strs[j]);
+      memcpy(ptr, &len, sizeof(int32));
+      memcpy(ptr + sizeof(int32), strs[j], len);
+      ptr += sizeof(int32) + len;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Copy into a buffer the value of a key of the metadata of a schema
+ * @return False when the key is not found
+ */
+static bool
+arrow_metadata_get(const char *metadata, const char *key, char *value)
+{
+  if (! metadata)
+    return false;
+  int32 count, len;
+  const char *ptr = metadata;
+  memcpy(&count, ptr, sizeof(int32));
+  ptr += sizeof(int32);
+  size_t keylen = strlen(key);
+  for (int i = 0; i < count; i++)
+  {
+    memcpy(&len, ptr, sizeof(int32));
+    bool found = ((size_t) len == keylen &&
+      strncmp(ptr + sizeof(int32), key, keylen) == 0);
+    ptr += sizeof(int32) + len;
+    memcpy(&len, ptr, sizeof(int32));
+    if (found)
+    {
+      len = Min(len, ARROW_MAX_METADATA - 1);
+      memcpy(value, ptr + sizeof(int32), len);
+      value[len] = '\0';
+      return true;
+    }
+    ptr += sizeof(int32) + len;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * Export
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the temporal type can be exchanged in the Arrow
+ * layout
+ */
+static bool
+ensure_arrow_temptype(MeosType temptype)
+{
+  if (temptype != T_TBOOL && temptype != T_TINT && temptype != T_TBIGINT &&
+      temptype != T_TFLOAT && temptype != T_TTEXT &&
+      temptype != T_TGEOMPOINT && temptype != T_TGEOGPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_FEATURE_NOT_SUPPORTED,
+      "Temporal type not supported in the Arrow layout: %s",
+      meostype_name(temptype));
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return the n-th instant of a temporal instant or sequence
+ */
+static inline const TInstant *
+temporal_arrow_inst_n(const Temporal *temp, int n)
+{
+  return (temp->subtype == TINSTANT) ? (const TInstant *) temp :
+    TSEQUENCE_INST_N((const TSequence *) temp, n);
+}
+
+/**
+ * @brief Return the Arrow format of the field `v` of a temporal type
+ */
+static const char *
+arrow_value_format(MeosType temptype)
+{
+  switch (temptype)
+  {
+    case T_TBOOL:
+      return "b";
+    case T_TINT:
+      return "i";
+    case T_TBIGINT:
+      return "l";
+    case T_TFLOAT:
+      return "g";
+    default: /* T_TTEXT */
+      return "u";
+  }
+}
+
+/**
+ * @brief Fill the array of the field `v` of the instants of the values
+ */
+static void
+arrow_export_values(Temporal **temparr, int count, MeosType temptype,
+  int64 ninsts, size_t nbytes, struct ArrowArray *array)
+{
+  if (temptype == T_TTEXT)
+  {
+    int32 *offsets = palloc(sizeof(int32) * (ninsts + 1));
+    char *bytes = palloc(Max(nbytes, 1));
+    int64 k = 0;
+    int32 pos = 0;
+    for (int i = 0; i < count; i++)
+    {
+      const Temporal *temp = temparr[i];
+      if (! temp)
+        continue;
+      int n = temporal_num_instants(temp);
+      for (int j = 0; j < n; j++)
+      {
+        const text *txt = DatumGetTextP(
+          tinstant_value_p(temporal_arrow_inst_n(temp, j)));
+        int32 len = (int32) VARSIZE_ANY_EXHDR(txt);
+        offsets[k++] = pos;
+        memcpy(bytes + pos, VARDATA_ANY(txt), len);
+        pos += len;
+      }
+    }
+    offsets[k] = pos;
+    ArrowArrayData *data = arrow_array_init(array, ninsts, 3, 0);
+    data->buffers[1] = offsets;
+    data->buffers[2] = bytes;
+    return;
+  }
+
+  void *values;
+  if (temptype == T_TBOOL)
+    values = palloc0(Max((ninsts + 7) / 8, 1));
+  else if (temptype == T_TINT)
+    values = palloc(sizeof(int32) * Max(ninsts, 1));
+  else
+    values = palloc(sizeof(int64) * Max(ninsts, 1));
+  int64 k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    if (! temp)
+      continue;
+    int n = temporal_num_instants(temp);
+    for (int j = 0; j < n; j++, k++)
+    {
+      Datum value = tinstant_value_p(temporal_arrow_inst_n(temp, j));
+      switch (temptype)
+      {
+        case T_TBOOL:
+          if (DatumGetBool(value))
+            ((uint8 *) values)[k / 8] |= (uint8) (1 << (k % 8));
+          break;
+        case T_TINT:
+          ((int32 *) values)[k] = DatumGetInt32(value);
+          break;
+        case T_TBIGINT:
+          ((int64 *) values)[k] = DatumGetInt64(value);
+          break;
+        default: /* T_TFLOAT */
+          ((double *) values)[k] = DatumGetFloat8(value);
+      }
+    }
+  }
+  arrow_array_values(array, ninsts, values);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Export an array of temporal values as an Arrow column
+ * @details The values must be temporal instants or sequences with inclusive
+ * bounds of the same type and interpolation, and temporal points must moreover have the same
+ * dimensionality and SRID. The `NULL` elements of the array are exported as
+ * null lists. The consumer of the column releases the schema and the array
+ * with their release callbacks.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[out] schema Schema of the column
+ * @param[out] array Data of the column
+ * @return On error return false
+ * @see #temparr_from_arrow()
+ */
+bool
+temparr_as_arrow(Temporal **temparr, int count, struct ArrowSchema *schema,
+  struct ArrowArray *array)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(schema, false);
+  VALIDATE_NOT_NULL(array, false);
+  if (! ensure_positive(count))
+    return false;
+
+  /* The first non-null value determines the type of the column */
+  const Temporal *first = NULL;
+  for (int i = 0; i < count && ! first; i++)
+    first = temparr[i];
+  if (! first)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The array must have at least one non-null temporal value");
+    return false;
+  }
+  MeosType temptype = first->temptype;
+  if (! ensure_arrow_temptype(temptype))
+    return false;
+  interpType interp = MEOS_FLAGS_GET_INTERP(first->flags);
+  bool point = tpoint_type(temptype);
+  bool hasz = MEOS_FLAGS_GET_Z(first->flags);
+  int32_t srid = point ? tspatial_srid(first) : 0;
+
+  /* Count the instants and the bytes of the texts */
+  int64 ninsts = 0, nulls = 0;
+  size_t nbytes = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    if (! temp)
+    {
+      nulls++;
+      continue;
+    }
+    if (temp->temptype != temptype || temp->subtype == TSEQUENCESET ||
+        MEOS_FLAGS_GET_INTERP(temp->flags) != interp ||
+        (point && (MEOS_FLAGS_GET_Z(temp->flags) != hasz ||
+          tspatial_srid(temp) != srid)))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The values of an Arrow column must be temporal instants or "
+        "sequences of the same type, interpolation, dimensionality, and SRID");
+      return false;
+    }
+    if (temp->subtype == TSEQUENCE &&
+        (! ((const TSequence *) temp)->period.lower_inc ||
+         ! ((const TSequence *) temp)->period.upper_inc))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The sequences of an Arrow column must have inclusive bounds");
+      return false;
+    }
+    int n = temporal_num_instants(temp);
+    ninsts += n;
+    if (temptype == T_TTEXT)
+    {
+      for (int j = 0; j < n; j++)
+        nbytes += VARSIZE_ANY_EXHDR(DatumGetTextP(
+          tinstant_value_p(temporal_arrow_inst_n(temp, j))));
+    }
+  }
+  if (ninsts > INT32_MAX || nbytes > INT32_MAX)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE,
+      "Too many instants for the 32-bit offsets of an Arrow column");
+    return false;
+  }
+
+  /* List offsets and validity, the bits of the valid lists are set */
+  int32 *offsets = palloc(sizeof(int32) * (count + 1));
+  uint8 *validity = nulls ? palloc0((count + 7) / 8) : NULL;
+  /* Timestamps and coordinates of the instants */
+  int64 *times = palloc(sizeof(int64) * Max(ninsts, 1));
+  double *coords[3] = { NULL, NULL, NULL };
+  int ncoords = point ? (hasz ? 3 : 2) : 0;
+  for (int c = 0; c < ncoords; c++)
+    coords[c] = palloc(sizeof(double) * Max(ninsts, 1));
+  int32 k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    offsets[i] = k;
+    if (! temp)
+      continue;
+    if (validity)
+      validity[i / 8] |= (uint8) (1 << (i % 8));
+    int n = temporal_num_instants(temp);
+    for (int j = 0; j < n; j++, k++)
+    {
+      const TInstant *inst = temporal_arrow_inst_n(temp, j);
+      if (pg_add_s64_overflow(inst->t, ARROW_EPOCH_OFFSET, &times[k]))
+      {
+        meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE,
+          "Timestamp out of the range of an Arrow timestamp");
+        pfree(offsets);
+        if (validity)
+          pfree(validity);
+        pfree(times);
+        for (int c = 0; c < ncoords; c++)
+          pfree(coords[c]);
+        return false;
+      }
+      if (point)
+      {
+        /* The coordinates are read in place from the serialized point */
+        const double *pt = (const double *) GS_POINT_PTR(
+          DatumGetGserializedP(tinstant_value_p(inst)));
+        for (int c = 0; c < ncoords; c++)
+          coords[c][k] = pt[c];
+      }
+    }
+  }
+  offsets[count] = k;
+
+  /* Arrays: list of struct of fields */
+  int nfields = 1 + (point ? ncoords : 1);
+  ArrowArrayData *data = arrow_array_init(array, count, 2, 1);
+  array->null_count = nulls;
+  data->buffers[0] = validity;
+  data->buffers[1] = offsets;
+  ArrowArrayData *structdata = arrow_array_init(&data->children[0], ninsts,
+    1, nfields);
+  arrow_array_values(&structdata->children[0], ninsts, times);
+  if (point)
+  {
+    for (int c = 0; c < ncoords; c++)
+      arrow_array_values(&structdata->children[1 + c], ninsts, coords[c]);
+  }
+  else
+    arrow_export_values(temparr, count, temptype, ninsts, nbytes,
+      &structdata->children[1]);
+
+  /* Schema with the type, the interpolation, and the SRID as metadata */
+  static const char *coordnames[] = { "x", "y", "z" };
+  char sridstr[16];
+  snprintf(sridstr, sizeof(sridstr), "%d", srid);
+  const char *keys[] = { "meos.type", "meos.interp", "meos.srid" };
+  const char *values[] = { meostype_name(temptype), interptype_name(interp),
+    sridstr };
+  ArrowSchemaData *sdata = arrow_schema_init(schema, "+l",
+    meostype_name(temptype), ARROW_FLAG_NULLABLE, 1);
+  sdata->metadata = arrow_metadata_make(keys, values, point ? 3 : 2);
+  schema->metadata = sdata->metadata;
+  ArrowSchemaData *structsdata = arrow_schema_init(&sdata->children[0], "+s",
+    "item", 0, nfields);
+  arrow_schema_init(&structsdata->children[0], "tsu:UTC", "t", 0, 0);
+  if (point)
+  {
+    for (int c = 0; c < ncoords; c++)
+      arrow_schema_init(&structsdata->children[1 + c], "g", coordnames[c], 0,
+        0);
+  }
+  else
+    arrow_schema_init(&structsdata->children[1], arrow_value_format(temptype),
+      "v", 0, 0);
+  return true;
+}
+
+/*****************************************************************************
+ * Import
+ *****************************************************************************/
+
+/**
+ * @brief Description of a field of the instants of an imported column
+ */
+typedef struct
+{
+  const struct ArrowArray *array;   /**< Array of the field */
+  const char *format;               /**< Arrow format of the field */
+  int64 offset;                     /**< Offset of the first element */
+} ArrowField;
+
+/**
+ * @brief Return true if the bit of a validity bitmap is set
+ */
+static inline bool
+arrow_bit(const void *bitmap, int64 i)
+{
+  return (((const uint8 *) bitmap)[i / 8] >> (i % 8)) & 1;
+}
+
+/**
+ * @brief Find a field of the struct of the instants of an imported column
+ */
+static bool
+arrow_field(const struct ArrowSchema *schema, const struct ArrowArray *array,
+  const char *name, ArrowField *field)
+{
+  for (int i = 0; i < schema->n_children; i++)
+  {
+    if (! schema->children[i]->name ||
+        strcmp(schema->children[i]->name, name) != 0)
+      continue;
+    const struct ArrowArray *child = array->children[i];
+    /* Each element of a field must be valid */
+    if (child->null_count != 0 && child->n_buffers > 0 && child->buffers[0])
+    {
+      for (int64 j = 0; j < array->length; j++)
+      {
+        if (! arrow_bit(child->buffers[0], array->offset + child->offset + j))
+        {
+          meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+            "The field '%s' of an Arrow column has null values", name);
+          return false;
+        }
+      }
+    }
+    field->array = child;
+    field->format = schema->children[i]->format;
+    field->offset = array->offset + child->offset;
+    return true;
+  }
+  field->array = NULL;
+  return true;
+}
+
+/**
+ * @brief Return the multiplier converting the timestamps of a field into
+ * microseconds, negative for a divisor, 0 if the format is not a timestamp
+ */
+static int64
+arrow_time_unit(const char *format)
+{
+  if (strncmp(format, "ts", 2) != 0 || format[2] == '\0' || format[3] != ':')
+    return 0;
+  switch (format[2])
+  {
+    case 's': return USECS_PER_SEC;
+    case 'm': return 1000;
+    case 'u': return 1;
+    case 'n': return -1000;
+    default: return 0;
+  }
+}
+
+/**
+ * @brief Return a temporal instant from an element of an imported column
+ * @return On error return @p NULL
+ */
+static TInstant *
+arrow_import_inst(MeosType temptype, const ArrowField *fields, int nfields,
+  int64 unit, int64 k, bool geodetic, int32_t srid)
+{
+  /* Timestamp, the nanoseconds are truncated to microseconds */
+  int64 t = ((const int64 *) fields[0].array->buffers[1])[fields[0].offset + k];
+  bool overflow = false;
+  if (unit > 0)
+    overflow = pg_mul_s64_overflow(t, unit, &t);
+  else
+  {
+    /* Division rounding towards minus infinity */
+    int64 rem = t % -unit;
+    t = t / -unit - (rem < 0 ? 1 : 0);
+  }
+  if (overflow || pg_sub_s64_overflow(t, ARROW_EPOCH_OFFSET, &t) ||
+      ! IS_VALID_TIMESTAMP(t))
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE,
+      "Arrow timestamp out of the range of a timestamptz");
+    return NULL;
+  }
+
+  const ArrowField *vf = &fields[1];
+  int64 idx = vf->offset + k;
+  Datum value;
+  switch (temptype)
+  {
+    case T_TBOOL:
+      value = BoolGetDatum(arrow_bit(vf->array->buffers[1], idx));
+      break;
+    case T_TINT:
+      value = Int32GetDatum(((const int32 *) vf->array->buffers[1])[idx]);
+      break;
+    case T_TBIGINT:
+      value = Int64GetDatum(((const int64 *) vf->array->buffers[1])[idx]);
+      break;
+    case T_TFLOAT:
+      value = Float8GetDatum(((const double *) vf->array->buffers[1])[idx]);
+      break;
+    case T_TTEXT:
+    {
+      int64 start, end;
+      if (vf->format[0] == 'U')
+      {
+        start = ((const int64 *) vf->array->buffers[1])[idx];
+        end = ((const int64 *) vf->array->buffers[1])[idx + 1];
+      }
+      else
+      {
+        start = ((const int32 *) vf->array->buffers[1])[idx];
+        end = ((const int32 *) vf->array->buffers[1])[idx + 1];
+      }
+      size_t len = (size_t) (end - start);
+      text *txt = palloc(VARHDRSZ + len);
+      SET_VARSIZE(txt, VARHDRSZ + len);
+      memcpy(VARDATA(txt), (const char *) vf->array->buffers[2] + start, len);
+      return tinstant_make_free(PointerGetDatum(txt), temptype, t);
+    }
+    default: /* T_TGEOMPOINT, T_TGEOGPOINT */
+    {
+      double coords[3] = { 0.0, 0.0, 0.0 };
+      for (int c = 0; c < nfields - 1; c++)
+        coords[c] = ((const double *) fields[1 + c].array->buffers[1])
+          [fields[1 + c].offset + k];
+      GSERIALIZED *gs = geopoint_make(coords[0], coords[1], coords[2],
+        nfields == 4, geodetic, srid);
+      return tinstant_make_free(PointerGetDatum(gs), temptype, t);
+    }
+  }
+  return tinstant_make(value, temptype, t);
+}
+
+/**
+ * @brief Return the temporal type of the field `v` of an imported column
+ */
+static MeosType
+arrow_value_temptype(const char *format)
+{
+  if (strcmp(format, "b") == 0)
+    return T_TBOOL;
+  if (strcmp(format, "i") == 0)
+    return T_TINT;
+  if (strcmp(format, "l") == 0)
+    return T_TBIGINT;
+  if (strcmp(format, "g") == 0)
+    return T_TFLOAT;
+  if (strcmp(format, "u") == 0 || strcmp(format, "U") == 0)
+    return T_TTEXT;
+  return T_UNKNOWN;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Import the temporal values of an Arrow column
+ * @details The column must have the layout produced by #temparr_as_arrow(),
+ * with 32-bit or 64-bit list and string offsets, and timestamps in any
+ * unit. The null lists are imported as `NULL` elements. The schema and the
+ * array are not released.
+ * @param[in] schema Schema of the column
+ * @param[in] array Data of the column
+ * @param[out] count Number of elements in the output array
+ * @return On error return @p NULL
+ * @see #temparr_as_arrow()
+ */
+Temporal **
+temparr_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array, int *count)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(schema, NULL); VALIDATE_NOT_NULL(array, NULL);
+  VALIDATE_NOT_NULL(count, NULL);
+
+  bool large = schema->format && strcmp(schema->format, "+L") == 0;
+  if (! schema->format || (! large && strcmp(schema->format, "+l") != 0) ||
+      schema->n_children != 1 || array->n_children != 1 ||
+      ! schema->children[0]->format ||
+      strcmp(schema->children[0]->format, "+s") != 0 ||
+      array->length > INT_MAX)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "An Arrow column of temporal values must be a list of structs");
+    return NULL;
+  }
+  const struct ArrowSchema *structschema = schema->children[0];
+  const struct ArrowArray *structarray = array->children[0];
+  if (structarray->null_count != 0 && structarray->buffers[0])
+  {
+    for (int64 j = 0; j < structarray->length; j++)
+    {
+      if (! arrow_bit(structarray->buffers[0], structarray->offset + j))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "An Arrow column of temporal values has null instants");
+        return NULL;
+      }
+    }
+  }
+
+  /* Fields of the instants */
+  ArrowField fields[ARROW_MAX_FIELDS];
+  if (! arrow_field(structschema, structarray, "t", &fields[0]) ||
+      ! arrow_field(structschema, structarray, "x", &fields[1]) ||
+      ! arrow_field(structschema, structarray, "y", &fields[2]) ||
+      ! arrow_field(structschema, structarray, "z", &fields[3]))
+    return NULL;
+  int64 unit = fields[0].array ? arrow_time_unit(fields[0].format) : 0;
+  if (! unit)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "An Arrow column of temporal values must have a timestamp field 't'");
+    return NULL;
+  }
+  MeosType temptype;
+  int nfields;
+  char type[ARROW_MAX_METADATA], interpstr[ARROW_MAX_METADATA],
+    sridstr[ARROW_MAX_METADATA];
+  bool hastype = arrow_metadata_get(schema->metadata, "meos.type", type);
+  if (fields[1].array && fields[2].array)
+  {
+    nfields = fields[3].array ? 4 : 3;
+    for (int c = 1; c < nfields; c++)
+    {
+      if (strcmp(fields[c].format, "g") != 0)
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The coordinates of an Arrow column must be of type float64");
+        return NULL;
+      }
+    }
+    temptype = (hastype && strcmp(type, "tgeogpoint") == 0) ?
+      T_TGEOGPOINT : T_TGEOMPOINT;
+  }
+  else
+  {
+    nfields = 2;
+    if (! arrow_field(structschema, structarray, "v", &fields[1]))
+      return NULL;
+    temptype = fields[1].array ? arrow_value_temptype(fields[1].format) :
+      T_UNKNOWN;
+    if (temptype == T_UNKNOWN)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "An Arrow column of temporal values must have the fields 'x' and 'y' "
+        "or a field 'v' of type bool, int32, int64, float64, or utf8");
+      return NULL;
+    }
+  }
+  bool geodetic = (temptype == T_TGEOGPOINT);
+  int32_t srid = geodetic ? WGS84_SRID : 0;
+  if (arrow_metadata_get(schema->metadata, "meos.srid", sridstr))
+    srid = atoi(sridstr);
+  interpType interp = (temptype == T_TFLOAT || tpoint_type(temptype)) ?
+    LINEAR : STEP;
+  if (arrow_metadata_get(schema->metadata, "meos.interp", interpstr))
+  {
+    meos_errno_reset();
+    interp = interptype_from_string(interpstr);
+    if (meos_errno())
+      return NULL;
+  }
+  if (interp == LINEAR && temptype != T_TFLOAT && ! tpoint_type(temptype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The temporal type %s does not support linear interpolation",
+      meostype_name(temptype));
+    return NULL;
+  }
+
+  /* Build the values, one list of instants each */
+  int nvalues = (int) array->length;
+  Temporal **result = palloc(sizeof(Temporal *) * Max(nvalues, 1));
+  const void *validity = (array->null_count != 0) ? array->buffers[0] : NULL;
+  for (int i = 0; i < nvalues; i++)
+  {
+    int64 idx = array->offset + i;
+    if (validity && ! arrow_bit(validity, idx))
+    {
+      result[i] = NULL;
+      continue;
+    }
+    int64 start, end;
+    if (large)
+    {
+      start = ((const int64 *) array->buffers[1])[idx];
+      end = ((const int64 *) array->buffers[1])[idx + 1];
+    }
+    else
+    {
+      start = ((const int32 *) array->buffers[1])[idx];
+      end = ((const int32 *) array->buffers[1])[idx + 1];
+    }
+    int n = (int) (end - start);
+    if (n < 1 || (interp == INTERP_NONE && n != 1))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Invalid number of instants in the element %d of an Arrow column: %d",
+        i, n);
+      pfree_array((void **) result, i);
+      return NULL;
+    }
+    TInstant **instants = palloc(sizeof(TInstant *) * n);
+    for (int j = 0; j < n; j++)
+    {
+      instants[j] = arrow_import_inst(temptype, fields, nfields, unit,
+        start + j, geodetic, srid);
+      if (! instants[j])
+      {
+        pfree_array((void **) instants, j);
+        pfree_array((void **) result, i);
+        return NULL;
+      }
+    }
+    if (interp == INTERP_NONE)
+    {
+      result[i] = (Temporal *) instants[0];
+      pfree(instants);
+    }
+    else
+      result[i] = (Temporal *) tsequence_make_free(instants, n, true, true,
+        interp, NORMALIZE);
+    if (! result[i])
+    {
+      pfree_array((void **) result, i);
+      return NULL;
+    }
+  }
+  *count = nvalues;
+  return result;
+}
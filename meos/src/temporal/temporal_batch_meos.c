@@ -0,0 +1,692 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Batch functions computing an accessor, a bounding box, or a
+ * restriction of each value of an array of temporal values
+ * @details The functions validate the array once, read the values in place
+ * without the validation and the allocation of the per-value functions, and
+ * write the results into an output array provided by the caller. The
+ * functions whose cost depends on the number of instants, such as the
+ * restriction and the length, split the array between the threads of the
+ * MEOS thread pool when the array is large enough.
+ */
+
+/* C */
+#include <assert.h>
+#include <limits.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_geo.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "temporal/meos_parallel.h"
+#include "temporal/span.h"
+#include "temporal/temporal.h"
+
+/* Number of values of an array processed by a task of a parallel loop */
+#define TEMPARR_BATCH_CHUNK 64
+
+/*****************************************************************************
+ * Driver of the batch functions
+ *****************************************************************************/
+
+typedef struct TemporalBatch TemporalBatch;
+
+/**
+ * @brief Function processing the values `start` to `end - 1` of a batch
+ */
+typedef void (*temparr_batch_fn)(const TemporalBatch *batch, int start,
+  int end);
+
+/**
+ * @brief State of a batch function shared by the tasks of a parallel loop
+ */
+struct TemporalBatch
+{
+  Temporal **temparr;       /**< Array of temporal values */
+  int count;                /**< Number of values */
+  temparr_batch_fn fn;      /**< Function processing a range of values */
+  const void *arg;          /**< Argument of the function */
+  void *result;             /**< Output array */
+};
+
+/**
+ * @brief Ensure that an array of temporal values is not empty, has no `NULL`
+ * element, and that its elements satisfy a type condition
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] typefn Function testing the temporal type, may be `NULL`
+ * @param[in] typename Name of the expected type for the error message
+ * @param[out] ninsts Total number of instants of the values, may be `NULL`
+ */
+static bool
+ensure_valid_temparr(Temporal **temparr, int count, bool (*typefn)(MeosType),
+  const char *typename, int64 *ninsts)
+{
+  if (! ensure_positive(count))
+    return false;
+  int64 total = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    if (! temp)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Null temporal value at position %d of the array", i);
+      return false;
+    }
+    if (typefn && ! typefn(temp->temptype))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+        "The temporal value at position %d of the array must be a %s",
+        i, typename);
+      return false;
+    }
+    if (ninsts)
+      total += (temp->subtype == TINSTANT) ? 1 :
+        (temp->subtype == TSEQUENCE) ? ((TSequence *) temp)->count :
+        ((TSequenceSet *) temp)->totalcount;
+  }
+  if (ninsts)
+    *ninsts = total;
+  return true;
+}
+
+/**
+ * @brief Process the values of the n-th chunk of a batch
+ */
+static void
+temparr_batch_task(void *arg, int task)
+{
+  const TemporalBatch *batch = (const TemporalBatch *) arg;
+  int start = task * TEMPARR_BATCH_CHUNK;
+  int end = Min(start + TEMPARR_BATCH_CHUNK, batch->count);
+  batch->fn(batch, start, end);
+  return;
+}
+
+/**
+ * @brief Process the values of a batch, splitting them between the threads
+ * of the pool when their number of instants is large enough
+ * @param[in] batch Batch
+ * @param[in] ninsts Total number of instants of the values, 0 for a function
+ * whose cost does not depend on it
+ */
+static void
+temparr_batch_run(TemporalBatch *batch, int64 ninsts)
+{
+  int ntasks = (batch->count + TEMPARR_BATCH_CHUNK - 1) / TEMPARR_BATCH_CHUNK;
+  int nthreads = meos_parallel_pool_threads((int) Min(ninsts, INT_MAX),
+    ntasks);
+  if (nthreads <= 1)
+    batch->fn(batch, 0, batch->count);
+  else
+    meos_parallel_for(nthreads, ntasks, &temparr_batch_task, batch);
+  return;
+}
+
+/**
+ * @brief Initialize a batch and process its values
+ */
+static void
+temparr_batch(Temporal **temparr, int count, temparr_batch_fn fn,
+  const void *arg, void *result, int64 ninsts)
+{
+  TemporalBatch batch;
+  batch.temparr = temparr;
+  batch.count = count;
+  batch.fn = fn;
+  batch.arg = arg;
+  batch.result = result;
+  temparr_batch_run(&batch, ninsts);
+  return;
+}
+
+/*****************************************************************************
+ * Accessor functions
+ *****************************************************************************/
+
+/**
+ * @brief Set the start timestamps of a range of values of a batch
+ */
+static void
+temparr_start_timestamptz_fn(const TemporalBatch *batch, int start, int end)
+{
+  TimestampTz *result = (TimestampTz *) batch->result;
+  for (int i = start; i < end; i++)
+    result[i] = temporal_start_inst(batch->temparr[i])->t;
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the start timestamps of an array of
+ * temporal values
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count timestamps
+ * @return On error return false
+ * @see #temporal_start_timestamptz()
+ */
+bool
+temparr_start_timestamptz(Temporal **temparr, int count, TimestampTz *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, NULL))
+    return false;
+  temparr_batch(temparr, count, &temparr_start_timestamptz_fn, NULL, result,
+    0);
+  return true;
+}
+
+/**
+ * @brief Set the end timestamps of a range of values of a batch
+ */
+static void
+temparr_end_timestamptz_fn(const TemporalBatch *batch, int start, int end)
+{
+  TimestampTz *result = (TimestampTz *) batch->result;
+  for (int i = start; i < end; i++)
+    result[i] = temporal_end_inst(batch->temparr[i])->t;
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the end timestamps of an array of
+ * temporal values
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count timestamps
+ * @return On error return false
+ * @see #temporal_end_timestamptz()
+ */
+bool
+temparr_end_timestamptz(Temporal **temparr, int count, TimestampTz *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, NULL))
+    return false;
+  temparr_batch(temparr, count, &temparr_end_timestamptz_fn, NULL, result, 0);
+  return true;
+}
+
+/**
+ * @brief Return the duration of a temporal value in microseconds
+ */
+static int64
+temporal_duration_usecs(const Temporal *temp, bool boundspan)
+{
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      return 0;
+    case TSEQUENCE:
+    {
+      if (MEOS_FLAGS_DISCRETE_INTERP(temp->flags) && ! boundspan)
+        return 0;
+      const Span *p = &((TSequence *) temp)->period;
+      return DatumGetTimestampTz(p->upper) - DatumGetTimestampTz(p->lower);
+    }
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      if (boundspan)
+        return DatumGetTimestampTz(ss->period.upper) -
+          DatumGetTimestampTz(ss->period.lower);
+      int64 result = 0;
+      for (int i = 0; i < ss->count; i++)
+      {
+        const Span *p = &TSEQUENCESET_SEQ_N(ss, i)->period;
+        result += DatumGetTimestampTz(p->upper) -
+          DatumGetTimestampTz(p->lower);
+      }
+      return result;
+    }
+  }
+}
+
+/**
+ * @brief Set the durations of a range of values of a batch
+ */
+static void
+temparr_duration_fn(const TemporalBatch *batch, int start, int end)
+{
+  int64 *result = (int64 *) batch->result;
+  bool boundspan = *(const bool *) batch->arg;
+  for (int i = start; i < end; i++)
+    result[i] = temporal_duration_usecs(batch->temparr[i], boundspan);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the durations of an array of temporal
+ * values in microseconds
+ * @details Contrary to #temporal_duration, the durations are not justified
+ * into days, so that they can be stored as 64-bit integers
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] boundspan True when the potential time gaps are ignored
+ * @param[out] result Array of @p count durations
+ * @return On error return false
+ * @see #temporal_duration()
+ */
+bool
+temparr_duration(Temporal **temparr, int count, bool boundspan, int64 *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, NULL))
+    return false;
+  temparr_batch(temparr, count, &temparr_duration_fn, &boundspan, result, 0);
+  return true;
+}
+
+/**
+ * @brief Set the number of instants of a range of values of a batch
+ */
+static void
+temparr_num_instants_fn(const TemporalBatch *batch, int start, int end)
+{
+  int *result = (int *) batch->result;
+  for (int i = start; i < end; i++)
+  {
+    const Temporal *temp = batch->temparr[i];
+    result[i] = temporal_num_instants(temp);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the number of instants of an array of
+ * temporal values
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count numbers of instants
+ * @return On error return false
+ * @see #temporal_num_instants()
+ */
+bool
+temparr_num_instants(Temporal **temparr, int count, int *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  int64 ninsts;
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, &ninsts))
+    return false;
+  temparr_batch(temparr, count, &temparr_num_instants_fn, NULL, result,
+    ninsts);
+  return true;
+}
+
+/**
+ * @brief Return true if the temporal type is a temporal float
+ */
+static bool
+tfloat_type(MeosType type)
+{
+  return type == T_TFLOAT;
+}
+
+/**
+ * @brief Return true if the temporal type is a temporal integer
+ */
+static bool
+tint_type(MeosType type)
+{
+  return type == T_TINT;
+}
+
+/**
+ * @brief Set the start or end float values of a range of values of a batch
+ */
+static void
+tfloatarr_value_fn(const TemporalBatch *batch, int start, int end)
+{
+  double *result = (double *) batch->result;
+  bool startval = *(const bool *) batch->arg;
+  for (int i = start; i < end; i++)
+  {
+    const Temporal *temp = batch->temparr[i];
+    result[i] = DatumGetFloat8(tinstant_value_p(startval ?
+      temporal_start_inst(temp) : temporal_end_inst(temp)));
+  }
+  return;
+}
+
+/**
+ * @brief Set the start or end integer values of a range of values of a batch
+ */
+static void
+tintarr_value_fn(const TemporalBatch *batch, int start, int end)
+{
+  int *result = (int *) batch->result;
+  bool startval = *(const bool *) batch->arg;
+  for (int i = start; i < end; i++)
+  {
+    const Temporal *temp = batch->temparr[i];
+    result[i] = DatumGetInt32(tinstant_value_p(startval ?
+      temporal_start_inst(temp) : temporal_end_inst(temp)));
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the start values of an array of
+ * temporal floats
+ * @param[in] temparr Array of temporal floats
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count values
+ * @return On error return false
+ * @see #tfloat_start_value()
+ */
+bool
+tfloatarr_start_value(Temporal **temparr, int count, double *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tfloat_type, "tfloat", NULL))
+    return false;
+  bool startval = true;
+  temparr_batch(temparr, count, &tfloatarr_value_fn, &startval, result, 0);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the end values of an array of temporal
+ * floats
+ * @param[in] temparr Array of temporal floats
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count values
+ * @return On error return false
+ * @see #tfloat_end_value()
+ */
+bool
+tfloatarr_end_value(Temporal **temparr, int count, double *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tfloat_type, "tfloat", NULL))
+    return false;
+  bool startval = false;
+  temparr_batch(temparr, count, &tfloatarr_value_fn, &startval, result, 0);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the start values of an array of
+ * temporal integers
+ * @param[in] temparr Array of temporal integers
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count values
+ * @return On error return false
+ * @see #tint_start_value()
+ */
+bool
+tintarr_start_value(Temporal **temparr, int count, int *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tint_type, "tint", NULL))
+    return false;
+  bool startval = true;
+  temparr_batch(temparr, count, &tintarr_value_fn, &startval, result, 0);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last argument the end values of an array of temporal
+ * integers
+ * @param[in] temparr Array of temporal integers
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count values
+ * @return On error return false
+ * @see #tint_end_value()
+ */
+bool
+tintarr_end_value(Temporal **temparr, int count, int *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tint_type, "tint", NULL))
+    return false;
+  bool startval = false;
+  temparr_batch(temparr, count, &tintarr_value_fn, &startval, result, 0);
+  return true;
+}
+
+/**
+ * @brief Set the lengths of a range of temporal points of a batch
+ */
+static void
+tpointarr_length_fn(const TemporalBatch *batch, int start, int end)
+{
+  double *result = (double *) batch->result;
+  for (int i = start; i < end; i++)
+  {
+    const Temporal *temp = batch->temparr[i];
+    if (! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+      result[i] = 0.0;
+    else if (temp->subtype == TSEQUENCE)
+      result[i] = tpointseq_length((TSequence *) temp);
+    else /* TSEQUENCESET */
+      result[i] = tpointseqset_length((TSequenceSet *) temp);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_geo_accessor
+ * @brief Return in the last argument the lengths traversed by an array of
+ * temporal points
+ * @details The array is split between the threads of the MEOS thread pool
+ * when it has enough instants
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count lengths
+ * @return On error return false
+ * @see #tpoint_length()
+ */
+bool
+tpointarr_length(Temporal **temparr, int count, double *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  int64 ninsts;
+  if (! ensure_valid_temparr(temparr, count, &tpoint_type, "temporal point",
+      &ninsts))
+    return false;
+  temparr_batch(temparr, count, &tpointarr_length_fn, NULL, result, ninsts);
+  return true;
+}
+
+/*****************************************************************************
+ * Bounding box functions
+ *****************************************************************************/
+
+/**
+ * @brief Set the time spans of a range of values of a batch
+ */
+static void
+temparr_to_tstzspan_fn(const TemporalBatch *batch, int start, int end)
+{
+  Span *result = (Span *) batch->result;
+  for (int i = start; i < end; i++)
+    temporal_set_tstzspan(batch->temparr[i], &result[i]);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_conversion
+ * @brief Return in the last argument the bounding periods of an array of
+ * temporal values
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count spans
+ * @return On error return false
+ * @see #temporal_to_tstzspan()
+ */
+bool
+temparr_to_tstzspan(Temporal **temparr, int count, Span *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, NULL))
+    return false;
+  temparr_batch(temparr, count, &temparr_to_tstzspan_fn, NULL, result, 0);
+  return true;
+}
+
+/**
+ * @brief Set the temporal boxes of a range of values of a batch
+ */
+static void
+tnumberarr_to_tbox_fn(const TemporalBatch *batch, int start, int end)
+{
+  TBox *result = (TBox *) batch->result;
+  for (int i = start; i < end; i++)
+    tnumber_set_tbox(batch->temparr[i], &result[i]);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_conversion
+ * @brief Return in the last argument the bounding boxes of an array of
+ * temporal numbers
+ * @param[in] temparr Array of temporal numbers
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count temporal boxes
+ * @return On error return false
+ * @see #tnumber_to_tbox()
+ */
+bool
+tnumberarr_to_tbox(Temporal **temparr, int count, TBox *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tnumber_type,
+      "temporal number", NULL))
+    return false;
+  temparr_batch(temparr, count, &tnumberarr_to_tbox_fn, NULL, result, 0);
+  return true;
+}
+
+/**
+ * @brief Set the spatiotemporal boxes of a range of values of a batch
+ */
+static void
+tspatialarr_to_stbox_fn(const TemporalBatch *batch, int start, int end)
+{
+  STBox *result = (STBox *) batch->result;
+  for (int i = start; i < end; i++)
+    tspatial_set_stbox(batch->temparr[i], &result[i]);
+  return;
+}
+
+/**
+ * @ingroup meos_geo_conversion
+ * @brief Return in the last argument the bounding boxes of an array of
+ * spatiotemporal values
+ * @param[in] temparr Array of spatiotemporal values
+ * @param[in] count Number of values
+ * @param[out] result Array of @p count spatiotemporal boxes
+ * @return On error return false
+ * @see #tspatial_to_stbox()
+ */
+bool
+tspatialarr_to_stbox(Temporal **temparr, int count, STBox *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  if (! ensure_valid_temparr(temparr, count, &tspatial_type,
+      "spatiotemporal value", NULL))
+    return false;
+  temparr_batch(temparr, count, &tspatialarr_to_stbox_fn, NULL, result, 0);
+  return true;
+}
+
+/*****************************************************************************
+ * Restriction functions
+ *****************************************************************************/
+
+/**
+ * @brief Restrict a range of values of a batch to a timestamptz span
+ */
+static void
+temparr_at_tstzspan_fn(const TemporalBatch *batch, int start, int end)
+{
+  Temporal **result = (Temporal **) batch->result;
+  const Span *s = (const Span *) batch->arg;
+  for (int i = start; i < end; i++)
+    result[i] = temporal_restrict_tstzspan(batch->temparr[i], s, REST_AT);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_restrict
+ * @brief Return in the last argument an array of temporal values restricted
+ * to a common timestamptz span
+ * @details The elements of the result are `NULL` for the values that do not
+ * intersect the span. The array is split between the threads of the MEOS
+ * thread pool when it has enough instants.
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] s Timestamptz span
+ * @param[out] result Array of @p count temporal values
+ * @return On error return false
+ * @see #temporal_at_tstzspan()
+ */
+bool
+temparr_at_tstzspan(Temporal **temparr, int count, const Span *s,
+  Temporal **result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temparr, false); VALIDATE_NOT_NULL(result, false);
+  VALIDATE_TSTZSPAN(s, false);
+  int64 ninsts;
+  if (! ensure_valid_temparr(temparr, count, NULL, NULL, &ninsts))
+    return false;
+  temparr_batch(temparr, count, &temparr_at_tstzspan_fn, s, result, ninsts);
+  return true;
+}
+
+/*****************************************************************************/
@@ -43,6 +43,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include <meos_internal_geo.h>
+#include "temporal/meos_parallel.h"
 #include "temporal/set.h"
 #include "temporal/span.h"
 #include "temporal/spanset.h"
@@ -572,8 +573,51 @@ temporal_merge(const Temporal *temp1, const Temporal *temp2)
   return result;
 }
 
+/**
+ * @brief Arguments of the tasks transforming temporal values into a common
+ * subtype
+ */
+typedef struct
+{
+  Temporal **temparr;       /**< Array of values */
+  uint8 subtype;            /**< Common subtype */
+  interpType interp;        /**< Interpolation */
+  Temporal **result;        /**< Transformed values */
+} TemporalConvertTasks;
+
+/**
+ * @brief Transform the n-th temporal value of an array into a common subtype
+ */
+static void
+temporal_convert_subtype_task(void *arg, int task)
+{
+  TemporalConvertTasks *tasks = (TemporalConvertTasks *) arg;
+  Temporal *temp = tasks->temparr[task];
+  uint8 subtype = tasks->subtype;
+  uint8 subtype1 = temp->subtype;
+  assert(subtype >= subtype1);
+  Temporal *result;
+  if (subtype == subtype1)
+    result = temporal_copy(temp);
+  else if (subtype1 == TINSTANT)
+  {
+    if (subtype == TSEQUENCE)
+      result = (Temporal *) tinstant_as_tsequence((TInstant *) temp,
+        tasks->interp);
+    else /* subtype == TSEQUENCESET */
+      result = (Temporal *) tinstant_as_tsequenceset((TInstant *) temp,
+        tasks->interp);
+  }
+  else /* subtype1 == TSEQUENCE && subtype == TSEQUENCESET */
+    result = (Temporal *) tsequence_as_tsequenceset((TSequence *) temp);
+  tasks->result[task] = result;
+  return;
+}
+
 /**
  * @brief Return an array of temporal values transformed into a common subtype
+ * @details The values are transformed by the threads of the MEOS thread pool
+ * when the array is large enough
  * @param[in] temparr Array of values
  * @param[in] count Number of values in the array
  * @param[in] subtype common subtype
@@ -585,26 +629,15 @@ temporalarr_convert_subtype(Temporal **temparr, int count, uint8 subtype,
 {
   assert(temparr);
   assert(temptype_subtype(subtype));
-  Temporal **result = palloc(sizeof(Temporal *) * count);
-  for (int i = 0; i < count; i++)
-  {
-    uint8 subtype1 = temparr[i]->subtype;
-    assert(subtype >= subtype1);
-    if (subtype == subtype1)
-      result[i] = temporal_copy(temparr[i]);
-    else if (subtype1 == TINSTANT)
-    {
-      if (subtype == TSEQUENCE)
-        result[i] = (Temporal *) tinstant_as_tsequence((TInstant *) temparr[i],
-          interp);
-      else /* subtype == TSEQUENCESET */
-        result[i] = (Temporal *) tinstant_as_tsequenceset((TInstant *) temparr[i],
-          interp);
-    }
-    else /* subtype1 == TSEQUENCE && subtype == TSEQUENCESET */
-      result[i] = (Temporal *) tsequence_as_tsequenceset((TSequence *) temparr[i]);
-  }
-  return result;
+  TemporalConvertTasks tasks;
+  tasks.temparr = temparr;
+  tasks.subtype = subtype;
+  tasks.interp = interp;
+  tasks.result = palloc(sizeof(Temporal *) * count);
+  /* Every value has at least one instant */
+  meos_parallel_for(meos_parallel_pool_threads(count, count), count,
+    &temporal_convert_subtype_task, &tasks);
+  return tasks.result;
 }
 
 /**
@@ -34,8 +34,19 @@
  */
 
 /* C */
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include "port/pg_bitutils.h"
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_geo.h>
@@ -49,12 +60,29 @@
 #include "temporal/tbox.h"
 #include "temporal/temporal.h"
 #include "temporal/type_util.h"
+#include "temporal/meos_parallel.h"
 #include "temporal/temporal_rtree.h"
 
 /*****************************************************************************
  * Functions passed as parameters in the creation of an RTree
  *****************************************************************************/
 
+/**
+ * @brief Return a bound of a span as a double
+ * @details The bound is converted according to the base type of the span
+ * rather than by casting the Datum, whose bits are those of a float for a
+ * float span and those of a sign-extended integer for an integer or a date
+ * span
+ * @param[in] d Bound
+ * @param[in] basetype Base type of the span
+ */
+static inline double
+span_bound_double(Datum d, MeosType basetype)
+{
+  return (basetype == T_TIMESTAMPTZ) ? (double) DatumGetTimestampTz(d) :
+    datum_double(d, basetype);
+}
+
 /**
  * @brief Return the lower or upper bound from a span as a double
  * @param[in] box Span
@@ -68,7 +96,7 @@ get_axis_span(const void *box, int axis UNUSED, bool upper)
 {
   assert(box);
   Span *span = (Span *) box;
-  return upper ? (double) span->upper : (double) span->lower;
+  return span_bound_double(upper ? span->upper : span->lower, span->basetype);
 }
 
 /**
@@ -86,7 +114,8 @@ get_axis_tbox(const void *box, int axis, bool upper)
   assert(box); assert(axis == 0 || axis == 1);
   TBox *tbox = (TBox *) box;
   if (axis == 0)
-    return upper ? (double) tbox->span.upper : (double) tbox->span.lower;
+    return span_bound_double(upper ? tbox->span.upper : tbox->span.lower,
+      tbox->span.basetype);
   else /* axis == 1 */
     return upper ? (double)((int64) tbox->period.upper) :
       (double)((int64) tbox->period.lower);
@@ -329,23 +358,100 @@ bbox_overlaps_tpcbox(const void *box1, const void *box2)
  * Rtree functions
  *****************************************************************************/
 
+/**
+ * @brief Ensure that an RTree can be modified, i.e., that it has not been
+ * opened by #rtree_open_mmap
+ */
+static bool
+ensure_rtree_writable(const RTree *rtree)
+{
+  if (! rtree->mapped)
+    return true;
+  meos_error(ERROR, MEOS_ERR_FEATURE_NOT_SUPPORTED,
+    "Cannot modify an RTree opened from a file");
+  return false;
+}
+
+/**
+ * @brief Return the bit mask of the axes a bounding box carries
+ * @details Bit `i` is set when the box has a value along axis `i` of
+ * @p rtree->get_axis. The bounds along the other axes are meaningless and are
+ * never compared.
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in] box Bounding box of type @p rtree->bboxtype
+ */
+static int
+rtree_box_axes(const RTree *rtree, const void *box)
+{
+  if (span_type(rtree->bboxtype))
+    return 1;
+  int16 flags;
+  if (rtree->bboxtype == T_TBOX)
+  {
+    flags = ((const TBox *) box)->flags;
+    return (MEOS_FLAGS_GET_X(flags) ? 1 : 0) |
+      (MEOS_FLAGS_GET_T(flags) ? 2 : 0);
+  }
+  /* STBox, or TPCBox which shares its prefix layout (see get_axis_tpcbox) */
+  flags = ((const STBox *) box)->flags;
+  return (MEOS_FLAGS_GET_X(flags) ? 3 : 0) |
+    (MEOS_FLAGS_GET_T(flags) ? 4 : 0) |
+    (MEOS_FLAGS_GET_Z(flags) && rtree->dims > 3 ? 8 : 0);
+}
+
+/**
+ * @brief Return the size of the nodes of an RTree
+ * @details A node has room for `MAXITEMS` bounding boxes followed by the
+ * per-axis arrays of their bounds
+ * @param[in] rtree Pointer to the RTree structure
+ */
+static size_t
+node_size(const RTree *rtree)
+{
+  assert(rtree->dims > 0 && rtree->dims <= RTREE_MAX_AXES);
+  return sizeof(RTreeNode) + rtree->bboxsize * MAXITEMS +
+    sizeof(double) * 2 * MAXITEMS * rtree->dims;
+}
+
 /**
  * @brief Creates a new RTree node
+ * @details The node has room for `MAXITEMS` bounding boxes followed by the
+ * per-axis arrays of their bounds, so the number of dimensions of the RTree
+ * must be known
+ * @param[in] rtree Pointer to the RTree structure
  * @param[in] node_type Type of the node
- * @param[in] bboxsize Bounding box size 
  * @return Pointer to the newly created node
  */
 static RTreeNode *
-node_make(RTreeNodeType node_type, size_t bboxsize)
+node_make(const RTree *rtree, RTreeNodeType node_type)
 {
-  size_t bboxes_size = bboxsize * MAXITEMS;
-  RTreeNode *node = palloc0(sizeof(RTreeNode) + bboxes_size);
+  RTreeNode *node = palloc0(node_size(rtree));
   node->node_type = node_type;
-  node->bboxsize = bboxsize;
+  node->bboxsize = rtree->bboxsize;
   node->count = 0;
   return node;
 }
 
+/**
+ * @brief Set the axis bounds of an entry of a node from its bounding box
+ * @details Must be called whenever the bounding box of an entry is written so
+ * that the per-axis arrays scanned by the search stay in sync with the boxes
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in,out] node Node
+ * @param[in] i Index of the entry
+ */
+static void
+node_set_bounds(const RTree *rtree, RTreeNode *node, int i)
+{
+  const void *box = RTREE_NODE_BBOX_N(node, i);
+  for (int axis = 0; axis < rtree->dims; axis++)
+  {
+    RTREE_NODE_LOWER(node, axis)[i] = rtree->get_axis(box, axis, false);
+    RTREE_NODE_UPPER(node, axis)[i] = rtree->get_axis(box, axis, true);
+  }
+  return;
+}
+
 /**
  * @brief Return the length of a bounding box along a given axis as a double
  * @param[in] rtree Pointer to the RTree structure containing the function to
@@ -509,6 +615,7 @@ box_largest_axis(const RTree *rtree, const void *box)
 /**
  * @brief Moves a bounding box from one RTree node to another.
  * @details Changes the information from one node into another.
+ * @param[in] rtree Pointer to the RTree structure
  * @param[in] from Pointer to the node from which the bounding box is
  * being moved.
  * @param[in] index The index of the bounding box in the `from` node that is to
@@ -517,12 +624,22 @@ box_largest_axis(const RTree *rtree, const void *box)
  * to.
  */
 static void
-node_move_box_at_index_into(RTreeNode *from, int index, RTreeNode *into)
+node_move_box_at_index_into(const RTree *rtree, RTreeNode *from, int index,
+  RTreeNode *into)
 {
   memcpy(RTREE_NODE_BBOX_N(into, into->count), RTREE_NODE_BBOX_N(from, index),
     from->bboxsize);
   memcpy(RTREE_NODE_BBOX_N(from, index),
     RTREE_NODE_BBOX_N(from, from->count - 1), from->bboxsize);
+  for (int axis = 0; axis < rtree->dims; axis++)
+  {
+    double *flower = RTREE_NODE_LOWER(from, axis);
+    double *fupper = RTREE_NODE_UPPER(from, axis);
+    RTREE_NODE_LOWER(into, axis)[into->count] = flower[index];
+    RTREE_NODE_UPPER(into, axis)[into->count] = fupper[index];
+    flower[index] = flower[from->count - 1];
+    fupper[index] = fupper[from->count - 1];
+  }
   if (from->node_type == RTREE_LEAF)
   {
     into->ids[into->count] = from->ids[index];
@@ -559,6 +676,13 @@ node_swap(const RTree *rtree, RTreeNode *node, int i, int j)
   memcpy(RTREE_NODE_BBOX_N(node, i), RTREE_NODE_BBOX_N(node, j),
     rtree->bboxsize);
   memcpy(RTREE_NODE_BBOX_N(node, j), buf, rtree->bboxsize);
+  for (int axis = 0; axis < rtree->dims; axis++)
+  {
+    double *lower = RTREE_NODE_LOWER(node, axis);
+    double *upper = RTREE_NODE_UPPER(node, axis);
+    double tmp = lower[i]; lower[i] = lower[j]; lower[j] = tmp;
+    tmp = upper[i]; upper[i] = upper[j]; upper[j] = tmp;
+  }
   if (node->node_type == RTREE_LEAF)
   {
     int64 tmp = node->ids[i];
@@ -661,7 +785,7 @@ node_split(RTree *rtree, RTreeNode *node, void *box, RTreeNode **right_out)
 {
   /* Split through the largest axis */
   int largest_axis = box_largest_axis(rtree, box);
-  RTreeNode *right = node_make(node->node_type, rtree->bboxsize);
+  RTreeNode *right = node_make(rtree, node->node_type);
   for (int i = 0; i < node->count; ++i)
   {
     double min_dist =
@@ -672,7 +796,7 @@ node_split(RTree *rtree, RTreeNode *node, void *box, RTreeNode **right_out)
       rtree->get_axis(RTREE_NODE_BBOX_N(node, i), largest_axis, true);
     /* Move to the right */
     if (max_dist < min_dist)
-      node_move_box_at_index_into(node, i--, right);
+      node_move_box_at_index_into(rtree, node, i--, right);
   }
 
   /* Make sure that both left and right nodes have at least MINITEMS by moving
@@ -683,7 +807,7 @@ node_split(RTree *rtree, RTreeNode *node, void *box, RTreeNode **right_out)
     node_sort_axis(rtree, right, largest_axis, false);
     do
     {
-      node_move_box_at_index_into(right, right->count - 1, node);
+      node_move_box_at_index_into(rtree, right, right->count - 1, node);
     } while (node->count < MINITEMS);
   }
   else if (right->count < MINITEMS)
@@ -692,7 +816,7 @@ node_split(RTree *rtree, RTreeNode *node, void *box, RTreeNode **right_out)
     node_sort_axis(rtree, node, largest_axis, true);
     do
     {
-      node_move_box_at_index_into(node, node->count - 1, right);
+      node_move_box_at_index_into(rtree, node, node->count - 1, right);
     } while (right->count < MINITEMS);
   }
   if (node->node_type == RTREE_INNER)
@@ -707,29 +831,36 @@ node_split(RTree *rtree, RTreeNode *node, void *box, RTreeNode **right_out)
 /**
  * @brief Inserts a new bounding box into an RTree node and handles node
  * splitting if necessary
- * @details If the node is a leaf and already contains the maximum number of
- * items (`MAXITEMS`), the function sets the `split` flag to `true` to indicate
- * that the node needs to be split. For non-leaf nodes, the function determines
- * the appropriate child node for insertion and recursively inserts the
- * bounding box. If splitting occurs, the function handles the split and
- * updates the parent node's bounding boxes.
+ * @details The entry is placed in a node at height @p level, that is, a leaf
+ * for the entries of the caller, or an inner node for the subtrees of a node
+ * dissolved by #rtree_delete. If that node already contains the maximum
+ * number of items (`MAXITEMS`), the function sets the `split` flag to `true`
+ * to indicate that the node needs to be split. For nodes above that height,
+ * the function determines the appropriate child node for insertion and
+ * recursively inserts the bounding box. If splitting occurs, the function
+ * handles the split and updates the parent node's bounding boxes.
  * @param[in] rtree Pointer to the RTree structure that provides axis value
  * retrieval and node splitting functions
  * @param[in] node_bounding_box Pointer to the bounding bounding box of all the
  * bounding boxes in `node`
  * @param[in] node Pointer to the node where the bounding box is being
  * inserted
+ * @param[in] height Height of `node`, 0 for a leaf
  * @param[in] new_box Pointer to the bounding box to be inserted
  * @param[in] id Identifier associated with the new bounding box (used only for
  * leaf nodes)
+ * @param[in] child Subtree associated with the new bounding box (used only for
+ * inner nodes)
+ * @param[in] level Height of the node receiving the entry
  * @param[out] split Pointer to a boolean flag that indicates if the node was
  * split during insertion
  */
 static void
 node_insert(RTree *rtree, void *node_bounding_box, RTreeNode *node,
-  void *new_box, int64 id, bool *split)
+  int height, void *new_box, int64 id, RTreeNode *child, int level,
+  bool *split)
 {
-  if (node->node_type == RTREE_LEAF)
+  if (height == level)
   {
     if (node->count == MAXITEMS)
     {
@@ -738,17 +869,23 @@ node_insert(RTree *rtree, void *node_bounding_box, RTreeNode *node,
     }
     int index = node->count;
     memcpy(RTREE_NODE_BBOX_N(node, index), new_box, rtree->bboxsize);
-    node->ids[index] = id;
+    node_set_bounds(rtree, node, index);
+    if (node->node_type == RTREE_LEAF)
+      node->ids[index] = id;
+    else
+      node->nodes[index] = child;
     node->count++;
     *split = false;
     return;
   }
   int insertion_node = node_choose(rtree, new_box, node);
   node_insert(rtree, RTREE_NODE_BBOX_N(node, insertion_node),
-    (RTreeNode *) node->nodes[insertion_node], new_box, id, split);
+    (RTreeNode *) node->nodes[insertion_node], height - 1, new_box, id, child,
+    level, split);
   if (! *split)
   {
     rtree->bbox_expand(new_box, RTREE_NODE_BBOX_N(node, insertion_node));
+    node_set_bounds(rtree, node, insertion_node);
     *split = false;
     return;
   }
@@ -762,10 +899,13 @@ node_insert(RTree *rtree, void *node_bounding_box, RTreeNode *node,
     RTREE_NODE_BBOX_N(node, insertion_node), &right);
   node_box_calculate(rtree, node->nodes[insertion_node],
     RTREE_NODE_BBOX_N(node, insertion_node));
+  node_set_bounds(rtree, node, insertion_node);
   node_box_calculate(rtree, right, RTREE_NODE_BBOX_N(node, node->count));
+  node_set_bounds(rtree, node, node->count);
   node->nodes[node->count] = right;
   node->count++;
-  node_insert(rtree, node_bounding_box, node, new_box, id, split);
+  node_insert(rtree, node_bounding_box, node, height, new_box, id, child,
+    level, split);
   return;
 }
 
@@ -795,42 +935,122 @@ leaf_consistent(const RTree *rtree, const void *key, const void *query,
 }
 
 /**
- * @brief Return true if an inner node is consistent with the search query
- * @details This is a looser check used for pruning subtrees during traversal.
+ * @brief Bounds of a query box along the axes of an RTree
+ */
+typedef struct
+{
+  int axes;                        /**< Axes compared, see #rtree_box_axes */
+  double lower[RTREE_MAX_AXES];    /**< Lower bound along each axis */
+  double upper[RTREE_MAX_AXES];    /**< Upper bound along each axis */
+} RTreeBounds;
+
+/**
+ * @brief Set the bounds of a query box along the axes of an RTree
+ * @details Only the axes carried by the query and by every box of the RTree
+ * are compared, as the box predicates ignore an axis one of the two boxes
+ * lacks
  * @param[in] rtree Pointer to the RTree structure
- * @param[in] key The bounding box of the inner node
  * @param[in] query The bounding box that serves as query
+ * @param[out] bounds Bounds of the query
+ */
+static void
+rtree_query_bounds(const RTree *rtree, const void *query, RTreeBounds *bounds)
+{
+  bounds->axes = rtree->axes & rtree_box_axes(rtree, query);
+  for (int axis = 0; axis < rtree->dims; axis++)
+  {
+    if (! (bounds->axes & (1 << axis)))
+      continue;
+    bounds->lower[axis] = rtree->get_axis(query, axis, false);
+    bounds->upper[axis] = rtree->get_axis(query, axis, true);
+  }
+  return;
+}
+
+/**
+ * @brief Set the bounds of an entry of a node, read from the per-axis arrays
+ * of the node
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in] node Node
+ * @param[in] i Index of the entry
+ * @param[in] axes Axes to compare
+ * @param[out] bounds Bounds of the entry
+ */
+static void
+node_entry_bounds(const RTree *rtree, const RTreeNode *node, int i, int axes,
+  RTreeBounds *bounds)
+{
+  bounds->axes = axes;
+  for (int axis = 0; axis < rtree->dims; axis++)
+  {
+    if (! (axes & (1 << axis)))
+      continue;
+    bounds->lower[axis] = RTREE_NODE_LOWER(node, axis)[i];
+    bounds->upper[axis] = RTREE_NODE_UPPER(node, axis)[i];
+  }
+  return;
+}
+
+/**
+ * @brief Return the bit mask of the entries of a node that may be consistent
+ * with a search query
+ * @details The whole node is tested at once, one axis after the other, by the
+ * kernels scanning the per-axis arrays of the node. At leaf level this is a
+ * filter: the bounds are compared as closed intervals of doubles, and
+ * converting a bound to a double never reverses its order with another bound,
+ * so every entry satisfying the exact predicate of #leaf_consistent is in the
+ * mask, while an entry only touching the query at an exclusive bound may be
+ * too. At inner level this is the looser check used for pruning subtrees:
+ * overlap for @p RTREE_OVERLAPS and @p RTREE_CONTAINED_BY, containment of the
+ * query for @p RTREE_CONTAINS.
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in] node The node to be tested
+ * @param[in] query Bounds of the query
  * @param[in] op The search operation
  */
-static bool
-inner_consistent(const RTree *rtree, const void *key, const void *query,
-  RTreeSearchOp op)
+static uint64
+node_consistent_mask(const RTree *rtree, const RTreeNode *node,
+  const RTreeBounds *query, RTreeSearchOp op)
 {
-  switch (op)
+  uint64 result = RTREE_COUNT_MASK(node->count);
+  bool within = (op == RTREE_CONTAINED_BY && node->node_type == RTREE_LEAF);
+  for (int axis = 0; axis < rtree->dims && result; axis++)
   {
-    case RTREE_OVERLAPS:
-    case RTREE_CONTAINED_BY:
-      return rtree->bbox_overlaps(key, query);
-    case RTREE_CONTAINS:
-      return rtree->bbox_contains(key, query);
+    if (! (query->axes & (1 << axis)))
+      continue;
+    const double *lower = RTREE_NODE_LOWER(node, axis);
+    const double *upper = RTREE_NODE_UPPER(node, axis);
+    double qlower = query->lower[axis], qupper = query->upper[axis];
+    if (within)
+      result &= rtree_bounds_within(lower, upper, node->count, qlower, qupper);
+    else if (op == RTREE_CONTAINS)
+      result &= rtree_bounds_cover(lower, upper, node->count, qlower, qupper);
+    else
+      result &= rtree_bounds_cover(lower, upper, node->count, qupper, qlower);
   }
-  return false;
+  return result;
 }
 
 /**
  * @brief Searches recursively a node looking for hits with a query
+ * @details Only the entries in the mask of #node_consistent_mask are visited,
+ * and a leaf entry is reported after the exact test of #leaf_consistent
  * @param[in] rtree Pointer to the RTree structure
  * @param[in] node The node to be searched
  * @param[in] op The search operation (overlaps, contains, or contained by)
  * @param[in] query The bounding box that serves as query
+ * @param[in] bounds Bounds of the query
  * @param[out] result MeosArray to collect matching IDs
  */
 static void
 node_search(const RTree *rtree, const RTreeNode *node, RTreeSearchOp op,
-  const void *query, MeosArray *result)
+  const void *query, const RTreeBounds *bounds, MeosArray *result)
 {
-  for (int i = 0; i < node->count; ++i)
+  uint64 mask = node_consistent_mask(rtree, node, bounds, op);
+  while (mask)
   {
+    int i = pg_rightmost_one_pos64(mask);
+    mask &= mask - 1;
     if (node->node_type == RTREE_LEAF)
     {
       if (leaf_consistent(rtree, RTREE_NODE_BBOX_N(node, i), query, op))
@@ -840,49 +1060,66 @@ node_search(const RTree *rtree, const RTreeNode *node, RTreeSearchOp op,
       }
     }
     else
-    {
-      if (inner_consistent(rtree, RTREE_NODE_BBOX_N(node, i), query, op))
-        node_search(rtree, node->nodes[i], op, query, result);
-    }
+      node_search(rtree, RTREE_NODE_CHILD(rtree, node, i), op, query, bounds,
+        result);
   }
   return;
 }
 
+/**
+ * @brief Return the search operation with its two arguments swapped
+ */
+static inline RTreeSearchOp
+rtree_op_commute(RTreeSearchOp op)
+{
+  return (op == RTREE_CONTAINS) ? RTREE_CONTAINED_BY :
+    ((op == RTREE_CONTAINED_BY) ? RTREE_CONTAINS : op);
+}
+
 /**
  * @brief Report the qualifying entry pairs of two nodes, descending both trees
  * @details A node does not store its own bounding box, so each node is visited
- * together with the box its parent holds for it; the roots are visited with a
- * null box, which prunes nothing. Only one side descends at a time when the
- * other is a leaf: iterating a leaf's boxes and recursing with that same leaf
- * would visit its entries once per box.
+ * together with the bounds of the box its parent holds for it; the roots are
+ * visited with no bounds, which prunes nothing. Only one side descends at a
+ * time when the other is a leaf: iterating a leaf's boxes and recursing with
+ * that same leaf would visit its entries once per box.
  *
  * Subtrees are pruned by overlap whatever @p op is, since one entry contains or
  * is contained by another only if their boxes overlap, so a node pair whose
- * boxes are disjoint holds no qualifying pair below it.
+ * boxes are disjoint holds no qualifying pair below it. The pruning tests the
+ * entries of one node against one box of the other at once with
+ * #node_consistent_mask, so a pair of nodes is only visited once its boxes are
+ * known to overlap.
  * @param[in] rtree1,rtree2 The RTrees being joined
  * @param[in] node1,node2 The nodes to be joined
- * @param[in] box1,box2 The boxes the parents hold for @p node1 and @p node2,
- * `NULL` for a root
+ * @param[in] bounds1,bounds2 Bounds of the boxes the parents hold for
+ * @p node1 and @p node2, `NULL` for a root
+ * @param[in] axes Axes carried by every box of both trees
  * @param[in] op The join operation
  * @param[out] result MeosArray collecting the two ids of each pair
  */
 static void
-node_join(const RTree *rtree1, const RTreeNode *node1, const void *box1,
-  const RTree *rtree2, const RTreeNode *node2, const void *box2,
-  RTreeSearchOp op, MeosArray *result)
+node_join(const RTree *rtree1, const RTreeNode *node1,
+  const RTreeBounds *bounds1, const RTree *rtree2, const RTreeNode *node2,
+  const RTreeBounds *bounds2, int axes, RTreeSearchOp op, MeosArray *result)
 {
-  if (box1 && box2 && ! rtree1->bbox_overlaps(box1, box2))
-    return;
-
   bool leaf1 = (node1->node_type == RTREE_LEAF);
   bool leaf2 = (node2->node_type == RTREE_LEAF);
+  RTreeBounds entry1, entry2;
   if (leaf1 && leaf2)
   {
+    /* The entries of node2 are tested against each entry of node1 taken as
+     * query, hence the commuted operation */
+    RTreeSearchOp op2 = rtree_op_commute(op);
     for (int i = 0; i < node1->count; ++i)
     {
       const void *key = RTREE_NODE_BBOX_N(node1, i);
-      for (int j = 0; j < node2->count; ++j)
+      node_entry_bounds(rtree1, node1, i, axes, &entry1);
+      uint64 mask = node_consistent_mask(rtree2, node2, &entry1, op2);
+      while (mask)
       {
+        int j = pg_rightmost_one_pos64(mask);
+        mask &= mask - 1;
         if (leaf_consistent(rtree1, key, RTREE_NODE_BBOX_N(node2, j), op))
         {
           int64 id1 = node1->ids[i];
@@ -895,22 +1132,48 @@ node_join(const RTree *rtree1, const RTreeNode *node1, const void *box1,
   }
   else if (! leaf1 && leaf2)
   {
-    for (int i = 0; i < node1->count; ++i)
-      node_join(rtree1, node1->nodes[i], RTREE_NODE_BBOX_N(node1, i), rtree2,
-        node2, box2, op, result);
+    uint64 mask = bounds2 ?
+      node_consistent_mask(rtree1, node1, bounds2, RTREE_OVERLAPS) :
+      RTREE_COUNT_MASK(node1->count);
+    while (mask)
+    {
+      int i = pg_rightmost_one_pos64(mask);
+      mask &= mask - 1;
+      node_entry_bounds(rtree1, node1, i, axes, &entry1);
+      node_join(rtree1, RTREE_NODE_CHILD(rtree1, node1, i), &entry1, rtree2,
+        node2, bounds2, axes, op, result);
+    }
   }
   else if (leaf1 && ! leaf2)
   {
-    for (int j = 0; j < node2->count; ++j)
-      node_join(rtree1, node1, box1, rtree2, node2->nodes[j],
-        RTREE_NODE_BBOX_N(node2, j), op, result);
+    uint64 mask = bounds1 ?
+      node_consistent_mask(rtree2, node2, bounds1, RTREE_OVERLAPS) :
+      RTREE_COUNT_MASK(node2->count);
+    while (mask)
+    {
+      int j = pg_rightmost_one_pos64(mask);
+      mask &= mask - 1;
+      node_entry_bounds(rtree2, node2, j, axes, &entry2);
+      node_join(rtree1, node1, bounds1, rtree2,
+        RTREE_NODE_CHILD(rtree2, node2, j), &entry2, axes, op, result);
+    }
   }
   else
   {
     for (int i = 0; i < node1->count; ++i)
-      for (int j = 0; j < node2->count; ++j)
-        node_join(rtree1, node1->nodes[i], RTREE_NODE_BBOX_N(node1, i), rtree2,
-          node2->nodes[j], RTREE_NODE_BBOX_N(node2, j), op, result);
+    {
+      node_entry_bounds(rtree1, node1, i, axes, &entry1);
+      uint64 mask = node_consistent_mask(rtree2, node2, &entry1,
+        RTREE_OVERLAPS);
+      while (mask)
+      {
+        int j = pg_rightmost_one_pos64(mask);
+        mask &= mask - 1;
+        node_entry_bounds(rtree2, node2, j, axes, &entry2);
+        node_join(rtree1, RTREE_NODE_CHILD(rtree1, node1, i), &entry1, rtree2,
+          RTREE_NODE_CHILD(rtree2, node2, j), &entry2, axes, op, result);
+      }
+    }
   }
   return;
 }
@@ -970,6 +1233,8 @@ rtree_create(MeosType bboxtype)
   }
   rtree->bboxtype = bboxtype;
   rtree->bboxsize = bboxsize;
+  /* Narrowed to the axes carried by every box as the boxes are added */
+  rtree->axes = (1 << RTREE_MAX_AXES) - 1;
   return rtree;
 }
 
@@ -1066,29 +1331,229 @@ rtree_create_tpcbox()
 #endif
 
 /*****************************************************************************
- * STR bulk load (PROTOTYPE, for measurement)
+ * STR bulk load
+ *
+ * The loading can be split between several threads: the sort of a level is a
+ * parallel sort of runs followed by parallel merges, the slabs of a level are
+ * sorted and packed concurrently, and the boxes of the nodes of a level are
+ * computed concurrently. The items are sorted on the centre of their box
+ * and then on their position in the level, which is a total order, so the
+ * sorted order and hence the tree do not depend on the number of threads.
  *****************************************************************************/
 
+/* Minimum number of items of a sort split between threads */
+#define STR_PARALLEL_MIN_ITEMS 16384
+/* Number of nodes of a level whose boxes are computed by one task */
+#define STR_MBR_CHUNK 1024
+
+/**
+ * @brief Item packed into a node by the STR bulk load
+ */
 typedef struct
 {
-  void *box;          /**< bbox of the item (leaf: caller's; inner: owned MBR) */
+  void *box;          /**< bbox of the item (leaf: caller's; inner: MBR) */
   int64 id;           /**< leaf payload */
   RTreeNode *child;   /**< inner payload */
+  double key;         /**< Centre of the box along the axis being sorted */
+  int pos;            /**< Position of the item in its level */
 } STRItem;
 
-typedef struct { const RTree *tree; int axis; } STRCtx;
-
+/**
+ * @brief Comparison function of the STR items, on the centre of their box
+ * and then on their position
+ */
 static int
-str_cmp(const void *a, const void *b, void *arg)
+str_cmp(const void *a, const void *b)
 {
-  const STRCtx *c = (const STRCtx *) arg;
   const STRItem *ia = (const STRItem *) a;
   const STRItem *ib = (const STRItem *) b;
-  double ca = (c->tree->get_axis(ia->box, c->axis, false) +
-               c->tree->get_axis(ia->box, c->axis, true)) / 2.0;
-  double cb = (c->tree->get_axis(ib->box, c->axis, false) +
-               c->tree->get_axis(ib->box, c->axis, true)) / 2.0;
-  return (ca > cb) - (ca < cb);
+  if (ia->key < ib->key)
+    return -1;
+  if (ia->key > ib->key)
+    return 1;
+  return (ia->pos > ib->pos) - (ia->pos < ib->pos);
+}
+
+/**
+ * @brief Sort STR items along an axis on a single thread
+ */
+static void
+str_sort_items(const RTree *rtree, STRItem *items, int count, int axis)
+{
+  for (int i = 0; i < count; i++)
+    items[i].key = (rtree->get_axis(items[i].box, axis, false) +
+      rtree->get_axis(items[i].box, axis, true)) / 2.0;
+  qsort(items, (size_t) count, sizeof(STRItem), str_cmp);
+  return;
+}
+
+/**
+ * @brief State of a parallel sort of STR items
+ * @details The items are split into runs sorted concurrently, which are then
+ * merged pairwise, round after round, each merge being split into segments
+ * of its output merged concurrently
+ */
+typedef struct
+{
+  const RTree *rtree;
+  int axis;
+  STRItem *src;       /**< Sorted runs */
+  STRItem *dst;       /**< Output of the merge round */
+  int nruns;          /**< Number of runs in @p src */
+  int *bounds;        /**< Start of each run, followed by the item count */
+  int nsegs;          /**< Number of segments of a merge */
+} STRSort;
+
+/**
+ * @brief Sort a run of a parallel sort
+ */
+static void
+str_sort_run(void *arg, int run)
+{
+  STRSort *sort = (STRSort *) arg;
+  str_sort_items(sort->rtree, sort->src + sort->bounds[run],
+    sort->bounds[run + 1] - sort->bounds[run], sort->axis);
+  return;
+}
+
+/**
+ * @brief Return the number of items of the first of two sorted arrays among
+ * the first @p k items of their merge
+ */
+static int
+str_corank(int k, const STRItem *a, int m, const STRItem *b, int n)
+{
+  int lo = (k > n) ? k - n : 0;
+  int hi = (k < m) ? k : m;
+  while (lo < hi)
+  {
+    int i = (lo + hi) / 2;
+    if (str_cmp(&a[i], &b[k - i - 1]) < 0)
+      lo = i + 1;
+    else
+      hi = i;
+  }
+  return lo;
+}
+
+/**
+ * @brief Merge a segment of the output of the merge of two runs of a parallel
+ * sort, or copy a segment of a run left without a pair
+ */
+static void
+str_merge_segment(void *arg, int task)
+{
+  STRSort *sort = (STRSort *) arg;
+  int pair = task / sort->nsegs, seg = task % sort->nsegs;
+  int start = sort->bounds[2 * pair];
+  int mid = sort->bounds[2 * pair + 1];
+  int end = (2 * pair + 2 <= sort->nruns) ? sort->bounds[2 * pair + 2] : mid;
+  const STRItem *a = sort->src + start, *b = sort->src + mid;
+  int m = mid - start, n = end - mid;
+  int lo = (int) ((int64) (m + n) * seg / sort->nsegs);
+  int hi = (int) ((int64) (m + n) * (seg + 1) / sort->nsegs);
+  int i = str_corank(lo, a, m, b, n), iend = str_corank(hi, a, m, b, n);
+  int j = lo - i, jend = hi - iend;
+  STRItem *out = sort->dst + start + lo;
+  while (i < iend && j < jend)
+    *out++ = (str_cmp(&a[i], &b[j]) < 0) ? a[i++] : b[j++];
+  while (i < iend)
+    *out++ = a[i++];
+  while (j < jend)
+    *out++ = b[j++];
+  return;
+}
+
+/**
+ * @brief Sort STR items along an axis, splitting the work between threads
+ * @details The result is the one of #str_sort_items
+ */
+static void
+str_sort(const RTree *rtree, STRItem *items, int count, int axis, int nthreads)
+{
+  if (nthreads <= 1 || count < STR_PARALLEL_MIN_ITEMS)
+  {
+    str_sort_items(rtree, items, count, axis);
+    return;
+  }
+  STRSort sort;
+  sort.rtree = rtree;
+  sort.axis = axis;
+  sort.src = items;
+  sort.dst = palloc(sizeof(STRItem) * (size_t) count);
+  sort.nruns = nthreads;
+  sort.bounds = palloc(sizeof(int) * (nthreads + 1));
+  for (int r = 0; r <= sort.nruns; r++)
+    sort.bounds[r] = (int) ((int64) count * r / sort.nruns);
+  meos_parallel_for(nthreads, sort.nruns, str_sort_run, &sort);
+
+  STRItem *scratch = sort.dst;
+  while (sort.nruns > 1)
+  {
+    int npairs = (sort.nruns + 1) / 2;
+    sort.nsegs = (nthreads + npairs - 1) / npairs;
+    meos_parallel_for(nthreads, npairs * sort.nsegs, str_merge_segment,
+      &sort);
+    for (int r = 0; r < npairs; r++)
+      sort.bounds[r] = sort.bounds[2 * r];
+    sort.bounds[npairs] = count;
+    sort.nruns = npairs;
+    STRItem *tmp = sort.src; sort.src = sort.dst; sort.dst = tmp;
+  }
+  if (sort.src != items)
+    memcpy(items, sort.src, sizeof(STRItem) * (size_t) count);
+  pfree(scratch);
+  pfree(sort.bounds);
+  return;
+}
+
+/**
+ * @brief State of the packing of the slabs of a level of the STR bulk load
+ */
+typedef struct
+{
+  RTree *rtree;
+  STRItem *items;     /**< Items of the level sorted on the first axis */
+  int count;          /**< Number of items */
+  int slices;         /**< Number of nodes of a full slab */
+  bool leaf;          /**< True for the leaf level */
+  RTreeNode **out;    /**< Nodes of the level */
+} STRPack;
+
+/**
+ * @brief Sort a slab of a level on the second axis and pack it into nodes
+ * @details The nodes of slab `s` start at position `s * slices` of the level,
+ * as every slab but the last one fills exactly `slices` nodes
+ */
+static void
+str_pack_slab(void *arg, int slab)
+{
+  STRPack *pack = (STRPack *) arg;
+  RTree *rtree = pack->rtree;
+  int per_slice = pack->slices * MAXITEMS;
+  int s = slab * per_slice;
+  int slen = (pack->count - s < per_slice) ? pack->count - s : per_slice;
+  if (rtree->dims > 1)
+    str_sort_items(rtree, pack->items + s, slen, 1);
+  int nnodes = slab * pack->slices;
+  for (int p = 0; p < slen; p += MAXITEMS)
+  {
+    int plen = (slen - p < MAXITEMS) ? slen - p : MAXITEMS;
+    RTreeNode *node = node_make(rtree, pack->leaf ? RTREE_LEAF : RTREE_INNER);
+    for (int k = 0; k < plen; k++)
+    {
+      STRItem *it = &pack->items[s + p + k];
+      memcpy(RTREE_NODE_BBOX_N(node, k), it->box, rtree->bboxsize);
+      node_set_bounds(rtree, node, k);
+      if (pack->leaf)
+        node->ids[k] = it->id;
+      else
+        node->nodes[k] = it->child;
+    }
+    node->count = plen;
+    pack->out[nnodes++] = node;
+  }
+  return;
 }
 
 /**
@@ -1099,63 +1564,88 @@ str_cmp(const void *a, const void *b, void *arg)
  * union of its children, computed here whatever the ordering.
  */
 static RTreeNode **
-str_pack_level(RTree *rtree, STRItem *items, int count, bool leaf, int *nout)
+str_pack_level(RTree *rtree, STRItem *items, int count, bool leaf,
+  int nthreads, int *nout)
 {
   int pages = (count + MAXITEMS - 1) / MAXITEMS;
   int slices = (int) ceil(sqrt((double) pages));
   if (slices < 1) slices = 1;
   int per_slice = slices * MAXITEMS;
 
-  STRCtx ctx; ctx.tree = rtree; ctx.axis = 0;
-  qsort_arg(items, (size_t) count, sizeof(STRItem), str_cmp, &ctx);
+  for (int i = 0; i < count; i++)
+    items[i].pos = i;
+  str_sort(rtree, items, count, 0, nthreads);
+
+  STRPack pack;
+  pack.rtree = rtree;
+  pack.items = items;
+  pack.count = count;
+  pack.slices = slices;
+  pack.leaf = leaf;
+  pack.out = palloc(sizeof(RTreeNode *) * (size_t) pages);
+  meos_parallel_for(nthreads, (count + per_slice - 1) / per_slice,
+    str_pack_slab, &pack);
+  *nout = pages;
+  return pack.out;
+}
+
+/**
+ * @brief State of the computation of the boxes of the nodes of a level
+ */
+typedef struct
+{
+  const RTree *rtree;
+  RTreeNode **level;  /**< Nodes of the level */
+  int nnodes;         /**< Number of nodes */
+  STRItem *up;        /**< Items of the next level */
+  char *mbrs;         /**< Boxes of the items of the next level */
+} STRLevel;
 
-  RTreeNode **out = palloc(sizeof(RTreeNode *) * (size_t) pages);
-  int nnodes = 0;
-  for (int s = 0; s < count; s += per_slice)
+/**
+ * @brief Set the items of the next level for a chunk of nodes of a level
+ */
+static void
+str_level_chunk(void *arg, int chunk)
+{
+  STRLevel *lvl = (STRLevel *) arg;
+  const RTree *rtree = lvl->rtree;
+  int end = (chunk + 1) * STR_MBR_CHUNK;
+  if (end > lvl->nnodes)
+    end = lvl->nnodes;
+  for (int i = chunk * STR_MBR_CHUNK; i < end; i++)
   {
-    int slen = (count - s < per_slice) ? count - s : per_slice;
-    if (rtree->dims > 1)
-    {
-      ctx.axis = 1;
-      qsort_arg(items + s, (size_t) slen, sizeof(STRItem), str_cmp, &ctx);
-    }
-    for (int p = 0; p < slen; p += MAXITEMS)
-    {
-      int plen = (slen - p < MAXITEMS) ? slen - p : MAXITEMS;
-      RTreeNode *node = node_make(leaf ? RTREE_LEAF : RTREE_INNER, rtree->bboxsize);
-      for (int k = 0; k < plen; k++)
-      {
-        STRItem *it = &items[s + p + k];
-        memcpy(RTREE_NODE_BBOX_N(node, k), it->box, rtree->bboxsize);
-        if (leaf)
-          node->ids[k] = it->id;
-        else
-          node->nodes[k] = it->child;
-      }
-      node->count = plen;
-      out[nnodes++] = node;
-    }
+    void *mbr = lvl->mbrs + (size_t) i * rtree->bboxsize;
+    node_box_calculate(rtree, lvl->level[i], mbr);
+    lvl->up[i].box = mbr;
+    lvl->up[i].id = 0;
+    lvl->up[i].child = lvl->level[i];
   }
-  *nout = nnodes;
-  return out;
+  return;
 }
 
 /**
  * @ingroup meos_geo_box_index
- * @brief Build an RTree from all of its entries at once
+ * @brief Build an RTree from all of its entries at once, splitting the work
+ * between threads
  * @details Bottom-up Sort-Tile-Recursive packing. The result answers the same
  * queries as inserting every entry one by one, but the whole set is known in
  * advance, so nodes are filled to capacity and no node is ever split.
+ *
+ * The tree is the same whatever the number of threads, node by node.
  * @param[in] rtree An EMPTY RTree of the appropriate bounding box type
  * @param[in] boxes Contiguous array of @p count boxes of the tree bbox size
  * @param[in] ids The id of each box
  * @param[in] count Number of entries
+ * @param[in] nthreads Number of threads, where a value less than 1 requests
+ * one thread per online processor
  */
 void
-rtree_load(RTree *rtree, const void *boxes, const int64 *ids, int count)
+rtree_load_parallel(RTree *rtree, const void *boxes, const int64 *ids,
+  int count, int nthreads)
 {
-  if (count <= 0)
+  if (! ensure_rtree_writable(rtree) || count <= 0)
     return;
+  nthreads = meos_parallel_threads(nthreads);
 
   /* A box type whose dimension count depends on the data carries -1 until the
    * first box arrives, which for a tree grown by insertion is the first insert */
@@ -1168,76 +1658,109 @@ rtree_load(RTree *rtree, const void *boxes, const int64 *ids, int count)
     items[i].box = (void *) ((const char *) boxes + (size_t) i * rtree->bboxsize);
     items[i].id = ids[i];
     items[i].child = NULL;
+    rtree->axes &= rtree_box_axes(rtree, items[i].box);
   }
 
   int nnodes;
-  RTreeNode **level = str_pack_level(rtree, items, count, true, &nnodes);
+  RTreeNode **level = str_pack_level(rtree, items, count, true, nthreads,
+    &nnodes);
   pfree(items);
 
   while (nnodes > 1)
   {
-    STRItem *up = palloc(sizeof(STRItem) * (size_t) nnodes);
-    for (int i = 0; i < nnodes; i++)
-    {
-      void *mbr = palloc0(rtree->bboxsize);
-      memcpy(mbr, RTREE_NODE_BBOX_N(level[i], 0), rtree->bboxsize);
-      for (int k = 1; k < level[i]->count; k++)
-        rtree->bbox_expand(RTREE_NODE_BBOX_N(level[i], k), mbr);
-      up[i].box = mbr; up[i].id = 0; up[i].child = level[i];
-    }
-    int prev = nnodes;
-    RTreeNode **parents = str_pack_level(rtree, up, prev, false, &nnodes);
-    for (int i = 0; i < prev; i++)
-      pfree(up[i].box);
-    pfree(up); pfree(level);
+    STRLevel lvl;
+    lvl.rtree = rtree;
+    lvl.level = level;
+    lvl.nnodes = nnodes;
+    lvl.up = palloc(sizeof(STRItem) * (size_t) nnodes);
+    lvl.mbrs = palloc0(rtree->bboxsize * (size_t) nnodes);
+    meos_parallel_for(nthreads, (nnodes + STR_MBR_CHUNK - 1) / STR_MBR_CHUNK,
+      str_level_chunk, &lvl);
+    RTreeNode **parents = str_pack_level(rtree, lvl.up, nnodes, false,
+      nthreads, &nnodes);
+    pfree(lvl.mbrs); pfree(lvl.up); pfree(level);
     level = parents;
   }
 
   rtree->root = level[0];
-  memcpy(&rtree->box, RTREE_NODE_BBOX_N(level[0], 0), rtree->bboxsize);
-  for (int k = 1; k < level[0]->count; k++)
-    rtree->bbox_expand(RTREE_NODE_BBOX_N(level[0], k), &rtree->box);
+  node_box_calculate(rtree, level[0], rtree->box);
   pfree(level);
   return;
 }
 
-
 /**
  * @ingroup meos_geo_box_index
- * @brief Insert a bounding box into the RTree index.
- * @note The parameter `id` is used for the search function, when a match
- * is found the id will be returned. The bounding box will be copied into the
- * RTRee.
- * @param[in] rtree The RTree previously initialized
- * @param[in] box The bounding box to be inserted
- * @param[in] id The id of the box being inserted
+ * @brief Build an RTree from all of its entries at once
+ * @details Bottom-up Sort-Tile-Recursive packing on the calling thread, see
+ * #rtree_load_parallel
+ * @param[in] rtree An EMPTY RTree of the appropriate bounding box type
+ * @param[in] boxes Contiguous array of @p count boxes of the tree bbox size
+ * @param[in] ids The id of each box
+ * @param[in] count Number of entries
  */
 void
-rtree_insert(RTree *rtree, void *box, int64 id)
+rtree_load(RTree *rtree, const void *boxes, const int64 *ids, int count)
+{
+  rtree_load_parallel(rtree, boxes, ids, count, 1);
+  return;
+}
+
+/**
+ * @brief Return the height of an RTree, 0 when the root is a leaf
+ * @details All the leaves of an RTree are at the same depth
+ * @param[in] rtree Pointer to the RTree structure, whose root is not NULL
+ */
+static int
+rtree_height(const RTree *rtree)
+{
+  int result = 0;
+  for (const RTreeNode *node = rtree->root; node->node_type == RTREE_INNER;
+      node = node->nodes[0])
+    result++;
+  return result;
+}
+
+/**
+ * @brief Insert an entry into a node at a given height of an RTree, growing
+ * the tree by a new root whenever the root is split
+ * @param[in] rtree The RTree
+ * @param[in] box The bounding box of the entry
+ * @param[in] id The id of the entry when @p level is 0
+ * @param[in] child The subtree of the entry when @p level is greater than 0
+ * @param[in] level Height of the node receiving the entry, which must not
+ * exceed the height of the RTree
+ */
+static void
+rtree_insert_entry(RTree *rtree, void *box, int64 id, RTreeNode *child,
+  int level)
 {
   while (1)
   {
     if (! rtree->root)
     {
-      RTreeNode *new_root = node_make(RTREE_LEAF, rtree->bboxsize);
+      assert(level == 0);
       if (rtree->dims < 0)
         rtree->dims = 3 + MEOS_FLAGS_GET_Z(((STBox *) box)->flags);
-      rtree->root = new_root;
+      rtree->root = node_make(rtree, RTREE_LEAF);
       memcpy(rtree->box, box, rtree->bboxsize);
     }
+    rtree->axes &= rtree_box_axes(rtree, box);
     bool split = false;
-    node_insert(rtree, &rtree->box, rtree->root, box, id, &split);
+    node_insert(rtree, &rtree->box, rtree->root, rtree_height(rtree), box, id,
+      child, level, &split);
     if (! split)
     {
       rtree->bbox_expand(box, &rtree->box);
       return;
     }
-    RTreeNode *new_root = node_make(RTREE_INNER, rtree->bboxsize);
+    RTreeNode *new_root = node_make(rtree, RTREE_INNER);
     RTreeNode *right;
     node_split(rtree, rtree->root, &rtree->box, &right);
 
     node_box_calculate(rtree, rtree->root, RTREE_NODE_BBOX_N(new_root, 0));
     node_box_calculate(rtree, right, RTREE_NODE_BBOX_N(new_root, 1));
+    node_set_bounds(rtree, new_root, 0);
+    node_set_bounds(rtree, new_root, 1);
     new_root->nodes[0] = rtree->root;
     new_root->nodes[1] = right;
     rtree->root = new_root;
@@ -1248,32 +1771,252 @@ rtree_insert(RTree *rtree, void *box, int64 id)
 
 /**
  * @ingroup meos_geo_box_index
- * @brief Search an RTree with a bounding box, collecting matching IDs into
- * a MeosArray
- * @details The result array is reset before the search. After the call,
- * use the returned count and #meos_array_get to read the matching IDs.
- * The same array can be reused across multiple searches without reallocating.
- * @param[in] rtree The RTree to query
- * @param[in] op The search operation: @p RTREE_OVERLAPS finds boxes that
- * overlap the query, @p RTREE_CONTAINS finds boxes that contain the query,
- * @p RTREE_CONTAINED_BY finds boxes contained by the query
- * @param[in] query The bounding box that serves as query
- * @param[out] result MeosArray of int to collect matching IDs (created by the
- * caller with `meos_array_create(sizeof(int64))`)
- * @return Number of matching IDs
+ * @brief Insert a bounding box into the RTree index.
+ * @note The parameter `id` is used for the search function, when a match
+ * is found the id will be returned. The bounding box will be copied into the
+ * RTRee.
+ * @param[in] rtree The RTree previously initialized
+ * @param[in] box The bounding box to be inserted
+ * @param[in] id The id of the box being inserted
  */
-int
-rtree_search(const RTree *rtree, RTreeSearchOp op, const void *query,
-  MeosArray *result)
+void
+rtree_insert(RTree *rtree, void *box, int64 id)
 {
-  meos_array_reset(result);
-  if (rtree->root)
-    node_search(rtree, rtree->root, op, query, result);
-  return meos_array_count(result);
+  if (! ensure_rtree_writable(rtree))
+    return;
+  rtree_insert_entry(rtree, box, id, NULL, 0);
+  return;
 }
 
 /**
- * @ingroup meos_geo_box_index
+ * @brief Remove the entry at a given index of a node, moving the last entry
+ * of the node into its place
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in,out] node Node
+ * @param[in] index Index of the entry to remove
+ */
+static void
+node_remove_at(const RTree *rtree, RTreeNode *node, int index)
+{
+  int last = node->count - 1;
+  if (index != last)
+  {
+    memcpy(RTREE_NODE_BBOX_N(node, index), RTREE_NODE_BBOX_N(node, last),
+      rtree->bboxsize);
+    for (int axis = 0; axis < rtree->dims; axis++)
+    {
+      RTREE_NODE_LOWER(node, axis)[index] = RTREE_NODE_LOWER(node, axis)[last];
+      RTREE_NODE_UPPER(node, axis)[index] = RTREE_NODE_UPPER(node, axis)[last];
+    }
+    if (node->node_type == RTREE_LEAF)
+      node->ids[index] = node->ids[last];
+    else
+      node->nodes[index] = node->nodes[last];
+  }
+  node->count--;
+  return;
+}
+
+/**
+ * @brief Nodes dissolved while condensing an RTree after a deletion, whose
+ * entries must be inserted again
+ */
+typedef struct
+{
+  int count;                    /**< Number of nodes */
+  int maxcount;                 /**< Allocated number of nodes */
+  RTreeNode **nodes;            /**< Dissolved nodes */
+  int *heights;                 /**< Height of each dissolved node */
+} RTreeOrphans;
+
+/**
+ * @brief Delete an entry from the subtree of a node, condensing on the way up
+ * @details Only the children whose bounds cover the box are descended, as
+ * given by #node_consistent_mask. At leaf level the entry must have the id and
+ * be equal to the box. On the way up, a child left with fewer than `MINITEMS`
+ * entries is removed from the node and kept in @p orphans so that its entries
+ * are inserted again, otherwise the box of the child is shrunk to its entries.
+ * @param[in] rtree Pointer to the RTree structure
+ * @param[in,out] node Node
+ * @param[in] height Height of the node, 0 for a leaf
+ * @param[in] box The bounding box of the entry
+ * @param[in] bounds Bounds of the box
+ * @param[in] id The id of the entry
+ * @param[in,out] orphans Dissolved nodes
+ * @return True when the entry has been found and deleted
+ */
+static bool
+node_delete(const RTree *rtree, RTreeNode *node, int height, const void *box,
+  const RTreeBounds *bounds, int64 id, RTreeOrphans *orphans)
+{
+  uint64 mask = node_consistent_mask(rtree, node, bounds, RTREE_CONTAINS);
+  while (mask)
+  {
+    int i = pg_rightmost_one_pos64(mask);
+    mask &= mask - 1;
+    void *entry = RTREE_NODE_BBOX_N(node, i);
+    if (node->node_type == RTREE_LEAF)
+    {
+      if (node->ids[i] == id && rtree->bbox_contains(entry, box) &&
+          rtree->bbox_contains(box, entry))
+      {
+        node_remove_at(rtree, node, i);
+        return true;
+      }
+      continue;
+    }
+    RTreeNode *child = node->nodes[i];
+    if (! node_delete(rtree, child, height - 1, box, bounds, id, orphans))
+      continue;
+    if (child->count < MINITEMS)
+    {
+      if (orphans->count == orphans->maxcount)
+      {
+        orphans->maxcount *= 2;
+        orphans->nodes = repalloc(orphans->nodes,
+          sizeof(RTreeNode *) * orphans->maxcount);
+        orphans->heights = repalloc(orphans->heights,
+          sizeof(int) * orphans->maxcount);
+      }
+      orphans->nodes[orphans->count] = child;
+      orphans->heights[orphans->count++] = height - 1;
+      node_remove_at(rtree, node, i);
+    }
+    else
+    {
+      node_box_calculate(rtree, child, entry);
+      node_set_bounds(rtree, node, i);
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Delete an entry from the RTree index
+ * @details The entry must have been inserted with the id and a box equal to
+ * the given one. The tree is condensed as in Guttman's R-tree: the nodes left
+ * with fewer than `MINITEMS` entries are dissolved and their entries inserted
+ * again at their original height, and the root is removed while it has a
+ * single child, so the cost is logarithmic in the number of entries.
+ * @param[in] rtree The RTree
+ * @param[in] box The bounding box of the entry
+ * @param[in] id The id of the entry
+ * @return True when the entry has been found and deleted, false otherwise
+ */
+bool
+rtree_delete(RTree *rtree, const void *box, int64 id)
+{
+  if (! ensure_rtree_writable(rtree) || ! rtree->root)
+    return false;
+
+  RTreeBounds bounds;
+  rtree_query_bounds(rtree, box, &bounds);
+  RTreeOrphans orphans;
+  orphans.count = 0;
+  orphans.maxcount = 8;
+  orphans.nodes = palloc(sizeof(RTreeNode *) * orphans.maxcount);
+  orphans.heights = palloc(sizeof(int) * orphans.maxcount);
+  int height = rtree_height(rtree);
+  if (! node_delete(rtree, rtree->root, height, box, &bounds, id, &orphans))
+  {
+    pfree(orphans.nodes); pfree(orphans.heights);
+    return false;
+  }
+
+  /* Only a leaf root can be left without entries: an inner root has at least
+   * two children since the tree is shortened while it has a single one, and a
+   * deletion dissolves at most one of them. The tree is then empty and there
+   * are no orphans. */
+  if (rtree->root->count == 0)
+  {
+    assert(rtree->root->node_type == RTREE_LEAF && orphans.count == 0);
+    pfree(rtree->root);
+    rtree->root = NULL;
+    pfree(orphans.nodes); pfree(orphans.heights);
+    return true;
+  }
+  node_box_calculate(rtree, rtree->root, rtree->box);
+
+  /* Insert the entries of the orphans again, appended bottom-up, highest first
+   * so that the nodes receiving the entries of the lower ones exist */
+  for (int i = orphans.count - 1; i >= 0; i--)
+  {
+    RTreeNode *orphan = orphans.nodes[i];
+    for (int j = 0; j < orphan->count; j++)
+      rtree_insert_entry(rtree, RTREE_NODE_BBOX_N(orphan, j),
+        orphan->node_type == RTREE_LEAF ? orphan->ids[j] : 0,
+        orphan->node_type == RTREE_LEAF ? NULL : orphan->nodes[j],
+        orphans.heights[i]);
+    pfree(orphan);
+  }
+  pfree(orphans.nodes); pfree(orphans.heights);
+
+  /* Shorten the tree while the root has a single child */
+  while (rtree->root && rtree->root->node_type == RTREE_INNER &&
+      rtree->root->count == 1)
+  {
+    RTreeNode *child = rtree->root->nodes[0];
+    pfree(rtree->root);
+    rtree->root = child;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Move an entry of the RTree index to a new bounding box
+ * @details The entry is deleted with #rtree_delete and inserted again with the
+ * new box, so the tree stays balanced however far the entry moves
+ * @param[in] rtree The RTree
+ * @param[in] oldbox The bounding box the entry has been inserted with
+ * @param[in] newbox The new bounding box of the entry
+ * @param[in] id The id of the entry
+ * @return True when the entry has been found and moved, false otherwise, in
+ * which case the RTree is unchanged
+ */
+bool
+rtree_update(RTree *rtree, const void *oldbox, void *newbox, int64 id)
+{
+  if (! rtree_delete(rtree, oldbox, id))
+    return false;
+  rtree_insert(rtree, newbox, id);
+  return true;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Search an RTree with a bounding box, collecting matching IDs into
+ * a MeosArray
+ * @details The result array is reset before the search. After the call,
+ * use the returned count and #meos_array_get to read the matching IDs.
+ * The same array can be reused across multiple searches without reallocating.
+ * @param[in] rtree The RTree to query
+ * @param[in] op The search operation: @p RTREE_OVERLAPS finds boxes that
+ * overlap the query, @p RTREE_CONTAINS finds boxes that contain the query,
+ * @p RTREE_CONTAINED_BY finds boxes contained by the query
+ * @param[in] query The bounding box that serves as query
+ * @param[out] result MeosArray of int to collect matching IDs (created by the
+ * caller with `meos_array_create(sizeof(int64))`)
+ * @return Number of matching IDs
+ */
+int
+rtree_search(const RTree *rtree, RTreeSearchOp op, const void *query,
+  MeosArray *result)
+{
+  meos_array_reset(result);
+  if (rtree->root)
+  {
+    RTreeBounds bounds;
+    rtree_query_bounds(rtree, query, &bounds);
+    node_search(rtree, rtree->root, op, query, &bounds, result);
+  }
+  return meos_array_count(result);
+}
+
+/**
+ * @ingroup meos_geo_box_index
  * @brief Join two RTrees, collecting the ids of every qualifying pair into a
  * MeosArray
  * @details Descends both trees at once, skipping the entries of a subtree pair
@@ -1299,11 +2042,444 @@ rtree_join(const RTree *rtree1, const RTree *rtree2, RTreeSearchOp op,
   assert(rtree1->bboxtype == rtree2->bboxtype);
   meos_array_reset(result);
   if (rtree1->root && rtree2->root)
-    node_join(rtree1, rtree1->root, NULL, rtree2, rtree2->root, NULL, op,
-      result);
+    node_join(rtree1, rtree1->root, NULL, rtree2, rtree2->root, NULL,
+      rtree1->axes & rtree2->axes, op, result);
   return meos_array_count(result) / 2;
 }
 
+/*****************************************************************************
+ * Batched and parallel join
+ *****************************************************************************/
+
+/* Least number of node pairs per thread the top levels of a parallel join are
+ * expanded into, so that a thread done with its pairs finds others to claim
+ * while the slower threads are still descending theirs */
+#define RTREE_JOIN_PAIRS_PER_THREAD 4
+
+/**
+ * @brief A pair of nodes of two joined RTrees still to be visited
+ * @details As in #node_join, each node is visited with the bounds of the box
+ * its parent holds for it, and a root has none.
+ */
+typedef struct
+{
+  const RTreeNode *node1;     /**< Node of the first RTree */
+  const RTreeNode *node2;     /**< Node of the second RTree */
+  bool bounded1;              /**< True when @p bounds1 is set */
+  bool bounded2;              /**< True when @p bounds2 is set */
+  RTreeBounds bounds1;        /**< Bounds of the box held for @p node1 */
+  RTreeBounds bounds2;        /**< Bounds of the box held for @p node2 */
+} RTreeJoinPair;
+
+/**
+ * @brief Cursor over the qualifying pairs of the join of two RTrees
+ * @details The recursion of #node_join is replaced by an explicit stack of
+ * node pairs, and the pair of leaves being reported keeps the entry of the
+ * first leaf and the candidates of the second leaf not yet tested, so that the
+ * traversal stops once a batch is full and resumes where it stopped.
+ */
+struct RTreeJoinCursor
+{
+  const RTree *rtree1;        /**< First RTree (borrowed, not owned) */
+  const RTree *rtree2;        /**< Second RTree (borrowed, not owned) */
+  RTreeSearchOp op;           /**< Join operation */
+  int axes;                   /**< Axes carried by every box of both trees */
+  RTreeJoinPair *stack;       /**< Node pairs still to be visited */
+  int count;                  /**< Number of node pairs on the stack */
+  int capacity;               /**< Allocated capacity of the stack */
+  const RTreeNode *leaf1;     /**< First leaf of the pair being reported */
+  const RTreeNode *leaf2;     /**< Second leaf, @p NULL when there is none */
+  int entry;                  /**< Entry of @p leaf1 being tested */
+  uint64 mask;                /**< Candidates of @p leaf2 left for @p entry */
+};
+
+/**
+ * @brief Initialize a join cursor with an empty stack
+ */
+static void
+join_cursor_init(RTreeJoinCursor *cursor, const RTree *rtree1,
+  const RTree *rtree2, RTreeSearchOp op)
+{
+  cursor->rtree1 = rtree1;
+  cursor->rtree2 = rtree2;
+  cursor->op = op;
+  cursor->axes = rtree1->axes & rtree2->axes;
+  cursor->capacity = MAXITEMS;
+  cursor->stack = palloc(sizeof(RTreeJoinPair) * cursor->capacity);
+  cursor->count = 0;
+  cursor->leaf1 = cursor->leaf2 = NULL;
+  cursor->entry = 0;
+  cursor->mask = 0;
+  return;
+}
+
+/**
+ * @brief Push a node pair onto the stack of a join cursor, growing it if
+ * needed
+ * @param[in] cursor The cursor
+ * @param[in] node1,node2 The nodes of the pair
+ * @param[in] bounds1,bounds2 Bounds of the boxes held for the nodes, `NULL`
+ * for a root
+ */
+static void
+join_pair_push(RTreeJoinCursor *cursor, const RTreeNode *node1,
+  const RTreeBounds *bounds1, const RTreeNode *node2,
+  const RTreeBounds *bounds2)
+{
+  if (cursor->count == cursor->capacity)
+  {
+    cursor->capacity *= 2;
+    cursor->stack = repalloc(cursor->stack,
+      sizeof(RTreeJoinPair) * cursor->capacity);
+  }
+  RTreeJoinPair *pair = &cursor->stack[cursor->count++];
+  pair->node1 = node1;
+  pair->node2 = node2;
+  pair->bounded1 = (bounds1 != NULL);
+  pair->bounded2 = (bounds2 != NULL);
+  if (bounds1)
+    pair->bounds1 = *bounds1;
+  if (bounds2)
+    pair->bounds2 = *bounds2;
+  return;
+}
+
+/**
+ * @brief Push the child pairs of a node pair that is not a pair of leaves
+ * @details The pairs are pruned as in #node_join and pushed so that they are
+ * popped in the order in which #node_join visits them.
+ * @param[in] cursor The cursor
+ * @param[in] pair The node pair, which is not on the stack of the cursor
+ */
+static void
+join_pair_expand(RTreeJoinCursor *cursor, const RTreeJoinPair *pair)
+{
+  const RTree *rtree1 = cursor->rtree1, *rtree2 = cursor->rtree2;
+  const RTreeNode *node1 = pair->node1, *node2 = pair->node2;
+  const RTreeBounds *bounds1 = pair->bounded1 ? &pair->bounds1 : NULL;
+  const RTreeBounds *bounds2 = pair->bounded2 ? &pair->bounds2 : NULL;
+  bool leaf1 = (node1->node_type == RTREE_LEAF);
+  bool leaf2 = (node2->node_type == RTREE_LEAF);
+  int start = cursor->count;
+  RTreeBounds entry1, entry2;
+  assert(! leaf1 || ! leaf2);
+  if (! leaf1 && leaf2)
+  {
+    uint64 mask = bounds2 ?
+      node_consistent_mask(rtree1, node1, bounds2, RTREE_OVERLAPS) :
+      RTREE_COUNT_MASK(node1->count);
+    while (mask)
+    {
+      int i = pg_rightmost_one_pos64(mask);
+      mask &= mask - 1;
+      node_entry_bounds(rtree1, node1, i, cursor->axes, &entry1);
+      join_pair_push(cursor, RTREE_NODE_CHILD(rtree1, node1, i), &entry1,
+        node2, bounds2);
+    }
+  }
+  else if (leaf1 && ! leaf2)
+  {
+    uint64 mask = bounds1 ?
+      node_consistent_mask(rtree2, node2, bounds1, RTREE_OVERLAPS) :
+      RTREE_COUNT_MASK(node2->count);
+    while (mask)
+    {
+      int j = pg_rightmost_one_pos64(mask);
+      mask &= mask - 1;
+      node_entry_bounds(rtree2, node2, j, cursor->axes, &entry2);
+      join_pair_push(cursor, node1, bounds1,
+        RTREE_NODE_CHILD(rtree2, node2, j), &entry2);
+    }
+  }
+  else
+  {
+    for (int i = 0; i < node1->count; ++i)
+    {
+      node_entry_bounds(rtree1, node1, i, cursor->axes, &entry1);
+      uint64 mask = node_consistent_mask(rtree2, node2, &entry1,
+        RTREE_OVERLAPS);
+      while (mask)
+      {
+        int j = pg_rightmost_one_pos64(mask);
+        mask &= mask - 1;
+        node_entry_bounds(rtree2, node2, j, cursor->axes, &entry2);
+        join_pair_push(cursor, RTREE_NODE_CHILD(rtree1, node1, i), &entry1,
+          RTREE_NODE_CHILD(rtree2, node2, j), &entry2);
+      }
+    }
+  }
+  /* Reverse the pushed pairs so that the first one is on top */
+  for (int lo = start, hi = cursor->count - 1; lo < hi; lo++, hi--)
+  {
+    RTreeJoinPair tmp = cursor->stack[lo];
+    cursor->stack[lo] = cursor->stack[hi];
+    cursor->stack[hi] = tmp;
+  }
+  return;
+}
+
+/**
+ * @brief Report the next qualifying pairs of a join cursor into an array
+ * @details Shared by #rtree_join_cursor_next and the tasks of
+ * #rtree_join_parallel; the array is not reset
+ * @return Number of pairs reported, which is less than @p maxpairs only when
+ * the join is exhausted
+ */
+static int
+join_cursor_fill(RTreeJoinCursor *cursor, int maxpairs, MeosArray *result)
+{
+  const RTree *rtree1 = cursor->rtree1, *rtree2 = cursor->rtree2;
+  /* The entries of the second leaf are tested against each entry of the first
+   * leaf taken as query, hence the commuted operation */
+  RTreeSearchOp op2 = rtree_op_commute(cursor->op);
+  int n = 0;
+  while (n < maxpairs)
+  {
+    if (cursor->leaf2)
+    {
+      const RTreeNode *node1 = cursor->leaf1, *node2 = cursor->leaf2;
+      while (n < maxpairs)
+      {
+        if (! cursor->mask)
+        {
+          if (++cursor->entry >= node1->count)
+          {
+            cursor->leaf2 = NULL;
+            break;
+          }
+          RTreeBounds entry1;
+          node_entry_bounds(rtree1, node1, cursor->entry, cursor->axes,
+            &entry1);
+          cursor->mask = node_consistent_mask(rtree2, node2, &entry1, op2);
+          continue;
+        }
+        int j = pg_rightmost_one_pos64(cursor->mask);
+        cursor->mask &= cursor->mask - 1;
+        if (leaf_consistent(rtree1, RTREE_NODE_BBOX_N(node1, cursor->entry),
+            RTREE_NODE_BBOX_N(node2, j), cursor->op))
+        {
+          int64 id1 = node1->ids[cursor->entry];
+          int64 id2 = node2->ids[j];
+          meos_array_add(result, &id1);
+          meos_array_add(result, &id2);
+          n++;
+        }
+      }
+      continue;
+    }
+    if (cursor->count == 0)
+      break;
+    RTreeJoinPair pair = cursor->stack[--cursor->count];
+    if (pair.node1->node_type == RTREE_LEAF &&
+        pair.node2->node_type == RTREE_LEAF)
+    {
+      cursor->leaf1 = pair.node1;
+      cursor->leaf2 = pair.node2;
+      cursor->entry = -1;
+      cursor->mask = 0;
+    }
+    else
+      join_pair_expand(cursor, &pair);
+  }
+  return n;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Open a cursor that yields the qualifying pairs of the join of two
+ * RTrees in batches
+ * @details The cursor reports the pairs of #rtree_join, in the same order, but
+ * a call to #rtree_join_cursor_next stops once it has a batch of pairs and the
+ * next call resumes the traversal where it stopped. A join whose answer does
+ * not fit in memory, or whose pairs are refined as they come, is thus read
+ * with a memory bounded by the batch size and the height of the trees. The
+ * trees must not be modified while the cursor is open. Close the cursor with
+ * #rtree_join_cursor_close.
+ * @param[in] rtree1,rtree2 The RTrees to join, of the same bounding box type
+ * @param[in] op The join operation, as for #rtree_join
+ * @return A cursor to be freed with #rtree_join_cursor_close
+ */
+RTreeJoinCursor *
+rtree_join_cursor_open(const RTree *rtree1, const RTree *rtree2,
+  RTreeSearchOp op)
+{
+  assert(rtree1); assert(rtree2);
+  assert(rtree1->bboxtype == rtree2->bboxtype);
+  RTreeJoinCursor *cursor = palloc(sizeof(RTreeJoinCursor));
+  join_cursor_init(cursor, rtree1, rtree2, op);
+  if (rtree1->root && rtree2->root)
+    join_pair_push(cursor, rtree1->root, NULL, rtree2->root, NULL);
+  return cursor;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Collect the next batch of qualifying pairs of a join cursor into a
+ * MeosArray
+ * @details The result array is reset and receives two ids per pair, as for
+ * #rtree_join.
+ * @param[in] cursor The cursor previously opened with #rtree_join_cursor_open
+ * @param[in] maxpairs Maximum number of pairs of the batch
+ * @param[out] result MeosArray of int64 to collect the ids
+ * @return Number of pairs of the batch, 0 once the join is exhausted, -1 on
+ * error
+ */
+int
+rtree_join_cursor_next(RTreeJoinCursor *cursor, int maxpairs,
+  MeosArray *result)
+{
+  assert(cursor); assert(result);
+  if (! ensure_positive(maxpairs))
+    return -1;
+  meos_array_reset(result);
+  return join_cursor_fill(cursor, maxpairs, result);
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Close a join cursor and free its resources
+ * @param[in] cursor The cursor to close; @p NULL is ignored
+ */
+void
+rtree_join_cursor_close(RTreeJoinCursor *cursor)
+{
+  if (! cursor)
+    return;
+  pfree(cursor->stack);
+  pfree(cursor);
+  return;
+}
+
+/**
+ * @brief Shared state of the tasks of a parallel join, each of which joins
+ * one of the node pairs the top levels of the trees were expanded into
+ */
+typedef struct
+{
+  const RTree *rtree1;        /**< First RTree */
+  const RTree *rtree2;        /**< Second RTree */
+  RTreeSearchOp op;           /**< Join operation */
+  const RTreeJoinPair *pairs; /**< Node pair of each task */
+  int batchsize;              /**< Maximum number of pairs of a batch */
+  rtree_join_fn fn;           /**< Function consuming the batches */
+  void *arg;                  /**< Argument passed to @p fn */
+  int64 npairs;               /**< Number of pairs passed to @p fn */
+  bool stop;                  /**< Set once @p fn asked to stop */
+} RTreeJoinTasks;
+
+/**
+ * @brief Join the node pair of a task of a parallel join, passing its
+ * qualifying pairs to the consuming function batch by batch
+ */
+static void
+join_task(void *arg, int task)
+{
+  RTreeJoinTasks *tasks = (RTreeJoinTasks *) arg;
+  if (__atomic_load_n(&tasks->stop, __ATOMIC_ACQUIRE))
+    return;
+  RTreeJoinCursor cursor;
+  join_cursor_init(&cursor, tasks->rtree1, tasks->rtree2, tasks->op);
+  cursor.stack[cursor.count++] = tasks->pairs[task];
+  MeosArray *batch = meos_array_create(sizeof(int64));
+  int n;
+  while ((n = join_cursor_fill(&cursor, tasks->batchsize, batch)) > 0)
+  {
+    __atomic_add_fetch(&tasks->npairs, n, __ATOMIC_RELAXED);
+    if (! tasks->fn(tasks->arg, (const int64 *) meos_array_get(batch, 0), n))
+      __atomic_store_n(&tasks->stop, true, __ATOMIC_RELEASE);
+    if (n < tasks->batchsize ||
+        __atomic_load_n(&tasks->stop, __ATOMIC_ACQUIRE))
+      break;
+    meos_array_reset(batch);
+  }
+  meos_array_destroy(batch);
+  pfree(cursor.stack);
+  return;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Join two RTrees with several threads, passing the qualifying pairs
+ * to a function batch by batch
+ * @details The top levels of the two trees are expanded into the node pairs
+ * whose boxes overlap until there are several pairs per thread, and each pair
+ * is then joined by the first thread free to claim it, so that a thread done
+ * with a sparse region of the trees takes over pairs left by the others.
+ *
+ * The pairs of a task are passed to @p fn as soon as a batch of @p batchsize
+ * pairs is full, so the refinement of the candidate pairs runs in the worker
+ * threads while the traversal of the trees goes on. A batch is an array of
+ * `2 * count` ids, the entry of @p rtree1 followed by the entry of @p rtree2
+ * for each pair, valid only for the duration of the call. The function is
+ * called concurrently from several threads and must be safe for it; when it
+ * returns false no further batch is passed to it. The set of pairs passed is
+ * the one of #rtree_join, but the batches arrive in no particular order.
+ * @param[in] rtree1,rtree2 The RTrees to join, of the same bounding box type
+ * @param[in] op The join operation, as for #rtree_join
+ * @param[in] nthreads Number of threads, a value less than 1 meaning as many
+ * as there are processors online
+ * @param[in] batchsize Maximum number of pairs of a batch
+ * @param[in] fn Function consuming the batches
+ * @param[in] arg Argument passed to @p fn
+ * @return Number of pairs passed to @p fn, -1 on error
+ */
+int64
+rtree_join_parallel(const RTree *rtree1, const RTree *rtree2,
+  RTreeSearchOp op, int nthreads, int batchsize, rtree_join_fn fn, void *arg)
+{
+  assert(rtree1); assert(rtree2); assert(fn);
+  assert(rtree1->bboxtype == rtree2->bboxtype);
+  if (! ensure_positive(batchsize))
+    return -1;
+  if (! rtree1->root || ! rtree2->root)
+    return 0;
+  nthreads = meos_parallel_threads(nthreads);
+
+  /* Expand the node pairs one level at a time, keeping the pairs of leaves,
+   * until there are enough of them to balance the threads */
+  RTreeJoinCursor level;
+  join_cursor_init(&level, rtree1, rtree2, op);
+  join_pair_push(&level, rtree1->root, NULL, rtree2->root, NULL);
+  bool expanded = true;
+  while (expanded && level.count > 0 &&
+    level.count < nthreads * RTREE_JOIN_PAIRS_PER_THREAD)
+  {
+    RTreeJoinPair *pairs = level.stack;
+    int npairs = level.count;
+    level.stack = palloc(sizeof(RTreeJoinPair) * level.capacity);
+    level.count = 0;
+    expanded = false;
+    for (int k = 0; k < npairs; k++)
+    {
+      if (pairs[k].node1->node_type == RTREE_LEAF &&
+          pairs[k].node2->node_type == RTREE_LEAF)
+        join_pair_push(&level, pairs[k].node1,
+          pairs[k].bounded1 ? &pairs[k].bounds1 : NULL, pairs[k].node2,
+          pairs[k].bounded2 ? &pairs[k].bounds2 : NULL);
+      else
+      {
+        join_pair_expand(&level, &pairs[k]);
+        expanded = true;
+      }
+    }
+    pfree(pairs);
+  }
+
+  RTreeJoinTasks tasks;
+  tasks.rtree1 = rtree1;
+  tasks.rtree2 = rtree2;
+  tasks.op = op;
+  tasks.pairs = level.stack;
+  tasks.batchsize = batchsize;
+  tasks.fn = fn;
+  tasks.arg = arg;
+  tasks.npairs = 0;
+  tasks.stop = false;
+  meos_parallel_for(nthreads, level.count, join_task, &tasks);
+  pfree(level.stack);
+  return tasks.npairs;
+}
+
 /**
  * @ingroup meos_temporal_box_index
  * @brief Insert a temporal value into the RTree index
@@ -1573,6 +2749,8 @@ struct RTreeNNCursor
 {
   const RTree *rtree;      /**< Indexed RTree (borrowed, not owned) */
   void *query;            /**< Private copy of the query bounding box */
+  RTreeBounds bounds;     /**< Bounds of the query along the time axis */
+  double far;             /**< Distance of an entry disjoint in time */
   RTreeNNEntry *heap;     /**< Binary min-heap keyed by distance */
   int count;              /**< Number of entries currently in the heap */
   int capacity;           /**< Allocated capacity of the heap array */
@@ -1641,17 +2819,66 @@ nn_heap_pop(RTreeNNCursor *cursor)
 }
 
 /**
- * @ingroup meos_geo_box_index
- * @brief Open a nearest-neighbour cursor that yields the ids stored in an
- * RTree in order of increasing distance to a query bounding box
- * @details The cursor performs an incremental best-first traversal: repeated
- * calls to #rtree_nn_cursor_next return the indexed ids from nearest to
- * farthest, using the same box-to-box distance as the `|=|` operator. The
- * caller stops consuming when it has enough neighbours (e.g. after `k`
- * results), so no more of the tree is visited than required. The query box is
- * copied into the cursor, so the caller may free or reuse it immediately. The
- * query box must have the same box type as the RTree; a spatial-only query on
- * an STBox index yields a purely spatial ordering, while a query carrying a
+ * @brief Set the query of a nearest-neighbour cursor and empty its heap
+ * @details The heap keeps its capacity, so that a cursor answering one query
+ * after another allocates nothing once it has grown
+ * @param[in] cursor The cursor
+ * @param[in] query The query bounding box, copied into the cursor
+ */
+static void
+nn_cursor_reset(RTreeNNCursor *cursor, const void *query)
+{
+  const RTree *rtree = cursor->rtree;
+  memcpy(cursor->query, query, rtree->bboxsize);
+  cursor->count = 0;
+  /* An entry whose time extent is disjoint from the one of the query is at
+   * the distance the box distance answers for it, which is known in advance,
+   * so only the time axis of the query is kept for the test of the entries */
+  cursor->bounds.axes = 0;
+  cursor->far = DBL_MAX;
+  if (rtree->root && (rtree->bboxtype == T_TBOX || rtree->bboxtype == T_STBOX
+#if POINTCLOUD
+      || rtree->bboxtype == T_TPCBOX
+#endif
+      ))
+  {
+    int taxis = (rtree->bboxtype == T_TBOX) ? 1 : 2;
+    rtree_query_bounds(rtree, query, &cursor->bounds);
+    cursor->bounds.axes &= (1 << taxis);
+    if (rtree->bboxtype == T_TBOX)
+    {
+      MeosType basetype = ((const TBox *) query)->span.basetype;
+      cursor->far = distance_double(distance_sentinel(basetype), basetype);
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return the mask of the entries of a node sharing an instant with the
+ * query of a nearest-neighbour cursor, the others being at the distance of a
+ * disjoint time extent
+ */
+static inline uint64
+nn_node_near(const RTreeNNCursor *cursor, const RTreeNode *node)
+{
+  return cursor->bounds.axes ?
+    node_consistent_mask(cursor->rtree, node, &cursor->bounds,
+      RTREE_OVERLAPS) : RTREE_COUNT_MASK(node->count);
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Open a nearest-neighbour cursor that yields the ids stored in an
+ * RTree in order of increasing distance to a query bounding box
+ * @details The cursor performs an incremental best-first traversal: repeated
+ * calls to #rtree_nn_cursor_next return the indexed ids from nearest to
+ * farthest, using the same box-to-box distance as the `|=|` operator. The
+ * caller stops consuming when it has enough neighbours (e.g. after `k`
+ * results), so no more of the tree is visited than required. The query box is
+ * copied into the cursor, so the caller may free or reuse it immediately. The
+ * query box must have the same box type as the RTree; a spatial-only query on
+ * an STBox index yields a purely spatial ordering, while a query carrying a
  * time dimension additionally requires overlapping time extents (as for
  * `|=|`). Close the cursor with #rtree_nn_cursor_close.
  * @param[in] rtree The RTree to query
@@ -1665,10 +2892,9 @@ rtree_nn_cursor_open(const RTree *rtree, const void *query)
   RTreeNNCursor *cursor = palloc0(sizeof(RTreeNNCursor));
   cursor->rtree = rtree;
   cursor->query = palloc(rtree->bboxsize);
-  memcpy(cursor->query, query, rtree->bboxsize);
   cursor->capacity = MAXITEMS;
   cursor->heap = palloc((size_t) cursor->capacity * sizeof(RTreeNNEntry));
-  cursor->count = 0;
+  nn_cursor_reset(cursor, query);
   /* Seed the heap with the root, which is always expanded first */
   if (rtree->root)
   {
@@ -1711,13 +2937,18 @@ rtree_nn_cursor_next(RTreeNNCursor *cursor, int64 *id_out, double *dist_out)
         *dist_out = entry.dist;
       return true;
     }
-    /* Expand the node: push every child keyed by its box distance */
+    /* Expand the node: push every child keyed by its box distance. The
+     * children sharing no instant with the query, tested for the whole node
+     * at once, are at the distance of a disjoint time extent, so the box
+     * distance is only computed for the others */
     const RTreeNode *node = entry.node;
+    uint64 near = nn_node_near(cursor, node);
     for (int i = 0; i < node->count; i++)
     {
       RTreeNNEntry child;
-      child.dist = rtree_bbox_distance(cursor->rtree, cursor->query,
-        RTREE_NODE_BBOX_N(node, i));
+      child.dist = (near & (UINT64CONST(1) << i)) ?
+        rtree_bbox_distance(cursor->rtree, cursor->query,
+          RTREE_NODE_BBOX_N(node, i)) : cursor->far;
       if (node->node_type == RTREE_LEAF)
       {
         child.is_leaf_entry = true;
@@ -1728,7 +2959,7 @@ rtree_nn_cursor_next(RTreeNNCursor *cursor, int64 *id_out, double *dist_out)
       {
         child.is_leaf_entry = false;
         child.id = 0;
-        child.node = node->nodes[i];
+        child.node = RTREE_NODE_CHILD(cursor->rtree, node, i);
       }
       nn_heap_push(cursor, child);
     }
@@ -1752,6 +2983,536 @@ rtree_nn_cursor_close(RTreeNNCursor *cursor)
   return;
 }
 
+/*****************************************************************************
+ * Batched nearest-neighbour queries
+ *
+ * A batch is answered by tasks each taking a run of queries in an order that
+ * keeps nearby queries together, so that the neighbours of a query, which are
+ * close to the next one, bound the search of the next query from the start:
+ * the subtrees farther than the k-th of them are then never entered, and the
+ * upper levels visited by the previous query are mostly the only ones visited
+ * again. Each task reuses one heap of nodes and one set of neighbours for all
+ * its queries.
+ *****************************************************************************/
+
+/**
+ * @brief A query of a batch with its position along the order of the batch
+ */
+typedef struct
+{
+  uint64 key;           /**< Position of the query along a Z-order curve */
+  int pos;              /**< Position of the query in the batch */
+} IndexQueryKey;
+
+/**
+ * @brief Comparison function for the keys of the queries of a batch, ties
+ * being broken by position so that the order does not depend on the sort
+ */
+static int
+index_query_key_cmp(const void *a, const void *b)
+{
+  const IndexQueryKey *ka = (const IndexQueryKey *) a;
+  const IndexQueryKey *kb = (const IndexQueryKey *) b;
+  if (ka->key != kb->key)
+    return (ka->key < kb->key) ? -1 : 1;
+  return ka->pos - kb->pos;
+}
+
+/**
+ * @brief Return the center of a query box along its first two dimensions
+ * @details The dimensions are the value and time for a TBox and the X and Y
+ * coordinates for an STBox, or the time when the box has no space dimension
+ */
+static void
+index_query_center(MeosType bboxtype, const void *box, double *x, double *y)
+{
+  double (*get_axis)(const void *, int, bool);
+  int axis1 = 0, axis2 = 1;
+  bool has1 = true, has2 = true;
+  if (span_type(bboxtype))
+  {
+    get_axis = &get_axis_span;
+    has2 = false;
+  }
+  else if (bboxtype == T_TBOX)
+  {
+    const TBox *tbox = (const TBox *) box;
+    get_axis = &get_axis_tbox;
+    has1 = MEOS_FLAGS_GET_X(tbox->flags);
+    has2 = MEOS_FLAGS_GET_T(tbox->flags);
+  }
+  else /* bboxtype == T_STBOX || bboxtype == T_TPCBOX */
+  {
+    /* A TPCBox shares the STBox prefix layout (see get_axis_tpcbox) */
+    const STBox *stbox = (const STBox *) box;
+    get_axis = &get_axis_stbox;
+    if (! MEOS_FLAGS_GET_X(stbox->flags))
+    {
+      axis1 = 2;
+      has1 = MEOS_FLAGS_GET_T(stbox->flags);
+      has2 = false;
+    }
+  }
+  /* Halving each bound first keeps the sum of two large bounds finite */
+  *x = has1 ? get_axis(box, axis1, false) / 2 + get_axis(box, axis1, true) / 2 :
+    0.0;
+  *y = has2 ? get_axis(box, axis2, false) / 2 + get_axis(box, axis2, true) / 2 :
+    0.0;
+  return;
+}
+
+/**
+ * @brief Return a value of [0, 1] scaled to a 32-bit integer with its bits
+ * spread to the even positions of a 64-bit integer
+ */
+static uint64
+index_query_spread(double value)
+{
+  uint64 v = (value > 0.0) ?
+    ((value < 1.0) ? (uint64) (value * (double) UINT32_MAX) : UINT32_MAX) : 0;
+  v = (v | (v << 16)) & UINT64CONST(0x0000FFFF0000FFFF);
+  v = (v | (v << 8)) & UINT64CONST(0x00FF00FF00FF00FF);
+  v = (v | (v << 4)) & UINT64CONST(0x0F0F0F0F0F0F0F0F);
+  v = (v | (v << 2)) & UINT64CONST(0x3333333333333333);
+  v = (v | (v << 1)) & UINT64CONST(0x5555555555555555);
+  return v;
+}
+
+/**
+ * @brief Return the positions of the queries of a batch in the order of a
+ * Z-order curve over the centers of the queries
+ * @param[in] bboxtype Type of the query boxes
+ * @param[in] queries Array of query boxes
+ * @param[in] stride Size of a query box in the array
+ * @param[in] count Number of query boxes
+ * @return Array of @p count positions, to be freed by the caller
+ */
+int *
+index_query_order(MeosType bboxtype, const void *queries, size_t stride,
+  int count)
+{
+  double *centers = palloc(sizeof(double) * 2 * (size_t) count);
+  double min[2] = {DBL_MAX, DBL_MAX}, max[2] = {-DBL_MAX, -DBL_MAX};
+  for (int i = 0; i < count; i++)
+  {
+    double *c = &centers[2 * i];
+    index_query_center(bboxtype, (const char *) queries + (size_t) i * stride,
+      &c[0], &c[1]);
+    for (int d = 0; d < 2; d++)
+    {
+      min[d] = Min(min[d], c[d]);
+      max[d] = Max(max[d], c[d]);
+    }
+  }
+  IndexQueryKey *keys = palloc(sizeof(IndexQueryKey) * (size_t) count);
+  for (int i = 0; i < count; i++)
+  {
+    double *c = &centers[2 * i];
+    uint64 key = 0;
+    for (int d = 0; d < 2; d++)
+    {
+      double extent = max[d] - min[d];
+      if (extent > 0.0 && isfinite(extent))
+        key |= index_query_spread((c[d] - min[d]) / extent) << d;
+    }
+    keys[i].key = key;
+    keys[i].pos = i;
+  }
+  qsort(keys, (size_t) count, sizeof(IndexQueryKey), &index_query_key_cmp);
+  int *result = palloc(sizeof(int) * (size_t) count);
+  for (int i = 0; i < count; i++)
+    result[i] = keys[i].pos;
+  pfree(centers); pfree(keys);
+  return result;
+}
+
+/**
+ * @brief Initialize an empty set of nearest neighbours
+ * @param[out] knn The set
+ * @param[in] k Number of neighbours per query
+ */
+void
+index_knn_init(IndexKNN *knn, int k)
+{
+  knn->k = k;
+  knn->count = knn->nseeds = 0;
+  knn->heap = palloc(sizeof(IndexNeighbor) * (size_t) k);
+  knn->seeds = palloc(sizeof(IndexNeighbor) * (size_t) k);
+  return;
+}
+
+/**
+ * @brief Free the arrays of a set of nearest neighbours
+ */
+void
+index_knn_free(IndexKNN *knn)
+{
+  pfree(knn->heap); pfree(knn->seeds);
+  return;
+}
+
+/**
+ * @brief Start the next query, keeping the neighbours of the previous one as
+ * seeds
+ */
+void
+index_knn_restart(IndexKNN *knn)
+{
+  IndexNeighbor *seeds = knn->seeds;
+  knn->seeds = knn->heap;
+  knn->nseeds = knn->count;
+  knn->heap = seeds;
+  knn->count = 0;
+  return;
+}
+
+/**
+ * @brief Return true if a box is one of the seeds, which were offered before
+ * the search started and must not be offered again when the search meets it
+ */
+bool
+index_knn_seeded(const IndexKNN *knn, const void *box)
+{
+  for (int i = 0; i < knn->nseeds; i++)
+    if (knn->seeds[i].box == box)
+      return true;
+  return false;
+}
+
+/**
+ * @brief Offer a box at a distance to the set of nearest neighbours, which
+ * keeps it if it is nearer than the k-th found so far
+ */
+void
+index_knn_offer(IndexKNN *knn, int64 id, double dist, const void *box)
+{
+  IndexNeighbor *heap = knn->heap;
+  int i;
+  if (knn->count < knn->k)
+  {
+    /* Sift up while the parent is nearer */
+    i = knn->count++;
+    while (i > 0 && heap[(i - 1) / 2].dist < dist)
+    {
+      heap[i] = heap[(i - 1) / 2];
+      i = (i - 1) / 2;
+    }
+  }
+  else
+  {
+    if (dist >= heap[0].dist)
+      return;
+    /* Replace the farthest and sift down towards the farther child */
+    i = 0;
+    while (true)
+    {
+      int child = 2 * i + 1;
+      if (child >= knn->count)
+        break;
+      if (child + 1 < knn->count && heap[child + 1].dist > heap[child].dist)
+        child++;
+      if (heap[child].dist <= dist)
+        break;
+      heap[i] = heap[child];
+      i = child;
+    }
+  }
+  heap[i].dist = dist;
+  heap[i].id = id;
+  heap[i].box = box;
+  return;
+}
+
+/**
+ * @brief Comparison function for neighbours by distance and then by id
+ */
+static int
+index_neighbor_cmp(const void *a, const void *b)
+{
+  const IndexNeighbor *na = (const IndexNeighbor *) a;
+  const IndexNeighbor *nb = (const IndexNeighbor *) b;
+  if (na->dist != nb->dist)
+    return (na->dist < nb->dist) ? -1 : 1;
+  return (na->id > nb->id) - (na->id < nb->id);
+}
+
+/**
+ * @brief Write the nearest neighbours of a query in order of increasing
+ * distance, the slots beyond those found having id -1 and distance -1
+ * @param[in] knn The set of neighbours, which is no longer a heap afterwards
+ * @param[out] ids Array of @p k ids
+ * @param[out] dists Array of @p k distances, or @p NULL
+ */
+void
+index_knn_emit(IndexKNN *knn, int64 *ids, double *dists)
+{
+  qsort(knn->heap, (size_t) knn->count, sizeof(IndexNeighbor),
+    &index_neighbor_cmp);
+  for (int i = 0; i < knn->k; i++)
+  {
+    bool found = (i < knn->count);
+    ids[i] = found ? knn->heap[i].id : -1;
+    if (dists)
+      dists[i] = found ? knn->heap[i].dist : -1.0;
+  }
+  return;
+}
+
+/**
+ * @brief Return true when the distance of a query to the boxes of an RTree is
+ * the planar distance between their extents, which #rtree_knn_query then
+ * reads from the bounds of the nodes
+ * @details This is the case of a planar STBox query with the spatial
+ * dimensions of the boxes of the RTree, for which #nad_stbox_stbox answers the
+ * closed form of #stbox_spatial_distance
+ * @pre The RTree is not empty
+ */
+static bool
+rtree_knn_planar(const RTree *rtree, const void *query)
+{
+  if (rtree->bboxtype != T_STBOX
+#if POINTCLOUD
+      && rtree->bboxtype != T_TPCBOX
+#endif
+      )
+    return false;
+  /* The boxes of a tree share their SRID, so a query with another one is left
+   * to #nad_stbox_stbox to be reported */
+  const STBox *box = (const STBox *) query;
+  const STBox *first = (const STBox *) RTREE_NODE_BBOX_N(rtree->root, 0);
+  return MEOS_FLAGS_GET_X(box->flags) && ! MEOS_FLAGS_GET_GEODETIC(box->flags) &&
+    MEOS_FLAGS_GET_Z(box->flags) == (rtree->dims == 4) &&
+    (rtree->axes & 0x3) == 0x3 && box->srid == first->srid;
+}
+
+/**
+ * @brief Compute the planar distance from a query to the entries of a node
+ * along the spatial axes of its bounds, as #stbox_spatial_distance does
+ */
+static void
+rtree_knn_planar_dists(const RTree *rtree, const RTreeNode *node,
+  const STBox *query, double *dists)
+{
+  const double *xlo = RTREE_NODE_LOWER(node, 0);
+  const double *xhi = RTREE_NODE_UPPER(node, 0);
+  const double *ylo = RTREE_NODE_LOWER(node, 1);
+  const double *yhi = RTREE_NODE_UPPER(node, 1);
+  for (int i = 0; i < node->count; i++)
+  {
+    double dx = fmax(fmax(query->xmin - xhi[i], xlo[i] - query->xmax), 0.0);
+    double dy = fmax(fmax(query->ymin - yhi[i], ylo[i] - query->ymax), 0.0);
+    dists[i] = dx * dx + dy * dy;
+  }
+  if (rtree->dims == 4)
+  {
+    const double *zlo = RTREE_NODE_LOWER(node, 3);
+    const double *zhi = RTREE_NODE_UPPER(node, 3);
+    for (int i = 0; i < node->count; i++)
+    {
+      double dz = fmax(fmax(query->zmin - zhi[i], zlo[i] - query->zmax), 0.0);
+      dists[i] += dz * dz;
+    }
+  }
+  for (int i = 0; i < node->count; i++)
+    dists[i] = sqrt(dists[i]);
+  return;
+}
+
+/**
+ * @brief Search the k nearest neighbours of the query of a cursor with a
+ * branch-and-bound traversal of the RTree
+ * @details The nodes are expanded nearest first as by #rtree_nn_cursor_next,
+ * but the entries of a leaf go to the set of neighbours rather than to the
+ * heap, and an entry is dropped as soon as it is not nearer than the k-th
+ * neighbour found so far. The set starts with the neighbours of the previous
+ * query at their distance to this one.
+ *
+ * For a planar query the distances to the entries of a node are computed at
+ * once from the bounds of the node. The time extents of the leaf entries whose
+ * distance makes them candidates are then compared exactly, since the node
+ * bounds do not tell a period from one touching it at an exclusive bound.
+ * @param[in] cursor Cursor holding the query and the reused heap
+ * @param[in,out] knn Set of neighbours, restarted for the query
+ */
+static void
+rtree_knn_query(RTreeNNCursor *cursor, IndexKNN *knn)
+{
+  const RTree *rtree = cursor->rtree;
+  if (! rtree->root)
+    return;
+  bool planar = rtree_knn_planar(rtree, cursor->query);
+  const STBox *query = (const STBox *) cursor->query;
+  bool hast = planar && MEOS_FLAGS_GET_T(query->flags);
+  for (int i = 0; i < knn->nseeds; i++)
+  {
+    const STBox *box = (const STBox *) knn->seeds[i].box;
+    double dist;
+    if (! planar)
+      dist = rtree_bbox_distance(rtree, query, box);
+    else if (hast && MEOS_FLAGS_GET_T(box->flags) &&
+        ! overlaps_span_span(&query->period, &box->period))
+      dist = cursor->far;
+    else
+    {
+      double dx = fmax(fmax(query->xmin - box->xmax, box->xmin - query->xmax),
+        0.0);
+      double dy = fmax(fmax(query->ymin - box->ymax, box->ymin - query->ymax),
+        0.0);
+      double dz = (rtree->dims == 4) ?
+        fmax(fmax(query->zmin - box->zmax, box->zmin - query->zmax), 0.0) :
+        0.0;
+      dist = sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    index_knn_offer(knn, knn->seeds[i].id, dist, box);
+  }
+  double dists[MAXITEMS];
+  RTreeNNEntry root_entry = {0.0, false, 0, rtree->root};
+  nn_heap_push(cursor, root_entry);
+  while (cursor->count > 0)
+  {
+    RTreeNNEntry entry = nn_heap_pop(cursor);
+    /* Every node left in the heap is at least as far */
+    if (index_knn_prune(knn, entry.dist))
+      break;
+    const RTreeNode *node = entry.node;
+    bool leaf = (node->node_type == RTREE_LEAF);
+    uint64 near = nn_node_near(cursor, node);
+    if (planar)
+      rtree_knn_planar_dists(rtree, node, query, dists);
+    for (int i = 0; i < node->count; i++)
+    {
+      const void *box = RTREE_NODE_BBOX_N(node, i);
+      double dist;
+      if (! (near & (UINT64CONST(1) << i)))
+        dist = cursor->far;
+      else if (planar)
+        dist = dists[i];
+      else
+        dist = rtree_bbox_distance(rtree, cursor->query, box);
+      if (index_knn_prune(knn, dist))
+        continue;
+      if (leaf)
+      {
+        if (index_knn_seeded(knn, box))
+          continue;
+        if (hast && dist != cursor->far &&
+            MEOS_FLAGS_GET_T(((const STBox *) box)->flags) &&
+            ! overlaps_span_span(&query->period, &((const STBox *) box)->period))
+        {
+          dist = cursor->far;
+          if (index_knn_prune(knn, dist))
+            continue;
+        }
+        index_knn_offer(knn, node->ids[i], dist, box);
+      }
+      else
+      {
+        RTreeNNEntry child = {dist, false, 0,
+          RTREE_NODE_CHILD(rtree, node, i)};
+        nn_heap_push(cursor, child);
+      }
+    }
+  }
+  cursor->count = 0;
+  return;
+}
+
+/**
+ * @brief Arguments of the tasks of a batched nearest-neighbour query
+ */
+typedef struct
+{
+  const RTree *rtree;     /**< Queried RTree */
+  const char *queries;    /**< Array of query boxes */
+  const int *order;       /**< Positions of the queries in locality order */
+  int count;              /**< Number of queries */
+  int k;                  /**< Number of neighbours per query */
+  int64 *ids;             /**< Output ids, @p k per query */
+  double *dists;          /**< Output distances, or @p NULL */
+} RTreeKNNBatch;
+
+/**
+ * @brief Answer one run of consecutive queries of a batch in locality order
+ */
+static void
+rtree_knn_chunk(void *arg, int task)
+{
+  RTreeKNNBatch *batch = (RTreeKNNBatch *) arg;
+  const RTree *rtree = batch->rtree;
+  int k = batch->k;
+  RTreeNNCursor cursor;
+  memset(&cursor, 0, sizeof(RTreeNNCursor));
+  cursor.rtree = rtree;
+  cursor.query = palloc(rtree->bboxsize);
+  cursor.capacity = MAXITEMS;
+  cursor.heap = palloc((size_t) cursor.capacity * sizeof(RTreeNNEntry));
+  IndexKNN knn;
+  index_knn_init(&knn, k);
+  int start = task * INDEX_KNN_CHUNK;
+  int end = Min(start + INDEX_KNN_CHUNK, batch->count);
+  for (int n = start; n < end; n++)
+  {
+    int q = batch->order[n];
+    nn_cursor_reset(&cursor, batch->queries + (size_t) q * rtree->bboxsize);
+    index_knn_restart(&knn);
+    rtree_knn_query(&cursor, &knn);
+    index_knn_emit(&knn, batch->ids + (size_t) q * k,
+      batch->dists ? batch->dists + (size_t) q * k : NULL);
+  }
+  index_knn_free(&knn);
+  pfree(cursor.heap); pfree(cursor.query);
+  return;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Return the k nearest neighbours of every box of a batch of queries
+ * @details The neighbours of a query are those #rtree_nn_cursor_next returns
+ * first, with the same distances, in order of increasing distance and then of
+ * id; among neighbours at the same distance as the k-th one, which ones are
+ * returned is unspecified. The neighbours of query `i` are written to
+ * positions `i * k` to `i * k + k - 1` of @p ids and @p dists, and when the
+ * RTree holds fewer than k boxes the remaining positions receive id -1 and
+ * distance -1.
+ *
+ * The queries are answered in an order keeping nearby queries together, the
+ * neighbours of a query bounding the search of the next one, and the runs of
+ * queries of this order are spread over the threads. A batch is answered
+ * much faster than by opening a cursor for each query.
+ * @param[in] rtree The RTree to query
+ * @param[in] queries Array of @p count query boxes of type @p rtree->bboxtype
+ * @param[in] count Number of queries
+ * @param[in] k Number of neighbours per query
+ * @param[in] nthreads Number of threads, a value less than 1 meaning as many
+ * as there are processors online
+ * @param[out] ids Array of `count * k` ids
+ * @param[out] dists Array of `count * k` distances, or @p NULL
+ * @return True on success, false on error
+ */
+bool
+rtree_knn_batch(const RTree *rtree, const void *queries, int count, int k,
+  int nthreads, int64 *ids, double *dists)
+{
+  assert(rtree); assert(queries || count == 0); assert(ids || count == 0);
+  if (! ensure_not_negative(count) || ! ensure_positive(k))
+    return false;
+  if (count == 0)
+    return true;
+  RTreeKNNBatch batch;
+  batch.rtree = rtree;
+  batch.queries = (const char *) queries;
+  batch.order = index_query_order(rtree->bboxtype, queries, rtree->bboxsize,
+    count);
+  batch.count = count;
+  batch.k = k;
+  batch.ids = ids;
+  batch.dists = dists;
+  meos_parallel_for(meos_parallel_threads(nthreads),
+    (count + INDEX_KNN_CHUNK - 1) / INDEX_KNN_CHUNK, &rtree_knn_chunk, &batch);
+  pfree((int *) batch.order);
+  return true;
+}
+
 /**
  * @brief Frees the memory allocated for an RTree node
  * @details The function recursively frees the memory of an RTree node.
@@ -1780,10 +3541,252 @@ node_free(RTreeNode *node)
 void
 rtree_free(RTree *rtree)
 {
-  if (rtree->root)
+  if (rtree->mapped)
+    index_file_unmap(rtree->mapped, rtree->mapped_size);
+  else if (rtree->root)
     node_free(rtree->root);
   pfree(rtree);
   return;
 }
 
+/*****************************************************************************
+ * Snapshots
+ *
+ * A snapshot is the image of the nodes of an RTree, which a process maps
+ * read-only and searches in place. The nodes are laid out breadth-first after
+ * a header, with the same layout as in memory except that an inner node
+ * stores the offsets of its children from the start of the file in place of
+ * pointers, see #RTREE_NODE_CHILD. A snapshot is thus position independent
+ * and is shared through the page cache by the processes mapping it, but it is
+ * tied to the byte order, the value of `MAXITEMS` and the box layout of the
+ * build that saved it, which the header records and #rtree_open_mmap checks.
+ *****************************************************************************/
+
+/* Identification of the RTree snapshots */
+#define RTREE_FILE_MAGIC "MEOSRTRE"
+#define RTREE_FILE_VERSION 1
+
+/**
+ * @brief Header of an RTree snapshot, followed by the bounding box of the
+ * tree and, from offset @p nodes, by the nodes
+ */
+typedef struct
+{
+  char magic[8];         /**< #RTREE_FILE_MAGIC */
+  uint32 version;        /**< #RTREE_FILE_VERSION */
+  uint32 byteorder;      /**< #INDEX_FILE_BYTEORDER as written */
+  int32 maxitems;        /**< `MAXITEMS` of the build */
+  int32 bboxtype;        /**< Type of the bounding box */
+  int32 dims;            /**< Number of axes */
+  int32 axes;            /**< Bit mask of the axes present in every box */
+  uint64 bboxsize;       /**< Size of the bounding box */
+  uint64 nodesize;       /**< Size of a node */
+  uint64 nnodes;         /**< Number of nodes */
+  uint64 nodes;          /**< Offset of the first node, which is the root */
+} RTreeFileHeader;
+
+/**
+ * @brief Map a file read-only into memory
+ * @param[in] filename Name of the file
+ * @param[out] size Size of the file
+ * @return Start of the mapping, or @p NULL on error
+ */
+const char *
+index_file_map(const char *filename, size_t *size)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot open the file \"%s\": %s",
+      filename, strerror(errno));
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot map the empty file \"%s\"",
+      filename);
+    return NULL;
+  }
+  void *result = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (result == MAP_FAILED)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot map the file \"%s\": %s",
+      filename, strerror(errno));
+    return NULL;
+  }
+  *size = (size_t) st.st_size;
+  return (const char *) result;
+}
+
+/**
+ * @brief Unmap a file mapped by #index_file_map
+ */
+void
+index_file_unmap(const char *mapped, size_t size)
+{
+  munmap((void *) mapped, size);
+  return;
+}
+
+/**
+ * @brief Return the number of nodes of the subtree of a node
+ */
+static uint64
+node_count(const RTree *rtree, const RTreeNode *node)
+{
+  uint64 result = 1;
+  if (node->node_type == RTREE_INNER)
+  {
+    for (int i = 0; i < node->count; i++)
+      result += node_count(rtree, RTREE_NODE_CHILD(rtree, node, i));
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Save an RTree into a file that #rtree_open_mmap maps for searching
+ * @details The nodes are written breadth-first, so that the upper levels,
+ * read by every search, are contiguous at the start of the file
+ * @param[in] rtree The RTree
+ * @param[in] filename Name of the file, which is overwritten
+ * @return True on success, false on error
+ */
+bool
+rtree_save(const RTree *rtree, const char *filename)
+{
+  RTreeFileHeader header;
+  memset(&header, 0, sizeof(RTreeFileHeader));
+  memcpy(header.magic, RTREE_FILE_MAGIC, sizeof(header.magic));
+  header.version = RTREE_FILE_VERSION;
+  header.byteorder = INDEX_FILE_BYTEORDER;
+  header.maxitems = MAXITEMS;
+  header.bboxtype = (int32) rtree->bboxtype;
+  header.dims = rtree->dims;
+  header.axes = rtree->axes;
+  header.bboxsize = rtree->bboxsize;
+  header.nodesize = rtree->root ? node_size(rtree) : 0;
+  header.nnodes = rtree->root ? node_count(rtree, rtree->root) : 0;
+  header.nodes = TYPEALIGN(INDEX_FILE_ALIGN,
+    sizeof(RTreeFileHeader) + rtree->bboxsize);
+
+  FILE *file = fopen(filename, "wb");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot create the file \"%s\": %s",
+      filename, strerror(errno));
+    return false;
+  }
+  char pad[INDEX_FILE_ALIGN] = {0};
+  fwrite(&header, sizeof(RTreeFileHeader), 1, file);
+  fwrite(rtree->box, rtree->bboxsize, 1, file);
+  fwrite(pad, header.nodes - sizeof(RTreeFileHeader) - rtree->bboxsize, 1,
+    file);
+  if (rtree->root)
+  {
+    /* The children of the k-th node of the queue are appended to the queue,
+     * so that the position of a node in the queue is its position in the file */
+    const RTreeNode **queue = palloc(sizeof(RTreeNode *) * header.nnodes);
+    RTreeNode *copy = palloc(header.nodesize);
+    uint64 next = 1;
+    queue[0] = rtree->root;
+    for (uint64 k = 0; k < header.nnodes; k++)
+    {
+      const RTreeNode *node = queue[k];
+      memcpy(copy, node, header.nodesize);
+      for (int i = 0; i < MAXITEMS; i++)
+      {
+        if (i >= node->count)
+          copy->ids[i] = 0;
+        else if (node->node_type == RTREE_INNER)
+        {
+          queue[next] = RTREE_NODE_CHILD(rtree, node, i);
+          copy->ids[i] = (int64) (header.nodes + next * header.nodesize);
+          next++;
+        }
+      }
+      fwrite(copy, header.nodesize, 1, file);
+    }
+    pfree(copy);
+    pfree(queue);
+  }
+  bool error = ferror(file);
+  if (fclose(file) != 0 || error)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot write the file \"%s\"",
+      filename);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_geo_box_index
+ * @brief Open an RTree saved by #rtree_save by mapping its file read-only
+ * @details Nothing is read before the first search, which reads the nodes in
+ * place, so opening is immediate and the processes mapping the same file
+ * share its pages. The RTree can be searched, joined and scanned by a
+ * nearest-neighbour cursor, but not modified, and #rtree_free unmaps it. The
+ * file is trusted: its header is checked, but not its nodes.
+ * @param[in] filename Name of the file
+ * @return RTree, or @p NULL on error
+ */
+RTree *
+rtree_open_mmap(const char *filename)
+{
+  size_t size;
+  const char *mapped = index_file_map(filename, &size);
+  if (! mapped)
+    return NULL;
+
+  RTreeFileHeader header;
+  bool valid = size >= sizeof(RTreeFileHeader);
+  if (valid)
+  {
+    memcpy(&header, mapped, sizeof(RTreeFileHeader));
+    MeosType bboxtype = (MeosType) header.bboxtype;
+    valid = memcmp(header.magic, RTREE_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+      header.version == RTREE_FILE_VERSION &&
+      header.byteorder == INDEX_FILE_BYTEORDER &&
+      header.maxitems == MAXITEMS &&
+      (span_type(bboxtype) || bboxtype == T_TBOX || bboxtype == T_STBOX
+#if POINTCLOUD
+        || bboxtype == T_TPCBOX
+#endif
+      ) &&
+      header.bboxsize == bbox_get_size(bboxtype) &&
+      header.nodes >= sizeof(RTreeFileHeader) + header.bboxsize &&
+      header.nodes + header.nnodes * header.nodesize == size;
+  }
+  RTree *rtree = NULL;
+  if (valid)
+  {
+    rtree = rtree_create((MeosType) header.bboxtype);
+    if (header.nnodes > 0)
+    {
+      rtree->dims = header.dims;
+      valid = header.dims > 0 && header.dims <= RTREE_MAX_AXES &&
+        header.nodesize == node_size(rtree);
+    }
+  }
+  if (! valid)
+  {
+    if (rtree)
+      pfree(rtree);
+    index_file_unmap(mapped, size);
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "The file \"%s\" is not an RTree saved by this build", filename);
+    return NULL;
+  }
+  rtree->axes = header.axes;
+  memcpy(rtree->box, mapped + sizeof(RTreeFileHeader), rtree->bboxsize);
+  rtree->root = header.nnodes ? (RTreeNode *) (mapped + header.nodes) : NULL;
+  rtree->mapped = mapped;
+  rtree->mapped_size = size;
+  return rtree;
+}
+
 /*****************************************************************************/
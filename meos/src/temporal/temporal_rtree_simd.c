@@ -0,0 +1,320 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Kernels testing the bounds of a whole RTree node along one axis
+ * @details The nodes of an RTree keep, next to their bounding boxes, a
+ * structure-of-arrays copy of the lower and upper bound of every box along
+ * each axis (see #RTREE_NODE_LOWER). The kernels in this file compare one such
+ * pair of arrays against the bounds of a query and return the answer for the
+ * whole node as a bit mask, bit `i` being set when box `i` qualifies. A
+ * search then only visits the set bits instead of calling the box predicate
+ * of the tree once per entry.
+ *
+ * Two predicates are enough for every search operation:
+ * - #rtree_bounds_cover sets bit `i` when `lower[i] <= a && upper[i] >= b`,
+ *   which with `a` the upper and `b` the lower bound of the query tests
+ *   overlap, and with `a` the lower and `b` the upper bound of the query
+ *   tests that the box contains the query
+ * - #rtree_bounds_within sets bit `i` when `lower[i] >= a && upper[i] <= b`,
+ *   which with the bounds of the query tests that the box is contained by it
+ *
+ * Each kernel comes in a scalar version, an SSE2 version for x86-64 and a
+ * Neon version for aarch64 (both part of the base instruction set of these
+ * architectures), and an AVX2 version that is selected at the first call when
+ * the processor supports it, in the same way as PostgreSQL selects its
+ * popcount functions.
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+#include "port/simd.h"
+/* MEOS */
+#include "temporal/temporal_rtree.h"
+
+/* The AVX2 kernels are compiled with a function target attribute and selected
+ * at run time, which requires GCC or Clang on x86 */
+#if defined(USE_SSE2) && defined(__GNUC__)
+  #define USE_AVX2_WITH_RUNTIME_CHECK
+  #include <immintrin.h>
+#endif
+
+/*****************************************************************************
+ * Scalar kernels, for the architectures without a vector extension in their
+ * base instruction set
+ *****************************************************************************/
+
+#if ! defined(USE_SSE2) && ! defined(USE_NEON)
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] <= a` and
+ * `upper[i] >= b`, one entry at a time
+ * @param[in] lower,upper Bounds of the entries along an axis
+ * @param[in] count Number of entries
+ * @param[in] a,b Bounds of the query
+ */
+static uint64
+rtree_bounds_cover_scalar(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  uint64 result = 0;
+  for (int i = 0; i < count; i++)
+    result |= (uint64) (lower[i] <= a && upper[i] >= b) << i;
+  return result;
+}
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] >= a` and
+ * `upper[i] <= b`, one entry at a time
+ * @param[in] lower,upper Bounds of the entries along an axis
+ * @param[in] count Number of entries
+ * @param[in] a,b Bounds of the query
+ */
+static uint64
+rtree_bounds_within_scalar(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  uint64 result = 0;
+  for (int i = 0; i < count; i++)
+    result |= (uint64) (lower[i] >= a && upper[i] <= b) << i;
+  return result;
+}
+
+#endif /* ! USE_SSE2 && ! USE_NEON */
+
+/*****************************************************************************
+ * Two-lane kernels
+ *
+ * The arrays of a node have room for MAXITEMS entries, a multiple of the
+ * number of lanes, so reading past @p count stays within the node. The bits
+ * of the entries past @p count are cleared before returning.
+ *****************************************************************************/
+
+#if defined(USE_SSE2)
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] <= a` and
+ * `upper[i] >= b`, two entries at a time with SSE2
+ */
+static uint64
+rtree_bounds_cover_sse2(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 2)
+  {
+    __m128d cmp = _mm_and_pd(_mm_cmple_pd(_mm_loadu_pd(lower + i), va),
+      _mm_cmpge_pd(_mm_loadu_pd(upper + i), vb));
+    result |= (uint64) _mm_movemask_pd(cmp) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] >= a` and
+ * `upper[i] <= b`, two entries at a time with SSE2
+ */
+static uint64
+rtree_bounds_within_sse2(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 2)
+  {
+    __m128d cmp = _mm_and_pd(_mm_cmpge_pd(_mm_loadu_pd(lower + i), va),
+      _mm_cmple_pd(_mm_loadu_pd(upper + i), vb));
+    result |= (uint64) _mm_movemask_pd(cmp) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+#elif defined(USE_NEON)
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] <= a` and
+ * `upper[i] >= b`, two entries at a time with Neon
+ */
+static uint64
+rtree_bounds_cover_neon(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 2)
+  {
+    uint64x2_t cmp = vandq_u64(vcleq_f64(vld1q_f64(lower + i), va),
+      vcgeq_f64(vld1q_f64(upper + i), vb));
+    result |= ((vgetq_lane_u64(cmp, 0) & 1) |
+      ((vgetq_lane_u64(cmp, 1) & 1) << 1)) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] >= a` and
+ * `upper[i] <= b`, two entries at a time with Neon
+ */
+static uint64
+rtree_bounds_within_neon(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  float64x2_t va = vdupq_n_f64(a), vb = vdupq_n_f64(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 2)
+  {
+    uint64x2_t cmp = vandq_u64(vcgeq_f64(vld1q_f64(lower + i), va),
+      vcleq_f64(vld1q_f64(upper + i), vb));
+    result |= ((vgetq_lane_u64(cmp, 0) & 1) |
+      ((vgetq_lane_u64(cmp, 1) & 1) << 1)) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+#endif /* USE_SSE2 / USE_NEON */
+
+/*****************************************************************************
+ * AVX2 kernels
+ *****************************************************************************/
+
+#ifdef USE_AVX2_WITH_RUNTIME_CHECK
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] <= a` and
+ * `upper[i] >= b`, four entries at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static uint64
+rtree_bounds_cover_avx2(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 4)
+  {
+    __m256d cmp = _mm256_and_pd(
+      _mm256_cmp_pd(_mm256_loadu_pd(lower + i), va, _CMP_LE_OQ),
+      _mm256_cmp_pd(_mm256_loadu_pd(upper + i), vb, _CMP_GE_OQ));
+    result |= (uint64) _mm256_movemask_pd(cmp) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+/**
+ * @brief Return the bit mask of the entries such that `lower[i] >= a` and
+ * `upper[i] <= b`, four entries at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static uint64
+rtree_bounds_within_avx2(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b);
+  uint64 result = 0;
+  for (int i = 0; i < count; i += 4)
+  {
+    __m256d cmp = _mm256_and_pd(
+      _mm256_cmp_pd(_mm256_loadu_pd(lower + i), va, _CMP_GE_OQ),
+      _mm256_cmp_pd(_mm256_loadu_pd(upper + i), vb, _CMP_LE_OQ));
+    result |= (uint64) _mm256_movemask_pd(cmp) << i;
+  }
+  return result & RTREE_COUNT_MASK(count);
+}
+
+#endif /* USE_AVX2_WITH_RUNTIME_CHECK */
+
+/*****************************************************************************
+ * Run-time selection of the kernels
+ *****************************************************************************/
+
+static uint64 rtree_bounds_cover_choose(const double *lower,
+  const double *upper, int count, double a, double b);
+static uint64 rtree_bounds_within_choose(const double *lower,
+  const double *upper, int count, double a, double b);
+
+/**
+ * @brief Kernel testing `lower[i] <= a && upper[i] >= b` for a whole node
+ */
+uint64 (*rtree_bounds_cover)(const double *lower, const double *upper,
+  int count, double a, double b) = rtree_bounds_cover_choose;
+
+/**
+ * @brief Kernel testing `lower[i] >= a && upper[i] <= b` for a whole node
+ */
+uint64 (*rtree_bounds_within)(const double *lower, const double *upper,
+  int count, double a, double b) = rtree_bounds_within_choose;
+
+/**
+ * @brief Set the kernels to the widest version the processor supports
+ * @note Several threads may run this at once; they all store the same
+ * function pointers
+ */
+static void
+rtree_bounds_choose_kernels(void)
+{
+#if defined(USE_AVX2_WITH_RUNTIME_CHECK)
+  if (__builtin_cpu_supports("avx2"))
+  {
+    rtree_bounds_cover = rtree_bounds_cover_avx2;
+    rtree_bounds_within = rtree_bounds_within_avx2;
+    return;
+  }
+#endif
+#if defined(USE_SSE2)
+  rtree_bounds_cover = rtree_bounds_cover_sse2;
+  rtree_bounds_within = rtree_bounds_within_sse2;
+#elif defined(USE_NEON)
+  rtree_bounds_cover = rtree_bounds_cover_neon;
+  rtree_bounds_within = rtree_bounds_within_neon;
+#else
+  rtree_bounds_cover = rtree_bounds_cover_scalar;
+  rtree_bounds_within = rtree_bounds_within_scalar;
+#endif
+  return;
+}
+
+static uint64
+rtree_bounds_cover_choose(const double *lower, const double *upper, int count,
+  double a, double b)
+{
+  rtree_bounds_choose_kernels();
+  return rtree_bounds_cover(lower, upper, count, a, b);
+}
+
+static uint64
+rtree_bounds_within_choose(const double *lower, const double *upper,
+  int count, double a, double b)
+{
+  rtree_bounds_choose_kernels();
+  return rtree_bounds_within(lower, upper, count, a, b);
+}
+
+/*****************************************************************************/
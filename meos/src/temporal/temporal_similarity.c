@@ -0,0 +1,557 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Similarity distances between temporal values computed by tiles of
+ * the distance matrix
+ * @details The discrete Fréchet, Dynamic Time Warping (DTW), and Longest
+ * Common SubSequence (LCSS) distances fill a dynamic programming matrix with
+ * one row per instant of the first value and one column per instant of the
+ * second one, each cell depending on the cells above, on the left, and on
+ * the upper left diagonal. The matrix is split into square tiles of
+ * #SIM_TILE rows and columns. A tile only depends on the last row of the
+ * tile above, the last column of the tile on the left, and the last cell of
+ * the tile on the upper left diagonal, so that the tiles of an anti-diagonal
+ * of tiles are independent and are computed by the threads of the MEOS
+ * thread pool when there are enough of them. Only the last row and the last
+ * column of the tiles are kept, i.e., the memory is linear in the number of
+ * instants.
+ *
+ * The cells outside of a Sakoe-Chiba band around the diagonal of the matrix
+ * are not computed. Since the cells of the Fréchet and the DTW distances do
+ * not decrease along a warping path, the computation is abandoned when all
+ * cells through which a path may leave the tiles computed so far exceed a
+ * maximum distance.
+ *
+ * The values of temporal numbers and the coordinates of geometry points are
+ * copied once into packed arrays and their distances are computed as done
+ * by #tinstant_distance, so that the results are the same as those of the
+ * row by row computation.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/float.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "temporal/meos_parallel.h"
+#include "temporal/temporal.h"
+#include "temporal/temporal_analytics.h"
+#include "temporal/tinstant.h"
+#include "temporal/type_util.h"
+#include "geo/tgeo_distance.h"
+#include "geo/tgeo_spatialfuncs.h"
+
+/* Number of rows and columns of the tiles of the distance matrix */
+#define SIM_TILE 256
+
+/*****************************************************************************
+ * Distance between the instants
+ *****************************************************************************/
+
+/**
+ * @brief Representation of the instants used for computing their distance
+ */
+typedef enum
+{
+  SIM_NUMBER,       /**< Values of temporal numbers */
+  SIM_POINT2D,      /**< Coordinates of 2D geometry points */
+  SIM_POINT3D,      /**< Coordinates of 3D geometry points */
+  SIM_INSTANT,      /**< Instants, whose distance is #tinstant_distance */
+} SimValues;
+
+/**
+ * @brief Instants of the rows and of the columns of a distance matrix
+ * @details The packed arrays of the rows and of the columns are allocated
+ * in a single memory block. The array @p x keeps the values of temporal
+ * numbers.
+ */
+typedef struct
+{
+  SimValues values;             /**< Representation of the instants */
+  int count1;                   /**< Number of rows */
+  int count2;                   /**< Number of columns */
+  const TInstant **instants1;   /**< Instants of the rows */
+  const TInstant **instants2;   /**< Instants of the columns */
+  datum_func2 func;             /**< Distance function of the instants */
+  double *x1, *y1, *z1;         /**< Packed values of the rows */
+  double *x2, *y2, *z2;         /**< Packed values of the columns */
+} SimInput;
+
+/**
+ * @brief Copy the values of an array of instants into packed arrays
+ */
+static void
+siminput_fill(SimValues values, const TInstant **instants, int count,
+  double *x, double *y, double *z)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (values == SIM_NUMBER)
+      x[i] = tnumberinst_double(instants[i]);
+    else if (values == SIM_POINT2D)
+    {
+      const POINT2D *p = DATUM_POINT2D_P(tinstant_value_p(instants[i]));
+      x[i] = p->x; y[i] = p->y;
+    }
+    else /* values == SIM_POINT3D */
+    {
+      const POINT3DZ *p = DATUM_POINT3DZ_P(tinstant_value_p(instants[i]));
+      x[i] = p->x; y[i] = p->y; z[i] = p->z;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Initialize the instants of the rows and of the columns of a
+ * distance matrix
+ * @note The packed arrays are freed with #siminput_free
+ */
+static void
+siminput_init(SimInput *in, const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2)
+{
+  MeosType temptype = instants1[0]->temptype;
+  int16 flags = instants1[0]->flags;
+  memset(in, 0, sizeof(SimInput));
+  in->count1 = count1; in->count2 = count2;
+  in->instants1 = instants1; in->instants2 = instants2;
+  if (tnumber_type(temptype))
+    in->values = SIM_NUMBER;
+  else if (tpoint_type(temptype) && ! MEOS_FLAGS_GET_GEODETIC(flags))
+    in->values = MEOS_FLAGS_GET_Z(flags) ? SIM_POINT3D : SIM_POINT2D;
+  else
+  {
+    in->values = SIM_INSTANT;
+    in->func = pt_distance_fn(flags);
+    return;
+  }
+
+  int ncoords = (in->values == SIM_NUMBER) ? 1 :
+    (in->values == SIM_POINT2D) ? 2 : 3;
+  double *block = palloc(sizeof(double) * ncoords * (count1 + count2));
+  in->x1 = block; in->x2 = block + count1;
+  if (ncoords > 1)
+  {
+    in->y1 = block + count1 + count2;
+    in->y2 = in->y1 + count1;
+  }
+  if (ncoords > 2)
+  {
+    in->z1 = block + 2 * (count1 + count2);
+    in->z2 = in->z1 + count1;
+  }
+  siminput_fill(in->values, instants1, count1, in->x1, in->y1, in->z1);
+  siminput_fill(in->values, instants2, count2, in->x2, in->y2, in->z2);
+  return;
+}
+
+/**
+ * @brief Free the packed arrays of the instants of a distance matrix
+ */
+static void
+siminput_free(SimInput *in)
+{
+  if (in->x1)
+    pfree(in->x1);
+  return;
+}
+
+/**
+ * @brief Return the distance between the instants of a row and a column
+ * @details The distance is the one of #tinstant_distance, e.g., the distance
+ * of 2D points is computed with @p hypot as in PostGIS
+ */
+static inline double
+siminput_distance(const SimInput *in, int i, int j)
+{
+  switch (in->values)
+  {
+    case SIM_NUMBER:
+      return fabs(in->x1[i] - in->x2[j]);
+    case SIM_POINT2D:
+      return hypot(in->x2[j] - in->x1[i], in->y2[j] - in->y1[i]);
+    case SIM_POINT3D:
+    {
+      double dx = in->x2[j] - in->x1[i], dy = in->y2[j] - in->y1[i],
+        dz = in->z2[j] - in->z1[i];
+      return sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    default: /* SIM_INSTANT */
+      return tinstant_distance(in->instants1[i], in->instants2[j], in->func);
+  }
+}
+
+/*****************************************************************************
+ * Wavefront computation of the Fréchet, DTW, and LCSS distances
+ *****************************************************************************/
+
+/**
+ * @brief State of the computation of a distance matrix by tiles
+ * @details The last cell of a tile is read by the tile on its lower right
+ * diagonal two anti-diagonals later, while the tiles of the next
+ * anti-diagonal write their own last cell, so that these cells are kept in
+ * three arrays used in turn.
+ */
+typedef struct
+{
+  const SimInput *in;       /**< Instants of the rows and the columns */
+  SimFunc simfunc;          /**< Similarity function */
+  double epsilon;           /**< Maximum distance of matching instants for
+                                 the LCSS distance */
+  int window;               /**< Half width of the Sakoe-Chiba band, -1 when
+                                 there is no band */
+  double none;              /**< Value of the cells outside of the matrix or
+                                 of the band */
+  int ntiles1, ntiles2;     /**< Number of tiles in a column and a row */
+  int diag;                 /**< Anti-diagonal of tiles being computed */
+  int first;                /**< Row of the first tile of the anti-diagonal */
+  double *lastrow;          /**< Last row of the last tile of each column */
+  double *lastcol;          /**< Last column of the last tile of each row */
+  double *corner[3];        /**< Last cell of the tiles, by anti-diagonal */
+  double *edgemin;          /**< Minimum of the last row and column of the
+                                 tiles of the anti-diagonal, by row */
+  double *cornermin;        /**< Last cell of the tiles of the anti-diagonal,
+                                 by row */
+} SimWavefront;
+
+/**
+ * @brief Return the range of the columns of the Sakoe-Chiba band in a row
+ * @details The band follows the line from the first to the last cell of the
+ * matrix, i.e., the center of row @p i is `i * (count2 - 1) / (count1 - 1)`
+ */
+static void
+simwave_band(const SimWavefront *w, int i, int *lower, int *upper)
+{
+  int count1 = w->in->count1, count2 = w->in->count2;
+  if (w->window < 0)
+  {
+    *lower = 0; *upper = count2 - 1;
+    return;
+  }
+  int64 num = (int64) i * (count2 - 1);
+  int64 den = (count1 > 1) ? count1 - 1 : 1;
+  int64 lo = num / den - w->window, hi = (num + den - 1) / den + w->window;
+  *lower = (int) Max(lo, 0);
+  *upper = (int) Min(hi, count2 - 1);
+  return;
+}
+
+/**
+ * @brief Compute a tile of the distance matrix
+ * @param[in] w State of the computation
+ * @param[in] bi,bj Row and column of the tile
+ */
+static void
+simwave_tile(SimWavefront *w, int bi, int bj)
+{
+  const SimInput *in = w->in;
+  int i0 = bi * SIM_TILE, i1 = Min(i0 + SIM_TILE, in->count1);
+  int j0 = bj * SIM_TILE, j1 = Min(j0 + SIM_TILE, in->count2);
+  int width = j1 - j0;
+  double buf1[SIM_TILE + 1], buf2[SIM_TILE + 1];
+  double *top = buf1, *cur = buf2;
+
+  /* The cell before the first one of the matrix has the neutral value of
+   * the function, which is 0 for all of them */
+  if (bi == 0 && bj == 0)
+    top[0] = 0.0;
+  else if (bi == 0 || bj == 0)
+    top[0] = w->none;
+  else
+    top[0] = w->corner[w->diag % 3][bj];
+  memcpy(top + 1, w->lastrow + j0, sizeof(double) * width);
+
+  double edgemin = w->none;
+  for (int i = i0; i < i1; i++)
+  {
+    int lower, upper;
+    simwave_band(w, i, &lower, &upper);
+    cur[0] = w->lastcol[i];
+    for (int k = 1; k <= width; k++)
+    {
+      int j = j0 + k - 1;
+      if (j < lower || j > upper)
+      {
+        cur[k] = w->none;
+        continue;
+      }
+      double d = siminput_distance(in, i, j);
+      if (w->simfunc == FRECHET)
+        cur[k] = Max(d, Min(top[k - 1], Min(top[k], cur[k - 1])));
+      else if (w->simfunc == DYNTIMEWARP)
+        cur[k] = d + Min(top[k - 1], Min(top[k], cur[k - 1]));
+      else /* w->simfunc == LCSS */
+        cur[k] = (d <= w->epsilon) ? top[k - 1] + 1 : Max(top[k], cur[k - 1]);
+    }
+    w->lastcol[i] = cur[width];
+    edgemin = Min(edgemin, cur[width]);
+    double *tmp = top; top = cur; cur = tmp;
+  }
+  memcpy(w->lastrow + j0, top + 1, sizeof(double) * width);
+  for (int k = 1; k <= width; k++)
+    edgemin = Min(edgemin, top[k]);
+
+  /* The last cell is read by the tile on the lower right diagonal */
+  if (bj + 1 < w->ntiles2)
+    w->corner[(w->diag + 2) % 3][bj + 1] = top[width];
+  w->edgemin[bi] = edgemin;
+  w->cornermin[bi] = top[width];
+  return;
+}
+
+/**
+ * @brief Compute the n-th tile of the current anti-diagonal
+ */
+static void
+simwave_task(void *arg, int task)
+{
+  SimWavefront *w = (SimWavefront *) arg;
+  int bi = w->first + task;
+  simwave_tile(w, bi, w->diag - bi);
+  return;
+}
+
+/**
+ * @brief Return the Fréchet, DTW, or LCSS distance between the instants of
+ * the rows and the columns of a distance matrix
+ * @param[in] in Instants of the rows and the columns
+ * @param[in] simfunc Similarity function
+ * @param[in] epsilon Maximum distance of matching instants for LCSS
+ * @param[in] window Half width of the Sakoe-Chiba band, -1 for no band
+ * @param[in] maxdist Maximum distance, above which the computation of the
+ * Fréchet and DTW distances is abandoned and infinity is returned
+ */
+static double
+simwave_distance(const SimInput *in, SimFunc simfunc, double epsilon,
+  int window, double maxdist)
+{
+  SimWavefront w;
+  w.in = in;
+  w.simfunc = simfunc;
+  w.epsilon = epsilon;
+  w.window = window;
+  w.none = (simfunc == LCSS) ? 0.0 : get_float8_infinity();
+  w.ntiles1 = (in->count1 + SIM_TILE - 1) / SIM_TILE;
+  w.ntiles2 = (in->count2 + SIM_TILE - 1) / SIM_TILE;
+
+  /* All arrays are allocated in a single memory block */
+  int ncorners = w.ntiles2 + 1;
+  size_t size = (size_t) in->count1 + in->count2 + 3 * ncorners +
+    2 * w.ntiles1;
+  double *block = palloc(sizeof(double) * size);
+  for (size_t i = 0; i < size; i++)
+    block[i] = w.none;
+  w.lastrow = block;
+  w.lastcol = w.lastrow + in->count2;
+  for (int i = 0; i < 3; i++)
+    w.corner[i] = w.lastcol + in->count1 + i * ncorners;
+  w.edgemin = w.corner[2] + ncorners;
+  w.cornermin = w.edgemin + w.ntiles1;
+
+  /* A path leaving the tiles computed so far goes through the last row or
+   * column of a tile of the last anti-diagonal, or through the last cell of
+   * a tile of the previous one */
+  bool abandon = (simfunc != LCSS && maxdist < get_float8_infinity());
+  double cornermin = w.none;
+  for (w.diag = 0; w.diag < w.ntiles1 + w.ntiles2 - 1; w.diag++)
+  {
+    w.first = Max(0, w.diag - w.ntiles2 + 1);
+    int last = Min(w.diag, w.ntiles1 - 1);
+    int ntasks = last - w.first + 1;
+    int64 ncells = (int64) ntasks * SIM_TILE * SIM_TILE;
+    int nthreads = meos_parallel_pool_threads((int) Min(ncells, INT_MAX),
+      ntasks);
+    if (nthreads <= 1)
+    {
+      for (int task = 0; task < ntasks; task++)
+        simwave_task(&w, task);
+    }
+    else
+      meos_parallel_for(nthreads, ntasks, &simwave_task, &w);
+
+    if (abandon && w.diag < w.ntiles1 + w.ntiles2 - 2)
+    {
+      double bound = cornermin;
+      cornermin = w.none;
+      for (int bi = w.first; bi <= last; bi++)
+      {
+        bound = Min(bound, w.edgemin[bi]);
+        cornermin = Min(cornermin, w.cornermin[bi]);
+      }
+      if (bound > maxdist)
+      {
+        pfree(block);
+        return get_float8_infinity();
+      }
+    }
+  }
+  double result = w.lastrow[in->count2 - 1];
+  pfree(block);
+  if (abandon && result > maxdist)
+    return get_float8_infinity();
+  return result;
+}
+
+/**
+ * @brief Return the Fréchet, DTW, or LCSS distance between two arrays of
+ * temporal instants
+ * @details The array with the most instants, or the second one when they
+ * have the same number of instants, gives the rows of the matrix
+ * @param[in] instants1,instants2 Arrays of temporal instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] simfunc Similarity function
+ * @param[in] epsilon Maximum distance of matching instants for LCSS
+ * @param[in] window Half width of the Sakoe-Chiba band, -1 for no band,
+ * which must be the case for LCSS
+ * @param[in] maxdist Maximum distance, above which the computation of the
+ * Fréchet and DTW distances is abandoned and infinity is returned
+ */
+double
+tinstarr_similarity(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, SimFunc simfunc, double epsilon,
+  int window, double maxdist)
+{
+  assert(simfunc == FRECHET || simfunc == DYNTIMEWARP || simfunc == LCSS);
+  assert(simfunc != LCSS || window < 0);
+  assert(count1 > 0); assert(count2 > 0);
+  SimInput in;
+  if (count1 > count2)
+    siminput_init(&in, instants1, count1, instants2, count2);
+  else
+    siminput_init(&in, instants2, count2, instants1, count1);
+  double result = simwave_distance(&in, simfunc, epsilon, window, maxdist);
+  siminput_free(&in);
+  return result;
+}
+
+/*****************************************************************************
+ * Average Hausdorff distance
+ *****************************************************************************/
+
+/**
+ * @brief Arguments of the tasks computing the distance from each row of a
+ * distance matrix to its nearest column
+ */
+typedef struct
+{
+  const SimInput *in;       /**< Instants of the rows and the columns */
+  bool transpose;           /**< True when the rows are the columns */
+  double *result;           /**< Minimum distance of each row */
+} SimRowMin;
+
+/**
+ * @brief Compute the minimum distances of the rows of the n-th tile of rows
+ */
+static void
+simrowmin_task(void *arg, int task)
+{
+  const SimRowMin *r = (const SimRowMin *) arg;
+  int nrows = r->transpose ? r->in->count2 : r->in->count1;
+  int ncols = r->transpose ? r->in->count1 : r->in->count2;
+  int i1 = Min((task + 1) * SIM_TILE, nrows);
+  for (int i = task * SIM_TILE; i < i1; i++)
+  {
+    double cmin = DBL_MAX;
+    for (int j = 0; j < ncols; j++)
+    {
+      double d = r->transpose ? siminput_distance(r->in, j, i) :
+        siminput_distance(r->in, i, j);
+      if (d < cmin)
+        cmin = d;
+    }
+    r->result[i] = cmin;
+  }
+  return;
+}
+
+/**
+ * @brief Set the distance from each row, or each column when @p transpose
+ * is true, of a distance matrix to its nearest column or row
+ */
+static void
+simrowmin(const SimInput *in, bool transpose, double *result)
+{
+  SimRowMin r = { in, transpose, result };
+  int nrows = transpose ? in->count2 : in->count1;
+  int ntasks = (nrows + SIM_TILE - 1) / SIM_TILE;
+  int64 ncells = (int64) in->count1 * in->count2;
+  int nthreads = meos_parallel_pool_threads((int) Min(ncells, INT_MAX),
+    ntasks);
+  if (nthreads <= 1)
+  {
+    for (int task = 0; task < ntasks; task++)
+      simrowmin_task(&r, task);
+  }
+  else
+    meos_parallel_for(nthreads, ntasks, &simrowmin_task, &r);
+  return;
+}
+
+/**
+ * @brief Return the average Hausdorff distance between two arrays of temporal
+ * instants
+ * @details The average Hausdorff distance averages, over both directions, the
+ * mean distance from each instant of one array to its nearest instant in the
+ * other array. The distances to the nearest instants are computed by tiles
+ * of rows in parallel and are then added in the order of the instants.
+ * @param[in] instants1,instants2 Arrays of temporal instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ */
+double
+tinstarr_average_hausdorff(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2)
+{
+  assert(count1 > 0); assert(count2 > 0);
+  SimInput in;
+  siminput_init(&in, instants1, count1, instants2, count2);
+  double *cmin = palloc(sizeof(double) * Max(count1, count2));
+  double sum1 = 0.0, sum2 = 0.0;
+  simrowmin(&in, false, cmin);
+  for (int i = 0; i < count1; i++)
+    sum1 += cmin[i];
+  simrowmin(&in, true, cmin);
+  for (int j = 0; j < count2; j++)
+    sum2 += cmin[j];
+  pfree(cmin);
+  siminput_free(&in);
+  return 0.5 * ((sum1 / (double) count1) + (sum2 / (double) count2));
+}
+
+/*****************************************************************************/
@@ -0,0 +1,280 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Bounded Fréchet and Dynamic Time Warping (DTW) distances between
+ * temporal values and between a temporal value and an array of them
+ * @details The bounded distances restrict the warping paths to a Sakoe-Chiba
+ * band and abandon the computation as soon as the distance is known to
+ * exceed a maximum one, in which case infinity is returned. The distances
+ * from a temporal value to an array of them, e.g., for clustering
+ * trajectories, skip the values whose lower bound given by the first and the
+ * last instants, which are matched by every warping path, exceeds the
+ * maximum distance, and are computed by the threads of the MEOS thread pool.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <limits.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/float.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "temporal/meos_parallel.h"
+#include "temporal/temporal.h"
+#include "temporal/temporal_analytics.h"
+#include "geo/tgeo_distance.h"
+#include "geo/tgeo_spatialfuncs.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Ensure that the band and the maximum distance of a bounded
+ * similarity distance are valid
+ */
+static bool
+ensure_valid_similarity_bounds(int window, double maxdist)
+{
+  if (window < -1)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The width of the band must be greater than or equal to -1: %d",
+      window);
+    return false;
+  }
+  if (isnan(maxdist) || maxdist < 0.0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The maximum distance must be greater than or equal to 0: %f",
+      maxdist);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return the bounded Fréchet or DTW distance between two temporal
+ * values
+ * @details The first and the last instants of the values are matched by
+ * every warping path, which gives a lower bound of the distance that is
+ * tested before computing it
+ */
+static double
+temporal_similarity_bounded(const Temporal *temp1, const Temporal *temp2,
+  SimFunc simfunc, int window, double maxdist)
+{
+  int count1, count2;
+  const TInstant **instants1 = temporal_insts_p(temp1, &count1);
+  const TInstant **instants2 = temporal_insts_p(temp2, &count2);
+  /* The flags are needed to select the spatial distance function */
+  MeosType temptype = instants1[0]->temptype;
+  datum_func2 func = tgeo_type(temptype) ?
+    geo_distance_fn(instants1[0]->flags) : ( tpoint_type(temptype) ?
+    pt_distance_fn(instants1[0]->flags) : NULL );
+  double first = tinstant_distance(instants1[0], instants2[0], func);
+  double last = (count1 == 1 && count2 == 1) ? 0.0 :
+    tinstant_distance(instants1[count1 - 1], instants2[count2 - 1], func);
+  double bound = (simfunc == FRECHET) ? Max(first, last) : first + last;
+  double result = (bound > maxdist) ? get_float8_infinity() :
+    tinstarr_similarity(instants1, count1, instants2, count2, simfunc, 0.0,
+      window, maxdist);
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return the Fréchet distance between two temporal values whose
+ * warping paths are restricted to a band, or infinity when the distance is
+ * greater than a maximum distance
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] window Half width of the Sakoe-Chiba band in number of instants
+ * around the line joining the first and the last instants of the values, -1
+ * for no band
+ * @param[in] maxdist Maximum distance, infinity for no maximum
+ * @return On error return @p DBL_MAX
+ * @see #temporal_frechet_distance()
+ */
+double
+temporal_frechet_distance_bounded(const Temporal *temp1,
+  const Temporal *temp2, int window, double maxdist)
+{
+  /* Ensure the validity of the arguments */
+  if (! ensure_valid_temporal_temporal(temp1, temp2) ||
+      ! ensure_valid_similarity_bounds(window, maxdist))
+    return DBL_MAX;
+  return temporal_similarity_bounded(temp1, temp2, FRECHET, window, maxdist);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return the Dynamic Time Warp distance between two temporal values
+ * whose warping paths are restricted to a band, or infinity when the
+ * distance is greater than a maximum distance
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] window Half width of the Sakoe-Chiba band in number of instants
+ * around the line joining the first and the last instants of the values, -1
+ * for no band
+ * @param[in] maxdist Maximum distance, infinity for no maximum
+ * @return On error return @p DBL_MAX
+ * @see #temporal_dyntimewarp_distance()
+ */
+double
+temporal_dyntimewarp_distance_bounded(const Temporal *temp1,
+  const Temporal *temp2, int window, double maxdist)
+{
+  /* Ensure the validity of the arguments */
+  if (! ensure_valid_temporal_temporal(temp1, temp2) ||
+      ! ensure_valid_similarity_bounds(window, maxdist))
+    return DBL_MAX;
+  return temporal_similarity_bounded(temp1, temp2, DYNTIMEWARP, window,
+    maxdist);
+}
+
+/*****************************************************************************
+ * Distances from a temporal value to an array of them
+ *****************************************************************************/
+
+/**
+ * @brief Arguments of the tasks computing the distances from a temporal value
+ * to an array of them
+ */
+typedef struct
+{
+  const Temporal *temp;     /**< Temporal value */
+  Temporal **temparr;       /**< Array of temporal values */
+  SimFunc simfunc;          /**< Similarity function */
+  int window;               /**< Half width of the band, -1 for no band */
+  double maxdist;           /**< Maximum distance */
+  double *result;           /**< Output array */
+} SimArray;
+
+/**
+ * @brief Compute the distance to the n-th value of the array
+ */
+static void
+temparr_similarity_task(void *arg, int task)
+{
+  const SimArray *sim = (const SimArray *) arg;
+  sim->result[task] = temporal_similarity_bounded(sim->temp,
+    sim->temparr[task], sim->simfunc, sim->window, sim->maxdist);
+  return;
+}
+
+/**
+ * @brief Set the bounded Fréchet or DTW distances from a temporal value to
+ * an array of them
+ */
+static bool
+temparr_similarity(const Temporal *temp, Temporal **temparr, int count,
+  SimFunc simfunc, int window, double maxdist, double *result)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temp, false); VALIDATE_NOT_NULL(temparr, false);
+  VALIDATE_NOT_NULL(result, false);
+  if (! ensure_positive(count) ||
+      ! ensure_valid_similarity_bounds(window, maxdist))
+    return false;
+  int64 ninsts = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! temparr[i])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Null temporal value at position %d of the array", i);
+      return false;
+    }
+    if (! ensure_valid_temporal_temporal(temp, temparr[i]))
+      return false;
+    ninsts += temporal_num_instants(temparr[i]);
+  }
+
+  SimArray sim = { temp, temparr, simfunc, window, maxdist, result };
+  int nthreads = meos_parallel_pool_threads((int) Min(ninsts, INT_MAX),
+    count);
+  if (nthreads <= 1)
+  {
+    for (int i = 0; i < count; i++)
+      temparr_similarity_task(&sim, i);
+  }
+  else
+    meos_parallel_for(nthreads, count, &temparr_similarity_task, &sim);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return in the last argument the Fréchet distances from a temporal
+ * value to an array of temporal values, infinity for the values whose
+ * distance is greater than a maximum distance
+ * @param[in] temp Temporal value
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] window Half width of the Sakoe-Chiba band, -1 for no band
+ * @param[in] maxdist Maximum distance, infinity for no maximum
+ * @param[out] result Array of @p count distances
+ * @return On error return false
+ * @see #temporal_frechet_distance_bounded()
+ */
+bool
+temparr_frechet_distance(const Temporal *temp, Temporal **temparr,
+  int count, int window, double maxdist, double *result)
+{
+  return temparr_similarity(temp, temparr, count, FRECHET, window, maxdist,
+    result);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return in the last argument the Dynamic Time Warp distances from a
+ * temporal value to an array of temporal values, infinity for the values
+ * whose distance is greater than a maximum distance
+ * @param[in] temp Temporal value
+ * @param[in] temparr Array of temporal values
+ * @param[in] count Number of values
+ * @param[in] window Half width of the Sakoe-Chiba band, -1 for no band
+ * @param[in] maxdist Maximum distance, infinity for no maximum
+ * @param[out] result Array of @p count distances
+ * @return On error return false
+ * @see #temporal_dyntimewarp_distance_bounded()
+ */
+bool
+temparr_dyntimewarp_distance(const Temporal *temp, Temporal **temparr,
+  int count, int window, double maxdist, double *result)
+{
+  return temparr_similarity(temp, temparr, count, DYNTIMEWARP, window,
+    maxdist, result);
+}
+
+/*****************************************************************************/
@@ -41,6 +41,8 @@
  */
 
 /* C */
+#include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 /* MEOS */
 #include <meos.h>
@@ -49,10 +51,12 @@
 #if POINTCLOUD
   #include <meos_pointcloud.h>
 #endif
+#include "temporal/meos_parallel.h"
 #include "temporal/temporal.h"
 #include "temporal/span_index.h"
 #include "temporal/tbox_index.h"
 #include "geo/stbox_index.h"
+#include "temporal/temporal_rtree.h"
 #include "temporal/temporal_sptree.h"
 
 /*****************************************************************************
@@ -471,6 +475,46 @@ sptree_create_tpcbox(SPTreeKind kind)
  * Insertion
  *****************************************************************************/
 
+/**
+ * @brief Set the dimensions of an index whose dimensions are determined by
+ * its first box, and hence the number of children per node
+ */
+static void
+sptree_set_dims(SPTree *sptree, int dims)
+{
+  sptree->dims = dims;
+  sptree->kd_bits = (dims == 8) ? STBOX_KD_BITS_Z : STBOX_KD_BITS;
+  sptree->nchild = (sptree->kind == SPTREE_QUADTREE) ? (1 << dims) : 2;
+  return;
+}
+
+/**
+ * @brief Ensure that an index can be modified, i.e., that it has not been
+ * opened by #sptree_open_mmap
+ */
+static bool
+ensure_sptree_writable(const SPTree *sptree)
+{
+  if (! sptree->mapped)
+    return true;
+  meos_error(ERROR, MEOS_ERR_FEATURE_NOT_SUPPORTED,
+    "Cannot modify an SPTree opened from a file");
+  return false;
+}
+
+/**
+ * @brief Return the child of a node in a quadrant, or @p NULL when empty
+ */
+static inline const SPNode *
+spnode_child(const SPTree *sptree, const SPNode *node, int quadrant)
+{
+  if (! sptree->mapped)
+    return node->children[quadrant];
+  int64 offset = ((const int64 *) ((const char *) node +
+    SPNODE_MAPPED_CHILDREN(sptree)))[quadrant];
+  return offset ? (const SPNode *) (sptree->mapped + offset) : NULL;
+}
+
 /**
  * @brief Return a new node holding a bounding box
  */
@@ -497,6 +541,8 @@ spnode_make(const SPTree *sptree, const void *box, int64 id)
 void
 sptree_insert(SPTree *sptree, void *box, int64 id)
 {
+  if (! ensure_sptree_writable(sptree))
+    return;
   /* Project the incoming box into the internal box type (TPCBox: STBox) */
   bboxunion proj;
   if (sptree->project)
@@ -507,12 +553,7 @@ sptree_insert(SPTree *sptree, void *box, int64 id)
   /* Determine the deferred dimensions from the first box (STBox: 6 for 2D+T,
    * 8 for 3D+T) and hence the number of children per node */
   if (sptree->dims < 0)
-  {
-    sptree->dims = sptree->box_dims(box);
-    sptree->kd_bits = (sptree->dims == 8) ? STBOX_KD_BITS_Z : STBOX_KD_BITS;
-    sptree->nchild = (sptree->kind == SPTREE_QUADTREE) ?
-      (1 << sptree->dims) : 2;
-  }
+    sptree_set_dims(sptree, sptree->box_dims(box));
   SPNode **slot = &sptree->root;
   int level = 0;
   while (*slot != NULL)
@@ -555,7 +596,7 @@ spnode_search(const SPTree *sptree, const SPNode *node, const void *nodebox,
   }
   for (int quadrant = 0; quadrant < sptree->nchild; quadrant++)
   {
-    const SPNode *child = node->children[quadrant];
+    const SPNode *child = spnode_child(sptree, node, quadrant);
     if (! child)
       continue;
     char next[SPTREE_NODEBOX_MAXSIZE];
@@ -802,11 +843,202 @@ spnode_free(const SPTree *sptree, SPNode *node)
 void
 sptree_free(SPTree *sptree)
 {
-  spnode_free(sptree, sptree->root);
+  if (sptree->mapped)
+    index_file_unmap(sptree->mapped, sptree->mapped_size);
+  else
+    spnode_free(sptree, sptree->root);
   pfree(sptree);
   return;
 }
 
+/*****************************************************************************
+ * Snapshots
+ *
+ * As for the RTree, a snapshot is the image of the nodes of an SPTree laid out
+ * breadth-first after a header, which a process maps read-only and searches
+ * in place. A node is followed by the offsets of its children, see
+ * #SPNODE_MAPPED_CHILDREN.
+ *****************************************************************************/
+
+/* Identification of the SPTree snapshots */
+#define SPTREE_FILE_MAGIC "MEOSSPTR"
+#define SPTREE_FILE_VERSION 1
+
+/**
+ * @brief Header of an SPTree snapshot, followed from offset @p nodes by the
+ * nodes
+ */
+typedef struct
+{
+  char magic[8];         /**< #SPTREE_FILE_MAGIC */
+  uint32 version;        /**< #SPTREE_FILE_VERSION */
+  uint32 byteorder;      /**< #INDEX_FILE_BYTEORDER as written */
+  int32 bboxtype;        /**< Type of the bounding box */
+  int32 kind;            /**< Quad-tree or k-d tree */
+  int32 dims;            /**< Number of dimensions of the box */
+  int32 nchild;          /**< Number of children per node */
+  uint64 boxsize;        /**< Size of the stored box */
+  uint64 nodesize;       /**< Size of a node with its child offsets */
+  uint64 nnodes;         /**< Number of nodes */
+  uint64 nodes;          /**< Offset of the first node, which is the root */
+} SPTreeFileHeader;
+
+/**
+ * @brief Return the number of nodes of the subtree of a node
+ */
+static uint64
+spnode_count(const SPTree *sptree, const SPNode *node)
+{
+  uint64 result = 1;
+  for (int i = 0; i < sptree->nchild; i++)
+  {
+    const SPNode *child = spnode_child(sptree, node, i);
+    if (child)
+      result += spnode_count(sptree, child);
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_box_index
+ * @brief Save an in-memory space-partitioning index into a file that
+ * #sptree_open_mmap maps for searching
+ * @param[in] sptree The SPTree
+ * @param[in] filename Name of the file, which is overwritten
+ * @return True on success, false on error
+ */
+bool
+sptree_save(const SPTree *sptree, const char *filename)
+{
+  SPTreeFileHeader header;
+  memset(&header, 0, sizeof(SPTreeFileHeader));
+  memcpy(header.magic, SPTREE_FILE_MAGIC, sizeof(header.magic));
+  header.version = SPTREE_FILE_VERSION;
+  header.byteorder = INDEX_FILE_BYTEORDER;
+  header.bboxtype = (int32) sptree->bboxtype;
+  header.kind = (int32) sptree->kind;
+  header.dims = sptree->dims;
+  header.nchild = sptree->nchild;
+  header.boxsize = sptree->boxsize;
+  header.nodesize = sptree->root ? SPNODE_MAPPED_CHILDREN(sptree) +
+    sizeof(int64) * sptree->nchild : 0;
+  header.nnodes = sptree->root ? spnode_count(sptree, sptree->root) : 0;
+  header.nodes = TYPEALIGN(INDEX_FILE_ALIGN, sizeof(SPTreeFileHeader));
+
+  FILE *file = fopen(filename, "wb");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot create the file \"%s\": %s",
+      filename, strerror(errno));
+    return false;
+  }
+  char pad[INDEX_FILE_ALIGN] = {0};
+  fwrite(&header, sizeof(SPTreeFileHeader), 1, file);
+  fwrite(pad, header.nodes - sizeof(SPTreeFileHeader), 1, file);
+  if (sptree->root)
+  {
+    /* The children of the k-th node of the queue are appended to the queue,
+     * so that the position of a node in the queue is its position in the file */
+    const SPNode **queue = palloc(sizeof(SPNode *) * header.nnodes);
+    char *copy = palloc0(header.nodesize);
+    int64 *offsets = (int64 *) (copy + SPNODE_MAPPED_CHILDREN(sptree));
+    uint64 next = 1;
+    queue[0] = sptree->root;
+    for (uint64 k = 0; k < header.nnodes; k++)
+    {
+      const SPNode *node = queue[k];
+      ((SPNode *) copy)->id = node->id;
+      memcpy(((SPNode *) copy)->centroid, node->centroid, sptree->boxsize);
+      for (int i = 0; i < sptree->nchild; i++)
+      {
+        const SPNode *child = spnode_child(sptree, node, i);
+        offsets[i] = 0;
+        if (child)
+        {
+          queue[next] = child;
+          offsets[i] = (int64) (header.nodes + next * header.nodesize);
+          next++;
+        }
+      }
+      fwrite(copy, header.nodesize, 1, file);
+    }
+    pfree(copy);
+    pfree(queue);
+  }
+  bool error = ferror(file);
+  if (fclose(file) != 0 || error)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "Cannot write the file \"%s\"",
+      filename);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_box_index
+ * @brief Open an in-memory space-partitioning index saved by #sptree_save by
+ * mapping its file read-only
+ * @details As for #rtree_open_mmap, the nodes are read in place by the
+ * searches and the nearest-neighbour cursors, the index cannot be modified,
+ * and #sptree_free unmaps it
+ * @param[in] filename Name of the file
+ * @return SPTree, or @p NULL on error
+ */
+SPTree *
+sptree_open_mmap(const char *filename)
+{
+  size_t size;
+  const char *mapped = index_file_map(filename, &size);
+  if (! mapped)
+    return NULL;
+
+  SPTreeFileHeader header;
+  bool valid = size >= sizeof(SPTreeFileHeader);
+  if (valid)
+  {
+    memcpy(&header, mapped, sizeof(SPTreeFileHeader));
+    MeosType bboxtype = (MeosType) header.bboxtype;
+    valid = memcmp(header.magic, SPTREE_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+      header.version == SPTREE_FILE_VERSION &&
+      header.byteorder == INDEX_FILE_BYTEORDER &&
+      (span_type(bboxtype) || bboxtype == T_TBOX || bboxtype == T_STBOX
+#if POINTCLOUD
+        || bboxtype == T_TPCBOX
+#endif
+      ) &&
+      (header.kind == SPTREE_QUADTREE || header.kind == SPTREE_KDTREE) &&
+      header.nodes >= sizeof(SPTreeFileHeader) &&
+      header.nodes + header.nnodes * header.nodesize == size;
+  }
+  SPTree *sptree = NULL;
+  if (valid)
+  {
+    sptree = sptree_create((MeosType) header.bboxtype,
+      (SPTreeKind) header.kind);
+    if (sptree->dims < 0 && (header.dims == 6 || header.dims == 8))
+      sptree_set_dims(sptree, header.dims);
+    valid = header.boxsize == sptree->boxsize &&
+      (header.nnodes == 0 || (header.dims == sptree->dims &&
+        header.nchild == sptree->nchild &&
+        header.nodesize == SPNODE_MAPPED_CHILDREN(sptree) +
+          sizeof(int64) * sptree->nchild));
+  }
+  if (! valid)
+  {
+    if (sptree)
+      pfree(sptree);
+    index_file_unmap(mapped, size);
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "The file \"%s\" is not an SPTree saved by this build", filename);
+    return NULL;
+  }
+  sptree->root = header.nnodes ? (SPNode *) (mapped + header.nodes) : NULL;
+  sptree->mapped = mapped;
+  sptree->mapped_size = size;
+  return sptree;
+}
+
 /*****************************************************************************
  * Nearest-neighbour (kNN) cursor
  *
@@ -960,6 +1192,78 @@ spnn_heap_pop(SPNNCursor *cursor)
   return top;
 }
 
+/**
+ * @brief Set the query of a nearest-neighbour cursor and seed its heap with
+ * the root node
+ * @details The heap keeps its capacity, so that a cursor answering one query
+ * after another allocates nothing once it has grown
+ * @param[in] cursor The cursor
+ * @param[in] query The query bounding box, copied into the cursor
+ */
+static void
+spnn_cursor_reset(SPNNCursor *cursor, const void *query)
+{
+  const SPTree *sptree = cursor->sptree;
+  /* Project the query box into the internal box type (TPCBox: STBox) */
+  if (sptree->project)
+    sptree->project(query, cursor->query);
+  else
+    memcpy(cursor->query, query, sptree->boxsize);
+  cursor->count = 0;
+  /* Seed the heap with the root node covering the infinite region */
+  if (sptree->root)
+  {
+    SPNNEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.is_emit = false;
+    entry.node = sptree->root;
+    entry.level = 0;
+    sptree->nodebox_init(entry.region, sptree->root->centroid, sptree);
+    entry.dist = sptree_nodebox_distance(sptree, cursor->query, entry.region);
+    spnn_heap_push(cursor, &entry);
+  }
+  return;
+}
+
+/**
+ * @brief Return the distance from the query of a cursor to a stored box
+ */
+static double
+spnn_box_distance(const SPNNCursor *cursor, const void *box)
+{
+  char nodebox[SPTREE_NODEBOX_MAXSIZE];
+  sptree_box_nodebox(cursor->sptree, box, nodebox);
+  return sptree_nodebox_distance(cursor->sptree, cursor->query, nodebox);
+}
+
+/**
+ * @brief Fill the entry of the child of a node in a quadrant, returning false
+ * when the quadrant is empty
+ */
+static bool
+spnn_child_entry(const SPNNCursor *cursor, const SPNNEntry *entry,
+  int quadrant, SPNNEntry *childentry)
+{
+  const SPTree *sptree = cursor->sptree;
+  const SPNode *node = entry->node;
+  const SPNode *child = spnode_child(sptree, node, quadrant);
+  if (! child)
+    return false;
+  childentry->is_emit = false;
+  childentry->id = 0;
+  childentry->node = child;
+  childentry->level = entry->level + 1;
+  if (sptree->kind == SPTREE_QUADTREE)
+    sptree->quadtree_next(entry->region, node->centroid, (uint8) quadrant,
+      childentry->region);
+  else
+    sptree->kdtree_next(entry->region, node->centroid, (uint8) quadrant,
+      entry->level, childentry->region);
+  childentry->dist = sptree_nodebox_distance(sptree, cursor->query,
+    childentry->region);
+  return true;
+}
+
 /**
  * @ingroup meos_temporal_box_index
  * @brief Open a nearest-neighbour cursor that yields the ids stored in an
@@ -981,26 +1285,9 @@ sptree_nn_cursor_open(const SPTree *sptree, const void *query)
   SPNNCursor *cursor = palloc0(sizeof(SPNNCursor));
   cursor->sptree = sptree;
   cursor->query = palloc(sptree->boxsize);
-  /* Project the query box into the internal box type (TPCBox: STBox) */
-  if (sptree->project)
-    sptree->project(query, cursor->query);
-  else
-    memcpy(cursor->query, query, sptree->boxsize);
   cursor->capacity = 64;
   cursor->heap = palloc((size_t) cursor->capacity * sizeof(SPNNEntry));
-  cursor->count = 0;
-  /* Seed the heap with the root node covering the infinite region */
-  if (sptree->root)
-  {
-    SPNNEntry entry;
-    memset(&entry, 0, sizeof(entry));
-    entry.is_emit = false;
-    entry.node = sptree->root;
-    entry.level = 0;
-    sptree->nodebox_init(entry.region, sptree->root->centroid, sptree);
-    entry.dist = sptree_nodebox_distance(sptree, cursor->query, entry.region);
-    spnn_heap_push(cursor, &entry);
-  }
+  spnn_cursor_reset(cursor, query);
   return cursor;
 }
 
@@ -1038,29 +1325,14 @@ sptree_nn_cursor_next(SPNNCursor *cursor, int64 *id_out, double *dist_out)
     memset(&emit, 0, sizeof(emit));
     emit.is_emit = true;
     emit.id = node->id;
-    char centroidbox[SPTREE_NODEBOX_MAXSIZE];
-    sptree_box_nodebox(sptree, node->centroid, centroidbox);
-    emit.dist = sptree_nodebox_distance(sptree, cursor->query, centroidbox);
+    emit.dist = spnn_box_distance(cursor, node->centroid);
     spnn_heap_push(cursor, &emit);
     for (int quadrant = 0; quadrant < sptree->nchild; quadrant++)
     {
-      const SPNode *child = node->children[quadrant];
-      if (! child)
-        continue;
       SPNNEntry childentry;
       memset(&childentry, 0, sizeof(childentry));
-      childentry.is_emit = false;
-      childentry.node = child;
-      childentry.level = entry.level + 1;
-      if (sptree->kind == SPTREE_QUADTREE)
-        sptree->quadtree_next(entry.region, node->centroid, (uint8) quadrant,
-          childentry.region);
-      else
-        sptree->kdtree_next(entry.region, node->centroid, (uint8) quadrant,
-          entry.level, childentry.region);
-      childentry.dist = sptree_nodebox_distance(sptree, cursor->query,
-        childentry.region);
-      spnn_heap_push(cursor, &childentry);
+      if (spnn_child_entry(cursor, &entry, quadrant, &childentry))
+        spnn_heap_push(cursor, &childentry);
     }
   }
   return false;
@@ -1082,4 +1354,145 @@ sptree_nn_cursor_close(SPNNCursor *cursor)
   return;
 }
 
+/*****************************************************************************
+ * Batched nearest-neighbour queries
+ *****************************************************************************/
+
+/**
+ * @brief Search the k nearest neighbours of the query of a cursor with a
+ * branch-and-bound traversal of the SPTree
+ * @details The nodes are expanded nearest first as by #sptree_nn_cursor_next,
+ * but the box stored at a node goes to the set of neighbours rather than to
+ * the heap, and a node or a box is dropped as soon as it is not nearer than
+ * the k-th neighbour found so far. The set starts with the neighbours of the
+ * previous query at their distance to this one.
+ * @param[in] cursor Cursor holding the query and the reused heap, seeded with
+ * the root node
+ * @param[in,out] knn Set of neighbours, restarted for the query
+ */
+static void
+sptree_knn_query(SPNNCursor *cursor, IndexKNN *knn)
+{
+  const SPTree *sptree = cursor->sptree;
+  for (int i = 0; i < knn->nseeds; i++)
+    index_knn_offer(knn, knn->seeds[i].id,
+      spnn_box_distance(cursor, knn->seeds[i].box), knn->seeds[i].box);
+  while (cursor->count > 0)
+  {
+    SPNNEntry entry = spnn_heap_pop(cursor);
+    /* Every node left in the heap is at least as far */
+    if (index_knn_prune(knn, entry.dist))
+      break;
+    const SPNode *node = entry.node;
+    if (! index_knn_seeded(knn, node->centroid))
+      index_knn_offer(knn, node->id, spnn_box_distance(cursor, node->centroid),
+        node->centroid);
+    for (int quadrant = 0; quadrant < sptree->nchild; quadrant++)
+    {
+      SPNNEntry childentry;
+      if (spnn_child_entry(cursor, &entry, quadrant, &childentry) &&
+          ! index_knn_prune(knn, childentry.dist))
+        spnn_heap_push(cursor, &childentry);
+    }
+  }
+  cursor->count = 0;
+  return;
+}
+
+/**
+ * @brief Arguments of the tasks of a batched nearest-neighbour query
+ */
+typedef struct
+{
+  const SPTree *sptree;   /**< Queried SPTree */
+  const char *queries;    /**< Array of query boxes */
+  size_t stride;          /**< Size of a query box */
+  const int *order;       /**< Positions of the queries in locality order */
+  int count;              /**< Number of queries */
+  int k;                  /**< Number of neighbours per query */
+  int64 *ids;             /**< Output ids, @p k per query */
+  double *dists;          /**< Output distances, or @p NULL */
+} SPTreeKNNBatch;
+
+/**
+ * @brief Answer one run of consecutive queries of a batch in locality order
+ */
+static void
+sptree_knn_chunk(void *arg, int task)
+{
+  SPTreeKNNBatch *batch = (SPTreeKNNBatch *) arg;
+  const SPTree *sptree = batch->sptree;
+  int k = batch->k;
+  SPNNCursor cursor;
+  memset(&cursor, 0, sizeof(SPNNCursor));
+  cursor.sptree = sptree;
+  cursor.query = palloc(sptree->boxsize);
+  cursor.capacity = 64;
+  cursor.heap = palloc((size_t) cursor.capacity * sizeof(SPNNEntry));
+  IndexKNN knn;
+  index_knn_init(&knn, k);
+  int start = task * INDEX_KNN_CHUNK;
+  int end = Min(start + INDEX_KNN_CHUNK, batch->count);
+  for (int n = start; n < end; n++)
+  {
+    int q = batch->order[n];
+    spnn_cursor_reset(&cursor, batch->queries + (size_t) q * batch->stride);
+    index_knn_restart(&knn);
+    sptree_knn_query(&cursor, &knn);
+    index_knn_emit(&knn, batch->ids + (size_t) q * k,
+      batch->dists ? batch->dists + (size_t) q * k : NULL);
+  }
+  index_knn_free(&knn);
+  pfree(cursor.heap); pfree(cursor.query);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_box_index
+ * @brief Return the k nearest neighbours of every box of a batch of queries
+ * @details The neighbours of a query are those #sptree_nn_cursor_next returns
+ * first, with the same distances, in order of increasing distance and then of
+ * id; among neighbours at the same distance as the k-th one, which ones are
+ * returned is unspecified. The neighbours of query `i` are written to
+ * positions `i * k` to `i * k + k - 1` of @p ids and @p dists, and when the
+ * SPTree holds fewer than k boxes the remaining positions receive id -1 and
+ * distance -1. The queries are answered as by #rtree_knn_batch.
+ * @param[in] sptree The SPTree to query
+ * @param[in] queries Array of @p count query boxes of type @p sptree->bboxtype
+ * @param[in] count Number of queries
+ * @param[in] k Number of neighbours per query
+ * @param[in] nthreads Number of threads, a value less than 1 meaning as many
+ * as there are processors online
+ * @param[out] ids Array of `count * k` ids
+ * @param[out] dists Array of `count * k` distances, or @p NULL
+ * @return True on success, false on error
+ */
+bool
+sptree_knn_batch(const SPTree *sptree, const void *queries, int count, int k,
+  int nthreads, int64 *ids, double *dists)
+{
+  assert(sptree); assert(queries || count == 0); assert(ids || count == 0);
+  if (! ensure_not_negative(count) || ! ensure_positive(k))
+    return false;
+  if (count == 0)
+    return true;
+  SPTreeKNNBatch batch;
+  batch.sptree = sptree;
+  batch.queries = (const char *) queries;
+  /* The queries have the size of the box type received, which is not the
+   * one of the boxes stored when they are projected */
+  batch.stride = bbox_get_size(sptree->bboxtype);
+  batch.order = index_query_order(sptree->bboxtype, queries, batch.stride,
+    count);
+  batch.count = count;
+  batch.k = k;
+  batch.ids = ids;
+  batch.dists = dists;
+  meos_parallel_for(meos_parallel_threads(nthreads),
+    (count + INDEX_KNN_CHUNK - 1) / INDEX_KNN_CHUNK, &sptree_knn_chunk,
+    &batch);
+  pfree((int *) batch.order);
+  return true;
+}
+
 /*****************************************************************************/
@@ -560,8 +560,8 @@ temporal_wagg_transfn(SkipList *state, const Temporal *temp,
 }
 
 /**
- * @brief Transition function for moving window count and average aggregation
- * for temporal values
+ * @brief Transition function for moving window average aggregation for
+ * temporal values
  */
 SkipList *
 temporal_wagg_transform_transfn(SkipList *state, const Temporal *temp,
@@ -577,4 +577,21 @@ temporal_wagg_transform_transfn(SkipList *state, const Temporal *temp,
   return result;
 }
 
+/**
+ * @brief Transition function for moving window count aggregation for
+ * temporal values
+ * @note The window count only needs the spans of the extended values, which
+ * are accumulated as events as for the temporal count
+ */
+SkipList *
+temporal_wcount_transfn(SkipList *state, const Temporal *temp,
+  const Interval *interv)
+{
+  int count;
+  TSequence **sequences = temporal_transform_wcount(temp, interv, &count);
+  SkipList *result = tcount_seqarr_events(state, sequences, count);
+  pfree_array((void **) sequences, count);
+  return result;
+}
+
 /*****************************************************************************/
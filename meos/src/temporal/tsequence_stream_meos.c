@@ -0,0 +1,550 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming construction of temporal sequences keyed by an identifier
+ * @details A stream accumulates the instants of many moving objects, such as
+ * the positions of the ships of an AIS feed, into one expandable sequence per
+ * object identifier. The sequences are found through an open-addressing hash
+ * table keyed by the identifier and grow by doubling their capacity, so that
+ * appending an instant takes amortized constant time.
+ *
+ * A sequence is passed to the function of the stream, and its instants are
+ * released, when
+ * - the next instant of its object is separated from its last instant by a
+ *   gap in distance, in time, or in speed, in which case the sequence is
+ *   finished and a new one starts with the instant,
+ * - it reaches the maximum number of instants of the stream,
+ * - the total memory of the sequences exceeds the budget of the stream, in
+ *   which case the sequences whose last instant is the oldest are released
+ *   until the memory falls below three quarters of the budget,
+ * - the stream is flushed.
+ * Except when the sequence is finished or flushed, the last instants of a
+ * released sequence are kept as the start of the next one, so that the
+ * successive sequences of an object overlap by these instants.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "temporal/temporal.h"
+#include "temporal/tsequence.h"
+#include "temporal/tsequenceset.h"
+#include "temporal/type_util.h"
+
+/* Initial number of entries of the hash table of a stream */
+#define TSEQSTREAM_INITIAL_KEYS 64
+/* Initial maximum number of instants of the sequence of a key */
+#define TSEQSTREAM_INITIAL_INSTS 64
+
+/**
+ * @brief Entry of the hash table of a stream
+ */
+typedef struct
+{
+  int64 key;                /**< Identifier of the object */
+  TSequence *seq;           /**< Expandable sequence, `NULL` when empty */
+  size_t size;              /**< Size in bytes of the sequence */
+  bool used;                /**< True when the entry holds a key */
+} TSeqStreamEntry;
+
+/**
+ * @brief Structure of a stream of temporal sequences
+ */
+struct TSeqStream
+{
+  TSeqStreamEntry *entries; /**< Hash table of the keys */
+  int capacity;             /**< Number of entries, a power of two */
+  int nkeys;                /**< Number of keys in the hash table */
+  interpType interp;        /**< Interpolation of the sequences */
+  double maxdist;           /**< Maximum distance between two instants */
+  bool hasmaxt;             /**< True when there is a maximum interval */
+  Interval maxt;            /**< Maximum interval between two instants */
+  double maxspeed;          /**< Maximum speed between two instants */
+  int maxinsts;             /**< Maximum number of instants of a sequence */
+  int keepinsts;            /**< Number of instants kept after a release */
+  size_t maxbytes;          /**< Memory budget of the sequences */
+  size_t nbytes;            /**< Memory of the sequences */
+  tseqstream_fn fn;         /**< Function consuming the sequences */
+  void *arg;                /**< Argument of the function */
+};
+
+/*****************************************************************************
+ * Hash table
+ *****************************************************************************/
+
+/**
+ * @brief Return the hash of a key
+ * @note The finalizer of SplitMix64 spreads consecutive identifiers over the
+ * whole table
+ */
+static inline uint64
+tseqstream_hash(int64 key)
+{
+  uint64 h = (uint64) key;
+  h = (h ^ (h >> 30)) * UINT64CONST(0xbf58476d1ce4e5b9);
+  h = (h ^ (h >> 27)) * UINT64CONST(0x94d049bb133111eb);
+  return h ^ (h >> 31);
+}
+
+/**
+ * @brief Return the entry of a key in a table, which is either the entry
+ * holding the key or the free entry where the key must be stored
+ */
+static TSeqStreamEntry *
+tseqstream_lookup(TSeqStreamEntry *entries, int capacity, int64 key)
+{
+  uint64 mask = (uint64) capacity - 1;
+  uint64 i = tseqstream_hash(key) & mask;
+  while (entries[i].used && entries[i].key != key)
+    i = (i + 1) & mask;
+  return &entries[i];
+}
+
+/**
+ * @brief Double the number of entries of the hash table of a stream
+ */
+static void
+tseqstream_grow(TSeqStream *stream)
+{
+  int capacity = stream->capacity * 2;
+  TSeqStreamEntry *entries = palloc0(sizeof(TSeqStreamEntry) * capacity);
+  for (int i = 0; i < stream->capacity; i++)
+  {
+    if (stream->entries[i].used)
+      *tseqstream_lookup(entries, capacity, stream->entries[i].key) =
+        stream->entries[i];
+  }
+  pfree(stream->entries);
+  stream->entries = entries;
+  stream->capacity = capacity;
+  return;
+}
+
+/*****************************************************************************
+ * Sequences of the keys
+ *****************************************************************************/
+
+/**
+ * @brief Set the sequence of an entry, accounting for its memory
+ */
+static void
+tseqstream_set_seq(TSeqStream *stream, TSeqStreamEntry *entry, TSequence *seq)
+{
+  stream->nbytes -= entry->size;
+  entry->seq = seq;
+  entry->size = seq ? VARSIZE(seq) : 0;
+  stream->nbytes += entry->size;
+  return;
+}
+
+/**
+ * @brief Return a new expandable sequence from the last instants of a
+ * sequence
+ * @param[in] seq Sequence
+ * @param[in] count Number of instants
+ * @param[in] maxcount Maximum number of instants of the result
+ * @param[in] lower_inc True when the lower bound of the result is inclusive
+ */
+static TSequence *
+tseqstream_seq_tail(const TSequence *seq, int count, int maxcount,
+  bool lower_inc)
+{
+  assert(count > 0 && count <= seq->count && count <= maxcount);
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = TSEQUENCE_INST_N(seq, seq->count - count + i);
+  TSequence *result = tsequence_make_exp1((TInstant **) instants, count,
+    maxcount, lower_inc, true, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO,
+    NULL);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Pass the sequence of an entry to the function of a stream and
+ * release it, keeping its last instants as the start of the next sequence
+ * when @p keep is true
+ */
+static void
+tseqstream_release(TSeqStream *stream, TSeqStreamEntry *entry, bool keep)
+{
+  TSequence *seq = entry->seq;
+  if (! seq)
+    return;
+  stream->fn(stream->arg, entry->key, seq);
+  TSequence *next = NULL;
+  int count = Min(stream->keepinsts, seq->count - 1);
+  if (keep && count > 0)
+  {
+    /* A sequence released because of its number of instants keeps its
+     * capacity, which the next instants of its object will fill again */
+    int maxcount = (stream->maxinsts > 0 && seq->count >= stream->maxinsts) ?
+      seq->maxcount : TSEQSTREAM_INITIAL_INSTS;
+    next = tseqstream_seq_tail(seq, count, Max(count, maxcount), true);
+  }
+  pfree(seq);
+  tseqstream_set_seq(stream, entry, next);
+  return;
+}
+
+/**
+ * @brief Comparator of the entries of a stream by the timestamp of the last
+ * instant of their sequence
+ */
+static int
+tseqstream_entry_cmp(const void *a, const void *b)
+{
+  const TSeqStreamEntry *e1 = *(const TSeqStreamEntry **) a;
+  const TSeqStreamEntry *e2 = *(const TSeqStreamEntry **) b;
+  TimestampTz t1 = TSEQUENCE_INST_N(e1->seq, e1->seq->count - 1)->t;
+  TimestampTz t2 = TSEQUENCE_INST_N(e2->seq, e2->seq->count - 1)->t;
+  if (t1 != t2)
+    return (t1 < t2) ? -1 : 1;
+  /* Release the biggest sequence first between equal timestamps */
+  if (e1->size != e2->size)
+    return (e1->size > e2->size) ? -1 : 1;
+  return (e1->key < e2->key) ? -1 : (e1->key > e2->key) ? 1 : 0;
+}
+
+/**
+ * @brief Release the sequences of a stream whose last instant is the oldest
+ * until its memory falls below three quarters of its budget
+ */
+static void
+tseqstream_shrink(TSeqStream *stream)
+{
+  TSeqStreamEntry **live = palloc(sizeof(TSeqStreamEntry *) * stream->nkeys);
+  int nlive = 0;
+  for (int i = 0; i < stream->capacity; i++)
+  {
+    if (stream->entries[i].seq)
+      live[nlive++] = &stream->entries[i];
+  }
+  qsort(live, (size_t) nlive, sizeof(TSeqStreamEntry *), tseqstream_entry_cmp);
+  size_t target = stream->maxbytes / 4 * 3;
+  for (int i = 0; i < nlive && stream->nbytes > target; i++)
+    tseqstream_release(stream, live[i], true);
+  pfree(live);
+  return;
+}
+
+/**
+ * @brief Return true when there is a gap in speed between the last instant of
+ * a sequence and an instant
+ */
+static bool
+tseqstream_speed_gap(const TSeqStream *stream, const TSequence *seq,
+  const TInstant *inst)
+{
+  const TInstant *last = TSEQUENCE_INST_N(seq, seq->count - 1);
+  if (inst->t <= last->t)
+    return false;
+  MeosType basetype = temptype_basetype(seq->temptype);
+  double dist = datum_distance(tinstant_value_p(last), tinstant_value_p(inst),
+    basetype, seq->flags);
+  double secs = (double) (inst->t - last->t) / USECS_PER_SEC;
+  return dist / secs > stream->maxspeed;
+}
+
+/*****************************************************************************
+ * Public functions
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a new stream of temporal sequences
+ * @param[in] interp Interpolation of the sequences
+ * @param[in] maxdist Maximum distance between two consecutive instants of a
+ * sequence, a value of 0 meaning no maximum
+ * @param[in] maxt Maximum interval between two consecutive instants of a
+ * sequence, may be `NULL`
+ * @param[in] maxspeed Maximum speed between two consecutive instants of a
+ * sequence in units of distance per second, a value of 0 meaning no maximum
+ * @param[in] fn Function receiving the sequences released by the stream
+ * @param[in] arg Argument passed to @p fn
+ * @note The function @p fn receives the argument @p arg, the key of the
+ * sequence, and the sequence, which belongs to the stream and is only valid
+ * for the duration of the call
+ */
+TSeqStream *
+tseqstream_make(interpType interp, double maxdist, const Interval *maxt,
+  double maxspeed, tseqstream_fn fn, void *arg)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(fn, NULL);
+  if (interp == INTERP_NONE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The interpolation of a stream must be given");
+    return NULL;
+  }
+  if (maxt && ! ensure_positive_duration(maxt))
+    return NULL;
+  if (maxdist < 0.0 || maxspeed < 0.0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The maximum distance and speed of a stream cannot be negative");
+    return NULL;
+  }
+
+  TSeqStream *result = palloc0(sizeof(TSeqStream));
+  result->capacity = TSEQSTREAM_INITIAL_KEYS;
+  result->entries = palloc0(sizeof(TSeqStreamEntry) * result->capacity);
+  result->interp = interp;
+  result->maxdist = maxdist;
+  if (maxt)
+  {
+    result->hasmaxt = true;
+    result->maxt = *maxt;
+  }
+  result->maxspeed = maxspeed;
+  result->fn = fn;
+  result->arg = arg;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Set the limits of the memory held by a stream of temporal sequences
+ * @param[in,out] stream Stream
+ * @param[in] maxinsts Maximum number of instants of a sequence, a value of 0
+ * meaning no maximum
+ * @param[in] keepinsts Number of last instants of a released sequence kept as
+ * the start of the next sequence of its object
+ * @param[in] maxbytes Memory budget of the sequences in bytes, a value of 0
+ * meaning no budget
+ */
+bool
+tseqstream_set_limits(TSeqStream *stream, int maxinsts, int keepinsts,
+  size_t maxbytes)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(stream, false);
+  if (! ensure_not_negative(maxinsts) || ! ensure_not_negative(keepinsts))
+    return false;
+  if (maxinsts > 0 && keepinsts >= maxinsts)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of instants kept must be less than the maximum number of "
+      "instants of a stream");
+    return false;
+  }
+  stream->maxinsts = maxinsts;
+  stream->keepinsts = keepinsts;
+  stream->maxbytes = maxbytes;
+  if (maxbytes > 0 && stream->nbytes > maxbytes)
+    tseqstream_shrink(stream);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Append an instant to the sequence of a key of a stream, releasing
+ * the sequences that reach the limits of the stream
+ * @param[in,out] stream Stream
+ * @param[in] key Identifier of the object
+ * @param[in] inst Instant, which is copied into the stream
+ * @return False on error, such as an instant that is not after the last
+ * instant of its object or whose type differs from it, in which case the
+ * instant is not appended
+ */
+bool
+tseqstream_append(TSeqStream *stream, int64 key, const TInstant *inst)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(stream, false); VALIDATE_NOT_NULL(inst, false);
+  if (stream->maxspeed > 0.0)
+  {
+    MeosType basetype = temptype_basetype(inst->temptype);
+    if (! tnumber_basetype(basetype) && ! geo_basetype(basetype))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+        "A stream with a maximum speed requires numbers or points");
+      return false;
+    }
+  }
+
+  /* Keep the load factor of the hash table at most one half */
+  if (2 * (stream->nkeys + 1) > stream->capacity)
+    tseqstream_grow(stream);
+  TSeqStreamEntry *entry = tseqstream_lookup(stream->entries,
+    stream->capacity, key);
+  if (! entry->used)
+  {
+    entry->used = true;
+    entry->key = key;
+    stream->nkeys++;
+  }
+
+  TSequence *seq = entry->seq;
+  if (seq && stream->maxspeed > 0.0 && seq->temptype == inst->temptype &&
+      tseqstream_speed_gap(stream, seq, inst))
+  {
+    tseqstream_release(stream, entry, false);
+    seq = NULL;
+  }
+
+  if (! seq)
+  {
+    int maxcount = TSEQSTREAM_INITIAL_INSTS;
+    if (stream->maxinsts > 0 && stream->maxinsts < maxcount)
+      maxcount = stream->maxinsts;
+    seq = tsequence_make_exp((TInstant **) &inst, 1, maxcount, true, true,
+      stream->interp, NORMALIZE_NO);
+    if (! seq)
+      return false;
+    tseqstream_set_seq(stream, entry, seq);
+  }
+  else
+  {
+    if (seq->temptype != inst->temptype)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+        "The instants of a key of a stream must be of the same type");
+      return false;
+    }
+    Temporal *temp = tsequence_append_tinstant(seq, inst, stream->maxdist,
+      stream->hasmaxt ? &stream->maxt : NULL, true);
+    /* On error the sequence is left unchanged */
+    if (! temp)
+      return false;
+    if (temp->subtype == TSEQUENCE)
+      /* The sequence is the same or a new one replacing the consumed one */
+      tseqstream_set_seq(stream, entry, (TSequence *) temp);
+    else
+    {
+      /* The instant starts a new sequence after a gap: the sequences of the
+       * result but the last one are finished */
+      TSequenceSet *ss = (TSequenceSet *) temp;
+      tseqstream_set_seq(stream, entry, NULL);
+      for (int i = 0; i < ss->count - 1; i++)
+        stream->fn(stream->arg, key, TSEQUENCESET_SEQ_N(ss, i));
+      const TSequence *last = TSEQUENCESET_SEQ_N(ss, ss->count - 1);
+      int maxcount = Max(last->count, TSEQSTREAM_INITIAL_INSTS);
+      tseqstream_set_seq(stream, entry, tseqstream_seq_tail(last, last->count,
+        maxcount, last->period.lower_inc));
+      pfree(ss);
+    }
+  }
+
+  if (stream->maxinsts > 0 && entry->seq->count >= stream->maxinsts)
+    tseqstream_release(stream, entry, true);
+  if (stream->maxbytes > 0 && stream->nbytes > stream->maxbytes)
+    tseqstream_shrink(stream);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Pass the sequence of a key of a stream to the function of the stream
+ * and release it
+ * @param[in,out] stream Stream
+ * @param[in] key Identifier of the object
+ * @return True when the key had a sequence
+ */
+bool
+tseqstream_flush_key(TSeqStream *stream, int64 key)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(stream, false);
+  TSeqStreamEntry *entry = tseqstream_lookup(stream->entries,
+    stream->capacity, key);
+  if (! entry->seq)
+    return false;
+  tseqstream_release(stream, entry, false);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Pass all the sequences of a stream to the function of the stream and
+ * release them
+ * @param[in,out] stream Stream
+ * @return Number of sequences passed to the function, -1 on error
+ */
+int
+tseqstream_flush(TSeqStream *stream)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(stream, -1);
+  int result = 0;
+  for (int i = 0; i < stream->capacity; i++)
+  {
+    if (stream->entries[i].seq)
+    {
+      tseqstream_release(stream, &stream->entries[i], false);
+      result++;
+    }
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the memory in bytes of the sequences of a stream
+ * @param[in] stream Stream
+ */
+size_t
+tseqstream_mem_size(const TSeqStream *stream)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(stream, 0);
+  return stream->nbytes;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Free a stream of temporal sequences without passing its sequences
+ * to its function
+ * @param[in] stream Stream
+ * @note Call #tseqstream_flush before to pass the pending sequences
+ */
+void
+tseqstream_free(TSeqStream *stream)
+{
+  if (! stream)
+    return;
+  for (int i = 0; i < stream->capacity; i++)
+  {
+    if (stream->entries[i].seq)
+      pfree(stream->entries[i].seq);
+  }
+  pfree(stream->entries);
+  pfree(stream);
+  return;
+}
+
+/*****************************************************************************/
@@ -36,9 +36,13 @@
 /* C */
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include "port/pg_bswap.h"
 #include "utils/timestamp.h"
+/* PostGIS */
+#include <liblwgeom_internal.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -47,6 +51,7 @@
 #include "temporal/span.h"
 #include "temporal/tbox.h"
 #include "temporal/type_util.h"
+#include "geo/geo_funcs.h"
 #include "geo/postgis_funcs.h"
 #include "geo/stbox.h"
 #include "geo/tgeo_spatialfuncs.h"
@@ -1578,9 +1583,37 @@ byte_from_wkb_state(meos_wkb_parse_state *s)
 
 /**
  * @brief Swap bytes in-place for endian conversion
+ * @note The sizes of the numbers are swapped with a single instruction
  */
 static inline void swap_bytes(void *data, size_t size)
 {
+  switch (size)
+  {
+    case 2:
+    {
+      uint16 v;
+      memcpy(&v, data, 2);
+      v = pg_bswap16(v);
+      memcpy(data, &v, 2);
+      return;
+    }
+    case 4:
+    {
+      uint32 v;
+      memcpy(&v, data, 4);
+      v = pg_bswap32(v);
+      memcpy(data, &v, 4);
+      return;
+    }
+    case 8:
+    {
+      uint64 v;
+      memcpy(&v, data, 8);
+      v = pg_bswap64(v);
+      memcpy(data, &v, 8);
+      return;
+    }
+  }
   uint8_t *bytes = (uint8_t*)data;
   for (size_t i = 0; i < size/2; i++)
   {
@@ -1787,6 +1820,80 @@ geo_from_wkb_state(meos_wkb_parse_state *s)
   return result;
 }
 
+/**
+ * @brief Read a point of a temporal point from its WKB representation
+ * @details Fast path of #geo_from_wkb_state for the points of a temporal
+ * point, which reads the coordinates without building a PostGIS geometry
+ * @param[in,out] s Parse state
+ * @param[out] coords Coordinates of the point
+ * @return False, leaving the parse state unchanged, when the value is not a
+ * nonempty point with the dimensionality and the SRID of the temporal point
+ * followed by a timestamp, which must then be read by #geo_from_wkb_state
+ */
+static bool
+tpoint_point_from_wkb_state(meos_wkb_parse_state *s, double *coords)
+{
+  const uint8_t *pos = s->pos;
+  size_t avail = s->wkb_size - (size_t) (pos - s->wkb);
+  if (avail < MEOS_WKB_BYTE_SIZE + MEOS_WKB_INT4_SIZE || pos[0] > 1)
+    return false;
+  /* Each geometry has its own endian flag */
+  bool swap = MEOS_IS_BIG_ENDIAN ? (pos[0] == 1) : (pos[0] == 0);
+  uint32 wkb_type;
+  memcpy(&wkb_type, pos + MEOS_WKB_BYTE_SIZE, MEOS_WKB_INT4_SIZE);
+  if (swap)
+    wkb_type = pg_bswap32(wkb_type);
+  pos += MEOS_WKB_BYTE_SIZE + MEOS_WKB_INT4_SIZE;
+
+  /* Get the flags from either the extended or the ISO type number */
+  bool hasz, has_srid = false;
+  if (wkb_type & 0xF0000000)
+  {
+    if ((wkb_type & WKBMOFFSET) || (wkb_type & 0x0FFFFFFF) != WKB_POINT_TYPE)
+      return false;
+    hasz = (wkb_type & WKBZOFFSET) != 0;
+    has_srid = (wkb_type & WKBSRIDFLAG) != 0;
+  }
+  else if (wkb_type == WKB_POINT_TYPE || wkb_type == WKB_POINT_TYPE + 1000)
+    hasz = (wkb_type != WKB_POINT_TYPE);
+  else
+    return false;
+  int ndims = hasz ? 3 : 2;
+  size_t size = MEOS_WKB_BYTE_SIZE + MEOS_WKB_INT4_SIZE +
+    (has_srid ? MEOS_WKB_INT4_SIZE : 0) + ndims * MEOS_WKB_DOUBLE_SIZE +
+    MEOS_WKB_TIMESTAMP_SIZE;
+  if (hasz != s->hasz || avail < size)
+    return false;
+  if (has_srid)
+  {
+    uint32 srid;
+    memcpy(&srid, pos, MEOS_WKB_INT4_SIZE);
+    if (swap)
+      srid = pg_bswap32(srid);
+    if ((int32_t) srid != s->srid)
+      return false;
+    pos += MEOS_WKB_INT4_SIZE;
+  }
+
+  /* Read the coordinates */
+  uint64 words[3];
+  memcpy(words, pos, ndims * MEOS_WKB_DOUBLE_SIZE);
+  if (swap)
+  {
+    for (int i = 0; i < ndims; i++)
+      words[i] = pg_bswap64(words[i]);
+  }
+  memcpy(coords, words, ndims * MEOS_WKB_DOUBLE_SIZE);
+  /* An empty point has NaN coordinates */
+  for (int i = 0; i < ndims; i++)
+  {
+    if (isnan(coords[i]))
+      return false;
+  }
+  s->pos = pos + ndims * MEOS_WKB_DOUBLE_SIZE;
+  return true;
+}
+
 #if CBUFFER
 /**
  * @brief Read a circular buffer and advance the parse state forward
@@ -2503,6 +2610,83 @@ tinstarr_from_wkb_state(meos_wkb_parse_state *s, int count)
   return result;
 }
 
+/**
+ * @brief Return a temporal point instant array from its WKB representation
+ * @details The instants are stored after the array of pointers in a single
+ * allocation, which is freed with the array. Since the points of a temporal
+ * point share their dimensionality and SRID, the first instant is built once
+ * and the other ones are copies of it with their own coordinates and
+ * timestamp.
+ * @return On a value that is not read by #tpoint_point_from_wkb_state return
+ * `NULL`, leaving the parse state unchanged
+ */
+static TInstant **
+tpointinstarr_from_wkb_state(meos_wkb_parse_state *s, int count)
+{
+  assert(tpoint_type(s->temptype));
+  const uint8_t *start = s->pos;
+  double coords[3] = {0};
+  if (! tpoint_point_from_wkb_state(s, coords))
+    return NULL;
+  TimestampTz t = timestamp_from_wkb_state(s);
+  int32_t srid = (s->geodetic && s->srid == SRID_UNKNOWN) ?
+    SRID_DEFAULT : s->srid;
+  TInstant *first = tinstant_make_free(PointerGetDatum(geopoint_make(
+    coords[0], coords[1], coords[2], s->hasz, s->geodetic, srid)),
+    s->temptype, t);
+  size_t instsize = VARSIZE(first);
+  size_t arrsize = DOUBLE_PAD(sizeof(TInstant *) * count);
+  char *block = palloc(arrsize + DOUBLE_PAD(instsize) * count);
+  TInstant **result = (TInstant **) block;
+  size_t ncoords = (s->hasz ? 3 : 2) * sizeof(double);
+  for (int i = 0; i < count; i++)
+  {
+    if (i > 0)
+    {
+      if (! tpoint_point_from_wkb_state(s, coords))
+      {
+        pfree(block); pfree(first);
+        s->pos = start;
+        return NULL;
+      }
+      t = timestamp_from_wkb_state(s);
+    }
+    TInstant *inst = (TInstant *) (block + arrsize + DOUBLE_PAD(instsize) * i);
+    memcpy(inst, first, instsize);
+    inst->t = t;
+    memcpy(GS_POINT_PTR(DatumGetGserializedP(tinstant_value_p(inst))),
+      coords, ncoords);
+    result[i] = inst;
+  }
+  pfree(first);
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence value from an instant array read from its
+ * WKB representation
+ */
+static TSequence *
+tsequence_from_wkb_instants(meos_wkb_parse_state *s, int count,
+  bool lower_inc, bool upper_inc)
+{
+  /* The instants of a temporal point are read in a single allocation */
+  if (tpoint_type(s->temptype))
+  {
+    TInstant **instants = tpointinstarr_from_wkb_state(s, count);
+    if (instants)
+    {
+      TSequence *result = tsequence_make(instants, count, lower_inc,
+        upper_inc, s->interp, NORMALIZE);
+      pfree(instants);
+      return result;
+    }
+  }
+  TInstant **instants = tinstarr_from_wkb_state(s, count);
+  return tsequence_make_free(instants, count, lower_inc, upper_inc, s->interp,
+    NORMALIZE);
+}
+
 /**
  * @brief Return a temporal sequence value from its WKB representation
  */
@@ -2517,9 +2701,7 @@ tsequence_from_wkb_state(meos_wkb_parse_state *s)
   bool lower_inc, upper_inc;
   bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
   /* Parse the instants */
-  TInstant **instants = tinstarr_from_wkb_state(s, count);
-  return tsequence_make_free(instants, count, lower_inc, upper_inc, s->interp,
-    NORMALIZE);
+  return tsequence_from_wkb_instants(s, count, lower_inc, upper_inc);
 }
 
 /**
@@ -2542,16 +2724,8 @@ tsequenceset_from_wkb_state(meos_wkb_parse_state *s)
     bool lower_inc, upper_inc;
     bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
     /* Parse the instants */
-    TInstant **instants = palloc(sizeof(TInstant *) * ninst);
-    for (int j = 0; j < ninst; j++)
-    {
-      /* Parse the value and the timestamp to create the temporal instant */
-      Datum value = base_from_wkb_state(s);
-      TimestampTz t = timestamp_from_wkb_state(s);
-      instants[j] = tinstant_make_free(value, s->temptype, t);
-    }
-    sequences[i] = tsequence_make_free(instants, ninst, lower_inc, upper_inc,
-      s->interp, NORMALIZE);
+    sequences[i] = tsequence_from_wkb_instants(s, ninst, lower_inc,
+      upper_inc);
   }
   return tsequenceset_make_free(sequences, count, NORMALIZE);
 }
@@ -0,0 +1,1361 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming input of temporal values in MF-JSON representation
+ * @details The functions in this file read MF-JSON documents with a pull
+ * parser instead of building the json-c object tree of the whole document as
+ * done by #temporal_from_mfjson(). The input is read from a buffer or by
+ * chunks from a file, and the members of each JSON object are consumed as
+ * they are read. The `coordinates`, `values`, and `datetimes` arrays of a
+ * moving object are decoded into flat arrays of numbers and timestamps, from
+ * which the instants of the temporal value are built when the object is
+ * closed. The temporal value is then passed to a function given by the
+ * caller and the arrays are released, so that the memory used only depends
+ * on the size of the largest moving object and not on the size of the
+ * document.
+ *
+ * Every object whose `type` is a moving type is read as a temporal value,
+ * whatever its depth in the document. This covers a single moving object, a
+ * sequence of moving objects separated by white space such as a file with
+ * one object per line, an array of moving objects, and a `FeatureCollection`
+ * whose features have a `temporalGeometry` member. The other members of the
+ * document are skipped.
+ *
+ * The streaming reader supports the types whose values are JSON scalars or
+ * point coordinates, that is, `MovingBoolean`, `MovingInteger`,
+ * `MovingBigInteger`, `MovingFloat`, `MovingText`, and `MovingPoint`. The
+ * other moving types must be read with #temporal_from_mfjson().
+ */
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/datetime.h>
+#include <utils/timestamp.h>
+/* PostGIS */
+#include <liblwgeom.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "temporal/temporal.h"
+#include "temporal/tsequence.h"
+#include "temporal/tsequenceset.h"
+#include "temporal/type_util.h"
+#include "geo/geo_funcs.h"
+
+#include <pgtypes.h>
+
+/* Size of the chunks read from a file */
+#define MFJSON_CHUNK_SIZE 65536
+/* Maximum nesting depth of the JSON values */
+#define MFJSON_MAX_DEPTH 256
+/* Maximum length of the type and interpolation names kept for an object */
+#define MFJSON_MAX_NAME 32
+/* Maximum length of a datetime */
+#define MFJSON_MAX_DATETIME 64
+
+/**
+ * @brief Scalar element of a `values` array
+ */
+typedef struct
+{
+  char kind;                  /**< 'n' number, 'b' boolean, 's' string */
+  bool integral;              /**< True when the number is an integer that
+                                   fits into an int64 */
+  int64 i;                    /**< Integer or boolean value */
+  double d;                   /**< Floating point value */
+  char *str;                  /**< String value */
+} MFJsonScalar;
+
+/**
+ * @brief Decoded arrays of a moving object or of one of its sequences
+ */
+typedef struct
+{
+  double *coords;             /**< Coordinates of the points */
+  int npoints;                /**< Number of points */
+  int maxpoints;              /**< Capacity of the coordinate array */
+  int dims;                   /**< Number of coordinates of the points */
+  MFJsonScalar *values;       /**< Scalar values */
+  int nvalues;                /**< Number of values */
+  int maxvalues;              /**< Capacity of the value array */
+  TimestampTz *times;         /**< Timestamps */
+  int ntimes;                 /**< Number of timestamps */
+  int maxtimes;               /**< Capacity of the timestamp array */
+  bool has_coords;            /**< True when the member `coordinates` was read */
+  bool has_values;            /**< True when the member `values` was read */
+  bool has_times;             /**< True when the member `datetimes` was read */
+  bool invalid_coords;        /**< True when `coordinates` is not an array of
+                                   2D or 3D points */
+  bool invalid_values;        /**< True when `values` is not an array of
+                                   scalars */
+  bool lower_inc;             /**< Lower bound flag, true by default */
+  bool upper_inc;             /**< Upper bound flag, true by default */
+} MFJsonSeq;
+
+/**
+ * @brief Members of a JSON object kept by the reader
+ */
+typedef struct
+{
+  char type[MFJSON_MAX_NAME]; /**< Value of the member `type` */
+  char interp[MFJSON_MAX_NAME]; /**< Value of the member `interpolation` */
+  int32_t srid;               /**< SRID given by the member `crs` */
+  bool has_srid;              /**< True when the member `crs` has an SRID */
+  MFJsonSeq seq;              /**< Arrays of the object */
+  MFJsonSeq *seqs;            /**< Arrays of the members of `sequences` */
+  int nseqs;                  /**< Number of sequences */
+  int maxseqs;                /**< Capacity of the sequence array */
+  bool has_seqs;              /**< True when the member `sequences` was read */
+} MFJsonObject;
+
+/**
+ * @brief State of the streaming reader
+ */
+typedef struct
+{
+  FILE *file;                 /**< Input file, `NULL` for a buffer */
+  const char *buf;            /**< Current chunk of the input */
+  size_t len;                 /**< Length of the current chunk */
+  size_t pos;                 /**< Position in the current chunk */
+  size_t offset;              /**< Offset of the current chunk in the input */
+  char *chunk;                /**< Buffer of the chunks read from the file */
+  char *str;                  /**< Last string or number read */
+  size_t strlen;              /**< Length of the last string or number */
+  size_t maxstr;              /**< Capacity of the string buffer */
+  int depth;                  /**< Nesting depth of the current value */
+  bool geodetic;              /**< True when points are read as geographies */
+  mfjson_read_fn fn;          /**< Function receiving the temporal values */
+  void *arg;                  /**< Argument of the function */
+  int count;                  /**< Number of temporal values read */
+  bool stop;                  /**< True when the function asked to stop */
+  bool error;                 /**< True when an error was raised */
+} MFJsonParser;
+
+static bool mfjson_parse_value(MFJsonParser *p);
+static bool mfjson_parse_object(MFJsonParser *p, MFJsonObject *obj);
+
+/*****************************************************************************
+ * Reading of the input
+ *****************************************************************************/
+
+/**
+ * @brief Raise an error for the current position of the input
+ * @details Only the first error is raised
+ */
+static bool
+mfjson_error(MFJsonParser *p, const char *format, ...)
+{
+  if (p->error)
+    return false;
+  p->error = true;
+  char msg[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(msg, sizeof(msg), format, args);
+  va_end(args);
+  meos_error(ERROR, MEOS_ERR_MFJSON_INPUT,
+    "Error while processing MFJSON string: %s (at offset %zu)", msg,
+    p->offset + p->pos);
+  return false;
+}
+
+/**
+ * @brief Read the next chunk of the input file, return false at the end of
+ * the input
+ */
+static bool
+mfjson_refill(MFJsonParser *p)
+{
+  if (! p->file || p->error)
+    return false;
+  size_t n = fread(p->chunk, 1, MFJSON_CHUNK_SIZE, p->file);
+  if (n == 0)
+  {
+    if (ferror(p->file))
+      mfjson_error(p, "unable to read the input file");
+    return false;
+  }
+  p->offset += p->len;
+  p->buf = p->chunk;
+  p->len = n;
+  p->pos = 0;
+  return true;
+}
+
+/**
+ * @brief Return the next character of the input without consuming it, or
+ * `EOF` at the end of the input
+ */
+static inline int
+mfjson_peek(MFJsonParser *p)
+{
+  if (p->pos == p->len && ! mfjson_refill(p))
+    return EOF;
+  return (unsigned char) p->buf[p->pos];
+}
+
+/**
+ * @brief Return and consume the next character of the input, or `EOF` at the
+ * end of the input
+ */
+static inline int
+mfjson_next(MFJsonParser *p)
+{
+  if (p->pos == p->len && ! mfjson_refill(p))
+    return EOF;
+  return (unsigned char) p->buf[p->pos++];
+}
+
+/**
+ * @brief Skip the white space and return the next character without
+ * consuming it
+ */
+static int
+mfjson_skip_ws(MFJsonParser *p)
+{
+  int c;
+  while ((c = mfjson_peek(p)) == ' ' || c == '\n' || c == '\r' || c == '\t')
+    p->pos++;
+  return c;
+}
+
+/**
+ * @brief Consume a given character after the white space
+ */
+static bool
+mfjson_expect(MFJsonParser *p, char expected)
+{
+  int c = mfjson_skip_ws(p);
+  if (c != expected)
+    return (c == EOF) ? mfjson_error(p, "unexpected end of input") :
+      mfjson_error(p, "expected '%c' instead of '%c'", expected, c);
+  p->pos++;
+  return true;
+}
+
+/**
+ * @brief Append a character to the string buffer of the reader
+ */
+static inline void
+mfjson_str_append(MFJsonParser *p, char c)
+{
+  if (p->strlen + 1 >= p->maxstr)
+  {
+    p->maxstr *= 2;
+    p->str = repalloc(p->str, p->maxstr);
+  }
+  p->str[p->strlen++] = c;
+}
+
+/**
+ * @brief Append a Unicode code point encoded in UTF-8 to the string buffer
+ */
+static void
+mfjson_str_append_utf8(MFJsonParser *p, uint32_t cp)
+{
+  if (cp < 0x80)
+    mfjson_str_append(p, (char) cp);
+  else if (cp < 0x800)
+  {
+    mfjson_str_append(p, (char) (0xC0 | (cp >> 6)));
+    mfjson_str_append(p, (char) (0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x10000)
+  {
+    mfjson_str_append(p, (char) (0xE0 | (cp >> 12)));
+    mfjson_str_append(p, (char) (0x80 | ((cp >> 6) & 0x3F)));
+    mfjson_str_append(p, (char) (0x80 | (cp & 0x3F)));
+  }
+  else
+  {
+    mfjson_str_append(p, (char) (0xF0 | (cp >> 18)));
+    mfjson_str_append(p, (char) (0x80 | ((cp >> 12) & 0x3F)));
+    mfjson_str_append(p, (char) (0x80 | ((cp >> 6) & 0x3F)));
+    mfjson_str_append(p, (char) (0x80 | (cp & 0x3F)));
+  }
+  return;
+}
+
+/**
+ * @brief Read the four hexadecimal digits of a `\u` escape
+ */
+static bool
+mfjson_parse_hex4(MFJsonParser *p, uint32_t *result)
+{
+  uint32_t cp = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    int c = mfjson_next(p);
+    cp <<= 4;
+    if (c >= '0' && c <= '9')
+      cp |= (uint32_t) (c - '0');
+    else if (c >= 'a' && c <= 'f')
+      cp |= (uint32_t) (c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      cp |= (uint32_t) (c - 'A' + 10);
+    else
+      return mfjson_error(p, "invalid Unicode escape in string");
+  }
+  *result = cp;
+  return true;
+}
+
+/**
+ * @brief Read a string into the string buffer of the reader, decoding its
+ * escape sequences
+ */
+static bool
+mfjson_parse_string(MFJsonParser *p)
+{
+  if (! mfjson_expect(p, '"'))
+    return false;
+  p->strlen = 0;
+  while (true)
+  {
+    /* Copy the characters up to the next quote or escape in one pass */
+    while (p->pos < p->len)
+    {
+      char c = p->buf[p->pos];
+      if (c == '"' || c == '\\')
+        break;
+      mfjson_str_append(p, c);
+      p->pos++;
+    }
+    int c = mfjson_next(p);
+    if (c == EOF)
+      return mfjson_error(p, "unterminated string");
+    if (c == '"')
+      break;
+    if (c != '\\')
+    {
+      /* Only reached when the chunk was exhausted */
+      mfjson_str_append(p, (char) c);
+      continue;
+    }
+    c = mfjson_next(p);
+    switch (c)
+    {
+      case '"': mfjson_str_append(p, '"'); break;
+      case '\\': mfjson_str_append(p, '\\'); break;
+      case '/': mfjson_str_append(p, '/'); break;
+      case 'b': mfjson_str_append(p, '\b'); break;
+      case 'f': mfjson_str_append(p, '\f'); break;
+      case 'n': mfjson_str_append(p, '\n'); break;
+      case 'r': mfjson_str_append(p, '\r'); break;
+      case 't': mfjson_str_append(p, '\t'); break;
+      case 'u':
+      {
+        uint32_t cp, low;
+        if (! mfjson_parse_hex4(p, &cp))
+          return false;
+        /* Combine a surrogate pair into one code point */
+        if (cp >= 0xD800 && cp <= 0xDBFF)
+        {
+          if (mfjson_next(p) != '\\' || mfjson_next(p) != 'u' ||
+              ! mfjson_parse_hex4(p, &low) || low < 0xDC00 || low > 0xDFFF)
+            return mfjson_error(p, "invalid Unicode surrogate pair in string");
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        mfjson_str_append_utf8(p, cp);
+        break;
+      }
+      default:
+        return mfjson_error(p, "invalid escape in string");
+    }
+  }
+  p->str[p->strlen] = '\0';
+  return true;
+}
+
+/**
+ * @brief Read a number
+ */
+static bool
+mfjson_parse_number(MFJsonParser *p, MFJsonScalar *result)
+{
+  bool integral = true;
+  int c;
+  p->strlen = 0;
+  while ((c = mfjson_peek(p)) != EOF && ((c >= '0' && c <= '9') || c == '-' ||
+    c == '+' || c == '.' || c == 'e' || c == 'E'))
+  {
+    if (c == '.' || c == 'e' || c == 'E')
+      integral = false;
+    mfjson_str_append(p, (char) c);
+    p->pos++;
+  }
+  p->str[p->strlen] = '\0';
+  char *end;
+  result->kind = 'n';
+  result->d = strtod(p->str, &end);
+  if (p->strlen == 0 || end != p->str + p->strlen)
+    return mfjson_error(p, "invalid number '%s'", p->str);
+  if (integral)
+  {
+    errno = 0;
+    result->i = strtoll(p->str, &end, 10);
+    integral = (errno == 0);
+  }
+  result->integral = integral;
+  return true;
+}
+
+/**
+ * @brief Read one of the literals `true`, `false`, and `null`
+ */
+static bool
+mfjson_parse_literal(MFJsonParser *p, MFJsonScalar *result)
+{
+  const char *lit;
+  int c = mfjson_peek(p);
+  if (c == 't')
+    lit = "true";
+  else if (c == 'f')
+    lit = "false";
+  else if (c == 'n')
+    lit = "null";
+  else
+    return (c == EOF) ? mfjson_error(p, "unexpected end of input") :
+      mfjson_error(p, "unexpected character '%c'", c);
+  for (const char *l = lit; *l; l++)
+  {
+    if (mfjson_next(p) != *l)
+      return mfjson_error(p, "invalid literal, expected '%s'", lit);
+  }
+  result->kind = (c == 'n') ? 'z' : 'b';
+  result->i = (c == 't');
+  return true;
+}
+
+/**
+ * @brief Read a scalar value
+ */
+static bool
+mfjson_parse_scalar(MFJsonParser *p, MFJsonScalar *result)
+{
+  int c = mfjson_skip_ws(p);
+  if (c == '"')
+  {
+    result->kind = 's';
+    return mfjson_parse_string(p);
+  }
+  if (c == '-' || (c >= '0' && c <= '9'))
+    return mfjson_parse_number(p, result);
+  return mfjson_parse_literal(p, result);
+}
+
+/**
+ * @brief Enter an object or an array
+ */
+static inline bool
+mfjson_enter(MFJsonParser *p, char open)
+{
+  if (++p->depth > MFJSON_MAX_DEPTH)
+    return mfjson_error(p, "maximum nesting depth exceeded");
+  return mfjson_expect(p, open);
+}
+
+/**
+ * @brief Read the separator after an element of an object or an array
+ * @return True when there is a next element, false at the end of the object
+ * or the array or on error
+ */
+static bool
+mfjson_next_element(MFJsonParser *p, char close)
+{
+  int c = mfjson_skip_ws(p);
+  p->pos++;
+  if (c == ',')
+    return true;
+  if (c == close)
+  {
+    p->depth--;
+    return false;
+  }
+  if (c == EOF)
+    mfjson_error(p, "unexpected end of input");
+  else
+    mfjson_error(p, "expected ',' or '%c' instead of '%c'", close, c);
+  return false;
+}
+
+/**
+ * @brief Read the opening of an object or an array
+ * @return True when the object or array has elements, false when it is empty
+ * or on error
+ */
+static bool
+mfjson_first_element(MFJsonParser *p, char open, char close)
+{
+  if (! mfjson_enter(p, open))
+    return false;
+  if (mfjson_skip_ws(p) == close)
+  {
+    p->pos++;
+    p->depth--;
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Reading of the members of a moving object
+ *****************************************************************************/
+
+/**
+ * @brief Read a string member into a fixed-size buffer, skip it if it is not
+ * a string
+ */
+static bool
+mfjson_parse_name(MFJsonParser *p, char *name)
+{
+  if (mfjson_skip_ws(p) != '"')
+    return mfjson_parse_value(p);
+  if (! mfjson_parse_string(p))
+    return false;
+  strlcpy(name, p->str, MFJSON_MAX_NAME);
+  return true;
+}
+
+/**
+ * @brief Read a boolean member, skip it with a warning if it is not a boolean
+ */
+static bool
+mfjson_parse_bound(MFJsonParser *p, const char *key, bool *result)
+{
+  int c = mfjson_skip_ws(p);
+  if (c != 't' && c != 'f')
+  {
+    meos_error(WARNING, MEOS_ERR_MFJSON_INPUT,
+      "Type of '%s' value in MFJSON string is not boolean, defaulting to true",
+      key);
+    return mfjson_parse_value(p);
+  }
+  MFJsonScalar value;
+  if (! mfjson_parse_literal(p, &value))
+    return false;
+  *result = (bool) value.i;
+  return true;
+}
+
+/**
+ * @brief Read the member `crs` and keep the SRID of its name
+ */
+static bool
+mfjson_parse_crs(MFJsonParser *p, MFJsonObject *obj)
+{
+  if (mfjson_skip_ws(p) != '{')
+    return mfjson_parse_value(p);
+  if (! mfjson_first_element(p, '{', '}'))
+    return ! p->error;
+  do
+  {
+    if (! mfjson_parse_string(p) || ! mfjson_expect(p, ':'))
+      return false;
+    if (pg_strcasecmp(p->str, "properties") != 0 ||
+        mfjson_skip_ws(p) != '{')
+    {
+      if (! mfjson_parse_value(p))
+        return false;
+      continue;
+    }
+    if (! mfjson_first_element(p, '{', '}'))
+      continue;
+    do
+    {
+      if (! mfjson_parse_string(p) || ! mfjson_expect(p, ':'))
+        return false;
+      if (pg_strcasecmp(p->str, "name") == 0 && mfjson_skip_ws(p) == '"')
+      {
+        if (! mfjson_parse_string(p))
+          return false;
+        obj->has_srid = (sscanf(p->str, "EPSG:%d", &obj->srid) == 1);
+      }
+      else if (! mfjson_parse_value(p))
+        return false;
+    } while (mfjson_next_element(p, '}'));
+    if (p->error)
+      return false;
+  } while (mfjson_next_element(p, '}'));
+  return ! p->error;
+}
+
+/**
+ * @brief Read one point of the member `coordinates`
+ */
+static bool
+mfjson_parse_point(MFJsonParser *p, MFJsonSeq *seq)
+{
+  double coords[3];
+  int ncoords = 0;
+  if (mfjson_skip_ws(p) != '[')
+  {
+    seq->invalid_coords = true;
+    return mfjson_parse_value(p);
+  }
+  if (! mfjson_first_element(p, '[', ']'))
+  {
+    seq->invalid_coords = true;
+    return ! p->error;
+  }
+  do
+  {
+    int c = mfjson_skip_ws(p);
+    if (c == '-' || (c >= '0' && c <= '9'))
+    {
+      MFJsonScalar value;
+      if (! mfjson_parse_number(p, &value))
+        return false;
+      if (ncoords < 3)
+        coords[ncoords] = value.d;
+      ncoords++;
+    }
+    else
+    {
+      seq->invalid_coords = true;
+      if (! mfjson_parse_value(p))
+        return false;
+    }
+  } while (mfjson_next_element(p, ']'));
+  if (p->error)
+    return false;
+  if (ncoords < 2 || ncoords > 3 || (seq->dims && ncoords != seq->dims))
+  {
+    seq->invalid_coords = true;
+    return true;
+  }
+  seq->dims = ncoords;
+  if (seq->npoints == seq->maxpoints)
+  {
+    seq->maxpoints *= 2;
+    seq->coords = repalloc(seq->coords, sizeof(double) * 3 * seq->maxpoints);
+  }
+  memcpy(&seq->coords[seq->npoints * 3], coords, sizeof(double) * ncoords);
+  seq->npoints++;
+  return true;
+}
+
+/**
+ * @brief Read the member `coordinates`
+ */
+static bool
+mfjson_parse_coords(MFJsonParser *p, MFJsonSeq *seq)
+{
+  seq->has_coords = true;
+  if (mfjson_skip_ws(p) != '[')
+  {
+    seq->invalid_coords = true;
+    return mfjson_parse_value(p);
+  }
+  if (! seq->coords)
+  {
+    seq->maxpoints = 64;
+    seq->coords = palloc(sizeof(double) * 3 * seq->maxpoints);
+  }
+  if (! mfjson_first_element(p, '[', ']'))
+    return ! p->error;
+  do
+  {
+    if (! mfjson_parse_point(p, seq))
+      return false;
+  } while (mfjson_next_element(p, ']'));
+  return ! p->error;
+}
+
+/**
+ * @brief Read the member `values`
+ */
+static bool
+mfjson_parse_values(MFJsonParser *p, MFJsonSeq *seq)
+{
+  seq->has_values = true;
+  if (mfjson_skip_ws(p) != '[')
+  {
+    seq->invalid_values = true;
+    return mfjson_parse_value(p);
+  }
+  if (! seq->values)
+  {
+    seq->maxvalues = 64;
+    seq->values = palloc(sizeof(MFJsonScalar) * seq->maxvalues);
+  }
+  if (! mfjson_first_element(p, '[', ']'))
+    return ! p->error;
+  do
+  {
+    int c = mfjson_skip_ws(p);
+    if (c == '{' || c == '[')
+    {
+      seq->invalid_values = true;
+      if (! mfjson_parse_value(p))
+        return false;
+      continue;
+    }
+    MFJsonScalar value;
+    if (! mfjson_parse_scalar(p, &value))
+      return false;
+    if (value.kind == 'z')
+    {
+      seq->invalid_values = true;
+      continue;
+    }
+    if (value.kind == 's')
+      value.str = pnstrdup(p->str, p->strlen);
+    if (seq->nvalues == seq->maxvalues)
+    {
+      seq->maxvalues *= 2;
+      seq->values = repalloc(seq->values,
+        sizeof(MFJsonScalar) * seq->maxvalues);
+    }
+    seq->values[seq->nvalues++] = value;
+  } while (mfjson_next_element(p, ']'));
+  return ! p->error;
+}
+
+/**
+ * @brief Read the digits of a fixed-width decimal number
+ */
+static inline bool
+mfjson_digits(const char *str, int n, int *result)
+{
+  int value = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (str[i] < '0' || str[i] > '9')
+      return false;
+    value = value * 10 + (str[i] - '0');
+  }
+  *result = value;
+  return true;
+}
+
+/**
+ * @brief Decode a datetime of the form `YYYY-MM-DDTHH:MM:SS[.ffffff]` followed
+ * by a UTC offset `Z`, `+HH`, `+HH:MM`, or `+HHMM`
+ * @details This is the form produced by the MF-JSON output of MEOS. Since the
+ * offset is explicit, the timestamp is computed without looking up the time
+ * zone of the session. Return false for any other form, which is then decoded
+ * by the timestamptz input function.
+ */
+static bool
+mfjson_fast_timestamptz(const char *str, size_t len, TimestampTz *result)
+{
+  int year, month, day, hour, min, sec, tzh = 0, tzm = 0;
+  if (len < 20 || str[4] != '-' || str[7] != '-' || str[10] != 'T' ||
+      str[13] != ':' || str[16] != ':' ||
+      ! mfjson_digits(str, 4, &year) || ! mfjson_digits(str + 5, 2, &month) ||
+      ! mfjson_digits(str + 8, 2, &day) || ! mfjson_digits(str + 11, 2, &hour) ||
+      ! mfjson_digits(str + 14, 2, &min) || ! mfjson_digits(str + 17, 2, &sec))
+    return false;
+  if (year < 1 || month < 1 || month > 12 || day < 1 ||
+      day > day_tab[isleap(year)][month - 1] || hour > 23 || min > 59 ||
+      sec > 59)
+    return false;
+  size_t pos = 19;
+  int64 fsec = 0;
+  if (str[pos] == '.')
+  {
+    int ndigits = 0;
+    pos++;
+    while (pos < len && str[pos] >= '0' && str[pos] <= '9')
+    {
+      /* Keep the microseconds, the timestamptz input rounds the others */
+      if (ndigits == 6)
+        return false;
+      fsec = fsec * 10 + (str[pos++] - '0');
+      ndigits++;
+    }
+    if (ndigits == 0)
+      return false;
+    for (; ndigits < 6; ndigits++)
+      fsec *= 10;
+  }
+  int sign;
+  if (pos < len && str[pos] == 'Z')
+  {
+    sign = 0;
+    pos++;
+  }
+  else if (pos + 3 <= len && (str[pos] == '+' || str[pos] == '-') &&
+    mfjson_digits(str + pos + 1, 2, &tzh))
+  {
+    sign = (str[pos] == '-') ? -1 : 1;
+    pos += 3;
+    if (pos < len && str[pos] == ':')
+      pos++;
+    if (pos + 2 <= len && mfjson_digits(str + pos, 2, &tzm))
+      pos += 2;
+  }
+  else
+    return false;
+  if (pos != len || tzh > 15 || tzm > 59)
+    return false;
+  int64 days = (int64) date2j(year, month, day) - POSTGRES_EPOCH_JDATE;
+  int64 secs = ((days * HOURS_PER_DAY + hour) * MINS_PER_HOUR + min) *
+    SECS_PER_MINUTE + sec - sign * (tzh * SECS_PER_HOUR + tzm * SECS_PER_MINUTE);
+  *result = (TimestampTz) (secs * USECS_PER_SEC + fsec);
+  return true;
+}
+
+/**
+ * @brief Read the member `datetimes`
+ */
+static bool
+mfjson_parse_datetimes(MFJsonParser *p, MFJsonSeq *seq)
+{
+  seq->has_times = true;
+  if (mfjson_skip_ws(p) != '[')
+    return mfjson_error(p, "invalid 'datetimes' array");
+  if (! seq->times)
+  {
+    seq->maxtimes = 64;
+    seq->times = palloc(sizeof(TimestampTz) * seq->maxtimes);
+  }
+  if (! mfjson_first_element(p, '[', ']'))
+    return ! p->error;
+  do
+  {
+    if (mfjson_skip_ws(p) != '"')
+      return mfjson_error(p, "invalid value in 'datetimes' array");
+    if (! mfjson_parse_string(p))
+      return false;
+    TimestampTz t;
+    if (! mfjson_fast_timestamptz(p->str, p->strlen, &t))
+    {
+      if (p->strlen > MFJSON_MAX_DATETIME)
+        return mfjson_error(p, "invalid value in 'datetimes' array");
+      /* Replace 'T' by ' ' before converting to timestamptz */
+      char *sep = strchr(p->str, 'T');
+      if (sep)
+        *sep = ' ';
+      meos_errno_reset();
+      /* The last argument is for an unused typmod */
+      t = pg_timestamptz_in(p->str, -1);
+      if (meos_errno())
+      {
+        p->error = true;
+        return false;
+      }
+    }
+    if (seq->ntimes == seq->maxtimes)
+    {
+      seq->maxtimes *= 2;
+      seq->times = repalloc(seq->times, sizeof(TimestampTz) * seq->maxtimes);
+    }
+    seq->times[seq->ntimes++] = t;
+  } while (mfjson_next_element(p, ']'));
+  return ! p->error;
+}
+
+/**
+ * @brief Initialize the arrays of a moving object or of a sequence
+ */
+static void
+mfjson_seq_init(MFJsonSeq *seq)
+{
+  memset(seq, 0, sizeof(MFJsonSeq));
+  seq->lower_inc = seq->upper_inc = true;
+  return;
+}
+
+/**
+ * @brief Free the arrays of a moving object or of a sequence
+ */
+static void
+mfjson_seq_free(MFJsonSeq *seq)
+{
+  if (seq->coords)
+    pfree(seq->coords);
+  if (seq->values)
+  {
+    for (int i = 0; i < seq->nvalues; i++)
+    {
+      if (seq->values[i].kind == 's')
+        pfree(seq->values[i].str);
+    }
+    pfree(seq->values);
+  }
+  if (seq->times)
+    pfree(seq->times);
+  return;
+}
+
+/**
+ * @brief Free the members kept for an object
+ */
+static void
+mfjson_object_free(MFJsonObject *obj)
+{
+  mfjson_seq_free(&obj->seq);
+  for (int i = 0; i < obj->nseqs; i++)
+    mfjson_seq_free(&obj->seqs[i]);
+  if (obj->seqs)
+    pfree(obj->seqs);
+  return;
+}
+
+/**
+ * @brief Read the member `sequences`
+ */
+static bool
+mfjson_parse_sequences(MFJsonParser *p, MFJsonObject *obj)
+{
+  obj->has_seqs = true;
+  if (mfjson_skip_ws(p) != '[')
+    return mfjson_error(p, "invalid 'sequences' array");
+  if (! mfjson_first_element(p, '[', ']'))
+    return ! p->error;
+  do
+  {
+    if (mfjson_skip_ws(p) != '{')
+      return mfjson_error(p, "invalid value in 'sequences' array");
+    MFJsonObject seqobj;
+    if (! mfjson_parse_object(p, &seqobj))
+    {
+      mfjson_object_free(&seqobj);
+      return false;
+    }
+    /* Keep only the arrays of the sequence */
+    if (obj->nseqs == obj->maxseqs)
+    {
+      obj->maxseqs = obj->maxseqs ? obj->maxseqs * 2 : 8;
+      obj->seqs = obj->seqs ?
+        repalloc(obj->seqs, sizeof(MFJsonSeq) * obj->maxseqs) :
+        palloc(sizeof(MFJsonSeq) * obj->maxseqs);
+    }
+    obj->seqs[obj->nseqs++] = seqobj.seq;
+    mfjson_seq_init(&seqobj.seq);
+    mfjson_object_free(&seqobj);
+  } while (mfjson_next_element(p, ']'));
+  return ! p->error;
+}
+
+/*****************************************************************************
+ * Construction of the temporal values
+ *****************************************************************************/
+
+/**
+ * @brief Return the temporal type of an MF-JSON type, or `T_UNKNOWN` when
+ * the type is not supported by the streaming reader
+ */
+static MeosType
+mfjson_temptype(const char *typestr, bool geodetic)
+{
+  if (strcmp(typestr, "MovingBoolean") == 0)
+    return T_TBOOL;
+  if (strcmp(typestr, "MovingInteger") == 0)
+    return T_TINT;
+  if (strcmp(typestr, "MovingBigInteger") == 0)
+    return T_TBIGINT;
+  if (strcmp(typestr, "MovingFloat") == 0)
+    return T_TFLOAT;
+  if (strcmp(typestr, "MovingText") == 0)
+    return T_TTEXT;
+  if (strcmp(typestr, "MovingPoint") == 0)
+    return geodetic ? T_TGEOGPOINT : T_TGEOMPOINT;
+  return T_UNKNOWN;
+}
+
+/**
+ * @brief Return the base value of a scalar element of a `values` array
+ */
+static bool
+mfjson_scalar_datum(MFJsonParser *p, const MFJsonScalar *value,
+  MeosType temptype, Datum *result)
+{
+  switch (temptype)
+  {
+    case T_TBOOL:
+      if (value->kind != 'b')
+        return mfjson_error(p,
+          "invalid boolean value in 'values' array");
+      *result = BoolGetDatum((bool) value->i);
+      return true;
+    case T_TINT:
+      if (value->kind != 'n' || ! value->integral ||
+          value->i < PG_INT32_MIN || value->i > PG_INT32_MAX)
+        return mfjson_error(p,
+          "invalid integer value in 'values' array");
+      *result = Int32GetDatum((int32) value->i);
+      return true;
+    case T_TBIGINT:
+      if (value->kind != 'n' || ! value->integral)
+        return mfjson_error(p,
+          "invalid integer value in 'values' array");
+      *result = Int64GetDatum(value->i);
+      return true;
+    case T_TFLOAT:
+      if (value->kind != 'n')
+        return mfjson_error(p, "invalid float value in 'values' array");
+      *result = Float8GetDatum(value->d);
+      return true;
+    default: /* T_TTEXT */
+      if (value->kind != 's')
+        return mfjson_error(p, "invalid string value in 'values' array");
+      *result = PointerGetDatum(cstring_to_text(value->str));
+      return true;
+  }
+}
+
+/**
+ * @brief Return the array of instants built from the arrays of a moving
+ * object or of a sequence
+ */
+static TInstant **
+mfjson_seq_instants(MFJsonParser *p, const MFJsonSeq *seq, MeosType temptype,
+  int32_t srid)
+{
+  bool point = tpoint_type(temptype);
+  const char *member = point ? "coordinates" : "values";
+  if (! seq->has_times)
+  {
+    mfjson_error(p, "unable to find 'datetimes'");
+    return NULL;
+  }
+  if (point ? ! seq->has_coords : ! seq->has_values)
+  {
+    mfjson_error(p, "unable to find '%s'", member);
+    return NULL;
+  }
+  if (point ? seq->invalid_coords : seq->invalid_values)
+  {
+    mfjson_error(p, "invalid '%s' array", member);
+    return NULL;
+  }
+  int count = point ? seq->npoints : seq->nvalues;
+  if (count != seq->ntimes || count < 1)
+  {
+    mfjson_error(p, "distinct number of elements in '%s' and 'datetimes' "
+      "arrays", member);
+    return NULL;
+  }
+
+  bool geodetic = tgeodetic_type(temptype);
+  TInstant **result = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    Datum value = (Datum) 0;
+    if (point)
+    {
+      const double *coords = &seq->coords[i * 3];
+      value = PointerGetDatum(geopoint_make(coords[0], coords[1],
+        seq->dims == 3 ? coords[2] : 0.0, seq->dims == 3, geodetic, srid));
+    }
+    else if (! mfjson_scalar_datum(p, &seq->values[i], temptype, &value))
+    {
+      pfree_array((void **) result, i);
+      return NULL;
+    }
+    result[i] = tinstant_make_free(value, temptype, seq->times[i]);
+  }
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence built from the arrays of a moving object
+ * or of a sequence
+ */
+static TSequence *
+mfjson_seq_make(MFJsonParser *p, const MFJsonSeq *seq, MeosType temptype,
+  int32_t srid, interpType interp)
+{
+  TInstant **instants = mfjson_seq_instants(p, seq, temptype, srid);
+  if (! instants)
+    return NULL;
+  return tsequence_make_free(instants, seq->ntimes, seq->lower_inc,
+    seq->upper_inc, interp, NORMALIZE);
+}
+
+/**
+ * @brief Return the temporal value of a moving object
+ */
+static Temporal *
+mfjson_object_temporal(MFJsonParser *p, const MFJsonObject *obj,
+  MeosType temptype)
+{
+  int32_t srid = 0;
+  if (tspatial_type(temptype))
+    srid = obj->has_srid ? obj->srid :
+      (tgeodetic_type(temptype) ? WGS84_SRID : 0);
+
+  if (obj->interp[0] == '\0')
+  {
+    mfjson_error(p, "unable to find 'interpolation'");
+    return NULL;
+  }
+  if (strcmp(obj->interp, "None") == 0)
+  {
+    TInstant **instants = mfjson_seq_instants(p, &obj->seq, temptype, srid);
+    if (! instants)
+      return NULL;
+    if (obj->seq.ntimes != 1)
+    {
+      pfree_array((void **) instants, obj->seq.ntimes);
+      mfjson_error(p, "invalid number of elements in '%s' and/or "
+        "'datetimes' arrays", tpoint_type(temptype) ? "coordinates" : "values");
+      return NULL;
+    }
+    TInstant *result = instants[0];
+    pfree(instants);
+    return (Temporal *) result;
+  }
+  if (strcmp(obj->interp, "Discrete") == 0)
+    return (Temporal *) mfjson_seq_make(p, &obj->seq, temptype, srid,
+      DISCRETE);
+  if (strcmp(obj->interp, "Step") != 0 && strcmp(obj->interp, "Linear") != 0)
+  {
+    mfjson_error(p, "invalid 'interpolation' value");
+    return NULL;
+  }
+  interpType interp = (strcmp(obj->interp, "Linear") == 0) ? LINEAR : STEP;
+  if (! obj->has_seqs)
+    return (Temporal *) mfjson_seq_make(p, &obj->seq, temptype, srid, interp);
+  if (obj->nseqs < 1)
+  {
+    mfjson_error(p, "invalid value of 'sequences' array");
+    return NULL;
+  }
+  TSequence **sequences = palloc(sizeof(TSequence *) * obj->nseqs);
+  for (int i = 0; i < obj->nseqs; i++)
+  {
+    sequences[i] = mfjson_seq_make(p, &obj->seqs[i], temptype, srid, interp);
+    if (! sequences[i])
+    {
+      pfree_array((void **) sequences, i);
+      return NULL;
+    }
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, obj->nseqs,
+    NORMALIZE);
+}
+
+/**
+ * @brief Pass to the function of the reader the temporal value of an object
+ * when it is a moving object
+ */
+static bool
+mfjson_object_emit(MFJsonParser *p, const MFJsonObject *obj)
+{
+  if (strncmp(obj->type, "Moving", 6) != 0)
+    return true;
+  MeosType temptype = mfjson_temptype(obj->type, p->geodetic);
+  if (temptype == T_UNKNOWN)
+    return mfjson_error(p, "type '%s' is not supported by the streaming "
+      "reader", obj->type);
+  Temporal *temp = mfjson_object_temporal(p, obj, temptype);
+  if (! temp)
+    return mfjson_error(p, "invalid '%s' value", obj->type);
+  p->count++;
+  /* The function takes ownership of the value */
+  if (! p->fn(p->arg, temp))
+    p->stop = true;
+  return true;
+}
+
+/*****************************************************************************
+ * Reading of JSON values
+ *****************************************************************************/
+
+/**
+ * @brief Read an object, keeping the members of a moving object
+ * @details The members of the moving object are recognized in a
+ * case-insensitive way as done by #temporal_from_mfjson(). The values of the
+ * other members are read with #mfjson_parse_value() so that the moving
+ * objects they contain are passed to the function of the reader.
+ */
+static bool
+mfjson_parse_object(MFJsonParser *p, MFJsonObject *obj)
+{
+  memset(obj, 0, sizeof(MFJsonObject));
+  mfjson_seq_init(&obj->seq);
+  if (! mfjson_first_element(p, '{', '}'))
+    return ! p->error;
+  do
+  {
+    if (mfjson_skip_ws(p) != '"')
+      return mfjson_error(p, "expected a member name");
+    if (! mfjson_parse_string(p) || ! mfjson_expect(p, ':'))
+      return false;
+    bool ok;
+    const char *key = p->str;
+    if (pg_strcasecmp(key, "type") == 0)
+      ok = mfjson_parse_name(p, obj->type);
+    else if (pg_strcasecmp(key, "interpolation") == 0)
+      ok = mfjson_parse_name(p, obj->interp);
+    else if (pg_strcasecmp(key, "crs") == 0)
+      ok = mfjson_parse_crs(p, obj);
+    else if (pg_strcasecmp(key, "coordinates") == 0)
+      ok = mfjson_parse_coords(p, &obj->seq);
+    else if (pg_strcasecmp(key, "values") == 0)
+      ok = mfjson_parse_values(p, &obj->seq);
+    else if (pg_strcasecmp(key, "datetimes") == 0)
+      ok = mfjson_parse_datetimes(p, &obj->seq);
+    else if (pg_strcasecmp(key, "lower_inc") == 0)
+      ok = mfjson_parse_bound(p, "lower_inc", &obj->seq.lower_inc);
+    else if (pg_strcasecmp(key, "upper_inc") == 0)
+      ok = mfjson_parse_bound(p, "upper_inc", &obj->seq.upper_inc);
+    else if (pg_strcasecmp(key, "sequences") == 0)
+      ok = mfjson_parse_sequences(p, obj);
+    else
+      ok = mfjson_parse_value(p);
+    if (! ok || p->stop)
+      return ok;
+  } while (mfjson_next_element(p, '}'));
+  return ! p->error;
+}
+
+/**
+ * @brief Read a JSON value, passing the moving objects it contains to the
+ * function of the reader
+ */
+static bool
+mfjson_parse_value(MFJsonParser *p)
+{
+  int c = mfjson_skip_ws(p);
+  if (c == '{')
+  {
+    MFJsonObject obj;
+    bool result = mfjson_parse_object(p, &obj);
+    if (result && ! p->stop)
+      result = mfjson_object_emit(p, &obj);
+    mfjson_object_free(&obj);
+    return result;
+  }
+  if (c == '[')
+  {
+    if (! mfjson_first_element(p, '[', ']'))
+      return ! p->error;
+    do
+    {
+      if (! mfjson_parse_value(p) || p->stop)
+        return ! p->error;
+    } while (mfjson_next_element(p, ']'));
+    return ! p->error;
+  }
+  MFJsonScalar value;
+  return mfjson_parse_scalar(p, &value);
+}
+
+/**
+ * @brief Read all the JSON values of the input
+ */
+static int
+mfjson_parse(MFJsonParser *p)
+{
+  p->maxstr = 256;
+  p->str = palloc(p->maxstr);
+  while (mfjson_skip_ws(p) != EOF && ! p->stop)
+  {
+    if (! mfjson_parse_value(p))
+      break;
+  }
+  pfree(p->str);
+  return p->error ? -1 : p->count;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Read the temporal values of an MF-JSON document held in a buffer
+ * and pass each of them to a function
+ * @details The document is read with a streaming parser that does not build
+ * the JSON tree of the document. Every moving object of the document is
+ * passed to the function as soon as it is read, which includes the moving
+ * objects of a `FeatureCollection` and those of a sequence of documents
+ * separated by white space. The function takes ownership of the temporal
+ * value and returns false to stop the reading.
+ * @param[in] mfjson Buffer
+ * @param[in] size Size of the buffer in bytes
+ * @param[in] geodetic True when the moving points are read as temporal
+ * geography points
+ * @param[in] fn Function receiving the temporal values
+ * @param[in] arg Argument passed to the function
+ * @return Number of temporal values passed to the function, -1 on error
+ * @note Only the types whose values are scalars or points are supported,
+ * the other types must be read with #temporal_from_mfjson()
+ */
+int
+temporal_from_mfjson_buffer(const char *mfjson, size_t size, bool geodetic,
+  mfjson_read_fn fn, void *arg)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(mfjson, -1); VALIDATE_NOT_NULL(fn, -1);
+
+  MFJsonParser p;
+  memset(&p, 0, sizeof(MFJsonParser));
+  p.buf = mfjson;
+  p.len = size;
+  p.geodetic = geodetic;
+  p.fn = fn;
+  p.arg = arg;
+  return mfjson_parse(&p);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Read the temporal values of an MF-JSON file and pass each of them
+ * to a function
+ * @details The file is read by chunks with the streaming parser of
+ * #temporal_from_mfjson_buffer(), so that files larger than the memory can
+ * be read.
+ * @param[in] file File opened for reading
+ * @param[in] geodetic True when the moving points are read as temporal
+ * geography points
+ * @param[in] fn Function receiving the temporal values
+ * @param[in] arg Argument passed to the function
+ * @return Number of temporal values passed to the function, -1 on error
+ */
+int
+temporal_from_mfjson_file(FILE *file, bool geodetic, mfjson_read_fn fn,
+  void *arg)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(file, -1); VALIDATE_NOT_NULL(fn, -1);
+
+  MFJsonParser p;
+  memset(&p, 0, sizeof(MFJsonParser));
+  p.file = file;
+  p.chunk = palloc(MFJSON_CHUNK_SIZE);
+  p.buf = p.chunk;
+  p.geodetic = geodetic;
+  p.fn = fn;
+  p.arg = arg;
+  int result = mfjson_parse(&p);
+  pfree(p.chunk);
+  return result;
+}
@@ -39,6 +39,7 @@
 #include <postgres.h>
 #include <miscadmin.h>
 #include <varatt.h>
+#include <port/pg_bswap.h>
 #include <utils/datetime.h>
 #include <utils/timestamp.h>
 #include <utils/varlena.h>
@@ -215,6 +216,54 @@ basetype_out(Datum value, MeosType type, int maxdd)
  * Output in MF-JSON representation
  *****************************************************************************/
 
+/* Number of bytes accumulated in the string buffer before it is written into
+ * the destination of the streaming MF-JSON output */
+#define MFJSON_SINK_CHUNK 65536
+
+/**
+ * @brief Destination of the streaming MF-JSON output
+ * @details The output is built in a string buffer that is written into the
+ * destination and emptied each time it exceeds #MFJSON_SINK_CHUNK bytes, so
+ * that the memory used does not depend on the size of the temporal value.
+ */
+typedef struct
+{
+  FILE *file;                 /**< Output file, `NULL` for a buffer */
+  char *buf;                  /**< Output buffer */
+  size_t size;                /**< Size of the output buffer */
+  size_t len;                 /**< Number of bytes produced so far */
+  bool failed;                /**< True when writing into the file failed */
+} MFJsonSink;
+
+/**
+ * @brief Write the content of the string buffer into the destination of the
+ * streaming output when it exceeds the chunk size or when forced
+ * @details Nothing is done when there is no destination, in which case the
+ * string buffer keeps the whole output. The bytes that do not fit into the
+ * output buffer are counted but not written.
+ */
+static void
+mfjson_sink_drain(stringbuffer_t *sb, MFJsonSink *sink, bool force)
+{
+  if (! sink)
+    return;
+  size_t len = (size_t) stringbuffer_getlength(sb);
+  if (len == 0 || (! force && len < MFJSON_SINK_CHUNK))
+    return;
+  const char *str = stringbuffer_getstring(sb);
+  if (sink->file)
+  {
+    if (! sink->failed && fwrite(str, 1, len, sink->file) != len)
+      sink->failed = true;
+  }
+  else if (sink->len + 1 < sink->size)
+    memcpy(sink->buf + sink->len, str,
+      Min(len, sink->size - 1 - sink->len));
+  sink->len += len;
+  stringbuffer_clear(sb);
+  return;
+}
+
 /**
  * @brief Write into the buffer an integer in the MF-JSON representation
  */
@@ -961,7 +1010,7 @@ tinstant_as_mfjson_sb(stringbuffer_t *sb, const TInstant *inst,
  */
 static bool
 tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq,
-  const bboxunion *box, int precision, const char *srs)
+  const bboxunion *box, int precision, const char *srs, MFJsonSink *sink)
 {
   bool success = temptype_as_mfjson_sb(sb, seq->temptype);
   /* Propagate errors up */
@@ -997,6 +1046,7 @@ tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq,
   const TInstant *inst;
   for (int i = 0; i < seq->count; i++)
   {
+    mfjson_sink_drain(sb, sink, false);
     if (i)
       stringbuffer_append_char(sb, ',');
     inst = TSEQUENCE_INST_N(seq, i);
@@ -1055,6 +1105,7 @@ tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq,
   stringbuffer_append_len(sb, "],\"datetimes\":[", 15);
   for (int i = 0; i < seq->count; i++)
   {
+    mfjson_sink_drain(sb, sink, false);
     if (i) stringbuffer_append_char(sb, ',');
     inst = TSEQUENCE_INST_N(seq, i);
     datetimes_as_mfjson_sb(sb, inst->t);
@@ -1074,7 +1125,7 @@ tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq,
  */
 static bool
 tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss,
-  const bboxunion *box, int precision, const char *srs)
+  const bboxunion *box, int precision, const char *srs, MFJsonSink *sink)
 {
   bool success = temptype_as_mfjson_sb(sb, ss->temptype);
   /* Propagate errors up */
@@ -1117,6 +1168,7 @@ tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss,
       stringbuffer_append_len(sb, "{\"values\":[", 11);
     for (int j = 0; j < seq->count; j++)
     {
+      mfjson_sink_drain(sb, sink, false);
       if (j)
         stringbuffer_append_char(sb, ',');
       inst = TSEQUENCE_INST_N(seq, j);
@@ -1174,6 +1226,7 @@ tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss,
     stringbuffer_append_len(sb, "],\"datetimes\":[", 15);
     for (int j = 0; j < seq->count; j++)
     {
+      mfjson_sink_drain(sb, sink, false);
       if (j) stringbuffer_append_char(sb, ',');
       inst = TSEQUENCE_INST_N(seq, j);
       datetimes_as_mfjson_sb(sb, inst->t);
@@ -1190,24 +1243,19 @@ tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss,
 /*****************************************************************************/
 
 /**
- * @ingroup meos_temporal_inout
- * @brief Return the MF-JSON representation of a temporal value
+ * @brief Write into the buffer a temporal value in the MF-JSON representation
+ * @param[in] sb String buffer
  * @param[in] temp Temporal value
  * @param[in] with_bbox True when the output value has bounding box
- * @param[in] flags Flags
- * @param[in] precision Number of decimal digits. It is only used when the base
- * type has floating point components, such as tfloat or tgeometry
+ * @param[in] precision Number of decimal digits
  * @param[in] srs Spatial reference system, may be `NULL`
- * @return On error return @p NULL
- * @csqlfn #Temporal_as_mfjson()
+ * @param[in] sink Destination of the streaming output, `NULL` when the
+ * string buffer keeps the whole output
  */
-char *
-temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
-  int precision, const char *srs)
+static bool
+temporal_as_mfjson_sb(stringbuffer_t *sb, const Temporal *temp,
+  bool with_bbox, int precision, const char *srs, MFJsonSink *sink)
 {
-  /* Ensure the validity of the arguments */
-  VALIDATE_NOT_NULL(temp, NULL);
-
   /* Get bounding box if needed */
   bboxunion *box = NULL, tmp;
   if (with_bbox)
@@ -1216,24 +1264,43 @@ temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
     box = &tmp;
   }
 
-  /* Create the string buffer */
-  stringbuffer_t *sb = stringbuffer_create();
-
-  bool res;
   assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
   {
     case TINSTANT:
-      res = tinstant_as_mfjson_sb(sb, (TInstant *) temp, box, precision, srs);
-      break;
-    case TSEQUENCE:
-      res = tsequence_as_mfjson_sb(sb, (TSequence *) temp, box, precision, 
+      return tinstant_as_mfjson_sb(sb, (TInstant *) temp, box, precision,
         srs);
-      break;
+    case TSEQUENCE:
+      return tsequence_as_mfjson_sb(sb, (TSequence *) temp, box, precision,
+        srs, sink);
     default: /* TSEQUENCESET */
-      res = tsequenceset_as_mfjson_sb(sb, (TSequenceSet *) temp, box,
-        precision, srs);
+      return tsequenceset_as_mfjson_sb(sb, (TSequenceSet *) temp, box,
+        precision, srs, sink);
   }
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the MF-JSON representation of a temporal value
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] flags Flags
+ * @param[in] precision Number of decimal digits. It is only used when the base
+ * type has floating point components, such as tfloat or tgeometry
+ * @param[in] srs Spatial reference system, may be `NULL`
+ * @return On error return @p NULL
+ * @csqlfn #Temporal_as_mfjson()
+ */
+char *
+temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
+  int precision, const char *srs)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temp, NULL);
+
+  /* Create the string buffer */
+  stringbuffer_t *sb = stringbuffer_create();
+  bool res = temporal_as_mfjson_sb(sb, temp, with_bbox, precision, srs, NULL);
   /* Convert the string buffer to a C string */
   char *result = ! res ? NULL : stringbuffer_getstringcopy(sb);
 
@@ -1253,6 +1320,80 @@ temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
   return result;
 }
 
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value into a buffer
+ * @details The output is produced by chunks, without building the whole
+ * representation in memory. As for `snprintf`, at most `size - 1` bytes are
+ * written followed by a null byte, and the length of the whole
+ * representation is returned, so that a return value not smaller than
+ * `size` means that the output was truncated.
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system, may be `NULL`
+ * @param[out] buf Output buffer, may be `NULL` when `size` is 0
+ * @param[in] size Size of the output buffer
+ * @return Length of the MF-JSON representation, 0 on error
+ * @see #temporal_as_mfjson()
+ */
+size_t
+temporal_as_mfjson_buffer(const Temporal *temp, bool with_bbox, int precision,
+  const char *srs, char *buf, size_t size)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temp, 0);
+  if (size > 0)
+    VALIDATE_NOT_NULL(buf, 0);
+
+  MFJsonSink sink = { .buf = buf, .size = size };
+  stringbuffer_t *sb = stringbuffer_create();
+  bool res = temporal_as_mfjson_sb(sb, temp, with_bbox, precision, srs,
+    &sink);
+  if (res)
+    mfjson_sink_drain(sb, &sink, true);
+  stringbuffer_destroy(sb);
+  if (size > 0)
+    buf[Min(sink.len, size - 1)] = '\0';
+  return res ? sink.len : 0;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value into a file
+ * @details The output is written by chunks, without building the whole
+ * representation in memory.
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system, may be `NULL`
+ * @param[in] file File opened for writing
+ * @return On error return false
+ * @see #temporal_as_mfjson()
+ */
+bool
+temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision,
+  const char *srs, FILE *file)
+{
+  /* Ensure the validity of the arguments */
+  VALIDATE_NOT_NULL(temp, false); VALIDATE_NOT_NULL(file, false);
+
+  MFJsonSink sink = { .file = file };
+  stringbuffer_t *sb = stringbuffer_create();
+  bool res = temporal_as_mfjson_sb(sb, temp, with_bbox, precision, srs,
+    &sink);
+  if (res)
+    mfjson_sink_drain(sb, &sink, true);
+  stringbuffer_destroy(sb);
+  if (sink.failed)
+  {
+    meos_error(ERROR, MEOS_ERR_MFJSON_OUTPUT,
+      "Unable to write the MFJSON representation into the file");
+    return false;
+  }
+  return res;
+}
+
 /*****************************************************************************
  * Output in Well-Known Binary (WKB) representation
  *
@@ -1285,6 +1426,29 @@ spatial_wkb_needs_srid(int32_t srid, uint8_t variant)
   return false;
 }
 
+/**
+ * @brief Return true if a geo value is a nonempty point without M
+ * coordinate, whose Well-Known Binary (WKB) representation is written without
+ * building a PostGIS geometry
+ */
+static inline bool
+geo_wkb_fast_point(const GSERIALIZED *gs)
+{
+  return gserialized_get_type(gs) == POINTTYPE &&
+    ! FLAGS_GET_M(gs->gflags) && ! gserialized_is_empty(gs);
+}
+
+/**
+ * @brief Return true if a point needs to output its SRID in the Well-Known
+ * Binary (WKB) representation, as decided by PostGIS for a geometry
+ */
+static inline bool
+point_wkb_needs_srid(const GSERIALIZED *gs, uint8_t variant)
+{
+  return ! (variant & WKB_NO_SRID) &&
+    spatial_wkb_needs_srid(gserialized_get_srid(gs), variant);
+}
+
 /**
  * @brief Return the size of the WKB representation of the geo value
  * @note Since the geo is embedded in a container such as a set or a temporal
@@ -1293,6 +1457,11 @@ spatial_wkb_needs_srid(int32_t srid, uint8_t variant)
 static size_t
 geo_to_wkb_size(const GSERIALIZED *gs, uint8_t variant)
 {
+  if (geo_wkb_fast_point(gs))
+    /* Endian flag + type + SRID (if requested) + coordinates */
+    return MEOS_WKB_BYTE_SIZE + MEOS_WKB_INT4_SIZE +
+      (point_wkb_needs_srid(gs, variant) ? MEOS_WKB_INT4_SIZE : 0) +
+      (FLAGS_GET_Z(gs->gflags) ? 3 : 2) * MEOS_WKB_DOUBLE_SIZE;
   /* On the non-extended path emit ISO WKB so the Z and M ordinates are encoded
    * without the SRID; the extended path already carries both. */
   uint8_t v = (variant & WKB_EXTENDED) ? variant : (variant | (uint8_t) WKB_ISO);
@@ -1910,8 +2079,25 @@ bytes_to_wkb_buf(uint8_t *valptr, size_t size, uint8_t *buf, uint8_t variant)
     /* Machine/request arch mismatch, so flip byte order */
     if (wkb_swap_bytes(variant))
     {
-      for (size_t i = 0; i < size; i++)
-        buf[i] = valptr[size - 1 - i];
+      if (size == 8)
+      {
+        uint64 v;
+        memcpy(&v, valptr, 8);
+        v = pg_bswap64(v);
+        memcpy(buf, &v, 8);
+      }
+      else if (size == 4)
+      {
+        uint32 v;
+        memcpy(&v, valptr, 4);
+        v = pg_bswap32(v);
+        memcpy(buf, &v, 4);
+      }
+      else
+      {
+        for (size_t i = 0; i < size; i++)
+          buf[i] = valptr[size - 1 - i];
+      }
     }
     /* If machine arch and requested arch match, don't flip byte order */
     else
@@ -2079,6 +2265,40 @@ text_to_wkb_buf(const text *txt, uint8_t *buf, uint8_t variant)
   return payload_to_wkb_buf((const uint8_t *) str, size, buf, variant);
 }
 
+/**
+ * @brief Write into the buffer a nonempty point without M coordinate in the
+ * Well-Known Binary (WKB) representation
+ * @details The output is the one of PostGIS for the point, which is written
+ * from the serialized coordinates without building a PostGIS geometry
+ */
+static uint8_t *
+point_to_wkb_buf(const GSERIALIZED *gs, uint8_t *buf, uint8_t variant)
+{
+  bool hasz = FLAGS_GET_Z(gs->gflags);
+  bool needs_srid = point_wkb_needs_srid(gs, variant);
+  /* The extended type number carries the flags in its upper bits, the ISO
+   * one adds 1000 for the Z coordinate */
+  uint32_t wkb_type = WKB_POINT_TYPE;
+  if (variant & WKB_EXTENDED)
+  {
+    if (hasz)
+      wkb_type |= WKBZOFFSET;
+    if (needs_srid)
+      wkb_type |= WKBSRIDFLAG;
+  }
+  else if (hasz)
+    wkb_type += 1000;
+  buf = endian_to_wkb_buf(buf, variant);
+  buf = bytes_to_wkb_buf((uint8_t *) &wkb_type, MEOS_WKB_INT4_SIZE, buf,
+    variant);
+  if (needs_srid)
+    buf = int32_to_wkb_buf(gserialized_get_srid(gs), buf, variant);
+  const double *coords = (const double *) GS_POINT_PTR(gs);
+  for (int i = 0; i < (hasz ? 3 : 2); i++)
+    buf = double_to_wkb_buf(coords[i], buf, variant);
+  return buf;
+}
+
 /**
  * @brief Write into the buffer a geo value in the Well-Known Binary (WKB)
  * representation
@@ -2086,6 +2306,8 @@ text_to_wkb_buf(const text *txt, uint8_t *buf, uint8_t variant)
 static uint8_t *
 geo_to_wkb_buf(const GSERIALIZED *gs, uint8_t *buf, uint8_t variant)
 {
+  if (geo_wkb_fast_point(gs))
+    return point_to_wkb_buf(gs, buf, variant);
   /* On the non-extended path emit ISO WKB so the Z and M ordinates are encoded
    * without the SRID; the extended path already carries both. */
   uint8_t v = (variant & WKB_EXTENDED) ? variant : (variant | (uint8_t) WKB_ISO);
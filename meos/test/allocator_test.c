@@ -34,8 +34,10 @@
  * It installs a counting allocator via #meos_initialize_allocator, builds and
  * frees a temporal value, and verifies that (a) the custom allocator was
  * actually invoked (interposition) and (b) the tracked live bytes return to
- * zero after freeing (no leak, so free routes through the hook too). Finally it
- * reinstalls the default (libc) allocator.
+ * zero after freeing (no leak, so free routes through the hook too). It then
+ * opens an arena scope, restricts a batch large enough to be split between the
+ * threads of the pool, and verifies that closing the scope leaves no live
+ * bytes either. Finally it reinstalls the default (libc) allocator.
  *
  * The program can be build as follows
  * @code
@@ -49,6 +51,11 @@
 #include <stdlib.h>
 #include <meos.h>
 
+/* Size of the batch restricted in an arena scope, large enough for the batch
+ * functions to split it between the threads of the pool */
+#define BATCH_COUNT 1024
+#define BATCH_INSTANTS 8
+
 /* The palloc/pfree entry points route MEOS working-memory allocations through
  * the hook. They are exported by libmeos but are not part of the typed API, so
  * declare them here. */
@@ -72,8 +79,8 @@ counting_malloc(size_t size)
   void *p = malloc(size);
   if (p)
   {
-    live_bytes += malloc_usable_size(p);
-    n_malloc++;
+    __atomic_add_fetch(&live_bytes, malloc_usable_size(p), __ATOMIC_RELAXED);
+    __atomic_add_fetch(&n_malloc, 1, __ATOMIC_RELAXED);
   }
   return p;
 }
@@ -85,9 +92,9 @@ counting_realloc(void *ptr, size_t size)
   void *p = realloc(ptr, size);
   if (p)
   {
-    live_bytes += malloc_usable_size(p);
-    live_bytes -= old;
-    n_realloc++;
+    __atomic_add_fetch(&live_bytes, malloc_usable_size(p), __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&live_bytes, old, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&n_realloc, 1, __ATOMIC_RELAXED);
   }
   return p;
 }
@@ -97,8 +104,8 @@ counting_free(void *ptr)
 {
   if (ptr)
   {
-    live_bytes -= malloc_usable_size(ptr);
-    n_free++;
+    __atomic_sub_fetch(&live_bytes, malloc_usable_size(ptr), __ATOMIC_RELAXED);
+    __atomic_add_fetch(&n_free, 1, __ATOMIC_RELAXED);
     free(ptr);
   }
 }
@@ -159,6 +166,56 @@ int main(void)
   printf("Allocator hook interposition and zero-leak: OK\n");
   printf("****************************************************************\n");
 
+  printf("* Arena scope with a parallel batch *\n");
+  printf("****************************************************************\n");
+
+  /* Build the batch outside the scope */
+  meos_initialize_threads(4);
+  Temporal **batch = malloc(sizeof(Temporal *) * BATCH_COUNT);
+  TInstant *instants[BATCH_INSTANTS];
+  TimestampTz t0 = timestamptz_in("2000-01-01", -1);
+  for (int i = 0; i < BATCH_COUNT; i++)
+  {
+    for (int j = 0; j < BATCH_INSTANTS; j++)
+      instants[j] = tfloatinst_make(i + j, t0 + (TimestampTz) j * 60000000);
+    batch[i] = (Temporal *) tsequence_make(instants, BATCH_INSTANTS, true,
+      true, LINEAR, false);
+    for (int j = 0; j < BATCH_INSTANTS; j++)
+      pfree(instants[j]);
+  }
+  Span *span = tstzspan_in("[2000-01-01 00:01:00, 2000-01-01 00:05:00]");
+  Temporal **result = malloc(sizeof(Temporal *) * BATCH_COUNT);
+  /* Restrict the batch once outside a scope so that the workers of the pool
+   * have set their time zone before the live bytes are measured */
+  bool ok = temparr_at_tstzspan(batch, BATCH_COUNT, span, result);
+  assert(ok);
+  for (int i = 0; i < BATCH_COUNT; i++)
+    pfree(result[i]);
+  size_t before = live_bytes;
+
+  /* The restricted values are allocated in the scope, even if the batch is
+   * large enough to be split between the threads of the pool */
+  meos_arena_push();
+  ok = temparr_at_tstzspan(batch, BATCH_COUNT, span, result);
+  assert(ok && result[0] != NULL);
+  meos_arena_pop();
+  /* Give back the block that the arena keeps for the next scope */
+  meos_finalize_arena();
+
+  printf("live bytes before the scope: %zu\n", before);
+  printf("live bytes after closing the scope: %zu\n", live_bytes);
+  assert(live_bytes == before);
+
+  for (int i = 0; i < BATCH_COUNT; i++)
+    pfree(batch[i]);
+  pfree(span);
+  free(batch);
+  free(result);
+  meos_finalize_threads();
+
+  printf("Arena scope with a parallel batch zero-leak: OK\n");
+  printf("****************************************************************\n");
+
   /* Reinstall the default allocator and finalize MEOS */
   meos_initialize_allocator(NULL, NULL, NULL);
   meos_finalize();
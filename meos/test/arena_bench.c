@@ -0,0 +1,270 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that benchmarks the arena scopes of MEOS, i.e.,
+ * meos_arena_push and meos_arena_pop, against the default allocation of each
+ * value with malloc and free.
+ *
+ * Two workloads are run with and without an arena scope, and their running
+ * times and the speedup are printed:
+ *  - assembly: trips of float instants are assembled into sequences, one
+ *    scope per trip, as in an ingest loop such as 03_ais_assemble.c;
+ *  - restriction: a long sequence is restricted to many periods and value
+ *    spans, one scope per run of restrictions.
+ *
+ * Four properties are asserted:
+ *  (i)   results: each workload computes the same checksum with and without
+ *        the arena;
+ *  (ii)  keep: a value copied out of a scope by meos_arena_keep is equal to
+ *        the one computed without the arena after the scope is closed;
+ *  (iii) nesting: closing a nested scope releases only its values, and the
+ *        scope depth is reported by meos_arena_depth;
+ *  (iv)  errors: closing a scope that is not open is rejected.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -O2 -I/usr/local/include -o arena_bench arena_bench.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <meos.h>
+
+/* Number of trips of the assembly workload */
+#define NUM_TRIPS 4000
+/* Number of instants of each trip */
+#define TRIP_INSTS 500
+/* Number of instants of the sequence of the restriction workload */
+#define SEQ_INSTS 20000
+/* Number of restrictions of the restriction workload */
+#define NUM_RESTRICTS 20000
+/* Number of restrictions per arena scope */
+#define RESTRICTS_PER_SCOPE 1000
+/* Microseconds between two instants */
+#define STEP_USECS ((TimestampTz) 10 * 1000000)
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+static double
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Value of the n-th instant of a trip */
+static double
+trip_value(int trip, int n)
+{
+  return (double) ((trip * 7919 + n * 104729) % 1000) / 10.0;
+}
+
+/* Return the sequence of a trip, freeing its instants unless they are in an
+ * arena scope */
+static TSequence *
+assemble_trip(int trip, TInstant **instants, bool arena)
+{
+  for (int n = 0; n < TRIP_INSTS; n++)
+    instants[n] = tfloatinst_make(trip_value(trip, n),
+      (TimestampTz) trip * 3600 * 1000000 + n * STEP_USECS);
+  TSequence *result = tsequence_make(instants, TRIP_INSTS, true, true, LINEAR,
+    true);
+  if (! arena)
+  {
+    for (int n = 0; n < TRIP_INSTS; n++)
+      free(instants[n]);
+  }
+  return result;
+}
+
+/* Run the assembly workload and return its checksum */
+static long
+run_assembly(bool arena)
+{
+  TInstant **instants = malloc(sizeof(TInstant *) * TRIP_INSTS);
+  long result = 0;
+  for (int trip = 0; trip < NUM_TRIPS; trip++)
+  {
+    if (arena)
+      meos_arena_push();
+    TSequence *seq = assemble_trip(trip, instants, arena);
+    result += temporal_num_instants((Temporal *) seq);
+    if (arena)
+      meos_arena_pop();
+    else
+      free(seq);
+  }
+  free(instants);
+  return result;
+}
+
+/* Return the long sequence of the restriction workload */
+static Temporal *
+restriction_seq(void)
+{
+  TInstant **instants = malloc(sizeof(TInstant *) * SEQ_INSTS);
+  for (int n = 0; n < SEQ_INSTS; n++)
+    instants[n] = tfloatinst_make(trip_value(1, n), n * STEP_USECS);
+  Temporal *result = (Temporal *) tsequence_make(instants, SEQ_INSTS, true,
+    true, LINEAR, true);
+  for (int n = 0; n < SEQ_INSTS; n++)
+    free(instants[n]);
+  free(instants);
+  return result;
+}
+
+/* Restrict the sequence to the n-th period and value span and return the
+ * number of instants of the results */
+static int
+restrict_seq(const Temporal *seq, int n, bool arena)
+{
+  TimestampTz lower = (TimestampTz) ((n * 7907) % (SEQ_INSTS - 200)) *
+    STEP_USECS;
+  Span *period = tstzspan_make(lower, lower + 150 * STEP_USECS, true, true);
+  Span *values = floatspan_make(20.0 + n % 50, 60.0 + n % 30, true, true);
+  Temporal *atperiod = temporal_at_tstzspan(seq, period);
+  Temporal *atvalues = tnumber_at_span(atperiod, values);
+  int result = temporal_num_instants(atperiod) +
+    (atvalues ? temporal_num_instants(atvalues) : 0);
+  if (! arena)
+  {
+    free(period); free(values); free(atperiod); free(atvalues);
+  }
+  return result;
+}
+
+/* Run the restriction workload and return its checksum */
+static long
+run_restriction(const Temporal *seq, bool arena)
+{
+  long result = 0;
+  for (int n = 0; n < NUM_RESTRICTS; n++)
+  {
+    if (arena && n % RESTRICTS_PER_SCOPE == 0)
+      meos_arena_push();
+    result += restrict_seq(seq, n, arena);
+    if (arena && (n + 1) % RESTRICTS_PER_SCOPE == 0)
+      meos_arena_pop();
+  }
+  return result;
+}
+
+/* Run a workload with and without an arena and print the times */
+static void
+bench(const char *name, long (*run)(const Temporal *, bool),
+  const Temporal *arg)
+{
+  /* A first run warms up the caches and the arena block */
+  run(arg, false); run(arg, true);
+  double start = now();
+  long plain = run(arg, false);
+  double tplain = now() - start;
+  start = now();
+  long arena = run(arg, true);
+  double tarena = now() - start;
+  printf("  %-12s malloc %8.3f s   arena %8.3f s   speedup %5.2fx\n", name,
+    tplain, tarena, tplain / tarena);
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%s: same checksum with the arena", name);
+  check(msg, plain == arena);
+}
+
+static long
+run_assembly_bench(const Temporal *arg, bool arena)
+{
+  (void) arg;
+  return run_assembly(arena);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+
+  printf("Benchmarking the arena scopes\n");
+  bench("assembly", run_assembly_bench, NULL);
+  Temporal *seq = restriction_seq();
+  bench("restriction", run_restriction, seq);
+
+  printf("Testing the arena scopes\n");
+  /* Keep a value out of a scope */
+  TInstant **instants = malloc(sizeof(TInstant *) * TRIP_INSTS);
+  TSequence *expected = assemble_trip(7, instants, false);
+  meos_arena_push();
+  TSequence *kept = meos_arena_keep(assemble_trip(7, instants, true));
+  meos_arena_pop();
+  check("a kept value outlives its scope",
+    temporal_eq((Temporal *) kept, (Temporal *) expected));
+  free(kept);
+
+  /* Nested scopes */
+  meos_arena_push();
+  TSequence *outer = assemble_trip(7, instants, true);
+  meos_arena_push();
+  check("the depth counts the open scopes", meos_arena_depth() == 2);
+  for (int trip = 0; trip < 100; trip++)
+    assemble_trip(trip, instants, true);
+  meos_arena_pop();
+  check("a nested pop keeps the values of the outer scope",
+    temporal_eq((Temporal *) outer, (Temporal *) expected));
+  meos_arena_pop();
+  check("the depth is 0 once all scopes are closed",
+    meos_arena_depth() == 0);
+  free(expected); free(instants);
+
+  meos_errno_reset();
+  meos_arena_pop();
+  check("closing a scope that is not open is rejected", meos_errno() != 0);
+  meos_errno_reset();
+
+  free(seq);
+  meos_finalize();
+  if (failures > 0)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return 1;
+  }
+  printf("\nAll tests passed\n");
+  return 0;
+}
@@ -0,0 +1,526 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the export and import of arrays of temporal
+ * values as columns of the Apache Arrow C Data Interface.
+ *
+ * The values are random temporal booleans, integers, big integers, floats,
+ * texts, and geometry and geography points, with and without Z, as
+ * instants and as discrete, step, and linear sequences.
+ *
+ * Five properties are asserted:
+ *  (i)   round trip: the values imported from the exported column are equal
+ *        to the exported values, for every type and interpolation;
+ *  (ii)  layout: the column is a list of structs with the fields described
+ *        in meos_arrow.h, whose timestamps are microseconds since 1970 and
+ *        whose metadata keeps the type, the interpolation, and the SRID;
+ *  (iii) foreign columns: a column with 64-bit list offsets, timestamps in
+ *        seconds, no metadata, and offsets in the list, the struct, and the
+ *        fields is imported with the default interpolation;
+ *  (iv)  nulls: the NULL values are exported as null lists and imported as
+ *        NULL values;
+ *  (v)   errors: arrays of sequence sets, of values of different types or
+ *        SRIDs, of sequences with exclusive bounds, or of NULL values only,
+ *        columns of instants with several instants per list, and timestamps
+ *        out of the range of the other epoch or of MEOS are refused.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o arrow_test arrow_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_arrow.h>
+#include <meos_geo.h>
+
+/* Number of random values per type and subtype */
+#define NUM_VALUES 20
+/* Maximum number of instants of a random value */
+#define MAX_INSTS 40
+/* Number of seconds between 1970-01-01 and 2000-01-01 */
+#define UNIX_2000 946684800
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Append to the string the value of the i-th instant of a type */
+static int
+append_value(char *buf, char type, int i, bool hasz)
+{
+  /* The values are not collinear so that the sequences keep every instant */
+  int v = 2 * i * i + rand() % 2;
+  switch (type)
+  {
+    case 'b':
+      return sprintf(buf, "%s", (i + rand()) % 2 ? "t" : "f");
+    case 'i':
+    case 'l':
+      return sprintf(buf, "%d", v);
+    case 'f':
+      return sprintf(buf, "%d.%d", v, rand() % 10);
+    case 't':
+      return sprintf(buf, "\"s%d\"", v);
+    default:
+      return hasz ? sprintf(buf, "Point(%d %d %d)", v % 90, i % 90, i) :
+        sprintf(buf, "Point(%d %d)", v % 90, i % 90);
+  }
+}
+
+/* Return a random value of a type as an instant (subtype 0) or a discrete,
+ * step, or linear sequence (subtypes 1 to 3) */
+static Temporal *
+random_value(char type, int subtype, bool hasz, const char *srid)
+{
+  char buf[MAX_INSTS * 64 + 64];
+  int n = (subtype == 0) ? 1 : 1 + rand() % MAX_INSTS;
+  int len = 0;
+  if (srid)
+    len += sprintf(buf + len, "SRID=%s;", srid);
+  if (subtype == 2)
+    len += sprintf(buf + len, "Interp=Step;");
+  if (subtype == 1)
+    len += sprintf(buf + len, "{");
+  else if (subtype > 1)
+    len += sprintf(buf + len, "[");
+  for (int i = 0; i < n; i++)
+  {
+    if (i > 0)
+      len += sprintf(buf + len, ", ");
+    len += append_value(buf + len, type, i, hasz);
+    len += sprintf(buf + len, "@2001-01-01 %02d:%02d:00+00", i / 60, i % 60);
+  }
+  if (subtype == 1)
+    len += sprintf(buf + len, "}");
+  else if (subtype > 1)
+    len += sprintf(buf + len, "]");
+  switch (type)
+  {
+    case 'b': return tbool_in(buf);
+    case 'i': return tint_in(buf);
+    case 'l': return tbigint_in(buf);
+    case 'f': return tfloat_in(buf);
+    case 't': return ttext_in(buf);
+    case 'p': return tgeompoint_in(buf);
+    default:  return tgeogpoint_in(buf);
+  }
+}
+
+/* Export and import an array of values and compare them */
+static bool
+round_trip(Temporal **values, int count)
+{
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  if (! temparr_as_arrow(values, count, &schema, &array))
+    return false;
+  int n;
+  Temporal **result = temparr_from_arrow(&schema, &array, &n);
+  schema.release(&schema);
+  array.release(&array);
+  if (! result)
+    return false;
+  bool ok = (n == count);
+  for (int i = 0; i < n; i++)
+  {
+    if (ok)
+      ok = (values[i] == NULL) ? (result[i] == NULL) :
+        (result[i] != NULL && temporal_eq(values[i], result[i]));
+    free(result[i]);
+  }
+  free(result);
+  return ok;
+}
+
+static void
+free_values(Temporal **values, int count)
+{
+  for (int i = 0; i < count; i++)
+    free(values[i]);
+}
+
+/* (i) round trip for every type and subtype */
+static void
+test_round_trip(void)
+{
+  printf("(i) round trip\n");
+  const char *types = "bilftpg";
+  const char *names[] = { "tbool", "tint", "tbigint", "tfloat", "ttext",
+    "tgeompoint", "tgeogpoint" };
+  const char *subtypes[] = { "instants", "discrete", "step", "linear" };
+  char name[128];
+  for (int t = 0; types[t]; t++)
+  {
+    char type = types[t];
+    for (int s = 0; s < 4; s++)
+    {
+      /* Booleans, integers, and texts do not have linear interpolation */
+      if (s == 3 && (type == 'b' || type == 'i' || type == 'l' || type == 't'))
+        continue;
+      for (int z = 0; z < ((type == 'p' || type == 'g') ? 2 : 1); z++)
+      {
+        const char *srid = (type == 'p') ? "3857" : NULL;
+        Temporal *values[NUM_VALUES];
+        for (int i = 0; i < NUM_VALUES; i++)
+          values[i] = random_value(type, s, z, srid);
+        snprintf(name, sizeof(name), "%s %s%s", names[t], subtypes[s],
+          z ? " with Z" : "");
+        check(name, round_trip(values, NUM_VALUES));
+        free_values(values, NUM_VALUES);
+      }
+    }
+  }
+}
+
+/* Return the value of a key of the metadata of a schema */
+static bool
+metadata_is(const char *metadata, const char *key, const char *value)
+{
+  int32_t count, len;
+  const char *ptr = metadata;
+  memcpy(&count, ptr, sizeof(int32_t));
+  ptr += sizeof(int32_t);
+  for (int i = 0; i < count; i++)
+  {
+    memcpy(&len, ptr, sizeof(int32_t));
+    bool found = ((size_t) len == strlen(key) &&
+      strncmp(ptr + sizeof(int32_t), key, len) == 0);
+    ptr += sizeof(int32_t) + len;
+    memcpy(&len, ptr, sizeof(int32_t));
+    if (found)
+      return (size_t) len == strlen(value) &&
+        strncmp(ptr + sizeof(int32_t), value, len) == 0;
+    ptr += sizeof(int32_t) + len;
+  }
+  return false;
+}
+
+/* (ii) layout of the exported column */
+static void
+test_layout(void)
+{
+  printf("(ii) layout\n");
+  Temporal *values[2];
+  values[0] = tgeompoint_in("SRID=3857;[Point(1 2)@2000-01-01 00:00:00+00, "
+    "Point(3 4)@2000-01-01 00:00:01+00]");
+  values[1] = tgeompoint_in("SRID=3857;[Point(5 6)@1970-01-01 00:00:00+00]");
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  bool ok = temparr_as_arrow(values, 2, &schema, &array);
+  check("export", ok);
+  if (ok)
+  {
+    struct ArrowSchema *item = schema.children[0];
+    check("schema is a list of structs",
+      strcmp(schema.format, "+l") == 0 && schema.n_children == 1 &&
+      strcmp(item->format, "+s") == 0 && item->n_children == 3);
+    check("fields t, x, and y",
+      strcmp(item->children[0]->name, "t") == 0 &&
+      strcmp(item->children[0]->format, "tsu:UTC") == 0 &&
+      strcmp(item->children[1]->name, "x") == 0 &&
+      strcmp(item->children[1]->format, "g") == 0 &&
+      strcmp(item->children[2]->name, "y") == 0);
+    check("metadata",
+      metadata_is(schema.metadata, "meos.type", "tgeompoint") &&
+      metadata_is(schema.metadata, "meos.interp", "Linear") &&
+      metadata_is(schema.metadata, "meos.srid", "3857"));
+    const int32_t *offsets = array.buffers[1];
+    check("list offsets", array.length == 2 && array.null_count == 0 &&
+      offsets[0] == 0 && offsets[1] == 2 && offsets[2] == 3);
+    struct ArrowArray *items = array.children[0];
+    const int64_t *times = items->children[0]->buffers[1];
+    const double *xs = items->children[1]->buffers[1];
+    const double *ys = items->children[2]->buffers[1];
+    check("timestamps since 1970",
+      items->length == 3 && times[0] == (int64_t) UNIX_2000 * 1000000 &&
+      times[1] == (int64_t) UNIX_2000 * 1000000 + 1000000 && times[2] == 0);
+    check("coordinates", xs[0] == 1 && ys[0] == 2 && xs[1] == 3 &&
+      ys[1] == 4 && xs[2] == 5 && ys[2] == 6);
+    schema.release(&schema);
+    check("schema released", schema.release == NULL);
+    array.release(&array);
+    check("array released", array.release == NULL);
+  }
+  free_values(values, 2);
+}
+
+/* No-op release callback of the foreign column */
+static void
+release_schema(struct ArrowSchema *schema)
+{
+  schema->release = NULL;
+}
+
+static void
+release_array(struct ArrowArray *array)
+{
+  array->release = NULL;
+}
+
+/* (iii) column produced by another implementation */
+static void
+test_foreign(void)
+{
+  printf("(iii) foreign columns\n");
+  /* The column skips its first list, the struct skips its first instant,
+   * and the fields skip their first element, so that the instants of the
+   * two lists read are at the positions 3 to 7 of the fields */
+  int64_t offsets[] = { 0, 1, 3, 6 };
+  int64_t times[] = { 0, 0, 0, UNIX_2000 + 10, UNIX_2000 + 20,
+    UNIX_2000 + 30, UNIX_2000 + 40, UNIX_2000 + 50 };
+  double values[] = { 0, 0, 0, 1, 2, 10, 20, 40 };
+  const void *listbufs[] = { NULL, offsets };
+  const void *structbufs[] = { NULL };
+  const void *timebufs[] = { NULL, times };
+  const void *valuebufs[] = { NULL, values };
+
+  /* The fields are not in the order of the exported columns */
+  struct ArrowSchema tschema = { .format = "tss:", .name = "t",
+    .release = &release_schema };
+  struct ArrowSchema vschema = { .format = "g", .name = "v",
+    .release = &release_schema };
+  struct ArrowSchema *fields[] = { &vschema, &tschema };
+  struct ArrowSchema sschema = { .format = "+s", .name = "item",
+    .n_children = 2, .children = fields, .release = &release_schema };
+  struct ArrowSchema *items[] = { &sschema };
+  struct ArrowSchema schema = { .format = "+L", .name = "speed",
+    .flags = ARROW_FLAG_NULLABLE, .n_children = 1, .children = items,
+    .release = &release_schema };
+
+  struct ArrowArray tarray = { .length = 6, .offset = 1, .n_buffers = 2,
+    .buffers = timebufs, .release = &release_array };
+  struct ArrowArray varray = { .length = 6, .offset = 1, .n_buffers = 2,
+    .buffers = valuebufs, .release = &release_array };
+  struct ArrowArray *arrays[] = { &varray, &tarray };
+  struct ArrowArray sarray = { .length = 6, .offset = 1, .n_buffers = 1,
+    .buffers = structbufs, .n_children = 2, .children = arrays,
+    .release = &release_array };
+  struct ArrowArray *sarrays[] = { &sarray };
+  struct ArrowArray array = { .length = 2, .offset = 1, .n_buffers = 2,
+    .buffers = listbufs, .n_children = 1, .children = sarrays,
+    .release = &release_array };
+
+  int count;
+  Temporal **result = temparr_from_arrow(&schema, &array, &count);
+  check("import", result != NULL && count == 2);
+  if (result)
+  {
+    Temporal *exp0 = tfloat_in("[1@2000-01-01 00:00:10+00, "
+      "2@2000-01-01 00:00:20+00]");
+    Temporal *exp1 = tfloat_in("[10@2000-01-01 00:00:30+00, "
+      "20@2000-01-01 00:00:40+00, 40@2000-01-01 00:00:50+00]");
+    check("values with linear interpolation",
+      result[0] && temporal_eq(result[0], exp0) &&
+      result[1] && temporal_eq(result[1], exp1));
+    free(exp0);
+    free(exp1);
+    free_values(result, count);
+    free(result);
+  }
+  /* Timestamps in milliseconds */
+  tschema.format = "tsm:UTC";
+  for (int i = 3; i < 8; i++)
+    times[i] *= 1000;
+  result = temparr_from_arrow(&schema, &array, &count);
+  Temporal *exp0 = tfloat_in("[1@2000-01-01 00:00:10+00, "
+    "2@2000-01-01 00:00:20+00]");
+  check("timestamps in milliseconds",
+    result && result[0] && temporal_eq(result[0], exp0));
+  free(exp0);
+  if (result)
+  {
+    free_values(result, count);
+    free(result);
+  }
+}
+
+/* (iv) NULL values */
+static void
+test_nulls(void)
+{
+  printf("(iv) nulls\n");
+  Temporal *values[NUM_VALUES];
+  for (int i = 0; i < NUM_VALUES; i++)
+    values[i] = (i % 3 == 0) ? NULL : random_value('f', 3, false, NULL);
+  check("round trip with NULL values", round_trip(values, NUM_VALUES));
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  if (temparr_as_arrow(values, NUM_VALUES, &schema, &array))
+  {
+    const unsigned char *validity = array.buffers[0];
+    check("validity bitmap", array.null_count == (NUM_VALUES + 2) / 3 &&
+      validity && (validity[0] & 1) == 0 && (validity[0] & 2) != 0);
+    schema.release(&schema);
+    array.release(&array);
+  }
+  free_values(values, NUM_VALUES);
+  /* A single value */
+  values[0] = tbool_in("t@2000-01-01");
+  check("round trip of a single instant", round_trip(values, 1));
+  free(values[0]);
+}
+
+/* Return true if the export of an array is refused */
+static bool
+export_fails(Temporal **values, int count)
+{
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  if (temparr_as_arrow(values, count, &schema, &array))
+  {
+    schema.release(&schema);
+    array.release(&array);
+    return false;
+  }
+  return true;
+}
+
+/* (v) errors */
+static void
+test_errors(void)
+{
+  printf("(v) errors\n");
+  Temporal *values[2];
+  values[0] = tfloat_in("{[1@2000-01-01, 2@2000-01-02]}");
+  check("sequence set", export_fails(values, 1));
+  free(values[0]);
+
+  values[0] = tfloat_in("[1@2000-01-01, 2@2000-01-02]");
+  values[1] = tint_in("[1@2000-01-01, 2@2000-01-02]");
+  check("values of different types", export_fails(values, 2));
+  free(values[1]);
+  values[1] = tfloat_in("Interp=Step;[1@2000-01-01, 2@2000-01-02]");
+  check("values of different interpolations", export_fails(values, 2));
+  free_values(values, 2);
+
+  values[0] = tgeompoint_in("SRID=3857;Point(1 1)@2000-01-01");
+  values[1] = tgeompoint_in("SRID=5676;Point(1 1)@2000-01-01");
+  check("points of different SRIDs", export_fails(values, 2));
+  free(values[1]);
+  values[1] = tgeompoint_in("SRID=3857;Point(1 1 1)@2000-01-01");
+  check("points of different dimensions", export_fails(values, 2));
+  free_values(values, 2);
+
+  /* The bounds are not part of the layout and would be read as inclusive */
+  values[0] = tint_in("[1@2000-01-01, 2@2000-01-02)");
+  check("sequences with an exclusive upper bound", export_fails(values, 1));
+  free(values[0]);
+  values[0] = tfloat_in("(1@2000-01-01, 2@2000-01-02]");
+  check("sequences with an exclusive lower bound", export_fails(values, 1));
+  free(values[0]);
+
+  values[0] = values[1] = NULL;
+  check("NULL values only", export_fails(values, 2));
+
+  /* A list of two instants in a column of instants */
+  values[0] = tint_in("1@2000-01-01");
+  values[1] = tint_in("2@2000-01-02");
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  if (temparr_as_arrow(values, 2, &schema, &array))
+  {
+    int count;
+    ((int32_t *) array.buffers[1])[1] = 2;
+    Temporal **result = temparr_from_arrow(&schema, &array, &count);
+    check("several instants in a list of instants", result == NULL);
+    ((int32_t *) array.buffers[1])[1] = 1;
+    schema.children[0]->children[0]->format = "u";
+    result = temparr_from_arrow(&schema, &array, &count);
+    check("timestamps of another type", result == NULL);
+    schema.children[0]->children[0]->format = "tsu:UTC";
+    schema.release(&schema);
+    array.release(&array);
+  }
+  free_values(values, 2);
+
+  /* Timestamps that cannot be shifted to the other epoch */
+  values[0] = tint_in("1@294270-01-01");
+  check("timestamp out of the range of Arrow", export_fails(values, 1));
+  free(values[0]);
+  values[0] = tint_in("1@2000-01-01");
+  if (temparr_as_arrow(values, 1, &schema, &array))
+  {
+    int count;
+    int64_t *times = (int64_t *) array.children[0]->children[0]->buffers[1];
+    times[0] = INT64_MIN;
+    Temporal **result = temparr_from_arrow(&schema, &array, &count);
+    check("timestamp out of the range of MEOS", result == NULL);
+    /* Shifted to the epoch of MEOS, the timestamp would be -infinity */
+    times[0] = INT64_MIN + (int64_t) UNIX_2000 * 1000000;
+    result = temparr_from_arrow(&schema, &array, &count);
+    check("timestamp shifted to -infinity", result == NULL);
+    /* Converted to microseconds, the timestamp is before 4713 BC */
+    schema.children[0]->children[0]->format = "tss:UTC";
+    times[0] = -5000000000000;
+    result = temparr_from_arrow(&schema, &array, &count);
+    check("timestamp in seconds before the first timestamptz",
+      result == NULL);
+    schema.children[0]->children[0]->format = "tsu:UTC";
+    schema.release(&schema);
+    array.release(&array);
+  }
+  free(values[0]);
+  meos_errno_reset();
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  srand(1);
+
+  test_round_trip();
+  test_layout();
+  test_foreign();
+  test_nulls();
+  test_errors();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d tests failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,342 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the snapshots of the in-memory RTree and SPTree
+ * indexes, i.e., rtree_save, rtree_open_mmap, sptree_save and
+ * sptree_open_mmap.
+ *
+ * An index is saved and opened again, and the mapped index, whose nodes are
+ * read in place from the file, is compared with the index it was saved from.
+ * The properties asserted are:
+ *  (i)   every search, for the three operations, returns the same ids;
+ *  (ii)  the join of a mapped RTree with itself and with a heap RTree returns
+ *        the same pairs as the heap RTrees;
+ *  (iii) the nearest-neighbour cursors return the same distances;
+ *  (iv)  a mapped index saved again gives a file equal byte for byte;
+ *  (v)   an empty index round trips, a file that is not a snapshot is
+ *        rejected, and a mapped index rejects insertions.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o index_snapshot_test index_snapshot_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of boxes in each index */
+#define NUM_BOXES 5000
+/* Number of query boxes */
+#define NUM_QUERIES 50
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+static int
+cmp_int64(const void *a, const void *b)
+{
+  int64 x = *(const int64 *) a, y = *(const int64 *) b;
+  return (x > y) - (x < y);
+}
+
+static double
+frand(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+/* Return a random box with Z and time of a given size */
+static STBox
+random_box(double size)
+{
+  char buf[256];
+  double x = frand() * 1000.0, y = frand() * 1000.0, z = frand() * 100.0;
+  int day = 1 + rand() % 27;
+  snprintf(buf, sizeof(buf), "STBOX ZT(((%f,%f,%f),(%f,%f,%f)),"
+    "[2000-01-%02d,2000-01-%02d])", x, y, z, x + size, y + size, z + size,
+    day, day + 1);
+  STBox *box = stbox_in(buf);
+  STBox result = *box;
+  free(box);
+  return result;
+}
+
+/* Return the sorted contents of a result array */
+static int64 *
+sorted_ids(MeosArray *result, int count)
+{
+  int64 *ids = malloc(sizeof(int64) * (count ? count : 1));
+  for (int i = 0; i < count; i++)
+    ids[i] = *(int64 *) meos_array_get(result, i);
+  qsort(ids, (size_t) count, sizeof(int64), cmp_int64);
+  return ids;
+}
+
+/* Return true when two files have the same contents */
+static bool
+same_file(const char *name1, const char *name2)
+{
+  FILE *file1 = fopen(name1, "rb"), *file2 = fopen(name2, "rb");
+  bool result = file1 && file2;
+  while (result)
+  {
+    int c1 = fgetc(file1), c2 = fgetc(file2);
+    if (c1 != c2)
+      result = false;
+    if (c1 == EOF || c2 == EOF)
+      break;
+  }
+  if (file1) fclose(file1);
+  if (file2) fclose(file2);
+  return result;
+}
+
+/* Return true when the searches of two RTrees, or of two SPTrees, return the
+ * same ids for every query and operation */
+static bool
+same_searches(const RTree *rtree1, const RTree *rtree2, const SPTree *sptree1,
+  const SPTree *sptree2, const STBox *queries)
+{
+  MeosArray *result = meos_array_create(sizeof(int64));
+  bool ok = true;
+  int hits = 0;
+  for (int op = RTREE_OVERLAPS; op <= RTREE_CONTAINED_BY; op++)
+  {
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      int n1 = rtree1 ? rtree_search(rtree1, op, &queries[q], result) :
+        sptree_search(sptree1, op, &queries[q], result);
+      int64 *ids1 = sorted_ids(result, n1);
+      int n2 = rtree2 ? rtree_search(rtree2, op, &queries[q], result) :
+        sptree_search(sptree2, op, &queries[q], result);
+      int64 *ids2 = sorted_ids(result, n2);
+      if (n1 != n2 || memcmp(ids1, ids2, sizeof(int64) * n1) != 0)
+        ok = false;
+      hits += n1;
+      free(ids1); free(ids2);
+    }
+  }
+  meos_array_destroy(result);
+  return ok && hits > 0;
+}
+
+/* Return true when two nearest-neighbour cursors return the same distances */
+static bool
+same_neighbours(const RTree *rtree1, const RTree *rtree2,
+  const SPTree *sptree1, const SPTree *sptree2, const STBox *query)
+{
+  RTreeNNCursor *rcursor1 = NULL, *rcursor2 = NULL;
+  SPNNCursor *scursor1 = NULL, *scursor2 = NULL;
+  if (rtree1)
+  {
+    rcursor1 = rtree_nn_cursor_open(rtree1, query);
+    rcursor2 = rtree_nn_cursor_open(rtree2, query);
+  }
+  else
+  {
+    scursor1 = sptree_nn_cursor_open(sptree1, query);
+    scursor2 = sptree_nn_cursor_open(sptree2, query);
+  }
+  bool ok = true;
+  int n = 0;
+  while (true)
+  {
+    int64 id1, id2;
+    double dist1, dist2;
+    bool next1 = rtree1 ? rtree_nn_cursor_next(rcursor1, &id1, &dist1) :
+      sptree_nn_cursor_next(scursor1, &id1, &dist1);
+    bool next2 = rtree1 ? rtree_nn_cursor_next(rcursor2, &id2, &dist2) :
+      sptree_nn_cursor_next(scursor2, &id2, &dist2);
+    if (next1 != next2 || (next1 && dist1 != dist2))
+      ok = false;
+    if (! next1 || ! next2)
+      break;
+    n++;
+  }
+  rtree_nn_cursor_close(rcursor1); rtree_nn_cursor_close(rcursor2);
+  sptree_nn_cursor_close(scursor1); sptree_nn_cursor_close(scursor2);
+  return ok && n == NUM_BOXES;
+}
+
+/* Return true when two joins return the same pairs */
+static bool
+same_joins(const RTree *rtree1, const RTree *rtree2, const RTree *rtree3,
+  const RTree *rtree4)
+{
+  MeosArray *result = meos_array_create(sizeof(int64));
+  bool ok = true;
+  for (int op = RTREE_OVERLAPS; op <= RTREE_CONTAINED_BY; op++)
+  {
+    int n1 = 2 * rtree_join(rtree1, rtree2, op, result);
+    int64 *ids1 = sorted_ids(result, n1);
+    int n2 = 2 * rtree_join(rtree3, rtree4, op, result);
+    int64 *ids2 = sorted_ids(result, n2);
+    if (n1 != n2 || memcmp(ids1, ids2, sizeof(int64) * n1) != 0)
+      ok = false;
+    free(ids1); free(ids2);
+  }
+  meos_array_destroy(result);
+  return ok;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  srand(20260103);
+
+  const char *file = "/tmp/meos_index_snapshot_test.idx";
+  const char *file2 = "/tmp/meos_index_snapshot_test2.idx";
+  STBox *boxes = malloc(sizeof(STBox) * NUM_BOXES);
+  int64 *ids = malloc(sizeof(int64) * NUM_BOXES);
+  STBox queries[NUM_QUERIES];
+  for (int i = 0; i < NUM_BOXES; i++)
+  {
+    boxes[i] = random_box(frand() * 10.0);
+    ids[i] = i;
+  }
+  for (int q = 0; q < NUM_QUERIES; q++)
+    queries[q] = random_box(50.0 + frand() * 100.0);
+
+  printf("RTree\n");
+  {
+    RTree *loaded = rtree_create_stbox();
+    rtree_load(loaded, boxes, ids, NUM_BOXES);
+    RTree *inserted = rtree_create_stbox();
+    for (int i = 0; i < NUM_BOXES; i++)
+      rtree_insert(inserted, &boxes[i], i);
+
+    check("a bulk-loaded RTree is saved", rtree_save(loaded, file));
+    RTree *mapped = rtree_open_mmap(file);
+    check("and opened", mapped != NULL);
+    check("its searches equal those of the heap RTree",
+      same_searches(loaded, mapped, NULL, NULL, queries));
+    check("its nearest neighbours equal those of the heap RTree",
+      same_neighbours(loaded, mapped, NULL, NULL, &queries[0]));
+    check("its joins equal those of the heap RTrees",
+      same_joins(loaded, inserted, mapped, inserted) &&
+      same_joins(loaded, loaded, mapped, mapped));
+    check("saving it again gives the same file",
+      rtree_save(mapped, file2) && same_file(file, file2));
+    rtree_free(mapped);
+
+    check("an RTree grown by insertion round trips",
+      rtree_save(inserted, file) && (mapped = rtree_open_mmap(file)) &&
+      same_searches(inserted, mapped, NULL, NULL, queries));
+    rtree_free(mapped);
+    rtree_free(inserted);
+    rtree_free(loaded);
+  }
+
+  printf("SPTree\n");
+  for (int kind = SPTREE_QUADTREE; kind <= SPTREE_KDTREE; kind++)
+  {
+    SPTree *sptree = sptree_create_stbox(kind);
+    for (int i = 0; i < NUM_BOXES; i++)
+      sptree_insert(sptree, &boxes[i], i);
+    SPTree *mapped = NULL;
+    bool ok = sptree_save(sptree, file) &&
+      (mapped = sptree_open_mmap(file)) != NULL;
+    check(kind == SPTREE_QUADTREE ? "a quad-tree is saved and opened" :
+      "a k-d tree is saved and opened", ok);
+    if (! ok)
+      continue;
+    check("its searches equal those of the heap SPTree",
+      same_searches(NULL, NULL, sptree, mapped, queries));
+    check("its nearest neighbours equal those of the heap SPTree",
+      same_neighbours(NULL, NULL, sptree, mapped, &queries[1]));
+    check("saving it again gives the same file",
+      sptree_save(mapped, file2) && same_file(file, file2));
+    sptree_free(mapped);
+    sptree_free(sptree);
+  }
+
+  printf("Empty, invalid, and read-only snapshots\n");
+  {
+    meos_initialize_noexit_error_handler();
+    MeosArray *result = meos_array_create(sizeof(int64));
+    RTree *rtree = rtree_create_stbox();
+    RTree *mapped = NULL;
+    check("an empty RTree round trips",
+      rtree_save(rtree, file) && (mapped = rtree_open_mmap(file)) &&
+      rtree_search(mapped, RTREE_OVERLAPS, &queries[0], result) == 0);
+    rtree_free(mapped);
+    rtree_free(rtree);
+
+    SPTree *sptree = sptree_create_stbox(SPTREE_QUADTREE);
+    check("an SPTree is not opened as an RTree",
+      sptree_save(sptree, file) && rtree_open_mmap(file) == NULL &&
+      meos_errno_reset() != 0);
+    sptree_free(sptree);
+    check("a missing file is not opened",
+      rtree_open_mmap("/nonexistent/meos.idx") == NULL &&
+      sptree_open_mmap("/nonexistent/meos.idx") == NULL &&
+      meos_errno_reset() != 0);
+
+    rtree = rtree_create_stbox();
+    rtree_load(rtree, boxes, ids, NUM_BOXES);
+    rtree_save(rtree, file);
+    rtree_free(rtree);
+    mapped = rtree_open_mmap(file);
+    rtree_insert(mapped, &boxes[0], NUM_BOXES);
+    bool ok = meos_errno_reset() != 0 &&
+      ! rtree_delete(mapped, &boxes[0], 0) && meos_errno_reset() != 0 &&
+      rtree_search(mapped, RTREE_CONTAINS, &boxes[0], result) >= 1;
+    check("a mapped RTree rejects modifications", ok);
+    rtree_free(mapped);
+    meos_array_destroy(result);
+  }
+
+  remove(file);
+  remove(file2);
+  free(boxes); free(ids);
+  meos_finalize();
+  if (failures)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("\nAll index snapshot tests passed.\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,318 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the batched nearest-neighbour queries of the
+ * in-memory RTree and SPTree indexes, i.e., rtree_knn_batch and
+ * sptree_knn_batch, against the nearest-neighbour cursors of the same indexes
+ * and a brute-force oracle.
+ *
+ * The indexes hold spatiotemporal boxes of random points over a few days, and
+ * one query in ten lies in another year, so that every box is at the distance
+ * of a disjoint time extent from it and its neighbours are all ties.
+ *
+ * Five properties are asserted per index:
+ *  (i)   distances: the k distances of each query are the first k distances
+ *        of the cursor opened on the same query, in order;
+ *  (ii)  ids: each reported id is a distinct inserted id whose box is at the
+ *        reported distance from the query;
+ *  (iii) threads: the answer is the same for 1, 3 and as many threads as
+ *        processors, so it does not depend on how the batch is split;
+ *  (iv)  padding: with k larger than the number of boxes the slots beyond
+ *        the boxes receive id -1 and distance -1;
+ *  (v)   errors: a batch with k = 0 is rejected.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o knn_batch_test knn_batch_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of boxes inserted into the indexes */
+#define NUM_BOXES 3000
+/* Number of queries of the batch, more than one run of queries per task */
+#define NUM_QUERIES 1500
+/* Number of neighbours per query */
+#define K 8
+/* Number of boxes of the index used for the padding property */
+#define NUM_FEW 5
+/* Tolerance for floating-point distance comparisons */
+#define EPS 1e-9
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Return a pseudo-random double in [min, max] */
+static double
+random_double(double min, double max)
+{
+  return min + (max - min) * ((double) rand() / (double) RAND_MAX);
+}
+
+/* Return a random box of a point within the first days of January 2000, or of
+ * January 2010 when @p later is true */
+static STBox *
+random_stbox(bool later)
+{
+  double x = random_double(-1000, 1000), y = random_double(-1000, 1000);
+  int day = 1 + rand() % 4, h1 = rand() % 20, h2 = h1 + rand() % 4;
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+    "STBOX XT(((%.6f,%.6f),(%.6f,%.6f)),"
+    "[%d-01-%02d %02d:00:00+00, %d-01-%02d %02d:59:59+00])",
+    x, y, x, y, later ? 2010 : 2000, day, h1, later ? 2010 : 2000, day, h2);
+  return stbox_in(buf);
+}
+
+/* Index under test, either an RTree or an SPTree */
+typedef struct
+{
+  const char *name;
+  RTree *rtree;
+  SPTree *sptree;
+} Index;
+
+static void
+index_insert(Index *index, STBox *box, int64 id)
+{
+  if (index->rtree)
+    rtree_insert(index->rtree, box, id);
+  else
+    sptree_insert(index->sptree, box, id);
+}
+
+static bool
+index_batch(const Index *index, const STBox *queries, int count, int k,
+  int nthreads, int64 *ids, double *dists)
+{
+  return index->rtree ?
+    rtree_knn_batch(index->rtree, queries, count, k, nthreads, ids, dists) :
+    sptree_knn_batch(index->sptree, queries, count, k, nthreads, ids, dists);
+}
+
+/* Read the first k distances of the cursor of the index on a query */
+static int
+index_cursor(const Index *index, const STBox *query, int k, double *dists)
+{
+  int n = 0;
+  if (index->rtree)
+  {
+    RTreeNNCursor *cursor = rtree_nn_cursor_open(index->rtree, query);
+    while (n < k && rtree_nn_cursor_next(cursor, NULL, &dists[n]))
+      n++;
+    rtree_nn_cursor_close(cursor);
+  }
+  else
+  {
+    SPNNCursor *cursor = sptree_nn_cursor_open(index->sptree, query);
+    while (n < k && sptree_nn_cursor_next(cursor, NULL, &dists[n]))
+      n++;
+    sptree_nn_cursor_close(cursor);
+  }
+  return n;
+}
+
+static void
+index_free(Index *index)
+{
+  if (index->rtree)
+    rtree_free(index->rtree);
+  else
+    sptree_free(index->sptree);
+}
+
+/* Return true when two distances are equal, both being possibly infinite */
+static bool
+same_distance(double a, double b)
+{
+  return a == b || fabs(a - b) <= EPS * (1.0 + fabs(a));
+}
+
+/*****************************************************************************
+ * Batch against the cursor and the brute-force oracle
+ *****************************************************************************/
+
+static void
+test_batch(Index *index, STBox **boxes, const STBox *queries)
+{
+  for (int i = 0; i < NUM_BOXES; i++)
+    index_insert(index, boxes[i], i);
+
+  size_t size = (size_t) NUM_QUERIES * K;
+  int64 *ids = malloc(size * sizeof(int64));
+  double *dists = malloc(size * sizeof(double));
+  char name[128];
+  snprintf(name, sizeof(name), "%s: batch succeeds", index->name);
+  check(name, index_batch(index, queries, NUM_QUERIES, K, 1, ids, dists));
+
+  /* (i) and (ii) */
+  bool samedist = true, validids = true;
+  int nfar = 0;
+  for (int q = 0; q < NUM_QUERIES; q++)
+  {
+    double expected[K];
+    int n = index_cursor(index, &queries[q], K, expected);
+    const int64 *qids = &ids[q * K];
+    const double *qdists = &dists[q * K];
+    if (n != K)
+      samedist = false;
+    for (int i = 0; i < K && samedist; i++)
+      if (! same_distance(qdists[i], expected[i]))
+        samedist = false;
+    for (int i = 0; i < K && validids; i++)
+    {
+      if (qids[i] < 0 || qids[i] >= NUM_BOXES ||
+          ! same_distance(nad_stbox_stbox(&queries[q], boxes[qids[i]]),
+            qdists[i]))
+        validids = false;
+      for (int j = 0; j < i; j++)
+        if (qids[j] == qids[i])
+          validids = false;
+    }
+    if (qdists[0] == DBL_MAX)
+      nfar++;
+  }
+  snprintf(name, sizeof(name), "%s: distances match the cursor", index->name);
+  check(name, samedist);
+  snprintf(name, sizeof(name), "%s: ids are distinct and at their distance",
+    index->name);
+  check(name, validids);
+  snprintf(name, sizeof(name), "%s: queries disjoint in time are answered",
+    index->name);
+  check(name, nfar > 0);
+
+  /* (iii) */
+  int64 *ids2 = malloc(size * sizeof(int64));
+  double *dists2 = malloc(size * sizeof(double));
+  int threads[] = {3, 0};
+  for (int t = 0; t < 2; t++)
+  {
+    bool ok = index_batch(index, queries, NUM_QUERIES, K, threads[t], ids2,
+      dists2);
+    snprintf(name, sizeof(name), "%s: same answer with %d threads",
+      index->name, threads[t]);
+    check(name, ok && memcmp(ids, ids2, size * sizeof(int64)) == 0 &&
+      memcmp(dists, dists2, size * sizeof(double)) == 0);
+  }
+
+  /* (v) */
+  snprintf(name, sizeof(name), "%s: k = 0 is rejected", index->name);
+  check(name, ! index_batch(index, queries, NUM_QUERIES, 0, 1, ids, dists));
+  meos_errno_reset();
+
+  free(ids); free(dists); free(ids2); free(dists2);
+  index_free(index);
+}
+
+/* (iv) */
+static void
+test_padding(Index *index, STBox **boxes, const STBox *queries)
+{
+  for (int i = 0; i < NUM_FEW; i++)
+    index_insert(index, boxes[i], i);
+  int64 ids[2 * K];
+  double dists[2 * K];
+  bool ok = index_batch(index, queries, 2, K, 1, ids, dists);
+  for (int q = 0; q < 2 && ok; q++)
+    for (int i = 0; i < K; i++)
+    {
+      bool found = (i < NUM_FEW);
+      if ((ids[q * K + i] >= 0) != found ||
+          (found ? dists[q * K + i] < 0.0 : dists[q * K + i] != -1.0))
+        ok = false;
+    }
+  char name[128];
+  snprintf(name, sizeof(name), "%s: slots beyond the boxes are padded",
+    index->name);
+  check(name, ok);
+  index_free(index);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+
+  STBox **boxes = malloc(NUM_BOXES * sizeof(STBox *));
+  for (int i = 0; i < NUM_BOXES; i++)
+    boxes[i] = random_stbox(false);
+  STBox *queries = malloc(NUM_QUERIES * sizeof(STBox));
+  for (int q = 0; q < NUM_QUERIES; q++)
+  {
+    STBox *box = random_stbox(q % 10 == 9);
+    queries[q] = *box;
+    free(box);
+  }
+
+  printf("Testing the batched nearest-neighbour queries\n");
+  Index rtree = {"rtree", rtree_create_stbox(), NULL};
+  test_batch(&rtree, boxes, queries);
+  Index quadtree = {"quad-tree", NULL,
+    sptree_create_stbox(SPTREE_QUADTREE)};
+  test_batch(&quadtree, boxes, queries);
+  Index kdtree = {"k-d tree", NULL, sptree_create_stbox(SPTREE_KDTREE)};
+  test_batch(&kdtree, boxes, queries);
+
+  Index rtree_few = {"rtree", rtree_create_stbox(), NULL};
+  test_padding(&rtree_few, boxes, queries);
+  Index kdtree_few = {"k-d tree", NULL, sptree_create_stbox(SPTREE_KDTREE)};
+  test_padding(&kdtree_few, boxes, queries);
+
+  for (int i = 0; i < NUM_BOXES; i++)
+    free(boxes[i]);
+  free(boxes); free(queries);
+
+  meos_finalize();
+  if (failures > 0)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return 1;
+  }
+  printf("\nAll tests passed\n");
+  return 0;
+}
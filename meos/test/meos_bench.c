@@ -0,0 +1,778 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A micro-benchmark of the hot paths of MEOS with regression tracking.
+ *
+ * The program generates two reproducible synthetic workloads from a seed:
+ *  - berlinmod: vehicles driving on a Manhattan grid of streets in a planar
+ *    coordinate system, sampled every two seconds, with stops at crossings;
+ *  - ais: vessels sailing in the Baltic Sea as geodetic points with a
+ *    drifting heading, sampled at irregular intervals of 2 to 30 seconds.
+ *
+ * Each benchmark times one operation over these workloads, such as
+ * tsequence_make, temporal_at_tstzspan, tgeo_at_stbox, tdistance_tgeo_tgeo
+ * (which lifts the distance over two sequences), rtree_search, and the
+ * MF-JSON and WKB input/output functions. For each benchmark the program
+ * reports the nanoseconds per operation, as the median and the minimum of
+ * five repetitions, and the number of allocations and the number of bytes
+ * allocated per operation, which are counted over the same inputs in every
+ * run with an allocator installed with #meos_initialize_allocator.
+ *
+ * Usage:
+ * @code
+ * meos_bench [--filter STR] [--scale N] [--seed N] [--min-time SEC]
+ *            [--json FILE] [--baseline FILE] [--threshold PCT] [--list]
+ * @endcode
+ *  - --filter: run only the benchmarks whose name contains STR;
+ *  - --scale: multiply the number of instants of the sequences (1000 per
+ *    trip at scale 1);
+ *  - --seed: seed of the workload generator (default 1);
+ *  - --min-time: minimum duration of a repetition in seconds (default 0.1);
+ *  - --json: write the results as JSON to FILE, "-" for the standard output;
+ *  - --baseline: compare the results with a JSON file written by a previous
+ *    run, and exit with a failure status when a benchmark is slower than the
+ *    baseline by more than the threshold or allocates more often;
+ *  - --threshold: tolerated slowdown in percent (default 10).
+ *
+ * The program is built by CMake with the option -DBENCH=ON, or as follows
+ * @code
+ * gcc -Wall -O2 -g -I/usr/local/include -o meos_bench meos_bench.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of trips of each workload */
+#define NUM_TRIPS 32
+/* Number of instants of a trip at scale 1 */
+#define TRIP_INSTANTS 1000
+/* Number of repetitions of a benchmark */
+#define NUM_REPS 5
+/* Number of operations run with the counting allocator, a multiple of the
+ * number of trips */
+#define ALLOC_ITERS (2 * NUM_TRIPS)
+/* Maximum number of benchmarks */
+#define MAX_BENCHES 64
+/* Number of boxes per trip inserted into the RTree */
+#define RTREE_BOXES 64
+/* Number of queries of the RTree */
+#define NUM_QUERIES 256
+/* Side of a block of the street grid in meters */
+#define BLOCK_SIZE 100.0
+/* Precision of the MF-JSON output */
+#define MFJSON_PRECISION 6
+
+/*****************************************************************************
+ * Reproducible random numbers
+ *****************************************************************************/
+
+/* State of the generator, the results do not depend on the C library */
+static uint64_t rng_state = 1;
+
+/* Return the next number of the splitmix64 generator */
+static uint64_t
+rng_next(void)
+{
+  uint64_t z = (rng_state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/* Return a random double in [min, max) */
+static double
+rng_double(double min, double max)
+{
+  return min + (max - min) * ((double) (rng_next() >> 11) / 9007199254740992.0);
+}
+
+/* Return a random integer in [min, max] */
+static int
+rng_int(int min, int max)
+{
+  return min + (int) (rng_next() % (uint64_t) (max - min + 1));
+}
+
+/*****************************************************************************
+ * Workloads
+ *****************************************************************************/
+
+/* Number of instants of a trip */
+static int num_insts = TRIP_INSTANTS;
+
+/* Start of the workloads */
+static TimestampTz t_start;
+
+/* BerlinMOD-like workload */
+static TInstant **bm_insts;              /* Instants of the first trip */
+static Temporal *bm_trips[NUM_TRIPS];
+static Span *bm_periods[NUM_TRIPS];      /* Middle half of the trips */
+static STBox *bm_boxes[NUM_TRIPS];       /* Central quarter of the trips */
+static uint8_t *bm_wkb[NUM_TRIPS];
+static size_t bm_wkb_size[NUM_TRIPS];
+static char *bm_mfjson[NUM_TRIPS];
+static RTree *bm_rtree;
+static STBox *bm_queries[NUM_QUERIES];
+
+/* AIS-like workload */
+static TInstant **ais_insts;             /* Instants of the first trip */
+static Temporal *ais_trips[NUM_TRIPS];
+
+/* Return a vehicle trip on the street grid */
+static TInstant **
+berlinmod_trip(TimestampTz start)
+{
+  TInstant **result = malloc(sizeof(TInstant *) * num_insts);
+  /* Start at a random crossing heading along a random axis */
+  double x = BLOCK_SIZE * rng_int(0, 100), y = BLOCK_SIZE * rng_int(0, 100);
+  int dir = rng_int(0, 3);
+  double speed = rng_double(5.0, 20.0);
+  int stop = 0;
+  TimestampTz t = start;
+  for (int i = 0; i < num_insts; i++)
+  {
+    GSERIALIZED *gs = geompoint_make2d(3857, x, y);
+    result[i] = tpointinst_make(gs, t);
+    free(gs);
+    t += 2000000; /* 2 seconds */
+    if (stop > 0)
+    {
+      stop--;
+      continue;
+    }
+    double step = 2.0 * speed;
+    double before = (dir % 2 == 0) ? x : y;
+    if (dir == 0) x += step;
+    else if (dir == 1) y += step;
+    else if (dir == 2) x -= step;
+    else y -= step;
+    double after = (dir % 2 == 0) ? x : y;
+    /* At a crossing, stop for a while and possibly turn */
+    if (floor(before / BLOCK_SIZE) != floor(after / BLOCK_SIZE))
+    {
+      double cross = BLOCK_SIZE * ((after > before) ? floor(after / BLOCK_SIZE) :
+        floor(before / BLOCK_SIZE));
+      if (dir % 2 == 0) x = cross; else y = cross;
+      if (rng_int(0, 3) == 0)
+        stop = rng_int(1, 10);
+      if (rng_int(0, 2) == 0)
+        dir = (dir + (rng_int(0, 1) ? 1 : 3)) % 4;
+      speed = rng_double(5.0, 20.0);
+    }
+  }
+  return result;
+}
+
+/* Return a vessel trip in the Baltic Sea */
+static TInstant **
+ais_trip(TimestampTz start)
+{
+  TInstant **result = malloc(sizeof(TInstant *) * num_insts);
+  double lon = rng_double(10.0, 20.0), lat = rng_double(54.0, 58.0);
+  double heading = rng_double(0.0, 2 * M_PI);
+  double speed = rng_double(3.0, 12.0); /* meters per second */
+  TimestampTz t = start;
+  for (int i = 0; i < num_insts; i++)
+  {
+    GSERIALIZED *gs = geogpoint_make2d(4326, lon, lat);
+    result[i] = tpointinst_make(gs, t);
+    free(gs);
+    int secs = rng_int(2, 30);
+    t += (TimestampTz) secs * 1000000;
+    heading += rng_double(-0.1, 0.1);
+    double dist = speed * secs;
+    lat += dist * cos(heading) / 111320.0;
+    lon += dist * sin(heading) / (111320.0 * cos(lat * M_PI / 180.0));
+  }
+  return result;
+}
+
+/* Return a sequence from instants and free them unless they are kept */
+static Temporal *
+make_trip(TInstant **instants, bool keep)
+{
+  Temporal *result = (Temporal *) tsequence_make(instants, num_insts, true,
+    true, LINEAR, true);
+  if (! keep)
+  {
+    for (int i = 0; i < num_insts; i++)
+      free(instants[i]);
+    free(instants);
+  }
+  return result;
+}
+
+/* Generate the workloads */
+static void
+workloads_init(int scale, uint64_t seed)
+{
+  rng_state = seed;
+  num_insts = TRIP_INSTANTS * scale;
+  t_start = timestamptz_in("2020-06-01 08:00:00+00", -1);
+  bm_rtree = rtree_create_stbox();
+  for (int i = 0; i < NUM_TRIPS; i++)
+  {
+    /* The trips start within the same minute so that they overlap in time */
+    TimestampTz start = t_start + (TimestampTz) rng_int(0, 59) * 1000000;
+    TInstant **instants = berlinmod_trip(start);
+    bm_trips[i] = make_trip(instants, i == 0);
+    if (i == 0)
+      bm_insts = instants;
+    TimestampTz lower = temporal_start_timestamptz(bm_trips[i]);
+    TimestampTz upper = temporal_end_timestamptz(bm_trips[i]);
+    bm_periods[i] = tstzspan_make(lower + (upper - lower) / 4,
+      upper - (upper - lower) / 4, true, true);
+    STBox *box = tspatial_to_stbox(bm_trips[i]);
+    double dx = (box->xmax - box->xmin) / 4, dy = (box->ymax - box->ymin) / 4;
+    bm_boxes[i] = stbox_make(true, false, false, 3857, box->xmin + dx,
+      box->xmax - dx, box->ymin + dy, box->ymax - dy, 0, 0, NULL);
+    free(box);
+    bm_wkb[i] = temporal_as_wkb(bm_trips[i], WKB_EXTENDED, &bm_wkb_size[i]);
+    bm_mfjson[i] = temporal_as_mfjson(bm_trips[i], false, 0,
+      MFJSON_PRECISION, NULL);
+    rtree_insert_temporal_split(bm_rtree, bm_trips[i], i, RTREE_BOXES);
+
+    start = t_start + (TimestampTz) rng_int(0, 59) * 1000000;
+    instants = ais_trip(start);
+    ais_trips[i] = make_trip(instants, i == 0);
+    if (i == 0)
+      ais_insts = instants;
+  }
+  /* Windows of 500 m and 10 minutes over the extent of the trips */
+  for (int i = 0; i < NUM_QUERIES; i++)
+  {
+    double x = rng_double(0, 100 * BLOCK_SIZE);
+    double y = rng_double(0, 100 * BLOCK_SIZE);
+    TimestampTz t = t_start + (TimestampTz) rng_int(0,
+      num_insts * 2 - 600) * 1000000;
+    Span *p = tstzspan_make(t, t + (TimestampTz) 600 * 1000000, true, true);
+    bm_queries[i] = stbox_make(true, false, false, 3857, x, x + 500, y,
+      y + 500, 0, 0, p);
+    free(p);
+  }
+  return;
+}
+
+/* Free the workloads */
+static void
+workloads_free(void)
+{
+  for (int i = 0; i < num_insts; i++)
+  {
+    free(bm_insts[i]);
+    free(ais_insts[i]);
+  }
+  free(bm_insts); free(ais_insts);
+  for (int i = 0; i < NUM_TRIPS; i++)
+  {
+    free(bm_trips[i]); free(bm_periods[i]); free(bm_boxes[i]);
+    free(bm_wkb[i]); free(bm_mfjson[i]); free(ais_trips[i]);
+  }
+  for (int i = 0; i < NUM_QUERIES; i++)
+    free(bm_queries[i]);
+  rtree_free(bm_rtree);
+  return;
+}
+
+/*****************************************************************************
+ * Operations
+ *****************************************************************************/
+
+/* Number of operations run so far, used to cycle over the inputs */
+static long op_count = 0;
+
+/* Result array of the RTree searches */
+static MeosArray *search_result;
+
+/* Sink for the results that are not freed, defeats dead code elimination */
+static volatile double sink;
+
+static void
+op_tsequence_make_berlinmod(void)
+{
+  free(tsequence_make(bm_insts, num_insts, true, true, LINEAR, true));
+}
+
+static void
+op_tsequence_make_ais(void)
+{
+  free(tsequence_make(ais_insts, num_insts, true, true, LINEAR, true));
+}
+
+static void
+op_temporal_at_tstzspan_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(temporal_at_tstzspan(bm_trips[k], bm_periods[k]));
+}
+
+static void
+op_tgeo_at_stbox_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(tgeo_at_stbox(bm_trips[k], bm_boxes[k], true));
+}
+
+static void
+op_tdistance_tgeo_tgeo_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(tdistance_tgeo_tgeo(bm_trips[k], bm_trips[(k + 1) % NUM_TRIPS]));
+}
+
+static void
+op_tdistance_tgeo_tgeo_ais(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(tdistance_tgeo_tgeo(ais_trips[k], ais_trips[(k + 1) % NUM_TRIPS]));
+}
+
+static void
+op_tpoint_speed_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(tpoint_speed(bm_trips[k]));
+}
+
+static void
+op_tpoint_length_ais(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  sink = tpoint_length(ais_trips[k]);
+}
+
+static void
+op_temporal_simplify_dp_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(temporal_simplify_dp(bm_trips[k], 10.0, true));
+}
+
+static void
+op_rtree_search_berlinmod(void)
+{
+  int k = op_count++ % NUM_QUERIES;
+  meos_array_reset(search_result);
+  sink = rtree_search(bm_rtree, RTREE_OVERLAPS, bm_queries[k], search_result);
+}
+
+static void
+op_temporal_as_wkb_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  size_t size;
+  free(temporal_as_wkb(bm_trips[k], WKB_EXTENDED, &size));
+}
+
+static void
+op_temporal_from_wkb_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(temporal_from_wkb(bm_wkb[k], bm_wkb_size[k]));
+}
+
+static void
+op_temporal_as_mfjson_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(temporal_as_mfjson(bm_trips[k], false, 0, MFJSON_PRECISION, NULL));
+}
+
+static void
+op_tgeompoint_from_mfjson_berlinmod(void)
+{
+  int k = op_count++ % NUM_TRIPS;
+  free(tgeompoint_from_mfjson(bm_mfjson[k]));
+}
+
+/* Benchmark definition */
+typedef struct
+{
+  const char *name;     /* Operation and workload */
+  void (*run)(void);    /* Function running one operation */
+} Bench;
+
+static const Bench BENCHES[] =
+{
+  {"tsequence_make/berlinmod", op_tsequence_make_berlinmod},
+  {"tsequence_make/ais", op_tsequence_make_ais},
+  {"temporal_at_tstzspan/berlinmod", op_temporal_at_tstzspan_berlinmod},
+  {"tgeo_at_stbox/berlinmod", op_tgeo_at_stbox_berlinmod},
+  {"tdistance_tgeo_tgeo/berlinmod", op_tdistance_tgeo_tgeo_berlinmod},
+  {"tdistance_tgeo_tgeo/ais", op_tdistance_tgeo_tgeo_ais},
+  {"tpoint_speed/berlinmod", op_tpoint_speed_berlinmod},
+  {"tpoint_length/ais", op_tpoint_length_ais},
+  {"temporal_simplify_dp/berlinmod", op_temporal_simplify_dp_berlinmod},
+  {"rtree_search/berlinmod", op_rtree_search_berlinmod},
+  {"temporal_as_wkb/berlinmod", op_temporal_as_wkb_berlinmod},
+  {"temporal_from_wkb/berlinmod", op_temporal_from_wkb_berlinmod},
+  {"temporal_as_mfjson/berlinmod", op_temporal_as_mfjson_berlinmod},
+  {"tgeompoint_from_mfjson/berlinmod", op_tgeompoint_from_mfjson_berlinmod},
+};
+
+#define NUM_BENCHES ((int) (sizeof(BENCHES) / sizeof(Bench)))
+
+/*****************************************************************************
+ * Measurement
+ *****************************************************************************/
+
+/* Counters of the counting allocator */
+static long alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+static void *
+counting_malloc(size_t size)
+{
+  alloc_count++;
+  alloc_bytes += size;
+  return malloc(size);
+}
+
+static void *
+counting_realloc(void *ptr, size_t size)
+{
+  alloc_count++;
+  alloc_bytes += size;
+  return realloc(ptr, size);
+}
+
+/* Result of a benchmark */
+typedef struct
+{
+  const char *name;
+  long iterations;      /* Operations per repetition */
+  double ns_per_op;     /* Median over the repetitions */
+  double ns_per_op_min; /* Minimum over the repetitions */
+  double allocs_per_op;
+  double bytes_per_op;
+} BenchResult;
+
+/* Return the current time in seconds */
+static double
+now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* Return the duration in seconds of a number of operations */
+static double
+run_timed(void (*run)(void), long iters)
+{
+  double start = now();
+  for (long i = 0; i < iters; i++)
+    run();
+  return now() - start;
+}
+
+static int
+double_cmp(const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+/* Run a benchmark */
+static BenchResult
+bench_run(const Bench *bench, double min_time)
+{
+  BenchResult result;
+  result.name = bench->name;
+  /* Warm up and calibrate the number of operations per repetition */
+  long iters = 1;
+  while (true)
+  {
+    double elapsed = run_timed(bench->run, iters);
+    if (elapsed >= min_time || iters >= (1L << 30))
+      break;
+    /* Aim at the minimum time with some margin, at most 10x per step */
+    double factor = (elapsed > 0) ? 1.2 * min_time / elapsed : 10.0;
+    iters = (long) ceil(iters * (factor > 10.0 ? 10.0 : factor));
+  }
+  result.iterations = iters;
+  double ns[NUM_REPS];
+  for (int i = 0; i < NUM_REPS; i++)
+    ns[i] = run_timed(bench->run, iters) * 1e9 / (double) iters;
+  qsort(ns, NUM_REPS, sizeof(double), double_cmp);
+  result.ns_per_op = ns[NUM_REPS / 2];
+  result.ns_per_op_min = ns[0];
+  /* Count the allocations over the same inputs in every run so that the
+   * counts are comparable with a baseline, the warm up has filled the lazy
+   * caches */
+  op_count = 0;
+  alloc_count = 0;
+  alloc_bytes = 0;
+  meos_initialize_allocator(counting_malloc, counting_realloc, NULL);
+  for (long i = 0; i < ALLOC_ITERS; i++)
+    bench->run();
+  meos_initialize_allocator(NULL, NULL, NULL);
+  result.allocs_per_op = (double) alloc_count / ALLOC_ITERS;
+  result.bytes_per_op = (double) alloc_bytes / ALLOC_ITERS;
+  return result;
+}
+
+/*****************************************************************************
+ * JSON output and baseline comparison
+ *****************************************************************************/
+
+/* Write the results as JSON, with one benchmark per line */
+static bool
+write_json(const char *filename, const BenchResult *results, int count,
+  int scale, uint64_t seed, double min_time)
+{
+  FILE *file = strcmp(filename, "-") == 0 ? stdout : fopen(filename, "w");
+  if (! file)
+  {
+    fprintf(stderr, "Cannot open the file %s\n", filename);
+    return false;
+  }
+  fprintf(file, "{\n  \"meos_version\": \"%s\",\n  \"scale\": %d,\n"
+    "  \"seed\": %llu,\n  \"min_time\": %g,\n  \"benchmarks\": [\n",
+    meos_version(), scale, (unsigned long long) seed, min_time);
+  for (int i = 0; i < count; i++)
+    fprintf(file, "    {\"name\": \"%s\", \"iterations\": %ld, "
+      "\"ns_per_op\": %.1f, \"ns_per_op_min\": %.1f, "
+      "\"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f}%s\n",
+      results[i].name, results[i].iterations, results[i].ns_per_op,
+      results[i].ns_per_op_min, results[i].allocs_per_op,
+      results[i].bytes_per_op, i < count - 1 ? "," : "");
+  fprintf(file, "  ]\n}\n");
+  if (file != stdout)
+    fclose(file);
+  return true;
+}
+
+/* Read the number following a key in a JSON object, return -1 if absent */
+static double
+json_number(const char *obj, const char *end, const char *key)
+{
+  char pattern[64];
+  snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+  const char *pos = strstr(obj, pattern);
+  if (! pos || pos > end)
+    return -1.0;
+  return strtod(pos + strlen(pattern), NULL);
+}
+
+/* Read the baseline written by #write_json, return the number of results */
+static int
+read_baseline(const char *filename, BenchResult *results, char **buffer)
+{
+  FILE *file = fopen(filename, "r");
+  if (! file)
+  {
+    fprintf(stderr, "Cannot open the baseline %s\n", filename);
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char *buf = malloc(size + 1);
+  size_t nread = fread(buf, 1, size, file);
+  buf[nread] = '\0';
+  fclose(file);
+  int count = 0;
+  char *pos = buf;
+  while (count < MAX_BENCHES && (pos = strstr(pos, "{\"name\": \"")))
+  {
+    char *name = pos + strlen("{\"name\": \"");
+    char *quote = strchr(name, '"');
+    char *end = quote ? strchr(quote, '}') : NULL;
+    if (! end)
+      break;
+    *quote = '\0';
+    results[count].name = name;
+    results[count].ns_per_op = json_number(quote + 1, end, "ns_per_op");
+    results[count].allocs_per_op = json_number(quote + 1, end,
+      "allocs_per_op");
+    count++;
+    pos = end;
+  }
+  *buffer = buf;
+  return count;
+}
+
+/* Compare the results with a baseline, return the number of regressions */
+static int
+compare_baseline(const BenchResult *results, int count,
+  const BenchResult *base, int nbase, double threshold)
+{
+  int regressions = 0;
+  printf("\n%-36s %12s %12s %8s  %s\n", "benchmark", "base ns/op",
+    "ns/op", "delta", "status");
+  for (int i = 0; i < count; i++)
+  {
+    const BenchResult *b = NULL;
+    for (int j = 0; j < nbase && ! b; j++)
+      if (strcmp(base[j].name, results[i].name) == 0)
+        b = &base[j];
+    if (! b || b->ns_per_op <= 0)
+    {
+      printf("%-36s %12s %12.1f %8s  new\n", results[i].name, "-",
+        results[i].ns_per_op, "-");
+      continue;
+    }
+    double delta = 100.0 * (results[i].ns_per_op - b->ns_per_op) /
+      b->ns_per_op;
+    /* Allocations are deterministic, any increase is a regression */
+    bool slower = delta > threshold;
+    bool allocs = b->allocs_per_op >= 0 &&
+      results[i].allocs_per_op > b->allocs_per_op + 0.5;
+    const char *status = "ok";
+    if (slower || allocs)
+    {
+      status = slower ? (allocs ? "REGRESSION (time, allocations)" :
+        "REGRESSION (time)") : "REGRESSION (allocations)";
+      regressions++;
+    }
+    else if (delta < -threshold)
+      status = "improved";
+    printf("%-36s %12.1f %12.1f %+7.1f%%  %s\n", results[i].name,
+      b->ns_per_op, results[i].ns_per_op, delta, status);
+  }
+  return regressions;
+}
+
+/*****************************************************************************/
+
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "Usage: %s [--filter STR] [--scale N] [--seed N] "
+    "[--min-time SEC] [--json FILE] [--baseline FILE] [--threshold PCT] "
+    "[--list]\n", prog);
+  return;
+}
+
+int
+main(int argc, char **argv)
+{
+  const char *filter = NULL, *json = NULL, *baseline = NULL;
+  int scale = 1;
+  uint64_t seed = 1;
+  double min_time = 0.1, threshold = 10.0;
+  bool list = false;
+  for (int i = 1; i < argc; i++)
+  {
+    bool hasarg = i + 1 < argc;
+    if (strcmp(argv[i], "--filter") == 0 && hasarg)
+      filter = argv[++i];
+    else if (strcmp(argv[i], "--scale") == 0 && hasarg)
+      scale = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && hasarg)
+      seed = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--min-time") == 0 && hasarg)
+      min_time = atof(argv[++i]);
+    else if (strcmp(argv[i], "--json") == 0 && hasarg)
+      json = argv[++i];
+    else if (strcmp(argv[i], "--baseline") == 0 && hasarg)
+      baseline = argv[++i];
+    else if (strcmp(argv[i], "--threshold") == 0 && hasarg)
+      threshold = atof(argv[++i]);
+    else if (strcmp(argv[i], "--list") == 0)
+      list = true;
+    else
+    {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (scale < 1 || min_time < 0 || threshold < 0)
+  {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (list)
+  {
+    for (int i = 0; i < NUM_BENCHES; i++)
+      printf("%s\n", BENCHES[i].name);
+    return EXIT_SUCCESS;
+  }
+
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  workloads_init(scale, seed);
+  search_result = meos_array_create(sizeof(int64));
+
+  /* The human-readable report goes to the standard error when the JSON
+   * output is written to the standard output */
+  FILE *report = (json && strcmp(json, "-") == 0) ? stderr : stdout;
+  fprintf(report, "%-36s %10s %12s %12s %12s %14s\n", "benchmark", "iters",
+    "ns/op", "min ns/op", "allocs/op", "bytes/op");
+  BenchResult results[MAX_BENCHES];
+  int count = 0;
+  for (int i = 0; i < NUM_BENCHES; i++)
+  {
+    if (filter && ! strstr(BENCHES[i].name, filter))
+      continue;
+    results[count] = bench_run(&BENCHES[i], min_time);
+    fprintf(report, "%-36s %10ld %12.1f %12.1f %12.2f %14.1f\n",
+      results[count].name, results[count].iterations,
+      results[count].ns_per_op, results[count].ns_per_op_min,
+      results[count].allocs_per_op, results[count].bytes_per_op);
+    fflush(report);
+    count++;
+  }
+
+  int status = EXIT_SUCCESS;
+  if (json && ! write_json(json, results, count, scale, seed, min_time))
+    status = EXIT_FAILURE;
+  if (baseline)
+  {
+    BenchResult base[MAX_BENCHES];
+    char *buffer = NULL;
+    int nbase = read_baseline(baseline, base, &buffer);
+    if (nbase < 0)
+      status = EXIT_FAILURE;
+    else
+    {
+      int regressions = compare_baseline(results, count, base, nbase,
+        threshold);
+      printf("%d regression(s) with a threshold of %g%%\n", regressions,
+        threshold);
+      if (regressions > 0)
+        status = EXIT_FAILURE;
+    }
+    free(buffer);
+  }
+
+  meos_array_destroy(search_result);
+  workloads_free();
+  meos_finalize();
+  return status;
+}
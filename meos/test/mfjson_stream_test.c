@@ -0,0 +1,498 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the streaming input and output of temporal
+ * values in MF-JSON representation, which reads the moving objects of a
+ * document one at a time without building its JSON tree and writes the
+ * representation of a temporal value by chunks.
+ *
+ * The values are random temporal booleans, integers, big integers, floats,
+ * texts, and geometry and geography points of every subtype, whose values
+ * differ from one instant to the next so that the sequences keep every
+ * instant.
+ *
+ * Five properties are asserted:
+ *  (i)   round trip: the streaming reader returns for the MF-JSON
+ *        representation of a value the same value as the DOM-based reader;
+ *  (ii)  writer: the representation written into a buffer or a file is the
+ *        one returned by temporal_as_mfjson, a too small buffer receives a
+ *        truncated prefix and the length of the whole representation;
+ *  (iii) collections: the moving objects of a FeatureCollection written into
+ *        a file are read one at a time in order, including when the function
+ *        stops the reading;
+ *  (iv)  datetimes and strings: the datetimes with any UTC offset and the
+ *        strings with escapes are decoded as done by the DOM-based reader,
+ *        and the UTC designator `Z` is read as a zero offset;
+ *  (v)   errors: a truncated document, an unsupported moving type, and
+ *        arrays of distinct lengths are refused.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o mfjson_stream_test mfjson_stream_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of random values per type and subtype */
+#define NUM_VALUES 20
+/* Maximum number of instants of a random value */
+#define MAX_INSTS 40
+/* Number of features of the collection */
+#define NUM_FEATURES 500
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Values received by the function of the reader */
+static Temporal *received[NUM_FEATURES];
+static int num_received;
+static int stop_after;
+
+/* Function of the reader recording the values received */
+static bool
+receive(void *arg, Temporal *temp)
+{
+  (void) arg;
+  if (num_received < NUM_FEATURES)
+    received[num_received++] = temp;
+  else
+    free(temp);
+  return stop_after == 0 || num_received < stop_after;
+}
+
+static void
+reset_received(void)
+{
+  for (int i = 0; i < num_received; i++)
+    free(received[i]);
+  num_received = 0;
+  stop_after = 0;
+}
+
+/* Append to the string the value of the i-th instant of a type */
+static int
+append_value(char *buf, char type, int i, int dims)
+{
+  /* The value changes at every instant and avoids collinear points */
+  int v = i * 3 + rand() % 2;
+  switch (type)
+  {
+    case 'b':
+      return sprintf(buf, "%s", i % 2 ? "true" : "false");
+    case 'i':
+      return sprintf(buf, "%d", v - 50);
+    case 'g':
+      return sprintf(buf, "%lld", (long long) v * 1000000007LL);
+    case 'f':
+      return sprintf(buf, "%d.%d", v - 50, (i * i) % 100 + 1);
+    case 't':
+      return sprintf(buf, "\"t%d\"", v);
+    default: /* 'p' geometry point, 'q' geography point */
+      if (dims == 3)
+        return sprintf(buf, "Point(%d.5 %d %d)", v % 90, (i * i) % 80,
+          i % 7);
+      return sprintf(buf, "Point(%d.5 %d)", v % 90, (i * i) % 80);
+  }
+}
+
+/* Return a random value of a type in its text representation */
+static Temporal *
+random_value(char type, int subtype, int dims, bool srid)
+{
+  static char buf[MAX_INSTS * 64 * 4];
+  char *p = buf;
+  int n = 1 + rand() % MAX_INSTS;
+  bool linear = (type == 'f' || type == 'p' || type == 'q') && rand() % 2;
+  if (type == 'p' && srid)
+    p += sprintf(p, "SRID=3812;");
+  if (! linear && subtype >= 2 && (type == 'f' || type == 'p' || type == 'q'))
+    p += sprintf(p, "Interp=Step;");
+  int nseqs = (subtype == 3) ? 1 + rand() % 3 : 1;
+  if (subtype == 3)
+    *p++ = '{';
+  int i = 0;
+  for (int s = 0; s < nseqs; s++)
+  {
+    if (s)
+      *p++ = ',';
+    if (subtype == 1)
+      *p++ = '{';
+    int count = (subtype == 0) ? 1 : n;
+    if (subtype >= 2)
+      *p++ = (count > 1 && s == 0 && rand() % 2) ? '(' : '[';
+    for (int j = 0; j < count; j++, i++)
+    {
+      if (j)
+        *p++ = ',';
+      p += append_value(p, type, i, dims);
+      p += sprintf(p, "@2025-01-01 %02d:%02d:%02d.%03d+00", (i / 3600) % 24,
+        (i / 60) % 60, i % 60, (i * 7) % 1000);
+    }
+    /* Leave a gap between the sequences of a sequence set */
+    i += 100;
+    if (subtype == 1)
+      *p++ = '}';
+    else if (subtype >= 2)
+      /* A step sequence with an exclusive upper bound would need equal last
+       * values */
+      *p++ = (linear && count > 1 && s == nseqs - 1 && rand() % 2) ?
+        ')' : ']';
+  }
+  if (subtype == 3)
+    *p++ = '}';
+  *p = '\0';
+  switch (type)
+  {
+    case 'b': return tbool_in(buf);
+    case 'i': return tint_in(buf);
+    case 'g': return tbigint_in(buf);
+    case 'f': return tfloat_in(buf);
+    case 't': return ttext_in(buf);
+    case 'p': return tgeompoint_in(buf);
+    default:  return tgeogpoint_in(buf);
+  }
+}
+
+/* Return the value of an MF-JSON string read by the DOM-based reader */
+static Temporal *
+dom_read(char type, const char *mfjson)
+{
+  switch (type)
+  {
+    case 'b': return tbool_from_mfjson(mfjson);
+    case 'i': return tint_from_mfjson(mfjson);
+    case 'g': return tbigint_from_mfjson(mfjson);
+    case 'f': return tfloat_from_mfjson(mfjson);
+    case 't': return ttext_from_mfjson(mfjson);
+    case 'p': return tgeompoint_from_mfjson(mfjson);
+    default:  return tgeogpoint_from_mfjson(mfjson);
+  }
+}
+
+/* Return the SRS of the MF-JSON representation of a value */
+static const char *
+value_srs(char type, bool srid)
+{
+  if (type == 'q')
+    return "EPSG:4326";
+  return (type == 'p' && srid) ? "EPSG:3812" : NULL;
+}
+
+/*****************************************************************************/
+
+/* Properties (i) and (ii) */
+static void
+test_round_trip(void)
+{
+  const char types[] = "bigftpq";
+  bool read_ok = true, write_ok = true, trunc_ok = true, file_ok = true;
+  for (int k = 0; types[k]; k++)
+  {
+    char type = types[k];
+    for (int subtype = 0; subtype < 4; subtype++)
+    {
+      for (int r = 0; r < NUM_VALUES; r++)
+      {
+        int dims = (rand() % 2) ? 3 : 2;
+        bool srid = rand() % 2;
+        Temporal *temp = random_value(type, subtype, dims, srid);
+        if (! temp)
+        {
+          read_ok = false;
+          continue;
+        }
+        bool bbox = rand() % 2;
+        const char *srs = value_srs(type, srid);
+        char *mfjson = temporal_as_mfjson(temp, bbox, 0, 6, srs);
+        size_t len = strlen(mfjson);
+
+        /* Streaming reader against the DOM-based reader */
+        Temporal *dom = dom_read(type, mfjson);
+        reset_received();
+        int n = temporal_from_mfjson_buffer(mfjson, len, type == 'q',
+          receive, NULL);
+        if (n != 1 || num_received != 1 || ! dom ||
+            ! temporal_eq(received[0], dom) || ! temporal_eq(received[0], temp))
+          read_ok = false;
+        free(dom);
+
+        /* Buffer of the exact size and too small buffer */
+        char *out = malloc(len + 1);
+        size_t len1 = temporal_as_mfjson_buffer(temp, bbox, 6, srs, out,
+          len + 1);
+        if (len1 != len || strcmp(out, mfjson) != 0)
+          write_ok = false;
+        size_t small = (size_t) rand() % (len + 1);
+        memset(out, 'x', len + 1);
+        size_t len2 = temporal_as_mfjson_buffer(temp, bbox, 6, srs, out,
+          small);
+        if (len2 != len || (small > 0 && (strncmp(out, mfjson, small - 1) != 0
+            || out[small - 1] != '\0')) || out[small] != 'x')
+          trunc_ok = false;
+        free(out);
+
+        /* File */
+        FILE *file = tmpfile();
+        if (! file || ! temporal_as_mfjson_file(temp, bbox, 6, srs, file))
+          file_ok = false;
+        else
+        {
+          long size = ftell(file);
+          char *fbuf = malloc(len + 1);
+          rewind(file);
+          if (size != (long) len || fread(fbuf, 1, len, file) != len ||
+              memcmp(fbuf, mfjson, len) != 0)
+            file_ok = false;
+          free(fbuf);
+        }
+        if (file)
+          fclose(file);
+        free(mfjson); free(temp);
+      }
+    }
+  }
+  reset_received();
+  check("(i) streaming reader equals DOM-based reader", read_ok);
+  check("(ii) writer into a buffer equals temporal_as_mfjson", write_ok);
+  check("(ii) writer into a too small buffer truncates", trunc_ok);
+  check("(ii) writer into a file equals temporal_as_mfjson", file_ok);
+
+  /* A value whose representation spans many chunks of the writer */
+  char *buf = malloc(64 * 20000);
+  char *p = buf + sprintf(buf, "[");
+  for (int i = 0; i < 20000; i++)
+    p += sprintf(p, "%s%d.%d@2025-01-01 %02d:%02d:%02d+00", i ? "," : "",
+      i % 2 ? i : -i, i % 10 + 1, i / 3600, (i / 60) % 60, i % 60);
+  sprintf(p, "]");
+  Temporal *seq = tfloat_in(buf);
+  free(buf);
+  char *mfjson = temporal_as_mfjson(seq, true, 0, 6, NULL);
+  size_t len = strlen(mfjson);
+  FILE *file = tmpfile();
+  bool big_ok = file && temporal_as_mfjson_file(seq, true, 6, NULL, file) &&
+    ftell(file) == (long) len;
+  if (big_ok)
+  {
+    char *fbuf = malloc(len);
+    rewind(file);
+    big_ok = fread(fbuf, 1, len, file) == len && memcmp(fbuf, mfjson, len) == 0;
+    free(fbuf);
+    /* Read the file back by chunks */
+    rewind(file);
+    reset_received();
+    big_ok &= temporal_from_mfjson_file(file, false, receive, NULL) == 1 &&
+      temporal_eq(received[0], seq);
+    reset_received();
+  }
+  if (file)
+    fclose(file);
+  check("(ii) value larger than the chunks written and read back", big_ok);
+  free(mfjson); free(seq);
+}
+
+/* Property (iii) */
+static void
+test_collection(void)
+{
+  Temporal *values[NUM_FEATURES];
+  FILE *file = tmpfile();
+  if (! file)
+  {
+    check("(iii) temporary file", false);
+    return;
+  }
+  fputs("{\"type\":\"FeatureCollection\",\"features\":[", file);
+  bool write_ok = true;
+  for (int i = 0; i < NUM_FEATURES; i++)
+  {
+    bool point = i % 2;
+    values[i] = random_value(point ? 'p' : 'f', rand() % 4, 2, point);
+    fprintf(file, "%s{\"type\":\"Feature\",\"id\":%d,\"properties\":"
+      "{\"name\":\"f\\\"%d\",\"geometry\":{\"type\":\"Point\","
+      "\"coordinates\":[1,2]},\"list\":[1,[2.5e3,{\"a\":null}],true]},"
+      "\"temporalGeometry\":", i ? ",\n" : "", i, i);
+    write_ok &= temporal_as_mfjson_file(values[i], i % 3 == 0, 6,
+      point ? "EPSG:3812" : NULL, file);
+    fputs("}", file);
+  }
+  fputs("]}\n", file);
+  check("(iii) collection written", write_ok);
+
+  rewind(file);
+  reset_received();
+  int n = temporal_from_mfjson_file(file, false, receive, NULL);
+  bool read_ok = n == NUM_FEATURES && num_received == NUM_FEATURES;
+  for (int i = 0; read_ok && i < NUM_FEATURES; i++)
+    read_ok = temporal_eq(received[i], values[i]);
+  check("(iii) features read one at a time in order", read_ok);
+
+  rewind(file);
+  reset_received();
+  stop_after = 10;
+  n = temporal_from_mfjson_file(file, false, receive, NULL);
+  bool stop_ok = n == 10 && num_received == 10;
+  for (int i = 0; stop_ok && i < 10; i++)
+    stop_ok = temporal_eq(received[i], values[i]);
+  check("(iii) function stops the reading", stop_ok);
+  reset_received();
+
+  fclose(file);
+  for (int i = 0; i < NUM_FEATURES; i++)
+    free(values[i]);
+}
+
+/* Return true when the streaming reader reads a single value equal to the
+ * one of the DOM-based reader */
+static bool
+same_as_dom(char type, const char *mfjson)
+{
+  Temporal *dom = dom_read(type, mfjson);
+  reset_received();
+  int n = temporal_from_mfjson_buffer(mfjson, strlen(mfjson), false, receive,
+    NULL);
+  bool result = dom && n == 1 && temporal_eq(received[0], dom);
+  reset_received();
+  free(dom);
+  return result;
+}
+
+/* Return true when the streaming reader reads a single value from each
+ * document and both values are equal */
+static bool
+same_stream(const char *mfjson1, const char *mfjson2)
+{
+  reset_received();
+  bool result = temporal_from_mfjson_buffer(mfjson1, strlen(mfjson1), false,
+    receive, NULL) == 1 && temporal_from_mfjson_buffer(mfjson2,
+    strlen(mfjson2), false, receive, NULL) == 1 && num_received == 2 &&
+    temporal_eq(received[0], received[1]);
+  reset_received();
+  return result;
+}
+
+/* Property (iv) */
+static void
+test_datetimes_strings(void)
+{
+  check("(iv) datetimes with UTC offsets", same_as_dom('f',
+    "{\"type\":\"MovingFloat\",\"values\":[1.5,2,3e1,-4.25],"
+    "\"datetimes\":[\"2025-01-01T10:00:00+02\",\"2025-01-01T08:30:00.5+00:00\","
+    "\"2025-01-01T12:00:00.123456-03:30\",\"2025-01-02T00:00:00\"],"
+    "\"lower_inc\":true,\"upper_inc\":false,\"interpolation\":\"Linear\"}"));
+  check("(iv) datetimes with the UTC designator", same_stream(
+    "{\"type\":\"MovingInteger\",\"values\":[1,2],\"datetimes\":"
+    "[\"2025-01-01T08:30:00.5Z\",\"2025-01-01T09:00:00Z\"],"
+    "\"interpolation\":\"Step\"}",
+    "{\"type\":\"MovingInteger\",\"values\":[1,2],\"datetimes\":"
+    "[\"2025-01-01T08:30:00.5+00\",\"2025-01-01T09:00:00+00\"],"
+    "\"interpolation\":\"Step\"}"));
+  check("(iv) datetimes before 2000 and in a leap year", same_as_dom('i',
+    "{\"type\":\"MovingInteger\",\"values\":[1,2,3],"
+    "\"datetimes\":[\"1969-12-31T23:59:59.999+00\",\"1996-02-29T12:00:00+0530\","
+    "\"2400-02-29T00:00:00-01\"],\"interpolation\":\"Discrete\"}"));
+  check("(iv) strings with escapes", same_as_dom('t',
+    "{\"type\":\"MovingText\",\"values\":[\"a\\\"b\\\\c\\/d\","
+    "\"\\u00e9\\ud83d\\ude00\\n\"],\"datetimes\":[\"2025-01-01T10:00:00+02\","
+    "\"2025-01-01T11:00:00+02\"],\"interpolation\":\"Step\"}"));
+  check("(iv) members in any order and case", same_as_dom('p',
+    "{\"Interpolation\":\"Linear\",\"Datetimes\":[\"2025-01-01T10:00:00+00\","
+    "\"2025-01-01T11:00:00+00\"],\"coordinates\":[[1,2],[3,5]],"
+    "\"crs\":{\"type\":\"Name\",\"properties\":{\"name\":\"EPSG:3812\"}},"
+    "\"type\":\"MovingPoint\"}"));
+}
+
+/* Property (v) */
+static void
+test_errors(void)
+{
+  const char *valid = "{\"type\":\"MovingBoolean\",\"values\":[true],"
+    "\"datetimes\":[\"2025-01-01T10:00:00+02\"],\"interpolation\":\"None\"}";
+  const char *mismatch = "{\"type\":\"MovingFloat\",\"values\":[1,2],"
+    "\"datetimes\":[\"2025-01-01T10:00:00+02\"],\"interpolation\":\"Step\"}";
+  const char *geometry = "{\"type\":\"MovingGeometry\",\"values\":"
+    "[{\"type\":\"Point\",\"coordinates\":[1,2]}],"
+    "\"datetimes\":[\"2025-01-01T10:00:00+02\"],\"interpolation\":\"None\"}";
+  bool ok = true;
+  for (size_t len = 0; len < strlen(valid); len += 7)
+  {
+    reset_received();
+    int n = temporal_from_mfjson_buffer(valid, len, false, receive, NULL);
+    /* An empty input has no value */
+    ok &= (len == 0) ? n == 0 : n == -1;
+  }
+  reset_received();
+  check("(v) truncated document refused", ok);
+  check("(v) arrays of distinct lengths refused", temporal_from_mfjson_buffer(
+    mismatch, strlen(mismatch), false, receive, NULL) == -1);
+  reset_received();
+  check("(v) unsupported moving type refused", temporal_from_mfjson_buffer(
+    geometry, strlen(geometry), false, receive, NULL) == -1);
+  reset_received();
+  check("(v) reader usable after an error", temporal_from_mfjson_buffer(
+    valid, strlen(valid), false, receive, NULL) == 1 && num_received == 1);
+  reset_received();
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+
+  test_round_trip();
+  test_collection();
+  test_datetimes_strings();
+  test_errors();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,317 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the deletion and update of entries of the
+ * in-memory RTree index, i.e., rtree_delete and rtree_update, against a
+ * brute-force scan of the live entries.
+ *
+ * Two trees over random 2-D STBoxes are exercised, one grown by insertion and
+ * one built by rtree_load, whose full nodes underflow differently. Six
+ * properties are asserted per tree:
+ *  (i)   deleting an entry that is not in the tree, either by its id or by its
+ *        box, returns false and leaves the tree unchanged;
+ *  (ii)  after every batch of random deletions, which dissolve underflowed
+ *        nodes and insert their entries again, a search returns exactly the
+ *        live ids matching the query;
+ *  (iii) a full drain of the nearest-neighbour cursor yields every live id
+ *        exactly once;
+ *  (iv)  moving every live entry with rtree_update keeps the searches exact
+ *        at the new boxes;
+ *  (v)   deleting every entry leaves an empty tree that accepts insertions;
+ *  (vi)  deleting one of several boxes inserted with the same id keeps the
+ *        others.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o rtree_delete_test rtree_delete_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of boxes in each tree, enough for three levels */
+#define NUM_BOXES 6000
+/* Number of deletions between two checks of the searches */
+#define BATCH 500
+/* Number of query boxes per check */
+#define NUM_QUERIES 40
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+static int
+cmp_int64(const void *a, const void *b)
+{
+  int64 x = *(const int64 *) a, y = *(const int64 *) b;
+  return (x > y) - (x < y);
+}
+
+static double
+frand(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+/* Return a random square of the 1000 x 1000 plane of a given size */
+static STBox
+random_box(double size)
+{
+  double x = frand() * 1000.0, y = frand() * 1000.0;
+  STBox *box = stbox_make(true, false, false, 0, x, x + size, y, y + size,
+    0, 0, NULL);
+  STBox result = *box;
+  free(box);
+  return result;
+}
+
+/**
+ * @brief Return true when the overlap searches of random queries return
+ * exactly the live ids whose box overlaps the query
+ */
+static bool
+search_matches(const RTree *rtree, const STBox *boxes, const bool *live)
+{
+  MeosArray *result = meos_array_create(sizeof(int64));
+  int64 *got = malloc(sizeof(int64) * NUM_BOXES);
+  bool ok = true;
+  for (int q = 0; q < NUM_QUERIES && ok; q++)
+  {
+    STBox query = random_box(100.0);
+    int ngot = rtree_search(rtree, RTREE_OVERLAPS, &query, result);
+    for (int i = 0; i < ngot; i++)
+      got[i] = *(int64 *) meos_array_get(result, i);
+    qsort(got, (size_t) ngot, sizeof(int64), cmp_int64);
+    int nwant = 0;
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      if (! live[i] || ! overlaps_stbox_stbox(&boxes[i], &query))
+        continue;
+      if (nwant >= ngot || got[nwant] != i)
+        ok = false;
+      nwant++;
+    }
+    if (nwant != ngot)
+      ok = false;
+  }
+  free(got);
+  meos_array_destroy(result);
+  return ok;
+}
+
+/**
+ * @brief Return true when a full drain of the nearest-neighbour cursor yields
+ * every live id exactly once
+ */
+static bool
+drain_matches(const RTree *rtree, const bool *live)
+{
+  STBox query = random_box(1.0);
+  char *seen = calloc(NUM_BOXES, 1);
+  RTreeNNCursor *cursor = rtree_nn_cursor_open(rtree, &query);
+  int64 id;
+  double dist;
+  bool ok = true;
+  while (rtree_nn_cursor_next(cursor, &id, &dist))
+  {
+    if (id < 0 || id >= NUM_BOXES || ! live[id] || seen[id])
+      ok = false;
+    else
+      seen[id] = 1;
+  }
+  rtree_nn_cursor_close(cursor);
+  for (int i = 0; i < NUM_BOXES; i++)
+    if (live[i] && ! seen[i])
+      ok = false;
+  free(seen);
+  return ok;
+}
+
+/**
+ * @brief Test the deletion and update of the entries of a tree holding the
+ * boxes with their index as id
+ */
+static void
+test_tree(RTree *rtree, STBox *boxes)
+{
+  bool *live = malloc(sizeof(bool) * NUM_BOXES);
+  for (int i = 0; i < NUM_BOXES; i++)
+    live[i] = true;
+
+  /* (i) Entries that are not in the tree */
+  STBox elsewhere = random_box(5.0);
+  bool ok = ! rtree_delete(rtree, &boxes[0], NUM_BOXES) &&
+    ! rtree_delete(rtree, &elsewhere, 0) &&
+    search_matches(rtree, boxes, live);
+  check("deleting a missing entry returns false", ok);
+
+  /* (ii) Random deletions of two thirds of the entries */
+  int *order = malloc(sizeof(int) * NUM_BOXES);
+  for (int i = 0; i < NUM_BOXES; i++)
+    order[i] = i;
+  for (int i = NUM_BOXES - 1; i > 0; i--)
+  {
+    int j = rand() % (i + 1);
+    int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+  }
+  bool deleted = true, searched = true;
+  int ndeleted = 0;
+  for (; ndeleted < 2 * NUM_BOXES / 3; ndeleted++)
+  {
+    int id = order[ndeleted];
+    deleted &= rtree_delete(rtree, &boxes[id], id);
+    deleted &= ! rtree_delete(rtree, &boxes[id], id);
+    live[id] = false;
+    if ((ndeleted + 1) % BATCH == 0)
+      searched &= search_matches(rtree, boxes, live);
+  }
+  check("every deletion finds its entry once", deleted);
+  check("searches after deletions equal brute force", searched);
+
+  /* (iii) Nearest-neighbour drain */
+  check("nearest-neighbour drain yields the live entries",
+    drain_matches(rtree, live));
+
+  /* (iv) Move every live entry */
+  bool updated = true;
+  for (int i = 0; i < NUM_BOXES; i++)
+  {
+    if (! live[i])
+      continue;
+    STBox moved = random_box(frand() * 10.0);
+    updated &= rtree_update(rtree, &boxes[i], &moved, i);
+    boxes[i] = moved;
+  }
+  updated &= ! rtree_update(rtree, &boxes[order[0]], &elsewhere, order[0]);
+  check("every update finds its entry", updated);
+  check("searches after updates equal brute force",
+    search_matches(rtree, boxes, live) && drain_matches(rtree, live));
+
+  /* (v) Delete the remaining entries and insert again */
+  deleted = true;
+  for (; ndeleted < NUM_BOXES; ndeleted++)
+  {
+    int id = order[ndeleted];
+    deleted &= rtree_delete(rtree, &boxes[id], id);
+    live[id] = false;
+  }
+  MeosArray *result = meos_array_create(sizeof(int64));
+  STBox all = random_box(0.0);
+  all.xmin = all.ymin = -1.0; all.xmax = all.ymax = 2000.0;
+  deleted &= (rtree_search(rtree, RTREE_OVERLAPS, &all, result) == 0);
+  check("deleting every entry leaves an empty tree", deleted);
+  for (int i = 0; i < NUM_BOXES / 4; i++)
+  {
+    rtree_insert(rtree, &boxes[i], i);
+    live[i] = true;
+  }
+  check("an emptied tree accepts insertions",
+    search_matches(rtree, boxes, live) && drain_matches(rtree, live));
+
+  meos_array_destroy(result);
+  free(order);
+  free(live);
+  return;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  srand(20260102);
+
+  STBox *boxes = malloc(sizeof(STBox) * NUM_BOXES);
+  int64 *ids = malloc(sizeof(int64) * NUM_BOXES);
+
+  printf("Tree grown by insertion\n");
+  RTree *rtree = rtree_create_stbox();
+  for (int i = 0; i < NUM_BOXES; i++)
+  {
+    boxes[i] = random_box(frand() * 10.0);
+    rtree_insert(rtree, &boxes[i], i);
+  }
+  test_tree(rtree, boxes);
+  rtree_free(rtree);
+
+  printf("Tree built by bulk loading\n");
+  rtree = rtree_create_stbox();
+  for (int i = 0; i < NUM_BOXES; i++)
+  {
+    boxes[i] = random_box(frand() * 10.0);
+    ids[i] = i;
+  }
+  rtree_load(rtree, boxes, ids, NUM_BOXES);
+  test_tree(rtree, boxes);
+  rtree_free(rtree);
+
+  printf("Several boxes with the same id\n");
+  {
+    /* (vi) Three disjoint boxes of the same id */
+    rtree = rtree_create_stbox();
+    STBox parts[3];
+    for (int i = 0; i < 3; i++)
+    {
+      STBox *box = stbox_make(true, false, false, 0, 10.0 * i, 10.0 * i + 1,
+        0, 1, 0, 0, NULL);
+      parts[i] = *box; free(box);
+      rtree_insert(rtree, &parts[i], 7);
+    }
+    MeosArray *result = meos_array_create(sizeof(int64));
+    bool ok = rtree_delete(rtree, &parts[1], 7) &&
+      rtree_search(rtree, RTREE_OVERLAPS, &parts[0], result) == 1 &&
+      rtree_search(rtree, RTREE_OVERLAPS, &parts[1], result) == 0 &&
+      rtree_search(rtree, RTREE_OVERLAPS, &parts[2], result) == 1;
+    check("deleting one box of an id keeps the others", ok);
+    meos_array_destroy(result);
+    rtree_free(rtree);
+  }
+
+  free(boxes); free(ids);
+  meos_finalize();
+  if (failures)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("\nAll RTree delete tests passed.\n");
+  return EXIT_SUCCESS;
+}
@@ -30,7 +30,8 @@
 /**
  * @file
  * @brief A program that tests the join of two in-memory RTree indexes, i.e.,
- * rtree_join, against an exact brute-force oracle.
+ * rtree_join and its batched and parallel variants rtree_join_cursor_next and
+ * rtree_join_parallel, against an exact brute-force oracle.
  *
  * The oracle is the public box predicate the join is meant to reproduce --
  * #overlaps_stbox_stbox and #contains_stbox_stbox -- applied to every pair of
@@ -46,7 +47,12 @@
  *  (ii)  completeness: every pair satisfying the predicate is reported;
  *  (iii) no duplicates: no pair is reported twice, so a caller counting the
  *        result counts each pair once;
- *  (iv)  count: the number of reported pairs equals the brute-force count.
+ *  (iv)  count: the number of reported pairs equals the brute-force count;
+ *  (v)   batches: the join cursor reports no batch larger than requested, and
+ *        its batches concatenated are the answer of rtree_join, in order;
+ *  (vi)  parallel: the pairs passed to the callback of rtree_join_parallel
+ *        are the answer of rtree_join for 1, 3 and 8 threads, and a callback
+ *        asking to stop receives no more than one batch per thread.
  * The degenerate cases of an empty index and of two indexes that share no box
  * are asserted separately.
  *
@@ -72,6 +78,9 @@
 /* Least number of pairs each operation must have for the comparison against
  * the oracle to exercise the traversal rather than compare two empty answers */
 #define MIN_EXPECTED_PAIRS 200
+/* Batch size of the cursor and of the parallel join, chosen so that a batch
+ * ends in the middle of the pairs of a pair of leaves */
+#define BATCH_SIZE 37
 
 static int failures = 0;
 
@@ -125,6 +134,41 @@ cmp_pair(const void *a, const void *b)
   return (pa[1] > pb[1]) - (pa[1] < pb[1]);
 }
 
+/* Pairs collected by the callback of the parallel join, which may be called
+ * concurrently, so that the slot of each batch is claimed atomically */
+typedef struct
+{
+  int64 *pairs;
+  int count;
+  int maxbatch;
+  int nbatches;
+  bool stop;
+} Collector;
+
+static bool
+collect_pairs(void *arg, const int64 *pairs, int count)
+{
+  Collector *coll = (Collector *) arg;
+  int pos = __atomic_fetch_add(&coll->count, count, __ATOMIC_RELAXED);
+  memcpy(coll->pairs + 2 * pos, pairs, 2 * count * sizeof(int64));
+  __atomic_fetch_add(&coll->nbatches, 1, __ATOMIC_RELAXED);
+  int max = __atomic_load_n(&coll->maxbatch, __ATOMIC_RELAXED);
+  while (count > max && ! __atomic_compare_exchange_n(&coll->maxbatch, &max,
+      count, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+  return ! coll->stop;
+}
+
+/* Comparison function sorting pairs of int64 ids lexicographically */
+static int
+cmp_pair64(const void *a, const void *b)
+{
+  const int64 *pa = (const int64 *) a, *pb = (const int64 *) b;
+  if (pa[0] != pb[0])
+    return (pa[0] > pb[0]) - (pa[0] < pb[0]);
+  return (pa[1] > pb[1]) - (pa[1] < pb[1]);
+}
+
 /* Return true if the pair of boxes satisfies the operation */
 static bool
 oracle(const STBox *box1, const STBox *box2, RTreeSearchOp op)
@@ -234,6 +278,69 @@ test_stbox_join(RTreeSearchOp op, const char *opname, int count1, int count2,
   snprintf(name, sizeof(name), "%s: reports no pair twice", opname);
   check(name, distinct);
 
+  /* The cursor reports the pairs of the join, in order, in bounded batches */
+  RTreeJoinCursor *cursor = rtree_join_cursor_open(rtree1, rtree2, op);
+  MeosArray *batch = meos_array_create(sizeof(int64));
+  bool bounded = true, inorder = true;
+  int ncursor = 0, n;
+  while ((n = rtree_join_cursor_next(cursor, BATCH_SIZE, batch)) > 0)
+  {
+    if (n > BATCH_SIZE || meos_array_count(batch) != 2 * n)
+      bounded = false;
+    for (int k = 0; k < 2 * n && inorder; k++)
+      if (ncursor * 2 + k >= 2 * npairs ||
+          *(int64 *) meos_array_get(batch, k) !=
+          *(int64 *) meos_array_get(result, ncursor * 2 + k))
+        inorder = false;
+    ncursor += n;
+  }
+  rtree_join_cursor_close(cursor);
+  meos_array_destroy(batch);
+  snprintf(name, sizeof(name), "%s: cursor batches are bounded", opname);
+  check(name, bounded && n == 0);
+  snprintf(name, sizeof(name), "%s: cursor reports the join in order",
+    opname);
+  check(name, inorder && ncursor == npairs);
+
+  /* The parallel join passes the same set of pairs whatever the number of
+   * threads */
+  int64 *sorted = malloc((size_t) (npairs ? npairs : 1) * 2 *
+    sizeof(int64));
+  for (int k = 0; k < 2 * npairs; k++)
+    sorted[k] = *(int64 *) meos_array_get(result, k);
+  qsort(sorted, (size_t) npairs, 2 * sizeof(int64), cmp_pair64);
+  int threads[] = {1, 3, 8};
+  for (int t = 0; t < 3; t++)
+  {
+    Collector coll = {0};
+    coll.pairs = malloc((size_t) (npairs ? npairs : 1) * 2 *
+      sizeof(int64));
+    int64 total = rtree_join_parallel(rtree1, rtree2, op, threads[t],
+      BATCH_SIZE, &collect_pairs, &coll);
+    qsort(coll.pairs, (size_t) coll.count, 2 * sizeof(int64), cmp_pair64);
+    bool equal = (total == npairs && coll.count == npairs &&
+      coll.maxbatch <= BATCH_SIZE);
+    for (int k = 0; k < 2 * npairs && equal; k++)
+      if (coll.pairs[k] != sorted[k])
+        equal = false;
+    snprintf(name, sizeof(name), "%s: parallel join with %d thread(s)",
+      opname, threads[t]);
+    check(name, equal);
+
+    /* A callback asking to stop at once receives at most one batch from each
+     * thread, namely those already being filled */
+    coll.count = coll.maxbatch = coll.nbatches = 0;
+    coll.stop = true;
+    total = rtree_join_parallel(rtree1, rtree2, op, threads[t], BATCH_SIZE,
+      &collect_pairs, &coll);
+    snprintf(name, sizeof(name), "%s: parallel join stops with %d thread(s)",
+      opname, threads[t]);
+    check(name, total == coll.count && coll.nbatches >= 1 &&
+      coll.nbatches <= threads[t]);
+    free(coll.pairs);
+  }
+  free(sorted);
+
   printf("    (%d pairs over %d x %d boxes)\n", npairs, count1, count2);
 
   meos_array_destroy(result);
@@ -297,6 +404,27 @@ test_degenerate(void)
   check("boxes apart in time only are not reported",
     rtree_join(filled, later, RTREE_OVERLAPS, result) == 0);
 
+  /* The batched and parallel variants agree on the degenerate cases */
+  RTreeJoinCursor *cursor = rtree_join_cursor_open(empty1, filled,
+    RTREE_OVERLAPS);
+  check("cursor over an empty index reports no pair",
+    rtree_join_cursor_next(cursor, 10, result) == 0);
+  rtree_join_cursor_close(cursor);
+  cursor = rtree_join_cursor_open(filled, near, RTREE_OVERLAPS);
+  check("cursor reports the single overlapping pair",
+    rtree_join_cursor_next(cursor, 10, result) == 1 &&
+    rtree_join_cursor_next(cursor, 10, result) == 0);
+  rtree_join_cursor_close(cursor);
+  int64 pairs[2];
+  Collector coll = {pairs, 0, 0, 0, false};
+  check("parallel join of an empty index reports no pair",
+    rtree_join_parallel(empty1, filled, RTREE_OVERLAPS, 4, 10,
+      &collect_pairs, &coll) == 0 && coll.count == 0);
+  check("parallel join reports the single overlapping pair",
+    rtree_join_parallel(filled, near, RTREE_OVERLAPS, 4, 10,
+      &collect_pairs, &coll) == 1 && coll.count == 1 &&
+    pairs[0] == 0 && pairs[1] == 7);
+
   meos_array_destroy(result);
   free(box); free(farbox); free(nearbox); free(laterbox);
   rtree_free(empty1); rtree_free(empty2); rtree_free(filled);
@@ -50,7 +50,12 @@
  *  (iv)  the ids survive: they are spread beyond 2^31, so a build carrying them
  *        at a narrower width would return different numbers;
  *  (v)   the degenerate counts are handled: loading no entries leaves a tree
- *        that answers nothing, and loading one returns that one.
+ *        that answers nothing, and loading one returns that one;
+ *  (vi)  the parallel load is deterministic: rtree_load_parallel builds, for
+ *        any number of threads, a tree equal node by node to the one of
+ *        rtree_load, compared through the files written by rtree_save. The
+ *        entries are many, to split the sorts between threads, and many share
+ *        the centre of their box, so that the order of equal keys matters.
  *
  * The program can be built as follows
  * @code
@@ -72,6 +77,8 @@
 #define MIN_EXPECTED_HITS 1000
 /* Lowest id, above 2^31 so that a narrower carrier would alter it */
 #define ID_BASE 4000000000LL
+/* Entries of the parallel loads, above the size of a sort split in runs */
+#define NUM_PARALLEL 100000
 
 static int
 cmp_int64(const void *a, const void *b)
@@ -97,6 +104,61 @@ search_sorted(const RTree *rtree, const STBox *query, int *count)
   return ids;
 }
 
+/**
+ * @brief Return true when two files have the same contents
+ */
+static bool
+same_file(const char *name1, const char *name2)
+{
+  FILE *file1 = fopen(name1, "rb"), *file2 = fopen(name2, "rb");
+  bool result = file1 && file2;
+  while (result)
+  {
+    int c1 = fgetc(file1), c2 = fgetc(file2);
+    if (c1 != c2)
+      result = false;
+    if (c1 == EOF || c2 == EOF)
+      break;
+  }
+  if (file1) fclose(file1);
+  if (file2) fclose(file2);
+  return result;
+}
+
+/**
+ * @brief Return the number of thread counts for which the parallel load of
+ * the boxes builds a tree different from the sequential one
+ */
+static int
+parallel_mismatches(RTree *(*create)(void), const void *boxes,
+  const int64 *ids, int count)
+{
+  const char *seqfile = "/tmp/meos_rtree_load_seq.idx";
+  const char *parfile = "/tmp/meos_rtree_load_par.idx";
+  RTree *seq = create();
+  rtree_load(seq, boxes, ids, count);
+  rtree_save(seq, seqfile);
+  rtree_free(seq);
+  int result = 0;
+  const int nthreads[] = {1, 2, 3, 8, 0};
+  for (int t = 0; t < 5; t++)
+  {
+    RTree *par = create();
+    rtree_load_parallel(par, boxes, ids, count, nthreads[t]);
+    rtree_save(par, parfile);
+    rtree_free(par);
+    if (! same_file(seqfile, parfile))
+    {
+      printf("rtree_load_parallel: %d threads built a tree different from "
+        "rtree_load\n", nthreads[t]);
+      result++;
+    }
+  }
+  remove(seqfile);
+  remove(parfile);
+  return result;
+}
+
 int
 main(void)
 {
@@ -209,6 +271,44 @@ main(void)
   free(s);
   free(whole);
 
+  /* (vi) the parallel loads build the tree of the sequential one, for boxes
+   * with two or four axes and for spans */
+  STBox *many = malloc(sizeof(STBox) * NUM_PARALLEL);
+  Span *spans = malloc(sizeof(Span) * NUM_PARALLEL);
+  int64 *manyids = malloc(sizeof(int64) * NUM_PARALLEL);
+  for (int i = 0; i < NUM_PARALLEL; i++)
+  {
+    /* At most 400 distinct centres along each axis */
+    int x = rand() % 400, y = rand() % 400, w = rand() % 3;
+    STBox *box = stbox_make(true, false, false, 0, x - w, x + w, y - w, y + w,
+      0, 0, NULL);
+    memcpy(&many[i], box, sizeof(STBox));
+    free(box);
+    Span *span = intspan_make(x - w, x + w, true, true);
+    memcpy(&spans[i], span, sizeof(Span));
+    free(span);
+    manyids[i] = i;
+  }
+  failures += parallel_mismatches(rtree_create_stbox, many, manyids,
+    NUM_PARALLEL);
+  failures += parallel_mismatches(rtree_create_intspan, spans, manyids,
+    NUM_PARALLEL);
+  for (int i = 0; i < NUM_PARALLEL; i++)
+  {
+    int day = 1 + rand() % 20;
+    snprintf(buf, sizeof(buf), "STBOX ZT(((%d,%d,%d),(%d,%d,%d)),"
+      "[2000-01-%02d,2000-01-%02d])", rand() % 100, rand() % 100,
+      rand() % 100, 100, 100, 100, day, day + 1);
+    STBox *box = stbox_in(buf);
+    memcpy(&many[i], box, sizeof(STBox));
+    free(box);
+  }
+  failures += parallel_mismatches(rtree_create_stbox, many, manyids,
+    NUM_PARALLEL);
+  free(many);
+  free(spans);
+  free(manyids);
+
   rtree_free(grown);
   rtree_free(packed);
   rtree_free(empty);
@@ -0,0 +1,422 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the whole-node scan of the in-memory RTree
+ * index, i.e., the per-axis bounds kept in every node and the kernels testing
+ * them, against a brute-force scan applying the exact box predicates.
+ *
+ * The nodes answer a search by comparing the bounds of their boxes as closed
+ * intervals of doubles and then confirming the surviving leaf entries with
+ * the exact predicate. The cases below are those where the two could part:
+ *  (i)   integer and date spans with negative bounds, whose Datum is a
+ *        sign-extended integer rather than the value;
+ *  (ii)  float spans with exclusive bounds touching the query, which the
+ *        closed comparison lets through and the exact predicate rejects;
+ *  (iii) temporal boxes over float values, and spatiotemporal boxes with Z,
+ *        queried with boxes lacking the time dimension, whose bounds along
+ *        that axis must not be compared;
+ *  (iv)  the three search operations, the join of two trees, and the
+ *        nearest-neighbour cursor over entries whose time extent is disjoint
+ *        from the query.
+ * Every search and join is required to return exactly the ids of the
+ * brute-force scan, and the cursor the distances of the exact box distance.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o rtree_scan_test rtree_scan_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of boxes inserted into each index, enough for several levels */
+#define NUM_BOXES 1500
+/* Number of query boxes per index and operation */
+#define NUM_QUERIES 60
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+static int
+cmp_int64(const void *a, const void *b)
+{
+  int64 x = *(const int64 *) a, y = *(const int64 *) b;
+  return (x > y) - (x < y);
+}
+
+/* Exact predicate of an operation over two boxes of the index type */
+typedef bool (*box_pred)(const void *, const void *);
+
+static bool span_overlaps(const void *a, const void *b)
+{ return overlaps_span_span(a, b); }
+static bool span_contains(const void *a, const void *b)
+{ return contains_span_span(a, b); }
+static bool tbox_overlaps(const void *a, const void *b)
+{ return overlaps_tbox_tbox(a, b); }
+static bool tbox_contains(const void *a, const void *b)
+{ return contains_tbox_tbox(a, b); }
+static bool stbox_overlaps(const void *a, const void *b)
+{ return overlaps_stbox_stbox(a, b); }
+static bool stbox_contains(const void *a, const void *b)
+{ return contains_stbox_stbox(a, b); }
+
+/**
+ * @brief Return true when the exact predicate of an operation holds for a
+ * stored box and a query
+ */
+static bool
+brute_match(RTreeSearchOp op, box_pred overlaps, box_pred contains,
+  const void *box, const void *query)
+{
+  if (op == RTREE_OVERLAPS)
+    return overlaps(box, query);
+  if (op == RTREE_CONTAINS)
+    return contains(box, query);
+  return contains(query, box);
+}
+
+/**
+ * @brief Return true when a search answers exactly the ids of a brute-force
+ * scan, over every query and operation
+ * @param[out] hits Total number of ids answered, to make sure the comparison
+ * is not vacuous
+ */
+static bool
+search_matches(const RTree *rtree, const char *boxes, const char *queries,
+  size_t size, box_pred overlaps, box_pred contains, int *hits)
+{
+  MeosArray *result = meos_array_create(sizeof(int64));
+  int64 *got = malloc(sizeof(int64) * NUM_BOXES);
+  int64 *want = malloc(sizeof(int64) * NUM_BOXES);
+  bool ok = true;
+  *hits = 0;
+  for (int op = RTREE_OVERLAPS; op <= RTREE_CONTAINED_BY; op++)
+  {
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      const void *query = queries + q * size;
+      int ngot = rtree_search(rtree, op, query, result);
+      for (int i = 0; i < ngot; i++)
+        got[i] = *(int64 *) meos_array_get(result, i);
+      int nwant = 0;
+      for (int i = 0; i < NUM_BOXES; i++)
+        if (brute_match(op, overlaps, contains, boxes + i * size, query))
+          want[nwant++] = i;
+      qsort(got, (size_t) ngot, sizeof(int64), cmp_int64);
+      if (ngot != nwant || memcmp(got, want, sizeof(int64) * ngot) != 0)
+        ok = false;
+      *hits += ngot;
+    }
+  }
+  free(got); free(want);
+  meos_array_destroy(result);
+  return ok;
+}
+
+/**
+ * @brief Return true when the join of two trees answers exactly the pairs of
+ * a brute-force scan, for every operation
+ */
+static bool
+join_matches(const RTree *rtree1, const RTree *rtree2, const char *boxes1,
+  const char *boxes2, int count2, size_t size, box_pred overlaps,
+  box_pred contains)
+{
+  MeosArray *result = meos_array_create(sizeof(int64));
+  bool ok = true;
+  for (int op = RTREE_OVERLAPS; op <= RTREE_CONTAINED_BY; op++)
+  {
+    int npairs = rtree_join(rtree1, rtree2, op, result);
+    int64 *got = malloc(sizeof(int64) * (npairs ? npairs : 1));
+    for (int k = 0; k < npairs; k++)
+      got[k] = *(int64 *) meos_array_get(result, 2 * k) * count2 +
+        *(int64 *) meos_array_get(result, 2 * k + 1);
+    qsort(got, (size_t) npairs, sizeof(int64), cmp_int64);
+    int nwant = 0;
+    for (int i = 0; i < NUM_BOXES && ok; i++)
+      for (int j = 0; j < count2; j++)
+        if (brute_match(op, overlaps, contains, boxes1 + i * size,
+            boxes2 + j * size))
+        {
+          if (nwant >= npairs || got[nwant] != (int64) i * count2 + j)
+            ok = false;
+          nwant++;
+        }
+    if (nwant != npairs)
+      ok = false;
+    free(got);
+  }
+  meos_array_destroy(result);
+  return ok;
+}
+
+static double
+frand(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  srand(20260101);
+  int hits;
+
+  printf("Integer and date spans with negative bounds\n");
+  {
+    Span *boxes = malloc(sizeof(Span) * NUM_BOXES);
+    Span *queries = malloc(sizeof(Span) * NUM_QUERIES);
+    RTree *rtree = rtree_create_intspan();
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      int lower = (rand() % 20000) - 10000;
+      Span *s = intspan_make(lower, lower + rand() % 50, true, true);
+      boxes[i] = *s; free(s);
+      rtree_insert(rtree, &boxes[i], i);
+    }
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      int lower = (rand() % 20000) - 10000;
+      Span *s = intspan_make(lower, lower + rand() % 400, true, true);
+      queries[q] = *s; free(s);
+    }
+    check("intspan search equals brute force",
+      search_matches(rtree, (char *) boxes, (char *) queries, sizeof(Span),
+        span_overlaps, span_contains, &hits) && hits > 0);
+    rtree_free(rtree);
+
+    rtree = rtree_create_datespan();
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      DateADT lower = (rand() % 20000) - 15000;
+      Span *s = datespan_make(lower, lower + 1 + rand() % 50, true, false);
+      boxes[i] = *s; free(s);
+    }
+    int64 *ids = malloc(sizeof(int64) * NUM_BOXES);
+    for (int i = 0; i < NUM_BOXES; i++)
+      ids[i] = i;
+    rtree_load(rtree, boxes, ids, NUM_BOXES);
+    free(ids);
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      DateADT lower = (rand() % 20000) - 15000;
+      Span *s = datespan_make(lower, lower + 1 + rand() % 400, true, false);
+      queries[q] = *s; free(s);
+    }
+    check("datespan search equals brute force",
+      search_matches(rtree, (char *) boxes, (char *) queries, sizeof(Span),
+        span_overlaps, span_contains, &hits) && hits > 0);
+    rtree_free(rtree);
+    free(boxes); free(queries);
+  }
+
+  printf("Float spans with exclusive bounds touching the queries\n");
+  {
+    Span *boxes = malloc(sizeof(Span) * NUM_BOXES);
+    Span *queries = malloc(sizeof(Span) * NUM_QUERIES);
+    RTree *rtree = rtree_create_floatspan();
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      /* Bounds on a coarse grid so that many of them touch a query bound */
+      double lower = (double) (rand() % 400) / 4.0 - 50.0;
+      Span *s = floatspan_make(lower, lower + (double) (1 + rand() % 8) / 4.0,
+        rand() % 2, rand() % 2);
+      boxes[i] = *s; free(s);
+      rtree_insert(rtree, &boxes[i], i);
+    }
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      double lower = (double) (rand() % 400) / 4.0 - 50.0;
+      Span *s = floatspan_make(lower, lower + (double) (1 + rand() % 20) / 4.0,
+        rand() % 2, rand() % 2);
+      queries[q] = *s; free(s);
+    }
+    check("floatspan search equals brute force",
+      search_matches(rtree, (char *) boxes, (char *) queries, sizeof(Span),
+        span_overlaps, span_contains, &hits) && hits > 0);
+
+    /* Join against a second tree of the same kind */
+    Span *boxes2 = malloc(sizeof(Span) * NUM_QUERIES);
+    RTree *rtree2 = rtree_create_floatspan();
+    for (int j = 0; j < NUM_QUERIES; j++)
+    {
+      boxes2[j] = queries[j];
+      rtree_insert(rtree2, &boxes2[j], j);
+    }
+    check("floatspan join equals brute force",
+      join_matches(rtree, rtree2, (char *) boxes, (char *) boxes2,
+        NUM_QUERIES, sizeof(Span), span_overlaps, span_contains));
+    rtree_free(rtree2); free(boxes2);
+    rtree_free(rtree);
+    free(boxes); free(queries);
+  }
+
+  printf("Temporal boxes over float values\n");
+  {
+    TBox *boxes = malloc(sizeof(TBox) * NUM_BOXES);
+    TBox *queries = malloc(sizeof(TBox) * NUM_QUERIES);
+    RTree *rtree = rtree_create_tbox();
+    char buf[256];
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      double x = frand() * 1000.0;
+      int day = 1 + rand() % 27;
+      snprintf(buf, sizeof(buf), "TBOXFLOAT XT([%f,%f),[2000-01-%02d,"
+        "2000-01-%02d))", x, x + frand() * 20.0, day, day + 1);
+      TBox *box = tbox_in(buf);
+      boxes[i] = *box; free(box);
+      rtree_insert(rtree, &boxes[i], i);
+    }
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      double x = frand() * 1000.0;
+      int day = 1 + rand() % 20;
+      /* Every other query has no time dimension */
+      if (q % 2)
+        snprintf(buf, sizeof(buf), "TBOXFLOAT X([%f,%f])", x,
+          x + frand() * 100.0);
+      else
+        snprintf(buf, sizeof(buf), "TBOXFLOAT XT([%f,%f],[2000-01-%02d,"
+          "2000-01-%02d])", x, x + frand() * 100.0, day, day + 7);
+      TBox *box = tbox_in(buf);
+      queries[q] = *box; free(box);
+    }
+    check("tbox search equals brute force",
+      search_matches(rtree, (char *) boxes, (char *) queries, sizeof(TBox),
+        tbox_overlaps, tbox_contains, &hits) && hits > 0);
+    rtree_free(rtree);
+    free(boxes); free(queries);
+  }
+
+  printf("Spatiotemporal boxes with Z\n");
+  {
+    STBox *boxes = malloc(sizeof(STBox) * NUM_BOXES);
+    STBox *queries = malloc(sizeof(STBox) * NUM_QUERIES);
+    RTree *rtree = rtree_create_stbox();
+    char buf[256];
+    for (int i = 0; i < NUM_BOXES; i++)
+    {
+      double x = frand() * 100.0, y = frand() * 100.0, z = frand() * 100.0;
+      int day = 1 + rand() % 27;
+      snprintf(buf, sizeof(buf), "STBOX ZT(((%f,%f,%f),(%f,%f,%f)),"
+        "[2000-01-%02d,2000-01-%02d])", x, y, z, x + frand() * 5.0,
+        y + frand() * 5.0, z + frand() * 5.0, day, day + 1);
+      STBox *box = stbox_in(buf);
+      boxes[i] = *box; free(box);
+      rtree_insert(rtree, &boxes[i], i);
+    }
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+      double x = frand() * 100.0, y = frand() * 100.0, z = frand() * 100.0;
+      int day = 1 + rand() % 20;
+      double w = 10.0 + frand() * 30.0;
+      /* Every other query has no time dimension */
+      if (q % 2)
+        snprintf(buf, sizeof(buf), "STBOX Z((%f,%f,%f),(%f,%f,%f))",
+          x, y, z, x + w, y + w, z + w);
+      else
+        snprintf(buf, sizeof(buf), "STBOX ZT(((%f,%f,%f),(%f,%f,%f)),"
+          "[2000-01-%02d,2000-01-%02d])", x, y, z, x + w, y + w, z + w, day,
+          day + 7);
+      STBox *box = stbox_in(buf);
+      queries[q] = *box; free(box);
+    }
+    check("stbox search equals brute force",
+      search_matches(rtree, (char *) boxes, (char *) queries, sizeof(STBox),
+        stbox_overlaps, stbox_contains, &hits) && hits > 0);
+
+    /* Join against a tree of larger boxes so that all operations answer */
+    STBox *boxes2 = malloc(sizeof(STBox) * NUM_QUERIES);
+    RTree *rtree2 = rtree_create_stbox();
+    for (int j = 0; j < NUM_QUERIES; j++)
+    {
+      double x = frand() * 100.0, y = frand() * 100.0, z = frand() * 100.0;
+      snprintf(buf, sizeof(buf), "STBOX ZT(((%f,%f,%f),(%f,%f,%f)),"
+        "[2000-01-01,2000-01-31])", x, y, z, x + 20.0, y + 20.0, z + 20.0);
+      STBox *box = stbox_in(buf);
+      boxes2[j] = *box; free(box);
+      rtree_insert(rtree2, &boxes2[j], j);
+    }
+    check("stbox join equals brute force",
+      join_matches(rtree, rtree2, (char *) boxes, (char *) boxes2,
+        NUM_QUERIES, sizeof(STBox), stbox_overlaps, stbox_contains));
+    rtree_free(rtree2); free(boxes2);
+
+    /* Nearest neighbours of a query sharing its time extent with a part of
+     * the entries only: every distance must be the exact box distance */
+    STBox *query = stbox_in("STBOX ZT(((50,50,50),(51,51,51)),"
+      "[2000-01-10,2000-01-12])");
+    RTreeNNCursor *cursor = rtree_nn_cursor_open(rtree, query);
+    int64 id;
+    double dist, prev = 0.0;
+    int n = 0, nfar = 0;
+    bool ok = true;
+    while (rtree_nn_cursor_next(cursor, &id, &dist))
+    {
+      double exact = nad_stbox_stbox(query, &boxes[id]);
+      if (dist != exact || dist < prev)
+        ok = false;
+      if (exact == DBL_MAX)
+        nfar++;
+      prev = dist;
+      n++;
+    }
+    rtree_nn_cursor_close(cursor);
+    free(query);
+    check("stbox nearest neighbours are the exact box distances",
+      ok && n == NUM_BOXES && nfar > 0 && nfar < NUM_BOXES);
+    rtree_free(rtree);
+    free(boxes); free(queries);
+  }
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("\nAll RTree node scan tests passed.\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,441 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+/**
+ * @file
+ * @brief A program that tests the similarity distances between temporal
+ * values computed by tiles of the distance matrix, comparing their results
+ * with the ones computed on the full matrix in this program.
+ *
+ * The values are random walks of temporal floats and of 2D and 3D temporal
+ * geometry points. Their number of instants is below, at, and above the
+ * multiples of the width of the tiles, and large enough for the anti-diagonals
+ * of tiles to be computed by the threads of the MEOS thread pool.
+ *
+ * Five properties are asserted:
+ *  (i)   distances: the Fréchet, Dynamic Time Warp (DTW), Longest Common
+ *        SubSequence (LCSS), and average Hausdorff distances are equal to the
+ *        ones computed on the full matrix;
+ *  (ii)  threads: the distances are the same when the thread pool is started;
+ *  (iii) band: the bounded distances restricted to a band are equal to the
+ *        ones computed on the cells of the band of the full matrix, are
+ *        greater than or equal to the unbounded ones, and are equal to them
+ *        when the band covers the matrix;
+ *  (iv)  early abandon: the bounded distances are infinity when the maximum
+ *        distance is below the distance and are the distance otherwise;
+ *  (v)   arrays: the distances from a value to an array of values are the
+ *        bounded distances between the value and each element of the array,
+ *        and invalid arguments are reported.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o similarity_test similarity_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Maximum distance for two instants to match in LCSS */
+#define LCSS_EPSILON 5.0
+
+/* Kinds of the functions computed on the full matrix */
+typedef enum
+{
+  REF_FRECHET,
+  REF_DTW,
+  REF_LCSS,
+} RefFunc;
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Return a random number between 0 and 1 */
+static double
+random_unit(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+/* Values and timestamps of a temporal value, dim is 1 for temporal floats
+ * and 2 or 3 for temporal points */
+typedef struct
+{
+  int count;
+  int dim;
+  double *x, *y, *z;
+  Temporal *temp;
+} Walk;
+
+/* Fill a random walk and its temporal value */
+static void
+walk_make(Walk *w, int n, int dim)
+{
+  w->count = n;
+  w->dim = dim;
+  w->x = malloc(sizeof(double) * n);
+  w->y = malloc(sizeof(double) * n);
+  w->z = malloc(sizeof(double) * n);
+  TInstant **instants = malloc(sizeof(TInstant *) * n);
+  double x = 0.0, y = 0.0, z = 0.0;
+  /* 2001-01-01 in microseconds since 2000-01-01 */
+  TimestampTz t = (TimestampTz) 366 * 86400 * 1000000;
+  for (int i = 0; i < n; i++)
+  {
+    x += 10.0 * (random_unit() * 2 - 1);
+    y += 10.0 * (random_unit() * 2 - 1);
+    z += 10.0 * (random_unit() * 2 - 1);
+    t += (TimestampTz) (1 + rand() % 60) * 1000000;
+    w->x[i] = x;
+    w->y[i] = (dim > 1) ? y : 0.0;
+    w->z[i] = (dim > 2) ? z : 0.0;
+    if (dim == 1)
+      instants[i] = tfloatinst_make(x, t);
+    else
+    {
+      GSERIALIZED *gs = (dim == 3) ? geompoint_make3dz(0, x, y, z) :
+        geompoint_make2d(0, x, y);
+      instants[i] = tpointinst_make(gs, t);
+      free(gs);
+    }
+  }
+  w->temp = (Temporal *) tsequence_make(instants, n, true, true, LINEAR,
+    false);
+  for (int i = 0; i < n; i++)
+    free(instants[i]);
+  free(instants);
+  return;
+}
+
+static void
+walk_free(Walk *w)
+{
+  free(w->x); free(w->y); free(w->z); free(w->temp);
+  return;
+}
+
+/* Return the distance between the i-th instant of a walk and the j-th
+ * instant of another one, computed with hypot in 2D as in PostGIS */
+static double
+walk_dist(const Walk *a, int i, const Walk *b, int j)
+{
+  if (a->dim == 1)
+    return fabs(a->x[i] - b->x[j]);
+  if (a->dim == 2)
+    return hypot(b->x[j] - a->x[i], b->y[j] - a->y[i]);
+  double dx = b->x[j] - a->x[i], dy = b->y[j] - a->y[i],
+    dz = b->z[j] - a->z[i];
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/* Return the distance computed on the full matrix, whose rows are the walk
+ * with the most instants, or the second one when they have the same number
+ * of instants, restricted to a band if window is not -1 */
+static double
+ref_similarity(const Walk *w1, const Walk *w2, RefFunc func, int window)
+{
+  const Walk *a = (w1->count > w2->count) ? w1 : w2;
+  const Walk *b = (w1->count > w2->count) ? w2 : w1;
+  int n = a->count, m = b->count;
+  double none = (func == REF_LCSS) ? 0.0 : INFINITY;
+  double *mat = malloc(sizeof(double) * (n + 1) * (m + 1));
+#define MAT(i, j) mat[(i) * (m + 1) + (j)]
+  for (int i = 0; i <= n; i++)
+    for (int j = 0; j <= m; j++)
+      MAT(i, j) = none;
+  MAT(0, 0) = 0.0;
+  for (int i = 1; i <= n; i++)
+  {
+    long long num = (long long) (i - 1) * (m - 1);
+    long long den = (n > 1) ? n - 1 : 1;
+    long long lower = (window < 0) ? 0 : num / den - window;
+    long long upper = (window < 0) ? m - 1 : (num + den - 1) / den + window;
+    for (int j = 1; j <= m; j++)
+    {
+      if (j - 1 < lower || j - 1 > upper)
+        continue;
+      double d = walk_dist(a, i - 1, b, j - 1);
+      double prev = fmin(MAT(i - 1, j - 1), fmin(MAT(i - 1, j),
+        MAT(i, j - 1)));
+      if (func == REF_FRECHET)
+        MAT(i, j) = fmax(d, prev);
+      else if (func == REF_DTW)
+        MAT(i, j) = d + prev;
+      else
+        MAT(i, j) = (d <= LCSS_EPSILON) ? MAT(i - 1, j - 1) + 1 :
+          fmax(MAT(i - 1, j), MAT(i, j - 1));
+    }
+  }
+  double result = MAT(n, m);
+#undef MAT
+  free(mat);
+  return result;
+}
+
+/* Return the average Hausdorff distance computed on the full matrix */
+static double
+ref_average_hausdorff(const Walk *a, const Walk *b)
+{
+  double sum1 = 0.0, sum2 = 0.0;
+  for (int i = 0; i < a->count; i++)
+  {
+    double min = INFINITY;
+    for (int j = 0; j < b->count; j++)
+      min = fmin(min, walk_dist(a, i, b, j));
+    sum1 += min;
+  }
+  for (int j = 0; j < b->count; j++)
+  {
+    double min = INFINITY;
+    for (int i = 0; i < a->count; i++)
+      min = fmin(min, walk_dist(a, i, b, j));
+    sum2 += min;
+  }
+  return 0.5 * ((sum1 / (double) a->count) + (sum2 / (double) b->count));
+}
+
+/* Return true if all distances between two walks are equal to the reference
+ * ones */
+static bool
+distances_equal(const Walk *a, const Walk *b)
+{
+  return
+    temporal_frechet_distance(a->temp, b->temp) ==
+      ref_similarity(a, b, REF_FRECHET, -1) &&
+    temporal_dyntimewarp_distance(a->temp, b->temp) ==
+      ref_similarity(a, b, REF_DTW, -1) &&
+    temporal_lcss_distance(a->temp, b->temp, LCSS_EPSILON) ==
+      ref_similarity(a, b, REF_LCSS, -1) &&
+    temporal_average_hausdorff_distance(a->temp, b->temp) ==
+      ref_average_hausdorff(a, b);
+}
+
+/* Check the distances for the sizes around the width of the tiles */
+static void
+check_distances(const char *name, int dim)
+{
+  static const int sizes[] = { 1, 2, 255, 256, 257, 600 };
+  int nsizes = (int) (sizeof(sizes) / sizeof(sizes[0]));
+  bool ok = true;
+  for (int i = 0; i < nsizes && ok; i++)
+  {
+    for (int j = 0; j < nsizes && ok; j++)
+    {
+      Walk a, b;
+      walk_make(&a, sizes[i], dim);
+      walk_make(&b, sizes[j], dim);
+      ok = distances_equal(&a, &b);
+      walk_free(&a); walk_free(&b);
+    }
+  }
+  check(name, ok);
+  return;
+}
+
+/* Check the bounded distances in a band and with a maximum distance */
+static void
+check_bounds(const Walk *a, const Walk *b, const char *suffix)
+{
+  char name[64];
+  double frechet = temporal_frechet_distance(a->temp, b->temp);
+  double dtw = temporal_dyntimewarp_distance(a->temp, b->temp);
+
+  /* (iii) band */
+  int wide = a->count + b->count;
+  bool ok = true;
+  for (int window = 0; window <= 8 && ok; window += 4)
+  {
+    double f = temporal_frechet_distance_bounded(a->temp, b->temp, window,
+      INFINITY);
+    double d = temporal_dyntimewarp_distance_bounded(a->temp, b->temp,
+      window, INFINITY);
+    ok = f == ref_similarity(a, b, REF_FRECHET, window) && f >= frechet &&
+      d == ref_similarity(a, b, REF_DTW, window) && d >= dtw;
+  }
+  snprintf(name, sizeof(name), "band equals the full matrix band%s", suffix);
+  check(name, ok);
+  snprintf(name, sizeof(name), "wide band equals no band%s", suffix);
+  check(name,
+    temporal_frechet_distance_bounded(a->temp, b->temp, wide, INFINITY) ==
+      frechet &&
+    temporal_dyntimewarp_distance_bounded(a->temp, b->temp, wide, INFINITY) ==
+      dtw);
+
+  /* (iv) early abandon */
+  snprintf(name, sizeof(name), "abandon below the distance%s", suffix);
+  check(name,
+    isinf(temporal_frechet_distance_bounded(a->temp, b->temp, -1,
+      0.5 * frechet)) &&
+    isinf(temporal_dyntimewarp_distance_bounded(a->temp, b->temp, -1,
+      0.5 * dtw)) &&
+    isinf(temporal_frechet_distance_bounded(a->temp, b->temp, -1,
+      nextafter(frechet, 0.0))) &&
+    isinf(temporal_dyntimewarp_distance_bounded(a->temp, b->temp, -1,
+      nextafter(dtw, 0.0))));
+  snprintf(name, sizeof(name), "no abandon at the distance%s", suffix);
+  check(name,
+    temporal_frechet_distance_bounded(a->temp, b->temp, -1, frechet) ==
+      frechet &&
+    temporal_dyntimewarp_distance_bounded(a->temp, b->temp, -1, dtw) ==
+      dtw);
+  return;
+}
+
+/* Check the distances from a value to an array of values */
+static void
+check_arrays(int count, int n, const char *suffix)
+{
+  char name[64];
+  Walk query, *walks = malloc(sizeof(Walk) * count);
+  Temporal **temparr = malloc(sizeof(Temporal *) * count);
+  double *result = malloc(sizeof(double) * count);
+  walk_make(&query, n, 2);
+  for (int i = 0; i < count; i++)
+  {
+    walk_make(&walks[i], n / 2 + rand() % n, 2);
+    temparr[i] = walks[i].temp;
+  }
+
+  bool ok = temparr_frechet_distance(query.temp, temparr, count, -1,
+    INFINITY, result);
+  for (int i = 0; i < count && ok; i++)
+    ok = result[i] == temporal_frechet_distance(query.temp, temparr[i]);
+  snprintf(name, sizeof(name), "array Frechet distances%s", suffix);
+  check(name, ok);
+
+  /* The maximum distance is the one to the first element of the array */
+  double maxdist = result[0];
+  ok = temparr_frechet_distance(query.temp, temparr, count, 4, maxdist,
+    result);
+  for (int i = 0; i < count && ok; i++)
+    ok = result[i] == temporal_frechet_distance_bounded(query.temp,
+      temparr[i], 4, maxdist);
+  ok = ok && temparr_dyntimewarp_distance(query.temp, temparr, count, 4,
+    100.0 * n, result);
+  for (int i = 0; i < count && ok; i++)
+    ok = result[i] == temporal_dyntimewarp_distance_bounded(query.temp,
+      temparr[i], 4, 100.0 * n);
+  snprintf(name, sizeof(name), "array bounded distances%s", suffix);
+  check(name, ok);
+
+  free(result); free(temparr);
+  walk_free(&query);
+  for (int i = 0; i < count; i++)
+    walk_free(&walks[i]);
+  free(walks);
+  return;
+}
+
+/* Check that invalid arguments are reported */
+static void
+check_errors(void)
+{
+  Walk a, b, c;
+  walk_make(&a, 10, 2);
+  walk_make(&b, 10, 2);
+  walk_make(&c, 10, 1);
+  Temporal *temparr[2] = { b.temp, NULL };
+  double result[2];
+  check("error on a band of width below -1",
+    temporal_frechet_distance_bounded(a.temp, b.temp, -2, INFINITY) ==
+      DBL_MAX && meos_errno_reset() == MEOS_ERR_INVALID_ARG_VALUE);
+  check("error on a negative maximum distance",
+    temporal_dyntimewarp_distance_bounded(a.temp, b.temp, -1, -1.0) ==
+      DBL_MAX && meos_errno_reset() == MEOS_ERR_INVALID_ARG_VALUE);
+  check("error on a null element of the array",
+    ! temparr_frechet_distance(a.temp, temparr, 2, -1, INFINITY, result) &&
+    meos_errno_reset() == MEOS_ERR_INVALID_ARG_VALUE);
+  temparr[1] = c.temp;
+  check("error on mixed temporal types in the array",
+    ! temparr_dyntimewarp_distance(a.temp, temparr, 2, -1, INFINITY,
+      result) && meos_errno_reset() == MEOS_ERR_INVALID_ARG_TYPE);
+  check("error on an empty array",
+    ! temparr_frechet_distance(a.temp, temparr, 0, -1, INFINITY, result) &&
+    meos_errno_reset() != MEOS_SUCCESS);
+  walk_free(&a); walk_free(&b); walk_free(&c);
+  return;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  srand(1);
+
+  printf("Similarity distances by tiles\n");
+
+  /* (i) distances */
+  check_distances("distances of temporal floats", 1);
+  check_distances("distances of 2D temporal points", 2);
+  check_distances("distances of 3D temporal points", 3);
+
+  /* (iii) band and (iv) early abandon */
+  Walk a, b;
+  walk_make(&a, 700, 2);
+  walk_make(&b, 530, 2);
+  check_bounds(&a, &b, "");
+  walk_free(&a); walk_free(&b);
+  check_arrays(6, 300, "");
+  check_errors();
+
+  /* (ii) threads: the anti-diagonals have enough tiles for the pool */
+  walk_make(&a, 2300, 2);
+  walk_make(&b, 2100, 2);
+  bool serial = distances_equal(&a, &b);
+  if (meos_initialize_threads(4) < 0)
+    check("thread pool started", false);
+  check("large distances without threads", serial);
+  check("large distances with threads", distances_equal(&a, &b));
+  check_bounds(&a, &b, " with threads");
+  walk_free(&a); walk_free(&b);
+  check_arrays(16, 600, " with threads");
+  meos_finalize_threads();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,352 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the states of the temporal aggregates when they
+ * are exchanged and combined as in a parallel aggregation, i.e., the
+ * combine functions that keep the values of each state as a sorted run
+ * merged by the final function, and the compact binary format of the states.
+ *
+ * The values are random temporal integers and booleans that are split among
+ * several partial states, as the rows of a table among parallel workers.
+ *
+ * Five properties are asserted per aggregate:
+ *  (i)   combine: combining all the partial states into the first one and
+ *        finalizing gives the result of a single state over all the values;
+ *  (ii)  tree: combining the partial states pairwise, so that the combined
+ *        states themselves carry runs, gives the same result;
+ *  (iii) round trip: a state written in binary format and read back gives
+ *        the same result, also for a combined state and a temporal count;
+ *  (iv)  bytes: writing a state read back gives the same bytes;
+ *  (v)   errors: combining states of instants and of sequences raises an
+ *        error in the final function, and a truncated or corrupted binary
+ *        state is rejected when it is read.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tagg_state_test tagg_state_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+
+/* Number of values aggregated per test */
+#define NUM_VALUES 600
+/* Number of partial states, one per parallel worker */
+#define NUM_STATES 7
+/* Number of timestamps of the grid */
+#define GRID_SIZE 200
+/* Step of the grid, one minute */
+#define GRID_STEP ((TimestampTz) 60000000)
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Origin of the grid of timestamps */
+static TimestampTz T0;
+
+/* Return a timestamp of the grid */
+static TimestampTz
+grid(int i)
+{
+  return T0 + (TimestampTz) i * GRID_STEP;
+}
+
+/* Return a random step sequence of integers or booleans */
+static Temporal *
+random_seq(bool isbool)
+{
+  int count = 1 + rand() % 5;
+  TInstant *instants[5];
+  int t = rand() % (GRID_SIZE - 10);
+  int value = 0;
+  bool lower_inc = rand() % 2, upper_inc = rand() % 2;
+  for (int i = 0; i < count; i++)
+  {
+    /* With step interpolation an exclusive upper bound keeps the value */
+    if (i == 0 || i < count - 1 || upper_inc)
+      value = rand() % 100;
+    instants[i] = isbool ? tboolinst_make(value % 2, grid(t)) :
+      tintinst_make(value, grid(t));
+    t += 1 + rand() % 2;
+  }
+  if (count == 1)
+    lower_inc = upper_inc = true;
+  Temporal *result = (Temporal *) tsequence_make(instants, count, lower_inc,
+    upper_inc, STEP, true);
+  for (int i = 0; i < count; i++)
+    free(instants[i]);
+  return result;
+}
+
+/* Return a random instant of integers */
+static Temporal *
+random_inst(void)
+{
+  return (Temporal *) tintinst_make(rand() % 100, grid(rand() % GRID_SIZE));
+}
+
+/* Aggregate functions of the test */
+typedef struct
+{
+  const char *name;
+  SkipList *(*transfn)(SkipList *, const Temporal *);
+  SkipList *(*combinefn)(SkipList *, SkipList *);
+  bool isbool;
+} Agg;
+
+static const Agg AGGS[] =
+{
+  {"tsum", &tint_tsum_transfn, &tint_tsum_combinefn, false},
+  {"tmax", &tint_tmax_transfn, &tint_tmax_combinefn, false},
+  {"tor", &tbool_tor_transfn, &tbool_tor_combinefn, true},
+  {"tcount", &temporal_tcount_transfn, &temporal_tcount_combinefn, false},
+};
+
+/* Free a state, which the final function does */
+static void
+state_free(SkipList *state)
+{
+  free(temporal_tagg_finalfn(state));
+}
+
+/* Return true if the two results are equal */
+static bool
+same_result(Temporal *temp1, Temporal *temp2)
+{
+  bool result = temp1 && temp2 && temporal_eq(temp1, temp2);
+  free(temp1); free(temp2);
+  return result;
+}
+
+/* Return the state written in binary format and read back */
+static SkipList *
+round_trip(SkipList *state, uint8_t **bytes, size_t *size)
+{
+  *size = temporal_aggstate_size(state);
+  *bytes = malloc(*size);
+  temporal_aggstate_write(state, *bytes);
+  SkipList *result = temporal_aggstate_read(*bytes, *size);
+  state_free(state);
+  return result;
+}
+
+/* Return the partial states of the values */
+static void
+partial_states(const Agg *agg, Temporal **values, SkipList **states)
+{
+  for (int i = 0; i < NUM_STATES; i++)
+    states[i] = NULL;
+  for (int i = 0; i < NUM_VALUES; i++)
+  {
+    int k = rand() % NUM_STATES;
+    states[k] = agg->transfn(states[k], values[i]);
+  }
+}
+
+/* (i)-(iv) */
+static void
+test_agg(const Agg *agg, bool instants)
+{
+  char name[128];
+  const char *kind = instants ? "instants" : "sequences";
+  Temporal *values[NUM_VALUES];
+  for (int i = 0; i < NUM_VALUES; i++)
+    values[i] = instants ? random_inst() : random_seq(agg->isbool);
+
+  SkipList *single = NULL;
+  for (int i = 0; i < NUM_VALUES; i++)
+    single = agg->transfn(single, values[i]);
+  Temporal *expected = temporal_tagg_finalfn(single);
+
+  /* (i) */
+  SkipList *states[NUM_STATES];
+  unsigned int seed = (unsigned int) rand();
+  srand(seed);
+  partial_states(agg, values, states);
+  SkipList *state = states[0];
+  for (int i = 1; i < NUM_STATES; i++)
+    state = agg->combinefn(state, states[i]);
+  for (int i = 1; i < NUM_STATES; i++)
+    state_free(states[i]);
+  snprintf(name, sizeof(name), "%s %s: combined states", agg->name, kind);
+  check(name, same_result(temporal_tagg_finalfn(state),
+    temporal_copy(expected)));
+
+  /* (ii) */
+  srand(seed);
+  partial_states(agg, values, states);
+  for (int width = 1; width < NUM_STATES; width *= 2)
+    for (int i = 0; i + width < NUM_STATES; i += 2 * width)
+    {
+      states[i] = agg->combinefn(states[i], states[i + width]);
+      state_free(states[i + width]);
+    }
+  snprintf(name, sizeof(name), "%s %s: pairwise combined states", agg->name,
+    kind);
+  check(name, same_result(temporal_tagg_finalfn(states[0]),
+    temporal_copy(expected)));
+
+  /* (iii) and (iv) */
+  srand(seed);
+  partial_states(agg, values, states);
+  uint8_t *bytes, *bytes2;
+  size_t size, size2;
+  for (int i = 0; i < NUM_STATES; i++)
+  {
+    states[i] = round_trip(states[i], &bytes, &size);
+    free(bytes);
+  }
+  state = states[0];
+  for (int i = 1; i < NUM_STATES; i++)
+    state = agg->combinefn(state, states[i]);
+  for (int i = 1; i < NUM_STATES; i++)
+    state_free(states[i]);
+  state = round_trip(state, &bytes, &size);
+  state = round_trip(state, &bytes2, &size2);
+  snprintf(name, sizeof(name), "%s %s: states read back", agg->name, kind);
+  check(name, same_result(temporal_tagg_finalfn(state),
+    temporal_copy(expected)));
+  snprintf(name, sizeof(name), "%s %s: same bytes when written again",
+    agg->name, kind);
+  check(name, size == size2 && memcmp(bytes, bytes2, size) == 0);
+  free(bytes); free(bytes2);
+
+  free(expected);
+  for (int i = 0; i < NUM_VALUES; i++)
+    free(values[i]);
+}
+
+/* (v) */
+static void
+test_errors(void)
+{
+  SkipList *state1 = NULL, *state2 = NULL;
+  for (int i = 0; i < 10; i++)
+  {
+    Temporal *inst = random_inst();
+    Temporal *seq = random_seq(false);
+    state1 = tint_tsum_transfn(state1, inst);
+    state2 = tint_tsum_transfn(state2, seq);
+    free(inst); free(seq);
+  }
+  SkipList *state = tint_tsum_combinefn(state1, state2);
+  Temporal *result = temporal_tagg_finalfn(state);
+  check("instants and sequences cannot be combined",
+    result == NULL && meos_errno() != 0);
+  meos_errno_reset();
+  state_free(state2);
+
+  /* Binary states that do not match their size */
+  state = NULL;
+  for (int i = 0; i < 10; i++)
+  {
+    Temporal *seq = random_seq(false);
+    state = tint_tsum_transfn(state, seq);
+    free(seq);
+  }
+  size_t size = temporal_aggstate_size(state);
+  uint8_t *bytes = malloc(size);
+  temporal_aggstate_write(state, bytes);
+  state_free(state);
+  bool rejected = true;
+  for (size_t len = 0; len < size; len++)
+  {
+    /* Copy the prefix so that reading past it is detected by sanitizers */
+    uint8_t *prefix = malloc(len + 1);
+    memcpy(prefix, bytes, len);
+    SkipList *read = temporal_aggstate_read(prefix, len);
+    if (read || meos_errno() == 0)
+      rejected = false;
+    if (read)
+      state_free(read);
+    meos_errno_reset();
+    free(prefix);
+  }
+  check("truncated binary states are rejected", rejected);
+  /* The number of values is the first field of the binary format */
+  int32_t length;
+  memcpy(&length, bytes, sizeof(int32_t));
+  int32_t corrupt[] = {-1, length + 1, 1 << 30};
+  rejected = true;
+  for (size_t i = 0; i < sizeof(corrupt) / sizeof(corrupt[0]); i++)
+  {
+    memcpy(bytes, &corrupt[i], sizeof(int32_t));
+    SkipList *read = temporal_aggstate_read(bytes, size);
+    if (read || meos_errno() == 0)
+      rejected = false;
+    if (read)
+      state_free(read);
+    meos_errno_reset();
+  }
+  check("binary states with a wrong number of values are rejected",
+    rejected);
+  free(bytes);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+  T0 = timestamptz_in("2025-01-01 08:00:00", -1);
+
+  for (size_t i = 0; i < sizeof(AGGS) / sizeof(AGGS[0]); i++)
+  {
+    printf("Aggregate %s\n", AGGS[i].name);
+    test_agg(&AGGS[i], false);
+    if (! AGGS[i].isbool)
+      test_agg(&AGGS[i], true);
+  }
+  printf("Errors\n");
+  test_errors();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
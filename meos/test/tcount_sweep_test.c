@@ -0,0 +1,405 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the temporal count aggregate, whose transition
+ * functions record the bounds of the values in an event buffer that the
+ * final function sweeps once.
+ *
+ * The values are random temporal integers, timestamps, and spans on a coarse
+ * grid of timestamps so that many bounds coincide, with random inclusive and
+ * exclusive bounds.
+ *
+ * Five properties are asserted:
+ *  (i)   sequences: the temporal count of continuous sequences and sequence
+ *        sets is equal to the temporal sum of temporal integers with value 1
+ *        over the same periods, which splices every value into the skiplist;
+ *  (ii)  instants: the same holds for timestamps, timestamp sets, instants,
+ *        and discrete sequences;
+ *  (iii) spans: the same holds for spans and span sets;
+ *  (iv)  combine: the combination of two partial states is equal to the state
+ *        of all the values;
+ *  (v)   values: at every timestamp of the grid and between two consecutive
+ *        ones the count is the number of values that contain the timestamp,
+ *        and mixing instants and sequences in a state raises an error.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tcount_sweep_test tcount_sweep_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+
+/* Number of values aggregated per test */
+#define NUM_VALUES 400
+/* Number of timestamps of the grid */
+#define GRID_SIZE 60
+/* Step of the grid, one minute */
+#define GRID_STEP ((TimestampTz) 60000000)
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Origin of the grid of timestamps */
+static TimestampTz T0;
+
+/* Return a timestamp of the grid */
+static TimestampTz
+grid(int i)
+{
+  return T0 + (TimestampTz) i * GRID_STEP;
+}
+
+/* Return a random span of the grid, which is an instant one time in eight */
+static Span *
+random_span(void)
+{
+  int lower = rand() % (GRID_SIZE - 1);
+  if (rand() % 8 == 0)
+    return tstzspan_make(grid(lower), grid(lower), true, true);
+  int width = GRID_SIZE - 1 - lower;
+  int upper = lower + 1 + rand() % (width < 8 ? width : 8);
+  return tstzspan_make(grid(lower), grid(upper), rand() % 2, rand() % 2);
+}
+
+/* Return a random continuous temporal integer with up to three sequences */
+static Temporal *
+random_tint(void)
+{
+  int nseqs = 1 + rand() % 3;
+  TSequence *sequences[3];
+  int lower = rand() % (GRID_SIZE / 2);
+  int k = 0;
+  for (int i = 0; i < nseqs && lower < GRID_SIZE - 1; i++)
+  {
+    int count = 1 + rand() % 4;
+    TInstant *instants[4];
+    int n = 0;
+    int t = lower, value = 0;
+    bool lower_inc = rand() % 2, upper_inc = rand() % 2;
+    for (int j = 0; j < count && t < GRID_SIZE; j++)
+    {
+      /* With step interpolation an exclusive upper bound keeps the value */
+      if (j == 0 || j < count - 1 || upper_inc)
+        value = rand() % 100;
+      instants[n++] = tintinst_make(value, grid(t));
+      t += 1 + rand() % 3;
+    }
+    if (n == 1)
+      lower_inc = upper_inc = true;
+    sequences[k++] = tsequence_make(instants, n, lower_inc, upper_inc, STEP,
+      true);
+    for (int j = 0; j < n; j++)
+      free(instants[j]);
+    /* Leave a gap of at least one grid step between the sequences */
+    lower = t + 1;
+  }
+  if (k == 1)
+    return (Temporal *) sequences[0];
+  Temporal *result = (Temporal *) tsequenceset_make(sequences, k, false);
+  for (int i = 0; i < k; i++)
+    free(sequences[i]);
+  return result;
+}
+
+/* Return the span of a timestamp as a temporal integer of value 1 */
+static Temporal *
+one_at(TimestampTz t)
+{
+  return (Temporal *) tintinst_make(1, t);
+}
+
+/* Add the sum of value 1 over a span to the reference state */
+static SkipList *
+ref_span(SkipList *state, const Span *s)
+{
+  Temporal *one = (Temporal *) tintseq_from_base_tstzspan(1, s);
+  state = tint_tsum_transfn(state, one);
+  free(one);
+  return state;
+}
+
+/* Add the sum of value 1 over the periods of a temporal value */
+static SkipList *
+ref_temporal(SkipList *state, const Temporal *temp)
+{
+  SpanSet *ss = temporal_time(temp);
+  for (int i = 0; i < spanset_num_spans(ss); i++)
+  {
+    Span *s = spanset_span_n(ss, i + 1);
+    state = ref_span(state, s);
+    free(s);
+  }
+  free(ss);
+  return state;
+}
+
+/* Return true if the two results are equal, including their representation */
+static bool
+same_result(const Temporal *temp1, const Temporal *temp2)
+{
+  if (! temp1 || ! temp2)
+    return temp1 == temp2;
+  char *str1 = tint_out(temp1);
+  char *str2 = tint_out(temp2);
+  bool result = temporal_eq(temp1, temp2) && strcmp(str1, str2) == 0;
+  if (! result)
+    printf("    %s\n    %s\n", str1, str2);
+  free(str1); free(str2);
+  return result;
+}
+
+/* Return true if the count at @p t is the number of spans containing it */
+static bool
+count_at(const Temporal *temp, Span **spans, int count, TimestampTz t)
+{
+  int expected = 0;
+  for (int i = 0; i < count; i++)
+    if (contains_span_timestamptz(spans[i], t))
+      expected++;
+  int value;
+  bool found = tint_value_at_timestamptz(temp, t, true, &value);
+  return found ? (value == expected) : (expected == 0);
+}
+
+/* (i), (iv), (v) */
+static void
+test_sequences(void)
+{
+  Temporal *values[NUM_VALUES];
+  for (int i = 0; i < NUM_VALUES; i++)
+    values[i] = random_tint();
+
+  SkipList *state = NULL, *ref = NULL, *state1 = NULL, *state2 = NULL;
+  for (int i = 0; i < NUM_VALUES; i++)
+  {
+    state = temporal_tcount_transfn(state, values[i]);
+    ref = ref_temporal(ref, values[i]);
+    if (i % 3 == 0)
+      state1 = temporal_tcount_transfn(state1, values[i]);
+    else
+      state2 = temporal_tcount_transfn(state2, values[i]);
+  }
+  Temporal *result = temporal_tagg_finalfn(state);
+  Temporal *expected = temporal_tagg_finalfn(ref);
+  Temporal *combined = temporal_tagg_finalfn(
+    temporal_tcount_combinefn(state1, state2));
+  check("sequences: equal to the sum over the skiplist",
+    same_result(result, expected));
+  check("sequences: combined states equal to a single state",
+    same_result(combined, result));
+
+  /* Collect the periods of the values for the brute-force count */
+  Span **spans = malloc(sizeof(Span *) * NUM_VALUES * 3);
+  int nspans = 0;
+  for (int i = 0; i < NUM_VALUES; i++)
+  {
+    SpanSet *ss = temporal_time(values[i]);
+    for (int j = 0; j < spanset_num_spans(ss); j++)
+      spans[nspans++] = spanset_span_n(ss, j + 1);
+    free(ss);
+  }
+  bool ok = true;
+  for (int i = 0; i < GRID_SIZE && ok; i++)
+    ok = count_at(result, spans, nspans, grid(i)) &&
+      count_at(result, spans, nspans, grid(i) + GRID_STEP / 2);
+  check("sequences: count at every timestamp of the grid", ok);
+
+  for (int i = 0; i < nspans; i++)
+    free(spans[i]);
+  free(spans);
+  for (int i = 0; i < NUM_VALUES; i++)
+    free(values[i]);
+  free(result); free(expected); free(combined);
+}
+
+/* (ii), (iv), (v) */
+static void
+test_instants(void)
+{
+  SkipList *state = NULL, *ref = NULL, *state1 = NULL, *state2 = NULL;
+  for (int i = 0; i < NUM_VALUES; i++)
+  {
+    TimestampTz t = grid(rand() % GRID_SIZE);
+    SkipList **part = (i % 2) ? &state1 : &state2;
+    switch (i % 4)
+    {
+      case 0:
+      {
+        state = timestamptz_tcount_transfn(state, t);
+        *part = timestamptz_tcount_transfn(*part, t);
+        Temporal *one = one_at(t);
+        ref = tint_tsum_transfn(ref, one);
+        free(one);
+        break;
+      }
+      case 1:
+      {
+        TimestampTz times[3] = {t, t + GRID_STEP, t + 3 * GRID_STEP};
+        Set *s = tstzset_make(times, 3);
+        state = tstzset_tcount_transfn(state, s);
+        *part = tstzset_tcount_transfn(*part, s);
+        Temporal *one = (Temporal *) tintseq_from_base_tstzset(1, s);
+        ref = tint_tsum_transfn(ref, one);
+        free(one); free(s);
+        break;
+      }
+      case 2:
+      {
+        Temporal *inst = (Temporal *) tintinst_make(rand() % 100, t);
+        state = temporal_tcount_transfn(state, inst);
+        *part = temporal_tcount_transfn(*part, inst);
+        Temporal *one = one_at(t);
+        ref = tint_tsum_transfn(ref, one);
+        free(one); free(inst);
+        break;
+      }
+      default:
+      {
+        TInstant *instants[2];
+        instants[0] = tintinst_make(rand() % 100, t);
+        instants[1] = tintinst_make(rand() % 100, t + 2 * GRID_STEP);
+        Temporal *seq = (Temporal *) tsequence_make(instants, 2, true, true,
+          DISCRETE, false);
+        state = temporal_tcount_transfn(state, seq);
+        *part = temporal_tcount_transfn(*part, seq);
+        for (int j = 0; j < 2; j++)
+        {
+          Temporal *one = one_at(instants[j]->t);
+          ref = tint_tsum_transfn(ref, one);
+          free(one); free(instants[j]);
+        }
+        free(seq);
+      }
+    }
+  }
+  Temporal *result = temporal_tagg_finalfn(state);
+  Temporal *expected = temporal_tagg_finalfn(ref);
+  Temporal *combined = temporal_tagg_finalfn(
+    temporal_tcount_combinefn(state1, state2));
+  check("instants: equal to the sum over the skiplist",
+    same_result(result, expected));
+  check("instants: combined states equal to a single state",
+    same_result(combined, result));
+  free(result); free(expected); free(combined);
+
+  /* A state of instants cannot count a span */
+  Span *s = random_span();
+  SkipList *mixed = timestamptz_tcount_transfn(NULL, T0);
+  mixed = tstzspan_tcount_transfn(mixed, s);
+  check("instants: mixing instants and spans is rejected",
+    mixed == NULL && meos_errno() != 0);
+  meos_errno_reset();
+  free(s);
+}
+
+/* (iii), (v) */
+static void
+test_spans(void)
+{
+  Span *spans[NUM_VALUES * 2];
+  int nspans = 0;
+  SkipList *state = NULL, *ref = NULL;
+  for (int i = 0; i < NUM_VALUES; i++)
+  {
+    if (i % 2)
+    {
+      Span *s = random_span();
+      state = tstzspan_tcount_transfn(state, s);
+      ref = ref_span(ref, s);
+      spans[nspans++] = s;
+    }
+    else
+    {
+      Span *s1 = random_span(), *s2 = random_span();
+      Span s[2] = {*s1, *s2};
+      SpanSet *ss = spanset_make(s, 2);
+      state = tstzspanset_tcount_transfn(state, ss);
+      for (int j = 0; j < spanset_num_spans(ss); j++)
+      {
+        Span *sj = spanset_span_n(ss, j + 1);
+        ref = ref_span(ref, sj);
+        spans[nspans++] = sj;
+      }
+      free(s1); free(s2); free(ss);
+    }
+  }
+  Temporal *result = temporal_tagg_finalfn(state);
+  Temporal *expected = temporal_tagg_finalfn(ref);
+  check("spans: equal to the sum over the skiplist",
+    same_result(result, expected));
+  bool ok = true;
+  for (int i = 0; i < GRID_SIZE && ok; i++)
+    ok = count_at(result, spans, nspans, grid(i)) &&
+      count_at(result, spans, nspans, grid(i) + GRID_STEP / 2);
+  check("spans: count at every timestamp of the grid", ok);
+  for (int i = 0; i < nspans; i++)
+    free(spans[i]);
+  free(result); free(expected);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+  T0 = timestamptz_in("2025-01-01 08:00:00", -1);
+
+  for (int round = 0; round < 5; round++)
+  {
+    printf("Round %d\n", round + 1);
+    test_sequences();
+    test_instants();
+    test_spans();
+  }
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the batch functions computing an accessor, a
+ * bounding box, or a restriction of each value of an array of temporal
+ * values.
+ *
+ * The values are random temporal integers, floats, and geometry and
+ * geography points of every subtype.
+ *
+ * Five properties are asserted:
+ *  (i)   accessors: the start and end timestamps and values, the durations,
+ *        the numbers of instants, and the lengths of the batch functions are
+ *        those of the functions applied to each value;
+ *  (ii)  bounding boxes: the periods, the temporal boxes, and the
+ *        spatiotemporal boxes are those of the functions applied to each
+ *        value;
+ *  (iii) restriction: the values restricted to a common span are those of
+ *        #temporal_at_tstzspan, `NULL` for the values out of the span;
+ *  (iv)  thread pool: with a pool started, the lengths and the restrictions
+ *        of an array with many instants are the same as without a pool;
+ *  (v)   errors: an empty array, a `NULL` element, a value of another type,
+ *        and a span of another type are refused.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o temporal_batch_test temporal_batch_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of random values of an array */
+#define NUM_VALUES 200
+/* Maximum number of instants of a random sequence */
+#define MAX_INSTS 30
+/* Number of values of the array of the thread pool test */
+#define NUM_LARGE 2000
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Append to the string the n instants of a random value of a type starting
+ * at a minute, enclosed in brackets when the value is a sequence */
+static int
+append_instants(char *buf, char type, int n, int minute, bool brackets)
+{
+  int len = brackets ? sprintf(buf, "[") : 0;
+  for (int i = 0; i < n; i++)
+  {
+    /* The values are not collinear so that the sequences keep every instant */
+    int v = 2 * i * i + rand() % 2;
+    if (i > 0)
+      len += sprintf(buf + len, ", ");
+    if (type == 'i')
+      len += sprintf(buf + len, "%d", v);
+    else if (type == 'f')
+      len += sprintf(buf + len, "%d.5", v);
+    else
+      len += sprintf(buf + len, "Point(%d %d)", v % 80, i % 80);
+    len += sprintf(buf + len, "@2001-01-01 %02d:%02d:%02d+00",
+      (minute + i) / 60, (minute + i) % 60, rand() % 60);
+  }
+  if (brackets)
+    len += sprintf(buf + len, "]");
+  return len;
+}
+
+/* Return a random value of a type: an instant, a sequence, or a sequence
+ * set of two or three sequences */
+static Temporal *
+random_value(char type, int maxinsts)
+{
+  char buf[4 * MAX_INSTS * 64 + 64];
+  int len = 0, subtype = rand() % 3, minute = rand() % 60;
+  if (type == 'p')
+    len += sprintf(buf, "SRID=3857;");
+  if (type == 'i')
+    len += sprintf(buf + len, "Interp=Step;");
+  if (subtype == 0)
+    append_instants(buf + len, type, 1, minute, false);
+  else if (subtype == 1)
+    append_instants(buf + len, type, 1 + rand() % maxinsts, minute, true);
+  else
+  {
+    int nseqs = 2 + rand() % 2;
+    len += sprintf(buf + len, "{");
+    for (int i = 0; i < nseqs; i++)
+    {
+      int n = 1 + rand() % maxinsts;
+      if (i > 0)
+        len += sprintf(buf + len, ", ");
+      len += append_instants(buf + len, type, n, minute, true);
+      minute += n + 1;
+    }
+    sprintf(buf + len, "}");
+  }
+  switch (type)
+  {
+    case 'i': return tint_in(buf);
+    case 'f': return tfloat_in(buf);
+    case 'p': return tgeompoint_in(buf);
+    default:  return tgeogpoint_in(buf);
+  }
+}
+
+static void
+random_values(Temporal **values, int count, char type, int maxinsts)
+{
+  for (int i = 0; i < count; i++)
+    values[i] = random_value(type, maxinsts);
+}
+
+static void
+free_values(Temporal **values, int count)
+{
+  for (int i = 0; i < count; i++)
+    free(values[i]);
+}
+
+/* Return the number of microseconds of an interval without months */
+static int64
+interval_usecs(const Interval *interv)
+{
+  return interv->time + (int64) interv->day * 86400 * 1000000;
+}
+
+/* (i) accessors */
+static void
+test_accessors(void)
+{
+  printf("(i) accessors\n");
+  Temporal *values[NUM_VALUES];
+  TimestampTz times[NUM_VALUES];
+  int64 durations[NUM_VALUES];
+  int ints[NUM_VALUES];
+  double doubles[NUM_VALUES];
+
+  random_values(values, NUM_VALUES, 'f', MAX_INSTS);
+  bool ok = temparr_start_timestamptz(values, NUM_VALUES, times);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (times[i] == temporal_start_timestamptz(values[i]));
+  check("start timestamps", ok);
+  ok = temparr_end_timestamptz(values, NUM_VALUES, times);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (times[i] == temporal_end_timestamptz(values[i]));
+  check("end timestamps", ok);
+  for (int b = 0; b < 2; b++)
+  {
+    ok = temparr_duration(values, NUM_VALUES, b, durations);
+    for (int i = 0; ok && i < NUM_VALUES; i++)
+    {
+      Interval *interv = temporal_duration(values[i], b);
+      ok = (durations[i] == interval_usecs(interv));
+      free(interv);
+    }
+    check(b ? "durations of the bounding spans" : "durations", ok);
+  }
+  ok = temparr_num_instants(values, NUM_VALUES, ints);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (ints[i] == temporal_num_instants(values[i]));
+  check("numbers of instants", ok);
+  /* An instant shared by two consecutive sequences is counted once */
+  Temporal *ss = tfloat_in("{[1@2000-01-01, 2@2000-01-02), "
+    "[2@2000-01-02, 5@2000-01-03]}");
+  ok = temparr_num_instants(&ss, 1, ints);
+  check("instant shared by two sequences counted once",
+    ok && ints[0] == 3 && ints[0] == temporal_num_instants(ss));
+  free(ss);
+  ok = tfloatarr_start_value(values, NUM_VALUES, doubles);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (doubles[i] == tfloat_start_value(values[i]));
+  check("start values of temporal floats", ok);
+  ok = tfloatarr_end_value(values, NUM_VALUES, doubles);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (doubles[i] == tfloat_end_value(values[i]));
+  check("end values of temporal floats", ok);
+  free_values(values, NUM_VALUES);
+
+  random_values(values, NUM_VALUES, 'i', MAX_INSTS);
+  ok = tintarr_start_value(values, NUM_VALUES, ints);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (ints[i] == tint_start_value(values[i]));
+  check("start values of temporal integers", ok);
+  ok = tintarr_end_value(values, NUM_VALUES, ints);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+    ok = (ints[i] == tint_end_value(values[i]));
+  check("end values of temporal integers", ok);
+  free_values(values, NUM_VALUES);
+
+  const char *types = "pg";
+  for (int t = 0; types[t]; t++)
+  {
+    random_values(values, NUM_VALUES, types[t], MAX_INSTS);
+    ok = tpointarr_length(values, NUM_VALUES, doubles);
+    for (int i = 0; ok && i < NUM_VALUES; i++)
+      ok = (doubles[i] == tpoint_length(values[i]));
+    check(t ? "lengths of geography points" : "lengths of geometry points",
+      ok);
+    free_values(values, NUM_VALUES);
+  }
+}
+
+/* (ii) bounding boxes */
+static void
+test_boxes(void)
+{
+  printf("(ii) bounding boxes\n");
+  Temporal *values[NUM_VALUES];
+  Span spans[NUM_VALUES];
+  TBox tboxes[NUM_VALUES];
+  STBox stboxes[NUM_VALUES];
+
+  random_values(values, NUM_VALUES, 'f', MAX_INSTS);
+  bool ok = temparr_to_tstzspan(values, NUM_VALUES, spans);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+  {
+    Span *s = temporal_to_tstzspan(values[i]);
+    ok = span_eq(&spans[i], s);
+    free(s);
+  }
+  check("periods", ok);
+  ok = tnumberarr_to_tbox(values, NUM_VALUES, tboxes);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+  {
+    TBox *box = tnumber_to_tbox(values[i]);
+    ok = tbox_eq(&tboxes[i], box);
+    free(box);
+  }
+  check("temporal boxes", ok);
+  free_values(values, NUM_VALUES);
+
+  random_values(values, NUM_VALUES, 'p', MAX_INSTS);
+  ok = tspatialarr_to_stbox(values, NUM_VALUES, stboxes);
+  for (int i = 0; ok && i < NUM_VALUES; i++)
+  {
+    STBox *box = tspatial_to_stbox(values[i]);
+    ok = stbox_eq(&stboxes[i], box);
+    free(box);
+  }
+  check("spatiotemporal boxes", ok);
+  free_values(values, NUM_VALUES);
+}
+
+/* Return true if the restrictions of an array to a span are those of
+ * temporal_at_tstzspan and count the NULL results */
+static bool
+same_restrictions(Temporal **values, int count, const Span *s, int *nulls)
+{
+  Temporal **result = malloc(sizeof(Temporal *) * count);
+  bool ok = temparr_at_tstzspan(values, count, s, result);
+  *nulls = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ok)
+      break;
+    Temporal *exp = temporal_at_tstzspan(values[i], s);
+    ok = (exp == NULL) ? (result[i] == NULL) :
+      (result[i] != NULL && temporal_eq(result[i], exp));
+    if (! exp)
+      (*nulls)++;
+    free(exp);
+  }
+  if (temparr_at_tstzspan(values, 0, s, result))
+    ok = false;
+  for (int i = 0; i < count; i++)
+    free(result[i]);
+  free(result);
+  return ok;
+}
+
+/* (iii) restriction */
+static void
+test_restriction(void)
+{
+  printf("(iii) restriction\n");
+  Temporal *values[NUM_VALUES];
+  random_values(values, NUM_VALUES, 'f', MAX_INSTS);
+  Span *s = tstzspan_in("[2001-01-01 00:40:00+00, 2001-01-01 01:10:30+00)");
+  int nulls;
+  bool ok = same_restrictions(values, NUM_VALUES, s, &nulls);
+  check("restriction to a span", ok);
+  check("some values are out of the span", nulls > 0 && nulls < NUM_VALUES);
+  free(s);
+  free_values(values, NUM_VALUES);
+}
+
+/* (iv) thread pool */
+static void
+test_thread_pool(void)
+{
+  printf("(iv) thread pool\n");
+  Temporal **values = malloc(sizeof(Temporal *) * NUM_LARGE);
+  random_values(values, NUM_LARGE, 'p', MAX_INSTS);
+  double *seq = malloc(sizeof(double) * NUM_LARGE);
+  double *par = malloc(sizeof(double) * NUM_LARGE);
+  bool ok = tpointarr_length(values, NUM_LARGE, seq);
+  check("pool started", meos_initialize_threads(4) == 4);
+  ok &= tpointarr_length(values, NUM_LARGE, par);
+  for (int i = 0; ok && i < NUM_LARGE; i++)
+    ok = (seq[i] == par[i]);
+  check("lengths", ok);
+  Span *s = tstzspan_in("[2001-01-01 00:40:00+00, 2001-01-01 01:10:30+00)");
+  int nulls;
+  check("restriction to a span",
+    same_restrictions(values, NUM_LARGE, s, &nulls));
+  meos_finalize_threads();
+  free(s);
+  free(seq);
+  free(par);
+  free_values(values, NUM_LARGE);
+  free(values);
+}
+
+/* (v) errors */
+static void
+test_errors(void)
+{
+  printf("(v) errors\n");
+  Temporal *values[2];
+  TimestampTz times[2];
+  double doubles[2];
+  int ints[2];
+  values[0] = tfloat_in("[1@2001-01-01, 2@2001-01-02]");
+  values[1] = NULL;
+  check("empty array", ! temparr_start_timestamptz(values, 0, times));
+  check("NULL element", ! temparr_start_timestamptz(values, 2, times));
+  values[1] = tint_in("[1@2001-01-01, 2@2001-01-02]");
+  check("temporal integer in an array of floats",
+    ! tfloatarr_start_value(values, 2, doubles));
+  check("temporal float in an array of integers",
+    ! tintarr_end_value(values, 2, ints));
+  check("temporal number in an array of points",
+    ! tpointarr_length(values, 2, doubles));
+  Span *s = floatspan_in("[1, 2]");
+  Temporal *result[2];
+  check("span of floats", ! temparr_at_tstzspan(values, 2, s, result));
+  free(s);
+  free_values(values, 2);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  srand(1);
+
+  test_accessors();
+  test_boxes();
+  test_restriction();
+  test_thread_pool();
+  test_errors();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d tests failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
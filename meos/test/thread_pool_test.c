@@ -0,0 +1,335 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the MEOS thread pool started by
+ * meos_initialize_threads, which splits the loops of the MEOS functions over
+ * large inputs between its threads.
+ *
+ * Each function is applied to the same input with and without the pool and
+ * the results are compared with temporal_eq. The inputs are sequence sets
+ * with more instants and sequences than the thresholds above which a loop is
+ * split between the threads.
+ *
+ * Six properties are asserted:
+ *  (i)   unary lifting: tfloat_degrees gives the same result with the pool;
+ *  (ii)  binary lifting: the product, with turning points, the temporal
+ *        comparison, with discontinuities, and the temporal distance of two
+ *        sequence sets give the same results with the pool;
+ *  (iii) merge: temporal_merge_array over values of different subtypes gives
+ *        the same result with the pool;
+ *  (iv)  split: tgeo_space_time_split gives the same fragments and bins in
+ *        the same order with the pool;
+ *  (v)   size: meos_get_threads reports the size of the pool, which can be
+ *        restarted with another size, and 1 once the pool is stopped;
+ *  (vi)  concurrent callers: application threads calling the functions
+ *        while the pool runs the loop of another thread obtain the same
+ *        results as without the pool.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o thread_pool_test thread_pool_test.c -L/usr/local/lib -lmeos -lm -lpthread
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of sequences of the sequence sets */
+#define NUM_SEQS 200
+/* Number of instants of each sequence */
+#define NUM_INSTS 40
+/* Number of threads of the pool */
+#define NUM_THREADS 4
+/* Number of application threads of property (vi) */
+#define NUM_CALLERS 3
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Append to @p str the instant at minute @p minute after 2000-01-01 of a
+ * value, or of a point when @p point is true */
+static size_t
+append_instant(char *str, size_t len, size_t size, int minute, int value,
+  int x, bool point, bool first)
+{
+  char time[64];
+  snprintf(time, sizeof(time), "2000-01-%02d %02d:%02d:00+00",
+    1 + minute / 1440, minute / 60 % 24, minute % 60);
+  if (point)
+    return len + snprintf(str + len, size - len, "%sPoint(%d %d)@%s",
+      first ? "" : ",", x, value, time);
+  return len + snprintf(str + len, size - len, "%s%d@%s", first ? "" : ",",
+    value, time);
+}
+
+/* Return a sequence set of NUM_SEQS sequences of NUM_INSTS instants, one per
+ * minute, whose sequences start every hour shifted by @p shift minutes, with
+ * values, or points when @p point is true, following a saw-tooth of phase
+ * @p phase */
+static Temporal *
+make_seqset(int shift, int phase, bool point)
+{
+  size_t size = (size_t) NUM_SEQS * NUM_INSTS * 64 + 16;
+  char *str = malloc(size);
+  size_t len = snprintf(str, size, "{");
+  for (int s = 0; s < NUM_SEQS; s++)
+  {
+    len += snprintf(str + len, size - len, "%s[", s ? "," : "");
+    for (int i = 0; i < NUM_INSTS; i++)
+      len = append_instant(str, len, size, s * 60 + shift + i,
+        ((s + i + phase) % 7) * 10 - 30, (s * 13 + i * 7) % 500, point,
+        i == 0);
+    len += snprintf(str + len, size - len, "]");
+  }
+  snprintf(str + len, size - len, "}");
+  Temporal *result = point ? tgeompoint_in(str) : tfloat_in(str);
+  free(str);
+  return result;
+}
+
+/* Return true when two results are both NULL or equal */
+static bool
+same_temporal(const Temporal *temp1, const Temporal *temp2)
+{
+  if (! temp1 || ! temp2)
+    return temp1 == temp2;
+  return temporal_eq(temp1, temp2);
+}
+
+/* Results of the functions of properties (i) to (iii) */
+typedef struct
+{
+  Temporal *degrees;
+  Temporal *mul;
+  Temporal *lt;
+  Temporal *dist;
+  Temporal *merge;
+} Results;
+
+/* Compute the results of the functions of properties (i) to (iii) */
+static void
+compute(Temporal *temp1, Temporal *temp2, Results *res)
+{
+  res->degrees = tfloat_degrees(temp1, false);
+  res->mul = mul_tnumber_tnumber(temp1, temp2);
+  res->lt = tlt_temporal_temporal(temp1, temp2);
+  res->dist = tdistance_tnumber_tnumber(temp1, temp2);
+  /* Merge instants, sequences and sequence sets disjoint in time */
+  int count = NUM_SEQS * 30;
+  Temporal **temparr = malloc(sizeof(Temporal *) * count);
+  char str[128];
+  for (int i = 0; i < count; i++)
+  {
+    /* Every third value is an instant, the others are sequences of two
+     * instants, and each value is five minutes after the previous one */
+    int minute = i * 5;
+    if (i % 3 == 0)
+      append_instant(str, 0, sizeof(str), minute, i % 11, 0, false, true);
+    else
+    {
+      size_t len = snprintf(str, sizeof(str), "[");
+      len = append_instant(str, len, sizeof(str), minute, i % 11, 0, false,
+        true);
+      len = append_instant(str, len, sizeof(str), minute + 2, i % 13, 0,
+        false, false);
+      snprintf(str + len, sizeof(str) - len, "]");
+    }
+    temparr[i] = tfloat_in(str);
+  }
+  res->merge = temporal_merge_array(temparr, count);
+  for (int i = 0; i < count; i++)
+    free(temparr[i]);
+  free(temparr);
+}
+
+static void
+free_results(Results *res)
+{
+  free(res->degrees); free(res->mul); free(res->lt); free(res->dist);
+  free(res->merge);
+}
+
+/* Return true when the results of the two computations are equal */
+static bool
+same_results(const Results *res1, const Results *res2)
+{
+  return same_temporal(res1->degrees, res2->degrees) &&
+    same_temporal(res1->mul, res2->mul) &&
+    same_temporal(res1->lt, res2->lt) &&
+    same_temporal(res1->dist, res2->dist) &&
+    same_temporal(res1->merge, res2->merge);
+}
+
+/* Return true when the two splits have the same fragments and bins */
+static bool
+same_split(const SpaceTimeSplit *split1, const SpaceTimeSplit *split2)
+{
+  if (split1->count != split2->count)
+    return false;
+  for (int i = 0; i < split1->count; i++)
+  {
+    if (! temporal_eq(split1->fragments[i], split2->fragments[i]) ||
+        split1->time_bins[i] != split2->time_bins[i] ||
+        ! geo_same(split1->space_bins[i], split2->space_bins[i]))
+      return false;
+  }
+  return true;
+}
+
+static void
+free_split(SpaceTimeSplit *split)
+{
+  for (int i = 0; i < split->count; i++)
+  {
+    free(split->fragments[i]);
+    free(split->space_bins[i]);
+  }
+  free(split->fragments); free(split->space_bins); free(split->time_bins);
+}
+
+/* Argument of an application thread of property (vi) */
+typedef struct
+{
+  Temporal *temp1;
+  Temporal *temp2;
+  const Results *expected;
+  bool ok;
+} Caller;
+
+static void *
+caller_thread(void *arg)
+{
+  Caller *caller = (Caller *) arg;
+  meos_initialize_timezone("UTC");
+  meos_initialize_collation();
+  caller->ok = true;
+  for (int round = 0; round < 3; round++)
+  {
+    Results res;
+    compute(caller->temp1, caller->temp2, &res);
+    caller->ok &= same_results(&res, caller->expected);
+    free_results(&res);
+  }
+  meos_finalize();
+  return NULL;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+
+  Temporal *temp1 = make_seqset(0, 0, false);
+  Temporal *temp2 = make_seqset(17, 3, false);
+  Temporal *tpoint = make_seqset(0, 0, true);
+  GSERIALIZED *sorigin = geom_in("Point(0 0)", -1);
+  Interval *duration = interval_in("2 hours", -1);
+  TimestampTz torigin = timestamptz_in("2000-01-01", -1);
+
+  printf("Testing the MEOS thread pool\n");
+  check("without a pool the size is 1", meos_get_threads() == 1);
+  Results seq;
+  compute(temp1, temp2, &seq);
+  SpaceTimeSplit seqsplit = tgeo_space_time_split(tpoint, 50, 50, 50,
+    duration, sorigin, torigin, true, false);
+  check("the split has fragments", seqsplit.count > 100);
+
+  check("the pool has the requested size",
+    meos_initialize_threads(NUM_THREADS) == NUM_THREADS &&
+    meos_get_threads() == NUM_THREADS);
+  Results par;
+  compute(temp1, temp2, &par);
+  check("degrees are the same with the pool",
+    same_temporal(seq.degrees, par.degrees));
+  check("products are the same with the pool",
+    same_temporal(seq.mul, par.mul));
+  check("comparisons are the same with the pool",
+    same_temporal(seq.lt, par.lt));
+  check("distances are the same with the pool",
+    same_temporal(seq.dist, par.dist));
+  check("merges are the same with the pool",
+    same_temporal(seq.merge, par.merge));
+  free_results(&par);
+  SpaceTimeSplit parsplit = tgeo_space_time_split(tpoint, 50, 50, 50,
+    duration, sorigin, torigin, true, false);
+  check("splits are the same with the pool", same_split(&seqsplit, &parsplit));
+  free_split(&parsplit);
+
+  pthread_t threads[NUM_CALLERS];
+  Caller callers[NUM_CALLERS];
+  for (int i = 0; i < NUM_CALLERS; i++)
+  {
+    callers[i] = (Caller) {temp1, temp2, &seq, false};
+    pthread_create(&threads[i], NULL, caller_thread, &callers[i]);
+  }
+  bool ok = true;
+  for (int i = 0; i < NUM_CALLERS; i++)
+  {
+    pthread_join(threads[i], NULL);
+    ok &= callers[i].ok;
+  }
+  check("concurrent callers obtain the same results", ok);
+
+  check("the pool can be restarted with another size",
+    meos_initialize_threads(2) == 2 && meos_get_threads() == 2);
+  compute(temp1, temp2, &par);
+  check("results are the same with the restarted pool",
+    same_results(&seq, &par));
+  free_results(&par);
+  meos_finalize_threads();
+  check("once stopped the size is 1", meos_get_threads() == 1);
+
+  free_results(&seq);
+  free_split(&seqsplit);
+  free(temp1); free(temp2); free(tpoint); free(sorigin); free(duration);
+
+  meos_finalize();
+  if (failures > 0)
+  {
+    printf("\n%d test(s) FAILED\n", failures);
+    return 1;
+  }
+  printf("\nAll tests passed\n");
+  return 0;
+}
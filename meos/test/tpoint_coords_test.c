@@ -0,0 +1,258 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the kernels of temporal points that read the
+ * coordinates of a sequence into packed arrays, i.e., the speed, the
+ * Douglas-Peucker simplifications, and the tiles of a sequence, together with
+ * the length, which reads the instants in place.
+ *
+ * The sequences are random walks in 2D and 3D whose number of instants lies
+ * around the multiples of the chunk size used by the kernels, and one
+ * instant in seven repeats the previous point.
+ *
+ * Five properties are asserted per number of instants and dimension:
+ *  (i)   length: tpoint_length is the sum of the segment lengths computed
+ *        one by one from the generated coordinates, bit for bit;
+ *  (ii)  speed: tpoint_speed is equal to temporal_derivative, which does not
+ *        use the packed arrays, for a sequence and a sequence set;
+ *  (iii) simplification: every instant of the sequence is within the
+ *        distance threshold of the sequence simplified by temporal_simplify_dp
+ *        with the synchronized distance, at the same timestamp;
+ *  (iv)  bounds: the simplified sequences of temporal_simplify_dp and
+ *        temporal_simplify_max_dist keep the first and the last instants;
+ *  (v)   tiles: the box of every instant is contained in one of the boxes
+ *        returned by tgeo_space_time_boxes with a bit matrix.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tpoint_coords_test tpoint_coords_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Largest number of instants of a sequence */
+#define MAX_INSTANTS 1100
+/* Distance threshold of the simplifications */
+#define SIMPLIFY_DIST 15.0
+/* Size of the tiles */
+#define TILE_SIZE 40.0
+/* Tolerance for floating-point distance comparisons */
+#define EPS 1e-9
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Return a pseudo-random double in [min, max] */
+static double
+random_double(double min, double max)
+{
+  return min + (max - min) * ((double) rand() / (double) RAND_MAX);
+}
+
+/* Coordinates and timestamps of the generated sequences */
+static double X[MAX_INSTANTS], Y[MAX_INSTANTS], Z[MAX_INSTANTS];
+static TimestampTz T[MAX_INSTANTS];
+
+/* Return a random walk of @p count instants starting at @p start */
+static Temporal *
+random_walk(int count, bool hasz, TimestampTz start)
+{
+  TInstant **instants = malloc(sizeof(TInstant *) * count);
+  TimestampTz t = start;
+  for (int i = 0; i < count; i++)
+  {
+    if (i > 0 && i % 7 == 0)
+    {
+      X[i] = X[i - 1]; Y[i] = Y[i - 1]; Z[i] = Z[i - 1];
+    }
+    else
+    {
+      X[i] = (i == 0) ? 0.0 : X[i - 1] + random_double(-10, 10);
+      Y[i] = (i == 0) ? 0.0 : Y[i - 1] + random_double(-10, 10);
+      Z[i] = (i == 0) ? 0.0 : Z[i - 1] + random_double(-10, 10);
+    }
+    T[i] = t;
+    t += (TimestampTz) (1 + rand() % 30) * 1000000;
+    GSERIALIZED *gs = hasz ? geompoint_make3dz(3857, X[i], Y[i], Z[i]) :
+      geompoint_make2d(3857, X[i], Y[i]);
+    instants[i] = tpointinst_make(gs, T[i]);
+    free(gs);
+  }
+  Temporal *result = (Temporal *) tsequence_make(instants, count, true, true,
+    LINEAR, false);
+  for (int i = 0; i < count; i++)
+    free(instants[i]);
+  free(instants);
+  return result;
+}
+
+/* Return true if the first and the last instants of the sequences are equal */
+static bool
+same_bounds(const Temporal *temp1, const Temporal *temp2)
+{
+  TInstant *s1 = temporal_start_instant(temp1);
+  TInstant *s2 = temporal_start_instant(temp2);
+  TInstant *e1 = temporal_end_instant(temp1);
+  TInstant *e2 = temporal_end_instant(temp2);
+  bool result = temporal_eq((Temporal *) s1, (Temporal *) s2) &&
+    temporal_eq((Temporal *) e1, (Temporal *) e2);
+  free(s1); free(s2); free(e1); free(e2);
+  return result;
+}
+
+static void
+test_sequence(int count, bool hasz)
+{
+  char name[128];
+  printf("%d instants, %s\n", count, hasz ? "3D" : "2D");
+  TimestampTz start = timestamptz_in("2000-01-01 00:00:00+00", -1);
+  Temporal *seq = random_walk(count, hasz, start);
+
+  /* (i) length */
+  double length = 0.0;
+  for (int i = 1; i < count; i++)
+  {
+    length += hasz ?
+      sqrt( ((X[i - 1] - X[i]) * (X[i - 1] - X[i])) +
+        ((Y[i - 1] - Y[i]) * (Y[i - 1] - Y[i])) +
+        ((Z[i - 1] - Z[i]) * (Z[i - 1] - Z[i])) ) :
+      sqrt( ((X[i - 1] - X[i]) * (X[i - 1] - X[i])) +
+        ((Y[i - 1] - Y[i]) * (Y[i - 1] - Y[i])) );
+  }
+  check("length equals the sum of the segment lengths",
+    tpoint_length(seq) == length);
+
+  /* (ii) speed, also for a sequence set with a second sequence one day later */
+  Temporal *speed = tpoint_speed(seq);
+  Temporal *deriv = temporal_derivative(seq);
+  check("speed equals the derivative", speed && deriv &&
+    temporal_eq(speed, deriv));
+  free(speed); free(deriv);
+  Temporal *seq2 = random_walk(count, hasz,
+    start + (TimestampTz) 86400 * 1000000 * 365);
+  TSequence *seqs[2] = { (TSequence *) seq, (TSequence *) seq2 };
+  Temporal *ss = (Temporal *) tsequenceset_make(seqs, 2, false);
+  speed = tpoint_speed(ss);
+  deriv = temporal_derivative(ss);
+  check("speed equals the derivative for a sequence set", speed && deriv &&
+    temporal_eq(speed, deriv));
+  free(speed); free(deriv); free(ss); free(seq2);
+  /* The coordinates of the first sequence are overwritten by the second one */
+  free(seq);
+  seq = random_walk(count, hasz, start);
+
+  /* (iii) simplification with the synchronized distance */
+  Temporal *dp = temporal_simplify_dp(seq, SIMPLIFY_DIST, true);
+  bool ok = dp != NULL;
+  for (int i = 0; ok && i < count; i++)
+  {
+    GSERIALIZED *value, *point = hasz ?
+      geompoint_make3dz(3857, X[i], Y[i], Z[i]) :
+      geompoint_make2d(3857, X[i], Y[i]);
+    ok = tgeo_value_at_timestamptz(dp, T[i], false, &value);
+    if (ok)
+    {
+      double d = hasz ? geom_distance3d(value, point) :
+        geom_distance2d(value, point);
+      ok = d <= SIMPLIFY_DIST + EPS;
+      free(value);
+    }
+    free(point);
+  }
+  check("synchronized distance to the simplification within threshold", ok);
+
+  /* (iv) bounds of the simplifications */
+  Temporal *dpspatial = temporal_simplify_dp(seq, SIMPLIFY_DIST, false);
+  Temporal *maxdist = temporal_simplify_max_dist(seq, SIMPLIFY_DIST, true);
+  snprintf(name, sizeof(name), "simplifications keep the bounds (%d, %d, %d)",
+    temporal_num_instants(dp), temporal_num_instants(dpspatial),
+    temporal_num_instants(maxdist));
+  check(name, same_bounds(seq, dp) && same_bounds(seq, dpspatial) &&
+    same_bounds(seq, maxdist));
+  free(dp); free(dpspatial); free(maxdist);
+
+  /* (v) tiles */
+  int nboxes;
+  GSERIALIZED *sorigin = hasz ? geompoint_make3dz(3857, 0, 0, 0) :
+    geompoint_make2d(3857, 0, 0);
+  STBox *boxes = tgeo_space_time_boxes(seq, TILE_SIZE, TILE_SIZE, TILE_SIZE,
+    NULL, sorigin, 0, true, true, &nboxes);
+  free(sorigin);
+  ok = boxes != NULL;
+  for (int i = 0; ok && i < count; i++)
+  {
+    TInstant *inst = temporal_instant_n(seq, i + 1);
+    STBox *box = tspatial_to_stbox((Temporal *) inst);
+    ok = false;
+    for (int j = 0; ! ok && j < nboxes; j++)
+      ok = contains_stbox_stbox(&boxes[j], box);
+    free(box); free(inst);
+  }
+  snprintf(name, sizeof(name), "every instant lies in one of the %d tiles",
+    nboxes);
+  check(name, ok);
+  free(boxes);
+  free(seq);
+  return;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  srand(2026);
+
+  /* Numbers of instants around the multiples of the chunk size */
+  int counts[] = { 2, 3, 255, 256, 257, 511, 512, 1100 };
+  for (size_t i = 0; i < sizeof(counts) / sizeof(int); i++)
+  {
+    test_sequence(counts[i], false);
+    test_sequence(counts[i], true);
+  }
+
+  meos_finalize();
+  printf("%s\n", failures ? "FAILURES" : "All tests passed");
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,323 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the cumulative-length index of temporal point
+ * sequences, which answers the queries on the length travelled by a
+ * sequence with a binary search.
+ *
+ * The sequences are random walks of geometry points, with and without Z,
+ * and of geography points, in which the point stops from time to time.
+ *
+ * Five properties are asserted:
+ *  (i)   length: the length of the index is the one of #tpoint_length;
+ *  (ii)  length at a timestamp: the length travelled at a timestamp is the
+ *        length of the sequence restricted to the period up to it;
+ *  (iii) inverse: the length travelled at the timestamp at which a length is
+ *        reached is this length, and the position at a length is the value
+ *        of the sequence at this timestamp, a stop being reached when it
+ *        starts;
+ *  (iv)  slicing: the sequence restricted to a range of lengths travels the
+ *        width of the range and includes a stop at its end;
+ *  (v)   errors: instants, sequence sets, step interpolation, other types,
+ *        and invalid ranges are refused, and lengths out of the sequence
+ *        give no result.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tpoint_index_test tpoint_index_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of instants of a random sequence */
+#define NUM_INSTS 2000
+/* Number of random probes per sequence */
+#define NUM_PROBES 200
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Return a random number between 0 and 1 */
+static double
+random_unit(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+/* Return a random walk of a temporal point of a kind: 'p' for 2D geometry
+ * points, 'z' for 3D geometry points, and 'g' for geography points */
+static Temporal *
+random_walk(char kind, int n)
+{
+  TInstant **instants = malloc(sizeof(TInstant *) * n);
+  double x = 0.0, y = 0.0, z = 0.0;
+  /* 2001-01-01 in microseconds since 2000-01-01 */
+  TimestampTz t = (TimestampTz) 366 * 86400 * 1000000;
+  for (int i = 0; i < n; i++)
+  {
+    /* The point stops at every tenth instant */
+    if (i > 0 && i % 10 != 0)
+    {
+      double step = (kind == 'g') ? 0.001 : 10.0;
+      x += step * (random_unit() * 2 - 1);
+      y += step * (random_unit() * 2 - 1);
+      z += step * (random_unit() * 2 - 1);
+    }
+    t += (TimestampTz) (1 + rand() % 60) * 1000000;
+    GSERIALIZED *gs = (kind == 'g') ? geogpoint_make2d(4326, x, y) :
+      (kind == 'z') ? geompoint_make3dz(0, x, y, z) :
+      geompoint_make2d(0, x, y);
+    instants[i] = tpointinst_make(gs, t);
+    free(gs);
+  }
+  Temporal *result = (Temporal *) tsequence_make(instants, n, true, true,
+    LINEAR, true);
+  for (int i = 0; i < n; i++)
+    free(instants[i]);
+  free(instants);
+  return result;
+}
+
+/* Return true if two values are equal up to a relative tolerance */
+static bool
+close_to(double a, double b, double tol)
+{
+  return fabs(a - b) <= tol * fmax(1.0, fmax(fabs(a), fabs(b)));
+}
+
+/* Return the distance between two points */
+static double
+point_distance(char kind, const GSERIALIZED *gs1, const GSERIALIZED *gs2)
+{
+  return (kind == 'g') ? geog_distance(gs1, gs2) :
+    (kind == 'z') ? geom_distance3d(gs1, gs2) : geom_distance2d(gs1, gs2);
+}
+
+/* Check the properties (i) to (iv) on a random walk of a kind */
+static void
+test_kind(char kind, const char *name)
+{
+  char label[128];
+  Temporal *seq = random_walk(kind, NUM_INSTS);
+  TPointIndex *idx = tpointindex_make(seq);
+  check("index built", idx != NULL);
+  if (! idx)
+  {
+    free(seq);
+    return;
+  }
+  TimestampTz start = temporal_start_timestamptz(seq);
+  TimestampTz end = temporal_end_timestamptz(seq);
+  double length = tpointindex_length(idx);
+
+  /* (i) length */
+  snprintf(label, sizeof(label), "(i) length of %s", name);
+  check(label, close_to(length, tpoint_length(seq),
+    (kind == 'g') ? 1e-9 : 0.0));
+
+  /* (ii) length at a timestamp, geography segments are not compared within
+   * a segment since their length is only proportional to time */
+  bool ok = true;
+  for (int i = 0; ok && i < NUM_PROBES; i++)
+  {
+    TimestampTz t = start + (TimestampTz) (random_unit() * (end - start));
+    if (kind == 'g')
+    {
+      int count;
+      TimestampTz *times = temporal_timestamps(seq, &count);
+      t = times[rand() % count];
+      free(times);
+    }
+    double d;
+    Span *s = tstzspan_make(start, t, true, true);
+    Temporal *prefix = temporal_at_tstzspan(seq, s);
+    ok = tpointindex_length_at_timestamptz(idx, t, &d) &&
+      close_to(d, tpoint_length(prefix), 1e-9);
+    free(s);
+    free(prefix);
+  }
+  snprintf(label, sizeof(label), "(ii) length at a timestamp of %s", name);
+  check(label, ok);
+
+  /* (iii) inverse */
+  ok = true;
+  for (int i = 0; ok && i < NUM_PROBES; i++)
+  {
+    double d = random_unit() * length, d2;
+    TimestampTz t;
+    ok = tpointindex_timestamptz_at_length(idx, d, &t) &&
+      tpointindex_length_at_timestamptz(idx, t, &d2) && close_to(d, d2, 1e-6);
+    GSERIALIZED *p1 = tpointindex_value_at_length(idx, d), *p2;
+    ok = ok && p1 && tgeo_value_at_timestamptz(seq, t, false, &p2);
+    if (ok)
+    {
+      /* The timestamp is rounded to the microsecond */
+      ok = point_distance(kind, p1, p2) < 1e-3;
+      free(p2);
+    }
+    free(p1);
+  }
+  snprintf(label, sizeof(label), "(iii) position at a length of %s", name);
+  check(label, ok);
+
+  /* (iv) slicing */
+  ok = true;
+  for (int i = 0; ok && i < NUM_PROBES; i++)
+  {
+    double from = random_unit() * length, to = random_unit() * length;
+    if (from > to)
+    {
+      double tmp = from; from = to; to = tmp;
+    }
+    Temporal *slice = tpointindex_at_length(idx, from, to);
+    ok = slice && close_to(tpoint_length(slice), to - from,
+      (kind == 'g') ? 1e-3 : 1e-6);
+    free(slice);
+  }
+  snprintf(label, sizeof(label), "(iv) slice of %s", name);
+  check(label, ok);
+  tpointindex_free(idx);
+  free(seq);
+}
+
+/* (iii) and (iv) on a sequence with a stop */
+static void
+test_stop(void)
+{
+  printf("stops\n");
+  Temporal *seq = tgeompoint_in("[Point(0 0)@2001-01-01 00:00:00+00, "
+    "Point(10 0)@2001-01-01 00:00:10+00, Point(10 0)@2001-01-01 00:00:20+00, "
+    "Point(20 0)@2001-01-01 00:00:30+00]");
+  TPointIndex *idx = tpointindex_make(seq);
+  TimestampTz start = temporal_start_timestamptz(seq), t;
+  double d;
+  check("length", tpointindex_length(idx) == 20.0);
+  check("a stop is reached when it starts",
+    tpointindex_timestamptz_at_length(idx, 10.0, &t) &&
+    t == start + 10000000);
+  check("length during the stop",
+    tpointindex_length_at_timestamptz(idx, start + 15000000, &d) &&
+    d == 10.0);
+  GSERIALIZED *p = tpointindex_value_at_length(idx, 15.0);
+  GSERIALIZED *exp = geom_in("Point(15 0)", -1);
+  check("position after the stop", p && geom_distance2d(p, exp) == 0.0);
+  free(p);
+  free(exp);
+  Temporal *slice = tpointindex_at_length(idx, 0.0, 10.0);
+  check("slice ending at the stop includes it",
+    slice && temporal_end_timestamptz(slice) == start + 20000000);
+  free(slice);
+  slice = tpointindex_at_length(idx, 10.0, 15.0);
+  check("slice starting at the stop includes it",
+    slice && temporal_start_timestamptz(slice) == start + 10000000 &&
+    temporal_end_timestamptz(slice) == start + 25000000);
+  free(slice);
+  tpointindex_free(idx);
+  free(seq);
+}
+
+/* (v) errors */
+static void
+test_errors(void)
+{
+  printf("(v) errors\n");
+  const char *invalid[] = {
+    "Point(1 1)@2001-01-01",
+    "{[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]}",
+    "Interp=Step;[Point(1 1)@2001-01-01, Point(2 2)@2001-01-02]",
+  };
+  const char *names[] = { "instant", "sequence set", "step interpolation" };
+  for (int i = 0; i < 3; i++)
+  {
+    Temporal *temp = tgeompoint_in(invalid[i]);
+    TPointIndex *idx = tpointindex_make(temp);
+    check(names[i], idx == NULL);
+    tpointindex_free(idx);
+    free(temp);
+  }
+  Temporal *temp = tfloat_in("[1@2001-01-01, 2@2001-01-02]");
+  check("temporal float", tpointindex_make(temp) == NULL);
+  free(temp);
+
+  temp = tgeompoint_in("[Point(0 0)@2001-01-01, Point(3 4)@2001-01-02]");
+  TPointIndex *idx = tpointindex_make(temp);
+  TimestampTz t;
+  double d;
+  check("length beyond the sequence",
+    ! tpointindex_timestamptz_at_length(idx, 5.5, &t) &&
+    tpointindex_value_at_length(idx, -1.0) == NULL);
+  check("timestamp out of the sequence",
+    ! tpointindex_length_at_timestamptz(idx, 0, &d));
+  check("range beyond the sequence",
+    tpointindex_at_length(idx, 6.0, 7.0) == NULL);
+  check("reversed range", tpointindex_at_length(idx, 2.0, 1.0) == NULL);
+  check("negative range", tpointindex_at_length(idx, -2.0, 1.0) == NULL);
+  tpointindex_free(idx);
+  free(temp);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  srand(1);
+
+  printf("random walks\n");
+  test_kind('p', "2D geometry points");
+  test_kind('z', "3D geometry points");
+  test_kind('g', "geography points");
+  test_stop();
+  test_errors();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d tests failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,373 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the functions of temporal geometry points that
+ * compute their segments with the vector kernels, comparing their results
+ * with the ones computed one segment at a time in this program.
+ *
+ * The sequences are random walks of 2D and 3D points in which the point
+ * stops from time to time, and zigzags whose points are at the same distance
+ * from the segment between their first and last points. Their number of
+ * instants is below, at, and above the multiples of the number of points
+ * processed at a time by the kernels.
+ *
+ * Five properties are asserted:
+ *  (i)   length: the length is the sum of the lengths of the segments,
+ *        added in the order of the segments;
+ *  (ii)  cumulative length: the value at each instant is the partial sum of
+ *        the distances between consecutive points, computed with @p hypot
+ *        in 2D as in PostGIS;
+ *  (iii) speed: the speed of each segment is the distance between its
+ *        points divided by its duration in seconds;
+ *  (iv)  simplification: the Douglas-Peucker simplification keeps the
+ *        instants kept by a recursive implementation that splits at the first
+ *        instant at the largest distance from the segment;
+ *  (v)   equality: all these values are equal to the reference ones, not
+ *        only close to them.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tpoint_simd_test tpoint_simd_test.c -L/usr/local/lib -lmeos -lm
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Distance used for the Douglas-Peucker simplification */
+#define SIMPLIFY_DIST 15.0
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Return a random number between 0 and 1 */
+static double
+random_unit(void)
+{
+  return (double) rand() / RAND_MAX;
+}
+
+/* Coordinates and timestamps of a sequence */
+typedef struct
+{
+  int count;
+  bool hasz;
+  double *x, *y, *z;
+  TimestampTz *t;
+} Coords;
+
+/* Fill the coordinates of a random walk or, if zigzag is true, of a zigzag */
+static void
+coords_make(Coords *c, int n, bool hasz, bool zigzag)
+{
+  c->count = n;
+  c->hasz = hasz;
+  c->x = malloc(sizeof(double) * n);
+  c->y = malloc(sizeof(double) * n);
+  c->z = malloc(sizeof(double) * n);
+  c->t = malloc(sizeof(TimestampTz) * n);
+  double x = 0.0, y = 0.0, z = 0.0;
+  /* 2001-01-01 in microseconds since 2000-01-01 */
+  TimestampTz t = (TimestampTz) 366 * 86400 * 1000000;
+  for (int i = 0; i < n; i++)
+  {
+    if (zigzag)
+    {
+      x = 10.0 * i;
+      y = (i % 2 == 0) ? 0.0 : 20.0;
+      z = (i % 2 == 0) ? 0.0 : 20.0;
+    }
+    /* The point stops at every tenth instant */
+    else if (i > 0 && i % 10 != 0)
+    {
+      x += 10.0 * (random_unit() * 2 - 1);
+      y += 10.0 * (random_unit() * 2 - 1);
+      z += 10.0 * (random_unit() * 2 - 1);
+    }
+    t += (TimestampTz) (1 + rand() % 60) * 1000000;
+    c->x[i] = x; c->y[i] = y; c->z[i] = hasz ? z : 0.0;
+    c->t[i] = t;
+  }
+  return;
+}
+
+static void
+coords_free(Coords *c)
+{
+  free(c->x); free(c->y); free(c->z); free(c->t);
+  return;
+}
+
+/* Return the temporal point sequence of the coordinates */
+static Temporal *
+coords_tpoint(const Coords *c)
+{
+  TInstant **instants = malloc(sizeof(TInstant *) * c->count);
+  for (int i = 0; i < c->count; i++)
+  {
+    GSERIALIZED *gs = c->hasz ?
+      geompoint_make3dz(0, c->x[i], c->y[i], c->z[i]) :
+      geompoint_make2d(0, c->x[i], c->y[i]);
+    instants[i] = tpointinst_make(gs, c->t[i]);
+    free(gs);
+  }
+  Temporal *result = (Temporal *) tsequence_make(instants, c->count, true,
+    true, LINEAR, false);
+  for (int i = 0; i < c->count; i++)
+    free(instants[i]);
+  free(instants);
+  return result;
+}
+
+/* Return the length of the segment ending at the instant i */
+static double
+seglength(const Coords *c, int i)
+{
+  double dx = c->x[i - 1] - c->x[i], dy = c->y[i - 1] - c->y[i];
+  if (! c->hasz)
+    return sqrt(dx * dx + dy * dy);
+  double dz = c->z[i - 1] - c->z[i];
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/* Return the distance between the points of the segment ending at the
+ * instant i as computed by PostGIS */
+static double
+segdist(const Coords *c, int i)
+{
+  if (c->hasz)
+    return seglength(c, i);
+  return hypot(c->x[i] - c->x[i - 1], c->y[i] - c->y[i - 1]);
+}
+
+/* Return the hypotenuse of a 3D vector as computed by MEOS */
+static double
+hypot3(double x, double y, double z)
+{
+  x = fabs(x); y = fabs(y); z = fabs(z);
+  double temp;
+  if (x < y)
+  {
+    temp = x; x = y; y = temp;
+  }
+  if (x < z)
+  {
+    temp = x; x = z; z = temp;
+  }
+  if (x == 0)
+    return hypot(y, z);
+  double yx = y / x, zx = z / x;
+  return x * sqrt(1.0 + (yx * yx) + (zx * zx));
+}
+
+/* Return the distance between the point k and the segment of the points a
+ * and b as computed by PostGIS */
+static double
+dist_pt_seg(const Coords *c, int k, int a, int b)
+{
+  const double *x = c->x, *y = c->y, *z = c->z;
+  double abx = x[b] - x[a], aby = y[b] - y[a], abz = z[b] - z[a];
+  int e = -1;
+  double r = 0.0;
+  if (c->hasz ? (fabs(abx) <= 1e-12 && fabs(aby) <= 1e-12 &&
+      fabs(abz) <= 1e-12) : (abx == 0 && aby == 0))
+    e = a;
+  else
+  {
+    double num = (x[k] - x[a]) * abx + (y[k] - y[a]) * aby;
+    double den = abx * abx + aby * aby;
+    if (c->hasz)
+    {
+      num += (z[k] - z[a]) * abz;
+      den += abz * abz;
+    }
+    r = num / den;
+    if (r < 0)
+      e = a;
+    else if (r > 1)
+      e = b;
+  }
+  double cx = (e >= 0) ? x[e] : x[a] + r * abx;
+  double cy = (e >= 0) ? y[e] : y[a] + r * aby;
+  double cz = (e >= 0) ? z[e] : z[a] + r * abz;
+  return c->hasz ? hypot3(cx - x[k], cy - y[k], cz - z[k]) :
+    hypot(cx - x[k], cy - y[k]);
+}
+
+/* Mark the instants kept by the Douglas-Peucker simplification between the
+ * instants i1 and i2 */
+static void
+simplify_dp(const Coords *c, int i1, int i2, bool *keep)
+{
+  if (i1 + 1 >= i2)
+    return;
+  int split = i1;
+  double d = -1;
+  for (int k = i1 + 1; k < i2; k++)
+  {
+    double dk = dist_pt_seg(c, k, i1, i2);
+    if (dk > d)
+    {
+      d = dk;
+      split = k;
+    }
+  }
+  if (d > SIMPLIFY_DIST)
+  {
+    keep[split] = true;
+    simplify_dp(c, i1, split, keep);
+    simplify_dp(c, split, i2, keep);
+  }
+  return;
+}
+
+/* Check the properties on a sequence */
+static void
+test_coords(const Coords *c, const char *name)
+{
+  char label[128];
+  int n = c->count;
+  Temporal *temp = coords_tpoint(c);
+
+  /* (i), (ii) and (v) Length and cumulative length */
+  Temporal *cumul = tpoint_cumulative_length(temp);
+  double length = 0.0, cumul_length = 0.0;
+  bool cumul_ok = true;
+  for (int i = 0; i < n; i++)
+  {
+    if (i > 0)
+    {
+      length += seglength(c, i);
+      cumul_length += segdist(c, i);
+    }
+    double value;
+    if (! tfloat_value_at_timestamptz(cumul, c->t[i], false, &value) ||
+        value != cumul_length)
+      cumul_ok = false;
+  }
+  snprintf(label, sizeof(label), "%s: length", name);
+  check(label, tpoint_length(temp) == length);
+  snprintf(label, sizeof(label), "%s: cumulative length", name);
+  check(label, cumul_ok);
+  free(cumul);
+
+  /* (iii) and (v) Speed */
+  Temporal *speed = tpoint_speed(temp);
+  bool speed_ok = true;
+  for (int i = 1; i < n; i++)
+  {
+    double expected = segdist(c, i) /
+      ((double) (c->t[i] - c->t[i - 1]) / 1000000);
+    double value;
+    if (! tfloat_value_at_timestamptz(speed, c->t[i - 1], false, &value) ||
+        value != expected)
+      speed_ok = false;
+  }
+  snprintf(label, sizeof(label), "%s: speed", name);
+  check(label, speed_ok);
+  free(speed);
+
+  /* (iv) and (v) Douglas-Peucker simplification */
+  bool *keep = calloc(n, sizeof(bool));
+  keep[0] = keep[n - 1] = true;
+  simplify_dp(c, 0, n - 1, keep);
+  int nkeep = 0;
+  for (int i = 0; i < n; i++)
+    nkeep += keep[i];
+  Temporal *simple = temporal_simplify_dp(temp, SIMPLIFY_DIST, false);
+  bool simple_ok = (temporal_num_instants(simple) == nkeep);
+  for (int i = 0, j = 0; simple_ok && i < n; i++)
+  {
+    if (! keep[i])
+      continue;
+    TInstant *inst = temporal_instant_n(simple, ++j);
+    simple_ok = (inst->t == c->t[i]);
+    free(inst);
+  }
+  snprintf(label, sizeof(label), "%s: simplification (%d of %d kept)", name,
+    nkeep, n);
+  check(label, simple_ok);
+  free(simple);
+  free(keep);
+  free(temp);
+  return;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  srand(1);
+
+  /* Numbers of instants around the multiples of the number of lanes, of the
+   * minimum number of instants for the kernels, and of the chunk size */
+  int counts[] = {3, 9, 31, 32, 33, 255, 256, 257, 511, 1000, 5003};
+  int ncounts = (int) (sizeof(counts) / sizeof(int));
+  char name[64];
+  for (int i = 0; i < ncounts; i++)
+  {
+    for (int kind = 0; kind < 4; kind++)
+    {
+      bool hasz = (kind % 2 == 1), zigzag = (kind >= 2);
+      /* A zigzag has an odd number of points to end at the start side */
+      int n = zigzag ? (counts[i] | 1) : counts[i];
+      Coords c;
+      coords_make(&c, n, hasz, zigzag);
+      snprintf(name, sizeof(name), "%s %s of %d", zigzag ? "zigzag" : "walk",
+        hasz ? "3D" : "2D", n);
+      printf("%s\n", name);
+      test_coords(&c, name);
+      coords_free(&c);
+    }
+  }
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
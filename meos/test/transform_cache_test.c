@@ -0,0 +1,295 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+/**
+ * @file
+ * @brief A program that tests the transformation of temporal points to
+ * another SRID, comparing the transformation of whole sequences with that of
+ * their instants, using a spatial_ref_sys.csv file written by this program.
+ *
+ * Five properties are asserted:
+ *  (i)   sequences: the transformation of a temporal point sequence, with or
+ *        without Z, and of a sequence set is that of each of their instants,
+ *        and the transformation back returns the input coordinates;
+ *  (ii)  inputs: the transformed value is not modified;
+ *  (iii) cache: after transforming to more pairs of SRIDs than the entries
+ *        of the cache, transforming again gives the same values;
+ *  (iv)  threads: the threads transforming concurrently obtain the values
+ *        obtained by the main thread;
+ *  (v)   reload: after setting the location of another file its SRIDs are
+ *        found, and a missing SRID is reported.
+ *
+ * The program requires the PROJ database for the EPSG codes of the file. It
+ * can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o transform_cache_test transform_cache_test.c -L/usr/local/lib -lmeos -lm -lpthread
+ * @endcode
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Number of instants of the sequences */
+#define NUM_INSTS 500
+/* Number of SRIDs the sequences are transformed to */
+#define NUM_SRIDS 5
+/* Number of threads transforming concurrently */
+#define NUM_THREADS 4
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* SRIDs the sequences are transformed to, which are either in the file or
+ * reserved for UTM zones */
+static const int32_t srids[NUM_SRIDS] = {2154, 3857, 999031, 999131, 4326};
+
+/* Write a spatial_ref_sys.csv file with the records of the lines */
+static void
+srs_write(const char *path, const char **lines, int count)
+{
+  FILE *file = fopen(path, "w");
+  fprintf(file, "auth_name,auth_srid,proj4text,srtext\n");
+  for (int i = 0; i < count; i++)
+    fprintf(file, "%s\n", lines[i]);
+  fclose(file);
+  return;
+}
+
+/* Return a sequence of points around Paris, with or without Z */
+static Temporal *
+seq_make(bool hasz)
+{
+  char *str = malloc(NUM_INSTS * 96 + 16);
+  char *pos = str + sprintf(str, "SRID=4326;[");
+  for (int i = 0; i < NUM_INSTS; i++)
+  {
+    double x = 2.2 + 0.3 * sin(i * 0.1), y = 48.8 + 0.2 * cos(i * 0.07);
+    if (hasz)
+      pos += sprintf(pos, "%sPoint(%.6f %.6f %d)@2000-01-01 00:%02d:%02d",
+        i ? "," : "", x, y, i % 100, (i / 60) % 60, i % 60);
+    else
+      pos += sprintf(pos, "%sPoint(%.6f %.6f)@2000-01-01 00:%02d:%02d",
+        i ? "," : "", x, y, (i / 60) % 60, i % 60);
+  }
+  sprintf(pos, "]");
+  Temporal *result = tgeompoint_in(str);
+  free(str);
+  return result;
+}
+
+/* Return true if the transformation of a value is that of its instants */
+static bool
+transform_instants(const Temporal *temp, const Temporal *result)
+{
+  int count = temporal_num_instants(temp);
+  if (! result || temporal_num_instants(result) != count)
+    return false;
+  for (int i = 1; i <= count; i++)
+  {
+    TInstant *inst = temporal_instant_n(temp, i);
+    TInstant *expected = (TInstant *) tspatial_transform((Temporal *) inst,
+      tspatial_srid(result));
+    TInstant *inst1 = temporal_instant_n(result, i);
+    bool ok = expected && temporal_eq((Temporal *) expected,
+      (Temporal *) inst1);
+    free(inst); free(expected); free(inst1);
+    if (! ok)
+      return false;
+  }
+  return true;
+}
+
+/* Sequence transformed by the threads and its transformations by the main
+ * thread */
+static Temporal *shared_seq;
+static Temporal *shared[NUM_SRIDS];
+
+/* Transform the sequence and compare with the main thread */
+static void *
+transform_thread(void *arg)
+{
+  bool *ok = (bool *) arg;
+  *ok = true;
+  for (int k = 0; k < 8 && *ok; k++)
+    for (int j = 0; j < NUM_SRIDS && *ok; j++)
+    {
+      Temporal *result = tspatial_transform(shared_seq, srids[j]);
+      *ok = result && temporal_eq(result, shared[j]);
+      free(result);
+    }
+  meos_finalize_projsrs();
+  return NULL;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+
+  printf("Transformation cache\n");
+  const char *lines1[] = {
+    "EPSG,4326,+proj=longlat +datum=WGS84 +no_defs,"
+      "GEOGCS[\"WGS 84\",DATUM[\"WGS_1984\","
+      "SPHEROID[\"WGS 84\",6378137,298.257223563]],PRIMEM[\"Greenwich\",0],"
+      "UNIT[\"degree\",0.0174532925199433]]",
+    "EPSG,3857,+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +x_0=0 "
+      "+y_0=0 +k=1 +units=m +nadgrids=@null +wktext +no_defs,"
+      "PROJCS[\"WGS 84 / Pseudo-Mercator\"]",
+    "EPSG,2154,+proj=lcc +lat_0=46.5 +lon_0=3 +lat_1=49 +lat_2=44 "
+      "+x_0=700000 +y_0=6600000 +ellps=GRS80 +units=m +no_defs,"
+      "PROJCS[\"RGF93 v1 / Lambert-93\"]",
+  };
+  const char *lines2[] = {
+    lines1[0],
+    "EPSG,5676,+proj=tmerc +lat_0=0 +lon_0=9 +k=1 +x_0=3500000 +y_0=0 "
+      "+ellps=bessel +units=m +no_defs,"
+      "PROJCS[\"DHDN / 3-degree Gauss-Kruger zone 3\"]",
+  };
+  char path1[] = "/tmp/transform_cache_test1_XXXXXX";
+  char path2[] = "/tmp/transform_cache_test2_XXXXXX";
+  close(mkstemp(path1));
+  close(mkstemp(path2));
+  srs_write(path1, lines1, 3);
+  srs_write(path2, lines2, 2);
+  meos_set_spatial_ref_sys_csv(path1);
+
+  /* (i) sequences */
+  Temporal *seq2d = seq_make(false);
+  Temporal *seq3d = seq_make(true);
+  bool ok = true, back = true;
+  for (int j = 0; j < NUM_SRIDS; j++)
+  {
+    Temporal *result2d = tspatial_transform(seq2d, srids[j]);
+    Temporal *result3d = tspatial_transform(seq3d, srids[j]);
+    ok &= transform_instants(seq2d, result2d) &&
+      transform_instants(seq3d, result3d);
+    Temporal *orig = result2d ? tspatial_transform(result2d, 4326) : NULL;
+    back &= orig && tspatial_srid(orig) == 4326 &&
+      temporal_hausdorff_distance(orig, seq2d) < 1e-9;
+    free(result2d); free(result3d); free(orig);
+  }
+  check("sequences transformed as their instants", ok);
+  check("sequences transformed back to their coordinates", back);
+  Temporal *ss = tgeompoint_in("SRID=4326;{[Point(2.35 48.85)@2000-01-01, "
+    "Point(2.36 48.86)@2000-01-02], [Point(2.4 48.9)@2000-01-03]}");
+  Temporal *result = tspatial_transform(ss, 2154);
+  check("sequence sets transformed as their instants",
+    transform_instants(ss, result));
+  free(result);
+
+  /* (ii) inputs */
+  Temporal *copy = temporal_copy(seq2d);
+  result = tspatial_transform(seq2d, 3857);
+  free(result);
+  ok = temporal_eq(copy, seq2d);
+  free(copy);
+  Temporal *geom = tgeometry_in("SRID=4326;[Linestring(2.35 48.85,3 49)"
+    "@2000-01-01, Point(2.36 48.86)@2000-01-02]");
+  copy = temporal_copy(geom);
+  result = tspatial_transform(geom, 3857);
+  ok &= result && temporal_eq(copy, geom);
+  free(result); free(copy); free(geom);
+  check("inputs not modified", ok);
+
+  /* (iii) cache, with the UTM zones north and south in both directions */
+  Temporal *first[240];
+  for (int i = 0; i < 120; i++)
+  {
+    int32_t zone = i < 60 ? 999001 + i : 999101 + i - 60;
+    first[2 * i] = tspatial_transform(ss, zone);
+    first[2 * i + 1] = first[2 * i] ?
+      tspatial_transform(first[2 * i], 4326) : NULL;
+  }
+  ok = true;
+  for (int i = 0; i < 120; i++)
+  {
+    int32_t zone = i < 60 ? 999001 + i : 999101 + i - 60;
+    Temporal *zoned = tspatial_transform(ss, zone);
+    Temporal *orig = zoned ? tspatial_transform(zoned, 4326) : NULL;
+    ok &= zoned && orig && temporal_eq(zoned, first[2 * i]) &&
+      temporal_eq(orig, first[2 * i + 1]);
+    free(zoned); free(orig);
+    free(first[2 * i]); free(first[2 * i + 1]);
+  }
+  check("transformations after evicting cache entries", ok);
+
+  /* (iv) threads */
+  shared_seq = seq3d;
+  for (int j = 0; j < NUM_SRIDS; j++)
+    shared[j] = tspatial_transform(seq3d, srids[j]);
+  pthread_t threads[NUM_THREADS];
+  bool thread_ok[NUM_THREADS];
+  for (int t = 0; t < NUM_THREADS; t++)
+    pthread_create(&threads[t], NULL, transform_thread, &thread_ok[t]);
+  ok = true;
+  for (int t = 0; t < NUM_THREADS; t++)
+  {
+    pthread_join(threads[t], NULL);
+    ok &= thread_ok[t];
+  }
+  check("threads obtain the values of the main thread", ok);
+  for (int j = 0; j < NUM_SRIDS; j++)
+    free(shared[j]);
+
+  /* (v) reload */
+  result = tspatial_transform(ss, 5676);
+  check("error on an SRID missing from the file", ! result &&
+    meos_errno_reset() == MEOS_ERR_INTERNAL_ERROR);
+  meos_set_spatial_ref_sys_csv(path2);
+  result = tspatial_transform(ss, 5676);
+  check("SRID of the new file found", result &&
+    transform_instants(ss, result));
+  free(result);
+
+  remove(path1);
+  remove(path2);
+  free(seq2d); free(seq3d); free(ss);
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,347 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the streaming construction of temporal
+ * sequences keyed by an identifier, which accumulates the instants of many
+ * objects and passes their sequences to a function when they reach the
+ * limits of the stream.
+ *
+ * The instants are random temporal floats of many keys appended in a random
+ * interleaving, each key with increasing timestamps and with values differing
+ * from one instant to the next, so that the step sequences built keep every
+ * instant.
+ *
+ * Five properties are asserted:
+ *  (i)   round trip: the instants of the sequences passed to the function of
+ *        a stream, without the instants repeated at the start of a sequence,
+ *        are the instants appended to each key, and the sequences have at
+ *        most the maximum number of instants of the stream;
+ *  (ii)  budget: the memory of the stream never exceeds its budget after an
+ *        append, and the round trip holds;
+ *  (iii) gaps in time: no sequence has two consecutive instants farther apart
+ *        than the maximum interval of the stream;
+ *  (iv)  gaps in speed: no sequence has two consecutive instants whose speed
+ *        exceeds the maximum speed of the stream;
+ *  (v)   errors: an instant that is not after the last one of its key or of
+ *        another type is refused and leaves the stream usable.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o tsequence_stream_test tsequence_stream_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+
+/* Number of keys */
+#define NUM_KEYS 200
+/* Number of instants per key */
+#define NUM_INSTS 300
+/* Step between two instants of a key, ten seconds */
+#define TIME_STEP ((TimestampTz) 10000000)
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Instants appended to the keys */
+static TimestampTz times[NUM_KEYS][NUM_INSTS];
+static double values[NUM_KEYS][NUM_INSTS];
+
+/* Instants received by the function of the stream, without repetitions */
+static TimestampTz rtimes[NUM_KEYS][NUM_INSTS];
+static double rvalues[NUM_KEYS][NUM_INSTS];
+static int rcount[NUM_KEYS];
+
+/* Limits checked on every sequence received */
+static int max_insts;
+static TimestampTz max_gap;
+static double max_speed;
+static int num_seqs;
+static bool seqs_ok;
+
+/* Function of the stream recording the sequences received */
+static void
+receive(void *arg, int64 key, const TSequence *seq)
+{
+  (void) arg;
+  const Temporal *temp = (const Temporal *) seq;
+  int count = temporal_num_instants(temp);
+  num_seqs++;
+  if (key < 0 || key >= NUM_KEYS || (max_insts > 0 && count > max_insts))
+  {
+    seqs_ok = false;
+    return;
+  }
+  TimestampTz prevt = 0;
+  double prevv = 0.0;
+  for (int i = 1; i <= count; i++)
+  {
+    TimestampTz t;
+    double v;
+    temporal_timestamptz_n(temp, i, &t);
+    tfloat_value_n(temp, i, &v);
+    if (i > 1)
+    {
+      double secs = (double) (t - prevt) / 1e6;
+      if ((max_gap > 0 && t - prevt > max_gap) ||
+          (max_speed > 0.0 && (v > prevv ? v - prevv : prevv - v) / secs >
+            max_speed))
+        seqs_ok = false;
+    }
+    prevt = t;
+    prevv = v;
+    int n = rcount[key];
+    if (n > 0 && t <= rtimes[key][n - 1])
+    {
+      /* An instant kept from the previous sequence of the key */
+      if (t != rtimes[key][n - 1] && (n < 2 || t > rtimes[key][n - 2]))
+        seqs_ok = false;
+      continue;
+    }
+    if (n == NUM_INSTS)
+    {
+      seqs_ok = false;
+      continue;
+    }
+    rtimes[key][n] = t;
+    rvalues[key][n] = v;
+    rcount[key]++;
+  }
+}
+
+/* Generate the instants of the keys, with a gap of @p gap at random places */
+static void
+generate(TimestampTz t0, TimestampTz gap, double jump)
+{
+  for (int k = 0; k < NUM_KEYS; k++)
+  {
+    TimestampTz t = t0 + (TimestampTz) k * 1000;
+    double v = (double) (rand() % 1000);
+    for (int i = 0; i < NUM_INSTS; i++)
+    {
+      t += TIME_STEP;
+      /* Consecutive values differ so that the normalization of the step
+       * sequences keeps every instant */
+      int delta = rand() % 2000 - 1000;
+      v += (double) (delta == 0 ? 1 : delta) / 100.0;
+      if (rand() % 50 == 0)
+      {
+        t += gap;
+        v += jump;
+      }
+      times[k][i] = t;
+      values[k][i] = v;
+    }
+  }
+  memset(rcount, 0, sizeof(rcount));
+  num_seqs = 0;
+  seqs_ok = true;
+}
+
+/* Append the instants of the keys in a random interleaving */
+static bool
+feed(TSeqStream *stream, size_t maxbytes)
+{
+  int next[NUM_KEYS] = {0};
+  int left = NUM_KEYS * NUM_INSTS;
+  bool ok = true;
+  while (left > 0)
+  {
+    int k = rand() % NUM_KEYS;
+    while (next[k] == NUM_INSTS)
+      k = (k + 1) % NUM_KEYS;
+    TInstant *inst = tfloatinst_make(values[k][next[k]], times[k][next[k]]);
+    if (! tseqstream_append(stream, k, inst))
+      ok = false;
+    free(inst);
+    if (maxbytes > 0 && tseqstream_mem_size(stream) > maxbytes)
+      ok = false;
+    next[k]++;
+    left--;
+  }
+  return ok;
+}
+
+/* Return true when the instants received are the ones appended */
+static bool
+round_trip(void)
+{
+  for (int k = 0; k < NUM_KEYS; k++)
+  {
+    if (rcount[k] != NUM_INSTS)
+      return false;
+    for (int i = 0; i < NUM_INSTS; i++)
+    {
+      if (rtimes[k][i] != times[k][i] || rvalues[k][i] != values[k][i])
+        return false;
+    }
+  }
+  return true;
+}
+
+static void
+test_round_trip(TimestampTz t0)
+{
+  generate(t0, 0, 0.0);
+  max_insts = 50; max_gap = 0; max_speed = 0.0;
+  TSeqStream *stream = tseqstream_make(STEP, 0.0, NULL, 0.0, &receive,
+    NULL);
+  tseqstream_set_limits(stream, max_insts, 2, 0);
+  bool fed = feed(stream, 0);
+  int nflushed = tseqstream_flush(stream);
+  check("(i) round trip: instants received are the ones appended",
+    fed && round_trip());
+  check("(i) round trip: sequences within the maximum number of instants",
+    seqs_ok && nflushed == NUM_KEYS && tseqstream_mem_size(stream) == 0);
+  tseqstream_free(stream);
+}
+
+static void
+test_budget(TimestampTz t0)
+{
+  size_t maxbytes = 64 * 1024;
+  generate(t0, 0, 0.0);
+  max_insts = 0; max_gap = 0; max_speed = 0.0;
+  TSeqStream *stream = tseqstream_make(STEP, 0.0, NULL, 0.0, &receive,
+    NULL);
+  tseqstream_set_limits(stream, 0, 1, maxbytes);
+  bool fed = feed(stream, maxbytes);
+  int nreleased = num_seqs;
+  tseqstream_flush(stream);
+  check("(ii) budget: memory within the budget after every append", fed);
+  check("(ii) budget: sequences released before the flush",
+    nreleased > 0 && seqs_ok);
+  check("(ii) budget: instants received are the ones appended", round_trip());
+  tseqstream_free(stream);
+}
+
+static void
+test_gaps(TimestampTz t0)
+{
+  /* Gaps of two hours every fifty instants on average */
+  generate(t0, (TimestampTz) 7200 * 1000000, 0.0);
+  max_insts = 0; max_gap = (TimestampTz) 3600 * 1000000; max_speed = 0.0;
+  Interval *maxt = interval_in("1 hour", -1);
+  TSeqStream *stream = tseqstream_make(STEP, 0.0, maxt, 0.0, &receive,
+    NULL);
+  free(maxt);
+  bool fed = feed(stream, 0);
+  int nsplit = num_seqs;
+  tseqstream_flush(stream);
+  check("(iii) gaps in time: sequences finished at the gaps",
+    fed && nsplit > 0 && seqs_ok);
+  check("(iii) gaps in time: instants received are the ones appended",
+    round_trip());
+  tseqstream_free(stream);
+
+  /* Jumps of the values of a thousand units in ten seconds */
+  generate(t0, 0, 1000.0);
+  max_insts = 0; max_gap = 0; max_speed = 50.0;
+  stream = tseqstream_make(STEP, 0.0, NULL, max_speed, &receive, NULL);
+  fed = feed(stream, 0);
+  nsplit = num_seqs;
+  tseqstream_flush(stream);
+  check("(iv) gaps in speed: sequences finished at the jumps",
+    fed && nsplit > 0 && seqs_ok);
+  check("(iv) gaps in speed: instants received are the ones appended",
+    round_trip());
+  tseqstream_free(stream);
+}
+
+static void
+test_errors(TimestampTz t0)
+{
+  memset(rcount, 0, sizeof(rcount));
+  num_seqs = 0; seqs_ok = true;
+  max_insts = 0; max_gap = 0; max_speed = 0.0;
+  TSeqStream *stream = tseqstream_make(LINEAR, 0.0, NULL, 0.0, &receive,
+    NULL);
+  TInstant *inst1 = tfloatinst_make(1.0, t0);
+  TInstant *inst2 = tfloatinst_make(2.0, t0 + TIME_STEP);
+  TInstant *inst3 = tintinst_make(3, t0 + 2 * TIME_STEP);
+  bool ok = tseqstream_append(stream, 7, inst2);
+  bool refused = ! tseqstream_append(stream, 7, inst1) &&
+    ! tseqstream_append(stream, 7, inst3);
+  ok &= tseqstream_append(stream, 8, inst1) &&
+    tseqstream_append(stream, 8, inst2);
+  check("(v) errors: out-of-order and mistyped instants refused",
+    ok && refused);
+  check("(v) errors: flush of a key", tseqstream_flush_key(stream, 7) &&
+    ! tseqstream_flush_key(stream, 7) && ! tseqstream_flush_key(stream, 9) &&
+    rcount[7] == 1 && rvalues[7][0] == 2.0);
+  check("(v) errors: stream usable after the errors",
+    tseqstream_flush(stream) == 1 && rcount[8] == 2 && seqs_ok &&
+    num_seqs == 2);
+  check("(v) errors: invalid limits refused",
+    ! tseqstream_set_limits(stream, 10, 10, 0) &&
+    ! tseqstream_set_limits(stream, -1, 0, 0));
+  free(inst1); free(inst2); free(inst3);
+  tseqstream_free(stream);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+  TimestampTz t0 = timestamptz_in("2025-01-01 08:00:00", -1);
+
+  for (int round = 0; round < 3; round++)
+  {
+    printf("Round %d\n", round + 1);
+    test_round_trip(t0);
+    test_budget(t0);
+    test_gaps(t0);
+  }
+  test_errors(t0);
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+/**
+ * @file
+ * @brief A program that tests the store of the routes read from a ways CSV
+ * file, comparing its lookups with the records written to the file by this
+ * program.
+ *
+ * The routes are horizontal lines, one every 10 units, some of which have the
+ * identifier of a previous route, an empty geometry, or no geometry.
+ *
+ * Five properties are asserted:
+ *  (i)   lookups: the geometry and the length of each route are those of the
+ *        first record of the file with its identifier, and the routes without
+ *        a record or with an empty geometry do not exist;
+ *  (ii)  bulk lookups: the geometries of an array of routes are those looked
+ *        up one at a time, and a missing route is reported;
+ *  (iii) threads: the threads looking up routes concurrently share the
+ *        geometries of the store;
+ *  (iv)  network points: a point is projected on the nearest route;
+ *  (v)   reload: after setting the location of another file the routes are
+ *        those of the new file, and a missing file is reported.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o ways_store_test ways_store_test.c -L/usr/local/lib -lmeos -lm -lpthread
+ * @endcode
+ */
+
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <meos.h>
+#include <meos_geo.h>
+#include <meos_npoint.h>
+
+/* Number of routes of the file */
+#define NUM_ROUTES 5000
+/* Number of threads looking up routes concurrently */
+#define NUM_THREADS 4
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Geometries of the routes as written to the file, NULL for the routes that
+ * do not exist */
+static GSERIALIZED *routes[NUM_ROUTES];
+
+/* Return the geometry of the route i, whose length depends on shift */
+static GSERIALIZED *
+route_make(int i, int shift)
+{
+  char wkt[128];
+  snprintf(wkt, sizeof(wkt), "SRID=5676;LINESTRING(0 %d,%d %d,%d %d)",
+    10 * i, 5 + (i + shift) % 7, 10 * i, 10 + (i + shift) % 11, 10 * i);
+  return geom_in(wkt, -1);
+}
+
+/* Write a ways CSV file and fill the geometries of its routes */
+static void
+ways_write(const char *path, int shift)
+{
+  FILE *file = fopen(path, "w");
+  GSERIALIZED *empty = geom_in("SRID=5676;LINESTRING EMPTY", -1);
+  char *hexempty = geo_as_hexewkb(empty, "NDR");
+  for (int i = 0; i < NUM_ROUTES; i++)
+  {
+    free(routes[i]);
+    routes[i] = NULL;
+    /* Every 97th route has no geometry and every 89th an empty one */
+    if (i % 97 == 0)
+    {
+      fprintf(file, "%d,\n", i);
+      continue;
+    }
+    if (i % 89 == 0)
+    {
+      fprintf(file, "%d,%s\n", i, hexempty);
+      continue;
+    }
+    routes[i] = route_make(i, shift);
+    char *hex = geo_as_hexewkb(routes[i], "NDR");
+    fprintf(file, "%d,%s\n", i, hex);
+    free(hex);
+    /* Every 13th route is followed by a record with its identifier */
+    if (i % 13 == 0)
+    {
+      GSERIALIZED *dup = route_make(i, shift + 1);
+      hex = geo_as_hexewkb(dup, "NDR");
+      fprintf(file, "%d,%s\n", i, hex);
+      free(hex); free(dup);
+    }
+  }
+  fclose(file);
+  free(hexempty); free(empty);
+  return;
+}
+
+/* Return true if the lookups of all routes agree with the file */
+static bool
+lookups_equal(void)
+{
+  for (int i = -1; i <= NUM_ROUTES; i++)
+  {
+    const GSERIALIZED *expected = (i >= 0 && i < NUM_ROUTES) ? routes[i] :
+      NULL;
+    const GSERIALIZED *gs = route_geom(i);
+    if (! expected)
+    {
+      if (gs || route_exists(i) || route_length(i) != DBL_MAX)
+        return false;
+      continue;
+    }
+    if (! gs || ! route_exists(i) || ! geo_same(gs, expected) ||
+        route_length(i) != geom_length(expected))
+      return false;
+  }
+  return true;
+}
+
+/* Geometries looked up by the main thread, compared by the other ones */
+static const GSERIALIZED *shared[NUM_ROUTES];
+
+/* Look up all routes and compare them with those of the main thread */
+static void *
+lookup_thread(void *arg)
+{
+  bool *ok = (bool *) arg;
+  *ok = true;
+  for (int k = 0; k < 4 && *ok; k++)
+    for (int i = 0; i < NUM_ROUTES && *ok; i++)
+      *ok = route_geom(i) == shared[i];
+  meos_finalize_ways();
+  return NULL;
+}
+
+/* Check the projection of points on the nearest route */
+static bool
+npoints_nearest(void)
+{
+  for (int i = 1; i < NUM_ROUTES; i += 7)
+  {
+    if (! routes[i])
+      continue;
+    /* A point of the route and a point 3 units above it */
+    double fraction = (double) (i % 10) / 10;
+    GSERIALIZED *on = line_interpolate_point(routes[i], fraction, false);
+    char wkt[64];
+    snprintf(wkt, sizeof(wkt), "SRID=5676;POINT(2 %d)", 10 * i + 3);
+    GSERIALIZED *above = geom_in(wkt, -1);
+    Npoint *np1 = geompoint_to_npoint(on);
+    Npoint *np2 = geompoint_to_npoint(above);
+    bool ok = np1 && np2 && npoint_route(np1) == i &&
+      fabs(npoint_position(np1) - fraction) < 1e-9 &&
+      npoint_route(np2) == i &&
+      npoint_position(np2) == line_locate_point(routes[i], above);
+    free(on); free(above); free(np1); free(np2);
+    if (! ok)
+      return false;
+  }
+  return true;
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+
+  printf("Ways store\n");
+  char path1[] = "/tmp/ways_store_test1_XXXXXX";
+  char path2[] = "/tmp/ways_store_test2_XXXXXX";
+  close(mkstemp(path1));
+  close(mkstemp(path2));
+  ways_write(path1, 0);
+  meos_set_ways_csv(path1);
+
+  /* (i) lookups */
+  check("lookups agree with the file", lookups_equal());
+  check("SRID of the ways", get_srid_ways() == 5676);
+
+  /* (ii) bulk lookups */
+  int64 rids[NUM_ROUTES];
+  const GSERIALIZED *geoms[NUM_ROUTES];
+  int count = 0;
+  for (int i = 0; i < NUM_ROUTES; i++)
+  {
+    if (routes[i])
+      rids[count++] = (i * 7919) % NUM_ROUTES;
+    shared[i] = route_geom(i);
+  }
+  for (int i = 0; i < count; i++)
+  {
+    while (! routes[rids[i]])
+      rids[i] = (rids[i] + 1) % NUM_ROUTES;
+  }
+  bool ok = routes_geom(rids, count, geoms);
+  for (int i = 0; i < count && ok; i++)
+    ok = geoms[i] == route_geom(rids[i]);
+  check("bulk lookups equal single lookups", ok);
+  rids[count / 2] = NUM_ROUTES;
+  check("error on a missing route in a bulk lookup",
+    ! routes_geom(rids, count, geoms) &&
+    meos_errno_reset() == MEOS_ERR_INVALID_ARG_VALUE);
+
+  /* (iii) threads */
+  pthread_t threads[NUM_THREADS];
+  bool thread_ok[NUM_THREADS];
+  for (int t = 0; t < NUM_THREADS; t++)
+    pthread_create(&threads[t], NULL, lookup_thread, &thread_ok[t]);
+  ok = true;
+  for (int t = 0; t < NUM_THREADS; t++)
+  {
+    pthread_join(threads[t], NULL);
+    ok &= thread_ok[t];
+  }
+  check("threads share the geometries of the store", ok);
+  check("lookups after the threads finalize", lookups_equal());
+
+  /* (iv) network points */
+  check("points projected on the nearest route", npoints_nearest());
+
+  /* (v) reload */
+  ways_write(path2, 3);
+  meos_set_ways_csv(path2);
+  check("lookups agree with the new file", lookups_equal());
+  meos_finalize_ways();
+  check("lookups after finalizing the store", lookups_equal());
+  meos_set_ways_csv("/nonexistent/ways.csv");
+  check("error on a missing file", ! route_exists(1) &&
+    meos_errno_reset() == MEOS_ERR_INTERNAL_TYPE_ERROR);
+
+  remove(path1);
+  remove(path2);
+  for (int i = 0; i < NUM_ROUTES; i++)
+    free(routes[i]);
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A program that tests the Well-Known Binary (WKB) representation of
+ * temporal points, whose points are written and read without building PostGIS
+ * geometries.
+ *
+ * The values are random temporal geometry and geography points in 2D and 3D,
+ * with and without SRID, of every subtype.
+ *
+ * Five properties are asserted:
+ *  (i)   round trip: a value read from its WKB is equal to the value for the
+ *        little-endian, big-endian, extended, ISO, and hexadecimal variants,
+ *        the variants that are not extended being only used for values
+ *        without SRID;
+ *  (ii)  points: in the extended WKB of a sequence the bytes of every point
+ *        are those of the extended WKB of the point written by PostGIS;
+ *  (iii) byte order: a sequence whose points are written with a byte order
+ *        different from the one of the sequence is read correctly;
+ *  (iv)  fallback: a sequence with a point that has another SRID than the
+ *        sequence is read by the general reader, which refuses it, and a
+ *        temporal geometry with points and polygons round trips;
+ *  (v)   size: the size of the WKB is the number of bytes written.
+ *
+ * The program can be built as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o wkb_point_test wkb_point_test.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+#include <meos_geo.h>
+
+/* Maximum number of instants of a sequence */
+#define MAX_INSTANTS 200
+/* WKB variants, as in PostGIS */
+#define VARIANT_ISO 0x01
+#define VARIANT_EXTENDED 0x04
+#define VARIANT_NDR 0x08
+#define VARIANT_XDR 0x10
+#define VARIANT_HEX 0x20
+
+static int failures = 0;
+
+static void
+check(const char *name, bool ok)
+{
+  printf("  %-58s %s\n", name, ok ? "OK" : "FAIL");
+  if (! ok)
+    failures++;
+}
+
+/* Append the text of a random instant to a buffer */
+static int
+print_instant(char *buf, bool hasz, int i)
+{
+  double x = (double) (rand() % 360000) / 1000.0 - 180.0;
+  double y = (double) (rand() % 180000) / 1000.0 - 90.0;
+  if (hasz)
+    return sprintf(buf, "Point(%.3f %.3f %.3f)@2025-01-01 %02d:%02d:%02d",
+      x, y, (double) (rand() % 10000) / 10.0, i / 3600, (i / 60) % 60, i % 60);
+  return sprintf(buf, "Point(%.3f %.3f)@2025-01-01 %02d:%02d:%02d", x, y,
+    i / 3600, (i / 60) % 60, i % 60);
+}
+
+/* Return a random temporal point of a subtype, 0 for an instant, 1 for a
+ * sequence, and 2 for a sequence set */
+static Temporal *
+random_tpoint(bool geodetic, bool hasz, int srid, int subtype)
+{
+  static char buf[MAX_INSTANTS * 96 + 64];
+  char *p = buf;
+  if (srid)
+    p += sprintf(p, "SRID=%d;", srid);
+  int count = 1 + rand() % MAX_INSTANTS;
+  if (subtype == 0)
+    print_instant(p, hasz, rand() % 3600);
+  else
+  {
+    p += sprintf(p, subtype == 1 ? "[" : "{[");
+    for (int i = 0; i < count; i++)
+    {
+      if (subtype == 2 && i > 0 && rand() % 20 == 0)
+        p += sprintf(p, "], [");
+      else if (i > 0)
+        p += sprintf(p, ", ");
+      p += print_instant(p, hasz, i * 7);
+    }
+    sprintf(p, subtype == 1 ? "]" : "]}");
+  }
+  return geodetic ? tgeogpoint_in(buf) : tgeompoint_in(buf);
+}
+
+/* Return true when a value is equal to the one read from its WKB */
+static bool
+round_trip(const Temporal *temp, uint8_t variant)
+{
+  Temporal *res;
+  size_t size;
+  if (variant & VARIANT_HEX)
+  {
+    char *hex = temporal_as_hexwkb(temp, variant & ~VARIANT_HEX, &size);
+    res = temporal_from_hexwkb(hex);
+    free(hex);
+  }
+  else
+  {
+    uint8_t *wkb = temporal_as_wkb(temp, variant, &size);
+    res = temporal_from_wkb(wkb, size);
+    free(wkb);
+  }
+  bool result = res && temporal_eq(temp, res);
+  free(res);
+  return result;
+}
+
+/* Return the offset of the first instant in the WKB of a sequence */
+static size_t
+seq_header_size(const uint8_t *wkb)
+{
+  /* Endian + temporal type + flags + SRID if any + count + bounds */
+  return 1 + 2 + 1 + ((wkb[3] & 0x40) ? 4 : 0) + 4 + 1;
+}
+
+/* Return true when the points in the extended WKB of a sequence are written
+ * as PostGIS writes them */
+static bool
+points_as_postgis(const Temporal *seq, bool ndr)
+{
+  size_t size;
+  uint8_t *wkb = temporal_as_wkb(seq, VARIANT_EXTENDED |
+    (ndr ? VARIANT_NDR : VARIANT_XDR), &size);
+  size_t pos = seq_header_size(wkb);
+  bool result = true;
+  int count = temporal_num_instants(seq);
+  for (int i = 1; i <= count && result; i++)
+  {
+    GSERIALIZED *gs;
+    tgeo_value_n(seq, i, &gs);
+    size_t gsize;
+    uint8_t *ewkb = geo_as_ewkb(gs, ndr ? "NDR" : "XDR", &gsize);
+    if (pos + gsize + 8 > size || memcmp(wkb + pos, ewkb, gsize) != 0)
+      result = false;
+    pos += gsize + 8;
+    free(ewkb); free(gs);
+  }
+  if (pos != size)
+    result = false;
+  free(wkb);
+  return result;
+}
+
+/* Reverse the byte order of the points of the little-endian extended WKB of a
+ * 2D sequence without SRID */
+static void
+swap_points(uint8_t *wkb, int count)
+{
+  size_t pos = seq_header_size(wkb);
+  for (int i = 0; i < count; i++)
+  {
+    uint8_t *pt = wkb + pos;
+    pt[0] = 0;
+    for (int k = 0; k < 3; k++)
+    {
+      uint8_t *v = pt + 1 + (k == 0 ? 0 : 4 + (k - 1) * 8);
+      int n = (k == 0) ? 4 : 8;
+      for (int j = 0; j < n / 2; j++)
+      {
+        uint8_t b = v[j];
+        v[j] = v[n - 1 - j];
+        v[n - 1 - j] = b;
+      }
+    }
+    pos += 1 + 4 + 16 + 8;
+  }
+}
+
+static void
+test_round_trip(void)
+{
+  static const uint8_t variants[] = {
+    VARIANT_NDR, VARIANT_XDR, VARIANT_NDR | VARIANT_EXTENDED,
+    VARIANT_XDR | VARIANT_EXTENDED, VARIANT_NDR | VARIANT_ISO,
+    VARIANT_NDR | VARIANT_EXTENDED | VARIANT_HEX,
+    VARIANT_XDR | VARIANT_EXTENDED | VARIANT_HEX };
+  bool rt = true, pts = true, sizes = true;
+  for (int geodetic = 0; geodetic < 2; geodetic++)
+  for (int hasz = 0; hasz < 2; hasz++)
+  for (int withsrid = 0; withsrid < 2; withsrid++)
+  for (int subtype = 0; subtype < 3; subtype++)
+  {
+    int srid = withsrid ? (geodetic ? 4326 : 3812) : 0;
+    Temporal *temp = random_tpoint(geodetic, hasz, srid, subtype);
+    if (! temp)
+    {
+      rt = false;
+      continue;
+    }
+    for (size_t v = 0; v < sizeof(variants); v++)
+    {
+      /* The WKB that is not extended has no SRID */
+      if ((variants[v] & VARIANT_EXTENDED) || geodetic || ! withsrid)
+        rt &= round_trip(temp, variants[v]);
+    }
+    if (subtype == 1)
+      pts &= points_as_postgis(temp, true) && points_as_postgis(temp, false);
+    size_t size, hexsize;
+    uint8_t *wkb = temporal_as_wkb(temp, VARIANT_EXTENDED, &size);
+    char *hex = temporal_as_hexwkb(temp, VARIANT_EXTENDED, &hexsize);
+    sizes &= (hexsize == 2 * size + 1 && strlen(hex) == 2 * size);
+    free(wkb); free(hex);
+    free(temp);
+  }
+  check("(i) round trip: all variants", rt);
+  check("(ii) points: bytes of the points written by PostGIS", pts);
+  check("(v) size: size of the WKB is the number of bytes written", sizes);
+}
+
+static void
+test_byte_order(void)
+{
+  Temporal *seq = random_tpoint(false, false, 0, 1);
+  int count = temporal_num_instants(seq);
+  size_t size;
+  uint8_t *wkb = temporal_as_wkb(seq, VARIANT_NDR | VARIANT_EXTENDED, &size);
+  swap_points(wkb, count);
+  Temporal *res = temporal_from_wkb(wkb, size);
+  check("(iii) byte order: big-endian points in a little-endian sequence",
+    res && temporal_eq(seq, res));
+  free(res); free(wkb); free(seq);
+}
+
+static void
+test_fallback(void)
+{
+  /* A point with another SRID than the one of the sequence */
+  Temporal *seq = tgeompoint_in("SRID=3812;[Point(1 1)@2025-01-01, "
+    "Point(2 2)@2025-01-02, Point(3 3)@2025-01-03]");
+  size_t size;
+  uint8_t *wkb = temporal_as_wkb(seq, VARIANT_NDR | VARIANT_EXTENDED, &size);
+  size_t pos = seq_header_size(wkb) + 1 + 4 + 4 + 16 + 8;
+  int srid = 5676;
+  memcpy(wkb + pos + 1 + 4, &srid, 4);
+  Temporal *res = temporal_from_wkb(wkb, size);
+  check("(iv) fallback: point with another SRID refused", res == NULL);
+  free(res); free(wkb); free(seq);
+
+  /* The points and the polygons of a temporal geometry are written by the
+   * fast path and by PostGIS respectively, and read by the general reader */
+  Temporal *tgeo = tgeometry_in("SRID=3812;{[Point(1 1 1)@2025-01-01, "
+    "Point(2 2 2)@2025-01-02], [Polygon((0 0 0,1 0 0,1 1 0,0 0 0))@2025-01-03,"
+    " Point(3 3 3)@2025-01-04]}");
+  check("(iv) fallback: temporal geometry with points and polygons",
+    tgeo && round_trip(tgeo, VARIANT_NDR | VARIANT_EXTENDED) &&
+    round_trip(tgeo, VARIANT_XDR | VARIANT_EXTENDED | VARIANT_HEX));
+  free(tgeo);
+}
+
+int
+main(void)
+{
+  meos_initialize();
+  meos_initialize_timezone("UTC");
+  meos_initialize_noexit_error_handler();
+  /* A fixed seed keeps the test deterministic across runs */
+  srand(1);
+
+  for (int round = 0; round < 5; round++)
+  {
+    printf("Round %d\n", round + 1);
+    test_round_trip();
+    test_byte_order();
+  }
+  test_fallback();
+
+  meos_finalize();
+  if (failures)
+  {
+    printf("%d test(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All tests passed\n");
+  return EXIT_SUCCESS;
+}
@@ -87,6 +87,10 @@ extern Datum Tdwithin_tspatial_geo(FunctionCallInfo fcinfo,
 extern Datum Tdwithin_tspatial_tspatial(FunctionCallInfo fcinfo,
   Temporal * (*func)(const Temporal *, const Temporal *, double));
 
+/* The following function is defined in tspatial_gist.c and also called by
+ * tspatial_brin.c */
+extern double stbox_penalty(void *bbox1, void *bbox2);
+
 /*****************************************************************************/
 
 #endif /* __PG_TSPATIAL_H__ */
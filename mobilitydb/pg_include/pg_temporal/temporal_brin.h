@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief BRIN index for span, temporal and spatiotemporal types
+ */
+
+#ifndef __PG_TEMPORAL_BRIN_H__
+#define __PG_TEMPORAL_BRIN_H__
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <fmgr.h>
+#include <access/stratnum.h>
+/* MEOS */
+#include <meos.h>
+#include "temporal/temporal.h"
+
+/*****************************************************************************/
+
+/**
+ * Structure keeping the functions that manipulate the bounding boxes kept by
+ * a BRIN index
+ */
+typedef struct
+{
+  size_t bboxsize;       /**< Size of the bounding box */
+  /** Set the bounding box of a value of the indexed column */
+  void (*value_bbox)(Datum, MeosType, void *);
+  /** Set the bounding box of a query argument */
+  void (*query_bbox)(Datum, MeosType, void *);
+  /** Expand the second bounding box with the first one */
+  void (*bbox_expand)(const void *, void *);
+  /** Determine whether a box may enclose values satisfying a query */
+  bool (*bbox_consistent)(const void *, const void *, StrategyNumber);
+  /** Amount by which the first box grows to include the second one */
+  double (*bbox_penalty)(const void *, const void *);
+} BboxBrinMethods;
+
+/* The following functions are also called by tspatial_brin.c */
+extern Datum bbox_brin_add_value(FunctionCallInfo fcinfo,
+  const BboxBrinMethods *methods);
+extern Datum bbox_brin_consistent(FunctionCallInfo fcinfo,
+  const BboxBrinMethods *methods);
+extern Datum bbox_brin_union(FunctionCallInfo fcinfo,
+  const BboxBrinMethods *methods);
+
+/*****************************************************************************/
+
+#endif /* __PG_TEMPORAL_BRIN_H__ */
@@ -39,6 +39,7 @@
 #include <fmgr.h>
 #include <access/gist.h>
 #include <access/stratnum.h>
+#include <utils/sortsupport.h>
 /* MEOS */
 #include <meos.h>
 #include "temporal/temporal.h"
@@ -79,6 +80,11 @@ extern void bbox_gist_consider_split(ConsiderSplitContext *context, int dimNum,
 extern Datum bbox_gist_picksplit(FunctionCallInfo fcinfo, MeosType bboxtype,
   void (*bbox_adjust)(void *, void *), double (*bbox_penalty)(void *, void *));
 
+/* The following functions are also called by span_gist.c and tpoint_gist.c */
+extern uint64 bbox_gist_hilbert_key(const double *coords, int ndims);
+extern void bbox_gist_sortsupport(SortSupport ssup,
+  uint64 (*bbox_key)(Datum));
+
 /* The following functions are also called by tnumber_spgist.c */
 extern bool tbox_index_leaf_consistent(const TBox *key, const TBox *query,
   StrategyNumber strategy);
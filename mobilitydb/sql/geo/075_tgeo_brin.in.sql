@@ -0,0 +1,307 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN inclusion and multi-inclusion indexes for temporal
+ * geometries/geographies
+ */
+
+CREATE FUNCTION stbox_brin_add_value(internal, internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Stbox_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_brin_consistent(internal, internal, internal, int4)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Stbox_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_brin_union(internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Stbox_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tgeometry_inclusion_ops
+  DEFAULT FOR TYPE tgeometry USING brin AS
+  STORAGE stbox,
+  -- strictly left
+  OPERATOR  1    << (tgeometry, stbox),
+  OPERATOR  1    << (tgeometry, tgeometry),
+  -- overlaps or left
+  OPERATOR  2    &< (tgeometry, stbox),
+  OPERATOR  2    &< (tgeometry, tgeometry),
+  -- overlaps
+  OPERATOR  3    && (tgeometry, tstzspan),
+  OPERATOR  3    && (tgeometry, stbox),
+  OPERATOR  3    && (tgeometry, tgeometry),
+  -- overlaps or right
+  OPERATOR  4    &> (tgeometry, stbox),
+  OPERATOR  4    &> (tgeometry, tgeometry),
+    -- strictly right
+  OPERATOR  5    >> (tgeometry, stbox),
+  OPERATOR  5    >> (tgeometry, tgeometry),
+    -- same
+  OPERATOR  6    ~= (tgeometry, tstzspan),
+  OPERATOR  6    ~= (tgeometry, stbox),
+  OPERATOR  6    ~= (tgeometry, tgeometry),
+  -- contains
+  OPERATOR  7    @> (tgeometry, tstzspan),
+  OPERATOR  7    @> (tgeometry, stbox),
+  OPERATOR  7    @> (tgeometry, tgeometry),
+  -- contained by
+  OPERATOR  8    <@ (tgeometry, tstzspan),
+  OPERATOR  8    <@ (tgeometry, stbox),
+  OPERATOR  8    <@ (tgeometry, tgeometry),
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeometry, stbox),
+  OPERATOR  9    &<| (tgeometry, tgeometry),
+  -- strictly below
+  OPERATOR  10    <<| (tgeometry, stbox),
+  OPERATOR  10    <<| (tgeometry, tgeometry),
+  -- strictly above
+  OPERATOR  11    |>> (tgeometry, stbox),
+  OPERATOR  11    |>> (tgeometry, tgeometry),
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeometry, stbox),
+  OPERATOR  12    |&> (tgeometry, tgeometry),
+  -- adjacent
+  OPERATOR  17    -|- (tgeometry, tstzspan),
+  OPERATOR  17    -|- (tgeometry, stbox),
+  OPERATOR  17    -|- (tgeometry, tgeometry),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeometry, tstzspan),
+  OPERATOR  28    &<# (tgeometry, stbox),
+  OPERATOR  28    &<# (tgeometry, tgeometry),
+  -- strictly before
+  OPERATOR  29    <<# (tgeometry, tstzspan),
+  OPERATOR  29    <<# (tgeometry, stbox),
+  OPERATOR  29    <<# (tgeometry, tgeometry),
+  -- strictly after
+  OPERATOR  30    #>> (tgeometry, tstzspan),
+  OPERATOR  30    #>> (tgeometry, stbox),
+  OPERATOR  30    #>> (tgeometry, tgeometry),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeometry, tstzspan),
+  OPERATOR  31    #&> (tgeometry, stbox),
+  OPERATOR  31    #&> (tgeometry, tgeometry),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeometry, stbox),
+  OPERATOR  32    &</ (tgeometry, tgeometry),
+  -- strictly front
+  OPERATOR  33    <</ (tgeometry, stbox),
+  OPERATOR  33    <</ (tgeometry, tgeometry),
+  -- strictly back
+  OPERATOR  34    />> (tgeometry, stbox),
+  OPERATOR  34    />> (tgeometry, tgeometry),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeometry, stbox),
+  OPERATOR  35    /&> (tgeometry, tgeometry),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tgeometry_inclusion_multi_ops
+  FOR TYPE tgeometry USING brin AS
+  STORAGE stbox,
+  -- strictly left
+  OPERATOR  1    << (tgeometry, stbox),
+  OPERATOR  1    << (tgeometry, tgeometry),
+  -- overlaps or left
+  OPERATOR  2    &< (tgeometry, stbox),
+  OPERATOR  2    &< (tgeometry, tgeometry),
+  -- overlaps
+  OPERATOR  3    && (tgeometry, tstzspan),
+  OPERATOR  3    && (tgeometry, stbox),
+  OPERATOR  3    && (tgeometry, tgeometry),
+  -- overlaps or right
+  OPERATOR  4    &> (tgeometry, stbox),
+  OPERATOR  4    &> (tgeometry, tgeometry),
+    -- strictly right
+  OPERATOR  5    >> (tgeometry, stbox),
+  OPERATOR  5    >> (tgeometry, tgeometry),
+    -- same
+  OPERATOR  6    ~= (tgeometry, tstzspan),
+  OPERATOR  6    ~= (tgeometry, stbox),
+  OPERATOR  6    ~= (tgeometry, tgeometry),
+  -- contains
+  OPERATOR  7    @> (tgeometry, tstzspan),
+  OPERATOR  7    @> (tgeometry, stbox),
+  OPERATOR  7    @> (tgeometry, tgeometry),
+  -- contained by
+  OPERATOR  8    <@ (tgeometry, tstzspan),
+  OPERATOR  8    <@ (tgeometry, stbox),
+  OPERATOR  8    <@ (tgeometry, tgeometry),
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeometry, stbox),
+  OPERATOR  9    &<| (tgeometry, tgeometry),
+  -- strictly below
+  OPERATOR  10    <<| (tgeometry, stbox),
+  OPERATOR  10    <<| (tgeometry, tgeometry),
+  -- strictly above
+  OPERATOR  11    |>> (tgeometry, stbox),
+  OPERATOR  11    |>> (tgeometry, tgeometry),
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeometry, stbox),
+  OPERATOR  12    |&> (tgeometry, tgeometry),
+  -- adjacent
+  OPERATOR  17    -|- (tgeometry, tstzspan),
+  OPERATOR  17    -|- (tgeometry, stbox),
+  OPERATOR  17    -|- (tgeometry, tgeometry),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeometry, tstzspan),
+  OPERATOR  28    &<# (tgeometry, stbox),
+  OPERATOR  28    &<# (tgeometry, tgeometry),
+  -- strictly before
+  OPERATOR  29    <<# (tgeometry, tstzspan),
+  OPERATOR  29    <<# (tgeometry, stbox),
+  OPERATOR  29    <<# (tgeometry, tgeometry),
+  -- strictly after
+  OPERATOR  30    #>> (tgeometry, tstzspan),
+  OPERATOR  30    #>> (tgeometry, stbox),
+  OPERATOR  30    #>> (tgeometry, tgeometry),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeometry, tstzspan),
+  OPERATOR  31    #&> (tgeometry, stbox),
+  OPERATOR  31    #&> (tgeometry, tgeometry),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeometry, stbox),
+  OPERATOR  32    &</ (tgeometry, tgeometry),
+  -- strictly front
+  OPERATOR  33    <</ (tgeometry, stbox),
+  OPERATOR  33    <</ (tgeometry, tgeometry),
+  -- strictly back
+  OPERATOR  34    />> (tgeometry, stbox),
+  OPERATOR  34    />> (tgeometry, tgeometry),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeometry, stbox),
+  OPERATOR  35    /&> (tgeometry, tgeometry),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tgeography_inclusion_ops
+  DEFAULT FOR TYPE tgeography USING brin AS
+  STORAGE stbox,
+  -- overlaps
+  OPERATOR  3    && (tgeography, tstzspan),
+  OPERATOR  3    && (tgeography, stbox),
+  OPERATOR  3    && (tgeography, tgeography),
+    -- same
+  OPERATOR  6    ~= (tgeography, tstzspan),
+  OPERATOR  6    ~= (tgeography, stbox),
+  OPERATOR  6    ~= (tgeography, tgeography),
+  -- contains
+  OPERATOR  7    @> (tgeography, tstzspan),
+  OPERATOR  7    @> (tgeography, stbox),
+  OPERATOR  7    @> (tgeography, tgeography),
+  -- contained by
+  OPERATOR  8    <@ (tgeography, tstzspan),
+  OPERATOR  8    <@ (tgeography, stbox),
+  OPERATOR  8    <@ (tgeography, tgeography),
+  -- adjacent
+  OPERATOR  17    -|- (tgeography, tstzspan),
+  OPERATOR  17    -|- (tgeography, stbox),
+  OPERATOR  17    -|- (tgeography, tgeography),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeography, tstzspan),
+  OPERATOR  28    &<# (tgeography, stbox),
+  OPERATOR  28    &<# (tgeography, tgeography),
+  -- strictly before
+  OPERATOR  29    <<# (tgeography, tstzspan),
+  OPERATOR  29    <<# (tgeography, stbox),
+  OPERATOR  29    <<# (tgeography, tgeography),
+  -- strictly after
+  OPERATOR  30    #>> (tgeography, tstzspan),
+  OPERATOR  30    #>> (tgeography, stbox),
+  OPERATOR  30    #>> (tgeography, tgeography),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeography, tstzspan),
+  OPERATOR  31    #&> (tgeography, stbox),
+  OPERATOR  31    #&> (tgeography, tgeography),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tgeography_inclusion_multi_ops
+  FOR TYPE tgeography USING brin AS
+  STORAGE stbox,
+  -- overlaps
+  OPERATOR  3    && (tgeography, tstzspan),
+  OPERATOR  3    && (tgeography, stbox),
+  OPERATOR  3    && (tgeography, tgeography),
+    -- same
+  OPERATOR  6    ~= (tgeography, tstzspan),
+  OPERATOR  6    ~= (tgeography, stbox),
+  OPERATOR  6    ~= (tgeography, tgeography),
+  -- contains
+  OPERATOR  7    @> (tgeography, tstzspan),
+  OPERATOR  7    @> (tgeography, stbox),
+  OPERATOR  7    @> (tgeography, tgeography),
+  -- contained by
+  OPERATOR  8    <@ (tgeography, tstzspan),
+  OPERATOR  8    <@ (tgeography, stbox),
+  OPERATOR  8    <@ (tgeography, tgeography),
+  -- adjacent
+  OPERATOR  17    -|- (tgeography, tstzspan),
+  OPERATOR  17    -|- (tgeography, stbox),
+  OPERATOR  17    -|- (tgeography, tgeography),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeography, tstzspan),
+  OPERATOR  28    &<# (tgeography, stbox),
+  OPERATOR  28    &<# (tgeography, tgeography),
+  -- strictly before
+  OPERATOR  29    <<# (tgeography, tstzspan),
+  OPERATOR  29    <<# (tgeography, stbox),
+  OPERATOR  29    <<# (tgeography, tgeography),
+  -- strictly after
+  OPERATOR  30    #>> (tgeography, tstzspan),
+  OPERATOR  30    #>> (tgeography, stbox),
+  OPERATOR  30    #>> (tgeography, tgeography),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeography, tstzspan),
+  OPERATOR  31    #&> (tgeography, stbox),
+  OPERATOR  31    #&> (tgeography, tgeography),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  stbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  stbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  stbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
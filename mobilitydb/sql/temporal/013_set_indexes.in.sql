@@ -86,7 +86,8 @@ CREATE OPERATOR CLASS intset_rtree_ops
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(intspan, intspan, internal),
-  FUNCTION  8  span_gist_distance(internal, intset, smallint, oid, internal);
+  FUNCTION  8  span_gist_distance(internal, intset, smallint, oid, internal),
+  FUNCTION  11 span_gist_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -135,7 +136,8 @@ CREATE OPERATOR CLASS bigintset_rtree_ops
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(bigintspan, bigintspan, internal),
-  FUNCTION  8  span_gist_distance(internal, bigintset, smallint, oid, internal);
+  FUNCTION  8  span_gist_distance(internal, bigintset, smallint, oid, internal),
+  FUNCTION  11 span_gist_sortsupport(internal);
 
 /******************************************************************************/
 
@@ -184,7 +186,8 @@ CREATE OPERATOR CLASS floatset_rtree_ops
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(floatspan, floatspan, internal),
-  FUNCTION  8  span_gist_distance(internal, floatset, smallint, oid, internal);
+  FUNCTION  8  span_gist_distance(internal, floatset, smallint, oid, internal),
+  FUNCTION  11 span_gist_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -228,7 +231,8 @@ CREATE OPERATOR CLASS dateset_rtree_ops
   FUNCTION  3  set_gist_compress(internal),
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
-  FUNCTION  7  span_gist_same(datespan, datespan, internal);
+  FUNCTION  7  span_gist_same(datespan, datespan, internal),
+  FUNCTION  11 span_gist_sortsupport(internal);
 
 /*****************************************************************************/
 
@@ -272,7 +276,8 @@ CREATE OPERATOR CLASS tstzset_rtree_ops
   FUNCTION  3  set_gist_compress(internal),
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
-  FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal);
+  FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal),
+  FUNCTION  11 span_gist_sortsupport(internal);
 
 /******************************************************************************
  * Quad-tree SP-GiST indexes
@@ -0,0 +1,1206 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN inclusion and multi-inclusion indexes for span types, temporal
+ * boxes, and temporal types
+ */
+
+/******************************************************************************
+ * Generic functions
+ ******************************************************************************/
+
+CREATE FUNCTION bbox_brin_inclusion_opcinfo(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Bbox_brin_inclusion_opcinfo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION bbox_brin_multi_opcinfo(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Bbox_brin_multi_opcinfo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION bbox_brin_multi_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Bbox_brin_multi_options'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+/******************************************************************************
+ * Span types
+ ******************************************************************************/
+
+CREATE FUNCTION span_brin_add_value(internal, internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Span_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION span_brin_consistent(internal, internal, internal, int4)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Span_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION span_brin_union(internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Span_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS intspan_inclusion_ops
+  DEFAULT FOR TYPE intspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (intspan, integer),
+  OPERATOR  1     << (intspan, intspan),
+  OPERATOR  1     << (intspan, intspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (intspan, integer),
+  OPERATOR  2     &< (intspan, intspan),
+  OPERATOR  2     &< (intspan, intspanset),
+  -- overlaps
+  OPERATOR  3     && (intspan, intspan),
+  OPERATOR  3     && (intspan, intspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (intspan, integer),
+  OPERATOR  4     &> (intspan, intspan),
+  OPERATOR  4     &> (intspan, intspanset),
+  -- strictly right
+  OPERATOR  5     >> (intspan, integer),
+  OPERATOR  5     >> (intspan, intspan),
+  OPERATOR  5     >> (intspan, intspanset),
+  -- contains
+  OPERATOR  7     @> (intspan, integer),
+  OPERATOR  7     @> (intspan, intspan),
+  OPERATOR  7     @> (intspan, intspanset),
+  -- contained by
+  OPERATOR  8     <@ (intspan, intspan),
+  OPERATOR  8     <@ (intspan, intspanset),
+  -- adjacent
+  OPERATOR  17    -|- (intspan, integer),
+  OPERATOR  17    -|- (intspan, intspan),
+  OPERATOR  17    -|- (intspan, intspanset),
+  -- equals
+  OPERATOR  18    = (intspan, intspan),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS intspan_inclusion_multi_ops
+  FOR TYPE intspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (intspan, integer),
+  OPERATOR  1     << (intspan, intspan),
+  OPERATOR  1     << (intspan, intspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (intspan, integer),
+  OPERATOR  2     &< (intspan, intspan),
+  OPERATOR  2     &< (intspan, intspanset),
+  -- overlaps
+  OPERATOR  3     && (intspan, intspan),
+  OPERATOR  3     && (intspan, intspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (intspan, integer),
+  OPERATOR  4     &> (intspan, intspan),
+  OPERATOR  4     &> (intspan, intspanset),
+  -- strictly right
+  OPERATOR  5     >> (intspan, integer),
+  OPERATOR  5     >> (intspan, intspan),
+  OPERATOR  5     >> (intspan, intspanset),
+  -- contains
+  OPERATOR  7     @> (intspan, integer),
+  OPERATOR  7     @> (intspan, intspan),
+  OPERATOR  7     @> (intspan, intspanset),
+  -- contained by
+  OPERATOR  8     <@ (intspan, intspan),
+  OPERATOR  8     <@ (intspan, intspanset),
+  -- adjacent
+  OPERATOR  17    -|- (intspan, integer),
+  OPERATOR  17    -|- (intspan, intspan),
+  OPERATOR  17    -|- (intspan, intspanset),
+  -- equals
+  OPERATOR  18    = (intspan, intspan),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS bigintspan_inclusion_ops
+  DEFAULT FOR TYPE bigintspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (bigintspan, bigint),
+  OPERATOR  1     << (bigintspan, bigintspan),
+  OPERATOR  1     << (bigintspan, bigintspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (bigintspan, bigint),
+  OPERATOR  2     &< (bigintspan, bigintspan),
+  OPERATOR  2     &< (bigintspan, bigintspanset),
+  -- overlaps
+  OPERATOR  3     && (bigintspan, bigintspan),
+  OPERATOR  3     && (bigintspan, bigintspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (bigintspan, bigint),
+  OPERATOR  4     &> (bigintspan, bigintspan),
+  OPERATOR  4     &> (bigintspan, bigintspanset),
+  -- strictly right
+  OPERATOR  5     >> (bigintspan, bigint),
+  OPERATOR  5     >> (bigintspan, bigintspan),
+  OPERATOR  5     >> (bigintspan, bigintspanset),
+  -- contains
+  OPERATOR  7     @> (bigintspan, bigint),
+  OPERATOR  7     @> (bigintspan, bigintspan),
+  OPERATOR  7     @> (bigintspan, bigintspanset),
+  -- contained by
+  OPERATOR  8     <@ (bigintspan, bigintspan),
+  OPERATOR  8     <@ (bigintspan, bigintspanset),
+  -- adjacent
+  OPERATOR  17    -|- (bigintspan, bigint),
+  OPERATOR  17    -|- (bigintspan, bigintspan),
+  OPERATOR  17    -|- (bigintspan, bigintspanset),
+  -- equals
+  OPERATOR  18    = (bigintspan, bigintspan),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS bigintspan_inclusion_multi_ops
+  FOR TYPE bigintspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (bigintspan, bigint),
+  OPERATOR  1     << (bigintspan, bigintspan),
+  OPERATOR  1     << (bigintspan, bigintspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (bigintspan, bigint),
+  OPERATOR  2     &< (bigintspan, bigintspan),
+  OPERATOR  2     &< (bigintspan, bigintspanset),
+  -- overlaps
+  OPERATOR  3     && (bigintspan, bigintspan),
+  OPERATOR  3     && (bigintspan, bigintspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (bigintspan, bigint),
+  OPERATOR  4     &> (bigintspan, bigintspan),
+  OPERATOR  4     &> (bigintspan, bigintspanset),
+  -- strictly right
+  OPERATOR  5     >> (bigintspan, bigint),
+  OPERATOR  5     >> (bigintspan, bigintspan),
+  OPERATOR  5     >> (bigintspan, bigintspanset),
+  -- contains
+  OPERATOR  7     @> (bigintspan, bigint),
+  OPERATOR  7     @> (bigintspan, bigintspan),
+  OPERATOR  7     @> (bigintspan, bigintspanset),
+  -- contained by
+  OPERATOR  8     <@ (bigintspan, bigintspan),
+  OPERATOR  8     <@ (bigintspan, bigintspanset),
+  -- adjacent
+  OPERATOR  17    -|- (bigintspan, bigint),
+  OPERATOR  17    -|- (bigintspan, bigintspan),
+  OPERATOR  17    -|- (bigintspan, bigintspanset),
+  -- equals
+  OPERATOR  18    = (bigintspan, bigintspan),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS floatspan_inclusion_ops
+  DEFAULT FOR TYPE floatspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (floatspan, float),
+  OPERATOR  1     << (floatspan, floatspan),
+  OPERATOR  1     << (floatspan, floatspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (floatspan, float),
+  OPERATOR  2     &< (floatspan, floatspan),
+  OPERATOR  2     &< (floatspan, floatspanset),
+  -- overlaps
+  OPERATOR  3     && (floatspan, floatspan),
+  OPERATOR  3     && (floatspan, floatspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (floatspan, float),
+  OPERATOR  4     &> (floatspan, floatspan),
+  OPERATOR  4     &> (floatspan, floatspanset),
+  -- strictly right
+  OPERATOR  5     >> (floatspan, float),
+  OPERATOR  5     >> (floatspan, floatspan),
+  OPERATOR  5     >> (floatspan, floatspanset),
+  -- contains
+  OPERATOR  7     @> (floatspan, float),
+  OPERATOR  7     @> (floatspan, floatspan),
+  OPERATOR  7     @> (floatspan, floatspanset),
+  -- contained by
+  OPERATOR  8     <@ (floatspan, floatspan),
+  OPERATOR  8     <@ (floatspan, floatspanset),
+  -- adjacent
+  OPERATOR  17    -|- (floatspan, float),
+  OPERATOR  17    -|- (floatspan, floatspan),
+  OPERATOR  17    -|- (floatspan, floatspanset),
+  -- equals
+  OPERATOR  18    = (floatspan, floatspan),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS floatspan_inclusion_multi_ops
+  FOR TYPE floatspan USING brin AS
+  -- strictly left
+  OPERATOR  1     << (floatspan, float),
+  OPERATOR  1     << (floatspan, floatspan),
+  OPERATOR  1     << (floatspan, floatspanset),
+  -- overlaps or left
+  OPERATOR  2     &< (floatspan, float),
+  OPERATOR  2     &< (floatspan, floatspan),
+  OPERATOR  2     &< (floatspan, floatspanset),
+  -- overlaps
+  OPERATOR  3     && (floatspan, floatspan),
+  OPERATOR  3     && (floatspan, floatspanset),
+  -- overlaps or right
+  OPERATOR  4     &> (floatspan, float),
+  OPERATOR  4     &> (floatspan, floatspan),
+  OPERATOR  4     &> (floatspan, floatspanset),
+  -- strictly right
+  OPERATOR  5     >> (floatspan, float),
+  OPERATOR  5     >> (floatspan, floatspan),
+  OPERATOR  5     >> (floatspan, floatspanset),
+  -- contains
+  OPERATOR  7     @> (floatspan, float),
+  OPERATOR  7     @> (floatspan, floatspan),
+  OPERATOR  7     @> (floatspan, floatspanset),
+  -- contained by
+  OPERATOR  8     <@ (floatspan, floatspan),
+  OPERATOR  8     <@ (floatspan, floatspanset),
+  -- adjacent
+  OPERATOR  17    -|- (floatspan, float),
+  OPERATOR  17    -|- (floatspan, floatspan),
+  OPERATOR  17    -|- (floatspan, floatspanset),
+  -- equals
+  OPERATOR  18    = (floatspan, floatspan),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS datespan_inclusion_ops
+  DEFAULT FOR TYPE datespan USING brin AS
+  -- strictly left
+  OPERATOR  1     <<# (datespan, date),
+  OPERATOR  1     <<# (datespan, datespan),
+  OPERATOR  1     <<# (datespan, datespanset),
+  -- overlaps or left
+  OPERATOR  2     &<# (datespan, date),
+  OPERATOR  2     &<# (datespan, datespan),
+  OPERATOR  2     &<# (datespan, datespanset),
+  -- overlaps
+  OPERATOR  3     && (datespan, datespan),
+  OPERATOR  3     && (datespan, datespanset),
+  -- overlaps or right
+  OPERATOR  4     #&> (datespan, date),
+  OPERATOR  4     #&> (datespan, datespan),
+  OPERATOR  4     #&> (datespan, datespanset),
+  -- strictly right
+  OPERATOR  5     #>> (datespan, date),
+  OPERATOR  5     #>> (datespan, datespan),
+  OPERATOR  5     #>> (datespan, datespanset),
+  -- contains
+  OPERATOR  7     @> (datespan, date),
+  OPERATOR  7     @> (datespan, datespan),
+  OPERATOR  7     @> (datespan, datespanset),
+  -- contained by
+  OPERATOR  8     <@ (datespan, datespan),
+  OPERATOR  8     <@ (datespan, datespanset),
+  -- adjacent
+  OPERATOR  17    -|- (datespan, date),
+  OPERATOR  17    -|- (datespan, datespan),
+  OPERATOR  17    -|- (datespan, datespanset),
+  -- equals
+  OPERATOR  18    = (datespan, datespan),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS datespan_inclusion_multi_ops
+  FOR TYPE datespan USING brin AS
+  -- strictly left
+  OPERATOR  1     <<# (datespan, date),
+  OPERATOR  1     <<# (datespan, datespan),
+  OPERATOR  1     <<# (datespan, datespanset),
+  -- overlaps or left
+  OPERATOR  2     &<# (datespan, date),
+  OPERATOR  2     &<# (datespan, datespan),
+  OPERATOR  2     &<# (datespan, datespanset),
+  -- overlaps
+  OPERATOR  3     && (datespan, datespan),
+  OPERATOR  3     && (datespan, datespanset),
+  -- overlaps or right
+  OPERATOR  4     #&> (datespan, date),
+  OPERATOR  4     #&> (datespan, datespan),
+  OPERATOR  4     #&> (datespan, datespanset),
+  -- strictly right
+  OPERATOR  5     #>> (datespan, date),
+  OPERATOR  5     #>> (datespan, datespan),
+  OPERATOR  5     #>> (datespan, datespanset),
+  -- contains
+  OPERATOR  7     @> (datespan, date),
+  OPERATOR  7     @> (datespan, datespan),
+  OPERATOR  7     @> (datespan, datespanset),
+  -- contained by
+  OPERATOR  8     <@ (datespan, datespan),
+  OPERATOR  8     <@ (datespan, datespanset),
+  -- adjacent
+  OPERATOR  17    -|- (datespan, date),
+  OPERATOR  17    -|- (datespan, datespan),
+  OPERATOR  17    -|- (datespan, datespanset),
+  -- equals
+  OPERATOR  18    = (datespan, datespan),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tstzspan_inclusion_ops
+  DEFAULT FOR TYPE tstzspan USING brin AS
+  -- overlaps
+  OPERATOR  3    && (tstzspan, tstzspan),
+  OPERATOR  3    && (tstzspan, tstzspanset),
+  -- contains
+  OPERATOR  7    @> (tstzspan, timestamptz),
+  OPERATOR  7    @> (tstzspan, tstzspan),
+  OPERATOR  7    @> (tstzspan, tstzspanset),
+  -- contained by
+  OPERATOR  8    <@ (tstzspan, tstzspan),
+  OPERATOR  8    <@ (tstzspan, tstzspanset),
+  -- adjacent
+  OPERATOR  17    -|- (tstzspan, timestamptz),
+  OPERATOR  17    -|- (tstzspan, tstzspan),
+  OPERATOR  17    -|- (tstzspan, tstzspanset),
+  -- equals
+  OPERATOR  18    = (tstzspan, tstzspan),
+  -- overlaps or before
+  OPERATOR  28    &<# (tstzspan, timestamptz),
+  OPERATOR  28    &<# (tstzspan, tstzspan),
+  OPERATOR  28    &<# (tstzspan, tstzspanset),
+  -- strictly before
+  OPERATOR  29    <<# (tstzspan, timestamptz),
+  OPERATOR  29    <<# (tstzspan, tstzspan),
+  OPERATOR  29    <<# (tstzspan, tstzspanset),
+  -- strictly after
+  OPERATOR  30    #>> (tstzspan, timestamptz),
+  OPERATOR  30    #>> (tstzspan, tstzspan),
+  OPERATOR  30    #>> (tstzspan, tstzspanset),
+  -- overlaps or after
+  OPERATOR  31    #&> (tstzspan, timestamptz),
+  OPERATOR  31    #&> (tstzspan, tstzspan),
+  OPERATOR  31    #&> (tstzspan, tstzspanset),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tstzspan_inclusion_multi_ops
+  FOR TYPE tstzspan USING brin AS
+  -- overlaps
+  OPERATOR  3    && (tstzspan, tstzspan),
+  OPERATOR  3    && (tstzspan, tstzspanset),
+  -- contains
+  OPERATOR  7    @> (tstzspan, timestamptz),
+  OPERATOR  7    @> (tstzspan, tstzspan),
+  OPERATOR  7    @> (tstzspan, tstzspanset),
+  -- contained by
+  OPERATOR  8    <@ (tstzspan, tstzspan),
+  OPERATOR  8    <@ (tstzspan, tstzspanset),
+  -- adjacent
+  OPERATOR  17    -|- (tstzspan, timestamptz),
+  OPERATOR  17    -|- (tstzspan, tstzspan),
+  OPERATOR  17    -|- (tstzspan, tstzspanset),
+  -- equals
+  OPERATOR  18    = (tstzspan, tstzspan),
+  -- overlaps or before
+  OPERATOR  28    &<# (tstzspan, timestamptz),
+  OPERATOR  28    &<# (tstzspan, tstzspan),
+  OPERATOR  28    &<# (tstzspan, tstzspanset),
+  -- strictly before
+  OPERATOR  29    <<# (tstzspan, timestamptz),
+  OPERATOR  29    <<# (tstzspan, tstzspan),
+  OPERATOR  29    <<# (tstzspan, tstzspanset),
+  -- strictly after
+  OPERATOR  30    #>> (tstzspan, timestamptz),
+  OPERATOR  30    #>> (tstzspan, tstzspan),
+  OPERATOR  30    #>> (tstzspan, tstzspanset),
+  -- overlaps or after
+  OPERATOR  31    #&> (tstzspan, timestamptz),
+  OPERATOR  31    #&> (tstzspan, tstzspan),
+  OPERATOR  31    #&> (tstzspan, tstzspanset),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************
+ * Temporal boxes and temporal types
+ ******************************************************************************/
+
+CREATE FUNCTION tbox_brin_add_value(internal, internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Tbox_brin_add_value'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_brin_consistent(internal, internal, internal, int4)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Tbox_brin_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_brin_union(internal, internal, internal)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Tbox_brin_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tbox_inclusion_ops
+  DEFAULT FOR TYPE tbox USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tbox, tbox),
+  OPERATOR  1    << (tbox, tint),
+  OPERATOR  1    << (tbox, tbigint),
+  OPERATOR  1    << (tbox, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tbox, tbox),
+  OPERATOR  2    &< (tbox, tint),
+  OPERATOR  2    &< (tbox, tbigint),
+  OPERATOR  2    &< (tbox, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tbox, tbox),
+  OPERATOR  3    && (tbox, tint),
+  OPERATOR  3    && (tbox, tbigint),
+  OPERATOR  3    && (tbox, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tbox, tbox),
+  OPERATOR  4    &> (tbox, tint),
+  OPERATOR  4    &> (tbox, tbigint),
+  OPERATOR  4    &> (tbox, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tbox, tbox),
+  OPERATOR  5    >> (tbox, tint),
+  OPERATOR  5    >> (tbox, tbigint),
+  OPERATOR  5    >> (tbox, tfloat),
+    -- same
+  OPERATOR  6    ~= (tbox, tbox),
+  OPERATOR  6    ~= (tbox, tint),
+  OPERATOR  6    ~= (tbox, tbigint),
+  OPERATOR  6    ~= (tbox, tfloat),
+  -- contains
+  OPERATOR  7    @> (tbox, tbox),
+  OPERATOR  7    @> (tbox, tint),
+  OPERATOR  7    @> (tbox, tbigint),
+  OPERATOR  7    @> (tbox, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tbox, tbox),
+  OPERATOR  8    <@ (tbox, tint),
+  OPERATOR  8    <@ (tbox, tbigint),
+  OPERATOR  8    <@ (tbox, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tbox, tbox),
+  OPERATOR  17    -|- (tbox, tint),
+  OPERATOR  17    -|- (tbox, tbigint),
+  OPERATOR  17    -|- (tbox, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbox, tbox),
+  OPERATOR  28    &<# (tbox, tint),
+  OPERATOR  28    &<# (tbox, tbigint),
+  OPERATOR  28    &<# (tbox, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tbox, tbox),
+  OPERATOR  29    <<# (tbox, tint),
+  OPERATOR  29    <<# (tbox, tbigint),
+  OPERATOR  29    <<# (tbox, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tbox, tbox),
+  OPERATOR  30    #>> (tbox, tint),
+  OPERATOR  30    #>> (tbox, tbigint),
+  OPERATOR  30    #>> (tbox, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbox, tbox),
+  OPERATOR  31    #&> (tbox, tint),
+  OPERATOR  31    #&> (tbox, tbigint),
+  OPERATOR  31    #&> (tbox, tfloat),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tbox_inclusion_multi_ops
+  FOR TYPE tbox USING brin AS
+  -- strictly left
+  OPERATOR  1    << (tbox, tbox),
+  OPERATOR  1    << (tbox, tint),
+  OPERATOR  1    << (tbox, tbigint),
+  OPERATOR  1    << (tbox, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tbox, tbox),
+  OPERATOR  2    &< (tbox, tint),
+  OPERATOR  2    &< (tbox, tbigint),
+  OPERATOR  2    &< (tbox, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tbox, tbox),
+  OPERATOR  3    && (tbox, tint),
+  OPERATOR  3    && (tbox, tbigint),
+  OPERATOR  3    && (tbox, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tbox, tbox),
+  OPERATOR  4    &> (tbox, tint),
+  OPERATOR  4    &> (tbox, tbigint),
+  OPERATOR  4    &> (tbox, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tbox, tbox),
+  OPERATOR  5    >> (tbox, tint),
+  OPERATOR  5    >> (tbox, tbigint),
+  OPERATOR  5    >> (tbox, tfloat),
+    -- same
+  OPERATOR  6    ~= (tbox, tbox),
+  OPERATOR  6    ~= (tbox, tint),
+  OPERATOR  6    ~= (tbox, tbigint),
+  OPERATOR  6    ~= (tbox, tfloat),
+  -- contains
+  OPERATOR  7    @> (tbox, tbox),
+  OPERATOR  7    @> (tbox, tint),
+  OPERATOR  7    @> (tbox, tbigint),
+  OPERATOR  7    @> (tbox, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tbox, tbox),
+  OPERATOR  8    <@ (tbox, tint),
+  OPERATOR  8    <@ (tbox, tbigint),
+  OPERATOR  8    <@ (tbox, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tbox, tbox),
+  OPERATOR  17    -|- (tbox, tint),
+  OPERATOR  17    -|- (tbox, tbigint),
+  OPERATOR  17    -|- (tbox, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbox, tbox),
+  OPERATOR  28    &<# (tbox, tint),
+  OPERATOR  28    &<# (tbox, tbigint),
+  OPERATOR  28    &<# (tbox, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tbox, tbox),
+  OPERATOR  29    <<# (tbox, tint),
+  OPERATOR  29    <<# (tbox, tbigint),
+  OPERATOR  29    <<# (tbox, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tbox, tbox),
+  OPERATOR  30    #>> (tbox, tint),
+  OPERATOR  30    #>> (tbox, tbigint),
+  OPERATOR  30    #>> (tbox, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbox, tbox),
+  OPERATOR  31    #&> (tbox, tint),
+  OPERATOR  31    #&> (tbox, tbigint),
+  OPERATOR  31    #&> (tbox, tfloat),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tbool_inclusion_ops
+  DEFAULT FOR TYPE tbool USING brin AS
+  STORAGE tstzspan,
+  -- overlaps
+  OPERATOR  3    && (tbool, tstzspan),
+  OPERATOR  3    && (tbool, tbool),
+    -- same
+  OPERATOR  6    ~= (tbool, tstzspan),
+  OPERATOR  6    ~= (tbool, tbool),
+  -- contains
+  OPERATOR  7    @> (tbool, tstzspan),
+  OPERATOR  7    @> (tbool, tbool),
+  -- contained by
+  OPERATOR  8    <@ (tbool, tstzspan),
+  OPERATOR  8    <@ (tbool, tbool),
+  -- adjacent
+  OPERATOR  17    -|- (tbool, tstzspan),
+  OPERATOR  17    -|- (tbool, tbool),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbool, tstzspan),
+  OPERATOR  28    &<# (tbool, tbool),
+  -- strictly before
+  OPERATOR  29    <<# (tbool, tstzspan),
+  OPERATOR  29    <<# (tbool, tbool),
+  -- strictly after
+  OPERATOR  30    #>> (tbool, tstzspan),
+  OPERATOR  30    #>> (tbool, tbool),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbool, tstzspan),
+  OPERATOR  31    #&> (tbool, tbool),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tbool_inclusion_multi_ops
+  FOR TYPE tbool USING brin AS
+  STORAGE tstzspan,
+  -- overlaps
+  OPERATOR  3    && (tbool, tstzspan),
+  OPERATOR  3    && (tbool, tbool),
+    -- same
+  OPERATOR  6    ~= (tbool, tstzspan),
+  OPERATOR  6    ~= (tbool, tbool),
+  -- contains
+  OPERATOR  7    @> (tbool, tstzspan),
+  OPERATOR  7    @> (tbool, tbool),
+  -- contained by
+  OPERATOR  8    <@ (tbool, tstzspan),
+  OPERATOR  8    <@ (tbool, tbool),
+  -- adjacent
+  OPERATOR  17    -|- (tbool, tstzspan),
+  OPERATOR  17    -|- (tbool, tbool),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbool, tstzspan),
+  OPERATOR  28    &<# (tbool, tbool),
+  -- strictly before
+  OPERATOR  29    <<# (tbool, tstzspan),
+  OPERATOR  29    <<# (tbool, tbool),
+  -- strictly after
+  OPERATOR  30    #>> (tbool, tstzspan),
+  OPERATOR  30    #>> (tbool, tbool),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbool, tstzspan),
+  OPERATOR  31    #&> (tbool, tbool),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tint_inclusion_ops
+  DEFAULT FOR TYPE tint USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tint, intspan),
+  OPERATOR  1    << (tint, tbox),
+  OPERATOR  1    << (tint, tint),
+   -- overlaps or left
+  OPERATOR  2    &< (tint, intspan),
+  OPERATOR  2    &< (tint, tbox),
+  OPERATOR  2    &< (tint, tint),
+  -- overlaps
+  OPERATOR  3    && (tint, intspan),
+  OPERATOR  3    && (tint, tstzspan),
+  OPERATOR  3    && (tint, tbox),
+  OPERATOR  3    && (tint, tint),
+  -- overlaps or right
+  OPERATOR  4    &> (tint, intspan),
+  OPERATOR  4    &> (tint, tbox),
+  OPERATOR  4    &> (tint, tint),
+  -- strictly right
+  OPERATOR  5    >> (tint, intspan),
+  OPERATOR  5    >> (tint, tbox),
+  OPERATOR  5    >> (tint, tint),
+    -- same
+  OPERATOR  6    ~= (tint, intspan),
+  OPERATOR  6    ~= (tint, tstzspan),
+  OPERATOR  6    ~= (tint, tbox),
+  OPERATOR  6    ~= (tint, tint),
+  -- contains
+  OPERATOR  7    @> (tint, intspan),
+  OPERATOR  7    @> (tint, tstzspan),
+  OPERATOR  7    @> (tint, tbox),
+  OPERATOR  7    @> (tint, tint),
+  -- contained by
+  OPERATOR  8    <@ (tint, intspan),
+  OPERATOR  8    <@ (tint, tstzspan),
+  OPERATOR  8    <@ (tint, tbox),
+  OPERATOR  8    <@ (tint, tint),
+  -- adjacent
+  OPERATOR  17    -|- (tint, intspan),
+  OPERATOR  17    -|- (tint, tstzspan),
+  OPERATOR  17    -|- (tint, tbox),
+  OPERATOR  17    -|- (tint, tint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tint, tstzspan),
+  OPERATOR  28    &<# (tint, tbox),
+  OPERATOR  28    &<# (tint, tint),
+  -- strictly before
+  OPERATOR  29    <<# (tint, tstzspan),
+  OPERATOR  29    <<# (tint, tbox),
+  OPERATOR  29    <<# (tint, tint),
+  -- strictly after
+  OPERATOR  30    #>> (tint, tstzspan),
+  OPERATOR  30    #>> (tint, tbox),
+  OPERATOR  30    #>> (tint, tint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tint, tstzspan),
+  OPERATOR  31    #&> (tint, tbox),
+  OPERATOR  31    #&> (tint, tint),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tint_inclusion_multi_ops
+  FOR TYPE tint USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tint, intspan),
+  OPERATOR  1    << (tint, tbox),
+  OPERATOR  1    << (tint, tint),
+   -- overlaps or left
+  OPERATOR  2    &< (tint, intspan),
+  OPERATOR  2    &< (tint, tbox),
+  OPERATOR  2    &< (tint, tint),
+  -- overlaps
+  OPERATOR  3    && (tint, intspan),
+  OPERATOR  3    && (tint, tstzspan),
+  OPERATOR  3    && (tint, tbox),
+  OPERATOR  3    && (tint, tint),
+  -- overlaps or right
+  OPERATOR  4    &> (tint, intspan),
+  OPERATOR  4    &> (tint, tbox),
+  OPERATOR  4    &> (tint, tint),
+  -- strictly right
+  OPERATOR  5    >> (tint, intspan),
+  OPERATOR  5    >> (tint, tbox),
+  OPERATOR  5    >> (tint, tint),
+    -- same
+  OPERATOR  6    ~= (tint, intspan),
+  OPERATOR  6    ~= (tint, tstzspan),
+  OPERATOR  6    ~= (tint, tbox),
+  OPERATOR  6    ~= (tint, tint),
+  -- contains
+  OPERATOR  7    @> (tint, intspan),
+  OPERATOR  7    @> (tint, tstzspan),
+  OPERATOR  7    @> (tint, tbox),
+  OPERATOR  7    @> (tint, tint),
+  -- contained by
+  OPERATOR  8    <@ (tint, intspan),
+  OPERATOR  8    <@ (tint, tstzspan),
+  OPERATOR  8    <@ (tint, tbox),
+  OPERATOR  8    <@ (tint, tint),
+  -- adjacent
+  OPERATOR  17    -|- (tint, intspan),
+  OPERATOR  17    -|- (tint, tstzspan),
+  OPERATOR  17    -|- (tint, tbox),
+  OPERATOR  17    -|- (tint, tint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tint, tstzspan),
+  OPERATOR  28    &<# (tint, tbox),
+  OPERATOR  28    &<# (tint, tint),
+  -- strictly before
+  OPERATOR  29    <<# (tint, tstzspan),
+  OPERATOR  29    <<# (tint, tbox),
+  OPERATOR  29    <<# (tint, tint),
+  -- strictly after
+  OPERATOR  30    #>> (tint, tstzspan),
+  OPERATOR  30    #>> (tint, tbox),
+  OPERATOR  30    #>> (tint, tint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tint, tstzspan),
+  OPERATOR  31    #&> (tint, tbox),
+  OPERATOR  31    #&> (tint, tint),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tbigint_inclusion_ops
+  DEFAULT FOR TYPE tbigint USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tbigint, bigintspan),
+  OPERATOR  1    << (tbigint, tbox),
+  OPERATOR  1    << (tbigint, tbigint),
+   -- overlaps or left
+  OPERATOR  2    &< (tbigint, bigintspan),
+  OPERATOR  2    &< (tbigint, tbox),
+  OPERATOR  2    &< (tbigint, tbigint),
+  -- overlaps
+  OPERATOR  3    && (tbigint, bigintspan),
+  OPERATOR  3    && (tbigint, tstzspan),
+  OPERATOR  3    && (tbigint, tbox),
+  OPERATOR  3    && (tbigint, tbigint),
+  -- overlaps or right
+  OPERATOR  4    &> (tbigint, bigintspan),
+  OPERATOR  4    &> (tbigint, tbox),
+  OPERATOR  4    &> (tbigint, tbigint),
+  -- strictly right
+  OPERATOR  5    >> (tbigint, bigintspan),
+  OPERATOR  5    >> (tbigint, tbox),
+  OPERATOR  5    >> (tbigint, tbigint),
+    -- same
+  OPERATOR  6    ~= (tbigint, bigintspan),
+  OPERATOR  6    ~= (tbigint, tstzspan),
+  OPERATOR  6    ~= (tbigint, tbox),
+  OPERATOR  6    ~= (tbigint, tbigint),
+  -- contains
+  OPERATOR  7    @> (tbigint, bigintspan),
+  OPERATOR  7    @> (tbigint, tstzspan),
+  OPERATOR  7    @> (tbigint, tbox),
+  OPERATOR  7    @> (tbigint, tbigint),
+  -- contained by
+  OPERATOR  8    <@ (tbigint, bigintspan),
+  OPERATOR  8    <@ (tbigint, tstzspan),
+  OPERATOR  8    <@ (tbigint, tbox),
+  OPERATOR  8    <@ (tbigint, tbigint),
+  -- adjacent
+  OPERATOR  17    -|- (tbigint, bigintspan),
+  OPERATOR  17    -|- (tbigint, tstzspan),
+  OPERATOR  17    -|- (tbigint, tbox),
+  OPERATOR  17    -|- (tbigint, tbigint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbigint, tstzspan),
+  OPERATOR  28    &<# (tbigint, tbox),
+  OPERATOR  28    &<# (tbigint, tbigint),
+  -- strictly before
+  OPERATOR  29    <<# (tbigint, tstzspan),
+  OPERATOR  29    <<# (tbigint, tbox),
+  OPERATOR  29    <<# (tbigint, tbigint),
+  -- strictly after
+  OPERATOR  30    #>> (tbigint, tstzspan),
+  OPERATOR  30    #>> (tbigint, tbox),
+  OPERATOR  30    #>> (tbigint, tbigint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbigint, tstzspan),
+  OPERATOR  31    #&> (tbigint, tbox),
+  OPERATOR  31    #&> (tbigint, tbigint),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tbigint_inclusion_multi_ops
+  FOR TYPE tbigint USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tbigint, bigintspan),
+  OPERATOR  1    << (tbigint, tbox),
+  OPERATOR  1    << (tbigint, tbigint),
+   -- overlaps or left
+  OPERATOR  2    &< (tbigint, bigintspan),
+  OPERATOR  2    &< (tbigint, tbox),
+  OPERATOR  2    &< (tbigint, tbigint),
+  -- overlaps
+  OPERATOR  3    && (tbigint, bigintspan),
+  OPERATOR  3    && (tbigint, tstzspan),
+  OPERATOR  3    && (tbigint, tbox),
+  OPERATOR  3    && (tbigint, tbigint),
+  -- overlaps or right
+  OPERATOR  4    &> (tbigint, bigintspan),
+  OPERATOR  4    &> (tbigint, tbox),
+  OPERATOR  4    &> (tbigint, tbigint),
+  -- strictly right
+  OPERATOR  5    >> (tbigint, bigintspan),
+  OPERATOR  5    >> (tbigint, tbox),
+  OPERATOR  5    >> (tbigint, tbigint),
+    -- same
+  OPERATOR  6    ~= (tbigint, bigintspan),
+  OPERATOR  6    ~= (tbigint, tstzspan),
+  OPERATOR  6    ~= (tbigint, tbox),
+  OPERATOR  6    ~= (tbigint, tbigint),
+  -- contains
+  OPERATOR  7    @> (tbigint, bigintspan),
+  OPERATOR  7    @> (tbigint, tstzspan),
+  OPERATOR  7    @> (tbigint, tbox),
+  OPERATOR  7    @> (tbigint, tbigint),
+  -- contained by
+  OPERATOR  8    <@ (tbigint, bigintspan),
+  OPERATOR  8    <@ (tbigint, tstzspan),
+  OPERATOR  8    <@ (tbigint, tbox),
+  OPERATOR  8    <@ (tbigint, tbigint),
+  -- adjacent
+  OPERATOR  17    -|- (tbigint, bigintspan),
+  OPERATOR  17    -|- (tbigint, tstzspan),
+  OPERATOR  17    -|- (tbigint, tbox),
+  OPERATOR  17    -|- (tbigint, tbigint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tbigint, tstzspan),
+  OPERATOR  28    &<# (tbigint, tbox),
+  OPERATOR  28    &<# (tbigint, tbigint),
+  -- strictly before
+  OPERATOR  29    <<# (tbigint, tstzspan),
+  OPERATOR  29    <<# (tbigint, tbox),
+  OPERATOR  29    <<# (tbigint, tbigint),
+  -- strictly after
+  OPERATOR  30    #>> (tbigint, tstzspan),
+  OPERATOR  30    #>> (tbigint, tbox),
+  OPERATOR  30    #>> (tbigint, tbigint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tbigint, tstzspan),
+  OPERATOR  31    #&> (tbigint, tbox),
+  OPERATOR  31    #&> (tbigint, tbigint),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tfloat_inclusion_ops
+  DEFAULT FOR TYPE tfloat USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tfloat, floatspan),
+  OPERATOR  1    << (tfloat, tbox),
+  OPERATOR  1    << (tfloat, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tfloat, floatspan),
+  OPERATOR  2    &< (tfloat, tbox),
+  OPERATOR  2    &< (tfloat, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tfloat, floatspan),
+  OPERATOR  3    && (tfloat, tstzspan),
+  OPERATOR  3    && (tfloat, tbox),
+  OPERATOR  3    && (tfloat, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tfloat, floatspan),
+  OPERATOR  4    &> (tfloat, tbox),
+  OPERATOR  4    &> (tfloat, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tfloat, floatspan),
+  OPERATOR  5    >> (tfloat, tbox),
+  OPERATOR  5    >> (tfloat, tfloat),
+    -- same
+  OPERATOR  6    ~= (tfloat, floatspan),
+  OPERATOR  6    ~= (tfloat, tstzspan),
+  OPERATOR  6    ~= (tfloat, tbox),
+  OPERATOR  6    ~= (tfloat, tfloat),
+  -- contains
+  OPERATOR  7    @> (tfloat, floatspan),
+  OPERATOR  7    @> (tfloat, tstzspan),
+  OPERATOR  7    @> (tfloat, tbox),
+  OPERATOR  7    @> (tfloat, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tfloat, floatspan),
+  OPERATOR  8    <@ (tfloat, tstzspan),
+  OPERATOR  8    <@ (tfloat, tbox),
+  OPERATOR  8    <@ (tfloat, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tfloat, floatspan),
+  OPERATOR  17    -|- (tfloat, tstzspan),
+  OPERATOR  17    -|- (tfloat, tbox),
+  OPERATOR  17    -|- (tfloat, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tfloat, tstzspan),
+  OPERATOR  28    &<# (tfloat, tbox),
+  OPERATOR  28    &<# (tfloat, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tfloat, tstzspan),
+  OPERATOR  29    <<# (tfloat, tbox),
+  OPERATOR  29    <<# (tfloat, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tfloat, tstzspan),
+  OPERATOR  30    #>> (tfloat, tbox),
+  OPERATOR  30    #>> (tfloat, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tfloat, tstzspan),
+  OPERATOR  31    #&> (tfloat, tbox),
+  OPERATOR  31    #&> (tfloat, tfloat),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS tfloat_inclusion_multi_ops
+  FOR TYPE tfloat USING brin AS
+  STORAGE tbox,
+  -- strictly left
+  OPERATOR  1    << (tfloat, floatspan),
+  OPERATOR  1    << (tfloat, tbox),
+  OPERATOR  1    << (tfloat, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tfloat, floatspan),
+  OPERATOR  2    &< (tfloat, tbox),
+  OPERATOR  2    &< (tfloat, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tfloat, floatspan),
+  OPERATOR  3    && (tfloat, tstzspan),
+  OPERATOR  3    && (tfloat, tbox),
+  OPERATOR  3    && (tfloat, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tfloat, floatspan),
+  OPERATOR  4    &> (tfloat, tbox),
+  OPERATOR  4    &> (tfloat, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tfloat, floatspan),
+  OPERATOR  5    >> (tfloat, tbox),
+  OPERATOR  5    >> (tfloat, tfloat),
+    -- same
+  OPERATOR  6    ~= (tfloat, floatspan),
+  OPERATOR  6    ~= (tfloat, tstzspan),
+  OPERATOR  6    ~= (tfloat, tbox),
+  OPERATOR  6    ~= (tfloat, tfloat),
+  -- contains
+  OPERATOR  7    @> (tfloat, floatspan),
+  OPERATOR  7    @> (tfloat, tstzspan),
+  OPERATOR  7    @> (tfloat, tbox),
+  OPERATOR  7    @> (tfloat, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tfloat, floatspan),
+  OPERATOR  8    <@ (tfloat, tstzspan),
+  OPERATOR  8    <@ (tfloat, tbox),
+  OPERATOR  8    <@ (tfloat, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tfloat, floatspan),
+  OPERATOR  17    -|- (tfloat, tstzspan),
+  OPERATOR  17    -|- (tfloat, tbox),
+  OPERATOR  17    -|- (tfloat, tfloat),
+  -- overlaps or before
+  OPERATOR  28    &<# (tfloat, tstzspan),
+  OPERATOR  28    &<# (tfloat, tbox),
+  OPERATOR  28    &<# (tfloat, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tfloat, tstzspan),
+  OPERATOR  29    <<# (tfloat, tbox),
+  OPERATOR  29    <<# (tfloat, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tfloat, tstzspan),
+  OPERATOR  30    #>> (tfloat, tbox),
+  OPERATOR  30    #>> (tfloat, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tfloat, tstzspan),
+  OPERATOR  31    #&> (tfloat, tbox),
+  OPERATOR  31    #&> (tfloat, tfloat),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  tbox_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  tbox_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  tbox_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS ttext_inclusion_ops
+  DEFAULT FOR TYPE ttext USING brin AS
+  STORAGE tstzspan,
+  -- overlaps
+  OPERATOR  3    && (ttext, tstzspan),
+  OPERATOR  3    && (ttext, ttext),
+    -- same
+  OPERATOR  6    ~= (ttext, tstzspan),
+  OPERATOR  6    ~= (ttext, ttext),
+  -- contains
+  OPERATOR  7    @> (ttext, tstzspan),
+  OPERATOR  7    @> (ttext, ttext),
+  -- contained by
+  OPERATOR  8    <@ (ttext, tstzspan),
+  OPERATOR  8    <@ (ttext, ttext),
+  -- adjacent
+  OPERATOR  17    -|- (ttext, tstzspan),
+  OPERATOR  17    -|- (ttext, ttext),
+  -- overlaps or before
+  OPERATOR  28    &<# (ttext, tstzspan),
+  OPERATOR  28    &<# (ttext, ttext),
+  -- strictly before
+  OPERATOR  29    <<# (ttext, tstzspan),
+  OPERATOR  29    <<# (ttext, ttext),
+  -- strictly after
+  OPERATOR  30    #>> (ttext, tstzspan),
+  OPERATOR  30    #>> (ttext, ttext),
+  -- overlaps or after
+  OPERATOR  31    #&> (ttext, tstzspan),
+  OPERATOR  31    #&> (ttext, ttext),
+  -- functions
+  FUNCTION  1  bbox_brin_inclusion_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal);
+
+CREATE OPERATOR CLASS ttext_inclusion_multi_ops
+  FOR TYPE ttext USING brin AS
+  STORAGE tstzspan,
+  -- overlaps
+  OPERATOR  3    && (ttext, tstzspan),
+  OPERATOR  3    && (ttext, ttext),
+    -- same
+  OPERATOR  6    ~= (ttext, tstzspan),
+  OPERATOR  6    ~= (ttext, ttext),
+  -- contains
+  OPERATOR  7    @> (ttext, tstzspan),
+  OPERATOR  7    @> (ttext, ttext),
+  -- contained by
+  OPERATOR  8    <@ (ttext, tstzspan),
+  OPERATOR  8    <@ (ttext, ttext),
+  -- adjacent
+  OPERATOR  17    -|- (ttext, tstzspan),
+  OPERATOR  17    -|- (ttext, ttext),
+  -- overlaps or before
+  OPERATOR  28    &<# (ttext, tstzspan),
+  OPERATOR  28    &<# (ttext, ttext),
+  -- strictly before
+  OPERATOR  29    <<# (ttext, tstzspan),
+  OPERATOR  29    <<# (ttext, ttext),
+  -- strictly after
+  OPERATOR  30    #>> (ttext, tstzspan),
+  OPERATOR  30    #>> (ttext, ttext),
+  -- overlaps or after
+  OPERATOR  31    #&> (ttext, tstzspan),
+  OPERATOR  31    #&> (ttext, ttext),
+  -- functions
+  FUNCTION  1  bbox_brin_multi_opcinfo(internal),
+  FUNCTION  2  span_brin_add_value(internal, internal, internal, internal),
+  FUNCTION  3  span_brin_consistent(internal, internal, internal, int4),
+  FUNCTION  4  span_brin_union(internal, internal, internal),
+  FUNCTION  5  bbox_brin_multi_options(internal);
+
+/******************************************************************************/
@@ -139,6 +139,7 @@ Datum
 Tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 {
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  store_fcinfo(fcinfo);
   Temporal *result = tpoint_tcentroid_finalfn(state);
   if (! result)
     PG_RETURN_NULL();
@@ -0,0 +1,166 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN index for spatiotemporal boxes and spatiotemporal types
+ * @details The summaries of the block ranges and the generic methods are
+ * those of the file `temporal_brin.c`, which keep either one or several
+ * spatiotemporal boxes for each block range.
+ */
+
+/* C */
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/stratnum.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_internal_geo.h>
+#include "geo/stbox.h"
+#include "geo/stbox_index.h"
+/* MobilityDB */
+#include "pg_temporal/meos_catalog.h"
+#include "pg_temporal/temporal.h"
+#include "pg_temporal/temporal_brin.h"
+#include "pg_geo/tspatial.h"
+
+/*****************************************************************************
+ * BRIN methods for spatiotemporal boxes and spatiotemporal types
+ *****************************************************************************/
+
+/**
+ * @brief Set the spatiotemporal box of a value of an indexed column
+ * @note Only the header of the temporal values is detoasted to read their
+ * bounding box
+ */
+static void
+stbox_brin_value_bbox(Datum value, MeosType type, void *result)
+{
+  if (tspatial_type(type))
+  {
+    Temporal *temp = temporal_slice(value);
+    tspatial_set_stbox(temp, (STBox *) result);
+    PG_FREE_IF_COPY_P(temp, DatumGetPointer(value));
+  }
+  else
+    tspatial_spgist_get_stbox(value, type, (STBox *) result);
+  return;
+}
+
+/**
+ * @brief Set the spatiotemporal box of a query argument
+ */
+static void
+stbox_brin_query_bbox(Datum value, MeosType type, void *result)
+{
+  tspatial_spgist_get_stbox(value, type, (STBox *) result);
+  return;
+}
+
+/**
+ * @brief Expand the second spatiotemporal box with the first one
+ */
+static void
+stbox_brin_expand(const void *bbox1, void *bbox2)
+{
+  stbox_expand((const STBox *) bbox1, (STBox *) bbox2);
+  return;
+}
+
+/**
+ * @brief Return true if a spatiotemporal box may enclose values satisfying a
+ * query
+ */
+static bool
+stbox_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return stbox_gist_inner_consistent((const STBox *) key,
+    (const STBox *) query, strategy);
+}
+
+/**
+ * @brief Return the amount by which the first spatiotemporal box grows to
+ * include the second one
+ */
+static double
+stbox_brin_penalty(const void *bbox1, const void *bbox2)
+{
+  return stbox_penalty((void *) bbox1, (void *) bbox2);
+}
+
+/* Functions manipulating the spatiotemporal boxes kept by a BRIN index */
+static const BboxBrinMethods StboxBrinMethods =
+{
+  sizeof(STBox),
+  &stbox_brin_value_bbox,
+  &stbox_brin_query_bbox,
+  &stbox_brin_expand,
+  &stbox_brin_consistent,
+  &stbox_brin_penalty
+};
+
+PGDLLEXPORT Datum Stbox_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_add_value);
+/**
+ * @brief BRIN add value method for spatiotemporal boxes and spatiotemporal
+ * types
+ */
+Datum
+Stbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, &StboxBrinMethods);
+}
+
+PGDLLEXPORT Datum Stbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_consistent);
+/**
+ * @brief BRIN consistent method for spatiotemporal boxes and spatiotemporal
+ * types
+ */
+Datum
+Stbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, &StboxBrinMethods);
+}
+
+PGDLLEXPORT Datum Stbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_union);
+/**
+ * @brief BRIN union method for spatiotemporal boxes and spatiotemporal types
+ */
+Datum
+Stbox_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, &StboxBrinMethods);
+}
+
+/*****************************************************************************/
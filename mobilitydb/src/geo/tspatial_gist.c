@@ -54,6 +54,7 @@
 #include "pg_temporal/meos_catalog.h"
 #include "pg_temporal/temporal.h"
 #include "pg_temporal/tnumber_gist.h"
+#include "pg_geo/tspatial.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -441,4 +442,43 @@ Tspatial_gist_distance(PG_FUNCTION_ARGS)
   return stbox_gist_distance(fcinfo, false);
 }
 
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Return the position on a Hilbert curve of a spatiotemporal box
+ */
+static uint64
+stbox_gist_key(Datum d)
+{
+  const STBox *box = DatumGetSTboxP(d);
+  double coords[4];
+  int ndims = 0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+  {
+    coords[ndims++] = (box->xmin + box->xmax) / 2.0;
+    coords[ndims++] = (box->ymin + box->ymax) / 2.0;
+    if (MEOS_FLAGS_GET_Z(box->flags))
+      coords[ndims++] = (box->zmin + box->zmax) / 2.0;
+  }
+  if (MEOS_FLAGS_GET_T(box->flags))
+    coords[ndims++] = ((double) DatumGetTimestampTz(box->period.lower) +
+      (double) DatumGetTimestampTz(box->period.upper)) / 2.0;
+  return ndims ? bbox_gist_hilbert_key(coords, ndims) : 0;
+}
+
+PGDLLEXPORT Datum Stbox_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for spatiotemporal boxes
+ */
+Datum
+Stbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  bbox_gist_sortsupport(ssup, stbox_gist_key);
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************/
@@ -40,6 +40,7 @@
 #include <postgres.h>
 #include <fmgr.h>
 #include <access/gist.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -47,10 +48,12 @@
 #include "temporal/span.h"
 #include "temporal/span_index.h"
 #include "temporal/temporal.h"
+#include "temporal/type_util.h"
 /* MobilityDB */
 #include "pg_temporal/meos_catalog.h"
 #include "pg_temporal/spanset.h"
 #include "pg_temporal/temporal.h"
+#include "pg_temporal/tnumber_gist.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -820,4 +823,36 @@ Span_gist_fetch(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(entry);
 }
 
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Return the position of the center of a span on a line
+ */
+static uint64
+span_gist_key(Datum d)
+{
+  const Span *s = DatumGetSpanP(d);
+  double center = (s->basetype == T_TIMESTAMPTZ) ?
+    ((double) DatumGetTimestampTz(s->lower) +
+      (double) DatumGetTimestampTz(s->upper)) / 2.0 :
+    (datum_double(s->lower, s->basetype) +
+      datum_double(s->upper, s->basetype)) / 2.0;
+  return bbox_gist_hilbert_key(&center, 1);
+}
+
+PGDLLEXPORT Datum Span_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for span types
+ */
+Datum
+Span_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  bbox_gist_sortsupport(ssup, span_gist_key);
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************/
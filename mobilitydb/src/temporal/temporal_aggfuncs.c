@@ -106,6 +106,7 @@ PG_FUNCTION_INFO_V1(Temporal_tagg_finalfn);
 Datum
 Temporal_tagg_finalfn(PG_FUNCTION_ARGS)
 {
+  store_fcinfo(fcinfo);
   MemoryContext ctx = set_aggregation_context(fcinfo);
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
   Temporal *result = temporal_tagg_finalfn(state);
@@ -717,6 +718,7 @@ Datum
 Tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
 {
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  store_fcinfo(fcinfo);
   Temporal *result = tnumber_tavg_finalfn(state);
   if (! result)
     PG_RETURN_NULL();
@@ -0,0 +1,682 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2025, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN index for span, temporal alphanumeric and temporal number types
+ * @details The index keeps for each block range the bounding boxes of its
+ * values, that is, spans for the span types and the temporal alphanumeric
+ * types, and temporal boxes for the temporal numbers.
+ *
+ * Two kinds of operator classes are defined. The inclusion operator classes
+ * keep a single box enclosing all the values of a block range, as the
+ * inclusion operator classes of PostgreSQL do for the range types. The
+ * multi-inclusion operator classes keep up to `boxes_per_range` boxes for
+ * each block range and, when a value does not fit in any of them, merge the
+ * two boxes whose union grows the least, in the spirit of the minmax-multi
+ * operator classes of PostgreSQL. Both kinds store the boxes in the same
+ * summary and only differ in their opcinfo method.
+ *
+ * A block range may contain values satisfying a query if one of its boxes
+ * satisfies for all the scan keys the test that the GiST index applies to its
+ * inner nodes, since as for these nodes the box encloses the values below it.
+ */
+
+#include "pg_temporal/temporal_brin.h"
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/brin_internal.h>
+#include <access/brin_tuple.h>
+#include <access/reloptions.h>
+#include <access/skey.h>
+#include <catalog/pg_type.h>
+#include <utils/rel.h>
+#include <utils/typcache.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "temporal/span.h"
+#include "temporal/span_index.h"
+#include "temporal/tbox.h"
+#include "temporal/tbox_index.h"
+#include "temporal/type_util.h"
+/* MobilityDB */
+#include "pg_temporal/meos_catalog.h"
+#include "pg_temporal/spanset.h"
+#include "pg_temporal/temporal.h"
+
+/* Default number of boxes per block range of the multi-inclusion classes */
+#define BBOX_BRIN_MULTI_DEFAULT_BOXES  8
+/* Maximum number of boxes per block range of the multi-inclusion classes */
+#define BBOX_BRIN_MULTI_MAX_BOXES      32
+
+/**
+ * Structure to represent the summary of a block range
+ */
+typedef struct
+{
+  int32 vl_len_;     /**< Varlena header (do not touch directly!) */
+  int32 count;       /**< Number of boxes */
+  /* The boxes follow */
+} BboxBrinSummary;
+
+/* Address of the i-th box of a summary */
+#define BBOX_BRIN_BOX(summary, i, bboxsize) \
+  ((char *) (summary) + sizeof(BboxBrinSummary) + (i) * (bboxsize))
+
+/**
+ * Structure to represent the options of the multi-inclusion classes
+ */
+typedef struct
+{
+  int32 vl_len_;          /**< Varlena header (do not touch directly!) */
+  int boxes_per_range;    /**< Maximum number of boxes per block range */
+} BboxBrinOptions;
+
+/**
+ * Structure to represent the private data of an operator class
+ */
+typedef struct
+{
+  int maxboxes;      /**< Number of boxes per block range by default */
+} BboxBrinOpaque;
+
+/*****************************************************************************
+ * Summaries of the block ranges
+ *****************************************************************************/
+
+/**
+ * @brief Return the summary of a block range, which is detoasted in place
+ * so that it can be modified
+ */
+static BboxBrinSummary *
+bbox_brin_summary(BrinValues *column)
+{
+  Datum value = column->bv_values[0];
+  BboxBrinSummary *result = (BboxBrinSummary *) PG_DETOAST_DATUM(value);
+  if ((Pointer) result != DatumGetPointer(value))
+  {
+    pfree(DatumGetPointer(value));
+    column->bv_values[0] = PointerGetDatum(result);
+  }
+  return result;
+}
+
+/**
+ * @brief Return a summary composed of a single box
+ */
+static BboxBrinSummary *
+bbox_brin_summary_make(const void *box, size_t bboxsize)
+{
+  size_t size = sizeof(BboxBrinSummary) + bboxsize;
+  BboxBrinSummary *result = palloc(size);
+  SET_VARSIZE(result, size);
+  result->count = 1;
+  memcpy(BBOX_BRIN_BOX(result, 0, bboxsize), box, bboxsize);
+  return result;
+}
+
+/**
+ * @brief Return true if the first box contains the second one
+ * @note The test is done by expanding a copy of the first box rather than
+ * with the topological operators, which reject the boxes that differ in SRID
+ * or in dimensionality and that may nevertheless be found in the same column
+ */
+static bool
+bbox_brin_contains(const void *box1, const void *box2,
+  const BboxBrinMethods *methods)
+{
+  bboxunion box;
+  memcpy(&box, box1, methods->bboxsize);
+  methods->bbox_expand(box2, &box);
+  return memcmp(&box, box1, methods->bboxsize) == 0;
+}
+
+/**
+ * @brief Add a box to a summary unless one of its boxes contains it
+ * @return The new summary, or NULL if the summary was left unchanged
+ */
+static BboxBrinSummary *
+bbox_brin_summary_add(BboxBrinSummary *summary, const void *box,
+  const BboxBrinMethods *methods)
+{
+  size_t bboxsize = methods->bboxsize;
+  for (int i = 0; i < summary->count; i++)
+  {
+    if (bbox_brin_contains(BBOX_BRIN_BOX(summary, i, bboxsize), box, methods))
+      return NULL;
+  }
+  size_t size = sizeof(BboxBrinSummary) + (summary->count + 1) * bboxsize;
+  BboxBrinSummary *result = repalloc(summary, size);
+  memcpy(BBOX_BRIN_BOX(result, result->count, bboxsize), box, bboxsize);
+  result->count++;
+  SET_VARSIZE(result, size);
+  return result;
+}
+
+/**
+ * @brief Merge the boxes of a summary until there are at most the given
+ * number of them
+ * @details At each step the two boxes merged are those for which the sum of
+ * the growths of each box for including the other one is minimal
+ */
+static void
+bbox_brin_summary_reduce(BboxBrinSummary *summary, int maxboxes,
+  const BboxBrinMethods *methods)
+{
+  size_t bboxsize = methods->bboxsize;
+  while (summary->count > maxboxes)
+  {
+    int mini = 0, minj = 1;
+    double mincost = 0.0;
+    bool first = true;
+    for (int i = 0; i < summary->count - 1; i++)
+    {
+      const void *box1 = BBOX_BRIN_BOX(summary, i, bboxsize);
+      for (int j = i + 1; j < summary->count; j++)
+      {
+        const void *box2 = BBOX_BRIN_BOX(summary, j, bboxsize);
+        double cost = methods->bbox_penalty(box1, box2) +
+          methods->bbox_penalty(box2, box1);
+        if (first || cost < mincost)
+        {
+          mini = i; minj = j; mincost = cost;
+          first = false;
+        }
+      }
+    }
+    /* Merge the second box into the first one and move the last box into
+     * the slot that is freed */
+    methods->bbox_expand(BBOX_BRIN_BOX(summary, minj, bboxsize),
+      BBOX_BRIN_BOX(summary, mini, bboxsize));
+    summary->count--;
+    if (minj != summary->count)
+      memcpy(BBOX_BRIN_BOX(summary, minj, bboxsize),
+        BBOX_BRIN_BOX(summary, summary->count, bboxsize), bboxsize);
+  }
+  SET_VARSIZE(summary, sizeof(BboxBrinSummary) + summary->count * bboxsize);
+  return;
+}
+
+/**
+ * @brief Return the maximum number of boxes per block range of an index
+ */
+static int
+bbox_brin_maxboxes(FunctionCallInfo fcinfo, const BrinDesc *bdesc,
+  AttrNumber attno)
+{
+  if (PG_HAS_OPCLASS_OPTIONS())
+  {
+    const BboxBrinOptions *opts =
+      (const BboxBrinOptions *) PG_GET_OPCLASS_OPTIONS();
+    if (opts && opts->boxes_per_range > 0)
+      return opts->boxes_per_range;
+  }
+  const BboxBrinOpaque *opaque = bdesc->bd_info[attno - 1]->oi_opaque;
+  return opaque->maxboxes;
+}
+
+/*****************************************************************************
+ * BRIN opcinfo and options methods
+ *****************************************************************************/
+
+/**
+ * @brief Return the description of the values stored by the index
+ * @param[in] maxboxes Number of boxes per block range by default
+ * @note Whatever the type of the boxes, the summary is stored as a bytea
+ */
+static BrinOpcInfo *
+bbox_brin_opcinfo(int maxboxes)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)) +
+    sizeof(BboxBrinOpaque));
+  result->oi_nstored = 1;
+  result->oi_regular_nulls = true;
+  result->oi_opaque = (BboxBrinOpaque *)
+    MAXALIGN((char *) result + SizeofBrinOpcInfo(1));
+  ((BboxBrinOpaque *) result->oi_opaque)->maxboxes = maxboxes;
+  result->oi_typcache[0] = lookup_type_cache(BYTEAOID, 0);
+  return result;
+}
+
+PGDLLEXPORT Datum Bbox_brin_inclusion_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Bbox_brin_inclusion_opcinfo);
+/**
+ * @brief BRIN opcinfo method for the inclusion operator classes
+ */
+Datum
+Bbox_brin_inclusion_opcinfo(PG_FUNCTION_ARGS UNUSED)
+{
+  PG_RETURN_POINTER(bbox_brin_opcinfo(1));
+}
+
+PGDLLEXPORT Datum Bbox_brin_multi_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Bbox_brin_multi_opcinfo);
+/**
+ * @brief BRIN opcinfo method for the multi-inclusion operator classes
+ */
+Datum
+Bbox_brin_multi_opcinfo(PG_FUNCTION_ARGS UNUSED)
+{
+  PG_RETURN_POINTER(bbox_brin_opcinfo(BBOX_BRIN_MULTI_DEFAULT_BOXES));
+}
+
+PGDLLEXPORT Datum Bbox_brin_multi_options(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Bbox_brin_multi_options);
+/**
+ * @brief BRIN options method for the multi-inclusion operator classes
+ */
+Datum
+Bbox_brin_multi_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(BboxBrinOptions));
+  add_local_int_reloption(relopts, "boxes_per_range",
+    "number of boxes kept for each block range",
+    BBOX_BRIN_MULTI_DEFAULT_BOXES, 1, BBOX_BRIN_MULTI_MAX_BOXES,
+    offsetof(BboxBrinOptions, boxes_per_range));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************
+ * BRIN add value, consistent, and union methods
+ *****************************************************************************/
+
+/**
+ * @brief Generic BRIN add value method
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] methods Functions manipulating the boxes of the index
+ */
+Datum
+bbox_brin_add_value(FunctionCallInfo fcinfo, const BboxBrinMethods *methods)
+{
+  BrinDesc *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  /* The null values are handled by the BRIN framework */
+  assert(! PG_GETARG_BOOL(3));
+
+  /* Compute the box of the value */
+  AttrNumber attno = column->bv_attno;
+  MeosType type = oid_meostype(bdesc->bd_index->rd_opcintype[attno - 1]);
+  bboxunion box;
+  methods->value_bbox(newval, type, &box);
+
+  /* If the block range has no value yet, the box is its summary */
+  if (column->bv_allnulls)
+  {
+    column->bv_values[0] = PointerGetDatum(bbox_brin_summary_make(&box,
+      methods->bboxsize));
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+
+  /* Add the box to the summary and merge boxes if there are too many */
+  BboxBrinSummary *summary = bbox_brin_summary_add(bbox_brin_summary(column),
+    &box, methods);
+  if (! summary)
+    PG_RETURN_BOOL(false);
+  bbox_brin_summary_reduce(summary, bbox_brin_maxboxes(fcinfo, bdesc, attno),
+    methods);
+  column->bv_values[0] = PointerGetDatum(summary);
+  PG_RETURN_BOOL(true);
+}
+
+/**
+ * @brief Generic BRIN consistent method
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] methods Functions manipulating the boxes of the index
+ */
+Datum
+bbox_brin_consistent(FunctionCallInfo fcinfo, const BboxBrinMethods *methods)
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey *keys = (ScanKey *) PG_GETARG_POINTER(2);
+  int nkeys = PG_GETARG_INT32(3);
+  /* The null values and the null scan keys are handled by the BRIN
+   * framework */
+  assert(! column->bv_allnulls);
+
+  /* Transform the queries into boxes */
+  bboxunion *queries = palloc(sizeof(bboxunion) * nkeys);
+  for (int i = 0; i < nkeys; i++)
+    methods->query_bbox(keys[i]->sk_argument,
+      oid_meostype(keys[i]->sk_subtype), &queries[i]);
+
+  /* The block range is consistent with the scan keys if one of its boxes is
+   * consistent with all of them */
+  const BboxBrinSummary *summary = (BboxBrinSummary *)
+    PG_DETOAST_DATUM(column->bv_values[0]);
+  size_t bboxsize = methods->bboxsize;
+  bool result = false;
+  for (int i = 0; i < summary->count && ! result; i++)
+  {
+    const void *box = BBOX_BRIN_BOX(summary, i, bboxsize);
+    result = true;
+    for (int j = 0; j < nkeys && result; j++)
+      result = methods->bbox_consistent(box, &queries[j],
+        keys[j]->sk_strategy);
+  }
+  pfree(queries);
+  PG_RETURN_BOOL(result);
+}
+
+/**
+ * @brief Generic BRIN union method
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] methods Functions manipulating the boxes of the index
+ */
+Datum
+bbox_brin_union(FunctionCallInfo fcinfo, const BboxBrinMethods *methods)
+{
+  BrinDesc *bdesc = (BrinDesc *) PG_GETARG_POINTER(0);
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+  /* The block ranges with only null values are handled by the BRIN
+   * framework */
+  assert(! col_a->bv_allnulls && ! col_b->bv_allnulls);
+
+  /* Add the boxes of the second summary to the first one */
+  BboxBrinSummary *summary = bbox_brin_summary(col_a);
+  const BboxBrinSummary *summary_b = (BboxBrinSummary *)
+    PG_DETOAST_DATUM(col_b->bv_values[0]);
+  size_t bboxsize = methods->bboxsize;
+  bool changed = false;
+  for (int i = 0; i < summary_b->count; i++)
+  {
+    BboxBrinSummary *newsummary = bbox_brin_summary_add(summary,
+      BBOX_BRIN_BOX(summary_b, i, bboxsize), methods);
+    if (newsummary)
+    {
+      summary = newsummary;
+      changed = true;
+    }
+  }
+  if (changed)
+    bbox_brin_summary_reduce(summary, bbox_brin_maxboxes(fcinfo, bdesc,
+      col_a->bv_attno), methods);
+  col_a->bv_values[0] = PointerGetDatum(summary);
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************
+ * BRIN methods for span types and temporal alphanumeric types
+ *****************************************************************************/
+
+/**
+ * @brief Set the span of a value of an indexed column
+ * @note Only the header of the temporal values and the span sets is
+ * detoasted to read their bounding box
+ */
+static void
+span_brin_value_bbox(Datum value, MeosType type, void *result)
+{
+  if (temporal_type(type))
+  {
+    Temporal *temp = temporal_slice(value);
+    temporal_set_tstzspan(temp, (Span *) result);
+    PG_FREE_IF_COPY_P(temp, DatumGetPointer(value));
+  }
+  else if (spanset_type(type))
+    spanset_span_slice(value, (Span *) result);
+  else
+    span_spgist_get_span(value, type, (Span *) result);
+  return;
+}
+
+/**
+ * @brief Set the span of a query argument
+ */
+static void
+span_brin_query_bbox(Datum value, MeosType type, void *result)
+{
+  span_spgist_get_span(value, type, (Span *) result);
+  return;
+}
+
+/**
+ * @brief Expand the second span with the first one
+ */
+static void
+span_brin_expand(const void *bbox1, void *bbox2)
+{
+  span_expand((const Span *) bbox1, (Span *) bbox2);
+  return;
+}
+
+/**
+ * @brief Return true if a span may enclose values satisfying a query
+ */
+static bool
+span_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return span_gist_inner_consistent((const Span *) key, (const Span *) query,
+    strategy);
+}
+
+/**
+ * @brief Return the width of a span as a double
+ */
+static double
+span_brin_width(const Span *s)
+{
+  return distance_double(distance_value_value(s->upper, s->lower,
+    s->basetype), s->basetype);
+}
+
+/**
+ * @brief Return the amount by which the first span grows to include the
+ * second one
+ */
+static double
+span_brin_penalty(const void *bbox1, const void *bbox2)
+{
+  Span s;
+  memcpy(&s, bbox1, sizeof(Span));
+  span_expand((const Span *) bbox2, &s);
+  return span_brin_width(&s) - span_brin_width((const Span *) bbox1);
+}
+
+/* Functions manipulating the spans kept by a BRIN index */
+static const BboxBrinMethods SpanBrinMethods =
+{
+  sizeof(Span),
+  &span_brin_value_bbox,
+  &span_brin_query_bbox,
+  &span_brin_expand,
+  &span_brin_consistent,
+  &span_brin_penalty
+};
+
+PGDLLEXPORT Datum Span_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_add_value);
+/**
+ * @brief BRIN add value method for span types and temporal alphanumeric
+ * types
+ */
+Datum
+Span_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, &SpanBrinMethods);
+}
+
+PGDLLEXPORT Datum Span_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_consistent);
+/**
+ * @brief BRIN consistent method for span types and temporal alphanumeric
+ * types
+ */
+Datum
+Span_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, &SpanBrinMethods);
+}
+
+PGDLLEXPORT Datum Span_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_union);
+/**
+ * @brief BRIN union method for span types and temporal alphanumeric types
+ */
+Datum
+Span_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, &SpanBrinMethods);
+}
+
+/*****************************************************************************
+ * BRIN methods for temporal boxes and temporal number types
+ *****************************************************************************/
+
+/**
+ * @brief Set the temporal box of a value of an indexed column
+ * @note Only the header of the temporal values is detoasted to read their
+ * bounding box
+ */
+static void
+tbox_brin_value_bbox(Datum value, MeosType type, void *result)
+{
+  if (tnumber_type(type))
+  {
+    Temporal *temp = temporal_slice(value);
+    tnumber_set_tbox(temp, (TBox *) result);
+    PG_FREE_IF_COPY_P(temp, DatumGetPointer(value));
+  }
+  else
+    tnumber_spgist_get_tbox(value, type, (TBox *) result);
+  return;
+}
+
+/**
+ * @brief Set the temporal box of a query argument
+ */
+static void
+tbox_brin_query_bbox(Datum value, MeosType type, void *result)
+{
+  tnumber_spgist_get_tbox(value, type, (TBox *) result);
+  return;
+}
+
+/**
+ * @brief Expand the second temporal box with the first one
+ */
+static void
+tbox_brin_expand(const void *bbox1, void *bbox2)
+{
+  tbox_expand((const TBox *) bbox1, (TBox *) bbox2);
+  return;
+}
+
+/**
+ * @brief Return true if a temporal box may enclose values satisfying a query
+ */
+static bool
+tbox_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return tbox_gist_inner_consistent((const TBox *) key, (const TBox *) query,
+    strategy);
+}
+
+/**
+ * @brief Return the size of a temporal box as the product of the widths of
+ * its dimensions
+ */
+static double
+tbox_brin_size(const TBox *box)
+{
+  double result = 1.0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+    result *= span_brin_width(&box->span);
+  if (MEOS_FLAGS_GET_T(box->flags))
+    result *= span_brin_width(&box->period);
+  return result;
+}
+
+/**
+ * @brief Return the amount by which the first temporal box grows to include
+ * the second one
+ */
+static double
+tbox_brin_penalty(const void *bbox1, const void *bbox2)
+{
+  TBox box;
+  memcpy(&box, bbox1, sizeof(TBox));
+  tbox_expand((const TBox *) bbox2, &box);
+  return tbox_brin_size(&box) - tbox_brin_size((const TBox *) bbox1);
+}
+
+/* Functions manipulating the temporal boxes kept by a BRIN index */
+static const BboxBrinMethods TboxBrinMethods =
+{
+  sizeof(TBox),
+  &tbox_brin_value_bbox,
+  &tbox_brin_query_bbox,
+  &tbox_brin_expand,
+  &tbox_brin_consistent,
+  &tbox_brin_penalty
+};
+
+PGDLLEXPORT Datum Tbox_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_add_value);
+/**
+ * @brief BRIN add value method for temporal boxes and temporal numbers
+ */
+Datum
+Tbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, &TboxBrinMethods);
+}
+
+PGDLLEXPORT Datum Tbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_consistent);
+/**
+ * @brief BRIN consistent method for temporal boxes and temporal numbers
+ */
+Datum
+Tbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, &TboxBrinMethods);
+}
+
+PGDLLEXPORT Datum Tbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_union);
+/**
+ * @brief BRIN union method for temporal boxes and temporal numbers
+ */
+Datum
+Tbox_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, &TboxBrinMethods);
+}
+
+/*****************************************************************************/
@@ -632,15 +632,17 @@ temporal_supportfn(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
       }
 
       /*
-       * Only add an operator condition for GIST and SPGIST indexes.
+       * Only add an operator condition for GIST, SPGIST, and BRIN indexes.
        * This means only the following opclasses
        *   tgeompoint_gist_ops, tgeogpoint_gist_ops,
-       *   tgeompoint_spgist_ops, tgeogpoint_spgist_ops
-       * will get automatic indexing when used with one of the indexable
-       * functions
+       *   tgeompoint_spgist_ops, tgeogpoint_spgist_ops,
+       *   tgeompoint_inclusion_ops, tgeogpoint_inclusion_ops
+       * and their multi-inclusion variants will get automatic indexing when
+       * used with one of the indexable functions
        */
       Oid opfamilyam = opFamilyAmOid(opfamilyoid);
-      if (opfamilyam != GIST_AM_OID && opfamilyam != SPGIST_AM_OID)
+      if (opfamilyam != GIST_AM_OID && opfamilyam != SPGIST_AM_OID &&
+          opfamilyam != BRIN_AM_OID)
         PG_RETURN_POINTER((Node *) NULL);
 
       /*
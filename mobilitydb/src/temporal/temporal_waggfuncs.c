@@ -95,8 +95,8 @@ Temporal_wagg_transfn(FunctionCallInfo fcinfo, datum_func2 func, bool min,
 }
 
 /**
- * @brief Transition function for moving window count and average aggregation
- * for temporal values
+ * @brief Transition function for moving window average aggregation for
+ * temporal values
  */
 Datum
 Temporal_wagg_transform_transfn(FunctionCallInfo fcinfo, datum_func2 func,
@@ -252,11 +252,20 @@ PG_FUNCTION_INFO_V1(Temporal_wcount_transfn);
  * values
  * @sqlfn wCount()
  */
-inline Datum
+Datum
 Temporal_wcount_transfn(PG_FUNCTION_ARGS)
 {
-  return Temporal_wagg_transform_transfn(fcinfo, &datum_sum_int32,
-    &temporal_transform_wcount);
+  SkipList *state;
+  MemoryContext ctx;
+  INPUT_AGG_TRANS_STATE_ARG(fcinfo, state, ctx);
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Interval *interval = PG_GETARG_INTERVAL_P(2);
+  store_fcinfo(fcinfo);
+  SkipList *result = temporal_wcount_transfn(state, temp, interval);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_FREE_IF_COPY(interval, 2);
+  unset_aggregation_context(ctx);
+  PG_RETURN_SKIPLIST_P(result);
 }
 
 PGDLLEXPORT Datum Tnumber_wavg_transfn(PG_FUNCTION_ARGS);
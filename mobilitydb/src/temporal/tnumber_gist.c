@@ -1081,4 +1081,211 @@ Tnumber_gist_distance(PG_FUNCTION_ARGS)
   return tbox_gist_distance(fcinfo, false);
 }
 
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Structure keeping the function that computes the sort key of a
+ * bounding box
+ */
+typedef struct
+{
+  uint64 (*bbox_key)(Datum);  /**< Position of the box on the curve */
+} BboxSortSupport;
+
+/**
+ * @brief Return an unsigned integer whose order is that of a double
+ */
+static uint64
+double_sortable(double d)
+{
+  uint64 u;
+  memcpy(&u, &d, sizeof(uint64));
+  /* Set the sign bit of the positive values and flip all the bits of the
+   * negative ones */
+  return (u & UINT64CONST(0x8000000000000000)) ? ~u :
+    u | UINT64CONST(0x8000000000000000);
+}
+
+/**
+ * @brief Return an unsigned integer whose order is that of a double rounded
+ * to a float
+ */
+static uint32
+float_sortable(double d)
+{
+  float f = (float) d;
+  uint32 u;
+  memcpy(&u, &f, sizeof(uint32));
+  return (u & 0x80000000) ? ~u : u | 0x80000000;
+}
+
+/**
+ * @brief Return the position on a Hilbert curve of the center of a bounding
+ * box
+ * @details Each coordinate is mapped to an unsigned integer of the same order
+ * from which are kept the most significant 64 / ndims bits. The position is
+ * then computed with the algorithm of J. Skilling, "Programming the Hilbert
+ * curve", AIP Conference Proceedings 707, 2004. A single coordinate is
+ * its own position with the full precision of a double.
+ * @param[in] coords Coordinates of the center
+ * @param[in] ndims Number of dimensions, between 1 and 4
+ */
+uint64
+bbox_gist_hilbert_key(const double *coords, int ndims)
+{
+  assert(ndims >= 1 && ndims <= 4);
+  if (ndims == 1)
+    return double_sortable(coords[0]);
+
+  int bits = 64 / ndims;
+  if (bits > 32)
+    bits = 32;
+  uint32 x[4];
+  for (int i = 0; i < ndims; i++)
+    x[i] = float_sortable(coords[i]) >> (32 - bits);
+
+  /* Inverse undo excess work */
+  uint32 m = (uint32) 1 << (bits - 1);
+  for (uint32 q = m; q > 1; q >>= 1)
+  {
+    uint32 p = q - 1;
+    for (int i = 0; i < ndims; i++)
+    {
+      if (x[i] & q)
+        x[0] ^= p;
+      else
+      {
+        uint32 t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  /* Gray encode */
+  for (int i = 1; i < ndims; i++)
+    x[i] ^= x[i - 1];
+  uint32 t = 0;
+  for (uint32 q = m; q > 1; q >>= 1)
+  {
+    if (x[ndims - 1] & q)
+      t ^= q - 1;
+  }
+  for (int i = 0; i < ndims; i++)
+    x[i] ^= t;
+
+  /* Interleave the bits of the transposed coordinates */
+  uint64 result = 0;
+  for (int b = bits - 1; b >= 0; b--)
+  {
+    for (int i = 0; i < ndims; i++)
+      result = (result << 1) | ((x[i] >> b) & 1);
+  }
+  return result;
+}
+
+/**
+ * @brief Compare two bounding boxes by their position on the curve
+ */
+static int
+bbox_gist_cmp_full(Datum x, Datum y, SortSupport ssup)
+{
+  const BboxSortSupport *extra = (BboxSortSupport *) ssup->ssup_extra;
+  uint64 key1 = extra->bbox_key(x);
+  uint64 key2 = extra->bbox_key(y);
+  return (key1 > key2) - (key1 < key2);
+}
+
+/**
+ * @brief Compare two abbreviated keys, which are the positions of the boxes
+ * on the curve
+ */
+static int
+bbox_gist_cmp_abbrev(Datum x, Datum y, SortSupport ssup UNUSED)
+{
+  uint64 key1 = DatumGetUInt64(x);
+  uint64 key2 = DatumGetUInt64(y);
+  return (key1 > key2) - (key1 < key2);
+}
+
+/**
+ * @brief Return the abbreviated key of a bounding box
+ */
+static Datum
+bbox_gist_abbrev_convert(Datum original, SortSupport ssup)
+{
+  const BboxSortSupport *extra = (BboxSortSupport *) ssup->ssup_extra;
+  return UInt64GetDatum(extra->bbox_key(original));
+}
+
+/**
+ * @brief Never abort the abbreviation, since the abbreviated keys are as
+ * discriminating as the full comparison
+ */
+static bool
+bbox_gist_abbrev_abort(int memtupcount UNUSED, SortSupport ssup UNUSED)
+{
+  return false;
+}
+
+/**
+ * @brief Set the sort support of a bounding box type, which orders the boxes
+ * by the position of their center on a Hilbert curve
+ * @details The sort support enables building a GiST index by sorting the
+ * bounding boxes and packing them into pages, instead of inserting them one
+ * by one
+ * @param[in] ssup Sort support
+ * @param[in] bbox_key Function computing the position of a box on the curve
+ */
+void
+bbox_gist_sortsupport(SortSupport ssup, uint64 (*bbox_key)(Datum))
+{
+  BboxSortSupport *extra = MemoryContextAlloc(ssup->ssup_cxt,
+    sizeof(BboxSortSupport));
+  extra->bbox_key = bbox_key;
+  ssup->ssup_extra = extra;
+  ssup->comparator = bbox_gist_cmp_full;
+  /* The abbreviated keys are passed by value only with 64-bit datums */
+  if (ssup->abbreviate && sizeof(Datum) == 8)
+  {
+    ssup->comparator = bbox_gist_cmp_abbrev;
+    ssup->abbrev_converter = bbox_gist_abbrev_convert;
+    ssup->abbrev_abort = bbox_gist_abbrev_abort;
+    ssup->abbrev_full_comparator = bbox_gist_cmp_full;
+  }
+  return;
+}
+
+/**
+ * @brief Return the position on a Hilbert curve of a temporal box
+ */
+static uint64
+tbox_gist_key(Datum d)
+{
+  const TBox *box = DatumGetTboxP(d);
+  double coords[2];
+  int ndims = 0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+    coords[ndims++] = (datum_double(box->span.lower, box->span.basetype) +
+      datum_double(box->span.upper, box->span.basetype)) / 2.0;
+  if (MEOS_FLAGS_GET_T(box->flags))
+    coords[ndims++] = ((double) DatumGetTimestampTz(box->period.lower) +
+      (double) DatumGetTimestampTz(box->period.upper)) / 2.0;
+  return ndims ? bbox_gist_hilbert_key(coords, ndims) : 0;
+}
+
+PGDLLEXPORT Datum Tbox_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for temporal boxes
+ */
+Datum
+Tbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  bbox_gist_sortsupport(ssup, tbox_gist_key);
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************/
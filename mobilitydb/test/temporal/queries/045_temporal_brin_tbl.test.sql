@@ -0,0 +1,586 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2026, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2025, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS test_brinops;
+CREATE TABLE test_brinops(
+  op TEXT,
+  leftarg TEXT,
+  rightarg TEXT,
+  no_idx BIGINT,
+  inclusion_idx BIGINT,
+  multi_idx BIGINT
+);
+
+-------------------------------------------------------------------------------
+-- Without Index
+-------------------------------------------------------------------------------
+
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t @> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t <@ tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '-|-', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t -|- tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<#', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t &<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#>>', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t #>> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'tstzspan', 'tstzspan', COUNT(*) FROM tbl_tstzspan_big WHERE t #&> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f && floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f @> floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f <@ floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f << floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f &< floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '>>', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f >> floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&>', 'floatspan', 'floatspan', COUNT(*) FROM tbl_floatspan_big WHERE f &> floatspan '[10,20]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp @> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '~=', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp ~= tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '-|-', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp -|- tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<#', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#>>', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'tbool', 'tstzspan', COUNT(*) FROM tbl_tbool_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tbool', 'tbool', COUNT(*) FROM tbl_tbool_big WHERE temp && tbool '[t@2001-06-01, f@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp && intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp @> intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp <@ intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp << intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp &< intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '>>', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp >> intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&>', 'tint', 'intspan', COUNT(*) FROM tbl_tint_big WHERE temp &> intspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tint', 'tbox', COUNT(*) FROM tbl_tint_big WHERE temp && tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tint', 'tbox', COUNT(*) FROM tbl_tint_big WHERE temp @> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tint', 'tbox', COUNT(*) FROM tbl_tint_big WHERE temp <@ tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tint', 'tbox', COUNT(*) FROM tbl_tint_big WHERE temp <<# tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'tint', 'tbox', COUNT(*) FROM tbl_tint_big WHERE temp #&> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tint', 'tint', COUNT(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp && floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp @> floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp <@ floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp << floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp &< floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '>>', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp >> floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&>', 'tfloat', 'floatspan', COUNT(*) FROM tbl_tfloat_big WHERE temp &> floatspan '[1,3]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tfloat', 'tstzspan', COUNT(*) FROM tbl_tfloat_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'tfloat', 'tstzspan', COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&<#', 'tfloat', 'tstzspan', COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#>>', 'tfloat', 'tstzspan', COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'tfloat', 'tstzspan', COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'tfloat', 'tfloat', COUNT(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '@>', 'tfloat', 'tfloat', COUNT(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'tfloat', 'tfloat', COUNT(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '~=', 'tfloat', 'tfloat', COUNT(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '-|-', 'tfloat', 'tfloat', COUNT(*) FROM tbl_tfloat_big WHERE temp -|- tfloat '[1@2001-06-01, 2@2001-07-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '&&', 'ttext', 'tstzspan', COUNT(*) FROM tbl_ttext_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<@', 'ttext', 'tstzspan', COUNT(*) FROM tbl_ttext_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '<<#', 'ttext', 'tstzspan', COUNT(*) FROM tbl_ttext_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]';
+INSERT INTO test_brinops(op, leftarg, rightarg, no_idx)
+SELECT '#&>', 'ttext', 'tstzspan', COUNT(*) FROM tbl_ttext_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]';
+
+-------------------------------------------------------------------------------
+-- BRIN inclusion index
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tstzspan_big_inclusion_idx ON tbl_tstzspan_big
+  USING BRIN(t) WITH (pages_per_range = 1);
+CREATE INDEX tbl_floatspan_big_inclusion_idx ON tbl_floatspan_big
+  USING BRIN(f) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tbool_big_inclusion_idx ON tbl_tbool_big
+  USING BRIN(temp) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tint_big_inclusion_idx ON tbl_tint_big
+  USING BRIN(temp) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tfloat_big_inclusion_idx ON tbl_tfloat_big
+  USING BRIN(temp) WITH (pages_per_range = 1);
+CREATE INDEX tbl_ttext_big_inclusion_idx ON tbl_ttext_big
+  USING BRIN(temp) WITH (pages_per_range = 1);
+
+SET enable_seqscan = off;
+
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t @> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t -|- tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f && floatspan '[10,20]' )
+WHERE op = '&&' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f @> floatspan '[10,20]' )
+WHERE op = '@>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f <@ floatspan '[10,20]' )
+WHERE op = '<@' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f << floatspan '[10,20]' )
+WHERE op = '<<' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f &< floatspan '[10,20]' )
+WHERE op = '&<' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f >> floatspan '[10,20]' )
+WHERE op = '>>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f &> floatspan '[10,20]' )
+WHERE op = '&>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp @> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp ~= tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '~=' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp -|- tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp && tbool '[t@2001-06-01, f@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tbool' AND rightarg = 'tbool';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && intspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> intspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ intspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp << intspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &< intspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >> intspan '[1,3]' )
+WHERE op = '>>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &> intspan '[1,3]' )
+WHERE op = '&>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <<# tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '<<#' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #&> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '#&>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && floatspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> floatspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ floatspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp << floatspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &< floatspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >> floatspan '[1,3]' )
+WHERE op = '>>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &> floatspan '[1,3]' )
+WHERE op = '&>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '~=' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp -|- tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '-|-' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET inclusion_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+
+RESET enable_seqscan;
+
+DROP INDEX tbl_tstzspan_big_inclusion_idx;
+DROP INDEX tbl_floatspan_big_inclusion_idx;
+DROP INDEX tbl_tbool_big_inclusion_idx;
+DROP INDEX tbl_tint_big_inclusion_idx;
+DROP INDEX tbl_tfloat_big_inclusion_idx;
+DROP INDEX tbl_ttext_big_inclusion_idx;
+
+-------------------------------------------------------------------------------
+-- BRIN multi-inclusion index
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tstzspan_big_multi_idx ON tbl_tstzspan_big
+  USING BRIN(t tstzspan_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+CREATE INDEX tbl_floatspan_big_multi_idx ON tbl_floatspan_big
+  USING BRIN(f floatspan_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tbool_big_multi_idx ON tbl_tbool_big
+  USING BRIN(temp tbool_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tint_big_multi_idx ON tbl_tint_big
+  USING BRIN(temp tint_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+CREATE INDEX tbl_tfloat_big_multi_idx ON tbl_tfloat_big
+  USING BRIN(temp tfloat_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+CREATE INDEX tbl_ttext_big_multi_idx ON tbl_ttext_big
+  USING BRIN(temp ttext_inclusion_multi_ops(boxes_per_range = 4)) WITH (pages_per_range = 1);
+
+SET enable_seqscan = off;
+
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t @> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t -|- tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tstzspan_big WHERE t #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tstzspan' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f && floatspan '[10,20]' )
+WHERE op = '&&' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f @> floatspan '[10,20]' )
+WHERE op = '@>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f <@ floatspan '[10,20]' )
+WHERE op = '<@' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f << floatspan '[10,20]' )
+WHERE op = '<<' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f &< floatspan '[10,20]' )
+WHERE op = '&<' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f >> floatspan '[10,20]' )
+WHERE op = '>>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_floatspan_big WHERE f &> floatspan '[10,20]' )
+WHERE op = '&>' AND leftarg = 'floatspan' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp @> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp ~= tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '~=' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp -|- tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tbool' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tbool_big WHERE temp && tbool '[t@2001-06-01, f@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tbool' AND rightarg = 'tbool';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && intspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> intspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ intspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp << intspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &< intspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >> intspan '[1,3]' )
+WHERE op = '>>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &> intspan '[1,3]' )
+WHERE op = '&>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <<# tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '<<#' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #&> tbox 'TBOXINT XT([1,3],[2001-01-01,2001-02-01])' )
+WHERE op = '#&>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && floatspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> floatspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ floatspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp << floatspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &< floatspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >> floatspan '[1,3]' )
+WHERE op = '>>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &> floatspan '[1,3]' )
+WHERE op = '&>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '~=' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp -|- tfloat '[1@2001-06-01, 2@2001-07-01]' )
+WHERE op = '-|-' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp && tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp <@ tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+UPDATE test_brinops
+SET multi_idx = ( SELECT COUNT(*) FROM tbl_ttext_big WHERE temp #&> tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'ttext' AND rightarg = 'tstzspan';
+
+RESET enable_seqscan;
+
+DROP INDEX tbl_tstzspan_big_multi_idx;
+DROP INDEX tbl_floatspan_big_multi_idx;
+DROP INDEX tbl_tbool_big_multi_idx;
+DROP INDEX tbl_tint_big_multi_idx;
+DROP INDEX tbl_tfloat_big_multi_idx;
+DROP INDEX tbl_ttext_big_multi_idx;
+
+-------------------------------------------------------------------------------
+-- TEST THE EQUIVALENCE
+-------------------------------------------------------------------------------
+
+SELECT * FROM test_brinops
+WHERE no_idx <> inclusion_idx OR no_idx <> multi_idx OR
+  no_idx IS NULL OR inclusion_idx IS NULL OR multi_idx IS NULL
+ORDER BY op, leftarg, rightarg;
+
+DROP TABLE test_brinops;
+
+-------------------------------------------------------------------------------
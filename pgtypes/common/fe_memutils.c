@@ -51,25 +51,545 @@ meos_initialize_allocator(meos_malloc_fn malloc_fn,
 }
 
 static inline void *
-meos_hook_malloc(size_t size)
+meos_libc_malloc(size_t size)
 {
 	meos_malloc_fn fn = __atomic_load_n(&MEOS_MALLOC, __ATOMIC_ACQUIRE);
 	return fn(size);
 }
 
 static inline void *
-meos_hook_realloc(void *ptr, size_t size)
+meos_libc_realloc(void *ptr, size_t size)
 {
 	meos_realloc_fn fn = __atomic_load_n(&MEOS_REALLOC, __ATOMIC_ACQUIRE);
 	return fn(ptr, size);
 }
 
 static inline void
-meos_hook_free(void *ptr)
+meos_libc_free(void *ptr)
 {
 	meos_free_fn fn = __atomic_load_n(&MEOS_FREE, __ATOMIC_ACQUIRE);
 	fn(ptr);
 }
+
+/*
+ * Arena mode. Between meos_arena_push and the matching meos_arena_pop, the
+ * allocations of the calling thread are carved out of large blocks obtained
+ * from the allocator hooks, and are all released at once by the pop. Each
+ * chunk is preceded by its size so that repalloc can copy it. pfree of a chunk
+ * of the arena only gives back the space of the last chunk of the current
+ * block, which is the common case of a temporary freed right after use, and
+ * pointers allocated outside the arena are freed by the hooks as usual.
+ * Telling the two apart must not cost a walk over the blocks on every pfree,
+ * so the blocks are indexed by the segments of the address space they cover.
+ *
+ * The arena is per thread (MEOS_TLS) like the session time zone, so a scope
+ * only captures the allocations of the thread that opened it. The caches that
+ * must outlive a scope, such as the time-zone and PROJ caches, allocate with
+ * the arena suspended (meos_arena_suspend/meos_arena_resume).
+ */
+
+/* Size of the first block of an arena, doubled for each new block */
+#define MEOS_ARENA_INITIAL_BLOCK	((size_t) 64 * 1024)
+/* Maximum size of a block, except for a larger single chunk */
+#define MEOS_ARENA_MAX_BLOCK		((size_t) 8 * 1024 * 1024)
+/* Size of the header of a chunk keeping its size */
+#define MEOS_ARENA_CHUNK_HDR		MAXALIGN(sizeof(size_t))
+/*
+ * Log2 of the size of the segments indexing the blocks, which is at most the
+ * size of a block so that a segment overlaps at most two of them
+ */
+#define MEOS_ARENA_SEGMENT_SHIFT	16
+/* Initial number of slots of the index of the blocks */
+#define MEOS_ARENA_INITIAL_SLOTS	256
+
+typedef struct MeosArenaBlock
+{
+	struct MeosArenaBlock *prev;	/* previous block, NULL for the first */
+	size_t		size;			/* usable bytes of the block */
+	size_t		used;			/* bytes handed out */
+	char	   *data;			/* start of the usable bytes */
+} MeosArenaBlock;
+
+/*
+ * Slot of the index of the blocks, a segment number of 0 marking an empty slot
+ * and a NULL block a removed one
+ */
+typedef struct
+{
+	uintptr_t	segment;		/* address >> MEOS_ARENA_SEGMENT_SHIFT */
+	MeosArenaBlock *block;		/* block overlapping the segment */
+} MeosArenaSlot;
+
+typedef struct
+{
+	MeosArenaBlock *block;		/* current block when the scope was opened */
+	size_t		used;			/* bytes used in it at that time */
+} MeosArenaMark;
+
+typedef struct
+{
+	MeosArenaBlock *blocks;		/* current block, linked to the previous ones */
+	MeosArenaMark *marks;		/* one mark per open scope */
+	int			depth;			/* number of open scopes */
+	int			maxdepth;		/* number of allocated marks */
+	int			suspended;		/* nesting of meos_arena_suspend */
+	size_t		nextsize;		/* size of the next block */
+	MeosArenaSlot *slots;		/* open-addressing index of the blocks */
+	size_t		nslots;			/* number of slots, a power of 2 */
+	size_t		nfilled;		/* number of slots used or removed */
+} MeosArena;
+
+static MEOS_TLS MeosArena MEOS_ARENA = {0};
+
+#define MEOS_ARENA_ACTIVE() (MEOS_ARENA.depth > 0 && MEOS_ARENA.suspended == 0)
+
+static inline size_t
+meos_arena_slot_hash(uintptr_t segment)
+{
+	return (size_t) (((uint64) segment * UINT64CONST(0x9E3779B97F4A7C15)) >> 32);
+}
+
+static inline uintptr_t
+meos_arena_segment(const void *ptr)
+{
+	return (uintptr_t) ptr >> MEOS_ARENA_SEGMENT_SHIFT;
+}
+
+/*
+ * Add a segment overlapped by a block to the index, which has a free slot
+ */
+static void
+meos_arena_slot_add(MeosArenaSlot *slots, size_t nslots, uintptr_t segment,
+					MeosArenaBlock *block)
+{
+	size_t		i = meos_arena_slot_hash(segment) & (nslots - 1);
+
+	while (slots[i].segment != 0)
+		i = (i + 1) & (nslots - 1);
+	slots[i].segment = segment;
+	slots[i].block = block;
+}
+
+/*
+ * Add the segments overlapped by a block to the index, rebuilding it without
+ * its removed slots when it would be more than half full, and return false
+ * when out of memory
+ */
+static bool
+meos_arena_index_add(MeosArenaBlock *block)
+{
+	uintptr_t	first = meos_arena_segment(block->data);
+	uintptr_t	last = meos_arena_segment(block->data + block->size - 1);
+	size_t		nsegs = last - first + 1;
+
+	if ((MEOS_ARENA.nfilled + nsegs) * 2 > MEOS_ARENA.nslots)
+	{
+		size_t		nlive = nsegs;
+
+		for (size_t i = 0; i < MEOS_ARENA.nslots; i++)
+		{
+			if (MEOS_ARENA.slots[i].block)
+				nlive++;
+		}
+		size_t		nslots = MEOS_ARENA_INITIAL_SLOTS;
+
+		while (nlive * 2 > nslots)
+			nslots *= 2;
+		MeosArenaSlot *slots = meos_libc_malloc(sizeof(MeosArenaSlot) * nslots);
+
+		if (!slots)
+			return false;
+		memset(slots, 0, sizeof(MeosArenaSlot) * nslots);
+		nlive -= nsegs;
+		for (size_t i = 0; i < MEOS_ARENA.nslots; i++)
+		{
+			if (MEOS_ARENA.slots[i].block)
+				meos_arena_slot_add(slots, nslots, MEOS_ARENA.slots[i].segment,
+									MEOS_ARENA.slots[i].block);
+		}
+		if (MEOS_ARENA.slots)
+			meos_libc_free(MEOS_ARENA.slots);
+		MEOS_ARENA.slots = slots;
+		MEOS_ARENA.nslots = nslots;
+		MEOS_ARENA.nfilled = nlive;
+	}
+	for (uintptr_t segment = first; segment <= last; segment++)
+		meos_arena_slot_add(MEOS_ARENA.slots, MEOS_ARENA.nslots, segment, block);
+	MEOS_ARENA.nfilled += nsegs;
+	return true;
+}
+
+/*
+ * Give a block back to the allocator after removing it from the index
+ */
+static void
+meos_arena_block_free(MeosArenaBlock *block)
+{
+	uintptr_t	first = meos_arena_segment(block->data);
+	uintptr_t	last = meos_arena_segment(block->data + block->size - 1);
+
+	for (uintptr_t segment = first; segment <= last; segment++)
+	{
+		size_t		i = meos_arena_slot_hash(segment) & (MEOS_ARENA.nslots - 1);
+
+		while (MEOS_ARENA.slots[i].segment != 0)
+		{
+			if (MEOS_ARENA.slots[i].segment == segment &&
+				MEOS_ARENA.slots[i].block == block)
+			{
+				MEOS_ARENA.slots[i].block = NULL;
+				break;
+			}
+			i = (i + 1) & (MEOS_ARENA.nslots - 1);
+		}
+	}
+	meos_libc_free(block);
+}
+
+/*
+ * Return the block of the arena of the calling thread holding the pointer,
+ * NULL if it was not allocated in it. Since a segment overlaps at most two
+ * blocks and the index is at most half full, only a few slots are probed.
+ */
+static MeosArenaBlock *
+meos_arena_block_of(const void *ptr)
+{
+	const char *p = (const char *) ptr;
+	uintptr_t	segment = meos_arena_segment(ptr);
+	size_t		i;
+
+	if (!MEOS_ARENA.slots)
+		return NULL;
+	i = meos_arena_slot_hash(segment) & (MEOS_ARENA.nslots - 1);
+	while (MEOS_ARENA.slots[i].segment != 0)
+	{
+		MeosArenaBlock *block = MEOS_ARENA.slots[i].block;
+
+		if (MEOS_ARENA.slots[i].segment == segment && block &&
+			p >= block->data && p < block->data + block->size)
+			return block;
+		i = (i + 1) & (MEOS_ARENA.nslots - 1);
+	}
+	return NULL;
+}
+
+/*
+ * Return true when a chunk of the current block was allocated in the innermost
+ * scope, so that its space can be given back or resized in place without
+ * going below the mark that the pop of the scope restores
+ */
+static bool
+meos_arena_in_scope(const void *ptr)
+{
+	const MeosArenaMark *mark;
+
+	if (MEOS_ARENA.depth == 0)
+		return false;
+	mark = &MEOS_ARENA.marks[MEOS_ARENA.depth - 1];
+	return mark->block != MEOS_ARENA.blocks ||
+		(const char *) ptr - MEOS_ARENA_CHUNK_HDR >=
+		MEOS_ARENA.blocks->data + mark->used;
+}
+
+/*
+ * Allocate a chunk in the arena, starting a new block when the current one is
+ * full
+ */
+static void *
+meos_arena_alloc(size_t size)
+{
+	size_t		chunk = MEOS_ARENA_CHUNK_HDR + MAXALIGN(size);
+	MeosArenaBlock *block = MEOS_ARENA.blocks;
+
+	if (!block || block->size - block->used < chunk)
+	{
+		size_t		blocksize = MEOS_ARENA.nextsize ?
+			MEOS_ARENA.nextsize : MEOS_ARENA_INITIAL_BLOCK;
+
+		if (blocksize < chunk)
+			blocksize = chunk;
+		block = meos_libc_malloc(MAXALIGN(sizeof(MeosArenaBlock)) + blocksize);
+		if (!block)
+			return NULL;
+		block->prev = MEOS_ARENA.blocks;
+		block->size = blocksize;
+		block->used = 0;
+		block->data = (char *) block + MAXALIGN(sizeof(MeosArenaBlock));
+		if (!meos_arena_index_add(block))
+		{
+			meos_libc_free(block);
+			return NULL;
+		}
+		MEOS_ARENA.blocks = block;
+		if (MEOS_ARENA.nextsize < MEOS_ARENA_MAX_BLOCK)
+			MEOS_ARENA.nextsize = Min(blocksize * 2, MEOS_ARENA_MAX_BLOCK);
+	}
+	char	   *result = block->data + block->used + MEOS_ARENA_CHUNK_HDR;
+
+	*(size_t *) (result - MEOS_ARENA_CHUNK_HDR) = size;
+	block->used += chunk;
+	return result;
+}
+
+/*
+ * Resize a chunk of the arena, in place when it is the last one of the
+ * current block, was allocated in the innermost scope, and the block has room
+ * for it
+ */
+static void *
+meos_arena_realloc(void *ptr, size_t size)
+{
+	MeosArenaBlock *block = MEOS_ARENA.blocks;
+	size_t		oldsize = *(size_t *) ((char *) ptr - MEOS_ARENA_CHUNK_HDR);
+	char	   *end = (char *) ptr + MAXALIGN(oldsize);
+
+	if (end == block->data + block->used && meos_arena_in_scope(ptr) &&
+		block->size - (block->used - MAXALIGN(oldsize)) >= MAXALIGN(size))
+	{
+		block->used = block->used - MAXALIGN(oldsize) + MAXALIGN(size);
+		*(size_t *) ((char *) ptr - MEOS_ARENA_CHUNK_HDR) = size;
+		return ptr;
+	}
+	if (size <= oldsize)
+		return ptr;
+	void	   *result = meos_arena_alloc(size);
+
+	if (result)
+		memcpy(result, ptr, oldsize);
+	return result;
+}
+
+/*
+ * Give back the space of a chunk of the arena when it is the last one of the
+ * current block and was allocated in the innermost scope
+ */
+static void
+meos_arena_free(void *ptr)
+{
+	MeosArenaBlock *block = MEOS_ARENA.blocks;
+	size_t		size = *(size_t *) ((char *) ptr - MEOS_ARENA_CHUNK_HDR);
+
+	if ((char *) ptr + MAXALIGN(size) == block->data + block->used &&
+		meos_arena_in_scope(ptr))
+		block->used -= MEOS_ARENA_CHUNK_HDR + MAXALIGN(size);
+}
+
+static inline void *
+meos_hook_malloc(size_t size)
+{
+	if (MEOS_ARENA_ACTIVE())
+		return meos_arena_alloc(size);
+	return meos_libc_malloc(size);
+}
+
+static inline void *
+meos_hook_realloc(void *ptr, size_t size)
+{
+	if (ptr && MEOS_ARENA.blocks && meos_arena_block_of(ptr))
+	{
+		/* A chunk of an arena stays in it even with the arena suspended */
+		if (MEOS_ARENA.suspended == 0)
+			return meos_arena_realloc(ptr, size);
+		size_t		oldsize = *(size_t *) ((char *) ptr - MEOS_ARENA_CHUNK_HDR);
+		void	   *result = meos_libc_malloc(size);
+
+		if (result)
+			memcpy(result, ptr, Min(oldsize, size));
+		return result;
+	}
+	if (!ptr && MEOS_ARENA_ACTIVE())
+		return meos_arena_alloc(size);
+	return meos_libc_realloc(ptr, size);
+}
+
+static inline void
+meos_hook_free(void *ptr)
+{
+	if (ptr && MEOS_ARENA.blocks)
+	{
+		MeosArenaBlock *block = meos_arena_block_of(ptr);
+
+		if (block)
+		{
+			if (block == MEOS_ARENA.blocks)
+				meos_arena_free(ptr);
+			return;
+		}
+	}
+	meos_libc_free(ptr);
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Open an arena scope on the calling thread
+ * @details Until the matching #meos_arena_pop, the memory allocated by MEOS on
+ * the calling thread, including the values returned to the caller, is carved
+ * out of large blocks and released all at once by the pop, which avoids the
+ * many small allocations and frees of building temporal values instant by
+ * instant. Such a value must not be freed with @p free, while the MEOS
+ * functions freeing it with @p pfree only give back its space when it is the
+ * last one allocated. A value that must outlive the scope is copied out of it
+ * with #meos_arena_keep. Scopes can be nested, a pop releasing only the
+ * memory allocated since the matching push. Since the scope only captures the
+ * allocations of the calling thread, the MEOS functions that split their work
+ * between the threads of #meos_initialize_threads run on the calling thread
+ * alone while a scope is open.
+ */
+void
+meos_arena_push(void)
+{
+	if (MEOS_ARENA.depth == MEOS_ARENA.maxdepth)
+	{
+		int			maxdepth = MEOS_ARENA.maxdepth ? MEOS_ARENA.maxdepth * 2 : 8;
+		MeosArenaMark *marks = meos_libc_realloc(MEOS_ARENA.marks,
+			sizeof(MeosArenaMark) * maxdepth);
+
+		if (!marks)
+		{
+			fprintf(stderr, _("out of memory\n"));
+			exit(EXIT_FAILURE);
+		}
+		MEOS_ARENA.marks = marks;
+		MEOS_ARENA.maxdepth = maxdepth;
+	}
+	MeosArenaMark *mark = &MEOS_ARENA.marks[MEOS_ARENA.depth++];
+
+	mark->block = MEOS_ARENA.blocks;
+	mark->used = MEOS_ARENA.blocks ? MEOS_ARENA.blocks->used : 0;
+	return;
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Close the last arena scope opened on the calling thread, releasing
+ * the memory allocated in it
+ * @details The values allocated in the scope must not be used after the pop.
+ * When the outermost scope is closed the largest block is kept for the next
+ * scope and the others are given back to the allocator.
+ */
+void
+meos_arena_pop(void)
+{
+	if (MEOS_ARENA.depth == 0)
+	{
+		meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+			"No arena scope to close");
+		return;
+	}
+	MeosArenaMark *mark = &MEOS_ARENA.marks[--MEOS_ARENA.depth];
+
+	if (MEOS_ARENA.depth > 0)
+	{
+		/* Release the blocks started in the scope */
+		while (MEOS_ARENA.blocks != mark->block)
+		{
+			MeosArenaBlock *prev = MEOS_ARENA.blocks->prev;
+
+			meos_arena_block_free(MEOS_ARENA.blocks);
+			MEOS_ARENA.blocks = prev;
+		}
+		if (mark->block)
+			mark->block->used = mark->used;
+		return;
+	}
+	/* Keep the largest block for the next scope */
+	MeosArenaBlock *keep = NULL;
+
+	for (MeosArenaBlock *block = MEOS_ARENA.blocks; block; block = block->prev)
+	{
+		if (!keep || block->size > keep->size)
+			keep = block;
+	}
+	while (MEOS_ARENA.blocks)
+	{
+		MeosArenaBlock *prev = MEOS_ARENA.blocks->prev;
+
+		if (MEOS_ARENA.blocks != keep)
+			meos_arena_block_free(MEOS_ARENA.blocks);
+		MEOS_ARENA.blocks = prev;
+	}
+	if (keep)
+	{
+		keep->prev = NULL;
+		keep->used = 0;
+		MEOS_ARENA.blocks = keep;
+		MEOS_ARENA.nextsize = Min(keep->size * 2, MEOS_ARENA_MAX_BLOCK);
+	}
+	return;
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Return a copy outside the arena scopes of the calling thread of a
+ * value allocated in one of them, or the value itself if it was not
+ * @details The copy is made by the allocator hooks and is freed as the values
+ * returned by MEOS outside an arena scope. Only values in a single piece of memory, such as
+ * the temporal values, spans, sets, boxes, or geometries, can be kept.
+ * @param[in] ptr Value
+ */
+void *
+meos_arena_keep(const void *ptr)
+{
+	if (!ptr || !MEOS_ARENA.blocks || !meos_arena_block_of(ptr))
+		return (void *) ptr;
+	size_t		size = *(size_t *) ((const char *) ptr - MEOS_ARENA_CHUNK_HDR);
+	void	   *result = meos_libc_malloc(size);
+
+	if (!result)
+	{
+		fprintf(stderr, _("out of memory\n"));
+		exit(EXIT_FAILURE);
+	}
+	memcpy(result, ptr, size);
+	return result;
+}
+
+/**
+ * @ingroup meos_setup
+ * @brief Return the number of arena scopes open on the calling thread
+ */
+int
+meos_arena_depth(void)
+{
+	return MEOS_ARENA.depth;
+}
+
+/*
+ * Make the allocations of the calling thread bypass its arena until the
+ * matching meos_arena_resume, for the state that outlives a scope
+ */
+void
+meos_arena_suspend(void)
+{
+	MEOS_ARENA.suspended++;
+}
+
+void
+meos_arena_resume(void)
+{
+	Assert(MEOS_ARENA.suspended > 0);
+	MEOS_ARENA.suspended--;
+}
+
+/*
+ * Release the arena of the calling thread, closing the scopes left open
+ */
+void
+meos_finalize_arena(void)
+{
+	while (MEOS_ARENA.blocks)
+	{
+		MeosArenaBlock *prev = MEOS_ARENA.blocks->prev;
+
+		meos_libc_free(MEOS_ARENA.blocks);
+		MEOS_ARENA.blocks = prev;
+	}
+	if (MEOS_ARENA.marks)
+		meos_libc_free(MEOS_ARENA.marks);
+	if (MEOS_ARENA.slots)
+		meos_libc_free(MEOS_ARENA.slots);
+	memset(&MEOS_ARENA, 0, sizeof(MeosArena));
+}
 #endif /* MEOS */
 
 static inline void *
@@ -72,6 +72,13 @@ extern void *palloc_extended(Size size, int flags);
 extern void *repalloc(void *pointer, Size size);
 extern void pfree(void *pointer);
 
+#if MEOS
+/* Make the allocations bypass the arena of the calling thread, for the state
+ * that must outlive an arena scope */
+extern void meos_arena_suspend(void);
+extern void meos_arena_resume(void);
+#endif
+
 #define palloc_object(type) ((type *) palloc(sizeof(type)))
 #define palloc0_object(type) ((type *) palloc0(sizeof(type)))
 #define palloc_array(type, count) ((type *) palloc(sizeof(type) * (count)))
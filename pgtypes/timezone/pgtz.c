@@ -331,8 +331,8 @@ scan_directory_ci(const char *dirname, const char *fname, int fnamelen,
  * 3. It's quick enough that we don't waste much time when the bootstrap
  * default timezone setting is later overridden from postgresql.conf.
  */
-pg_tz *
-pg_tzset(const char *name)
+static pg_tz *
+pg_tzset_cached(const char *name)
 {
   // pg_tz_cache *tzp; /* MEOS */
   struct state tzstate;
@@ -419,6 +419,23 @@ pg_tzset(const char *name)
   return NULL;
 }
 
+/*
+ * MEOS: The time zones loaded are kept in the cache of the calling thread, so
+ * that they are allocated outside an arena scope open on it
+ */
+pg_tz *
+pg_tzset(const char *name)
+{
+#if defined(MEOS) && MEOS
+  meos_arena_suspend();
+  pg_tz *result = pg_tzset_cached(name);
+  meos_arena_resume();
+  return result;
+#else
+  return pg_tzset_cached(name);
+#endif
+}
+
 /*
  * Load a fixed-GMT-offset timezone.
  * This is used for SQL-spec SET TIME ZONE INTERVAL 'foo' cases.
@@ -1310,6 +1310,9 @@ meos_initialize_collation(void)
    * once in meos_initialize(), already in a persistent context.
    */
   MemoryContext oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+#else
+  /* Likewise the locale outlives an arena scope open on the calling thread */
+  meos_arena_suspend();
 #endif /* ! MEOS */
   if (strcmp(database_locprovider, COLLATIONPROVIDER[COLLPROV_BUILTIN]) == 0)
     result = meos_create_pg_locale_builtin(DEFAULT_COLLATION_OID);
@@ -1327,6 +1330,8 @@ meos_initialize_collation(void)
   default_locale = result;
 #if ! MEOS
   MemoryContextSwitchTo(oldcontext);
+#else
+  meos_arena_resume();
 #endif /* ! MEOS */
   return;
 }